@@ -167,6 +167,10 @@ struct Entity {
     std::string fillBlockType; std::string fillColor;
     int count = 1;
     std::vector<EntityInstance> instances;
+    // Bumped whenever instances are added, removed or re-prototyped, or a
+    // placed instance moves (layout passes that only slide UI text and
+    // buttons leave it alone); caches built from `instances` compare against it.
+    uint64_t instanceEdits = 0;
     std::vector<UiStateColors> uiStates;
 };
 
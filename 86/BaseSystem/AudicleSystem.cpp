@@ -18,6 +18,7 @@ namespace AudicleSystemLogic {
                     for (const auto& event : proto.instances) {
                         // This logic might need refinement if prototypes in instances are names
                         activeWorld.instances.push_back(HostLogic::CreateInstance(baseSystem, event.prototypeID, event.position, event.color));
+                        activeWorld.instanceEdits += 1;
                     }
                 }
                 finishedAudicleInstanceIDs.push_back(inst.instanceID);
@@ -39,6 +40,7 @@ namespace AudicleSystemLogic {
                     }),
                 activeWorld.instances.end()
             );
+            activeWorld.instanceEdits += 1;
         }
     }
 }
@@ -4,11 +4,18 @@
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
+#include "BaseSystem/RenderDevice.h"
+
 // Forward declarations
 struct BaseSystem;
 struct Entity;
 
 namespace AudioRayVisualizerSystemLogic {
+    namespace {
+        struct RayVertex { glm::vec3 pos; glm::vec3 color; };
+
+        std::vector<RayVertex> g_vertices;
+    }
 
     void UpdateAudioRayVisualizer(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
         if (!baseSystem.renderer || !baseSystem.world || !baseSystem.rayTracedAudio) return;
@@ -28,20 +35,25 @@ namespace AudioRayVisualizerSystemLogic {
         }
         if (!renderer.audioRayShader) return;
 
+        // These are world-space segments drawn as depth-tested GL_LINES with
+        // the camera's view and projection (by OverlayRenderSystem and the
+        // color emotion pass), so they keep their own buffer rather than
+        // going through the NDC-triangle UI batch.
+        RenderDevice::Device& device = RenderDevice::current();
         if (renderer.audioRayVAO == 0) {
-            glGenVertexArrays(1, &renderer.audioRayVAO);
-            glGenBuffers(1, &renderer.audioRayVBO);
-            glBindVertexArray(renderer.audioRayVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.audioRayVBO);
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-            glBindVertexArray(0);
+            renderer.audioRayVAO = device.createVertexArray();
+            renderer.audioRayVBO = device.createBuffer();
+            device.bindVertexArray(renderer.audioRayVAO);
+            device.bindBuffer(GL_ARRAY_BUFFER, renderer.audioRayVBO);
+            device.vertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(RayVertex), offsetof(RayVertex, pos));
+            device.enableVertexAttribArray(0);
+            device.vertexAttribPointer(1, 3, GL_FLOAT, false, sizeof(RayVertex), offsetof(RayVertex, color));
+            device.enableVertexAttribArray(1);
+            device.bindVertexArray(0);
         }
 
-        struct RayVertex { glm::vec3 pos; glm::vec3 color; };
-        std::vector<RayVertex> verts;
+        std::vector<RayVertex>& verts = g_vertices;
+        verts.clear();
         verts.reserve(rtAudio.debugSegments.size() * 2);
         for (const auto& seg : rtAudio.debugSegments) {
             verts.push_back({seg.from, seg.color});
@@ -50,7 +62,7 @@ namespace AudioRayVisualizerSystemLogic {
 
         renderer.audioRayVertexCount = static_cast<int>(verts.size());
         renderer.audioRayVoxelCount = 0;
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.audioRayVBO);
-        glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(RayVertex), verts.data(), GL_DYNAMIC_DRAW);
+        device.bindBuffer(GL_ARRAY_BUFFER, renderer.audioRayVBO);
+        device.bufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(RayVertex), verts.data(), GL_DYNAMIC_DRAW);
     }
 }
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -16,6 +17,7 @@
 #include <vector>
 #include "chuck.h"
 #include "BaseSystem/Vst3Host.h"
+#include "BaseSystem/WavStreamWriter.h"
 
 // Forward declarations
 struct AudioContext;
@@ -24,6 +26,9 @@ namespace PinkNoiseSystemLogic {
     // It's defined in PinkNoiseSystem.cpp.
     float generate_filtered_pink_noise(AudioContext*);
 }
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem& baseSystem, const std::string& key, int fallback);
+}
 
 namespace {
     struct WavInfo {
@@ -256,6 +261,7 @@ namespace {
         audio.gameplaySfxNames.clear();
         audio.gameplaySfxBuffers.clear();
         audio.gameplaySfxSampleRates.clear();
+        audio.gameplaySfxLastTrigger.clear();
         audio.gameplaySfxVoices.clear();
         audio.gameplaySfxVoices.resize(16);
 
@@ -291,6 +297,7 @@ namespace {
             audio.gameplaySfxNames.push_back(cueName);
             audio.gameplaySfxBuffers.push_back(std::move(clip));
             audio.gameplaySfxSampleRates.push_back(rate);
+            audio.gameplaySfxLastTrigger.push_back(-1.0e9);
         }
         if (enabled) {
             std::cout << "AudioSystem: gameplay SFX ready (wav=" << loadedCount
@@ -299,9 +306,49 @@ namespace {
     }
 }
 
-// --- JACK CALLBACKS ---
-int jack_process_callback(jack_nframes_t nframes, void* arg) {
-    auto* audioContext = static_cast<AudioContext*>(arg);
+// Port buffers for one process block. The backend owns them: JACK port
+// buffers in the realtime path, plain vectors in the offline driver.
+struct AudioBlockIO {
+    static constexpr int kMaxChannels = 32;
+    jack_nframes_t frames = 0;
+    std::array<jack_default_audio_sample_t*, kMaxChannels> outputs{};
+    int outputCount = 0;
+    std::array<const jack_default_audio_sample_t*, kMaxChannels> inputs{};
+    int inputCount = 0;
+};
+
+// Deterministic stand-in for the JACK server. Blocks are rendered only when
+// asked for, inputs come from inputScript (silence when unset) and every
+// output channel can be captured to memory and/or a multichannel WAV.
+struct OfflineAudioDriver {
+    uint32_t sampleRate = 48000;
+    uint32_t bufferFrames = 256;
+    uint64_t framesRendered = 0;
+    int blocksPerUpdate = 0;
+    double pendingSeconds = 0.0;
+    std::vector<std::vector<float>> outputs;
+    std::vector<std::vector<float>> inputs;
+    AudioSystemLogic::OfflineInputScript inputScript;
+    bool captureToMemory = false;
+    std::vector<std::vector<float>> captured;
+    WavStreamWriter captureWav;
+    std::vector<float> interleaveScratch;
+};
+
+// Audio thread. Takes the track the main thread last published, unless the
+// one it replaced before has not been collected yet; then it waits a block.
+static bool adoptSoundtrack(SoundtrackSlot& slot) {
+    if (slot.retired.load(std::memory_order_acquire)) return false;
+    SoundtrackSlot::Track* next = slot.pending.exchange(nullptr, std::memory_order_acq_rel);
+    if (!next) return false;
+    slot.retired.store(slot.playing, std::memory_order_release);
+    slot.playing = next;
+    return true;
+}
+
+// --- PROCESS BLOCK ---
+int processAudioBlock(AudioContext* audioContext, const AudioBlockIO& io) {
+    const jack_nframes_t nframes = io.frames;
     float chuckMainPeak = 0.0f;
     float soundtrackPeak = 0.0f;
     float speakerBlockPeak = 0.0f;
@@ -316,21 +363,17 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
     }
 
     if (audioContext->chuck && audioContext->chuckRunning) {
+        ChucKSystemLogic::DispatchSfxTriggers(*audioContext);
         audioContext->chuck->run(nullptr, audioContext->chuckInterleavedBuffer.data(), nframes);
     } else {
         std::fill(audioContext->chuckInterleavedBuffer.begin(), audioContext->chuckInterleavedBuffer.begin() + chuckFrames, 0.0f);
     }
 
-    constexpr int kMaxOutputs = 32;
-    std::array<jack_default_audio_sample_t*, kMaxOutputs> outBuffers{};
-    const int totalOutputs = std::min<int>(static_cast<int>(audioContext->output_ports.size()), kMaxOutputs);
+    const auto& outBuffers = io.outputs;
+    const int totalOutputs = io.outputCount;
     for (int ch = 0; ch < totalOutputs; ++ch) {
-        jack_port_t* port = audioContext->output_ports[ch];
-        if (!port) continue;
-        auto* out = (jack_default_audio_sample_t*)jack_port_get_buffer(port, nframes);
-        outBuffers[ch] = out;
-        if (out) {
-            std::fill(out, out + nframes, 0.0f);
+        if (outBuffers[ch]) {
+            std::fill(outBuffers[ch], outBuffers[ch] + nframes, 0.0f);
         }
     }
 
@@ -592,7 +635,11 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
         audioContext->headUnderwaterLpState = 0.0f;
     }
 
-    if (audioContext->rayTestActive && !audioContext->rayTestBuffer.empty()) {
+    if (adoptSoundtrack(audioContext->rayTestTrack)) {
+        audioContext->rayTestPos = 0.0;
+    }
+    const SoundtrackSlot::Track* rayTrack = audioContext->rayTestTrack.playing;
+    if (audioContext->rayTestActive && rayTrack && !rayTrack->audio.left.empty()) {
         jack_default_audio_sample_t* outL = (totalOutputs > 0) ? outBuffers[0] : nullptr;
         jack_default_audio_sample_t* outR = (totalOutputs > 1) ? outBuffers[1] : nullptr;
         if (outL || outR) {
@@ -628,10 +675,11 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
                 if (micEchoDelaySamples >= micEchoBufferSize) micEchoDelaySamples = micEchoBufferSize - 1;
             }
 
-            const double step = (audioContext->rayTestSampleRate > 0)
-                ? static_cast<double>(audioContext->rayTestSampleRate) / static_cast<double>(audioContext->sampleRate)
+            const std::vector<float>& rayBuffer = rayTrack->audio.left;
+            const double step = (rayTrack->audio.sampleRate > 0)
+                ? static_cast<double>(rayTrack->audio.sampleRate) / static_cast<double>(audioContext->sampleRate)
                 : 1.0;
-            const size_t sampleCount = audioContext->rayTestBuffer.size();
+            const size_t sampleCount = rayBuffer.size();
             for (jack_nframes_t i = 0; i < nframes; ++i) {
                 if (sampleCount == 0) break;
                 size_t idx = static_cast<size_t>(audioContext->rayTestPos);
@@ -646,8 +694,8 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
                 }
                 size_t idxNext = (idx + 1 < sampleCount) ? idx + 1 : idx;
                 double frac = audioContext->rayTestPos - static_cast<double>(idx);
-                float rawSample = static_cast<float>((1.0 - frac) * audioContext->rayTestBuffer[idx] +
-                                                     frac * audioContext->rayTestBuffer[idxNext]);
+                float rawSample = static_cast<float>((1.0 - frac) * rayBuffer[idx] +
+                                                     frac * rayBuffer[idxNext]);
                 float sample = rawSample * audioContext->rayTestGain * speakerBlockGain;
 
                 if (echoBufferSize > 1) {
@@ -721,16 +769,30 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
         }
     }
 
-    if (audioContext->headTrackActive && !audioContext->headTrackBuffer.empty()) {
+    if (adoptSoundtrack(audioContext->headTrack)) {
+        const SoundtrackSlot::Track& adopted = *audioContext->headTrack.playing;
+        audioContext->headTrackPos = 0.0;
+        if (adopted.start) {
+            audioContext->headTrackGain = adopted.gain;
+            audioContext->headTrackLoop = adopted.loop;
+            audioContext->headTrackActive.store(true, std::memory_order_relaxed);
+        }
+    }
+    const SoundtrackSlot::Track* headTrack = audioContext->headTrack.playing;
+    if (audioContext->headTrackActive.load(std::memory_order_relaxed) && headTrack && !headTrack->audio.left.empty()) {
         jack_default_audio_sample_t* outL = (totalOutputs > 0) ? outBuffers[0] : nullptr;
         jack_default_audio_sample_t* outR = (totalOutputs > 1) ? outBuffers[1] : nullptr;
         if (outL || outR) {
             const float monoScale = 0.5f;
             const float soundtrackGain = audioContext->soundtrackLevelGain.load(std::memory_order_relaxed);
-            const double step = (audioContext->headTrackSampleRate > 0)
-                ? static_cast<double>(audioContext->headTrackSampleRate) / static_cast<double>(audioContext->sampleRate)
+            const std::vector<float>& leftBuffer = headTrack->audio.left;
+            const double step = (headTrack->audio.sampleRate > 0)
+                ? static_cast<double>(headTrack->audio.sampleRate) / static_cast<double>(audioContext->sampleRate)
                 : 1.0;
-            const size_t sampleCount = audioContext->headTrackBuffer.size();
+            const size_t sampleCount = leftBuffer.size();
+            const float* rightBuffer = (headTrack->audio.right.size() == sampleCount)
+                ? headTrack->audio.right.data()
+                : nullptr;
             for (jack_nframes_t i = 0; i < nframes; ++i) {
                 if (sampleCount == 0) break;
                 size_t idx = static_cast<size_t>(audioContext->headTrackPos);
@@ -739,20 +801,25 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
                         audioContext->headTrackPos = 0.0;
                         idx = 0;
                     } else {
-                        audioContext->headTrackActive = false;
+                        audioContext->headTrackActive.store(false, std::memory_order_relaxed);
                         break;
                     }
                 }
                 size_t idxNext = (idx + 1 < sampleCount) ? idx + 1 : idx;
                 double frac = audioContext->headTrackPos - static_cast<double>(idx);
-                float sample = static_cast<float>((1.0 - frac) * audioContext->headTrackBuffer[idx] +
-                                                   frac * audioContext->headTrackBuffer[idxNext]);
-                sample *= audioContext->headTrackGain;
-                sample *= soundtrackGain;
-                float absSample = std::fabs(sample);
+                const float trackGain = audioContext->headTrackGain * soundtrackGain;
+                float sample = static_cast<float>((1.0 - frac) * leftBuffer[idx] +
+                                                   frac * leftBuffer[idxNext]);
+                sample *= trackGain;
+                float sampleRight = sample;
+                if (rightBuffer) {
+                    sampleRight = static_cast<float>((1.0 - frac) * rightBuffer[idx] + frac * rightBuffer[idxNext]);
+                    sampleRight *= trackGain;
+                }
+                float absSample = std::max(std::fabs(sample), std::fabs(sampleRight));
                 if (absSample > soundtrackPeak) soundtrackPeak = absSample;
                 if (outL) outL[i] += sample * monoScale;
-                if (outR) outR[i] += sample * monoScale;
+                if (outR) outR[i] += sampleRight * monoScale;
                 audioContext->headTrackPos += step;
             }
         }
@@ -935,9 +1002,22 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
                             const auto& data = daw.clipAudio[clip.audioId];
                             uint64_t srcOffset = clip.sourceOffset + (overlapStart - clipStart);
                             uint64_t count = overlapEnd - overlapStart;
-                            if (srcOffset >= data.left.size()) continue;
-                            uint64_t maxCopy = std::min<uint64_t>(count, data.left.size() - srcOffset);
+                            const uint64_t sourceFrames = data.frameCount();
+                            if (srcOffset >= sourceFrames) continue;
+                            uint64_t maxCopy = std::min<uint64_t>(count, sourceFrames - srcOffset);
                             size_t dstBase = outOffset + static_cast<size_t>(overlapStart - segStart);
+                            if (data.isStreamed()) {
+                                if (dstBase >= clipBufferL.size()) continue;
+                                size_t streamCount = std::min<size_t>(static_cast<size_t>(maxCopy),
+                                                                      clipBufferL.size() - dstBase);
+                                DawStreamSystemLogic::ReadStreamFramesRT(daw,
+                                                                         data,
+                                                                         srcOffset,
+                                                                         streamCount,
+                                                                         clipBufferL.data() + dstBase,
+                                                                         clipBufferR.data() + dstBase);
+                                continue;
+                            }
                             for (uint64_t i = 0; i < maxCopy; ++i) {
                                 size_t dst = dstBase + static_cast<size_t>(i);
                                 if (dst >= clipBufferL.size()) break;
@@ -1493,14 +1573,8 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
         }
 
         if (daw.transportRecording.load(std::memory_order_relaxed)) {
-            constexpr int kMaxInputs = 32;
-            std::array<jack_default_audio_sample_t*, kMaxInputs> inBuffers{};
-            const int totalInputs = std::min<int>(static_cast<int>(audioContext->input_ports.size()), kMaxInputs);
-            for (int ch = 0; ch < totalInputs; ++ch) {
-                jack_port_t* port = audioContext->input_ports[ch];
-                if (!port) continue;
-                inBuffers[ch] = (jack_default_audio_sample_t*)jack_port_get_buffer(port, nframes);
-            }
+            const auto& inBuffers = io.inputs;
+            const int totalInputs = io.inputCount;
             const float* micBuf = (needMicBuffer && !audioContext->micCaptureBuffer.empty())
                 ? audioContext->micCaptureBuffer.data()
                 : nullptr;
@@ -1534,22 +1608,7 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
                 if (!rightSource) {
                     rightSource = leftSource;
                 }
-                size_t writeSpaceLeft = jack_ringbuffer_write_space(track.recordRing);
-                size_t framesToWriteLeft = std::min<size_t>(nframes, writeSpaceLeft / sizeof(float));
-                if (framesToWriteLeft > 0) {
-                    jack_ringbuffer_write(track.recordRing,
-                                          reinterpret_cast<const char*>(leftSource),
-                                          framesToWriteLeft * sizeof(float));
-                }
-                if (track.recordRingRight && rightSource) {
-                    size_t writeSpaceRight = jack_ringbuffer_write_space(track.recordRingRight);
-                    size_t framesToWriteRight = std::min<size_t>(nframes, writeSpaceRight / sizeof(float));
-                    if (framesToWriteRight > 0) {
-                        jack_ringbuffer_write(track.recordRingRight,
-                                              reinterpret_cast<const char*>(rightSource),
-                                              framesToWriteRight * sizeof(float));
-                    }
-                }
+                DawRecordSystemLogic::WriteRecordInputRT(track, leftSource, rightSource, static_cast<size_t>(nframes));
             }
         }
     }
@@ -1562,92 +1621,244 @@ int jack_process_callback(jack_nframes_t nframes, void* arg) {
     return 0;
 }
 
+// --- JACK CALLBACKS ---
+int jack_process_callback(jack_nframes_t nframes, void* arg) {
+    auto* audioContext = static_cast<AudioContext*>(arg);
+    AudioBlockIO io;
+    io.frames = nframes;
+    io.outputCount = std::min<int>(static_cast<int>(audioContext->output_ports.size()), AudioBlockIO::kMaxChannels);
+    for (int ch = 0; ch < io.outputCount; ++ch) {
+        jack_port_t* port = audioContext->output_ports[ch];
+        io.outputs[ch] = port ? (jack_default_audio_sample_t*)jack_port_get_buffer(port, nframes) : nullptr;
+    }
+    io.inputCount = std::min<int>(static_cast<int>(audioContext->input_ports.size()), AudioBlockIO::kMaxChannels);
+    for (int ch = 0; ch < io.inputCount; ++ch) {
+        jack_port_t* port = audioContext->input_ports[ch];
+        io.inputs[ch] = port ? (const jack_default_audio_sample_t*)jack_port_get_buffer(port, nframes) : nullptr;
+    }
+    return processAudioBlock(audioContext, io);
+}
+
 void jack_shutdown_callback(void* arg) {
     std::cerr << "JACK server has shut down." << std::endl;
 }
 
 // --- SYSTEM LOGIC ---
 namespace AudioSystemLogic {
-    void InitializeAudio(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
-        if (!baseSystem.audio) { std::cerr << "FATAL: AudioContext not available." << std::endl; exit(-1); }
-        AudioContext& audio = *baseSystem.audio;
-        srand(time(NULL));
-        const char* client_name = "cardinal_eds";
-        jack_status_t status;
-        audio.client = jack_client_open(client_name, JackNullOption, &status);
-        if (audio.client == nullptr) { std::cerr << "FATAL: jack_client_open() failed." << std::endl; exit(1); }
-        jack_set_process_callback(audio.client, jack_process_callback, &audio);
-        jack_on_shutdown(audio.client, jack_shutdown_callback, &audio);
-        audio.ring_buffer = jack_ringbuffer_create(2048 * sizeof(float));
-        jack_ringbuffer_mlock(audio.ring_buffer);
-        audio.gameplaySfxEventRing = jack_ringbuffer_create(sizeof(GameplaySfxEvent) * 256);
-        if (audio.gameplaySfxEventRing) {
-            jack_ringbuffer_mlock(audio.gameplaySfxEventRing);
-        }
-        audio.output_ports.clear();
-        audio.input_ports.clear();
-        for (int ch = 0; ch < audio.jackOutputChannels; ++ch) {
-            std::string name;
-            if (ch >= audio.dawOutputStart) {
-                int dawIndex = ch - audio.dawOutputStart;
-                if (dawIndex == 0) {
-                    name = "daw_L";
-                } else if (dawIndex == 1) {
-                    name = "daw_S";
-                } else if (dawIndex == 2) {
-                    name = "daw_FF";
-                } else if (dawIndex == 3) {
-                    name = "daw_R";
+    namespace {
+        // Opens the JACK client, registers the engine's ports and connects them to
+        // the physical devices. Returns false when no server is reachable.
+        bool openJackBackend(AudioContext& audio, t_CKINT& outSampleRate, t_CKINT& outBufferFrames) {
+            const char* client_name = "cardinal_eds";
+            jack_status_t status;
+            audio.client = jack_client_open(client_name, JackNullOption, &status);
+            if (audio.client == nullptr) { std::cerr << "FATAL: jack_client_open() failed." << std::endl; return false; }
+            jack_set_process_callback(audio.client, jack_process_callback, &audio);
+            jack_on_shutdown(audio.client, jack_shutdown_callback, &audio);
+            audio.output_ports.clear();
+            audio.input_ports.clear();
+            for (int ch = 0; ch < audio.jackOutputChannels; ++ch) {
+                std::string name;
+                if (ch >= audio.dawOutputStart) {
+                    int dawIndex = ch - audio.dawOutputStart;
+                    if (dawIndex == 0) {
+                        name = "daw_L";
+                    } else if (dawIndex == 1) {
+                        name = "daw_S";
+                    } else if (dawIndex == 2) {
+                        name = "daw_FF";
+                    } else if (dawIndex == 3) {
+                        name = "daw_R";
+                    } else {
+                        name = "output_" + std::to_string(ch + 1);
+                    }
                 } else {
                     name = "output_" + std::to_string(ch + 1);
                 }
-            } else {
-                name = "output_" + std::to_string(ch + 1);
+                jack_port_t* p = jack_port_register(audio.client, name.c_str(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+                audio.output_ports.push_back(p);
             }
-            jack_port_t* p = jack_port_register(audio.client, name.c_str(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
-            audio.output_ports.push_back(p);
-        }
-        for (int ch = 0; ch < audio.jackInputChannels; ++ch) {
-            std::string name = "input_" + std::to_string(ch + 1);
-            jack_port_t* p = jack_port_register(audio.client, name.c_str(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
-            audio.input_ports.push_back(p);
+            for (int ch = 0; ch < audio.jackInputChannels; ++ch) {
+                std::string name = "input_" + std::to_string(ch + 1);
+                jack_port_t* p = jack_port_register(audio.client, name.c_str(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+                audio.input_ports.push_back(p);
+            }
+            audio.midi_input_ports.clear();
+            if (jack_activate(audio.client)) { std::cerr << "FATAL: Cannot activate client." << std::endl; return false; }
+            // Auto-connect outputs to physical playback ports.
+            if (const char** playbackPorts = jack_get_ports(audio.client, nullptr, JACK_DEFAULT_AUDIO_TYPE,
+                                                            JackPortIsInput | JackPortIsPhysical)) {
+                for (size_t i = 0; i < audio.output_ports.size() && playbackPorts[i] && i < 2; ++i) {
+                    if (!audio.output_ports[i]) continue;
+                    jack_connect(audio.client, jack_port_name(audio.output_ports[i]), playbackPorts[i]);
+                }
+                jack_free(playbackPorts);
+            }
+            // Auto-connect physical capture ports to DAW inputs.
+            audio.physicalInputPorts.clear();
+            if (const char** capturePorts = jack_get_ports(audio.client, nullptr, JACK_DEFAULT_AUDIO_TYPE,
+                                                           JackPortIsOutput | JackPortIsPhysical)) {
+                for (size_t i = 0; capturePorts[i]; ++i) {
+                    audio.physicalInputPorts.emplace_back(capturePorts[i]);
+                }
+                for (size_t i = 0; i < audio.input_ports.size() && i < audio.physicalInputPorts.size(); ++i) {
+                    if (!audio.input_ports[i]) continue;
+                    jack_connect(audio.client, audio.physicalInputPorts[i].c_str(), jack_port_name(audio.input_ports[i]));
+                }
+                jack_free(capturePorts);
+            }
+            std::cout << "Audio I/O System Initialized." << std::endl;
+
+            if (!audio.physicalInputPorts.empty()) {
+                std::cout << "JACK physical inputs:" << std::endl;
+                for (const auto& port : audio.physicalInputPorts) {
+                    std::cout << "  " << port << std::endl;
+                }
+            }
+
+            outSampleRate = static_cast<t_CKINT>(jack_get_sample_rate(audio.client));
+            outBufferFrames = static_cast<t_CKINT>(jack_get_buffer_size(audio.client));
+            return true;
         }
-        audio.midi_input_ports.clear();
-        if (jack_activate(audio.client)) { std::cerr << "FATAL: Cannot activate client." << std::endl; exit(1); }
-        // Auto-connect outputs to physical playback ports.
-        if (const char** playbackPorts = jack_get_ports(audio.client, nullptr, JACK_DEFAULT_AUDIO_TYPE,
-                                                        JackPortIsInput | JackPortIsPhysical)) {
-            for (size_t i = 0; i < audio.output_ports.size() && playbackPorts[i] && i < 2; ++i) {
-                if (!audio.output_ports[i]) continue;
-                jack_connect(audio.client, jack_port_name(audio.output_ports[i]), playbackPorts[i]);
+
+        void captureOfflineBlock(OfflineAudioDriver& driver, jack_nframes_t frames) {
+            const size_t channels = driver.outputs.size();
+            if (driver.captureToMemory) {
+                for (size_t ch = 0; ch < channels; ++ch) {
+                    const std::vector<float>& out = driver.outputs[ch];
+                    driver.captured[ch].insert(driver.captured[ch].end(), out.begin(), out.begin() + frames);
+                }
+            }
+            if (driver.captureWav.isOpen()) {
+                driver.interleaveScratch.resize(static_cast<size_t>(frames) * channels);
+                for (jack_nframes_t i = 0; i < frames; ++i) {
+                    for (size_t ch = 0; ch < channels; ++ch) {
+                        driver.interleaveScratch[i * channels + ch] = driver.outputs[ch][i];
+                    }
+                }
+                if (!driver.captureWav.writeInterleaved(driver.interleaveScratch.data(), frames)) {
+                    std::cerr << "AudioSystem: offline capture write failed for " << driver.captureWav.path << std::endl;
+                    driver.captureWav.close();
+                }
             }
-            jack_free(playbackPorts);
         }
-        // Auto-connect physical capture ports to DAW inputs.
+    }
+
+    bool OpenOfflineAudio(AudioContext& audio, uint32_t sampleRate, uint32_t bufferFrames) {
+        if (audio.client || sampleRate == 0 || bufferFrames == 0) return false;
+        auto driver = std::make_shared<OfflineAudioDriver>();
+        driver->sampleRate = sampleRate;
+        driver->bufferFrames = bufferFrames;
+        driver->outputs.assign(static_cast<size_t>(std::max(0, audio.jackOutputChannels)),
+                               std::vector<float>(bufferFrames, 0.0f));
+        driver->inputs.assign(static_cast<size_t>(std::max(0, audio.jackInputChannels)),
+                              std::vector<float>(bufferFrames, 0.0f));
+        audio.output_ports.clear();
+        audio.input_ports.clear();
+        audio.midi_input_ports.clear();
         audio.physicalInputPorts.clear();
-        if (const char** capturePorts = jack_get_ports(audio.client, nullptr, JACK_DEFAULT_AUDIO_TYPE,
-                                                       JackPortIsOutput | JackPortIsPhysical)) {
-            for (size_t i = 0; capturePorts[i]; ++i) {
-                audio.physicalInputPorts.emplace_back(capturePorts[i]);
+        audio.offlineDriver = std::move(driver);
+        return true;
+    }
+
+    // Runs the same process function the JACK callback does, on the calling
+    // thread. The input script runs first and must not resize the channels.
+    void RenderOfflineBlocks(AudioContext& audio, size_t blockCount) {
+        if (!audio.offlineDriver) return;
+        OfflineAudioDriver& driver = *audio.offlineDriver;
+        AudioBlockIO io;
+        io.frames = driver.bufferFrames;
+        io.outputCount = std::min<int>(static_cast<int>(driver.outputs.size()), AudioBlockIO::kMaxChannels);
+        io.inputCount = std::min<int>(static_cast<int>(driver.inputs.size()), AudioBlockIO::kMaxChannels);
+        for (int ch = 0; ch < io.outputCount; ++ch) io.outputs[ch] = driver.outputs[ch].data();
+        for (int ch = 0; ch < io.inputCount; ++ch) io.inputs[ch] = driver.inputs[ch].data();
+        for (size_t block = 0; block < blockCount; ++block) {
+            for (auto& input : driver.inputs) {
+                std::fill(input.begin(), input.end(), 0.0f);
             }
-            for (size_t i = 0; i < audio.input_ports.size() && i < audio.physicalInputPorts.size(); ++i) {
-                if (!audio.input_ports[i]) continue;
-                jack_connect(audio.client, audio.physicalInputPorts[i].c_str(), jack_port_name(audio.input_ports[i]));
+            if (driver.inputScript) {
+                driver.inputScript(driver.framesRendered, driver.bufferFrames, driver.inputs);
             }
-            jack_free(capturePorts);
+            processAudioBlock(&audio, io);
+            captureOfflineBlock(driver, io.frames);
+            driver.framesRendered += io.frames;
+        }
+    }
+
+    bool StartOfflineCapture(AudioContext& audio, const std::string& wavPath, bool toMemory) {
+        if (!audio.offlineDriver) return false;
+        OfflineAudioDriver& driver = *audio.offlineDriver;
+        driver.captureToMemory = toMemory;
+        driver.captured.assign(driver.outputs.size(), {});
+        if (wavPath.empty()) return true;
+        const uint16_t channels = static_cast<uint16_t>(std::max<size_t>(1, driver.outputs.size()));
+        if (!driver.captureWav.open(wavPath, channels, driver.sampleRate, true)) {
+            std::cerr << "AudioSystem: failed to open offline capture " << wavPath << std::endl;
+            return false;
         }
-        std::cout << "Audio I/O System Initialized." << std::endl;
+        return true;
+    }
+
+    void StopOfflineCapture(AudioContext& audio) {
+        if (!audio.offlineDriver) return;
+        audio.offlineDriver->captureToMemory = false;
+        audio.offlineDriver->captureWav.close();
+    }
+
+    // Update step: keeps the offline backend moving with the frame clock, or by
+    // a fixed number of blocks per frame when audioOfflineBlocksPerUpdate is set
+    // (which makes a whole run reproducible regardless of frame timing).
+    void PumpOfflineAudio(BaseSystem& baseSystem, std::vector<Entity>&, float dt, GLFWwindow*) {
+        if (!baseSystem.audio || !baseSystem.audio->offlineDriver) return;
+        AudioContext& audio = *baseSystem.audio;
+        OfflineAudioDriver& driver = *audio.offlineDriver;
+        size_t blocks = 0;
+        if (driver.blocksPerUpdate > 0) {
+            blocks = static_cast<size_t>(driver.blocksPerUpdate);
+        } else {
+            const double blockSeconds = static_cast<double>(driver.bufferFrames) / static_cast<double>(driver.sampleRate);
+            driver.pendingSeconds = std::min(driver.pendingSeconds + static_cast<double>(std::max(0.0f, dt)), 1.0);
+            blocks = static_cast<size_t>(driver.pendingSeconds / blockSeconds);
+            driver.pendingSeconds -= static_cast<double>(blocks) * blockSeconds;
+        }
+        RenderOfflineBlocks(audio, blocks);
+    }
 
-        if (!audio.physicalInputPorts.empty()) {
-            std::cout << "JACK physical inputs:" << std::endl;
-            for (const auto& port : audio.physicalInputPorts) {
-                std::cout << "  " << port << std::endl;
+    void InitializeAudio(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
+        if (!baseSystem.audio) { std::cerr << "FATAL: AudioContext not available." << std::endl; exit(-1); }
+        AudioContext& audio = *baseSystem.audio;
+        srand(time(NULL));
+        audio.ring_buffer = jack_ringbuffer_create(2048 * sizeof(float));
+        jack_ringbuffer_mlock(audio.ring_buffer);
+        audio.gameplaySfxEventRing = jack_ringbuffer_create(sizeof(GameplaySfxEvent) * 256);
+        if (audio.gameplaySfxEventRing) {
+            jack_ringbuffer_mlock(audio.gameplaySfxEventRing);
+        }
+        audio.chuckSfxTriggerRing = jack_ringbuffer_create(sizeof(ChuckSfxTrigger) * 256);
+        if (audio.chuckSfxTriggerRing) {
+            jack_ringbuffer_mlock(audio.chuckSfxTriggerRing);
+        }
+        const std::string backend = getRegistryString(baseSystem, "AudioBackend", "jack");
+        t_CKINT sampleRate = 0;
+        t_CKINT bufferFrames = 0;
+        if (backend == "offline") {
+            const int rate = std::max(8000, RenderInitSystemLogic::getRegistryInt(baseSystem, "audioOfflineSampleRate", 48000));
+            const int frames = std::max(16, RenderInitSystemLogic::getRegistryInt(baseSystem, "audioOfflineBufferFrames", 256));
+            OpenOfflineAudio(audio, static_cast<uint32_t>(rate), static_cast<uint32_t>(frames));
+            audio.offlineDriver->blocksPerUpdate = std::max(0, RenderInitSystemLogic::getRegistryInt(baseSystem, "audioOfflineBlocksPerUpdate", 0));
+            const std::string capturePath = getRegistryString(baseSystem, "audioOfflineCapturePath", "");
+            if (!capturePath.empty()) {
+                StartOfflineCapture(audio, capturePath, false);
             }
+            sampleRate = rate;
+            bufferFrames = frames;
+            std::cout << "Audio I/O System Initialized (offline, " << rate << " Hz, "
+                      << frames << " frames/block)." << std::endl;
+        } else {
+            if (!openJackBackend(audio, sampleRate, bufferFrames)) exit(1);
         }
 
-        // Initialize ChucK engine to render via JACK
-        const t_CKINT sampleRate = static_cast<t_CKINT>(jack_get_sample_rate(audio.client));
-        const t_CKINT bufferFrames = static_cast<t_CKINT>(jack_get_buffer_size(audio.client));
+        // Initialize ChucK engine to render through the backend
         audio.sampleRate = static_cast<float>(sampleRate);
         audio.chuckBufferFrames = bufferFrames;
         audio.chuckInputChannels = 0;
@@ -1658,7 +1869,7 @@ namespace AudioSystemLogic {
         audio.chuck->setParam(CHUCK_PARAM_OUTPUT_CHANNELS, audio.chuckOutputChannels);
         // Keep VM alive even when no shreds are currently active; prevents startup race-to-halt.
         audio.chuck->setParam(CHUCK_PARAM_VM_HALT, FALSE);
-        audio.chuck->setParam(CHUCK_PARAM_IS_REALTIME_AUDIO_HINT, TRUE);
+        audio.chuck->setParam(CHUCK_PARAM_IS_REALTIME_AUDIO_HINT, audio.offlineDriver ? FALSE : TRUE);
         // Allocate buffers expected by ChucK::run (input optional, output will be provided by JACK)
         if (audio.chuckInputChannels > 0) {
             audio.chuckInput = new SAMPLE[bufferFrames * audio.chuckInputChannels]();
@@ -1705,18 +1916,14 @@ namespace AudioSystemLogic {
         audio.rayItdWriteIndex = 0;
         audio.headRayItdBuffer.assign(itdSamples, 0.0f);
         audio.headRayItdWriteIndex = 0;
-        audio.rayTestBuffer.clear();
-        audio.rayTestSampleRate = 0;
         audio.rayTestPos = 0.0;
         audio.rayTestGain = 0.0f;
         audio.rayTestPan = 0.0f;
         audio.rayTestActive = false;
         audio.rayTestLoop = true;
-        audio.headTrackBuffer.clear();
-        audio.headTrackSampleRate = 0;
         audio.headTrackPos = 0.0;
         audio.headTrackGain = 1.0f;
-        audio.headTrackActive = false;
+        audio.headTrackActive.store(false, std::memory_order_relaxed);
         audio.headTrackLoop = true;
         audio.chuckMainLevelGain.store(0.0f, std::memory_order_relaxed);
         audio.soundtrackLevelGain.store(0.0f, std::memory_order_relaxed);
@@ -1749,7 +1956,9 @@ namespace AudioSystemLogic {
         audio.chuckHeadCompileRequested = true; // compile player-head source script on next update
     }
 
-    bool TriggerGameplaySfx(BaseSystem& baseSystem, const std::string& cueName, float gain) {
+    // Main thread. A cue retriggered inside its cooldown is dropped but still
+    // reported as handled, so callers do not fall back to another backend.
+    bool TriggerGameplaySfx(BaseSystem& baseSystem, const std::string& cueName, float gain, float cooldownSeconds) {
         if (!baseSystem.audio) return false;
         AudioContext& audio = *baseSystem.audio;
         if (!audio.gameplaySfxEnabled.load(std::memory_order_relaxed)) return false;
@@ -1757,6 +1966,9 @@ namespace AudioSystemLogic {
         int clipIndex = findGameplaySfxClipIndex(audio, cueName);
         if (clipIndex < 0 || clipIndex >= static_cast<int>(audio.gameplaySfxBuffers.size())) return false;
         if (audio.gameplaySfxBuffers[static_cast<size_t>(clipIndex)].empty()) return false;
+        const double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        double& lastTrigger = audio.gameplaySfxLastTrigger[static_cast<size_t>(clipIndex)];
+        if (now - lastTrigger < static_cast<double>(cooldownSeconds)) return true;
         GameplaySfxEvent ev;
         ev.clipIndex = static_cast<uint16_t>(clipIndex);
         ev.gain = std::clamp(gain, 0.0f, 4.0f);
@@ -1766,13 +1978,22 @@ namespace AudioSystemLogic {
         jack_ringbuffer_write(audio.gameplaySfxEventRing,
                               reinterpret_cast<const char*>(&ev),
                               sizeof(GameplaySfxEvent));
+        lastTrigger = now;
         return true;
     }
 
     void CleanupAudio(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
-        if (!baseSystem.audio || !baseSystem.audio->client) return;
-        jack_deactivate(baseSystem.audio->client);
-        jack_client_close(baseSystem.audio->client);
+        if (!baseSystem.audio) return;
+        if (!baseSystem.audio->client && !baseSystem.audio->offlineDriver) return;
+        if (baseSystem.audio->client) {
+            jack_deactivate(baseSystem.audio->client);
+            jack_client_close(baseSystem.audio->client);
+            baseSystem.audio->client = nullptr;
+        }
+        if (baseSystem.audio->offlineDriver) {
+            StopOfflineCapture(*baseSystem.audio);
+            baseSystem.audio->offlineDriver.reset();
+        }
         baseSystem.audio->output_ports.clear();
         baseSystem.audio->input_ports.clear();
         if (baseSystem.audio->ring_buffer) {
@@ -1783,6 +2004,10 @@ namespace AudioSystemLogic {
             jack_ringbuffer_free(baseSystem.audio->gameplaySfxEventRing);
             baseSystem.audio->gameplaySfxEventRing = nullptr;
         }
+        if (baseSystem.audio->chuckSfxTriggerRing) {
+            jack_ringbuffer_free(baseSystem.audio->chuckSfxTriggerRing);
+            baseSystem.audio->chuckSfxTriggerRing = nullptr;
+        }
         if (baseSystem.audio->chuckInput) {
             delete[] baseSystem.audio->chuckInput;
             baseSystem.audio->chuckInput = nullptr;
@@ -1796,6 +2021,9 @@ namespace AudioSystemLogic {
         baseSystem.audio->gameplaySfxBuffers.clear();
         baseSystem.audio->gameplaySfxSampleRates.clear();
         baseSystem.audio->gameplaySfxVoices.clear();
+        baseSystem.audio->chuckSfxSoundCount.store(0, std::memory_order_relaxed);
+        baseSystem.audio->chuckSfxSounds.clear();
+        baseSystem.audio->chuckSfxPreloaded = false;
         std::cout << "Audio I/O System Cleaned Up." << std::endl;
     }
 }
@@ -74,8 +74,9 @@ namespace AudioVisualizerFollowerSystemLogic {
             if (world.name != kFollowerWorldName) continue;
             for (auto& instance : world.instances) {
                 const bool isVisualizer = (instance.prototypeID == visualizerProtoID) || (instance.name == "AudioVisualizer");
-                if (!isVisualizer) continue;
+                if (!isVisualizer || instance.position == targetPosition) continue;
                 instance.position = targetPosition;
+                world.instanceEdits += 1;
             }
         }
     }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace AuroraSystemLogic {
 
     struct RibbonLayer { float alpha; float scaleX; float scaleY; GLenum sf; GLenum df; };
@@ -9,6 +11,7 @@ namespace AuroraSystemLogic {
     static void initAuroraResources(BaseSystem& baseSystem) {
         if (!baseSystem.renderer) return;
         RendererContext& renderer = *baseSystem.renderer;
+        RenderDevice::Device& device = RenderDevice::current();
         if (!renderer.auroraShader) {
             renderer.auroraShader = std::make_unique<Shader>(
                 baseSystem.world->shaders["AURORA_VERTEX_SHADER"].c_str(),
@@ -50,8 +53,8 @@ namespace AuroraSystemLogic {
                 renderer.auroras[i].palette = (i < 2) ? 0 : 1;
                 renderer.auroras[i].bend = 40.0f + frand() * 200.0f;
                 renderer.auroras[i].seed = frand();
-                glGenVertexArrays(1, &renderer.auroras[i].vao);
-                glGenBuffers(1, &renderer.auroras[i].vbo);
+                renderer.auroras[i].vao = device.createVertexArray();
+                renderer.auroras[i].vbo = device.createBuffer();
                 renderer.auroras[i].vertexCount = 0;
             }
         }
@@ -126,23 +129,25 @@ namespace AuroraSystemLogic {
         }
 
         a.vertexCount = static_cast<int>(verts.size() / 5);
-        glBindVertexArray(a.vao);
-        glBindBuffer(GL_ARRAY_BUFFER, a.vbo);
-        glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(float), verts.data(), GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
-        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(4 * sizeof(float))); glEnableVertexAttribArray(2);
+        RenderDevice::Device& device = RenderDevice::current();
+        device.bindVertexArray(a.vao);
+        device.bindBuffer(GL_ARRAY_BUFFER, a.vbo);
+        device.bufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(float), verts.data(), GL_DYNAMIC_DRAW);
+        device.vertexAttribPointer(0, 3, GL_FLOAT, false, 5 * sizeof(float), 0); device.enableVertexAttribArray(0);
+        device.vertexAttribPointer(1, 1, GL_FLOAT, false, 5 * sizeof(float), 3 * sizeof(float)); device.enableVertexAttribArray(1);
+        device.vertexAttribPointer(2, 1, GL_FLOAT, false, 5 * sizeof(float), 4 * sizeof(float)); device.enableVertexAttribArray(2);
     }
 
     void RenderAuroras(BaseSystem& baseSystem, float time, const glm::mat4& view, const glm::mat4& projection) {
         initAuroraResources(baseSystem);
         if (!baseSystem.renderer || !baseSystem.renderer->auroraShader) return;
         RendererContext& renderer = *baseSystem.renderer;
+        RenderDevice::Device& device = RenderDevice::current();
 
-        glDisable(GL_DEPTH_TEST);
-        glDepthMask(GL_FALSE);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.disable(GL_DEPTH_TEST);
+        device.depthMask(false);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         // Rebuild ribbons
         for (auto& a : renderer.auroras) {
@@ -167,25 +172,25 @@ namespace AuroraSystemLogic {
                 model = glm::rotate(model, a.yaw, glm::vec3(0,1,0));
                 model = glm::scale(model, glm::vec3(a.width, a.height, a.width * 0.12f));
 
-                glBlendFunc(layer.sf, layer.df);
+                device.blendFunc(layer.sf, layer.df);
                 renderer.auroraShader->setMat4("model", model);
                 renderer.auroraShader->setInt("paletteIndex", a.palette);
                 renderer.auroraShader->setFloat("passAlpha", layer.alpha);
-                glBindVertexArray(a.vao);
-                glDrawArrays(GL_TRIANGLES, 0, a.vertexCount);
+                device.bindVertexArray(a.vao);
+                device.drawArrays(GL_TRIANGLES, 0, a.vertexCount);
 
                 if (li == 1) { // single halo on middle layer to avoid double-add brightening
                     glm::mat4 haloModel = glm::scale(model, glm::vec3(1.25f, 1.35f, 1.05f));
                     renderer.auroraShader->setMat4("model", haloModel);
                     renderer.auroraShader->setFloat("passAlpha", layer.alpha * 0.6f);
-                    glDrawArrays(GL_TRIANGLES, 0, a.vertexCount);
+                    device.drawArrays(GL_TRIANGLES, 0, a.vertexCount);
                 }
             }
         }
 
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
+        device.disable(GL_BLEND);
+        device.depthMask(true);
+        device.enable(GL_DEPTH_TEST);
     }
 
 }
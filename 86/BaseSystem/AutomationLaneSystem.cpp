@@ -9,8 +9,10 @@
 #include <limits>
 #include <vector>
 
+#include "BaseSystem/UIBatch.h"
 #include "BaseSystem/Vst3Host.h"
 
+namespace UIBatchSystemLogic { UIBatch::Builder& Frame(BaseSystem& baseSystem); }
 namespace DawLaneTimelineSystemLogic {
     struct LaneLayout;
     bool hasDawUiWorld(const LevelContext& level);
@@ -121,10 +123,13 @@ namespace AutomationLaneSystemLogic {
                 if (point.offsetSample > clip.length) point.offsetSample = clip.length;
                 point.value = clamp01(point.value);
             }
-            std::sort(clip.points.begin(), clip.points.end(), [](const AutomationPoint& a, const AutomationPoint& b) {
+            auto byOffset = [](const AutomationPoint& a, const AutomationPoint& b) {
                 if (a.offsetSample == b.offsetSample) return a.value < b.value;
                 return a.offsetSample < b.offsetSample;
-            });
+            };
+            // Runs for every visible clip each frame; points are almost always in order already.
+            if (std::is_sorted(clip.points.begin(), clip.points.end(), byOffset)) return;
+            std::sort(clip.points.begin(), clip.points.end(), byOffset);
         }
 
         float valueFromY(float y, float bodyTop, float bodyBottom) {
@@ -373,20 +378,8 @@ namespace AutomationLaneSystemLogic {
         if (!DawLaneTimelineSystemLogic::hasDawUiWorld(*baseSystem.level)) return;
 
         DawContext& daw = *baseSystem.daw;
-        RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
 
-        if (!renderer.uiColorShader) {
-            renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(),
-                                                              world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-        }
-        if (renderer.uiMidiLaneVAO == 0) {
-            glGenVertexArrays(1, &renderer.uiMidiLaneVAO);
-        }
-        if (renderer.uiMidiLaneVBO == 0) {
-            glGenBuffers(1, &renderer.uiMidiLaneVBO);
-        }
-
         const auto laneLayout = DawLaneTimelineSystemLogic::ComputeLaneLayout(baseSystem, daw, win);
         const int audioTrackCount = laneLayout.audioTrackCount;
         const int midiTrackCount = baseSystem.midi ? static_cast<int>(baseSystem.midi->tracks.size()) : 0;
@@ -933,26 +926,7 @@ namespace AutomationLaneSystemLogic {
         }
 
         if (!g_vertices.empty()) {
-            glDisable(GL_DEPTH_TEST);
-            glEnable(GL_BLEND);
-            glBlendColor(0.0f, 0.0f, 0.0f, kLaneAlpha);
-            glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-            glBindVertexArray(renderer.uiMidiLaneVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.uiMidiLaneVBO);
-            glBufferData(GL_ARRAY_BUFFER,
-                         g_vertices.size() * sizeof(UiVertex),
-                         g_vertices.data(),
-                         GL_DYNAMIC_DRAW);
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)0);
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)(sizeof(glm::vec2)));
-
-            renderer.uiColorShader->use();
-            renderer.uiColorShader->setFloat("alpha", kLaneAlpha);
-            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(g_vertices.size()));
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glEnable(GL_DEPTH_TEST);
+            UIBatchSystemLogic::Frame(baseSystem).addColored(g_vertices, kLaneAlpha);
         }
 
         g_rightMouseWasDown = rightDown;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+struct BlockCellHash {
+    std::size_t operator()(const glm::ivec3& v) const noexcept {
+        uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(v.x)) * 0x9E3779B185EBCA87ull;
+        h ^= static_cast<uint64_t>(static_cast<uint32_t>(v.y)) * 0xC2B2AE3D27D4EB4Full;
+        h ^= static_cast<uint64_t>(static_cast<uint32_t>(v.z)) * 0x165667B19E3779F9ull;
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+};
+
+// Integer block cell -> slot of the block instance occupying it in one
+// world's instance list. Only the owner knows the instance list, so slots are
+// taken on trust here; callers check the instance a slot names before using
+// it and rebuild when the list was reordered behind the index's back.
+struct BlockCellIndex {
+    std::unordered_map<glm::ivec3, int32_t, BlockCellHash> slots;
+    size_t syncedInstanceCount = 0;
+
+    static glm::ivec3 cellOf(const glm::vec3& position) {
+        return glm::ivec3(glm::round(position));
+    }
+
+    void clear() {
+        slots.clear();
+        syncedInstanceCount = 0;
+    }
+
+    int32_t find(const glm::ivec3& cell) const {
+        auto it = slots.find(cell);
+        return it == slots.end() ? -1 : it->second;
+    }
+
+    void spawn(const glm::ivec3& cell, int32_t slot) {
+        slots[cell] = slot;
+    }
+
+    void despawn(const glm::ivec3& cell) {
+        slots.erase(cell);
+    }
+
+    // The instance in `cell` moved from slot `from` to slot `to`, e.g. the
+    // last instance filling a swap-and-pop hole. No-op if the cell points
+    // elsewhere.
+    void move(const glm::ivec3& cell, int32_t from, int32_t to) {
+        auto it = slots.find(cell);
+        if (it == slots.end() || it->second != from) return;
+        it->second = to;
+    }
+};
@@ -7,18 +7,18 @@
 #include <cstdint>
 #include <limits>
 #include <string>
-#include <unordered_map>
 
 namespace HostLogic { EntityInstance CreateInstance(BaseSystem& baseSystem, int prototypeID, glm::vec3 position, glm::vec3 color); }
 namespace BlockSelectionSystemLogic {
     void RemoveBlockFromCache(BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position);
     bool HasBlockAt(BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position);
+    const EntityInstance* FindBlockInstance(const BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position);
     void AddBlockToCache(BaseSystem& baseSystem, std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position, int prototypeID);
 }
 namespace StructureCaptureSystemLogic { void NotifyBlockChanged(BaseSystem& baseSystem, int worldIndex, const glm::vec3& position); }
 namespace RayTracedAudioSystemLogic { void InvalidateSourceCache(BaseSystem& baseSystem); }
 namespace ChucKSystemLogic { void StopNoiseShred(BaseSystem& baseSystem); }
-namespace AudioSystemLogic { bool TriggerGameplaySfx(BaseSystem& baseSystem, const std::string& cueName, float gain); }
+namespace AudioSystemLogic { bool TriggerGameplaySfx(BaseSystem& baseSystem, const std::string& cueName, float gain, float cooldownSeconds); }
 namespace VoxelMeshingSystemLogic { void RequestPriorityVoxelRemesh(BaseSystem& baseSystem, std::vector<Entity>& prototypes, const glm::ivec3& worldCell); }
 namespace TreeGenerationSystemLogic { void NotifyPineLogRemoved(const glm::ivec3& worldCell, int removedPrototypeID); }
 namespace GemSystemLogic {
@@ -271,15 +271,11 @@ namespace BlockChargeSystemLogic {
 
             int worldIndex = player.targetedWorldIndex;
             if (worldIndex < 0 || worldIndex >= static_cast<int>(level.worlds.size())) return -1;
-            const Entity& world = level.worlds[static_cast<size_t>(worldIndex)];
-            for (const auto& inst : world.instances) {
-                if (glm::distance(inst.position, player.targetedBlockPosition) > POSITION_EPSILON) continue;
-                if (inst.prototypeID < 0 || inst.prototypeID >= static_cast<int>(prototypes.size())) continue;
-                if (outCell) *outCell = glm::ivec3(glm::round(inst.position));
-                if (outFromVoxel) *outFromVoxel = false;
-                return inst.prototypeID;
-            }
-            return -1;
+            const EntityInstance* inst = BlockSelectionSystemLogic::FindBlockInstance(baseSystem, prototypes, worldIndex, player.targetedBlockPosition);
+            if (!inst || glm::distance(inst->position, player.targetedBlockPosition) > POSITION_EPSILON) return -1;
+            if (outCell) *outCell = glm::ivec3(glm::round(inst->position));
+            if (outFromVoxel) *outFromVoxel = false;
+            return inst->prototypeID;
         }
 
         bool hasWallStoneAtCell(const BaseSystem& baseSystem,
@@ -294,13 +290,8 @@ namespace BlockChargeSystemLogic {
                 }
             }
             if (worldIndexHint < 0 || worldIndexHint >= static_cast<int>(level.worlds.size())) return false;
-            const Entity& world = level.worlds[static_cast<size_t>(worldIndexHint)];
-            const glm::vec3 cellPos = glm::vec3(cell);
-            for (const auto& inst : world.instances) {
-                if (glm::distance(inst.position, cellPos) > POSITION_EPSILON) continue;
-                if (isWallStonePrototypeID(prototypes, inst.prototypeID)) return true;
-            }
-            return false;
+            const EntityInstance* inst = BlockSelectionSystemLogic::FindBlockInstance(baseSystem, prototypes, worldIndexHint, glm::vec3(cell));
+            return inst && isWallStonePrototypeID(prototypes, inst->prototypeID);
         }
 
         uint32_t packColor(const glm::vec3& color) {
@@ -324,19 +315,13 @@ namespace BlockChargeSystemLogic {
             return glm::vec3(r, g, b);
         }
 
+        // Each backend keeps its own per-sound cooldown.
         bool triggerGameplaySfx(BaseSystem& baseSystem, const char* fileName, float cooldownSeconds = 0.0f) {
             if (!fileName) return false;
-            static std::unordered_map<std::string, double> s_lastTrigger;
             const std::string keyName(fileName);
-            const double now = glfwGetTime();
-            auto it = s_lastTrigger.find(keyName);
-            if (it != s_lastTrigger.end() && (now - it->second) < static_cast<double>(cooldownSeconds)) {
-                return false;
-            }
 
             // Primary path: preloaded/game-thread-safe one-shot audio from AudioSystem.
-            if (AudioSystemLogic::TriggerGameplaySfx(baseSystem, keyName, 1.0f)) {
-                s_lastTrigger[keyName] = now;
+            if (AudioSystemLogic::TriggerGameplaySfx(baseSystem, keyName, 1.0f, cooldownSeconds)) {
                 return true;
             }
 
@@ -344,13 +329,7 @@ namespace BlockChargeSystemLogic {
             if (!readRegistryBool(baseSystem, "GameplaySfxFallbackToChuck", false)) {
                 return false;
             }
-            if (!baseSystem.audio || !baseSystem.audio->chuck) return false;
-            const std::string scriptPath = std::string("Procedures/chuck/gameplay/") + fileName;
-            std::vector<t_CKUINT> ids;
-            bool ok = baseSystem.audio->chuck->compileFile(scriptPath, "", 1, FALSE, &ids);
-            if (!ok || ids.empty()) return false;
-            s_lastTrigger[keyName] = now;
-            return true;
+            return ChucKSystemLogic::TriggerSfx(baseSystem, std::string("Procedures/chuck/gameplay/") + keyName, cooldownSeconds);
         }
 
         struct RemovedBlockInfo {
@@ -407,6 +386,7 @@ namespace BlockChargeSystemLogic {
                                 }
                                 world.instances[i] = world.instances.back();
                                 world.instances.pop_back();
+                                world.instanceEdits += 1;
                             }
                         }
                         return true;
@@ -414,21 +394,20 @@ namespace BlockChargeSystemLogic {
                 }
             }
 
-            for (size_t i = 0; i < world.instances.size(); ++i) {
-                const EntityInstance& inst = world.instances[i];
-                if (glm::distance(inst.position, position) > POSITION_EPSILON) continue;
-                if (inst.prototypeID < 0 || inst.prototypeID >= static_cast<int>(prototypes.size())) continue;
-                const Entity& proto = prototypes[inst.prototypeID];
-                if (!isRemovableGameplayBlock(proto)) continue;
-                if (removedInfo) {
-                    removedInfo->prototypeID = inst.prototypeID;
-                    removedInfo->color = inst.color;
-                }
-                world.instances[i] = world.instances.back();
-                world.instances.pop_back();
-                return true;
+            // Callers follow up with RemoveBlockFromCache, which re-points the
+            // swapped-in tail instance in the cell index.
+            const EntityInstance* found = BlockSelectionSystemLogic::FindBlockInstance(baseSystem, prototypes, worldIndex, position);
+            if (!found || glm::distance(found->position, position) > POSITION_EPSILON) return false;
+            if (!isRemovableGameplayBlock(prototypes[found->prototypeID])) return false;
+            if (removedInfo) {
+                removedInfo->prototypeID = found->prototypeID;
+                removedInfo->color = found->color;
             }
-            return false;
+            const size_t i = static_cast<size_t>(found - world.instances.data());
+            world.instances[i] = world.instances.back();
+            world.instances.pop_back();
+            world.instanceEdits += 1;
+            return true;
         }
     }
 
@@ -782,6 +761,7 @@ namespace BlockChargeSystemLogic {
             if (!placedInVoxel) {
                 Entity& world = level.worlds[playerCtx.targetedWorldIndex];
                 world.instances.push_back(HostLogic::CreateInstance(baseSystem, playerCtx.heldPrototypeID, placePos, playerCtx.heldBlockColor));
+                world.instanceEdits += 1;
                 BlockSelectionSystemLogic::AddBlockToCache(baseSystem, prototypes, playerCtx.targetedWorldIndex, placePos, playerCtx.heldPrototypeID);
                 StructureCaptureSystemLogic::NotifyBlockChanged(baseSystem, playerCtx.targetedWorldIndex, placePos);
             }
@@ -4,6 +4,9 @@
 #include <limits>
 #include <cmath>
 
+#include "BaseSystem/BlockCellIndex.h"
+#include "BaseSystem/DampingBrickmap.h"
+
 namespace BlockSelectionSystemLogic {
 
     namespace {
@@ -248,80 +251,69 @@ namespace BlockSelectionSystemLogic {
         }
     }
 
-    struct IVec3Hash {
-        std::size_t operator()(const glm::ivec3& v) const noexcept {
-            std::size_t hx = std::hash<int>()(v.x);
-            std::size_t hy = std::hash<int>()(v.y);
-            std::size_t hz = std::hash<int>()(v.z);
-            return hx ^ (hy << 1) ^ (hz << 2);
-        }
-    };
-
-    struct BlockEntry {
-        glm::vec3 center;
-        glm::vec3 min;
-        glm::vec3 max;
-        int worldIndex = -1;
-        bool active = true;
-        float dampingFactor = 0.25f;
-    };
-
+    // Per-world cell index over block instances, shared by selection, HasBlockAt,
+    // FindBlockInstance and the damping brickmap. Spawns and despawns that go
+    // through AddBlockToCache/RemoveBlockFromCache patch it in place. Other
+    // changes to a world's instance list show up as a new size or buffer, or
+    // as a slot that no longer names its cell, and the world is rebuilt on
+    // next use; in-place edits that keep both must call InvalidateWorldCache.
     struct WorldBlockCache {
-        std::vector<BlockEntry> blocks;
-        std::unordered_map<glm::ivec3, std::vector<int>, IVec3Hash> cellLookup;
-        std::unordered_map<glm::ivec3, int, IVec3Hash> positionLookup;
+        BlockCellIndex cells;
+        const EntityInstance* syncedData = nullptr;
         bool initialized = false;
     };
 
     static std::vector<WorldBlockCache> g_worldCaches;
+    static const std::vector<Entity>* g_cachePrototypes = nullptr;
+    // Mirrors what SampleBlockDamping would answer for every cell, for the
+    // audio ray marchers. Cell edits patch it in place; whole-cache rebuilds
+    // and invalidations mark it dirty so it is rebuilt on next use.
+    static DampingBrickmap g_dampingBrickmap;
+    static bool g_dampingBrickmapDirty = true;
 
     glm::ivec3 PositionKey(const glm::vec3& pos) {
-        return glm::ivec3(glm::round(pos));
+        return BlockCellIndex::cellOf(pos);
     }
 
-    void AddEntry(WorldBlockCache& cache, const BlockEntry& entry) {
-        int index = static_cast<int>(cache.blocks.size());
-        cache.blocks.push_back(entry);
-        cache.positionLookup[PositionKey(entry.center)] = index;
-        glm::ivec3 minCell = glm::ivec3(glm::floor(entry.min));
-        glm::ivec3 maxCell = glm::ivec3(glm::floor(entry.max - glm::vec3(1e-4f)));
-        for (int x = minCell.x; x <= maxCell.x; ++x) {
-            for (int y = minCell.y; y <= maxCell.y; ++y) {
-                for (int z = minCell.z; z <= maxCell.z; ++z) {
-                    cache.cellLookup[glm::ivec3(x, y, z)].push_back(index);
-                }
-            }
-        }
+    bool isBlockInstance(const std::vector<Entity>& prototypes, const EntityInstance& inst) {
+        if (inst.prototypeID < 0 || inst.prototypeID >= static_cast<int>(prototypes.size())) return false;
+        return prototypes[inst.prototypeID].isBlock;
     }
 
-    void BuildCache(WorldBlockCache& cache, int worldIndex, const Entity& world, const std::vector<Entity>& prototypes) {
-        cache.blocks.clear();
-        cache.cellLookup.clear();
-        cache.positionLookup.clear();
-        for (const auto& inst : world.instances) {
-            if (inst.prototypeID < 0 || inst.prototypeID >= static_cast<int>(prototypes.size())) continue;
-            const Entity& proto = prototypes[inst.prototypeID];
-            if (!proto.isBlock) continue;
-            BlockEntry entry;
-            entry.center = inst.position;
-            entry.min = inst.position - glm::vec3(0.5f);
-            entry.max = inst.position + glm::vec3(0.5f);
-            entry.worldIndex = worldIndex;
-            entry.active = true;
-            entry.dampingFactor = proto.dampingFactor;
-            AddEntry(cache, entry);
+    void BuildCache(WorldBlockCache& cache, const Entity& world, const std::vector<Entity>& prototypes) {
+        BlockCellIndex previous;
+        previous.slots.swap(cache.cells.slots);
+        cache.cells.clear();
+        for (size_t i = 0; i < world.instances.size(); ++i) {
+            const EntityInstance& inst = world.instances[i];
+            if (!isBlockInstance(prototypes, inst)) continue;
+            cache.cells.spawn(PositionKey(inst.position), static_cast<int32_t>(i));
+        }
+        cache.cells.syncedInstanceCount = world.instances.size();
+        cache.syncedData = world.instances.data();
+        // Worlds whose lists churn without touching blocks (UI, audicles)
+        // rebuild often; only a changed set of occupied cells dirties the
+        // brickmap.
+        bool sameCells = cache.initialized && previous.slots.size() == cache.cells.slots.size();
+        for (auto it = previous.slots.begin(); sameCells && it != previous.slots.end(); ++it) {
+            sameCells = cache.cells.slots.count(it->first) > 0;
         }
         cache.initialized = true;
+        if (!sameCells) g_dampingBrickmapDirty = true;
     }
 
-    void EnsureCacheBuilt(int worldIndex, BaseSystem& baseSystem, const std::vector<Entity>& prototypes) {
+    void EnsureCacheBuilt(int worldIndex, const BaseSystem& baseSystem, const std::vector<Entity>& prototypes) {
         if (!baseSystem.level) return;
         if (g_worldCaches.size() <= static_cast<size_t>(worldIndex)) {
             g_worldCaches.resize(worldIndex + 1);
         }
+        g_cachePrototypes = &prototypes;
         WorldBlockCache& cache = g_worldCaches[worldIndex];
-        if (!cache.initialized) {
-            BuildCache(cache, worldIndex, baseSystem.level->worlds[worldIndex], prototypes);
+        const Entity& world = baseSystem.level->worlds[worldIndex];
+        if (!cache.initialized
+            || cache.cells.syncedInstanceCount != world.instances.size()
+            || cache.syncedData != world.instances.data()) {
+            BuildCache(cache, world, prototypes);
         }
     }
 
@@ -342,15 +334,7 @@ namespace BlockSelectionSystemLogic {
         (void)cameraPosition;
         (void)radius;
         if (!baseSystem.level) return false;
-        if (g_worldCaches.size() < baseSystem.level->worlds.size()) {
-            g_worldCaches.resize(baseSystem.level->worlds.size());
-        }
-        for (size_t i = 0; i < baseSystem.level->worlds.size(); ++i) {
-            WorldBlockCache& cache = g_worldCaches[i];
-            if (!cache.initialized) {
-                BuildCache(cache, static_cast<int>(i), baseSystem.level->worlds[i], prototypes);
-            }
-        }
+        EnsureAllCaches(baseSystem, prototypes);
         return true;
     }
 
@@ -358,44 +342,111 @@ namespace BlockSelectionSystemLogic {
         if (worldIndex < 0) return;
         if (g_worldCaches.size() <= static_cast<size_t>(worldIndex)) return;
         g_worldCaches[worldIndex].initialized = false;
+        g_dampingBrickmapDirty = true;
+        CollisionSystemLogic::InvalidateColliders(worldIndex);
+    }
+
+    // Slot of the block instance in `cell`, or -1. A slot that no longer names
+    // a block in that cell means the instance list changed under the index,
+    // so the world is rebuilt once and asked again.
+    int lookupBlockSlot(const BaseSystem& baseSystem, int worldIndex, const glm::ivec3& cell) {
+        if (!g_cachePrototypes || !baseSystem.level) return -1;
+        if (worldIndex < 0 || worldIndex >= static_cast<int>(g_worldCaches.size())) return -1;
+        if (worldIndex >= static_cast<int>(baseSystem.level->worlds.size())) return -1;
+        WorldBlockCache& cache = g_worldCaches[worldIndex];
+        if (!cache.initialized) return -1;
+        const Entity& world = baseSystem.level->worlds[worldIndex];
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            const int32_t slot = cache.cells.find(cell);
+            if (slot < 0) return -1;
+            if (slot < static_cast<int32_t>(world.instances.size())) {
+                const EntityInstance& inst = world.instances[static_cast<size_t>(slot)];
+                if (PositionKey(inst.position) == cell && isBlockInstance(*g_cachePrototypes, inst)) return slot;
+            }
+            BuildCache(cache, world, *g_cachePrototypes);
+        }
+        return -1;
+    }
+
+    // First initialized world cache with a block at `cell` wins.
+    bool sampleCachedDamping(const BaseSystem& baseSystem, const glm::ivec3& cell, float& dampingOut) {
+        for (size_t i = 0; i < g_worldCaches.size(); ++i) {
+            const int slot = lookupBlockSlot(baseSystem, static_cast<int>(i), cell);
+            if (slot < 0) continue;
+            const EntityInstance& inst = baseSystem.level->worlds[i].instances[static_cast<size_t>(slot)];
+            dampingOut = (*g_cachePrototypes)[inst.prototypeID].dampingFactor;
+            return true;
+        }
+        return false;
     }
 
+    void refreshDampingCell(const BaseSystem& baseSystem, const glm::ivec3& cell) {
+        if (g_dampingBrickmapDirty) return;
+        float damping = 0.0f;
+        g_dampingBrickmap.setCell(cell, sampleCachedDamping(baseSystem, cell, damping)
+            ? DampingBrickmap::encodeDamping(damping)
+            : uint8_t(0));
+    }
+
+    // Expected right after the instance was appended to the world's instance
+    // list; anything else leaves a count mismatch and a rebuild.
     void AddBlockToCache(BaseSystem& baseSystem, std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position, int prototypeID) {
         if (worldIndex < 0 || !baseSystem.level || worldIndex >= static_cast<int>(baseSystem.level->worlds.size())) return;
-        EnsureCacheBuilt(worldIndex, baseSystem, prototypes);
+        if (g_worldCaches.size() <= static_cast<size_t>(worldIndex)) {
+            g_worldCaches.resize(worldIndex + 1);
+        }
         WorldBlockCache& cache = g_worldCaches[worldIndex];
+        const Entity& world = baseSystem.level->worlds[worldIndex];
         glm::ivec3 key = PositionKey(position);
-        auto it = cache.positionLookup.find(key);
-        if (it != cache.positionLookup.end()) {
-            cache.blocks[it->second].active = true;
-            cache.blocks[it->second].center = position;
-            cache.blocks[it->second].min = position - glm::vec3(0.5f);
-            cache.blocks[it->second].max = position + glm::vec3(0.5f);
-            cache.blocks[it->second].dampingFactor = (prototypeID >= 0 && prototypeID < static_cast<int>(prototypes.size()))
-                ? prototypes[prototypeID].dampingFactor : cache.blocks[it->second].dampingFactor;
-            return;
+        if (cache.initialized && cache.cells.syncedInstanceCount + 1 == world.instances.size()) {
+            const EntityInstance& added = world.instances.back();
+            if (PositionKey(added.position) == key && isBlockInstance(prototypes, added)) {
+                cache.cells.spawn(key, static_cast<int32_t>(world.instances.size() - 1));
+            }
+            cache.cells.syncedInstanceCount = world.instances.size();
+            cache.syncedData = world.instances.data();
         }
-        BlockEntry entry;
-        entry.center = position;
-        entry.min = position - glm::vec3(0.5f);
-        entry.max = position + glm::vec3(0.5f);
-        entry.worldIndex = worldIndex;
-        entry.active = true;
-        entry.dampingFactor = (prototypeID >= 0 && prototypeID < static_cast<int>(prototypes.size()))
-            ? prototypes[prototypeID].dampingFactor : 0.5f;
-        AddEntry(cache, entry);
+        EnsureCacheBuilt(worldIndex, baseSystem, prototypes);
+        refreshDampingCell(baseSystem, key);
+        RayTracedAudioSystemLogic::InvalidatePropagationCell(baseSystem, key);
+        CollisionSystemLogic::NotifyBlockAdded(baseSystem, prototypes, worldIndex, position, prototypeID);
     }
 
+    // Expected right after the instance left the world's instance list; a
+    // swap-and-pop removal has its moved tail instance re-pointed here.
     void RemoveBlockFromCache(BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position) {
         if (worldIndex < 0 || !baseSystem.level || worldIndex >= static_cast<int>(baseSystem.level->worlds.size())) return;
-        EnsureCacheBuilt(worldIndex, baseSystem, prototypes);
+        if (g_worldCaches.size() <= static_cast<size_t>(worldIndex)) {
+            g_worldCaches.resize(worldIndex + 1);
+        }
         WorldBlockCache& cache = g_worldCaches[worldIndex];
+        const Entity& world = baseSystem.level->worlds[worldIndex];
         glm::ivec3 key = PositionKey(position);
-        auto it = cache.positionLookup.find(key);
-        if (it != cache.positionLookup.end()) {
-            cache.blocks[it->second].active = false;
-            cache.positionLookup.erase(it);
+        if (cache.initialized) {
+            const int32_t slot = cache.cells.find(key);
+            cache.cells.despawn(key);
+            const int32_t tail = static_cast<int32_t>(world.instances.size());
+            if (slot >= 0 && cache.cells.syncedInstanceCount == world.instances.size() + 1) {
+                if (slot < tail) {
+                    cache.cells.move(PositionKey(world.instances[static_cast<size_t>(slot)].position), tail, slot);
+                }
+                cache.cells.syncedInstanceCount = world.instances.size();
+                cache.syncedData = world.instances.data();
+            }
         }
+        EnsureCacheBuilt(worldIndex, baseSystem, prototypes);
+        refreshDampingCell(baseSystem, key);
+        RayTracedAudioSystemLogic::InvalidatePropagationCell(baseSystem, key);
+        CollisionSystemLogic::NotifyBlockRemoved(baseSystem, worldIndex, position);
+    }
+
+    const EntityInstance* FindBlockInstance(const BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position) {
+        if (!baseSystem.level) return nullptr;
+        if (worldIndex < 0 || worldIndex >= static_cast<int>(baseSystem.level->worlds.size())) return nullptr;
+        EnsureCacheBuilt(worldIndex, baseSystem, prototypes);
+        const int slot = lookupBlockSlot(baseSystem, worldIndex, PositionKey(position));
+        if (slot < 0) return nullptr;
+        return &baseSystem.level->worlds[worldIndex].instances[static_cast<size_t>(slot)];
     }
 
     bool HasBlockAt(BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position) {
@@ -422,14 +473,7 @@ namespace BlockSelectionSystemLogic {
             glm::ivec3 cell = glm::ivec3(glm::round(position));
             if (baseSystem.voxelWorld->getBlockWorld(cell) != 0) return true;
         }
-        if (worldIndex < 0 || worldIndex >= static_cast<int>(baseSystem.level->worlds.size())) return false;
-        EnsureCacheBuilt(worldIndex, baseSystem, prototypes);
-        WorldBlockCache& cache = g_worldCaches[worldIndex];
-        glm::ivec3 key = PositionKey(position);
-        auto it = cache.positionLookup.find(key);
-        if (it == cache.positionLookup.end()) return false;
-        int idx = it->second;
-        return idx >= 0 && idx < static_cast<int>(cache.blocks.size()) && cache.blocks[idx].active;
+        return FindBlockInstance(baseSystem, prototypes, worldIndex, position) != nullptr;
     }
 
     bool SampleBlockDamping(BaseSystem& baseSystem,
@@ -437,18 +481,49 @@ namespace BlockSelectionSystemLogic {
                             float& dampingOut) {
         if (!baseSystem.level) return false;
         if (g_worldCaches.size() < baseSystem.level->worlds.size()) return false;
-        for (const auto& cache : g_worldCaches) {
-            if (!cache.initialized) continue;
-            auto it = cache.positionLookup.find(cell);
-            if (it == cache.positionLookup.end()) continue;
-            int idx = it->second;
-            if (idx < 0 || idx >= static_cast<int>(cache.blocks.size())) continue;
-            const BlockEntry& block = cache.blocks[idx];
-            if (!block.active) continue;
-            dampingOut = block.dampingFactor;
-            return true;
+        return sampleCachedDamping(baseSystem, cell, dampingOut);
+    }
+
+    // Null whenever SampleBlockDamping would report every cell empty.
+    const DampingBrickmap* GetDampingBrickmap(BaseSystem& baseSystem) {
+        if (!baseSystem.level) return nullptr;
+        if (g_worldCaches.size() < baseSystem.level->worlds.size()) return nullptr;
+        // Rebuilding a stale or invalidated world cache re-dirties the map, so
+        // settle the caches before looking at the flag; an invalidated world
+        // left unbuilt would drop out of the rebuilt map. The audio workers
+        // call this after the main thread has, so they only ever take the
+        // read-only path.
+        bool stale = false;
+        for (size_t i = 0; i < g_worldCaches.size() && i < baseSystem.level->worlds.size(); ++i) {
+            const WorldBlockCache& cache = g_worldCaches[i];
+            const Entity& world = baseSystem.level->worlds[i];
+            if (!cache.initialized
+                || cache.cells.syncedInstanceCount != world.instances.size()
+                || cache.syncedData != world.instances.data()) {
+                stale = true;
+            }
         }
-        return false;
+        if (stale && g_cachePrototypes) EnsureAllCaches(baseSystem, *g_cachePrototypes);
+        if (g_dampingBrickmapDirty) {
+            g_dampingBrickmap.clear();
+            g_dampingBrickmapDirty = false;
+            RayTracedAudioSystemLogic::InvalidatePropagation(baseSystem);
+            // Sampling may rebuild a cache whose slots went stale, so walk a
+            // snapshot of the occupied cells.
+            std::vector<glm::ivec3> cells;
+            for (const auto& cache : g_worldCaches) {
+                if (!cache.initialized) continue;
+                for (const auto& [cell, slot] : cache.cells.slots) {
+                    (void)slot;
+                    cells.push_back(cell);
+                }
+            }
+            for (const glm::ivec3& cell : cells) {
+                if (g_dampingBrickmap.cellValue(cell) != 0) continue;
+                refreshDampingCell(baseSystem, cell);
+            }
+        }
+        return &g_dampingBrickmap;
     }
 
     glm::vec3 GetCameraDirection(const PlayerContext& player) {
@@ -460,7 +535,6 @@ namespace BlockSelectionSystemLogic {
     }
 
     bool RaycastBlocks(const BaseSystem& baseSystem,
-                       const std::vector<WorldBlockCache>& caches,
                        const glm::vec3& origin,
                        const glm::vec3& direction,
                        glm::ivec3& outCell,
@@ -496,27 +570,29 @@ namespace BlockSelectionSystemLogic {
         glm::vec3 bestNormal(0.0f);
         int bestWorld = -1;
 
+        // Blocks are unit cubes around integer centres, so the floor cell the
+        // ray is in can be touched by the blocks of up to eight index cells.
         auto testCell = [&](const glm::ivec3& candidateCell) {
-            for (const auto& cache : caches) {
-                auto iter = cache.cellLookup.find(candidateCell);
-                if (iter == cache.cellLookup.end()) continue;
-                for (int idx : iter->second) {
-                    if (idx < 0 || idx >= static_cast<int>(cache.blocks.size())) continue;
-                    const BlockEntry& block = cache.blocks[idx];
-                    if (!block.active) continue;
-                    const glm::ivec3 blockCell = glm::ivec3(glm::round(block.center));
-                    if (isLatchedAnchorSuppressedTarget(baseSystem, block.worldIndex, blockCell)) continue;
+            for (int worldIndex = 0; worldIndex < static_cast<int>(g_worldCaches.size()); ++worldIndex) {
+                for (int corner = 0; corner < 8; ++corner) {
+                    const glm::ivec3 blockCell = candidateCell + glm::ivec3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+                    const int slot = lookupBlockSlot(baseSystem, worldIndex, blockCell);
+                    if (slot < 0) continue;
+                    if (isLatchedAnchorSuppressedTarget(baseSystem, worldIndex, blockCell)) continue;
+                    const glm::vec3 blockCenter = baseSystem.level->worlds[worldIndex].instances[static_cast<size_t>(slot)].position;
+                    const glm::vec3 blockMin = blockCenter - glm::vec3(0.5f);
+                    const glm::vec3 blockMax = blockCenter + glm::vec3(0.5f);
                     float tMin = 0.0f, tMax = maxDistance;
                     for (int axis = 0; axis < 3; ++axis) {
                         float invD = (axis == 0 ? dir.x : (axis == 1 ? dir.y : dir.z));
                         if (std::abs(invD) < 1e-6f) {
-                            float minBound = block.min[axis];
-                            float maxBound = block.max[axis];
+                            float minBound = blockMin[axis];
+                            float maxBound = blockMax[axis];
                             if (rayPos[axis] < minBound || rayPos[axis] > maxBound) { tMin = tMax + 1.0f; break; }
                         } else {
                             float originComponent = rayPos[axis];
-                            float minBound = block.min[axis];
-                            float maxBound = block.max[axis];
+                            float minBound = blockMin[axis];
+                            float maxBound = blockMax[axis];
                             float t1 = (minBound - originComponent) / invD;
                             float t2 = (maxBound - originComponent) / invD;
                             if (t1 > t2) std::swap(t1, t2);
@@ -528,9 +604,9 @@ namespace BlockSelectionSystemLogic {
                     if (tMin <= tMax && tMin >= 0.0f) {
                         if (tMin < bestDistance) {
                             bestDistance = tMin;
-                            bestCenter = block.center;
+                            bestCenter = blockCenter;
                             bestNormal = entryNormal;
-                            bestWorld = block.worldIndex;
+                            bestWorld = worldIndex;
                             found = true;
                         }
                     }
@@ -612,7 +688,7 @@ namespace BlockSelectionSystemLogic {
         glm::vec3 cacheNormal(0.0f);
         int cacheWorld = -1;
         float cacheDist = std::numeric_limits<float>::max();
-        if (RaycastBlocks(baseSystem, g_worldCaches, eyePos, dir, cacheCell, cacheCenter, cacheNormal, cacheWorld, &cacheDist)) {
+        if (RaycastBlocks(baseSystem, eyePos, dir, cacheCell, cacheCenter, cacheNormal, cacheWorld, &cacheDist)) {
             foundAny = true;
             bestDist = cacheDist;
             hitCell = cacheCell;
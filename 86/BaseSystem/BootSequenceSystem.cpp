@@ -2,6 +2,13 @@
 
 #include <GLFW/glfw3.h>
 
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic {
+    UIBatch::Builder& Frame(BaseSystem& baseSystem);
+    void Flush(BaseSystem& baseSystem);
+}
+
 namespace BootSequenceSystemLogic {
     namespace {
         constexpr float kBootLoadingSeconds = 10.0f;
@@ -29,20 +36,6 @@ namespace BootSequenceSystemLogic {
             verts.push_back({d, color});
         }
 
-        void ensureFullscreenResources(RendererContext& renderer, WorldContext& world) {
-        // Only need solid-color shader for the bar; skip fullscreen shader to avoid grey overlay.
-    }
-
-        void ensureBarResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.uiColorShader) {
-                renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(), world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.uiButtonVAO == 0) {
-                glGenVertexArrays(1, &renderer.uiButtonVAO);
-                glGenBuffers(1, &renderer.uiButtonVBO);
-            }
-        }
-
         glm::vec3 resolveColor(const WorldContext* world, const std::string& name, const glm::vec3& fallback) {
             if (world && !name.empty()) {
                 auto it = world->colorLibrary.find(name);
@@ -131,12 +124,7 @@ namespace BootSequenceSystemLogic {
         if (!ui.loadingActive) return;
         if (!baseSystem.renderer || !baseSystem.world || !win) return;
 
-        RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
-        ensureFullscreenResources(renderer, world);
-        ensureBarResources(renderer, world);
-
-        glDisable(GL_DEPTH_TEST);
 
         int windowWidth = 0, windowHeight = 0;
         glfwGetWindowSize(win, &windowWidth, &windowHeight);
@@ -207,18 +195,8 @@ namespace BootSequenceSystemLogic {
                  pixelToNDC(fillD, screenWidth, screenHeight),
                  fillColor);
 
-        if (!vertices.empty() && renderer.uiColorShader) {
-            glBindVertexArray(renderer.uiButtonVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.uiButtonVBO);
-            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(UiVertex), vertices.data(), GL_DYNAMIC_DRAW);
-            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, pos));
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, color));
-            glEnableVertexAttribArray(1);
-            renderer.uiColorShader->use();
-            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
-        }
-
-        glEnable(GL_DEPTH_TEST);
+        // Boot draws after the UI span has been flushed, so it flushes its own bar.
+        UIBatchSystemLogic::Frame(baseSystem).addColored(vertices, 1.0f);
+        UIBatchSystemLogic::Flush(baseSystem);
     }
 }
@@ -7,6 +7,7 @@
 
 namespace BlockSelectionSystemLogic {
     bool HasBlockAt(BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position);
+    const EntityInstance* FindBlockInstance(const BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position);
     void AddBlockToCache(BaseSystem& baseSystem, std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position, int prototypeID);
 }
 namespace HostLogic { const Entity* findPrototype(const std::string& name, const std::vector<Entity>& prototypes); }
@@ -17,8 +18,6 @@ namespace VoxelMeshingSystemLogic { void RequestPriorityVoxelRemesh(BaseSystem&
 namespace BuildSystemLogic {
 
     namespace {
-        constexpr float kPickEpsilon = 0.05f;
-
         bool getRegistryBool(const BaseSystem& baseSystem, const std::string& key, bool fallback) {
             if (!baseSystem.registry) return fallback;
             auto it = baseSystem.registry->find(key);
@@ -94,38 +93,12 @@ namespace BuildSystemLogic {
             float b = static_cast<float>(packed & 0xff) / 255.0f;
             return glm::vec3(r, g, b);
         }
-
-        bool findBlockInstance(const LevelContext& level,
-                               const std::vector<Entity>& prototypes,
-                               int worldIndex,
-                               const glm::vec3& position,
-                               EntityInstance& outInst) {
-            if (worldIndex < 0 || worldIndex >= static_cast<int>(level.worlds.size())) return false;
-            const Entity& world = level.worlds[worldIndex];
-            for (const auto& inst : world.instances) {
-                if (glm::distance(inst.position, position) > kPickEpsilon) continue;
-                if (inst.prototypeID < 0 || inst.prototypeID >= static_cast<int>(prototypes.size())) continue;
-                const Entity& proto = prototypes[inst.prototypeID];
-                if (!proto.isBlock) continue;
-                outInst = inst;
-                return true;
-            }
-            return false;
-        }
-    }
-
-    bool BlockExistsAt(const Entity& world, const glm::vec3& position) {
-        for (const auto& inst : world.instances) {
-            if (glm::distance(inst.position, position) < 0.01f) return true;
-        }
-        return false;
     }
 
     void UpdateBuildMode(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
         if (!baseSystem.player || !baseSystem.level || !baseSystem.hud) return;
         PlayerContext& player = *baseSystem.player;
         HUDContext& hud = *baseSystem.hud;
-        LevelContext& level = *baseSystem.level;
         const bool legacyBuildModesEnabled = getRegistryBool(baseSystem, "LegacyBuildModesEnabled", false);
         if (baseSystem.ui && baseSystem.ui->active) {
             hud.buildModeActive = false;
@@ -159,10 +132,11 @@ namespace BuildSystemLogic {
             }
 
             if (pickedPrototypeID < 0) {
-                EntityInstance picked;
-                if (findBlockInstance(level, prototypes, player.targetedWorldIndex, player.targetedBlockPosition, picked)) {
-                    pickedPrototypeID = picked.prototypeID;
-                    pickedColor = picked.color;
+                const EntityInstance* picked = BlockSelectionSystemLogic::FindBlockInstance(
+                    baseSystem, prototypes, player.targetedWorldIndex, player.targetedBlockPosition);
+                if (picked) {
+                    pickedPrototypeID = picked->prototypeID;
+                    pickedColor = picked->color;
                 }
             }
 
@@ -265,6 +239,7 @@ namespace BuildSystemLogic {
                         if (!placedInVoxel) {
                             Entity& world = baseSystem.level->worlds[player.targetedWorldIndex];
                             world.instances.push_back(HostLogic::CreateInstance(baseSystem, buildPrototypeID, placePos, buildColor));
+                            world.instanceEdits += 1;
                             BlockSelectionSystemLogic::AddBlockToCache(baseSystem, prototypes, player.targetedWorldIndex, placePos, buildPrototypeID);
                             StructureCaptureSystemLogic::NotifyBlockChanged(baseSystem, player.targetedWorldIndex, placePos);
                         }
@@ -5,6 +5,10 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic { UIBatch::Builder& Frame(BaseSystem& baseSystem); }
+
 namespace ButtonSystemLogic {
 
     struct ButtonState {
@@ -50,16 +54,6 @@ namespace ButtonSystemLogic {
         constexpr float kButtonAlphaDefault = 0.85f;
         constexpr bool kDebugRelayoutTrackButtons = false;
 
-        void ensureResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.uiColorShader) {
-                renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(), world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.uiButtonVAO == 0) {
-                glGenVertexArrays(1, &renderer.uiButtonVAO);
-                glGenBuffers(1, &renderer.uiButtonVBO);
-            }
-        }
-
         void pushQuad(std::vector<ButtonVertex>& verts,
                       const glm::vec2& a,
                       const glm::vec2& b,
@@ -449,6 +443,7 @@ namespace ButtonSystemLogic {
                             if (const char* fallback = fallbackTrackButtonName(inst)) {
                                 if (const Entity* proto = HostLogic::findPrototype(fallback, prototypes)) {
                                     inst.prototypeID = proto->prototypeID;
+                                    world.instanceEdits += 1;
                                 }
                             }
                         }
@@ -458,6 +453,7 @@ namespace ButtonSystemLogic {
                         if (const char* fallback = fallbackTrackButtonNameFromId(inst)) {
                             if (const Entity* proto = HostLogic::findPrototype(fallback, prototypes)) {
                                 inst.prototypeID = proto->prototypeID;
+                                world.instanceEdits += 1;
                             }
                         }
                     }
@@ -466,6 +462,7 @@ namespace ButtonSystemLogic {
                         const Entity* proto = HostLogic::findPrototype(inst.name, prototypes);
                         if (!proto || !proto->isUIButton) continue;
                         inst.prototypeID = proto->prototypeID;
+                        world.instanceEdits += 1;
                     }
                     if (!prototypes[inst.prototypeID].isUIButton) continue;
                     ui.buttonInstances.push_back(&inst);
@@ -521,9 +518,7 @@ namespace ButtonSystemLogic {
                                ButtonRenderPass pass,
                                GLFWwindow* win) {
             if (!baseSystem.renderer || !baseSystem.world || !baseSystem.level || !win) return;
-            RendererContext& renderer = *baseSystem.renderer;
             WorldContext& world = *baseSystem.world;
-            ensureResources(renderer, world);
 
             int windowWidth = 0, windowHeight = 0;
             glfwGetWindowSize(win, &windowWidth, &windowHeight);
@@ -575,28 +570,13 @@ namespace ButtonSystemLogic {
                                     screenWidth, screenHeight, vertices);
             }
 
-            if (vertices.empty() || !renderer.uiColorShader) return;
+            if (vertices.empty()) return;
 
-            glDisable(GL_DEPTH_TEST);
-            glEnable(GL_BLEND);
             float buttonAlpha = kButtonAlphaDefault;
             if (baseSystem.daw) {
                 buttonAlpha = std::clamp(baseSystem.daw->activeThemeButton.a, 0.0f, 1.0f);
             }
-            glBlendColor(0.0f, 0.0f, 0.0f, buttonAlpha);
-            glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-            glBindVertexArray(renderer.uiButtonVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.uiButtonVBO);
-            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(ButtonVertex), vertices.data(), GL_DYNAMIC_DRAW);
-            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ButtonVertex), (void*)offsetof(ButtonVertex, pos));
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ButtonVertex), (void*)offsetof(ButtonVertex, color));
-            glEnableVertexAttribArray(1);
-
-            renderer.uiColorShader->use();
-            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glEnable(GL_DEPTH_TEST);
+            UIBatchSystemLogic::Frame(baseSystem).addColored(vertices, buttonAlpha);
         }
     }
 
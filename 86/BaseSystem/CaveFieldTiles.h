@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// One column of a quantized cave field lattice: lattice x in [x0, x0 + nx),
+// every y, and z in [z0, z0 + nz), laid out x, then y, then z-fastest like
+// the monolithic field it replaces.
+struct CaveFieldTile {
+    int x0 = 0;
+    int z0 = 0;
+    int nx = 0;
+    int nz = 0;
+    int dimY = 0;
+    std::vector<uint8_t> a;
+    std::vector<uint8_t> b;
+
+    size_t index(int lx, int y, int lz) const {
+        return (static_cast<size_t>(lx) * static_cast<size_t>(dimY) + static_cast<size_t>(y)) * static_cast<size_t>(nz)
+            + static_cast<size_t>(lz);
+    }
+};
+
+// Cave field lattice split into XZ column tiles that are filled on demand by
+// worker threads, optionally round-tripped through an on-disk cache keyed by
+// `paramKey`, and evicted least-recently-used beyond `capacityTiles`. Only
+// the fill callback and the disk cache run off the main thread; everything
+// else is main-thread only. Tile pointers stay valid until the next trim,
+// configure or reset.
+struct CaveFieldTiles {
+    using FillFn = std::function<void(CaveFieldTile&)>;
+
+    ~CaveFieldTiles() { reset(); }
+
+    void configure(int newDimX, int newDimY, int newDimZ, int newTileSize, size_t capacityTiles, int workers,
+                   uint64_t newParamKey, const std::string& newDiskDir, FillFn fill) {
+        reset();
+        dimX = std::max(0, newDimX);
+        dimY = std::max(0, newDimY);
+        dimZ = std::max(0, newDimZ);
+        tileEdge = std::max(1, newTileSize);
+        tilesX = (dimX + tileEdge - 1) / tileEdge;
+        tilesZ = (dimZ + tileEdge - 1) / tileEdge;
+        capacity = std::max<size_t>(1, capacityTiles);
+        workerCount = std::max(1, workers);
+        paramKey = newParamKey;
+        diskDir = newDiskDir;
+        fillTile = std::move(fill);
+        slots.resize(static_cast<size_t>(tilesX) * static_cast<size_t>(tilesZ));
+    }
+
+    // Joins the workers (finishing tiles already being filled) and drops
+    // every tile.
+    void reset() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+            queue.clear();
+        }
+        workCv.notify_all();
+        for (auto& thread : threads) {
+            if (thread.joinable()) thread.join();
+        }
+        threads.clear();
+        stop = false;
+        results.clear();
+        slots.clear();
+        residentTiles = 0;
+    }
+
+    int tileSize() const { return tileEdge; }
+    size_t residentCount() const { return residentTiles; }
+
+    // Resident tile holding lattice column (x, z), or nullptr.
+    const CaveFieldTile* find(int x, int z) {
+        Slot* slot = slotFor(x, z);
+        if (!slot || !slot->tile) return nullptr;
+        slot->lastUse = useTick;
+        return slot->tile.get();
+    }
+
+    // Like find, but queues the tile if needed and waits for it.
+    const CaveFieldTile* acquire(int x, int z) {
+        if (const CaveFieldTile* tile = find(x, z)) return tile;
+        Slot* slot = slotFor(x, z);
+        if (!slot) return nullptr;
+        request(x, z, true);
+        while (!slot->tile) {
+            std::unique_lock<std::mutex> lock(mutex);
+            doneCv.wait(lock, [this]() { return !results.empty(); });
+            lock.unlock();
+            collect();
+        }
+        slot->lastUse = useTick;
+        return slot->tile.get();
+    }
+
+    // Queues the tile holding lattice column (x, z) unless it is resident.
+    // Urgent requests jump the queue, including ones already waiting in it.
+    void request(int x, int z, bool urgent = false) {
+        Slot* slot = slotFor(x, z);
+        if (!slot || slot->tile || (slot->queued && !urgent)) return;
+        const int slotIndex = static_cast<int>(slot - slots.data());
+        if (threads.empty()) {
+            for (int i = 0; i < workerCount; ++i) {
+                threads.emplace_back([this]() { workerLoop(); });
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (slot->queued) {
+                // Already taken by a worker if it is no longer waiting.
+                auto it = std::find(queue.begin(), queue.end(), slotIndex);
+                if (it == queue.end()) return;
+                queue.erase(it);
+            }
+            if (urgent) {
+                queue.push_front(slotIndex);
+            } else {
+                queue.push_back(slotIndex);
+            }
+        }
+        slot->queued = true;
+        workCv.notify_one();
+    }
+
+    // Queues every tile overlapping lattice columns [x0, x1] x [z0, z1].
+    void requestRange(int x0, int z0, int x1, int z1) {
+        x0 = std::max(x0, 0);
+        z0 = std::max(z0, 0);
+        x1 = std::min(x1, dimX - 1);
+        z1 = std::min(z1, dimZ - 1);
+        if (x0 > x1 || z0 > z1) return;
+        for (int tz = z0 / tileEdge; tz <= z1 / tileEdge; ++tz) {
+            for (int tx = x0 / tileEdge; tx <= x1 / tileEdge; ++tx) {
+                request(tx * tileEdge, tz * tileEdge);
+            }
+        }
+    }
+
+    // Installs finished tiles and evicts the least recently used ones past
+    // capacity. Call between sections, never while holding tile pointers.
+    void trim() {
+        collect();
+        useTick += 1;
+        if (residentTiles <= capacity) return;
+        std::vector<Slot*> resident;
+        resident.reserve(residentTiles);
+        for (Slot& slot : slots) {
+            if (slot.tile) resident.push_back(&slot);
+        }
+        const size_t evictCount = resident.size() - capacity;
+        std::nth_element(resident.begin(), resident.begin() + static_cast<std::ptrdiff_t>(evictCount), resident.end(),
+            [](const Slot* a, const Slot* b) { return a->lastUse < b->lastUse; });
+        for (size_t i = 0; i < evictCount; ++i) {
+            resident[i]->tile.reset();
+        }
+        residentTiles -= evictCount;
+    }
+
+private:
+    struct Slot {
+        std::unique_ptr<CaveFieldTile> tile;
+        uint64_t lastUse = 0;
+        bool queued = false;
+    };
+
+    struct Result {
+        int slot = -1;
+        std::unique_ptr<CaveFieldTile> tile;
+    };
+
+    int dimX = 0;
+    int dimY = 0;
+    int dimZ = 0;
+    int tileEdge = 32;
+    int tilesX = 0;
+    int tilesZ = 0;
+    size_t capacity = 64;
+    int workerCount = 1;
+    uint64_t paramKey = 0;
+    std::string diskDir;
+    FillFn fillTile;
+
+    std::vector<Slot> slots;
+    size_t residentTiles = 0;
+    uint64_t useTick = 1;
+
+    std::mutex mutex;
+    std::condition_variable workCv;
+    std::condition_variable doneCv;
+    std::deque<int> queue;
+    std::vector<Result> results;
+    std::vector<std::thread> threads;
+    bool stop = false;
+
+    Slot* slotFor(int x, int z) {
+        if (x < 0 || z < 0 || x >= dimX || z >= dimZ || slots.empty()) return nullptr;
+        return &slots[static_cast<size_t>(z / tileEdge) * static_cast<size_t>(tilesX) + static_cast<size_t>(x / tileEdge)];
+    }
+
+    void collect() {
+        std::vector<Result> done;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.swap(results);
+        }
+        for (Result& result : done) {
+            Slot& slot = slots[static_cast<size_t>(result.slot)];
+            slot.queued = false;
+            if (!slot.tile) residentTiles += 1;
+            slot.tile = std::move(result.tile);
+            slot.lastUse = useTick;
+        }
+    }
+
+    void workerLoop() {
+        while (true) {
+            int slotIndex = -1;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                workCv.wait(lock, [this]() { return stop || !queue.empty(); });
+                if (stop) return;
+                slotIndex = queue.front();
+                queue.pop_front();
+            }
+            auto tile = std::make_unique<CaveFieldTile>();
+            tile->x0 = (slotIndex % tilesX) * tileEdge;
+            tile->z0 = (slotIndex / tilesX) * tileEdge;
+            tile->nx = std::min(tileEdge, dimX - tile->x0);
+            tile->nz = std::min(tileEdge, dimZ - tile->z0);
+            tile->dimY = dimY;
+            if (!loadFromDisk(*tile)) {
+                const size_t count = static_cast<size_t>(tile->nx) * static_cast<size_t>(dimY) * static_cast<size_t>(tile->nz);
+                tile->a.assign(count, 0);
+                tile->b.assign(count, 0);
+                if (fillTile) fillTile(*tile);
+                saveToDisk(*tile);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                results.push_back({slotIndex, std::move(tile)});
+            }
+            doneCv.notify_all();
+        }
+    }
+
+    struct DiskHeader {
+        uint32_t magic = 0x54564143u; // "CAVT"
+        uint32_t version = 1;
+        uint64_t paramKey = 0;
+        int32_t x0 = 0, z0 = 0, nx = 0, nz = 0, dimY = 0;
+        int32_t reserved = 0;
+    };
+
+    std::filesystem::path diskPath(const CaveFieldTile& tile) const {
+        char dir[24];
+        std::snprintf(dir, sizeof(dir), "%016llx", static_cast<unsigned long long>(paramKey));
+        return std::filesystem::path(diskDir) / dir
+            / ("tile" + std::to_string(tile.x0) + "_" + std::to_string(tile.z0) + ".cave");
+    }
+
+    DiskHeader headerFor(const CaveFieldTile& tile) const {
+        DiskHeader header;
+        header.paramKey = paramKey;
+        header.x0 = tile.x0;
+        header.z0 = tile.z0;
+        header.nx = tile.nx;
+        header.nz = tile.nz;
+        header.dimY = tile.dimY;
+        return header;
+    }
+
+    bool loadFromDisk(CaveFieldTile& tile) const {
+        if (diskDir.empty()) return false;
+        std::ifstream in(diskPath(tile), std::ios::binary);
+        if (!in.is_open()) return false;
+        DiskHeader expected = headerFor(tile);
+        DiskHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(&header, &expected, sizeof(header)) != 0) return false;
+        const size_t count = static_cast<size_t>(tile.nx) * static_cast<size_t>(tile.dimY) * static_cast<size_t>(tile.nz);
+        tile.a.resize(count);
+        tile.b.resize(count);
+        in.read(reinterpret_cast<char*>(tile.a.data()), static_cast<std::streamsize>(count));
+        in.read(reinterpret_cast<char*>(tile.b.data()), static_cast<std::streamsize>(count));
+        return static_cast<bool>(in);
+    }
+
+    void saveToDisk(const CaveFieldTile& tile) const {
+        if (diskDir.empty()) return;
+        std::error_code ec;
+        const std::filesystem::path path = diskPath(tile);
+        std::filesystem::create_directories(path.parent_path(), ec);
+        if (ec) return;
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return;
+            DiskHeader header = headerFor(tile);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(tile.a.data()), static_cast<std::streamsize>(tile.a.size()));
+            out.write(reinterpret_cast<const char*>(tile.b.data()), static_cast<std::streamsize>(tile.b.size()));
+            if (!out) return;
+        }
+        std::filesystem::rename(temp, path, ec);
+    }
+};
@@ -1,6 +1,8 @@
 #pragma once
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 namespace ChucKSystemLogic {
 
@@ -76,6 +78,205 @@ namespace ChucKSystemLogic {
         return count;
     }
 
+    static constexpr int kMaxSfxSounds = 128;
+    static constexpr float kSfxReloadCheckSeconds = 1.0f;
+    static const std::array<const char*, 2> kSfxFolders = {
+        "Procedures/chuck/gameplay",
+        "Procedures/chuck/fishing"
+    };
+
+    // Wraps a one-shot gameplay script in a host shred. The script must
+    // define play(); wrapping bare top-level code would also swallow any
+    // helper functions it declares, which ChucK rejects inside a function.
+    // The host wakes on a global event and starts one voice per trigger
+    // counted since its last wake (capped at the pool size), stealing the
+    // oldest voice when every slot is still sounding.
+    static bool build_sfx_host(const std::string& source, const ChuckSfxSound& sound, int voices, std::string& outCode) {
+        if (source.find("fun void play()") == std::string::npos) return false;
+        const std::string count = std::to_string(std::max(1, voices));
+        std::ostringstream code;
+        code << "global Event " << sound.triggerEvent << ";\n"
+             << "global int " << sound.triggerCount << ";\n"
+             << source << "\n"
+             << "Shred @ sfxVoices[" << count << "];\n"
+             << "int sfxVoiceStamp[" << count << "];\n"
+             << "0 => int sfxStamp;\n"
+             << sound.triggerCount << " => int sfxHandled;\n"
+             << "while (true) {\n"
+             << "    " << sound.triggerEvent << " => now;\n"
+             << "    " << sound.triggerCount << " - sfxHandled => int pending;\n"
+             << "    " << sound.triggerCount << " => sfxHandled;\n"
+             << "    if (pending > " << count << ") " << count << " => pending;\n"
+             << "    for (0 => int p; p < pending; p++) {\n"
+             << "        -1 => int slot;\n"
+             << "        0 => int oldest;\n"
+             << "        for (0 => int i; i < " << count << "; i++) {\n"
+             << "            if (sfxVoices[i] == null) { i => slot; break; }\n"
+             << "            if (sfxVoices[i].done()) { i => slot; break; }\n"
+             << "            if (sfxVoiceStamp[i] < sfxVoiceStamp[oldest]) i => oldest;\n"
+             << "        }\n"
+             << "        if (slot < 0) {\n"
+             << "            oldest => slot;\n"
+             << "            Machine.remove(sfxVoices[slot].id());\n"
+             << "        }\n"
+             << "        spork ~ play() @=> sfxVoices[slot];\n"
+             << "        sfxStamp++;\n"
+             << "        sfxStamp => sfxVoiceStamp[slot];\n"
+             << "    }\n"
+             << "}\n";
+        outCode = code.str();
+        return true;
+    }
+
+    static void remove_shred(AudioContext& audio, t_CKUINT& shredId) {
+        if (!shredId) return;
+        if (auto* sh = audio.chuck->vm()->shreduler()->lookup(shredId)) {
+            audio.chuck->vm()->shreduler()->remove(sh);
+        }
+        shredId = 0;
+    }
+
+    static bool compile_sfx_host(AudioContext& audio, ChuckSfxSound& sound) {
+        sound.ready = false;
+        remove_shred(audio, sound.hostShredId);
+        std::ifstream f(sound.scriptPath);
+        if (!f.is_open()) {
+            std::cerr << "ChucK SFX script not found at '" << sound.scriptPath << "'." << std::endl;
+            return false;
+        }
+        std::stringstream source;
+        source << f.rdbuf();
+        file_mtime(sound.scriptPath, sound.scriptMTime);
+        std::string code;
+        if (!build_sfx_host(source.str(), sound, audio.chuckSfxVoicesPerSound, code)) {
+            std::cerr << "ChucK SFX script '" << sound.scriptPath
+                      << "' does not define fun void play(); it will not play." << std::endl;
+            return false;
+        }
+        std::vector<t_CKUINT> ids;
+        bool ok = audio.chuck->compileCode(code, "", 1, FALSE, &ids);
+        if (!ok || ids.empty()) {
+            std::cerr << "ChucK failed to compile SFX script: " << sound.scriptPath << std::endl;
+            return false;
+        }
+        sound.hostShredId = ids.front();
+        sound.ready = true;
+        return true;
+    }
+
+    static int find_sfx(const AudioContext& audio, const std::string& scriptPath) {
+        const int count = audio.chuckSfxSoundCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; ++i) {
+            if (audio.chuckSfxSounds[static_cast<size_t>(i)].scriptPath == scriptPath) return i;
+        }
+        return -1;
+    }
+
+    // Main thread only. A script is compiled the first time it is seen and
+    // never again unless the file changes; a failed compile is remembered so
+    // a broken script is not recompiled on every trigger.
+    static int register_sfx(AudioContext& audio, const std::string& scriptPath) {
+        int index = find_sfx(audio, scriptPath);
+        if (index >= 0) return index;
+        if (audio.chuckSfxSounds.capacity() == 0) {
+            audio.chuckSfxSounds.reserve(kMaxSfxSounds);
+        }
+        index = audio.chuckSfxSoundCount.load(std::memory_order_relaxed);
+        if (index >= kMaxSfxSounds) {
+            std::cerr << "ChucK SFX table full; ignoring " << scriptPath << std::endl;
+            return -1;
+        }
+        ChuckSfxSound sound;
+        sound.scriptPath = scriptPath;
+        sound.triggerEvent = "sfx_trigger_" + std::to_string(index);
+        sound.triggerCount = "sfx_trigger_count_" + std::to_string(index);
+        compile_sfx_host(audio, sound);
+        audio.chuckSfxSounds.push_back(std::move(sound));
+        audio.chuckSfxSoundCount.store(index + 1, std::memory_order_release);
+        return index;
+    }
+
+    static void preload_sfx(BaseSystem& baseSystem, AudioContext& audio) {
+        audio.chuckSfxPreloaded = true;
+        audio.chuckSfxVoicesPerSound = std::clamp(
+            RenderInitSystemLogic::getRegistryInt(baseSystem, "ChuckSfxVoicesPerSound", audio.chuckSfxVoicesPerSound), 1, 32);
+        int ready = 0;
+        int failed = 0;
+        for (const char* folder : kSfxFolders) {
+            std::error_code ec;
+            std::vector<std::string> scripts;
+            for (const auto& entry : std::filesystem::directory_iterator(folder, ec)) {
+                if (entry.path().extension() == ".ck") scripts.push_back(entry.path().generic_string());
+            }
+            std::sort(scripts.begin(), scripts.end());
+            for (const auto& script : scripts) {
+                int index = register_sfx(audio, script);
+                if (index >= 0 && audio.chuckSfxSounds[static_cast<size_t>(index)].ready) ++ready;
+                else ++failed;
+            }
+        }
+        std::cout << "ChucK SFX ready: " << ready << " script(s), "
+                  << audio.chuckSfxVoicesPerSound << " voice(s) each." << std::endl;
+        if (failed > 0) {
+            std::cerr << "ChucK SFX: " << failed << " script(s) failed to load and will stay silent." << std::endl;
+        }
+    }
+
+    static void reload_changed_sfx(AudioContext& audio) {
+        const int count = audio.chuckSfxSoundCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; ++i) {
+            ChuckSfxSound& sound = audio.chuckSfxSounds[static_cast<size_t>(i)];
+            std::time_t m;
+            if (file_mtime(sound.scriptPath, m) && m != sound.scriptMTime) {
+                compile_sfx_host(audio, sound);
+            }
+        }
+    }
+
+    bool TriggerSfx(BaseSystem& baseSystem, const std::string& scriptPath, float cooldownSeconds) {
+        if (!baseSystem.audio || !baseSystem.audio->chuck) return false;
+        AudioContext& audio = *baseSystem.audio;
+        if (!audio.chuckSfxTriggerRing) return false;
+        const int index = register_sfx(audio, scriptPath);
+        if (index < 0) return false;
+        ChuckSfxSound& sound = audio.chuckSfxSounds[static_cast<size_t>(index)];
+        if (!sound.ready) return false;
+        const double now = glfwGetTime();
+        if ((now - sound.lastTriggerTime) < static_cast<double>(cooldownSeconds)) return false;
+        if (jack_ringbuffer_write_space(audio.chuckSfxTriggerRing) < sizeof(ChuckSfxTrigger)) return false;
+        ChuckSfxTrigger trigger;
+        trigger.soundIndex = static_cast<uint16_t>(index);
+        jack_ringbuffer_write(audio.chuckSfxTriggerRing,
+                              reinterpret_cast<const char*>(&trigger),
+                              sizeof(ChuckSfxTrigger));
+        sound.lastTriggerTime = now;
+        return true;
+    }
+
+    // Audio thread, just before the VM runs the block. Each sound's running
+    // trigger total is published to its host before the wake-up, so several
+    // triggers inside one block still start several voices.
+    void DispatchSfxTriggers(AudioContext& audio) {
+        if (!audio.chuck || !audio.chuckRunning || !audio.chuckSfxTriggerRing) return;
+        const int count = audio.chuckSfxSoundCount.load(std::memory_order_acquire);
+        std::array<uint16_t, kMaxSfxSounds> pending{};
+        ChuckSfxTrigger trigger;
+        while (jack_ringbuffer_read_space(audio.chuckSfxTriggerRing) >= sizeof(ChuckSfxTrigger)) {
+            jack_ringbuffer_read(audio.chuckSfxTriggerRing,
+                                 reinterpret_cast<char*>(&trigger),
+                                 sizeof(ChuckSfxTrigger));
+            if (trigger.soundIndex >= count) continue;
+            pending[trigger.soundIndex] += 1;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (pending[static_cast<size_t>(i)] == 0) continue;
+            ChuckSfxSound& sound = audio.chuckSfxSounds[static_cast<size_t>(i)];
+            sound.triggersSent += pending[static_cast<size_t>(i)];
+            audio.chuck->setGlobalInt(sound.triggerCount.c_str(), sound.triggersSent);
+            audio.chuck->signalGlobalEvent(sound.triggerEvent.c_str());
+        }
+    }
+
     void StopNoiseShred(BaseSystem& baseSystem) {
         if (!baseSystem.audio || !baseSystem.audio->chuck) return;
         AudioContext& audio = *baseSystem.audio;
@@ -98,6 +299,15 @@ namespace ChucKSystemLogic {
         if (!baseSystem.audio || !baseSystem.audio->chuck) return;
         AudioContext& audio = *baseSystem.audio;
 
+        if (!audio.chuckSfxPreloaded) {
+            preload_sfx(baseSystem, audio);
+        }
+        audio.chuckSfxReloadTimer += dt;
+        if (audio.chuckSfxReloadTimer >= kSfxReloadCheckSeconds) {
+            audio.chuckSfxReloadTimer = 0.0f;
+            reload_changed_sfx(audio);
+        }
+
         if (audio.chuckBypass) {
             if (audio.chuckMainShredId) {
                 if (auto* sh = audio.chuck->vm()->shreduler()->lookup(audio.chuckMainShredId)) {
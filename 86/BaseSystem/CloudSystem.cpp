@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace CloudSystemLogic {
 
     namespace {
@@ -29,6 +31,7 @@ namespace CloudSystemLogic {
         VoxelWorldContext& voxelWorld = *baseSystem.voxelWorld;
         if (!voxelWorld.enabled || voxelWorld.sections.empty()) return;
         if (!renderer.faceShader || !renderer.faceVAO || !renderer.faceInstanceVBO) return;
+        RenderDevice::Device& device = RenderDevice::current();
 
         glm::mat4 view = player.viewMatrix;
         float fovY = 2.0f * std::atan(1.0f / std::max(player.projectionMatrix[1][1], 1e-5f));
@@ -109,11 +112,11 @@ namespace CloudSystemLogic {
 
         if (cloudInstances.empty()) return;
 
-        glDisable(GL_DEPTH_TEST);
-        glDepthMask(GL_FALSE);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDisable(GL_CULL_FACE);
+        device.disable(GL_DEPTH_TEST);
+        device.depthMask(false);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.disable(GL_CULL_FACE);
 
         renderer.faceShader->use();
         renderer.faceShader->setMat4("view", view);
@@ -132,18 +135,15 @@ namespace CloudSystemLogic {
         renderer.faceShader->setInt("atlasTexture", 0);
         renderer.faceShader->setInt("faceType", 2); // Horizontal (+Y) cloud sheet.
 
-        glBindVertexArray(renderer.faceVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
-        glBufferData(GL_ARRAY_BUFFER,
-                     static_cast<GLsizeiptr>(cloudInstances.size() * sizeof(FaceInstanceRenderData)),
-                     cloudInstances.data(),
-                     GL_DYNAMIC_DRAW);
-        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(cloudInstances.size()));
-
-        glEnable(GL_CULL_FACE);
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
+        device.bindVertexArray(renderer.faceVAO);
+        device.bindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
+        device.bufferData(GL_ARRAY_BUFFER, cloudInstances.size() * sizeof(FaceInstanceRenderData), cloudInstances.data(), GL_DYNAMIC_DRAW);
+        device.drawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(cloudInstances.size()));
+
+        device.enable(GL_CULL_FACE);
+        device.disable(GL_BLEND);
+        device.depthMask(true);
+        device.enable(GL_DEPTH_TEST);
     }
 
 }
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BaseSystem/BlockCellIndex.h"
+
+// Uniform-grid broadphase over axis-aligned boxes. Every entry is filed under
+// each grid cell its box overlaps, so a query only visits the cells its own
+// box covers and reports each overlapping entry once. Overlap is inclusive
+// (touching boxes are candidates); callers run the exact test. Handles stay
+// valid until removed and are then recycled. Queries share a stamp buffer and
+// must not run concurrently with each other or with edits.
+struct CollisionSpatialHash {
+    using CellHash = BlockCellHash;
+
+    struct Entry {
+        glm::vec3 min{0.0f};
+        glm::vec3 max{0.0f};
+        glm::ivec3 cellMin{0};
+        glm::ivec3 cellMax{-1};
+        int32_t tag = 0;
+        bool live = false;
+    };
+
+    float cellSize = 4.0f;
+    std::vector<Entry> entries;
+    std::vector<int32_t> freeEntries;
+    std::unordered_map<glm::ivec3, std::vector<int32_t>, CellHash> cells;
+    size_t liveCount = 0;
+
+    void clear(float newCellSize) {
+        cellSize = newCellSize > 0.0f ? newCellSize : 4.0f;
+        entries.clear();
+        freeEntries.clear();
+        cells.clear();
+        stamps.clear();
+        stamp = 0;
+        liveCount = 0;
+    }
+
+    glm::ivec3 cellOf(const glm::vec3& p) const {
+        return glm::ivec3(static_cast<int>(std::floor(p.x / cellSize)),
+                          static_cast<int>(std::floor(p.y / cellSize)),
+                          static_cast<int>(std::floor(p.z / cellSize)));
+    }
+
+    int32_t insert(const glm::vec3& min, const glm::vec3& max, int32_t tag) {
+        int32_t handle = 0;
+        if (!freeEntries.empty()) {
+            handle = freeEntries.back();
+            freeEntries.pop_back();
+        } else {
+            handle = static_cast<int32_t>(entries.size());
+            entries.emplace_back();
+            stamps.push_back(0);
+        }
+        Entry& entry = entries[static_cast<size_t>(handle)];
+        entry.min = min;
+        entry.max = max;
+        entry.tag = tag;
+        entry.live = true;
+        entry.cellMin = cellOf(min);
+        entry.cellMax = cellOf(max);
+        link(handle, entry.cellMin, entry.cellMax);
+        liveCount += 1;
+        return handle;
+    }
+
+    // Re-files the entry only when its covered cell range changes.
+    void move(int32_t handle, const glm::vec3& min, const glm::vec3& max) {
+        if (!valid(handle)) return;
+        Entry& entry = entries[static_cast<size_t>(handle)];
+        const glm::ivec3 newMin = cellOf(min);
+        const glm::ivec3 newMax = cellOf(max);
+        entry.min = min;
+        entry.max = max;
+        if (newMin == entry.cellMin && newMax == entry.cellMax) return;
+        unlink(handle, entry.cellMin, entry.cellMax);
+        entry.cellMin = newMin;
+        entry.cellMax = newMax;
+        link(handle, newMin, newMax);
+    }
+
+    void remove(int32_t handle) {
+        if (!valid(handle)) return;
+        Entry& entry = entries[static_cast<size_t>(handle)];
+        unlink(handle, entry.cellMin, entry.cellMax);
+        entry.live = false;
+        freeEntries.push_back(handle);
+        liveCount -= 1;
+    }
+
+    bool valid(int32_t handle) const {
+        return handle >= 0 && handle < static_cast<int32_t>(entries.size())
+            && entries[static_cast<size_t>(handle)].live;
+    }
+
+    // Appends the handles of entries overlapping [min, max].
+    void query(const glm::vec3& min, const glm::vec3& max, std::vector<int32_t>& out) const {
+        if (liveCount == 0) return;
+        nextStamp();
+        const glm::ivec3 lo = cellOf(min);
+        const glm::ivec3 hi = cellOf(max);
+        const double span = (static_cast<double>(hi.x) - lo.x + 1.0)
+            * (static_cast<double>(hi.y) - lo.y + 1.0)
+            * (static_cast<double>(hi.z) - lo.z + 1.0);
+        if (span > static_cast<double>(cells.size())) {
+            // Query box covers more grid cells than are occupied; walk the
+            // occupied ones instead.
+            for (const auto& [cell, list] : cells) {
+                if (cell.x < lo.x || cell.y < lo.y || cell.z < lo.z) continue;
+                if (cell.x > hi.x || cell.y > hi.y || cell.z > hi.z) continue;
+                collect(list, min, max, out);
+            }
+            return;
+        }
+        for (int z = lo.z; z <= hi.z; ++z) {
+            for (int y = lo.y; y <= hi.y; ++y) {
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    auto it = cells.find(glm::ivec3(x, y, z));
+                    if (it == cells.end()) continue;
+                    collect(it->second, min, max, out);
+                }
+            }
+        }
+    }
+
+    // Box [min, max] moved by `delta`: candidates are everything overlapping
+    // the union of its start and end positions.
+    void querySwept(const glm::vec3& min, const glm::vec3& max, const glm::vec3& delta, std::vector<int32_t>& out) const {
+        query(glm::min(min, min + delta), glm::max(max, max + delta), out);
+    }
+
+    // One query per body; results for body i are handles[offsets[i] .. offsets[i + 1]).
+    void queryBatch(const std::vector<glm::vec3>& mins,
+                    const std::vector<glm::vec3>& maxs,
+                    std::vector<int32_t>& offsets,
+                    std::vector<int32_t>& handles) const {
+        const size_t count = std::min(mins.size(), maxs.size());
+        offsets.assign(count + 1, 0);
+        handles.clear();
+        for (size_t i = 0; i < count; ++i) {
+            query(mins[i], maxs[i], handles);
+            offsets[i + 1] = static_cast<int32_t>(handles.size());
+        }
+    }
+
+private:
+    mutable std::vector<uint32_t> stamps;
+    mutable uint32_t stamp = 0;
+
+    void nextStamp() const {
+        stamp += 1;
+        if (stamp == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0u);
+            stamp = 1;
+        }
+    }
+
+    void collect(const std::vector<int32_t>& list, const glm::vec3& min, const glm::vec3& max, std::vector<int32_t>& out) const {
+        for (int32_t handle : list) {
+            uint32_t& seen = stamps[static_cast<size_t>(handle)];
+            if (seen == stamp) continue;
+            seen = stamp;
+            const Entry& entry = entries[static_cast<size_t>(handle)];
+            if (entry.min.x > max.x || entry.max.x < min.x) continue;
+            if (entry.min.y > max.y || entry.max.y < min.y) continue;
+            if (entry.min.z > max.z || entry.max.z < min.z) continue;
+            out.push_back(handle);
+        }
+    }
+
+    void link(int32_t handle, const glm::ivec3& lo, const glm::ivec3& hi) {
+        for (int z = lo.z; z <= hi.z; ++z) {
+            for (int y = lo.y; y <= hi.y; ++y) {
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    cells[glm::ivec3(x, y, z)].push_back(handle);
+                }
+            }
+        }
+    }
+
+    void unlink(int32_t handle, const glm::ivec3& lo, const glm::ivec3& hi) {
+        for (int z = lo.z; z <= hi.z; ++z) {
+            for (int y = lo.y; y <= hi.y; ++y) {
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    auto it = cells.find(glm::ivec3(x, y, z));
+                    if (it == cells.end()) continue;
+                    std::vector<int32_t>& list = it->second;
+                    auto found = std::find(list.begin(), list.end(), handle);
+                    if (found == list.end()) continue;
+                    *found = list.back();
+                    list.pop_back();
+                    if (list.empty()) cells.erase(it);
+                }
+            }
+        }
+    }
+};
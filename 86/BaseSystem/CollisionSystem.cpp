@@ -1,7 +1,9 @@
 #pragma once
 #include "../Host.h"
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
+#include "BaseSystem/CollisionSpatialHash.h"
 
 namespace CollisionSystemLogic {
 
@@ -29,21 +31,8 @@ namespace CollisionSystemLogic {
         }
 
         bool triggerGameplaySfx(BaseSystem& baseSystem, const char* fileName, float cooldownSeconds = 0.0f) {
-            if (!fileName || !baseSystem.audio || !baseSystem.audio->chuck) return false;
-            const std::string scriptPath = std::string("Procedures/chuck/gameplay/") + fileName;
-            static std::unordered_map<std::string, double> s_lastTrigger;
-            const double now = glfwGetTime();
-            auto it = s_lastTrigger.find(scriptPath);
-            if (it != s_lastTrigger.end() && (now - it->second) < static_cast<double>(cooldownSeconds)) {
-                return false;
-            }
-            std::vector<t_CKUINT> ids;
-            bool ok = baseSystem.audio->chuck->compileFile(scriptPath, "", 1, FALSE, &ids);
-            if (ok && !ids.empty()) {
-                s_lastTrigger[scriptPath] = now;
-                return true;
-            }
-            return false;
+            if (!fileName) return false;
+            return ChucKSystemLogic::TriggerSfx(baseSystem, std::string("Procedures/chuck/gameplay/") + fileName, cooldownSeconds);
         }
 
         int floorDivInt(int value, int divisor) {
@@ -106,6 +95,172 @@ namespace CollisionSystemLogic {
         }
     }
 
+    // Persistent broadphase over the collidable block instances of every level
+    // world (voxel worlds are addressed by cell and bypass it). Entry tags hold
+    // the SlopeDir, None for plain solid boxes. Block edits patch it through
+    // NotifyBlockAdded/NotifyBlockRemoved; a world is rebuilt when invalidated,
+    // when its instanceEdits or instance count moved on without going through
+    // those hooks, or when another world took its slot.
+    // Colliding instances sharing a cell share one box, counted so it stays
+    // until the last of them is removed.
+    struct CellCollider {
+        int32_t handle = -1;
+        int32_t count = 0;
+    };
+
+    struct WorldColliderIndex {
+        std::unordered_map<glm::ivec3, CellCollider, CollisionSpatialHash::CellHash> cells;
+        std::string worldName;
+        uint64_t syncedEdits = 0;
+        size_t syncedCount = 0;
+        bool built = false;
+    };
+
+    struct ColliderIndex {
+        CollisionSpatialHash hash;
+        std::vector<WorldColliderIndex> worlds;
+        std::vector<int32_t> candidates;
+    };
+
+    static ColliderIndex g_colliderIndex;
+
+    namespace {
+        // -1 when the prototype does not collide, otherwise the entry tag.
+        int colliderTag(const std::vector<Entity>& prototypes, int prototypeID) {
+            if (prototypeID < 0 || prototypeID >= static_cast<int>(prototypes.size())) return -1;
+            const Entity& proto = prototypes[prototypeID];
+            SlopeDir slopeDir = slopeDirFromName(proto.name);
+            if (slopeDir != SlopeDir::None) return static_cast<int>(slopeDir);
+            bool isNonColliding = proto.name == "Water" || proto.name == "AudioVisualizer";
+            if (!proto.isBlock || isNonColliding || !proto.isSolid) return -1;
+            return static_cast<int>(SlopeDir::None);
+        }
+
+        void addCollider(WorldColliderIndex& world, const glm::vec3& position, int tag) {
+            if (tag < 0) return;
+            const glm::ivec3 cell = BlockCellIndex::cellOf(position);
+            CellCollider& collider = world.cells[cell];
+            if (collider.count > 0) {
+                collider.count += 1;
+                g_colliderIndex.hash.entries[static_cast<size_t>(collider.handle)].tag = tag;
+                return;
+            }
+            collider.handle = g_colliderIndex.hash.insert(position - glm::vec3(0.5f), position + glm::vec3(0.5f), tag);
+            collider.count = 1;
+        }
+
+        void removeCollider(WorldColliderIndex& world, const glm::vec3& position) {
+            auto it = world.cells.find(BlockCellIndex::cellOf(position));
+            if (it == world.cells.end()) return;
+            it->second.count -= 1;
+            if (it->second.count > 0) return;
+            g_colliderIndex.hash.remove(it->second.handle);
+            world.cells.erase(it);
+        }
+
+        void clearWorldColliders(WorldColliderIndex& world) {
+            for (const auto& [cell, collider] : world.cells) {
+                (void)cell;
+                g_colliderIndex.hash.remove(collider.handle);
+            }
+            world.cells.clear();
+            world.built = false;
+        }
+
+        void buildWorldColliders(WorldColliderIndex& index, const Entity& world, const std::vector<Entity>& prototypes) {
+            clearWorldColliders(index);
+            for (const auto& inst : world.instances) {
+                addCollider(index, inst.position, colliderTag(prototypes, inst.prototypeID));
+            }
+            index.worldName = world.name;
+            index.syncedEdits = world.instanceEdits;
+            index.syncedCount = world.instances.size();
+            index.built = true;
+        }
+
+        ColliderIndex& ensureColliderIndex(const BaseSystem& baseSystem, const std::vector<Entity>& prototypes) {
+            ColliderIndex& index = g_colliderIndex;
+            const auto& worlds = baseSystem.level->worlds;
+            if (index.worlds.size() != worlds.size()) {
+                index.worlds.clear();
+                index.hash.clear(std::max(1.0f, getRegistryFloat(baseSystem, "CollisionBroadphaseCellSize", 4.0f)));
+                index.worlds.resize(worlds.size());
+            }
+            for (size_t i = 0; i < worlds.size(); ++i) {
+                WorldColliderIndex& world = index.worlds[i];
+                const Entity& source = worlds[i];
+                if (!world.built || world.syncedEdits != source.instanceEdits
+                    || world.syncedCount != source.instances.size() || world.worldName != source.name) {
+                    buildWorldColliders(world, source, prototypes);
+                }
+            }
+            return index;
+        }
+
+        // The hooks are called right after the one edit they describe; any
+        // other edit since the last sync leaves the world stale for a rebuild.
+        WorldColliderIndex* hookedWorld(const BaseSystem& baseSystem, int worldIndex) {
+            if (!baseSystem.level) return nullptr;
+            if (worldIndex < 0 || worldIndex >= static_cast<int>(g_colliderIndex.worlds.size())) return nullptr;
+            if (worldIndex >= static_cast<int>(baseSystem.level->worlds.size())) return nullptr;
+            WorldColliderIndex& world = g_colliderIndex.worlds[worldIndex];
+            if (!world.built) return nullptr;
+            const Entity& source = baseSystem.level->worlds[worldIndex];
+            if (world.syncedEdits + 1 != source.instanceEdits || world.worldName != source.name) return nullptr;
+            world.syncedEdits = source.instanceEdits;
+            world.syncedCount = source.instances.size();
+            return &world;
+        }
+    }
+
+    void NotifyBlockAdded(BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position, int prototypeID) {
+        WorldColliderIndex* world = hookedWorld(baseSystem, worldIndex);
+        if (!world) return;
+        addCollider(*world, position, colliderTag(prototypes, prototypeID));
+    }
+
+    void NotifyBlockRemoved(BaseSystem& baseSystem, int worldIndex, const glm::vec3& position) {
+        WorldColliderIndex* world = hookedWorld(baseSystem, worldIndex);
+        if (!world) return;
+        removeCollider(*world, position);
+    }
+
+    // worldIndex < 0 drops every world.
+    void InvalidateColliders(int worldIndex) {
+        if (worldIndex < 0) {
+            for (auto& world : g_colliderIndex.worlds) clearWorldColliders(world);
+            return;
+        }
+        if (worldIndex >= static_cast<int>(g_colliderIndex.worlds.size())) return;
+        clearWorldColliders(g_colliderIndex.worlds[worldIndex]);
+    }
+
+    // Instance-world collider boxes (slopes as full cells) overlapping each
+    // query box; results for box i are [offsets[i], offsets[i + 1]) of hitMin/hitMax.
+    void QueryColliderBatch(BaseSystem& baseSystem,
+                            const std::vector<Entity>& prototypes,
+                            const std::vector<glm::vec3>& boxMin,
+                            const std::vector<glm::vec3>& boxMax,
+                            std::vector<int>& offsets,
+                            std::vector<glm::vec3>& hitMin,
+                            std::vector<glm::vec3>& hitMax) {
+        offsets.assign(std::min(boxMin.size(), boxMax.size()) + 1, 0);
+        hitMin.clear();
+        hitMax.clear();
+        if (!baseSystem.level) return;
+        ColliderIndex& index = ensureColliderIndex(baseSystem, prototypes);
+        std::vector<int32_t> handleOffsets;
+        index.hash.queryBatch(boxMin, boxMax, handleOffsets, index.candidates);
+        for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+            for (int32_t k = handleOffsets[i]; k < handleOffsets[i + 1]; ++k) {
+                const CollisionSpatialHash::Entry& entry = index.hash.entries[static_cast<size_t>(index.candidates[k])];
+                hitMin.push_back(entry.min);
+                hitMax.push_back(entry.max);
+            }
+            offsets[i + 1] = static_cast<int>(hitMin.size());
+        }
+    }
+
     AABB MakePlayerAABB(const glm::vec3& center, const glm::vec3& halfExtents) {
         return {center - halfExtents, center + halfExtents};
     }
@@ -204,19 +359,25 @@ namespace CollisionSystemLogic {
                 }
             }
         } else {
-            for (const auto& world : baseSystem.level->worlds) {
-                for (const auto& inst : world.instances) {
-                    if (inst.prototypeID < 0 || inst.prototypeID >= static_cast<int>(prototypes.size())) continue;
-                    const Entity& proto = prototypes[inst.prototypeID];
-                    SlopeDir slopeDir = slopeDirFromName(proto.name);
-                    if (slopeDir != SlopeDir::None) {
-                        slopeColliders.push_back({inst.position, slopeDir});
-                        continue;
-                    }
-                    bool isNonColliding = proto.name == "Water" || proto.name == "AudioVisualizer";
-                    if (!proto.isBlock || isNonColliding || !proto.isSolid) continue;
-                    blockAABBs.push_back({inst.position - glm::vec3(0.5f), inst.position + glm::vec3(0.5f)});
+            // Sweep the player box, padded to cover auto-step headroom and the
+            // slope snap/seam windows, which look past the swept volume.
+            ColliderIndex& index = ensureColliderIndex(baseSystem, prototypes);
+            const glm::vec3 queryPad(1.5f, 3.0f, 1.5f);
+            index.candidates.clear();
+            index.hash.querySwept(prevPos - halfExtents - queryPad,
+                                  prevPos + halfExtents + queryPad,
+                                  velocity,
+                                  index.candidates);
+            // Handle order keeps ResolveAxis deterministic between frames.
+            std::sort(index.candidates.begin(), index.candidates.end());
+            for (int32_t handle : index.candidates) {
+                const CollisionSpatialHash::Entry& entry = index.hash.entries[static_cast<size_t>(handle)];
+                const SlopeDir slopeDir = static_cast<SlopeDir>(entry.tag);
+                if (slopeDir != SlopeDir::None) {
+                    slopeColliders.push_back({(entry.min + entry.max) * 0.5f, slopeDir});
+                    continue;
                 }
+                blockAABBs.push_back({entry.min, entry.max});
             }
         }
         if (baseSystem.fishing && baseSystem.fishing->rodPlacedInWorld) {
@@ -4,6 +4,8 @@
 #include <cmath>
 #include <limits>
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace ColorEmotionSystemLogic {
 
     namespace {
@@ -409,6 +411,7 @@ namespace ColorEmotionSystemLogic {
         ColorEmotionContext& emotion = *baseSystem.colorEmotion;
         PlayerContext& player = *baseSystem.player;
         if (!emotion.enabled || !emotion.active || emotion.intensity <= 0.001f) return;
+        RenderDevice::Device& device = RenderDevice::current();
 
         const bool underwaterWaterlineEnabled = getRegistryBool(baseSystem, "ColorEmotionUnderwaterWaterlineEnabled", false);
         if (underwaterWaterlineEnabled
@@ -490,21 +493,18 @@ namespace ColorEmotionSystemLogic {
                 }
 
                 if (!cueVerts.empty()) {
-                    glEnable(GL_DEPTH_TEST);
-                    glEnable(GL_BLEND);
-                    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    device.enable(GL_DEPTH_TEST);
+                    device.enable(GL_BLEND);
+                    device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
                     renderer.audioRayShader->use();
                     renderer.audioRayShader->setMat4("view", player.viewMatrix);
                     renderer.audioRayShader->setMat4("projection", player.projectionMatrix);
-                    glBindVertexArray(renderer.audioRayVAO);
-                    glBindBuffer(GL_ARRAY_BUFFER, renderer.audioRayVBO);
-                    glBufferData(GL_ARRAY_BUFFER,
-                                 static_cast<GLsizeiptr>(cueVerts.size() * sizeof(CueVertex)),
-                                 cueVerts.data(),
-                                 GL_DYNAMIC_DRAW);
-                    glLineWidth(cueLineWidth);
-                    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(cueVerts.size()));
-                    glLineWidth(1.0f);
+                    device.bindVertexArray(renderer.audioRayVAO);
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.audioRayVBO);
+                    device.bufferData(GL_ARRAY_BUFFER, cueVerts.size() * sizeof(CueVertex), cueVerts.data(), GL_DYNAMIC_DRAW);
+                    device.lineWidth(cueLineWidth);
+                    device.drawArrays(GL_LINES, 0, static_cast<GLsizei>(cueVerts.size()));
+                    device.lineWidth(1.0f);
                 }
             }
         }
@@ -516,9 +516,9 @@ namespace ColorEmotionSystemLogic {
         if (win) glfwGetFramebufferSize(win, &fbWidth, &fbHeight);
         float aspectRatio = (fbHeight > 0) ? (static_cast<float>(fbWidth) / static_cast<float>(fbHeight)) : 1.0f;
 
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.disable(GL_DEPTH_TEST);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         const float opacityScale = glm::clamp(getRegistryFloat(baseSystem, "ColorEmotionOpacityScale", 0.62f), 0.0f, 1.0f);
         const float fullChargeSpinSpeed = getRegistryFloat(baseSystem, "ColorEmotionChargeFullSpinSpeed", 3.0f);
@@ -580,9 +580,9 @@ namespace ColorEmotionSystemLogic {
         renderer.colorEmotionShader->setVec3("chargeDualToneSecondaryColor", dualToneSecondary);
         renderer.colorEmotionShader->setFloat("chargeDualToneSpinSpeed", fullChargeSpinSpeed);
 
-        glBindVertexArray(renderer.colorEmotionVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
-        glEnable(GL_DEPTH_TEST);
+        device.bindVertexArray(renderer.colorEmotionVAO);
+        device.drawArrays(GL_TRIANGLES, 0, 6);
+        device.bindVertexArray(0);
+        device.enable(GL_DEPTH_TEST);
     }
 }
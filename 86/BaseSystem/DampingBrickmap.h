@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Two-level occupancy grid over block cells for the audio ray marcher. The
+// coarse level is a dense bitmask of 8x8x8 bricks over a growable box; each
+// set bit owns a brick holding one damping byte per cell (0 = empty). A clear
+// bit therefore answers "512 empty cells" without touching any hash map, and
+// skipEmptyBrick() lets a voxel DDA cross such a brick in one step.
+struct DampingBrickmap {
+    static constexpr int kBrickShift = 3;
+    static constexpr int kBrickSize = 1 << kBrickShift;
+    static constexpr int kBrickCells = kBrickSize * kBrickSize * kBrickSize;
+    static constexpr int kGrowMarginBricks = 4;
+
+    struct Brick {
+        std::array<uint8_t, kBrickCells> damping{};
+        uint16_t occupied = 0;
+    };
+
+    glm::ivec3 originBrick{0};
+    glm::ivec3 dims{0};
+    std::vector<uint64_t> occupiedBits;
+    std::vector<int32_t> brickIndex;
+    std::vector<Brick> bricks;
+    std::vector<int32_t> freeBricks;
+
+    static uint8_t encodeDamping(float damping) {
+        float clamped = damping < 0.0f ? 0.0f : (damping > 1.0f ? 1.0f : damping);
+        return static_cast<uint8_t>(1 + static_cast<int>(clamped * 254.0f + 0.5f));
+    }
+
+    static float decodeDamping(uint8_t value) {
+        return static_cast<float>(value - 1) / 254.0f;
+    }
+
+    static glm::ivec3 brickOf(const glm::ivec3& cell) {
+        return glm::ivec3(cell.x >> kBrickShift, cell.y >> kBrickShift, cell.z >> kBrickShift);
+    }
+
+    static int cellSlot(const glm::ivec3& cell) {
+        const int mask = kBrickSize - 1;
+        return (cell.x & mask) | ((cell.y & mask) << kBrickShift) | ((cell.z & mask) << (2 * kBrickShift));
+    }
+
+    void clear() {
+        originBrick = glm::ivec3(0);
+        dims = glm::ivec3(0);
+        occupiedBits.clear();
+        brickIndex.clear();
+        bricks.clear();
+        freeBricks.clear();
+    }
+
+    bool coarseSlot(const glm::ivec3& brick, size_t& out) const {
+        const glm::ivec3 local = brick - originBrick;
+        if (local.x < 0 || local.y < 0 || local.z < 0) return false;
+        if (local.x >= dims.x || local.y >= dims.y || local.z >= dims.z) return false;
+        out = (static_cast<size_t>(local.z) * static_cast<size_t>(dims.y) + static_cast<size_t>(local.y))
+            * static_cast<size_t>(dims.x) + static_cast<size_t>(local.x);
+        return true;
+    }
+
+    bool brickEmpty(const glm::ivec3& brick) const {
+        size_t slot = 0;
+        if (!coarseSlot(brick, slot)) return true;
+        return (occupiedBits[slot >> 6] & (uint64_t(1) << (slot & 63))) == 0;
+    }
+
+    uint8_t cellValue(const glm::ivec3& cell) const {
+        size_t slot = 0;
+        if (!coarseSlot(brickOf(cell), slot)) return 0;
+        if ((occupiedBits[slot >> 6] & (uint64_t(1) << (slot & 63))) == 0) return 0;
+        return bricks[static_cast<size_t>(brickIndex[slot])].damping[static_cast<size_t>(cellSlot(cell))];
+    }
+
+    bool sample(const glm::ivec3& cell, float& dampingOut) const {
+        const uint8_t value = cellValue(cell);
+        if (value == 0) return false;
+        dampingOut = decodeDamping(value);
+        return true;
+    }
+
+    void setCell(const glm::ivec3& cell, uint8_t value) {
+        const glm::ivec3 brick = brickOf(cell);
+        size_t slot = 0;
+        if (!coarseSlot(brick, slot)) {
+            if (value == 0) return;
+            grow(brick);
+            coarseSlot(brick, slot);
+        }
+        const uint64_t bit = uint64_t(1) << (slot & 63);
+        if ((occupiedBits[slot >> 6] & bit) == 0) {
+            if (value == 0) return;
+            int32_t index = 0;
+            if (!freeBricks.empty()) {
+                index = freeBricks.back();
+                freeBricks.pop_back();
+                bricks[static_cast<size_t>(index)] = Brick{};
+            } else {
+                index = static_cast<int32_t>(bricks.size());
+                bricks.emplace_back();
+            }
+            brickIndex[slot] = index;
+            occupiedBits[slot >> 6] |= bit;
+        }
+        Brick& target = bricks[static_cast<size_t>(brickIndex[slot])];
+        uint8_t& stored = target.damping[static_cast<size_t>(cellSlot(cell))];
+        if (stored == 0 && value != 0) target.occupied += 1;
+        if (stored != 0 && value == 0) target.occupied -= 1;
+        stored = value;
+        if (target.occupied == 0) {
+            freeBricks.push_back(brickIndex[slot]);
+            brickIndex[slot] = -1;
+            occupiedBits[slot >> 6] &= ~bit;
+        }
+    }
+
+    // When `voxel` sits in an empty brick, advances an Amanatides-Woo DDA
+    // (tMax/tDelta/step, ties broken like the marchers in
+    // RayTracedAudioSystem) to the first cell past that brick and returns the
+    // number of cell steps taken. The state, `distance` and `axis` come out
+    // exactly as if those steps had been made one at a time, and
+    // `previousDistance` gets the distance of the step before the last one.
+    // Returns 0 (state untouched) for occupied bricks, rays that never leave,
+    // when the jump would exceed `maxSteps`, or when one of the steps would
+    // advance the distance by no more than `minStep`: marchers that stop on
+    // such a step pass their threshold so they still see it, the others pass
+    // a negative value.
+    int skipEmptyBrick(glm::ivec3& voxel,
+                       glm::vec3& tMax,
+                       const glm::vec3& tDelta,
+                       const glm::ivec3& step,
+                       int maxSteps,
+                       float minStep,
+                       float& distance,
+                       float& previousDistance,
+                       int& axis) const {
+        const glm::ivec3 brick = brickOf(voxel);
+        if (!brickEmpty(brick)) return 0;
+        float exitTime[3];
+        int exitSteps[3];
+        for (int a = 0; a < 3; ++a) {
+            exitTime[a] = std::numeric_limits<float>::infinity();
+            exitSteps[a] = 0;
+            if (step[a] == 0) continue;
+            const int base = brick[a] * kBrickSize;
+            exitSteps[a] = step[a] > 0 ? base + kBrickSize - voxel[a] : voxel[a] - base + 1;
+            float t = tMax[a];
+            for (int i = 1; i < exitSteps[a]; ++i) t += tDelta[a];
+            exitTime[a] = t;
+        }
+        const int exitAxis = (exitTime[0] < exitTime[1])
+            ? (exitTime[0] < exitTime[2] ? 0 : 2)
+            : (exitTime[1] < exitTime[2] ? 1 : 2);
+        const float exitT = exitTime[exitAxis];
+        if (!(exitT < std::numeric_limits<float>::infinity())) return 0;
+
+        // Every other axis takes the crossings it reaches before exitT. At an
+        // exact tie the marchers step z before y before x, so a crossing at
+        // exitT is taken first only by a higher axis.
+        int taken[3] = {0, 0, 0};
+        float newTMax[3] = {tMax[0], tMax[1], tMax[2]};
+        float previous = distance;
+        int total = 0;
+        // Each step lands on one of these crossing times, in rising order per
+        // axis; merged, they are the distances the one-at-a-time march reports.
+        float crossings[3][kBrickSize];
+        for (int a = 0; a < 3; ++a) {
+            if (step[a] == 0) continue;
+            if (a == exitAxis) {
+                taken[a] = exitSteps[a];
+                for (int i = 0; i < taken[a]; ++i) {
+                    if (i + 1 < taken[a]) previous = std::max(previous, newTMax[a]);
+                    crossings[a][i] = newTMax[a];
+                    newTMax[a] += tDelta[a];
+                }
+            } else {
+                while ((newTMax[a] < exitT || (newTMax[a] == exitT && a > exitAxis)) && taken[a] < exitSteps[a] - 1) {
+                    previous = std::max(previous, newTMax[a]);
+                    crossings[a][taken[a]] = newTMax[a];
+                    newTMax[a] += tDelta[a];
+                    taken[a] += 1;
+                }
+            }
+            total += taken[a];
+        }
+        if (total > maxSteps) return 0;
+        if (minStep >= 0.0f) {
+            int next[3] = {0, 0, 0};
+            float last = distance;
+            for (int i = 0; i < total; ++i) {
+                int pick = -1;
+                for (int a = 0; a < 3; ++a) {
+                    if (next[a] < taken[a] && (pick < 0 || crossings[a][next[a]] < crossings[pick][next[pick]])) pick = a;
+                }
+                const float t = crossings[pick][next[pick]++];
+                if (t <= last + minStep) return 0;
+                last = t;
+            }
+        }
+        for (int a = 0; a < 3; ++a) {
+            voxel[a] += step[a] * taken[a];
+            tMax[a] = newTMax[a];
+        }
+        previousDistance = previous;
+        distance = exitT;
+        axis = exitAxis;
+        return total;
+    }
+
+private:
+    void grow(const glm::ivec3& brick) {
+        glm::ivec3 lo = brick - glm::ivec3(kGrowMarginBricks);
+        glm::ivec3 hi = brick + glm::ivec3(kGrowMarginBricks + 1);
+        if (dims.x > 0) {
+            lo = glm::min(lo, originBrick);
+            hi = glm::max(hi, originBrick + dims);
+        }
+        const glm::ivec3 newDims = hi - lo;
+        const size_t count = static_cast<size_t>(newDims.x) * newDims.y * newDims.z;
+        std::vector<uint64_t> newBits((count + 63) / 64, 0);
+        std::vector<int32_t> newIndex(count, -1);
+        for (int z = 0; z < dims.z; ++z) {
+            for (int y = 0; y < dims.y; ++y) {
+                for (int x = 0; x < dims.x; ++x) {
+                    const size_t oldSlot = (static_cast<size_t>(z) * dims.y + y) * dims.x + x;
+                    if (brickIndex[oldSlot] < 0) continue;
+                    const glm::ivec3 local = originBrick + glm::ivec3(x, y, z) - lo;
+                    const size_t newSlot = (static_cast<size_t>(local.z) * newDims.y + local.y) * newDims.x + local.x;
+                    newIndex[newSlot] = brickIndex[oldSlot];
+                    newBits[newSlot >> 6] |= uint64_t(1) << (newSlot & 63);
+                }
+            }
+        }
+        originBrick = lo;
+        dims = newDims;
+        occupiedBits.swap(newBits);
+        brickIndex.swap(newIndex);
+    }
+};
@@ -2,12 +2,17 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <filesystem>
 #include <limits>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace DawWaveformSystemLogic {
-    void RebuildWaveform(DawTrack& track, float sampleRate);
+    void ClearRecordPreview(DawTrack& track);
+}
+namespace DawIOSystemLogic {
+    bool LoadClipAudioFile(DawContext& daw, const std::string& path, DawClipAudio& outClip, uint32_t& outRate);
 }
 
 namespace DawClipSystemLogic {
@@ -84,36 +89,64 @@ namespace DawClipSystemLogic {
             track.clips = std::move(updated);
         }
 
-        void rebuildTrackCacheFromClips(DawContext& daw, DawTrack& track) {
+        uint64_t trackEndSample(const DawTrack& track) {
             uint64_t maxEnd = 0;
             for (const auto& clip : track.clips) {
                 uint64_t end = clip.startSample + clip.length;
                 if (end > maxEnd) maxEnd = end;
             }
-            track.audio.clear();
-            track.audio.resize(static_cast<size_t>(maxEnd), 0.0f);
-            track.audioRight.clear();
-            track.audioRight.resize(static_cast<size_t>(maxEnd), 0.0f);
+            return maxEnd;
+        }
+
+        // Reads the clips that overlap [startSample, startSample + count) straight
+        // from the audio pool. Clips later in track.clips win where they overlap,
+        // matching the order the audio thread mixes them in.
+        void renderTrackRange(DawContext& daw,
+                              const DawTrack& track,
+                              uint64_t startSample,
+                              size_t count,
+                              float* outLeft,
+                              float* outRight) {
+            std::fill(outLeft, outLeft + count, 0.0f);
+            if (outRight) std::fill(outRight, outRight + count, 0.0f);
+            const uint64_t rangeEnd = startSample + count;
             for (const auto& clip : track.clips) {
                 if (clip.audioId < 0 || clip.audioId >= static_cast<int>(daw.clipAudio.size())) continue;
+                const uint64_t clipStart = clip.startSample;
+                const uint64_t clipEnd = clip.startSample + clip.length;
+                if (clipEnd <= clipStart || clipEnd <= startSample || clipStart >= rangeEnd) continue;
                 const DawClipAudio& data = daw.clipAudio[clip.audioId];
-                uint64_t clipStart = clip.startSample;
-                uint64_t clipEnd = clip.startSample + clip.length;
-                uint64_t srcOffset = clip.sourceOffset;
-                if (clipEnd <= clipStart) continue;
-                if (srcOffset >= data.left.size()) continue;
-                uint64_t maxCopy = std::min<uint64_t>(clip.length, data.left.size() - srcOffset);
-                for (uint64_t i = 0; i < maxCopy; ++i) {
-                    size_t dst = static_cast<size_t>(clipStart + i);
-                    if (dst >= track.audio.size()) break;
-                    const size_t src = static_cast<size_t>(srcOffset + i);
-                    float left = data.left[src];
-                    float right = (data.channels > 1 && src < data.right.size()) ? data.right[src] : left;
-                    track.audio[dst] = left;
-                    track.audioRight[dst] = right;
+                const uint64_t sourceFrames = data.frameCount();
+                const uint64_t copyStart = std::max(clipStart, startSample);
+                const uint64_t srcOffset = clip.sourceOffset + (copyStart - clipStart);
+                if (srcOffset >= sourceFrames) continue;
+                const size_t copyCount = static_cast<size_t>(std::min({clipEnd - copyStart,
+                                                                       rangeEnd - copyStart,
+                                                                       sourceFrames - srcOffset}));
+                const size_t dst = static_cast<size_t>(copyStart - startSample);
+                if (data.isStreamed()) {
+                    DawStreamSystemLogic::ReadStreamFrames(daw, data, srcOffset, copyCount,
+                                                           outLeft + dst,
+                                                           outRight ? outRight + dst : nullptr);
+                    continue;
+                }
+                const float* left = data.left.data() + srcOffset;
+                std::copy(left, left + copyCount, outLeft + dst);
+                if (!outRight) continue;
+                if (data.channels > 1 && srcOffset + copyCount <= data.right.size()) {
+                    const float* right = data.right.data() + srcOffset;
+                    std::copy(right, right + copyCount, outRight + dst);
+                } else {
+                    std::copy(left, left + copyCount, outRight + dst);
                 }
             }
-            DawWaveformSystemLogic::RebuildWaveform(track, daw.sampleRate);
+        }
+
+        // Clip edits no longer flatten the track; playback, export and the
+        // mirror all read clips by range, so an edit only drops the stale
+        // record-preview overlay.
+        void refreshTrackFromClips(DawContext&, DawTrack& track) {
+            DawWaveformSystemLogic::ClearRecordPreview(track);
         }
 
         struct PendingRecordSegment {
@@ -155,36 +188,42 @@ namespace DawClipSystemLogic {
             }
         }
 
-        DawClip makeClipFromPendingRange(DawContext& daw,
-                                         const std::vector<float>& pendingLeft,
-                                         const std::vector<float>& pendingRight,
-                                         uint64_t sourceOffset,
-                                         uint64_t length,
-                                         uint64_t startSample) {
+        DawClip makeClipFromTakeRange(int audioId,
+                                      uint64_t takeFrames,
+                                      uint64_t sourceOffset,
+                                      uint64_t length,
+                                      uint64_t startSample) {
             DawClip clip{};
-            if (length == 0 || sourceOffset >= pendingLeft.size()) return clip;
-            uint64_t safeLength = std::min<uint64_t>(length, pendingLeft.size() - sourceOffset);
-            bool stereo = !pendingRight.empty();
-            if (stereo && sourceOffset < pendingRight.size()) {
-                safeLength = std::min<uint64_t>(safeLength, pendingRight.size() - sourceOffset);
-            }
-            if (safeLength == 0) return clip;
-            DawClipAudio segment;
-            segment.channels = stereo ? 2 : 1;
-            segment.left.assign(pendingLeft.begin() + static_cast<size_t>(sourceOffset),
-                                pendingLeft.begin() + static_cast<size_t>(sourceOffset + safeLength));
-            if (stereo) {
-                segment.right.assign(pendingRight.begin() + static_cast<size_t>(sourceOffset),
-                                     pendingRight.begin() + static_cast<size_t>(sourceOffset + safeLength));
-            }
-            clip.audioId = addClipAudio(daw, std::move(segment));
+            if (audioId < 0 || length == 0 || sourceOffset >= takeFrames) return clip;
+            clip.audioId = audioId;
             clip.startSample = startSample;
-            clip.length = safeLength;
-            clip.sourceOffset = 0;
+            clip.length = std::min<uint64_t>(length, takeFrames - sourceOffset);
+            clip.sourceOffset = sourceOffset;
             clip.takeId = -1;
             return clip;
         }
 
+        // Recorded takes arrive as files from DawRecordSystem; they join the
+        // audio pool through the same loader as session audio, so long takes
+        // stay on disk.
+        int addTakeAudio(DawContext& daw, DawTrack& track, uint64_t& outFrames) {
+            outFrames = 0;
+            if (track.recordTakePath.empty() || track.recordTakeFrames == 0) return -1;
+            const std::string path = track.recordTakePath;
+            track.recordTakePath.clear();
+            track.recordTakeFrames = 0;
+            DawClipAudio data;
+            uint32_t rate = 0;
+            if (!DawIOSystemLogic::LoadClipAudioFile(daw, path, data, rate)) return -1;
+            if (!data.isStreamed()) {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+            outFrames = data.frameCount();
+            if (outFrames == 0) return -1;
+            return addClipAudio(daw, std::move(data));
+        }
+
         void captureOverwrittenAsTakes(DawTrack& track, const DawClip& incoming) {
             if (incoming.length == 0) return;
             const uint64_t incomingStart = incoming.startSample;
@@ -217,12 +256,12 @@ namespace DawClipSystemLogic {
 
         void mergePendingRecords(DawContext& daw) {
             for (auto& track : daw.tracks) {
-                if (track.pendingRecord.empty() && track.pendingRecordRight.empty()) continue;
-                std::vector<float> pendingLeft = std::move(track.pendingRecord);
-                std::vector<float> pendingRight = std::move(track.pendingRecordRight);
                 track.pendingRecord.clear();
                 track.pendingRecordRight.clear();
-                uint64_t pendingFrames = static_cast<uint64_t>(pendingLeft.size());
+                track.pendingRecordBase = 0;
+                uint64_t pendingFrames = 0;
+                const int takeAudioId = addTakeAudio(daw, track, pendingFrames);
+                if (takeAudioId < 0) continue;
 
                 const bool loopCapture = track.recordLoopCapture
                     && track.recordLoopEndSample > track.recordLoopStartSample;
@@ -239,12 +278,11 @@ namespace DawClipSystemLogic {
                                             loopLength,
                                             segments);
                     for (const auto& seg : segments) {
-                        DawClip clip = makeClipFromPendingRange(daw,
-                                                                pendingLeft,
-                                                                pendingRight,
-                                                                seg.sourceOffset,
-                                                                seg.length,
-                                                                seg.logicalStart);
+                        DawClip clip = makeClipFromTakeRange(takeAudioId,
+                                                             pendingFrames,
+                                                             seg.sourceOffset,
+                                                             seg.length,
+                                                             seg.logicalStart);
                         if (clip.length == 0) continue;
                         if (seg.loopTake) {
                             loopTakeClips.push_back(clip);
@@ -253,12 +291,11 @@ namespace DawClipSystemLogic {
                         }
                     }
                 } else {
-                    DawClip clip = makeClipFromPendingRange(daw,
-                                                            pendingLeft,
-                                                            pendingRight,
-                                                            0,
-                                                            pendingFrames,
-                                                            track.recordStartSample);
+                    DawClip clip = makeClipFromTakeRange(takeAudioId,
+                                                         pendingFrames,
+                                                         0,
+                                                         pendingFrames,
+                                                         track.recordStartSample);
                     if (clip.length > 0) {
                         regularClips.push_back(clip);
                     }
@@ -288,7 +325,7 @@ namespace DawClipSystemLogic {
                 }
 
                 track.recordLoopCapture = false;
-                rebuildTrackCacheFromClips(daw, track);
+                refreshTrackFromClips(daw, track);
             }
         }
 
@@ -306,7 +343,7 @@ namespace DawClipSystemLogic {
             track.activeLoopTakeIndex = active;
             const DawClip& nextTake = track.loopTakeClips[static_cast<size_t>(active)];
             insertActiveClip(track, nextTake, false);
-            rebuildTrackCacheFromClips(daw, track);
+            refreshTrackFromClips(daw, track);
             return true;
         }
     }
@@ -315,8 +352,16 @@ namespace DawClipSystemLogic {
         trimClipsForNewClip(track, clip);
     }
 
-    void RebuildTrackCacheFromClips(DawContext& daw, DawTrack& track) {
-        rebuildTrackCacheFromClips(daw, track);
+    void RefreshTrackFromClips(DawContext& daw, DawTrack& track) {
+        refreshTrackFromClips(daw, track);
+    }
+
+    uint64_t TrackEndSample(const DawTrack& track) {
+        return trackEndSample(track);
+    }
+
+    void RenderTrackRange(DawContext& daw, const DawTrack& track, uint64_t startSample, size_t count, float* outLeft, float* outRight) {
+        renderTrackRange(daw, track, startSample, count, outLeft, outRight);
     }
 
     void MergePendingRecords(DawContext& daw) {
@@ -12,6 +12,9 @@
 
 #include "BaseSystem/Vst3Host.h"
 #include "DawMixerLayout.h"
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic { UIBatch::Builder& Frame(BaseSystem& baseSystem); }
 
 namespace DawFaderSystemLogic {
     struct UiVertex {
@@ -176,17 +179,6 @@ namespace DawFaderSystemLogic {
             pushQuad(verts, leftA, leftB, leftC, leftD, sideColor, width, height);
         }
 
-        void ensureResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.uiColorShader) {
-                renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(),
-                                                                 world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.uiFaderVAO == 0) {
-                glGenVertexArrays(1, &renderer.uiFaderVAO);
-                glGenBuffers(1, &renderer.uiFaderVBO);
-            }
-        }
-
         void ensureFaderState(DawFaderContext& ctx, int stripCount, float speakerBlockStartupGain) {
             if (stripCount < 0) stripCount = 0;
             size_t target = static_cast<size_t>(stripCount);
@@ -889,10 +881,7 @@ namespace DawFaderSystemLogic {
         PanelRect bottomRect = (panel.bottomRenderRect.w > 0.0f) ? panel.bottomRenderRect : panel.bottomRect;
         if (bottomRect.w <= 1.0f || bottomRect.h <= 1.0f) return;
 
-        RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
-        ensureResources(renderer, world);
-        if (!renderer.uiColorShader) return;
 
         int windowWidth = 0, windowHeight = 0;
         int fbWidth = 0, fbHeight = 0;
@@ -982,7 +971,6 @@ namespace DawFaderSystemLogic {
 
         if (vertices.empty()) return;
 
-        glEnable(GL_SCISSOR_TEST);
         float scaleX = (windowWidth > 0) ? static_cast<float>(fbWidth) / static_cast<float>(windowWidth) : 1.0f;
         float scaleY = (windowHeight > 0) ? static_cast<float>(fbHeight) / static_cast<float>(windowHeight) : 1.0f;
         float bleed = DawMixerLayout::kMixerScissorBleed;
@@ -994,24 +982,13 @@ namespace DawFaderSystemLogic {
         int scissorY = std::max(0, static_cast<int>(scissorYf));
         int scissorW = std::max(0, std::min(fbWidth, static_cast<int>(scissorWf)));
         int scissorH = std::max(0, std::min(fbHeight, static_cast<int>(scissorHf)));
-        glScissor(scissorX, scissorY, scissorW, scissorH);
-
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendColor(0.0f, 0.0f, 0.0f, kFaderAlpha);
-        glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-        glBindVertexArray(renderer.uiFaderVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.uiFaderVBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(UiVertex), vertices.data(), GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, pos));
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, color));
-        glEnableVertexAttribArray(1);
-
-        renderer.uiColorShader->use();
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_DEPTH_TEST);
-        glDisable(GL_SCISSOR_TEST);
+        UIBatch::Clip clip;
+        clip.enabled = true;
+        clip.x = scissorX;
+        clip.y = scissorY;
+        clip.w = scissorW;
+        clip.h = scissorH;
+
+        UIBatchSystemLogic::Frame(baseSystem).addColored(vertices, kFaderAlpha, clip);
     }
 }
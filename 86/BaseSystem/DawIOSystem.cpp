@@ -13,11 +13,15 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "BaseSystem/SessionBinary.h"
+#include "BaseSystem/WavStreamWriter.h"
+
 #if defined(__APPLE__)
 #include <mach-o/dyld.h>
 #elif defined(__linux__)
@@ -25,7 +29,7 @@
 #endif
 
 namespace DawClipSystemLogic {
-    void RebuildTrackCacheFromClips(DawContext& daw, DawTrack& track);
+    void RefreshTrackFromClips(DawContext& daw, DawTrack& track);
 }
 namespace MidiWaveformSystemLogic {
     void RebuildWaveform(MidiTrack& track, float sampleRate);
@@ -197,42 +201,56 @@ namespace DawIOSystemLogic {
             return true;
         }
 
-        bool writeWavMonoFloat(const std::string& path, const std::vector<float>& samples, uint32_t sampleRate) {
-            std::ofstream file(path, std::ios::binary);
-            if (!file.is_open()) return false;
-
-            uint32_t dataSize = static_cast<uint32_t>(samples.size() * sizeof(float));
-            uint32_t riffSize = 36 + dataSize;
-            uint16_t audioFormat = 3;
-            uint16_t numChannels = 1;
-            uint16_t bitsPerSample = 32;
-            uint32_t byteRate = sampleRate * numChannels * (bitsPerSample / 8);
-            uint16_t blockAlign = numChannels * (bitsPerSample / 8);
+        // Audio files may be memory-mapped by DawStreamSystem, so they are never
+        // truncated in place: writers go to a sibling temp file that replaces
+        // the original once complete.
+        std::string tempPathFor(const std::string& path) {
+            return path + ".tmp";
+        }
 
-            file.write("RIFF", 4);
-            file.write(reinterpret_cast<const char*>(&riffSize), sizeof(riffSize));
-            file.write("WAVE", 4);
-            file.write("fmt ", 4);
-            uint32_t fmtSize = 16;
-            file.write(reinterpret_cast<const char*>(&fmtSize), sizeof(fmtSize));
-            file.write(reinterpret_cast<const char*>(&audioFormat), sizeof(audioFormat));
-            file.write(reinterpret_cast<const char*>(&numChannels), sizeof(numChannels));
-            file.write(reinterpret_cast<const char*>(&sampleRate), sizeof(sampleRate));
-            file.write(reinterpret_cast<const char*>(&byteRate), sizeof(byteRate));
-            file.write(reinterpret_cast<const char*>(&blockAlign), sizeof(blockAlign));
-            file.write(reinterpret_cast<const char*>(&bitsPerSample), sizeof(bitsPerSample));
-            file.write("data", 4);
-            file.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
-            if (!samples.empty()) {
-                file.write(reinterpret_cast<const char*>(samples.data()), static_cast<std::streamsize>(dataSize));
+        bool commitTempFile(const std::string& tempPath, const std::string& path, bool ok) {
+            std::error_code ec;
+            if (!ok) {
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+            std::filesystem::rename(tempPath, path, ec);
+            if (ec) {
+                std::filesystem::remove(tempPath, ec);
+                return false;
             }
             return true;
         }
 
+        // Mirror files keep their mono layout (the left channel); the track is
+        // rendered from its clips a chunk at a time instead of from a flat copy.
+        bool writeTrackMirror(DawContext& daw, const DawTrack& track, const std::string& path, uint32_t sampleRate) {
+            const uint64_t frames = DawClipSystemLogic::TrackEndSample(track);
+            const std::string tempPath = tempPathFor(path);
+            const bool needsRf64 = 36 + frames * sizeof(float) > WavStreamWriter::kRiffSizeLimit;
+            bool ok = false;
+            {
+                WavStreamWriter writer;
+                if (writer.open(tempPath, 1, sampleRate, needsRf64)) {
+                    constexpr size_t kChunkFrames = 65536;
+                    std::vector<float> left(static_cast<size_t>(std::min<uint64_t>(kChunkFrames, frames)), 0.0f);
+                    ok = true;
+                    for (uint64_t pos = 0; pos < frames && ok; pos += kChunkFrames) {
+                        size_t count = static_cast<size_t>(std::min<uint64_t>(kChunkFrames, frames - pos));
+                        DawClipSystemLogic::RenderTrackRange(daw, track, pos, count, left.data(), nullptr);
+                        ok = writer.writePlanar(left.data(), nullptr, count);
+                    }
+                    ok = writer.close() && ok;
+                }
+            }
+            return commitTempFile(tempPath, path, ok);
+        }
+
         bool writeWavClipAudio(const std::string& path, const DawClipAudio& clipAudio, uint32_t sampleRate) {
             if (clipAudio.left.empty()) return false;
             const bool stereo = (clipAudio.channels > 1) && !clipAudio.right.empty();
-            std::ofstream file(path, std::ios::binary);
+            const std::string tempPath = tempPathFor(path);
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
             if (!file.is_open()) return false;
 
             uint16_t numChannels = stereo ? 2 : 1;
@@ -269,7 +287,94 @@ namespace DawIOSystemLogic {
             } else {
                 file.write(reinterpret_cast<const char*>(clipAudio.left.data()), static_cast<std::streamsize>(dataSize));
             }
-            return true;
+            file.close();
+            return commitTempFile(tempPath, path, !file.fail());
+        }
+
+        // Clips at or above the configured size stay on disk and are served by
+        // the streaming cache; smaller ones (and anything the mapper rejects)
+        // are loaded into memory as before.
+        bool loadClipAudio(DawContext& daw, const std::string& path, DawClipAudio& outClip, uint32_t& outRate) {
+            std::error_code ec;
+            const uintmax_t fileBytes = std::filesystem::file_size(path, ec);
+            if (!ec && daw.streamThresholdBytes > 0 && fileBytes >= daw.streamThresholdBytes) {
+                if (DawStreamSystemLogic::OpenStreamedClipAudio(daw, path, outClip, outRate)) return true;
+            }
+            return loadWavClipAudio(path, outClip, outRate);
+        }
+
+        // Content hash of a pool entry, computed once. In-memory clips hash
+        // their samples; streamed clips hash the identity of the file they
+        // map (path, size, write time), which writers only ever replace by
+        // rename.
+        uint64_t clipAudioHash(const DawContext& daw, DawClipAudio& clipAudio) {
+            if (clipAudio.contentHash != 0) return clipAudio.contentHash;
+            SessionBinary::Hasher hasher;
+            if (clipAudio.isStreamed()) {
+                const std::string path = DawStreamSystemLogic::StreamSourcePath(daw, clipAudio);
+                std::error_code ec;
+                const uintmax_t bytes = std::filesystem::file_size(path, ec);
+                ec.clear();
+                const auto written = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+                hasher.addString(path)
+                    .addU64(static_cast<uint64_t>(bytes))
+                    .addU64(static_cast<uint64_t>(written))
+                    .addU64(clipAudio.streamFrames)
+                    .addU64(static_cast<uint64_t>(clipAudio.channels));
+            } else {
+                const bool stereo = (clipAudio.channels > 1) && !clipAudio.right.empty();
+                hasher.addU64(stereo ? 2 : 1);
+                hasher.add(clipAudio.left.data(), clipAudio.left.size() * sizeof(float));
+                if (stereo) hasher.add(clipAudio.right.data(), clipAudio.right.size() * sizeof(float));
+            }
+            clipAudio.contentHash = std::max<uint64_t>(1, hasher.value());
+            return clipAudio.contentHash;
+        }
+
+        std::string hashToHex(uint64_t value) {
+            char buffer[17] = {0};
+            std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+            return buffer;
+        }
+
+        uint64_t hexToHash(const std::string& text) {
+            if (text.empty() || text.size() > 16) return 0;
+            char* end = nullptr;
+            const unsigned long long value = std::strtoull(text.c_str(), &end, 16);
+            return (end && *end == '\0') ? static_cast<uint64_t>(value) : 0;
+        }
+
+        // What a track's mirror file was rendered from.
+        uint64_t trackMirrorKey(DawContext& daw, const DawTrack& track, uint32_t sampleRate) {
+            SessionBinary::Hasher hasher;
+            hasher.addU64(sampleRate).addU64(DawClipSystemLogic::TrackEndSample(track));
+            for (const auto& clip : track.clips) {
+                uint64_t audioHash = 0;
+                if (clip.audioId >= 0 && clip.audioId < static_cast<int>(daw.clipAudio.size())) {
+                    audioHash = clipAudioHash(daw, daw.clipAudio[static_cast<size_t>(clip.audioId)]);
+                }
+                hasher.addU64(audioHash).addU64(clip.startSample).addU64(clip.length).addU64(clip.sourceOffset);
+            }
+            return hasher.value();
+        }
+
+        std::filesystem::path trackMirrorPath(const DawContext& daw, size_t trackIndex) {
+            return std::filesystem::path(daw.mirrorPath) / ("track_" + std::to_string(trackIndex + 1) + ".wav");
+        }
+
+        // Mirror files are rewritten only when the clips they render from have
+        // changed since this slot was last written or loaded.
+        bool writeTrackMirrorIfChanged(DawContext& daw, size_t trackIndex) {
+            const uint32_t sampleRate = static_cast<uint32_t>(daw.sampleRate);
+            const std::filesystem::path outPath = trackMirrorPath(daw, trackIndex);
+            const DawTrack& track = daw.tracks[trackIndex];
+            const uint64_t key = trackMirrorKey(daw, track, sampleRate);
+            if (daw.mirrorKeys.size() <= trackIndex) daw.mirrorKeys.resize(trackIndex + 1, 0);
+            std::error_code ec;
+            if (daw.mirrorKeys[trackIndex] == key && std::filesystem::exists(outPath, ec)) return true;
+            const bool ok = writeTrackMirror(daw, track, outPath.string(), sampleRate);
+            daw.mirrorKeys[trackIndex] = ok ? key : 0;
+            return ok;
         }
 
         int64_t displayBarToZeroBased(int displayBar) {
@@ -329,6 +434,8 @@ namespace DawIOSystemLogic {
         constexpr const char* kSessionFormat = "salamander_session";
         constexpr int kSessionVersion = 1;
         constexpr const char* kSessionExtension = ".salmproj";
+        constexpr const char* kSessionJsonExtension = ".json";  // saved as JSON text, for export
+        constexpr const char* kAutosaveSuffix = ".autosave";
         constexpr const char* kThemeFormat = "salamander_theme_presets";
         constexpr int kThemeVersion = 1;
         constexpr const char* kThemeFileName = "daw_themes.json";
@@ -656,7 +763,9 @@ namespace DawIOSystemLogic {
         std::string ensureSessionExtension(const std::string& path) {
             if (path.empty()) return path;
             std::filesystem::path fsPath(path);
-            if (fsPath.extension() == kSessionExtension) return fsPath.string();
+            if (fsPath.extension() == kSessionExtension || fsPath.extension() == kSessionJsonExtension) {
+                return fsPath.string();
+            }
             fsPath += kSessionExtension;
             return fsPath.string();
         }
@@ -995,7 +1104,19 @@ namespace DawIOSystemLogic {
             daw.laneOrder = std::move(restored);
         }
 
-        bool processStemExportBlock(BaseSystem& baseSystem, uint32_t maxFrames) {
+        struct StemExportWorkerState {
+            std::thread worker;
+            std::atomic<bool> finished{false};
+            std::atomic<bool> cancelRequested{false};
+            bool success = false;
+            std::string message;
+        };
+
+        static StemExportWorkerState g_stemExportWorker;
+
+        bool processStemExportBlock(BaseSystem& baseSystem,
+                                    uint32_t maxFrames,
+                                    std::array<std::vector<float>, DawContext::kBusCount>& busBuffers) {
             if (!baseSystem.daw) return false;
             DawContext& daw = *baseSystem.daw;
             if (!daw.exportJobActive) return false;
@@ -1005,7 +1126,6 @@ namespace DawIOSystemLogic {
             uint32_t nframes = static_cast<uint32_t>(std::min<uint64_t>(remaining, maxFrames));
             if (nframes == 0) return false;
 
-            std::array<std::vector<float>, DawContext::kBusCount> busBuffers;
             for (auto& bus : busBuffers) {
                 bus.assign(static_cast<size_t>(nframes), 0.0f);
             }
@@ -1080,9 +1200,19 @@ namespace DawIOSystemLogic {
                     const auto& data = daw.clipAudio[clip.audioId];
                     uint64_t srcOffset = clip.sourceOffset + (overlapStart - clipStart);
                     uint64_t copyCount = overlapEnd - overlapStart;
-                    if (srcOffset >= data.left.size()) continue;
-                    copyCount = std::min<uint64_t>(copyCount, static_cast<uint64_t>(data.left.size()) - srcOffset);
+                    const uint64_t sourceFrames = data.frameCount();
+                    if (srcOffset >= sourceFrames) continue;
+                    copyCount = std::min<uint64_t>(copyCount, sourceFrames - srcOffset);
                     size_t dstBase = static_cast<size_t>(overlapStart - playhead);
+                    if (data.isStreamed()) {
+                        // Offline render reads the mapping directly so export never underruns.
+                        if (dstBase >= clipBufferL.size()) continue;
+                        size_t streamCount = std::min<size_t>(static_cast<size_t>(copyCount), clipBufferL.size() - dstBase);
+                        DawStreamSystemLogic::ReadStreamFrames(daw, data, srcOffset, streamCount,
+                                                               clipBufferL.data() + dstBase,
+                                                               clipBufferR.data() + dstBase);
+                        continue;
+                    }
                     for (uint64_t i = 0; i < copyCount; ++i) {
                         size_t dst = dstBase + static_cast<size_t>(i);
                         if (dst >= clipBufferL.size()) break;
@@ -1320,14 +1450,6 @@ namespace DawIOSystemLogic {
                 }
             }
 
-            for (int busIndex = 0; busIndex < DawContext::kBusCount; ++busIndex) {
-                auto& dst = daw.exportStemBuffers[static_cast<size_t>(busIndex)];
-                const auto& src = busBuffers[static_cast<size_t>(busIndex)];
-                size_t oldSize = dst.size();
-                dst.resize(oldSize + src.size());
-                std::copy(src.begin(), src.end(), dst.begin() + oldSize);
-            }
-
             daw.exportJobCursorSample += static_cast<uint64_t>(nframes);
             const uint64_t total = daw.exportJobEndSample - daw.exportJobStartSample;
             const uint64_t done = daw.exportJobCursorSample - daw.exportJobStartSample;
@@ -1347,6 +1469,10 @@ namespace DawIOSystemLogic {
             DawContext& daw = *baseSystem.daw;
             MidiContext& midi = *baseSystem.midi;
             Vst3Context& vst3 = *baseSystem.vst3;
+            // Same lock order as processStemExportBlock; the main thread keeps
+            // editing MIDI tracks while the worker finishes.
+            std::lock_guard<std::mutex> dawLock(daw.trackMutex);
+            std::lock_guard<std::mutex> midiLock(midi.trackMutex);
             if (daw.exportMidiHeldVelocities.empty()) return;
 
             const int numFrames = std::max(64, vst3.blockSize > 0 ? vst3.blockSize : 512);
@@ -1399,12 +1525,80 @@ namespace DawIOSystemLogic {
             } else {
                 daw.exportProgress.store(0.0f, std::memory_order_relaxed);
             }
-            for (auto& stem : daw.exportStemBuffers) {
-                stem.clear();
-                stem.shrink_to_fit();
-            }
             daw.exportMidiHeldVelocities.clear();
         }
+
+        // Runs on the export worker thread. Renders blocks back to back and
+        // streams each bus straight to its stem file, so memory use stays at
+        // one block per bus regardless of the export length.
+        void runStemExportJob(BaseSystem* baseSystem,
+                              std::array<std::string, DawContext::kBusCount> outPaths,
+                              uint32_t blockFrames) {
+            DawContext& daw = *baseSystem->daw;
+            const uint32_t sampleRate = static_cast<uint32_t>(std::max(1.0f, daw.sampleRate));
+            const uint64_t totalFrames = daw.exportJobEndSample - daw.exportJobStartSample;
+            const bool needsRf64 = (36u + totalFrames * sizeof(float)) > WavStreamWriter::kRiffSizeLimit;
+
+            bool ok = true;
+            std::string message = "Export complete.";
+            std::array<WavStreamWriter, DawContext::kBusCount> writers;
+            for (int i = 0; i < DawContext::kBusCount && ok; ++i) {
+                if (!writers[static_cast<size_t>(i)].open(outPaths[static_cast<size_t>(i)], 1, sampleRate, needsRf64)) {
+                    ok = false;
+                    message = "Export failed while writing files.";
+                }
+            }
+
+            std::array<std::vector<float>, DawContext::kBusCount> busBuffers;
+            while (ok && daw.exportJobCursorSample < daw.exportJobEndSample) {
+                if (g_stemExportWorker.cancelRequested.load(std::memory_order_relaxed)) {
+                    ok = false;
+                    message = "Export cancelled.";
+                    break;
+                }
+                if (!processStemExportBlock(*baseSystem, blockFrames, busBuffers)) {
+                    ok = false;
+                    message = "Export failed during render.";
+                    break;
+                }
+                for (int i = 0; i < DawContext::kBusCount; ++i) {
+                    const auto& bus = busBuffers[static_cast<size_t>(i)];
+                    if (!writers[static_cast<size_t>(i)].writeInterleaved(bus.data(), bus.size())) {
+                        ok = false;
+                        message = "Export failed while writing files.";
+                        break;
+                    }
+                }
+                // The track locks are released between blocks; std::mutex is
+                // not fair, so give autosave and the UI a turn at them.
+                std::this_thread::yield();
+            }
+
+            flushExportMidiNotes(*baseSystem);
+
+            for (auto& writer : writers) {
+                if (!writer.close() && ok) {
+                    ok = false;
+                    message = "Export failed while writing files.";
+                }
+            }
+            if (!ok) {
+                for (const auto& outPath : outPaths) {
+                    std::error_code ec;
+                    std::filesystem::remove(outPath, ec);
+                }
+            }
+
+            g_stemExportWorker.success = ok;
+            g_stemExportWorker.message = message;
+            g_stemExportWorker.finished.store(true, std::memory_order_release);
+        }
+
+        void joinStemExportWorker() {
+            if (g_stemExportWorker.worker.joinable()) {
+                g_stemExportWorker.worker.join();
+            }
+        }
     }
 
     bool ResolveMirrorPath(DawContext& daw) {
@@ -1416,28 +1610,28 @@ namespace DawIOSystemLogic {
 
     void WriteTracksIfNeeded(DawContext& daw) {
         if (!daw.mirrorAvailable) return;
-        for (int i = 0; i < static_cast<int>(daw.tracks.size()); ++i) {
-            const auto& data = daw.tracks[static_cast<size_t>(i)].audio;
-            std::filesystem::path outPath = std::filesystem::path(daw.mirrorPath) / ("track_" + std::to_string(i + 1) + ".wav");
-            writeWavMonoFloat(outPath.string(), data, static_cast<uint32_t>(daw.sampleRate));
+        for (size_t i = 0; i < daw.tracks.size(); ++i) {
+            writeTrackMirrorIfChanged(daw, i);
         }
     }
 
+    bool LoadClipAudioFile(DawContext& daw, const std::string& path, DawClipAudio& outClip, uint32_t& outRate) {
+        return loadClipAudio(daw, path, outClip, outRate);
+    }
+
     void WriteTrackAt(DawContext& daw, int trackIndex) {
         if (!daw.mirrorAvailable) return;
         if (trackIndex < 0 || trackIndex >= static_cast<int>(daw.tracks.size())) return;
-        const auto& data = daw.tracks[static_cast<size_t>(trackIndex)].audio;
-        std::filesystem::path outPath = std::filesystem::path(daw.mirrorPath) / ("track_" + std::to_string(trackIndex + 1) + ".wav");
-        writeWavMonoFloat(outPath.string(), data, static_cast<uint32_t>(daw.sampleRate));
+        writeTrackMirrorIfChanged(daw, static_cast<size_t>(trackIndex));
     }
 
     void LoadTracksIfAvailable(DawContext& daw) {
         if (!daw.mirrorAvailable) return;
         for (int i = 0; i < static_cast<int>(daw.tracks.size()); ++i) {
-            std::filesystem::path inPath = std::filesystem::path(daw.mirrorPath) / ("track_" + std::to_string(i + 1) + ".wav");
+            std::filesystem::path inPath = trackMirrorPath(daw, static_cast<size_t>(i));
             uint32_t rate = 0;
             DawClipAudio clipData;
-            if (loadWavClipAudio(inPath.string(), clipData, rate)) {
+            if (loadClipAudio(daw, inPath.string(), clipData, rate)) {
                 DawTrack& track = daw.tracks[static_cast<size_t>(i)];
                 track.clips.clear();
                 track.loopTakeClips.clear();
@@ -1453,13 +1647,16 @@ namespace DawIOSystemLogic {
                 clip.startSample = 0;
                 clip.sourceOffset = 0;
                 clip.length = (audioId >= 0 && audioId < static_cast<int>(daw.clipAudio.size()))
-                    ? static_cast<uint64_t>(daw.clipAudio[audioId].left.size())
+                    ? daw.clipAudio[audioId].frameCount()
                     : 0;
                 clip.takeId = -1;
                 if (clip.length > 0) {
                     track.clips.push_back(clip);
                 }
-                DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+                DawClipSystemLogic::RefreshTrackFromClips(daw, track);
+                // The file on disk is what these clips render to.
+                if (daw.mirrorKeys.size() <= static_cast<size_t>(i)) daw.mirrorKeys.resize(static_cast<size_t>(i) + 1, 0);
+                daw.mirrorKeys[static_cast<size_t>(i)] = trackMirrorKey(daw, track, static_cast<uint32_t>(daw.sampleRate));
             } else {
                 daw.tracks[static_cast<size_t>(i)].clips.clear();
                 daw.tracks[static_cast<size_t>(i)].loopTakeClips.clear();
@@ -1468,8 +1665,6 @@ namespace DawIOSystemLogic {
                 daw.tracks[static_cast<size_t>(i)].nextTakeId = 1;
                 daw.tracks[static_cast<size_t>(i)].loopTakeRangeStartSample = 0;
                 daw.tracks[static_cast<size_t>(i)].loopTakeRangeLength = 0;
-                daw.tracks[static_cast<size_t>(i)].audio.clear();
-                daw.tracks[static_cast<size_t>(i)].audioRight.clear();
                 daw.tracks[static_cast<size_t>(i)].waveformMin.clear();
                 daw.tracks[static_cast<size_t>(i)].waveformMax.clear();
                 daw.tracks[static_cast<size_t>(i)].waveformMinRight.clear();
@@ -1599,7 +1794,7 @@ namespace DawIOSystemLogic {
 #elif defined(__linux__)
         const char* cmd =
             "zenity --file-selection --title='Load Salamander Session' "
-            "--file-filter='Salamander Session | *.salmproj' 2>/dev/null";
+            "--file-filter='Salamander Session | *.salmproj *.json' 2>/dev/null";
         std::string selected = commandOutputFirstLine(cmd);
         if (selected.empty()) return false;
         ioPath = selected;
@@ -1610,228 +1805,543 @@ namespace DawIOSystemLogic {
 #endif
     }
 
-    bool SaveSession(BaseSystem& baseSystem, const std::string& rawPath) {
-        if (!baseSystem.daw || !baseSystem.midi) return false;
-        DawContext& daw = *baseSystem.daw;
-        MidiContext& midi = *baseSystem.midi;
+    namespace {
+        // One track as a save writes it: every field but the clips, already
+        // in session JSON, plus raw copies of the clip lists.
+        template <class Clip>
+        struct TrackSnapshot {
+            json settings = json::object();
+            std::vector<Clip> clips;
+            std::vector<Clip> loopTakeClips;
+        };
 
-        std::filesystem::path sessionPath = ensureSessionExtension(rawPath);
-        if (!sessionPath.is_absolute()) {
-            sessionPath = std::filesystem::absolute(sessionPath);
+        // A pool entry's asset file. Only pending assets are written; the
+        // rest already exist under their content-addressed names.
+        struct AssetSnapshot {
+            std::string file;                          // relative to the asset dir
+            bool pending = false;
+            std::string copyFrom;                      // streamed clips copy the file they map
+            const DawClipAudio* borrowed = nullptr;    // synchronous saves read the pool in place
+            DawClipAudio owned;                        // autosaves write from a copy
+        };
+
+        // Everything a save writes, captured under the track locks so the
+        // writer needs neither the locks nor the contexts.
+        struct SessionSnapshot {
+            std::filesystem::path sessionPath;
+            std::filesystem::path assetDir;
+            bool asJson = false;
+            bool collectAssets = false;  // drop asset files the pool no longer names
+            uint32_t sampleRate = 44100;
+            json head = json::object();
+            json audioPool = json::array();
+            std::vector<AssetSnapshot> assets;  // parallel to audioPool
+            std::vector<TrackSnapshot<DawClip>> audioTracks;
+            std::vector<TrackSnapshot<MidiClip>> midiTracks;
+            std::vector<TrackSnapshot<AutomationClip>> automationTracks;
+        };
+
+        // Encoded track chunk per slot, reused while the track hashes the same.
+        struct CachedTrackChunk {
+            bool valid = false;
+            uint64_t key = 0;
+            SessionBinary::Chunk chunk;
+        };
+
+        static std::vector<CachedTrackChunk> g_trackChunkCache[3];
+
+        struct AutosaveWorkerState {
+            std::thread worker;
+            std::atomic<bool> finished{false};
+            bool success = false;
+            std::string message;
+            uint64_t lastHash = 0;  // file hash of the last autosave written
+            double elapsed = 0.0;
+        };
+
+        static AutosaveWorkerState g_autosave;
+
+        std::filesystem::path autosavePathFor(const std::filesystem::path& sessionPath) {
+            std::string stem = sessionPath.stem().string();
+            if (stem.empty()) stem = "Untitled";
+            return sessionPath.parent_path() / (stem + kAutosaveSuffix + kSessionExtension);
         }
-        if (sessionPath.empty()) return false;
-        std::filesystem::path sessionDir = sessionPath.parent_path();
-        if (sessionDir.empty()) {
-            sessionDir = std::filesystem::current_path();
-            sessionPath = sessionDir / sessionPath.filename();
+
+        // Loading an autosave resumes the session it was saved beside.
+        std::filesystem::path sessionPathForAutosave(const std::filesystem::path& path) {
+            const std::string stem = path.stem().string();
+            const std::string suffix = kAutosaveSuffix;
+            if (stem.size() <= suffix.size() || stem.compare(stem.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                return path;
+            }
+            return path.parent_path() / (stem.substr(0, stem.size() - suffix.size()) + kSessionExtension);
         }
 
-        std::error_code ec;
-        std::filesystem::create_directories(sessionDir, ec);
-        if (ec) {
-            std::cerr << "Session save failed: could not create directory " << sessionDir << std::endl;
-            return false;
+        std::string assetFileFor(uint64_t contentHash) {
+            return "audio/clip_" + hashToHex(contentHash) + ".wav";
         }
 
-        std::filesystem::path assetDir = sessionDir / defaultAssetDirName(sessionPath);
-        std::filesystem::path audioDir = assetDir / "audio";
-        std::filesystem::remove_all(audioDir, ec);
-        ec.clear();
-        std::filesystem::create_directories(audioDir, ec);
-        if (ec) {
-            std::cerr << "Session save failed: could not create asset audio directory " << audioDir << std::endl;
-            return false;
+        bool copyAssetFile(const std::string& from, const std::string& path) {
+            const std::string tempPath = tempPathFor(path);
+            std::error_code ec;
+            std::filesystem::copy_file(from, tempPath, std::filesystem::copy_options::overwrite_existing, ec);
+            return commitTempFile(tempPath, path, !ec);
         }
 
-        json root = json::object();
-        root["format"] = kSessionFormat;
-        root["version"] = kSessionVersion;
-        root["asset_dir"] = assetDir.filename().string();
-        root["sample_rate"] = daw.sampleRate;
-        root["timeline"] = {
-            {"seconds_per_screen", daw.timelineSecondsPerScreen},
-            {"offset_samples", daw.timelineOffsetSamples},
-            {"zero_sample", daw.timelineZeroSample},
-            {"lane_height", daw.timelineLaneHeight},
-            {"lane_offset", daw.timelineLaneOffset},
-            {"playhead_sample", daw.playheadSample.load(std::memory_order_relaxed)}
-        };
-        root["transport"] = {
-            {"bpm", daw.bpm.load(std::memory_order_relaxed)},
-            {"metronome_enabled", daw.metronomeEnabled.load(std::memory_order_relaxed)},
-            {"loop_enabled", daw.loopEnabled.load(std::memory_order_relaxed)},
-            {"loop_start_samples", daw.loopStartSamples},
-            {"loop_end_samples", daw.loopEndSamples}
-        };
-        root["export"] = {
-            {"start_bar", daw.exportStartBar},
-            {"end_bar", daw.exportEndBar},
-            {"folder_path", daw.exportFolderPath},
-            {"stem_names", json::array({
-                daw.exportStemNames[0],
-                daw.exportStemNames[1],
-                daw.exportStemNames[2],
-                daw.exportStemNames[3]
-            })}
-        };
+        void hashClip(SessionBinary::Hasher& hasher, const DawClip& clip) {
+            hasher.addU64(static_cast<uint64_t>(static_cast<int64_t>(clip.audioId)))
+                .addU64(clip.startSample)
+                .addU64(clip.length)
+                .addU64(clip.sourceOffset)
+                .addU64(static_cast<uint64_t>(static_cast<int64_t>(clip.takeId)));
+        }
 
-        json audioPool = json::array();
-        json audioTracks = json::array();
-        json midiTracks = json::array();
-        json automationTracks = json::array();
-
-        std::lock_guard<std::mutex> dawLock(daw.trackMutex);
-        std::lock_guard<std::mutex> midiLock(midi.trackMutex);
-
-        const uint32_t sampleRate = static_cast<uint32_t>(std::max(1.0f, daw.sampleRate));
-        for (size_t i = 0; i < daw.clipAudio.size(); ++i) {
-            std::string fileName = "clip_" + std::to_string(i + 1) + ".wav";
-            std::filesystem::path outPath = audioDir / fileName;
-            bool ok = writeWavClipAudio(outPath.string(), daw.clipAudio[i], sampleRate);
-            json entry = json::object();
-            entry["id"] = static_cast<int>(i);
-            entry["file"] = std::string("audio/") + fileName;
-            entry["valid"] = ok;
-            const bool stereo = (daw.clipAudio[i].channels > 1) && !daw.clipAudio[i].right.empty();
-            entry["channels"] = stereo ? 2 : 1;
-            entry["frames"] = stereo
-                ? static_cast<uint64_t>(std::min(daw.clipAudio[i].left.size(), daw.clipAudio[i].right.size()))
-                : static_cast<uint64_t>(daw.clipAudio[i].left.size());
-            audioPool.push_back(std::move(entry));
+        void hashClip(SessionBinary::Hasher& hasher, const MidiClip& clip) {
+            hasher.addU64(clip.startSample)
+                .addU64(clip.length)
+                .addU64(static_cast<uint64_t>(static_cast<int64_t>(clip.takeId)))
+                .addU64(clip.notes.size());
+            for (const auto& note : clip.notes) {
+                uint32_t velocityBits = 0;
+                std::memcpy(&velocityBits, &note.velocity, sizeof(velocityBits));
+                hasher.addU64(static_cast<uint64_t>(static_cast<uint32_t>(note.pitch)) | (static_cast<uint64_t>(velocityBits) << 32))
+                    .addU64(note.startSample)
+                    .addU64(note.length);
+            }
         }
 
-        for (size_t i = 0; i < daw.tracks.size(); ++i) {
-            const DawTrack& track = daw.tracks[i];
-            json trackJson = json::object();
-            trackJson["arm_mode"] = track.armMode.load(std::memory_order_relaxed);
-            trackJson["mute"] = track.mute.load(std::memory_order_relaxed);
-            trackJson["solo"] = track.solo.load(std::memory_order_relaxed);
-            trackJson["output_bus"] = track.outputBus.load(std::memory_order_relaxed);
-            trackJson["output_bus_l"] = track.outputBusL.load(std::memory_order_relaxed);
-            trackJson["output_bus_r"] = track.outputBusR.load(std::memory_order_relaxed);
-            trackJson["gain"] = track.gain.load(std::memory_order_relaxed);
-            trackJson["physical_input_index"] = track.physicalInputIndex;
-            trackJson["stereo_input_pair12"] = track.stereoInputPair12;
-            trackJson["next_take_id"] = track.nextTakeId;
-            trackJson["active_loop_take_index"] = track.activeLoopTakeIndex;
-            trackJson["take_stack_expanded"] = track.takeStackExpanded;
-            trackJson["loop_take_range_start_sample"] = track.loopTakeRangeStartSample;
-            trackJson["loop_take_range_length"] = track.loopTakeRangeLength;
-            trackJson["clips"] = json::array();
-            trackJson["loop_take_clips"] = json::array();
-            for (const auto& clip : track.clips) {
-                trackJson["clips"].push_back(serializeDawClip(clip));
-            }
-            for (const auto& clip : track.loopTakeClips) {
-                trackJson["loop_take_clips"].push_back(serializeDawClip(clip));
-            }
-            audioTracks.push_back(std::move(trackJson));
-        }
-
-        for (size_t i = 0; i < midi.tracks.size(); ++i) {
-            const MidiTrack& track = midi.tracks[i];
-            json trackJson = json::object();
-            trackJson["arm_mode"] = track.armMode.load(std::memory_order_relaxed);
-            trackJson["mute"] = track.mute.load(std::memory_order_relaxed);
-            trackJson["solo"] = track.solo.load(std::memory_order_relaxed);
-            trackJson["output_bus"] = track.outputBus.load(std::memory_order_relaxed);
-            trackJson["output_bus_l"] = track.outputBusL.load(std::memory_order_relaxed);
-            trackJson["output_bus_r"] = track.outputBusR.load(std::memory_order_relaxed);
-            trackJson["gain"] = track.gain.load(std::memory_order_relaxed);
-            trackJson["next_take_id"] = track.nextTakeId;
-            trackJson["active_loop_take_index"] = track.activeLoopTakeIndex;
-            trackJson["take_stack_expanded"] = track.takeStackExpanded;
-            trackJson["loop_take_range_start_sample"] = track.loopTakeRangeStartSample;
-            trackJson["loop_take_range_length"] = track.loopTakeRangeLength;
-            trackJson["clips"] = json::array();
-            trackJson["loop_take_clips"] = json::array();
+        void hashClip(SessionBinary::Hasher& hasher, const AutomationClip& clip) {
+            hasher.addU64(clip.startSample)
+                .addU64(clip.length)
+                .addU64(static_cast<uint64_t>(static_cast<int64_t>(clip.takeId)))
+                .addU64(clip.points.size());
+            for (const auto& point : clip.points) {
+                uint32_t valueBits = 0;
+                std::memcpy(&valueBits, &point.value, sizeof(valueBits));
+                hasher.addU64(point.offsetSample).addU64(valueBits);
+            }
+        }
+
+        // Hashes the fields a track chunk is serialized from, so an unchanged
+        // track reuses its chunk without being serialized again.
+        template <class Clip>
+        uint64_t trackSnapshotKey(const TrackSnapshot<Clip>& track) {
+            SessionBinary::Hasher hasher;
+            hasher.addString(track.settings.dump());
+            hasher.addU64(track.clips.size());
+            for (const auto& clip : track.clips) hashClip(hasher, clip);
+            hasher.addU64(track.loopTakeClips.size());
+            for (const auto& clip : track.loopTakeClips) hashClip(hasher, clip);
+            return hasher.value();
+        }
+
+        template <class Clip, class SerializeClip>
+        json trackSnapshotJson(const TrackSnapshot<Clip>& track, SerializeClip serializeClip, bool withLoopTakes) {
+            json out = track.settings;
+            out["clips"] = json::array();
             for (const auto& clip : track.clips) {
-                trackJson["clips"].push_back(serializeMidiClip(clip));
+                out["clips"].push_back(serializeClip(clip));
             }
-            for (const auto& clip : track.loopTakeClips) {
-                trackJson["loop_take_clips"].push_back(serializeMidiClip(clip));
+            if (withLoopTakes) {
+                out["loop_take_clips"] = json::array();
+                for (const auto& clip : track.loopTakeClips) {
+                    out["loop_take_clips"].push_back(serializeClip(clip));
+                }
             }
-            midiTracks.push_back(std::move(trackJson));
+            return out;
         }
 
-        for (const auto& track : daw.automationTracks) {
-            json trackJson = json::object();
-            trackJson["target_lane_type"] = track.targetLaneType;
-            trackJson["target_lane_track"] = track.targetLaneTrack;
-            trackJson["target_device_slot"] = track.targetDeviceSlot;
-            trackJson["target_parameter_slot"] = track.targetParameterSlot;
-            trackJson["target_parameter_id"] = track.targetParameterId;
-            trackJson["target_lane_label"] = track.targetLaneLabel;
-            trackJson["target_device_label"] = track.targetDeviceLabel;
-            trackJson["target_parameter_label"] = track.targetParameterLabel;
-            trackJson["clips"] = json::array();
-            for (const auto& clip : track.clips) {
-                trackJson["clips"].push_back(serializeAutomationClip(clip));
+        template <class Clip, class SerializeClip>
+        void appendTrackChunks(std::vector<SessionBinary::Chunk>& chunks,
+                               uint32_t chunkId,
+                               std::vector<CachedTrackChunk>& cache,
+                               const std::vector<TrackSnapshot<Clip>>& tracks,
+                               SerializeClip serializeClip,
+                               bool withLoopTakes) {
+            cache.resize(tracks.size());
+            for (size_t i = 0; i < tracks.size(); ++i) {
+                const uint64_t key = trackSnapshotKey(tracks[i]);
+                CachedTrackChunk& cached = cache[i];
+                if (!cached.valid || cached.key != key) {
+                    cached.chunk = SessionBinary::makeChunk(chunkId, trackSnapshotJson(tracks[i], serializeClip, withLoopTakes));
+                    cached.key = key;
+                    cached.valid = true;
+                }
+                chunks.push_back(cached.chunk);
             }
-            automationTracks.push_back(std::move(trackJson));
         }
 
-        if (baseSystem.vst3) {
-            Vst3Context& vst3 = *baseSystem.vst3;
-            for (size_t i = 0; i < audioTracks.size(); ++i) {
-                json fx = json::array();
-                if (i < vst3.audioTracks.size()) {
-                    for (const auto* plugin : vst3.audioTracks[i].effects) {
-                        fx.push_back(serializePlugin(plugin));
+        // Main thread only; the track locks are held just while track and
+        // clip state is copied. copyAudio makes the snapshot own the samples
+        // of assets still to be written (autosave hands it to a worker);
+        // otherwise they are borrowed from the pool, which only the main
+        // thread grows.
+        SessionSnapshot captureSession(BaseSystem& baseSystem,
+                                       const std::filesystem::path& sessionPath,
+                                       const std::filesystem::path& assetDir,
+                                       bool copyAudio) {
+            DawContext& daw = *baseSystem.daw;
+            MidiContext& midi = *baseSystem.midi;
+            SessionSnapshot snapshot;
+            snapshot.sessionPath = sessionPath;
+            snapshot.assetDir = assetDir;
+            snapshot.sampleRate = static_cast<uint32_t>(std::max(1.0f, daw.sampleRate));
+
+            // Pool entries never change once added and only this thread adds
+            // them, so hashing and copying samples happens before the track
+            // locks; the audio callback blocks on daw.trackMutex.
+            const std::filesystem::path audioDir = assetDir / "audio";
+            snapshot.assets.resize(daw.clipAudio.size());
+            for (size_t i = 0; i < daw.clipAudio.size(); ++i) {
+                DawClipAudio& clipData = daw.clipAudio[i];
+                AssetSnapshot& asset = snapshot.assets[i];
+                const uint64_t contentHash = clipAudioHash(daw, clipData);
+                std::error_code ec;
+                const std::string source = clipData.isStreamed()
+                    ? DawStreamSystemLogic::StreamSourcePath(daw, clipData)
+                    : std::string();
+                if (!source.empty() && std::filesystem::equivalent(std::filesystem::path(source).parent_path(), audioDir, ec)) {
+                    // Streamed from this session's own assets: keep its name.
+                    asset.file = "audio/" + std::filesystem::path(source).filename().string();
+                } else {
+                    asset.file = assetFileFor(contentHash);
+                    asset.pending = !std::filesystem::exists(assetDir / asset.file, ec);
+                }
+                if (asset.pending) {
+                    if (clipData.isStreamed()) {
+                        asset.copyFrom = source;
+                    } else if (copyAudio) {
+                        asset.owned.channels = clipData.channels;
+                        asset.owned.left = clipData.left;
+                        asset.owned.right = clipData.right;
+                    } else {
+                        asset.borrowed = &clipData;
                     }
                 }
-                audioTracks[i]["fx_chain"] = std::move(fx);
+                json entry = json::object();
+                entry["id"] = static_cast<int>(i);
+                entry["file"] = asset.file;
+                entry["valid"] = false;
+                entry["content_hash"] = hashToHex(contentHash);
+                const bool stereo = (clipData.channels > 1) && (clipData.isStreamed() || !clipData.right.empty());
+                entry["channels"] = stereo ? 2 : 1;
+                entry["frames"] = clipData.isStreamed()
+                    ? clipData.frameCount()
+                    : stereo
+                    ? static_cast<uint64_t>(std::min(clipData.left.size(), clipData.right.size()))
+                    : static_cast<uint64_t>(clipData.left.size());
+                snapshot.audioPool.push_back(std::move(entry));
             }
-            for (size_t i = 0; i < midiTracks.size(); ++i) {
-                json fx = json::array();
-                if (i < vst3.midiTracks.size()) {
-                    for (const auto* plugin : vst3.midiTracks[i].effects) {
-                        fx.push_back(serializePlugin(plugin));
+
+            std::lock_guard<std::mutex> dawLock(daw.trackMutex);
+            std::lock_guard<std::mutex> midiLock(midi.trackMutex);
+
+            json& head = snapshot.head;
+            head["format"] = kSessionFormat;
+            head["version"] = kSessionVersion;
+            head["asset_dir"] = assetDir.filename().string();
+            head["sample_rate"] = daw.sampleRate;
+            head["timeline"] = {
+                {"seconds_per_screen", daw.timelineSecondsPerScreen},
+                {"offset_samples", daw.timelineOffsetSamples},
+                {"zero_sample", daw.timelineZeroSample},
+                {"lane_height", daw.timelineLaneHeight},
+                {"lane_offset", daw.timelineLaneOffset},
+                {"playhead_sample", daw.playheadSample.load(std::memory_order_relaxed)}
+            };
+            head["transport"] = {
+                {"bpm", daw.bpm.load(std::memory_order_relaxed)},
+                {"metronome_enabled", daw.metronomeEnabled.load(std::memory_order_relaxed)},
+                {"loop_enabled", daw.loopEnabled.load(std::memory_order_relaxed)},
+                {"loop_start_samples", daw.loopStartSamples},
+                {"loop_end_samples", daw.loopEndSamples}
+            };
+            head["export"] = {
+                {"start_bar", daw.exportStartBar},
+                {"end_bar", daw.exportEndBar},
+                {"folder_path", daw.exportFolderPath},
+                {"stem_names", json::array({
+                    daw.exportStemNames[0],
+                    daw.exportStemNames[1],
+                    daw.exportStemNames[2],
+                    daw.exportStemNames[3]
+                })}
+            };
+            head["lane_order"] = json::array();
+            for (const auto& lane : daw.laneOrder) {
+                head["lane_order"].push_back({
+                    {"type", lane.type},
+                    {"track_index", lane.trackIndex}
+                });
+            }
+
+            snapshot.audioTracks.resize(daw.tracks.size());
+            for (size_t i = 0; i < daw.tracks.size(); ++i) {
+                const DawTrack& track = daw.tracks[i];
+                TrackSnapshot<DawClip>& out = snapshot.audioTracks[i];
+                json& trackJson = out.settings;
+                trackJson["arm_mode"] = track.armMode.load(std::memory_order_relaxed);
+                trackJson["mute"] = track.mute.load(std::memory_order_relaxed);
+                trackJson["solo"] = track.solo.load(std::memory_order_relaxed);
+                trackJson["output_bus"] = track.outputBus.load(std::memory_order_relaxed);
+                trackJson["output_bus_l"] = track.outputBusL.load(std::memory_order_relaxed);
+                trackJson["output_bus_r"] = track.outputBusR.load(std::memory_order_relaxed);
+                trackJson["gain"] = track.gain.load(std::memory_order_relaxed);
+                trackJson["physical_input_index"] = track.physicalInputIndex;
+                trackJson["stereo_input_pair12"] = track.stereoInputPair12;
+                trackJson["next_take_id"] = track.nextTakeId;
+                trackJson["active_loop_take_index"] = track.activeLoopTakeIndex;
+                trackJson["take_stack_expanded"] = track.takeStackExpanded;
+                trackJson["loop_take_range_start_sample"] = track.loopTakeRangeStartSample;
+                trackJson["loop_take_range_length"] = track.loopTakeRangeLength;
+                out.clips = track.clips;
+                out.loopTakeClips = track.loopTakeClips;
+            }
+
+            snapshot.midiTracks.resize(midi.tracks.size());
+            for (size_t i = 0; i < midi.tracks.size(); ++i) {
+                const MidiTrack& track = midi.tracks[i];
+                TrackSnapshot<MidiClip>& out = snapshot.midiTracks[i];
+                json& trackJson = out.settings;
+                trackJson["arm_mode"] = track.armMode.load(std::memory_order_relaxed);
+                trackJson["mute"] = track.mute.load(std::memory_order_relaxed);
+                trackJson["solo"] = track.solo.load(std::memory_order_relaxed);
+                trackJson["output_bus"] = track.outputBus.load(std::memory_order_relaxed);
+                trackJson["output_bus_l"] = track.outputBusL.load(std::memory_order_relaxed);
+                trackJson["output_bus_r"] = track.outputBusR.load(std::memory_order_relaxed);
+                trackJson["gain"] = track.gain.load(std::memory_order_relaxed);
+                trackJson["next_take_id"] = track.nextTakeId;
+                trackJson["active_loop_take_index"] = track.activeLoopTakeIndex;
+                trackJson["take_stack_expanded"] = track.takeStackExpanded;
+                trackJson["loop_take_range_start_sample"] = track.loopTakeRangeStartSample;
+                trackJson["loop_take_range_length"] = track.loopTakeRangeLength;
+                out.clips = track.clips;
+                out.loopTakeClips = track.loopTakeClips;
+            }
+
+            snapshot.automationTracks.resize(daw.automationTracks.size());
+            for (size_t i = 0; i < daw.automationTracks.size(); ++i) {
+                const AutomationTrack& track = daw.automationTracks[i];
+                TrackSnapshot<AutomationClip>& out = snapshot.automationTracks[i];
+                json& trackJson = out.settings;
+                trackJson["target_lane_type"] = track.targetLaneType;
+                trackJson["target_lane_track"] = track.targetLaneTrack;
+                trackJson["target_device_slot"] = track.targetDeviceSlot;
+                trackJson["target_parameter_slot"] = track.targetParameterSlot;
+                trackJson["target_parameter_id"] = track.targetParameterId;
+                trackJson["target_lane_label"] = track.targetLaneLabel;
+                trackJson["target_device_label"] = track.targetDeviceLabel;
+                trackJson["target_parameter_label"] = track.targetParameterLabel;
+                out.clips = track.clips;
+            }
+
+            if (baseSystem.vst3) {
+                Vst3Context& vst3 = *baseSystem.vst3;
+                for (size_t i = 0; i < snapshot.audioTracks.size(); ++i) {
+                    json fx = json::array();
+                    if (i < vst3.audioTracks.size()) {
+                        for (const auto* plugin : vst3.audioTracks[i].effects) {
+                            fx.push_back(serializePlugin(plugin));
+                        }
                     }
+                    snapshot.audioTracks[i].settings["fx_chain"] = std::move(fx);
                 }
-                if (i < vst3.midiInstruments.size() && vst3.midiInstruments[i]) {
-                    midiTracks[i]["instrument"] = serializePlugin(vst3.midiInstruments[i]);
-                } else {
-                    midiTracks[i]["instrument"] = nullptr;
+                for (size_t i = 0; i < snapshot.midiTracks.size(); ++i) {
+                    json fx = json::array();
+                    if (i < vst3.midiTracks.size()) {
+                        for (const auto* plugin : vst3.midiTracks[i].effects) {
+                            fx.push_back(serializePlugin(plugin));
+                        }
+                    }
+                    json& trackJson = snapshot.midiTracks[i].settings;
+                    if (i < vst3.midiInstruments.size() && vst3.midiInstruments[i]) {
+                        trackJson["instrument"] = serializePlugin(vst3.midiInstruments[i]);
+                    } else {
+                        trackJson["instrument"] = nullptr;
+                    }
+                    trackJson["fx_chain"] = std::move(fx);
                 }
-                midiTracks[i]["fx_chain"] = std::move(fx);
             }
+            return snapshot;
         }
 
-        root["audio_pool"] = std::move(audioPool);
-        root["audio_tracks"] = std::move(audioTracks);
-        root["midi_tracks"] = std::move(midiTracks);
-        root["automation_tracks"] = std::move(automationTracks);
-        root["lane_order"] = json::array();
-        for (const auto& lane : daw.laneOrder) {
-            root["lane_order"].push_back({
-                {"type", lane.type},
-                {"track_index", lane.trackIndex}
-            });
+        // Drops asset files no pool entry names, and temp files left behind by
+        // an interrupted write.
+        void collectUnusedAssets(const SessionSnapshot& snapshot) {
+            std::unordered_set<std::string> used;
+            for (const auto& asset : snapshot.assets) {
+                used.insert(std::filesystem::path(asset.file).filename().string());
+            }
+            std::error_code ec;
+            std::vector<std::filesystem::path> unused;
+            for (const auto& entry : std::filesystem::directory_iterator(snapshot.assetDir / "audio", ec)) {
+                const std::filesystem::path& path = entry.path();
+                const std::string ext = path.extension().string();
+                if (ext != ".wav" && ext != ".tmp") continue;
+                if (used.count(path.filename().string())) continue;
+                unused.push_back(path);
+            }
+            for (const auto& path : unused) {
+                std::filesystem::remove(path, ec);
+            }
         }
 
-        std::filesystem::path tmpPath = sessionPath;
-        tmpPath += ".tmp";
-        {
-            std::ofstream out(tmpPath);
-            if (!out.is_open()) {
-                std::cerr << "Session save failed: could not open " << tmpPath << std::endl;
+        // Writes pending assets, then the session file. Safe off the main
+        // thread. With lastWrittenHash, a binary file identical to the one
+        // last written is not written again.
+        bool writeSessionSnapshot(SessionSnapshot& snapshot, uint64_t* lastWrittenHash, std::string& error) {
+            std::error_code ec;
+            const std::filesystem::path audioDir = snapshot.assetDir / "audio";
+            std::filesystem::create_directories(audioDir, ec);
+            if (ec) {
+                error = "could not create asset audio directory " + audioDir.string();
                 return false;
             }
-            out << root.dump(2);
+
+            for (size_t i = 0; i < snapshot.assets.size(); ++i) {
+                AssetSnapshot& asset = snapshot.assets[i];
+                const std::filesystem::path outPath = snapshot.assetDir / asset.file;
+                bool ok = false;
+                if (!asset.pending) {
+                    ok = std::filesystem::exists(outPath, ec);
+                } else if (!asset.copyFrom.empty()) {
+                    ok = copyAssetFile(asset.copyFrom, outPath.string());
+                } else {
+                    ok = writeWavClipAudio(outPath.string(), asset.borrowed ? *asset.borrowed : asset.owned, snapshot.sampleRate);
+                }
+                snapshot.audioPool[i]["valid"] = ok;
+            }
+
+            if (snapshot.asJson) {
+                json root = snapshot.head;
+                root["audio_pool"] = snapshot.audioPool;
+                root["audio_tracks"] = json::array();
+                root["midi_tracks"] = json::array();
+                root["automation_tracks"] = json::array();
+                for (const auto& track : snapshot.audioTracks) {
+                    root["audio_tracks"].push_back(trackSnapshotJson(track, serializeDawClip, true));
+                }
+                for (const auto& track : snapshot.midiTracks) {
+                    root["midi_tracks"].push_back(trackSnapshotJson(track, serializeMidiClip, true));
+                }
+                for (const auto& track : snapshot.automationTracks) {
+                    root["automation_tracks"].push_back(trackSnapshotJson(track, serializeAutomationClip, false));
+                }
+                const std::string text = root.dump(2);
+                if (!SessionBinary::saveFileAtomic(snapshot.sessionPath, std::vector<uint8_t>(text.begin(), text.end()), error)) {
+                    return false;
+                }
+            } else {
+                std::vector<SessionBinary::Chunk> chunks;
+                chunks.reserve(2 + snapshot.audioTracks.size() + snapshot.midiTracks.size() + snapshot.automationTracks.size());
+                chunks.push_back(SessionBinary::makeChunk(SessionBinary::kHead, snapshot.head));
+                chunks.push_back(SessionBinary::makeChunk(SessionBinary::kPool, snapshot.audioPool));
+                appendTrackChunks(chunks, SessionBinary::kAudioTrack, g_trackChunkCache[0],
+                                  snapshot.audioTracks, serializeDawClip, true);
+                appendTrackChunks(chunks, SessionBinary::kMidiTrack, g_trackChunkCache[1],
+                                  snapshot.midiTracks, serializeMidiClip, true);
+                appendTrackChunks(chunks, SessionBinary::kAutomationTrack, g_trackChunkCache[2],
+                                  snapshot.automationTracks, serializeAutomationClip, false);
+                const uint64_t fileHash = SessionBinary::combinedHash(chunks);
+                if (lastWrittenHash && *lastWrittenHash == fileHash && std::filesystem::exists(snapshot.sessionPath, ec)) {
+                    return true;
+                }
+                if (!SessionBinary::saveFileAtomic(snapshot.sessionPath, SessionBinary::encode(chunks), error)) {
+                    return false;
+                }
+                if (lastWrittenHash) *lastWrittenHash = fileHash;
+            }
+
+            if (snapshot.collectAssets) {
+                collectUnusedAssets(snapshot);
+            }
+            return true;
         }
-        std::filesystem::rename(tmpPath, sessionPath, ec);
-        if (ec) {
-            std::filesystem::remove(sessionPath, ec);
-            ec.clear();
-            std::filesystem::rename(tmpPath, sessionPath, ec);
-            if (ec) {
-                std::filesystem::remove(tmpPath, ec);
-                std::cerr << "Session save failed: could not replace " << sessionPath << std::endl;
-                return false;
+
+        void joinAutosaveWorker() {
+            if (g_autosave.worker.joinable()) {
+                g_autosave.worker.join();
             }
         }
 
+        // Every daw.autosaveIntervalSeconds, snapshots a saved session and
+        // writes it beside the session file on a worker thread. Assets go to
+        // the session's own asset dir, where a later save finds them already
+        // written.
+        void tickAutosave(BaseSystem& baseSystem, float dt) {
+            if (!baseSystem.daw || !baseSystem.midi) return;
+            DawContext& daw = *baseSystem.daw;
+            if (g_autosave.worker.joinable()) {
+                if (!g_autosave.finished.load(std::memory_order_acquire)) return;
+                g_autosave.worker.join();
+                if (!g_autosave.success) {
+                    std::cerr << "Autosave failed: " << g_autosave.message << std::endl;
+                }
+            }
+            if (daw.sessionPath.empty() || daw.autosaveIntervalSeconds <= 0.0) return;
+            g_autosave.elapsed += static_cast<double>(dt);
+            if (g_autosave.elapsed < daw.autosaveIntervalSeconds) return;
+            if (daw.transportRecording.load(std::memory_order_relaxed) || daw.recordStopPending) return;
+            g_autosave.elapsed = 0.0;
+
+            const std::filesystem::path sessionPath(daw.sessionPath);
+            auto snapshot = std::make_shared<SessionSnapshot>(captureSession(
+                baseSystem,
+                autosavePathFor(sessionPath),
+                sessionPath.parent_path() / defaultAssetDirName(sessionPath),
+                true));
+            g_autosave.finished.store(false, std::memory_order_release);
+            g_autosave.worker = std::thread([snapshot]() {
+                std::string message;
+                const bool ok = writeSessionSnapshot(*snapshot, &g_autosave.lastHash, message);
+                g_autosave.success = ok;
+                g_autosave.message = message;
+                g_autosave.finished.store(true, std::memory_order_release);
+            });
+        }
+    }
+
+    void ShutdownAutosave() {
+        joinAutosaveWorker();
+    }
+
+    bool SaveSession(BaseSystem& baseSystem, const std::string& rawPath) {
+        if (!baseSystem.daw || !baseSystem.midi) return false;
+        DawContext& daw = *baseSystem.daw;
+        joinAutosaveWorker();
+
+        std::filesystem::path sessionPath = ensureSessionExtension(rawPath);
+        if (!sessionPath.is_absolute()) {
+            sessionPath = std::filesystem::absolute(sessionPath);
+        }
+        if (sessionPath.empty()) return false;
+        std::filesystem::path sessionDir = sessionPath.parent_path();
+        if (sessionDir.empty()) {
+            sessionDir = std::filesystem::current_path();
+            sessionPath = sessionDir / sessionPath.filename();
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(sessionDir, ec);
+        if (ec) {
+            std::cerr << "Session save failed: could not create directory " << sessionDir << std::endl;
+            return false;
+        }
+
+        std::filesystem::path assetDir = sessionDir / defaultAssetDirName(sessionPath);
+        SessionSnapshot snapshot = captureSession(baseSystem, sessionPath, assetDir, false);
+        snapshot.asJson = sessionPath.extension() == kSessionJsonExtension;
+        snapshot.collectAssets = true;
+        std::string error;
+        if (!writeSessionSnapshot(snapshot, nullptr, error)) {
+            std::cerr << "Session save failed: " << error << std::endl;
+            return false;
+        }
+        std::filesystem::remove(autosavePathFor(sessionPath), ec);
+        daw.sessionPath = sessionPath.string();
+        g_autosave.elapsed = 0.0;
+        DawRecordSystemLogic::SweepTakeFiles(daw, true);
+
         std::cerr << "Session saved: " << sessionPath << std::endl;
         return true;
     }
@@ -1840,24 +2350,33 @@ namespace DawIOSystemLogic {
         if (!baseSystem.daw || !baseSystem.midi) return false;
         DawContext& daw = *baseSystem.daw;
         MidiContext& midi = *baseSystem.midi;
+        joinAutosaveWorker();
 
         std::filesystem::path sessionPath(rawPath);
         if (!sessionPath.is_absolute()) {
             sessionPath = std::filesystem::absolute(sessionPath);
         }
-        if (!std::filesystem::exists(sessionPath)) {
+        if (!SessionBinary::recoverInterruptedSave(sessionPath)) {
             std::cerr << "Session load failed: file not found " << sessionPath << std::endl;
             return false;
         }
 
         json root;
-        try {
-            std::ifstream in(sessionPath);
-            if (!in.is_open()) return false;
-            root = json::parse(in);
-        } catch (...) {
-            std::cerr << "Session load failed: invalid JSON " << sessionPath << std::endl;
-            return false;
+        if (SessionBinary::isBinaryFile(sessionPath)) {
+            std::string error;
+            if (!SessionBinary::loadFile(sessionPath, root, error)) {
+                std::cerr << "Session load failed: " << error << " in " << sessionPath << std::endl;
+                return false;
+            }
+        } else {
+            try {
+                std::ifstream in(sessionPath);
+                if (!in.is_open()) return false;
+                root = json::parse(in);
+            } catch (...) {
+                std::cerr << "Session load failed: invalid JSON " << sessionPath << std::endl;
+                return false;
+            }
         }
 
         if (readString(root, "format", "") != kSessionFormat) {
@@ -1905,12 +2424,15 @@ namespace DawIOSystemLogic {
             std::lock_guard<std::mutex> dawLock(daw.trackMutex);
             std::lock_guard<std::mutex> midiLock(midi.trackMutex);
 
+            DawRecordSystemLogic::AbortTakes(daw);
             daw.clipAudio.clear();
+            DawStreamSystemLogic::ReleaseStreams(daw);
             for (auto& track : daw.tracks) {
-                track.audio.clear();
-                track.audioRight.clear();
                 track.pendingRecord.clear();
                 track.pendingRecordRight.clear();
+                track.pendingRecordBase = 0;
+                track.recordTakePath.clear();
+                track.recordTakeFrames = 0;
                 track.clips.clear();
                 track.loopTakeClips.clear();
                 track.waveformMin.clear();
@@ -1948,7 +2470,9 @@ namespace DawIOSystemLogic {
                 uint32_t rate = 0;
                 if (!rel.empty()) {
                     std::filesystem::path inPath = assetDir / rel;
-                    loadWavClipAudio(inPath.string(), data, rate);
+                    if (loadClipAudio(daw, inPath.string(), data, rate)) {
+                        data.contentHash = hexToHash(readString(clipEntry, "content_hash", ""));
+                    }
                 }
                 daw.clipAudio.push_back(std::move(data));
             }
@@ -2023,7 +2547,7 @@ namespace DawIOSystemLogic {
                 if (track.activeLoopTakeIndex < -1 || track.activeLoopTakeIndex >= static_cast<int>(track.loopTakeClips.size())) {
                     track.activeLoopTakeIndex = track.loopTakeClips.empty() ? -1 : 0;
                 }
-                DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+                DawClipSystemLogic::RefreshTrackFromClips(daw, track);
             }
 
             for (size_t i = 0; i < midi.tracks.size() && i < midiTracksJson.size(); ++i) {
@@ -2161,6 +2685,10 @@ namespace DawIOSystemLogic {
         }
         daw.uiCacheBuilt = false;
         midi.uiCacheBuilt = false;
+        daw.sessionPath = sessionPathForAutosave(sessionPath).string();
+        g_autosave.elapsed = 0.0;
+        g_autosave.lastHash = 0;
+        DawRecordSystemLogic::SweepTakeFiles(daw, true);
         std::cerr << "Session loaded: " << sessionPath << std::endl;
         return true;
     }
@@ -2230,12 +2758,6 @@ namespace DawIOSystemLogic {
         daw.exportSucceeded = false;
         daw.exportStatusMessage = "Exporting stems...";
 
-        const uint64_t reserveSamples = endSample - startSample;
-        for (auto& stem : daw.exportStemBuffers) {
-            stem.clear();
-            stem.reserve(static_cast<size_t>(reserveSamples));
-        }
-
         daw.exportMidiHeldVelocities.clear();
         if (baseSystem.vst3) {
             daw.exportSavedContinuousSamples = baseSystem.vst3->continuousSamples;
@@ -2248,7 +2770,24 @@ namespace DawIOSystemLogic {
             daw.exportSavedContinuousSamples = 0;
         }
 
+        uint32_t blockFrames = 512;
+        if (baseSystem.vst3 && baseSystem.vst3->blockSize > 0) {
+            blockFrames = static_cast<uint32_t>(std::max(64, baseSystem.vst3->blockSize));
+        }
+        std::array<std::string, DawContext::kBusCount> outPaths;
+        std::filesystem::path outDir(daw.exportFolderPath);
+        for (int i = 0; i < DawContext::kBusCount; ++i) {
+            const std::string stemName = sanitizeStemName(daw.exportStemNames[static_cast<size_t>(i)], i);
+            outPaths[static_cast<size_t>(i)] = (outDir / (stemName + ".wav")).string();
+        }
+
         audio.offlineRenderMute.store(true, std::memory_order_relaxed);
+        joinStemExportWorker();
+        g_stemExportWorker.finished.store(false, std::memory_order_relaxed);
+        g_stemExportWorker.cancelRequested.store(false, std::memory_order_relaxed);
+        g_stemExportWorker.success = false;
+        g_stemExportWorker.message.clear();
+        g_stemExportWorker.worker = std::thread(runStemExportJob, &baseSystem, outPaths, blockFrames);
         return true;
     }
 
@@ -2256,44 +2795,24 @@ namespace DawIOSystemLogic {
         if (!baseSystem.daw) return;
         DawContext& daw = *baseSystem.daw;
         if (!daw.exportJobActive) return;
-
-        uint32_t blockFrames = 512;
-        if (baseSystem.vst3 && baseSystem.vst3->blockSize > 0) {
-            blockFrames = static_cast<uint32_t>(std::max(64, baseSystem.vst3->blockSize));
-        }
-        constexpr int kBlocksPerTick = 8;
-        for (int i = 0; i < kBlocksPerTick; ++i) {
-            if (!daw.exportJobActive) break;
-            if (daw.exportJobCursorSample >= daw.exportJobEndSample) break;
-            if (!processStemExportBlock(baseSystem, blockFrames)) {
-                finishStemExport(baseSystem, false, "Export failed during render.");
-                return;
+        if (!g_stemExportWorker.finished.load(std::memory_order_acquire)) {
+            if (g_stemExportWorker.cancelRequested.load(std::memory_order_relaxed)) {
+                daw.exportStatusMessage = "Cancelling export...";
             }
-        }
-
-        if (daw.exportJobCursorSample < daw.exportJobEndSample) {
             return;
         }
+        joinStemExportWorker();
+        finishStemExport(baseSystem, g_stemExportWorker.success, g_stemExportWorker.message);
+    }
 
-        flushExportMidiNotes(baseSystem);
-
-        const uint32_t sampleRate = static_cast<uint32_t>(std::max(1.0f, daw.sampleRate));
-        bool wroteAll = true;
-        std::filesystem::path outDir(daw.exportFolderPath);
-        for (int i = 0; i < DawContext::kBusCount; ++i) {
-            const std::string stemName = sanitizeStemName(daw.exportStemNames[static_cast<size_t>(i)], i);
-            std::filesystem::path outPath = outDir / (stemName + ".wav");
-            if (!writeWavMonoFloat(outPath.string(),
-                                   daw.exportStemBuffers[static_cast<size_t>(i)],
-                                   sampleRate)) {
-                wroteAll = false;
-            }
-        }
-        if (wroteAll) {
-            finishStemExport(baseSystem, true, "Export complete.");
-        } else {
-            finishStemExport(baseSystem, false, "Export failed while writing files.");
-        }
+    void CancelStemExport(BaseSystem& baseSystem, bool waitForWorker) {
+        if (!baseSystem.daw) return;
+        DawContext& daw = *baseSystem.daw;
+        if (!daw.exportJobActive) return;
+        g_stemExportWorker.cancelRequested.store(true, std::memory_order_relaxed);
+        if (!waitForWorker) return;
+        joinStemExportWorker();
+        finishStemExport(baseSystem, false, "Export cancelled.");
     }
 
     bool ParseThemeColorHex(const std::string& value, glm::vec4& outColor) {
@@ -2520,6 +3039,7 @@ namespace DawIOSystemLogic {
         }
     }
 
-    void UpdateDawIO(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*) {
+    void UpdateDawIO(BaseSystem& baseSystem, std::vector<Entity>&, float dt, GLFWwindow*) {
+        tickAutosave(baseSystem, dt);
     }
 }
@@ -14,7 +14,7 @@
 
 namespace DawClipSystemLogic {
     void TrimClipsForNewClip(DawTrack& track, const DawClip& clip);
-    void RebuildTrackCacheFromClips(DawContext& daw, DawTrack& track);
+    void RefreshTrackFromClips(DawContext& daw, DawTrack& track);
     bool CycleTrackLoopTake(DawContext& daw, int trackIndex, int direction);
 }
 namespace DawTrackSystemLogic {
@@ -652,7 +652,7 @@ namespace DawLaneInputSystemLogic {
 
             track.clips[static_cast<size_t>(clipIndex)] = left;
             track.clips.insert(track.clips.begin() + clipIndex + 1, right);
-            DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+            DawClipSystemLogic::RefreshTrackFromClips(daw, track);
             daw.selectedClipTrack = trackIndex;
             daw.selectedClipIndex = clipIndex + 1;
             daw.selectedAutomationClipTrack = -1;
@@ -874,7 +874,7 @@ namespace DawLaneInputSystemLogic {
             DawTrack& track = daw.tracks[static_cast<size_t>(trackIndex)];
             if (clipIndex >= static_cast<int>(track.clips.size())) return false;
             track.clips.erase(track.clips.begin() + clipIndex);
-            DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+            DawClipSystemLogic::RefreshTrackFromClips(daw, track);
             daw.selectedClipTrack = -1;
             daw.selectedClipIndex = -1;
             daw.selectedAutomationClipTrack = -1;
@@ -1205,6 +1205,8 @@ namespace DawLaneInputSystemLogic {
                 if (cursorInRect(ui, exportLayout.closeBtn) || cursorInRect(ui, exportLayout.cancelBtn)) {
                     if (!exportInProgress) {
                         closeExportMenu();
+                    } else if (cursorInRect(ui, exportLayout.cancelBtn)) {
+                        DawIOSystemLogic::CancelStemExport(baseSystem, false);
                     }
                     ui.consumeClick = true;
                 } else if (!exportInProgress && cursorInRect(ui, exportLayout.startMinus)) {
@@ -1609,7 +1611,7 @@ namespace DawLaneInputSystemLogic {
                     break;
                 }
             }
-            DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+            DawClipSystemLogic::RefreshTrackFromClips(daw, track);
             daw.selectedClipTrack = trackIndex;
             daw.selectedClipIndex = selectedIndex;
             daw.selectedAutomationClipTrack = -1;
@@ -2299,7 +2301,7 @@ namespace DawLaneInputSystemLogic {
                 clip.startSample = daw.clipTrimTargetStart;
                 clip.length = daw.clipTrimTargetLength;
                 clip.sourceOffset = daw.clipTrimTargetSourceOffset;
-                DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+                DawClipSystemLogic::RefreshTrackFromClips(daw, track);
                 daw.clipTrimActive = false;
                 daw.clipTrimTrack = -1;
                 daw.clipTrimIndex = -1;
@@ -2312,7 +2314,7 @@ namespace DawLaneInputSystemLogic {
                 uint64_t origSourceOffset = daw.clipTrimOriginalSourceOffset;
                 uint64_t sourceSize = 0;
                 if (clip.audioId >= 0 && clip.audioId < static_cast<int>(daw.clipAudio.size())) {
-                    sourceSize = static_cast<uint64_t>(daw.clipAudio[clip.audioId].left.size());
+                    sourceSize = daw.clipAudio[clip.audioId].frameCount();
                 }
 
                 uint64_t prevEnd = 0;
@@ -2583,9 +2585,9 @@ namespace DawLaneInputSystemLogic {
                             baseSystem.midi->selectedClipTrack = -1;
                             baseSystem.midi->selectedClipIndex = -1;
                         }
-                        DawClipSystemLogic::RebuildTrackCacheFromClips(daw, toTrack);
+                        DawClipSystemLogic::RefreshTrackFromClips(daw, toTrack);
                         if (srcTrack != dstTrack) {
-                            DawClipSystemLogic::RebuildTrackCacheFromClips(daw, fromTrack);
+                            DawClipSystemLogic::RefreshTrackFromClips(daw, fromTrack);
                         }
                     }
                 }
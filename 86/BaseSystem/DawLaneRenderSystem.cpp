@@ -7,7 +7,13 @@
 #include <string>
 #include <vector>
 
-#include "stb_easy_font.h"
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic { UIBatch::Builder& Frame(BaseSystem& baseSystem); }
+namespace FontSystemLogic {
+    bool AppendUiLabel(UIBatch::TextOverlay& labels, size_t at, float x, float y, const char* text,
+                       const glm::vec3& color, double screenWidth, double screenHeight);
+}
 
 namespace DawLaneTimelineSystemLogic {
     struct LaneLayout;
@@ -17,11 +23,10 @@ namespace DawLaneTimelineSystemLogic {
 }
 namespace DawLaneResourceSystemLogic {
     using UiVertex = DawLaneTimelineSystemLogic::UiVertex;
-    const std::vector<UiVertex>& GetLaneVertices();
-    std::vector<UiVertex>& GetLaneVerticesMutable();
-    size_t GetLaneStaticVertexCount();
-    void SetLaneTotalVertexCount(size_t count);
-    size_t GetLaneTotalVertexCount();
+    bool LanesReady();
+    std::vector<UiVertex>& GetLaneOverlayVertices();
+    UIBatch::TextOverlay& GetLaneOverlayLabels();
+    void SubmitDawLanes(BaseSystem& baseSystem, UIBatch::Builder& batch, float alpha);
 }
 namespace DawIOSystemLogic {
     double BarSamples(const DawContext& daw);
@@ -71,29 +76,14 @@ namespace DawLaneRenderSystemLogic {
         }
 
         void pushText(std::vector<DawLaneResourceSystemLogic::UiVertex>& verts,
+                      UIBatch::TextOverlay& labels,
                       float x,
                       float y,
                       const char* text,
                       const glm::vec3& color,
                       double width,
                       double height) {
-            if (!text || text[0] == '\0') return;
-            char buffer[99999];
-            int quads = stb_easy_font_print(x, y, const_cast<char*>(text), nullptr, buffer, sizeof(buffer));
-            float* data = reinterpret_cast<float*>(buffer);
-            for (int i = 0; i < quads; ++i) {
-                int base = i * 16;
-                glm::vec2 v0{data[base + 0], data[base + 1]};
-                glm::vec2 v1{data[base + 4], data[base + 5]};
-                glm::vec2 v2{data[base + 8], data[base + 9]};
-                glm::vec2 v3{data[base + 12], data[base + 13]};
-                pushQuad(verts,
-                         pixelToNDC(v0, width, height),
-                         pixelToNDC(v1, width, height),
-                         pixelToNDC(v2, width, height),
-                         pixelToNDC(v3, width, height),
-                         color);
-            }
+            FontSystemLogic::AppendUiLabel(labels, verts.size(), x, y, text, color, width, height);
         }
 
         struct Rect {
@@ -386,14 +376,13 @@ namespace DawLaneRenderSystemLogic {
         if (!DawLaneTimelineSystemLogic::hasDawUiWorld(*baseSystem.level)) return;
 
         DawContext& daw = *baseSystem.daw;
-        RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
 
-        auto& vertices = DawLaneResourceSystemLogic::GetLaneVerticesMutable();
-        size_t staticCount = DawLaneResourceSystemLogic::GetLaneStaticVertexCount();
-        if (staticCount == 0 || !renderer.uiColorShader) return;
-        if (vertices.size() < staticCount) return;
-        vertices.resize(staticCount);
+        if (!DawLaneResourceSystemLogic::LanesReady()) return;
+        auto& vertices = DawLaneResourceSystemLogic::GetLaneOverlayVertices();
+        vertices.clear();
+        auto& labels = DawLaneResourceSystemLogic::GetLaneOverlayLabels();
+        labels.clear();
 
         const auto layout = DawLaneTimelineSystemLogic::ComputeLaneLayout(baseSystem, daw, win);
         const int audioTrackCount = layout.audioTrackCount;
@@ -1093,6 +1082,7 @@ namespace DawLaneRenderSystemLogic {
                         pushRect(vertices, rowRect, glm::vec3(0.28f, 0.33f, 0.37f), layout.screenWidth, layout.screenHeight);
                     }
                     pushText(vertices,
+                             labels,
                              menuLayout.menuRect.left + 8.0f,
                              y + 13.0f,
                              daw.automationParamMenuLabels[i].c_str(),
@@ -1139,6 +1129,7 @@ namespace DawLaneRenderSystemLogic {
 
             pushRect(vertices, settingsLayout.closeBtn, glm::vec3(0.72f, 0.26f, 0.24f), layout.screenWidth, layout.screenHeight);
             pushText(vertices,
+                     labels,
                      settingsLayout.closeBtn.left + 7.0f,
                      settingsLayout.closeBtn.top + 8.0f,
                      "X",
@@ -1166,6 +1157,7 @@ namespace DawLaneRenderSystemLogic {
                                 layout.screenWidth,
                                 layout.screenHeight);
                 pushText(vertices,
+                         labels,
                          rect.left + 8.0f,
                          rect.top + 15.0f,
                          label,
@@ -1175,6 +1167,7 @@ namespace DawLaneRenderSystemLogic {
             };
 
             pushText(vertices,
+                     labels,
                      settingsLayout.x + 18.0f,
                      settingsLayout.y + 24.0f,
                      "Settings",
@@ -1199,6 +1192,7 @@ namespace DawLaneRenderSystemLogic {
                         : glm::clamp(panelFront + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
                     pushRect(vertices, row, rowColor, layout.screenWidth, layout.screenHeight);
                     pushText(vertices,
+                             labels,
                              row.left + 8.0f,
                              row.top + 15.0f,
                              daw.themes[static_cast<size_t>(i)].name.c_str(),
@@ -1208,6 +1202,7 @@ namespace DawLaneRenderSystemLogic {
                 }
                 if (static_cast<int>(daw.themes.size()) > maxRows) {
                     pushText(vertices,
+                             labels,
                              settingsLayout.listRect.left + 8.0f,
                              settingsLayout.listRect.bottom + 14.0f,
                              "...",
@@ -1216,6 +1211,7 @@ namespace DawLaneRenderSystemLogic {
                              layout.screenHeight);
                 }
                 pushText(vertices,
+                         labels,
                          settingsLayout.x + 314.0f,
                          settingsLayout.y + 104.0f,
                          "Create custom themes with RGBA hex",
@@ -1223,6 +1219,7 @@ namespace DawLaneRenderSystemLogic {
                          layout.screenWidth,
                          layout.screenHeight);
                 pushText(vertices,
+                         labels,
                          settingsLayout.x + 314.0f,
                          settingsLayout.y + 124.0f,
                          "codes like FFFFFFCC.",
@@ -1245,6 +1242,7 @@ namespace DawLaneRenderSystemLogic {
             } else {
                 auto drawField = [&](const Rect& rect, const char* label, const std::string& value, bool active) {
                     pushText(vertices,
+                             labels,
                              rect.left,
                              rect.top - 6.0f,
                              label,
@@ -1269,6 +1267,7 @@ namespace DawLaneRenderSystemLogic {
                                     layout.screenWidth,
                                     layout.screenHeight);
                     pushText(vertices,
+                             labels,
                              rect.left + 8.0f,
                              rect.top + 18.0f,
                              value.c_str(),
@@ -1311,6 +1310,7 @@ namespace DawLaneRenderSystemLogic {
 
             if (!daw.themeStatusMessage.empty()) {
                 pushText(vertices,
+                         labels,
                          settingsLayout.x + 18.0f,
                          settingsLayout.y + settingsLayout.h - 14.0f,
                          daw.themeStatusMessage.c_str(),
@@ -1350,6 +1350,7 @@ namespace DawLaneRenderSystemLogic {
 
             pushRect(vertices, exportLayout.closeBtn, glm::vec3(0.72f, 0.26f, 0.24f), layout.screenWidth, layout.screenHeight);
             pushText(vertices,
+                     labels,
                      exportLayout.closeBtn.left + 7.0f,
                      exportLayout.closeBtn.top + 8.0f,
                      "X",
@@ -1367,6 +1368,7 @@ namespace DawLaneRenderSystemLogic {
                                 layout.screenWidth,
                                 layout.screenHeight);
                 pushText(vertices,
+                         labels,
                          rect.left + 7.0f,
                          rect.top + 15.0f,
                          label,
@@ -1381,9 +1383,10 @@ namespace DawLaneRenderSystemLogic {
             drawButton(exportLayout.endPlus, "+");
             drawButton(exportLayout.folderBtn, "Folder");
             drawButton(exportLayout.exportBtn, daw.exportInProgress.load(std::memory_order_relaxed) ? "Busy" : "Export");
-            drawButton(exportLayout.cancelBtn, "Close");
+            drawButton(exportLayout.cancelBtn, daw.exportInProgress.load(std::memory_order_relaxed) ? "Cancel" : "Close");
 
             pushText(vertices,
+                     labels,
                      exportLayout.x + 18.0f,
                      exportLayout.y + 24.0f,
                      "Export Stems",
@@ -1395,8 +1398,8 @@ namespace DawLaneRenderSystemLogic {
             char endLabel[64];
             std::snprintf(startLabel, sizeof(startLabel), "Start Bar: %d", daw.exportStartBar);
             std::snprintf(endLabel, sizeof(endLabel), "End Bar: %d", daw.exportEndBar);
-            pushText(vertices, exportLayout.x + 24.0f, exportLayout.y + 72.0f, startLabel, textColor, layout.screenWidth, layout.screenHeight);
-            pushText(vertices, exportLayout.x + 24.0f, exportLayout.y + 104.0f, endLabel, textColor, layout.screenWidth, layout.screenHeight);
+            pushText(vertices, labels, exportLayout.x + 24.0f, exportLayout.y + 72.0f, startLabel, textColor, layout.screenWidth, layout.screenHeight);
+            pushText(vertices, labels, exportLayout.x + 24.0f, exportLayout.y + 104.0f, endLabel, textColor, layout.screenWidth, layout.screenHeight);
 
             int64_t startSample = DawIOSystemLogic::BarDisplayToSample(daw, daw.exportStartBar);
             int64_t endSample = DawIOSystemLogic::BarDisplayToSample(daw, daw.exportEndBar);
@@ -1407,13 +1410,13 @@ namespace DawLaneRenderSystemLogic {
             double lenSec = static_cast<double>(lengthSamples) / sampleRate;
             char lenLabel[96];
             std::snprintf(lenLabel, sizeof(lenLabel), "Length: %.2f bars (%.2f sec)", lenBars, lenSec);
-            pushText(vertices, exportLayout.x + 24.0f, exportLayout.y + 136.0f, lenLabel, textColor, layout.screenWidth, layout.screenHeight);
+            pushText(vertices, labels, exportLayout.x + 24.0f, exportLayout.y + 136.0f, lenLabel, textColor, layout.screenWidth, layout.screenHeight);
 
             std::string folder = daw.exportFolderPath.empty() ? std::string("<not set>") : daw.exportFolderPath;
             if (folder.size() > 52) {
                 folder = "..." + folder.substr(folder.size() - 49);
             }
-            pushText(vertices, exportLayout.x + 24.0f, exportLayout.y + 152.0f, folder.c_str(), textColor, layout.screenWidth, layout.screenHeight);
+            pushText(vertices, labels, exportLayout.x + 24.0f, exportLayout.y + 152.0f, folder.c_str(), textColor, layout.screenWidth, layout.screenHeight);
 
             const std::array<const char*, DawContext::kBusCount> busLabels{"L", "S", "F", "R"};
             for (int i = 0; i < DawContext::kBusCount; ++i) {
@@ -1427,6 +1430,7 @@ namespace DawLaneRenderSystemLogic {
                 const std::string& name = daw.exportStemNames[static_cast<size_t>(i)];
                 std::snprintf(stemLabel, sizeof(stemLabel), "%s Stem: %s.wav", busLabels[static_cast<size_t>(i)], name.c_str());
                 pushText(vertices,
+                         labels,
                          row.left + 8.0f,
                          row.top + 16.0f,
                          stemLabel,
@@ -1448,6 +1452,7 @@ namespace DawLaneRenderSystemLogic {
                 status = daw.exportInProgress.load(std::memory_order_relaxed) ? "Exporting..." : "Ready";
             }
             pushText(vertices,
+                     labels,
                      exportLayout.progressBar.left,
                      exportLayout.progressBar.bottom + 16.0f,
                      status.c_str(),
@@ -1456,28 +1461,12 @@ namespace DawLaneRenderSystemLogic {
                      layout.screenHeight);
         }
 
-        DawLaneResourceSystemLogic::SetLaneTotalVertexCount(vertices.size());
-        size_t totalCount = DawLaneResourceSystemLogic::GetLaneTotalVertexCount();
-        if (totalCount == 0 || !renderer.uiColorShader) return;
-
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
         float laneAlpha = kLaneAlphaDefault;
         if (baseSystem.daw) {
             laneAlpha = std::clamp(baseSystem.daw->activeThemeBackground.a, 0.0f, 1.0f);
         }
-        glBlendColor(0.0f, 0.0f, 0.0f, laneAlpha);
-        glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-        glBindVertexArray(renderer.uiLaneVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.uiLaneVBO);
-        glBufferData(GL_ARRAY_BUFFER, totalCount * sizeof(DawLaneResourceSystemLogic::UiVertex), vertices.data(), GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(DawLaneResourceSystemLogic::UiVertex), (void*)offsetof(DawLaneResourceSystemLogic::UiVertex, pos));
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(DawLaneResourceSystemLogic::UiVertex), (void*)offsetof(DawLaneResourceSystemLogic::UiVertex, color));
-        glEnableVertexAttribArray(1);
-        renderer.uiColorShader->use();
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(totalCount));
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_DEPTH_TEST);
+        UIBatch::Builder& batch = UIBatchSystemLogic::Frame(baseSystem);
+        DawLaneResourceSystemLogic::SubmitDawLanes(baseSystem, batch, laneAlpha);
+        batch.addColored(vertices, laneAlpha, labels);
     }
 }
@@ -6,7 +6,15 @@
 #include <cstdio>
 #include <vector>
 
-#include "stb_easy_font.h"
+#include "BaseSystem/LaneGeometry.h"
+#include "BaseSystem/UIBatch.h"
+
+namespace FontSystemLogic {
+    bool AppendUiLabel(UIBatch::TextOverlay& labels, size_t at, float x, float y, const char* text,
+                       const glm::vec3& color, double screenWidth, double screenHeight);
+}
+
+namespace UIBatchSystemLogic { void UseLaneStore(BaseSystem& baseSystem, LaneGeometry::Store& store); }
 
 namespace DawLaneTimelineSystemLogic {
     struct LaneLayout;
@@ -26,31 +34,50 @@ namespace DawLaneResourceSystemLogic {
         constexpr float kRulerGap = 6.0f;
         constexpr float kTrackHandleSize = 60.0f;
         constexpr float kTrackHandleInset = 12.0f;
-        constexpr float kClipHorizontalPad = 2.0f;
-        constexpr float kClipVerticalInset = 0.0f;
-        constexpr float kClipMinHeight = 2.0f;
-        constexpr float kClipLipMinHeight = 6.0f;
-        constexpr float kClipLipMaxHeight = 12.0f;
         constexpr size_t kWaveformBlockSize = 256;
 
+        using LaneVertex = DawLaneTimelineSystemLogic::UiVertex;
+
+        struct ClipGeometry {
+            LaneGeometry::Segment body;  // body, lip and beat ticks
+            LaneGeometry::ClipLayout layout;
+        };
+
+        // One audio lane's segments in the store; see LaneGeometry.h.
+        struct TrackGeometry {
+            std::vector<ClipGeometry> clips;
+            LaneGeometry::Segment background;
+            LaneGeometry::Segment handle;
+            LaneGeometry::Segment wave;  // stereo divider, clip waveforms and record preview, in window x
+            bool hasRightWave = false;
+        };
+
+        struct LanePalette {
+            glm::vec3 lane{0.14f, 0.14f, 0.14f};
+            glm::vec3 highlight{0.2f, 0.2f, 0.2f};
+            glm::vec3 shadow{0.08f, 0.08f, 0.08f};
+            glm::vec3 waveform{0.05f, 0.05f, 0.05f};
+            glm::vec3 clip{0.0f};
+            glm::vec3 clipLip{0.0f};
+            glm::vec3 selectedClip{0.0f};
+            glm::vec3 selectedClipLip{0.0f};
+        };
+
+        // The lanes live in a LaneGeometry::Store the batch draws from its
+        // own buffer; the plan says what of it this view shows. The ruler and
+        // grid are rebuilt with the plan and submitted ahead of it.
+        // vertices/labels are DawLaneRender's overlay, refilled every frame.
         struct LaneRenderCache {
-            std::vector<DawLaneTimelineSystemLogic::UiVertex> vertices;
-            size_t staticVertexCount = 0;
-            size_t totalVertexCount = 0;
-            int cachedWidth = 0;
-            int cachedHeight = 0;
-            float cachedScrollY = 0.0f;
-            float cachedStartY = 0.0f;
-            float cachedLaneHeight = 60.0f;
-            int cachedTrackCount = 0;
-            int64_t cachedTimelineOffset = 0;
-            double cachedSecondsPerScreen = 10.0;
-            double cachedBpm = 120.0;
-            std::vector<int> cachedLaneSignature;
-            std::vector<uint64_t> waveVersions;
-            std::vector<uint64_t> cachedClipSignature;
-            int cachedPreviewSlot = -1;
-            uint64_t cachedThemeRevision = 0;
+            LaneGeometry::Store store;
+            LaneGeometry::Plan plan;
+            std::vector<LaneGeometry::Vertex> scratch;
+            std::vector<LaneVertex> rulerVertices;
+            std::vector<LaneVertex> vertices;
+            UIBatch::TextOverlay labels;
+            std::vector<TrackGeometry> tracks;
+            uint64_t composedKey = 0;
+            uint64_t composedRevision = 0;
+            bool composed = false;
         };
 
         LaneRenderCache g_cache;
@@ -61,7 +88,7 @@ namespace DawLaneResourceSystemLogic {
             return {ndcX, ndcY};
         }
 
-        void pushQuad(std::vector<DawLaneTimelineSystemLogic::UiVertex>& verts,
+        void pushQuad(std::vector<LaneVertex>& verts,
                       const glm::vec2& a,
                       const glm::vec2& b,
                       const glm::vec2& c,
@@ -75,147 +102,280 @@ namespace DawLaneResourceSystemLogic {
             verts.push_back({d, color});
         }
 
-        void pushText(std::vector<DawLaneTimelineSystemLogic::UiVertex>& verts,
-                      float x,
-                      float y,
-                      const char* text,
-                      const glm::vec3& color,
-                      double width,
-                      double height) {
-            if (!text || text[0] == '\0') return;
-            char buffer[99999];
-            int numQuads = stb_easy_font_print(x, y, const_cast<char*>(text), nullptr, buffer, sizeof(buffer));
-            float* vertsRaw = reinterpret_cast<float*>(buffer);
-            for (int i = 0; i < numQuads; ++i) {
-                const int base = i * 16;
-                glm::vec2 v0{vertsRaw[base + 0], vertsRaw[base + 1]};
-                glm::vec2 v1{vertsRaw[base + 4], vertsRaw[base + 5]};
-                glm::vec2 v2{vertsRaw[base + 8], vertsRaw[base + 9]};
-                glm::vec2 v3{vertsRaw[base + 12], vertsRaw[base + 13]};
-                pushQuad(verts,
-                         pixelToNDC(v0, width, height),
-                         pixelToNDC(v1, width, height),
-                         pixelToNDC(v2, width, height),
-                         pixelToNDC(v3, width, height),
-                         color);
-            }
+        uint32_t packRgb(const glm::vec3& color) {
+            return UIBatch::packColor(color.r, color.g, color.b, 0.0f);
         }
 
-        void computeClipRect(float centerY,
-                             float laneHalfH,
-                             float& top,
-                             float& bottom,
-                             float& lipBottom) {
-            top = centerY - laneHalfH + kClipVerticalInset;
-            bottom = centerY + laneHalfH - kClipVerticalInset;
-            if (bottom < top + kClipMinHeight) {
-                float mid = (top + bottom) * 0.5f;
-                top = mid - (kClipMinHeight * 0.5f);
-                bottom = mid + (kClipMinHeight * 0.5f);
-            }
-            float lipHeight = std::clamp((bottom - top) * 0.18f, kClipLipMinHeight, kClipLipMaxHeight);
-            lipBottom = std::min(bottom, top + lipHeight);
-        }
-
-        void ensureResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.uiColorShader) {
-                renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(), world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.uiLaneVAO == 0) {
-                glGenVertexArrays(1, &renderer.uiLaneVAO);
-                glGenBuffers(1, &renderer.uiLaneVBO);
-            }
-        }
-
-        void buildLanes(BaseSystem& baseSystem,
-                        DawContext& daw,
-                        WorldContext& world,
-                        const DawLaneTimelineSystemLogic::LaneLayout& layout,
-                        int previewSlot,
-                        double bpm) {
-            const int audioTrackCount = layout.audioTrackCount;
-            const int laneCount = layout.laneCount;
-            const float laneLeft = layout.laneLeft;
-            const float laneRight = layout.laneRight;
-            const float laneHalfH = layout.laneHalfH;
-            const float rowSpan = layout.rowSpan;
-            const float startY = layout.startY;
-            const float topBound = layout.topBound;
-            const float visualBottomBound = layout.visualBottomBound;
-            const double secondsPerScreen = layout.secondsPerScreen;
-            const bool previewingAudioLaneDrag = (previewSlot >= 0
-                && daw.dragActive
-                && daw.dragLaneType == 0
-                && daw.dragLaneIndex >= 0);
-            const int draggedLaneIndex = daw.dragLaneIndex;
-            auto computeDisplayIndex = [&](int laneIndex) -> int {
-                int displayIndex = laneIndex;
-                if (previewSlot < 0) return displayIndex;
-                if (previewingAudioLaneDrag) {
-                    if (laneIndex == draggedLaneIndex) return -1;
-                    if (laneIndex > draggedLaneIndex) {
-                        displayIndex -= 1;
-                    }
-                }
-                if (displayIndex >= previewSlot) {
-                    displayIndex += 1;
-                }
-                return displayIndex;
-            };
-
-            g_cache.cachedWidth = static_cast<int>(layout.screenWidth);
-            g_cache.cachedHeight = static_cast<int>(layout.screenHeight);
-            g_cache.cachedScrollY = layout.scrollY;
-            g_cache.cachedStartY = layout.startY;
-            g_cache.cachedLaneHeight = layout.laneHeight;
-            g_cache.cachedTrackCount = audioTrackCount;
-            g_cache.cachedTimelineOffset = daw.timelineOffsetSamples;
-            g_cache.cachedSecondsPerScreen = secondsPerScreen;
-            g_cache.cachedBpm = bpm;
-            g_cache.cachedThemeRevision = daw.themeRevision;
-            g_cache.vertices.clear();
-            g_cache.vertices.reserve(static_cast<size_t>(audioTrackCount) * 18);
-
-            glm::vec3 laneColor(0.14f, 0.14f, 0.14f);
-            glm::vec3 laneHighlight(0.2f, 0.2f, 0.2f);
-            glm::vec3 laneShadow(0.08f, 0.08f, 0.08f);
-            glm::vec3 waveformBaseColor(0.05f, 0.05f, 0.05f);
+        LanePalette lanePalette(const WorldContext& world) {
+            LanePalette palette;
             auto itBase = world.colorLibrary.find("MiraLaneBase");
             if (itBase != world.colorLibrary.end()) {
-                laneColor = itBase->second;
+                palette.lane = itBase->second;
                 auto itHighlight = world.colorLibrary.find("MiraLaneHighlight");
                 if (itHighlight != world.colorLibrary.end()) {
-                    laneHighlight = itHighlight->second;
+                    palette.highlight = itHighlight->second;
                 } else {
-                    laneHighlight = glm::clamp(laneColor + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+                    palette.highlight = glm::clamp(palette.lane + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
                 }
                 auto itShadow = world.colorLibrary.find("MiraLaneShadow");
                 if (itShadow != world.colorLibrary.end()) {
-                    laneShadow = itShadow->second;
+                    palette.shadow = itShadow->second;
                 } else {
-                    laneShadow = glm::clamp(laneColor - glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+                    palette.shadow = glm::clamp(palette.lane - glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
                 }
                 auto itWave = world.colorLibrary.find("MiraWaveform");
                 if (itWave != world.colorLibrary.end()) {
-                    waveformBaseColor = itWave->second;
+                    palette.waveform = itWave->second;
                 } else {
-                    waveformBaseColor = glm::clamp(laneShadow - glm::vec3(0.2f), glm::vec3(0.0f), glm::vec3(1.0f));
+                    palette.waveform = glm::clamp(palette.shadow - glm::vec3(0.2f), glm::vec3(0.0f), glm::vec3(1.0f));
                 }
             } else {
                 auto it = world.colorLibrary.find("DarkGray");
                 if (it != world.colorLibrary.end()) {
-                    laneColor = glm::clamp(it->second + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
-                    laneHighlight = glm::clamp(it->second + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
-                    laneShadow = glm::clamp(it->second - glm::vec3(0.06f), glm::vec3(0.0f), glm::vec3(1.0f));
-                    waveformBaseColor = glm::clamp(it->second - glm::vec3(0.2f), glm::vec3(0.0f), glm::vec3(1.0f));
+                    palette.lane = glm::clamp(it->second + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
+                    palette.highlight = glm::clamp(it->second + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+                    palette.shadow = glm::clamp(it->second - glm::vec3(0.06f), glm::vec3(0.0f), glm::vec3(1.0f));
+                    palette.waveform = glm::clamp(it->second - glm::vec3(0.2f), glm::vec3(0.0f), glm::vec3(1.0f));
+                }
+            }
+            palette.clip = glm::clamp(palette.highlight + glm::vec3(0.12f), glm::vec3(0.0f), glm::vec3(1.0f));
+            palette.clipLip = glm::clamp(palette.clip - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
+            palette.selectedClip = glm::clamp(palette.clip + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+            auto itSelectedClip = world.colorLibrary.find("MiraLaneSelected");
+            if (itSelectedClip != world.colorLibrary.end()) {
+                palette.selectedClip = itSelectedClip->second;
+            }
+            palette.selectedClipLip = glm::clamp(palette.selectedClip - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
+            return palette;
+        }
+
+        void writeSegment(LaneGeometry::Segment& segment) {
+            g_cache.store.write(segment.id, g_cache.scratch);
+        }
+
+        void releaseTrack(TrackGeometry& geometry) {
+            for (ClipGeometry& clip : geometry.clips) g_cache.store.release(clip.body.id);
+            g_cache.store.release(geometry.background.id);
+            g_cache.store.release(geometry.handle.id);
+            g_cache.store.release(geometry.wave.id);
+        }
+
+        void buildBackground(TrackGeometry& geometry,
+                             uint32_t lane,
+                             const DawLaneTimelineSystemLogic::LaneLayout& layout,
+                             const LanePalette& palette,
+                             uint64_t themeRevision) {
+            const uint64_t key = LaneGeometry::Key()
+                .addReal(layout.laneLeft).addReal(layout.laneRight).addReal(layout.laneHalfH)
+                .add(themeRevision).value();
+            if (!geometry.background.rebuild(key)) return;
+            g_cache.scratch.clear();
+            LaneGeometry::pushBevelBox(g_cache.scratch, lane, layout.laneLeft, layout.laneHalfH, layout.laneRight, 6.0f,
+                                       packRgb(palette.lane), packRgb(palette.highlight), packRgb(palette.shadow));
+            writeSegment(geometry.background);
+        }
+
+        void buildHandle(TrackGeometry& geometry,
+                         uint32_t lane,
+                         const DawLaneTimelineSystemLogic::LaneLayout& layout,
+                         const LanePalette& palette,
+                         uint64_t themeRevision) {
+            const uint64_t key = LaneGeometry::Key()
+                .addReal(layout.laneLeft).addReal(layout.laneRight).addReal(layout.laneHeight)
+                .add(themeRevision).value();
+            if (!geometry.handle.rebuild(key)) return;
+            float handleSize = std::min(kTrackHandleSize, std::max(14.0f, layout.laneHeight));
+            float handleHalf = handleSize * 0.5f;
+            float handleCenterX = layout.laneRight + kTrackHandleInset + handleHalf;
+            float minCenterX = layout.laneLeft + 4.0f + handleHalf;
+            if (handleCenterX < minCenterX) handleCenterX = minCenterX;
+            glm::vec3 handleFront = glm::clamp(palette.lane + glm::vec3(0.03f), glm::vec3(0.0f), glm::vec3(1.0f));
+            glm::vec3 handleTop = glm::clamp(palette.highlight + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
+            float handleDepth = std::min(6.0f, handleHalf * 0.5f);
+            g_cache.scratch.clear();
+            LaneGeometry::pushBevelBox(g_cache.scratch, lane, handleCenterX - handleHalf, handleHalf,
+                                       handleCenterX + handleHalf, handleDepth,
+                                       packRgb(handleFront), packRgb(handleTop), packRgb(palette.shadow));
+            writeSegment(geometry.handle);
+        }
+
+        // Every beat tick of the clip is kept, so only edits rebuild it.
+        void buildClipBody(ClipGeometry& geometry,
+                           uint32_t lane,
+                           const DawClip& clip,
+                           bool selected,
+                           const LanePalette& palette,
+                           float laneHalfH,
+                           uint64_t beatStepSamples,
+                           uint64_t themeRevision) {
+            const uint64_t key = LaneGeometry::Key()
+                .add(clip.startSample).add(clip.length).add(selected ? 1u : 0u)
+                .add(beatStepSamples).addReal(laneHalfH).add(themeRevision).value();
+            if (!geometry.body.rebuild(key)) return;
+            const glm::vec3& bodyColor = selected ? palette.selectedClip : palette.clip;
+            const glm::vec3& lipColor = selected ? palette.selectedClipLip : palette.clipLip;
+            g_cache.scratch.clear();
+            geometry.layout = LaneGeometry::pushClip(g_cache.scratch, lane, laneHalfH, clip.startSample, clip.length,
+                                                     beatStepSamples, packRgb(bodyColor), packRgb(lipColor));
+            writeSegment(geometry.body);
+        }
+
+        // Stereo divider, clip waveforms and the blocks UpdateWaveformRange
+        // writes while a take is recorded. Columns are sampled per lane pixel
+        // as before, so this segment follows the view horizontally; each
+        // reads the pyramid level closest to samplesPerPixel, so peaks
+        // survive at any zoom.
+        void buildTrackWave(TrackGeometry& geometry,
+                            uint32_t lane,
+                            const DawContext& daw,
+                            const DawTrack& track,
+                            const LaneGeometry::View& view,
+                            const LanePalette& palette,
+                            float laneHalfH,
+                            float ampScale,
+                            uint64_t themeRevision) {
+            const uint64_t previewStart = track.recordStartSample;
+            const uint64_t previewEnd = track.recordStartSample + track.pendingRecordBase
+                + static_cast<uint64_t>(track.pendingRecord.size());
+            const bool hasPreview = previewEnd > previewStart && !track.waveformMin.empty()
+                && track.waveformMax.size() == track.waveformMin.size();
+            const bool hasRightWave = geometry.hasRightWave;
+            LaneGeometry::Key key;
+            key.addReal(view.offsetSamples).addReal(view.windowSamples).addReal(view.laneLeft).addReal(view.laneRight)
+                .addReal(laneHalfH).addReal(ampScale).add(hasRightWave ? 1u : 0u).add(daw.clipWaveformVersion)
+                .add(static_cast<uint64_t>(track.clips.size()));
+            for (const auto& clip : track.clips) {
+                key.add(static_cast<uint64_t>(clip.audioId + 1)).add(clip.startSample).add(clip.length).add(clip.sourceOffset);
+            }
+            key.add(hasPreview ? 1u : 0u);
+            if (hasPreview) {
+                key.add(track.waveformVersion).add(previewStart).add(previewEnd)
+                    .add(static_cast<uint64_t>(track.waveformMin.size())).add(themeRevision);
+            }
+            if (!geometry.wave.rebuild(key.value())) return;
+            g_cache.scratch.clear();
+            auto& out = g_cache.scratch;
+            if ((track.clips.empty() && !hasPreview) || static_cast<int>(view.laneRight - view.laneLeft) <= 0
+                || view.windowSamples <= 0.0) {
+                writeSegment(geometry.wave);
+                return;
+            }
+            if (hasRightWave) {
+                LaneGeometry::pushSplit(out, lane, view.laneLeft, view.laneRight, packRgb(glm::vec3(0.03f, 0.03f, 0.03f)));
+            }
+            auto pushColumn = [&](int x, float minVal, float maxVal, float minValR, float maxValR,
+                                  const glm::vec3& blockColor) {
+                glm::vec3 rightColor = glm::clamp(blockColor + glm::vec3(0.16f, 0.04f, 0.08f),
+                                                  glm::vec3(0.0f), glm::vec3(1.0f));
+                LaneGeometry::pushWaveColumn(out, lane, view.laneLeft + static_cast<float>(x), laneHalfH, ampScale,
+                                             hasRightWave, minVal, maxVal, minValR, maxValR,
+                                             packRgb(blockColor), packRgb(rightColor));
+            };
+            for (const auto& clip : track.clips) {
+                if (clip.audioId < 0 || clip.audioId >= static_cast<int>(daw.clipAudio.size())) continue;
+                const DawClipAudio& clipAudio = daw.clipAudio[clip.audioId];
+                const double clipStart = static_cast<double>(clip.startSample);
+                LaneGeometry::clipColumns(view, clip.startSample, clip.length, [&](int x, double s0, double s1) {
+                    const uint64_t src0 = clip.sourceOffset + static_cast<uint64_t>(s0 - clipStart);
+                    const uint64_t src1 = std::max(src0 + 1, clip.sourceOffset + static_cast<uint64_t>(std::ceil(s1 - clipStart)));
+                    DawWaveformSpan span;
+                    if (!DawWaveformSystemLogic::QueryClipWaveform(clipAudio, src0, src1, span)) return;
+                    pushColumn(x, span.minL, span.maxL, span.minR, span.maxR, span.color);
+                });
+            }
+            if (hasPreview) {
+                const size_t blockCount = track.waveformMin.size();
+                const bool previewRight = (track.waveformMinRight.size() == blockCount)
+                    && (track.waveformMaxRight.size() == blockCount);
+                LaneGeometry::previewColumns(view, previewStart, previewEnd, [&](int x, double samplePos) {
+                    size_t idx = static_cast<size_t>(samplePos) / kWaveformBlockSize;
+                    if (idx >= blockCount) return;
+                    const float minVal = track.waveformMin[idx];
+                    const float maxVal = track.waveformMax[idx];
+                    pushColumn(x,
+                               minVal,
+                               maxVal,
+                               previewRight ? track.waveformMinRight[idx] : minVal,
+                               previewRight ? track.waveformMaxRight[idx] : maxVal,
+                               palette.waveform);
+                });
+            }
+            writeSegment(geometry.wave);
+        }
+
+        // Rewrites whatever segments of on-screen lanes went stale.
+        void refreshGeometry(const DawContext& daw,
+                             const DawLaneTimelineSystemLogic::LaneLayout& layout,
+                             const LaneGeometry::Rows& rows,
+                             const std::vector<int>& audioLaneIndex,
+                             const LaneGeometry::View& view,
+                             const LanePalette& palette) {
+            const int audioTrackCount = layout.audioTrackCount;
+            if (g_cache.tracks.size() != static_cast<size_t>(audioTrackCount)) {
+                for (size_t t = static_cast<size_t>(audioTrackCount); t < g_cache.tracks.size(); ++t) {
+                    releaseTrack(g_cache.tracks[t]);
+                }
+                g_cache.tracks.resize(static_cast<size_t>(audioTrackCount));
+            }
+
+            double bpmNow = daw.bpm.load(std::memory_order_relaxed);
+            if (bpmNow <= 0.0) bpmNow = 120.0;
+            uint64_t beatStepSamples = std::max<uint64_t>(1,
+                static_cast<uint64_t>(std::llround((60.0 / bpmNow) * static_cast<double>(daw.sampleRate))));
+            const float ampScale = layout.laneHeight * 0.8f * 0.5f;
+
+            for (int t = 0; t < audioTrackCount; ++t) {
+                int laneIndex = audioLaneIndex[static_cast<size_t>(t)];
+                if (laneIndex < 0) continue;
+                int displayIndex = rows.displayIndex(laneIndex);
+                if (displayIndex < 0) continue;
+                if (!rows.onScreen(rows.centerY(displayIndex), layout.screenHeight)) continue;
+                const DawTrack& track = daw.tracks[static_cast<size_t>(t)];
+                TrackGeometry& geometry = g_cache.tracks[static_cast<size_t>(t)];
+                const uint32_t lane = static_cast<uint32_t>(t);
+                bool trackHasStereoClip = false;
+                for (const auto& clip : track.clips) {
+                    if (clip.audioId < 0 || clip.audioId >= static_cast<int>(daw.clipAudio.size())) continue;
+                    const DawClipAudio& clipAudio = daw.clipAudio[clip.audioId];
+                    if (clipAudio.channels > 1 && (clipAudio.isStreamed() || !clipAudio.right.empty())) {
+                        trackHasStereoClip = true;
+                        break;
+                    }
                 }
+                geometry.hasRightWave = trackHasStereoClip;
+                buildBackground(geometry, lane, layout, palette, daw.themeRevision);
+                buildHandle(geometry, lane, layout, palette, daw.themeRevision);
+                if (geometry.clips.size() != track.clips.size()) {
+                    for (size_t ci = track.clips.size(); ci < geometry.clips.size(); ++ci) {
+                        g_cache.store.release(geometry.clips[ci].body.id);
+                    }
+                    geometry.clips.resize(track.clips.size());
+                }
+                for (size_t ci = 0; ci < track.clips.size(); ++ci) {
+                    const DawClip& clip = track.clips[ci];
+                    bool selectedClip = (t == daw.selectedClipTrack) && (static_cast<int>(ci) == daw.selectedClipIndex);
+                    buildClipBody(geometry.clips[ci], lane, clip, selectedClip, palette,
+                                  layout.laneHalfH, beatStepSamples, daw.themeRevision);
+                }
+                buildTrackWave(geometry, lane, daw, track, view, palette,
+                               layout.laneHalfH, ampScale, daw.themeRevision);
             }
+        }
 
+        void composeRulerAndGrid(const DawContext& daw,
+                                 const DawLaneTimelineSystemLogic::LaneLayout& layout,
+                                 const LanePalette& palette,
+                                 double bpm) {
+            const float laneLeft = layout.laneLeft;
+            const float laneRight = layout.laneRight;
+            const float topBound = layout.topBound;
+            const float visualBottomBound = layout.visualBottomBound;
+            const double secondsPerScreen = layout.secondsPerScreen;
             if (daw.laneOrder.empty()) {
-                glm::vec3 rulerFront = laneHighlight;
-                glm::vec3 rulerTop = glm::clamp(laneHighlight + glm::vec3(0.05f), glm::vec3(0.0f), glm::vec3(1.0f));
-                glm::vec3 rulerSide = glm::clamp(laneShadow - glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
-                float rulerTopY = startY - laneHalfH - (kRulerHeight + kRulerInset) + kRulerLowerOffset;
+                glm::vec3 rulerFront = palette.highlight;
+                glm::vec3 rulerTop = glm::clamp(palette.highlight + glm::vec3(0.05f), glm::vec3(0.0f), glm::vec3(1.0f));
+                glm::vec3 rulerSide = glm::clamp(palette.shadow - glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
+                float rulerTopY = layout.startY - layout.laneHalfH - (kRulerHeight + kRulerInset) + kRulerLowerOffset;
                 float rulerBottomY = rulerTopY + kRulerHeight;
                 float bevelDepth = 6.0f;
                 float rulerLeft = laneLeft + kRulerSideInset;
@@ -232,19 +392,19 @@ namespace DawLaneResourceSystemLogic {
                 glm::vec2 rLeftB = rFrontD;
                 glm::vec2 rLeftC(rFrontD.x - bevelDepth, rFrontD.y - bevelDepth);
                 glm::vec2 rLeftD(rFrontA.x - bevelDepth, rFrontA.y - bevelDepth);
-                pushQuad(g_cache.vertices,
+                pushQuad(g_cache.rulerVertices,
                          pixelToNDC(rFrontA, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(rFrontB, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(rFrontC, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(rFrontD, layout.screenWidth, layout.screenHeight),
                          rulerFront);
-                pushQuad(g_cache.vertices,
+                pushQuad(g_cache.rulerVertices,
                          pixelToNDC(rTopA, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(rTopB, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(rTopC, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(rTopD, layout.screenWidth, layout.screenHeight),
                          rulerTop);
-                pushQuad(g_cache.vertices,
+                pushQuad(g_cache.rulerVertices,
                          pixelToNDC(rLeftA, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(rLeftB, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(rLeftC, layout.screenWidth, layout.screenHeight),
@@ -258,7 +418,7 @@ namespace DawLaneResourceSystemLogic {
                 double offsetSec = static_cast<double>(daw.timelineOffsetSamples) / static_cast<double>(daw.sampleRate);
                 double endSec = offsetSec + secondsPerScreen;
                 double firstTick = std::floor(offsetSec / gridSeconds) * gridSeconds;
-                glm::vec3 gridColor = glm::clamp(laneShadow + glm::vec3(0.06f), glm::vec3(0.0f), glm::vec3(1.0f));
+                glm::vec3 gridColor = glm::clamp(palette.shadow + glm::vec3(0.06f), glm::vec3(0.0f), glm::vec3(1.0f));
                 float lineHalf = 0.5f;
                 for (double tick = firstTick; tick <= endSec + 0.0001; tick += gridSeconds) {
                     float t = static_cast<float>((tick - offsetSec) / secondsPerScreen);
@@ -283,7 +443,7 @@ namespace DawLaneResourceSystemLogic {
                     glm::vec2 b(x + lineHalf, topBound);
                     glm::vec2 c(x + lineHalf, visualBottomBound);
                     glm::vec2 d(x - lineHalf, visualBottomBound);
-                    pushQuad(g_cache.vertices,
+                    pushQuad(g_cache.rulerVertices,
                              pixelToNDC(a, layout.screenWidth, layout.screenHeight),
                              pixelToNDC(b, layout.screenWidth, layout.screenHeight),
                              pixelToNDC(c, layout.screenWidth, layout.screenHeight),
@@ -294,7 +454,7 @@ namespace DawLaneResourceSystemLogic {
                 glm::vec2 hTopB(laneRight, topBound - lineHalf);
                 glm::vec2 hTopC(laneRight, topBound + lineHalf);
                 glm::vec2 hTopD(laneLeft, topBound + lineHalf);
-                pushQuad(g_cache.vertices,
+                pushQuad(g_cache.rulerVertices,
                          pixelToNDC(hTopA, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(hTopB, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(hTopC, layout.screenWidth, layout.screenHeight),
@@ -304,374 +464,107 @@ namespace DawLaneResourceSystemLogic {
                 glm::vec2 hBotB(laneRight, visualBottomBound - lineHalf);
                 glm::vec2 hBotC(laneRight, visualBottomBound + lineHalf);
                 glm::vec2 hBotD(laneLeft, visualBottomBound + lineHalf);
-                pushQuad(g_cache.vertices,
+                pushQuad(g_cache.rulerVertices,
                          pixelToNDC(hBotA, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(hBotB, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(hBotC, layout.screenWidth, layout.screenHeight),
                          pixelToNDC(hBotD, layout.screenWidth, layout.screenHeight),
                          gridColor);
             }
+        }
 
-            const auto audioLaneIndex = DawLaneTimelineSystemLogic::BuildAudioLaneIndex(daw, audioTrackCount);
-
-            for (int i = 0; i < audioTrackCount; ++i) {
-                int laneIndex = audioLaneIndex[static_cast<size_t>(i)];
-                if (laneIndex < 0) continue;
-                int displayIndex = computeDisplayIndex(laneIndex);
-                if (displayIndex < 0) continue;
-                float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                float top = centerY - laneHalfH;
-                float bottom = centerY + laneHalfH;
+        // Lays out what this view shows of the store. Painter's order matches
+        // the old single pass: ruler and grid, lane bodies, clip bodies with
+        // their labels, waveforms, handles.
+        void composeLanes(const DawContext& daw,
+                          const DawLaneTimelineSystemLogic::LaneLayout& layout,
+                          const LaneGeometry::Rows& rows,
+                          const std::vector<int>& audioLaneIndex,
+                          const LaneGeometry::View& view,
+                          const LanePalette& palette,
+                          double bpm) {
+            const int audioTrackCount = layout.audioTrackCount;
+            LaneGeometry::Plan& plan = g_cache.plan;
+            const LaneGeometry::Store& store = g_cache.store;
+            g_cache.rulerVertices.clear();
+            plan.clear();
+            composeRulerAndGrid(daw, layout, palette, bpm);
 
-                float bevelDepth = 6.0f;
-                glm::vec2 frontA(laneLeft, top);
-                glm::vec2 frontB(laneRight, top);
-                glm::vec2 frontC(laneRight, bottom);
-                glm::vec2 frontD(laneLeft, bottom);
-
-                glm::vec2 topA = frontA;
-                glm::vec2 topB = frontB;
-                glm::vec2 topC(frontB.x - bevelDepth, frontB.y - bevelDepth);
-                glm::vec2 topD(frontA.x - bevelDepth, frontA.y - bevelDepth);
-
-                glm::vec2 leftA = frontA;
-                glm::vec2 leftB = frontD;
-                glm::vec2 leftC(frontD.x - bevelDepth, frontD.y - bevelDepth);
-                glm::vec2 leftD(frontA.x - bevelDepth, frontA.y - bevelDepth);
-
-                pushQuad(g_cache.vertices,
-                         pixelToNDC(frontA, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(frontB, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(frontC, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(frontD, layout.screenWidth, layout.screenHeight),
-                         laneColor);
-                pushQuad(g_cache.vertices,
-                         pixelToNDC(topA, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(topB, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(topC, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(topD, layout.screenWidth, layout.screenHeight),
-                         laneHighlight);
-                pushQuad(g_cache.vertices,
-                         pixelToNDC(leftA, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(leftB, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(leftC, layout.screenWidth, layout.screenHeight),
-                         pixelToNDC(leftD, layout.screenWidth, layout.screenHeight),
-                         laneShadow);
-            }
+            uint64_t beatStepSamples = std::max<uint64_t>(1,
+                static_cast<uint64_t>(std::llround((60.0 / bpm) * static_cast<double>(daw.sampleRate))));
+            auto laneCenter = [&](int t, float& centerY) -> bool {
+                int laneIndex = audioLaneIndex[static_cast<size_t>(t)];
+                if (laneIndex < 0) return false;
+                int displayIndex = rows.displayIndex(laneIndex);
+                if (displayIndex < 0) return false;
+                centerY = rows.centerY(displayIndex);
+                return rows.onScreen(centerY, layout.screenHeight);
+            };
+            auto label = [&](size_t at, float x, float y, const char* text) {
+                FontSystemLogic::AppendUiLabel(plan.labels(), at, x, y, text, glm::vec3(0.04f, 0.04f, 0.04f),
+                                               layout.screenWidth, layout.screenHeight);
+            };
 
-            double offsetSamples = static_cast<double>(daw.timelineOffsetSamples);
-            double windowSamples = secondsPerScreen * static_cast<double>(daw.sampleRate);
-            if (windowSamples < 0.0) windowSamples = 0.0;
-            glm::vec3 clipColor = glm::clamp(laneHighlight + glm::vec3(0.12f), glm::vec3(0.0f), glm::vec3(1.0f));
-            glm::vec3 clipLipColor = glm::clamp(clipColor - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
-            glm::vec3 selectedClipColor = glm::clamp(clipColor + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
-            auto itSelectedClip = world.colorLibrary.find("MiraLaneSelected");
-            if (itSelectedClip != world.colorLibrary.end()) {
-                selectedClipColor = itSelectedClip->second;
+            float centerY = 0.0f;
+            for (int t = 0; t < audioTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                const TrackGeometry& geometry = g_cache.tracks[static_cast<size_t>(t)];
+                plan.add(store, geometry.background.id, static_cast<uint32_t>(t), centerY, view);
             }
-            glm::vec3 selectedClipLipColor = glm::clamp(selectedClipColor - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
-            double bpmNow = daw.bpm.load(std::memory_order_relaxed);
-            if (bpmNow <= 0.0) bpmNow = 120.0;
-            uint64_t beatStepSamples = std::max<uint64_t>(1,
-                static_cast<uint64_t>(std::llround((60.0 / bpmNow) * static_cast<double>(daw.sampleRate))));
             for (int t = 0; t < audioTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
                 const auto& clips = daw.tracks[static_cast<size_t>(t)].clips;
-                if (clips.empty()) continue;
-                int laneIndex = audioLaneIndex[static_cast<size_t>(t)];
-                if (laneIndex < 0) continue;
-                int displayIndex = computeDisplayIndex(laneIndex);
-                if (displayIndex < 0) continue;
-                float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                float top = 0.0f;
-                float bottom = 0.0f;
-                float lipBottom = 0.0f;
-                computeClipRect(centerY, laneHalfH, top, bottom, lipBottom);
-                for (size_t ci = 0; ci < clips.size(); ++ci) {
-                    const auto& clip = clips[ci];
-                    if (clip.length == 0) continue;
-                    bool selectedClip = (t == daw.selectedClipTrack) && (static_cast<int>(ci) == daw.selectedClipIndex);
-                    const glm::vec3& bodyColor = selectedClip ? selectedClipColor : clipColor;
-                    const glm::vec3& lipColor = selectedClip ? selectedClipLipColor : clipLipColor;
-                    double clipStart = static_cast<double>(clip.startSample);
-                    double clipEnd = static_cast<double>(clip.startSample + clip.length);
-                    if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) continue;
-                    double visibleStart = std::max(clipStart, offsetSamples);
-                    double visibleEnd = std::min(clipEnd, offsetSamples + windowSamples);
-                    float t0 = (windowSamples > 0.0)
-                        ? static_cast<float>((visibleStart - offsetSamples) / windowSamples)
-                        : 0.0f;
-                    float t1 = (windowSamples > 0.0)
-                        ? static_cast<float>((visibleEnd - offsetSamples) / windowSamples)
-                        : 0.0f;
-                    float x0 = laneLeft + (laneRight - laneLeft) * t0 - kClipHorizontalPad;
-                    float x1 = laneLeft + (laneRight - laneLeft) * t1 + kClipHorizontalPad;
-                    x0 = std::max(x0, laneLeft);
-                    x1 = std::min(x1, laneRight);
-                    if (x1 < laneLeft || x0 > laneRight) continue;
-                    glm::vec2 a(x0, top);
-                    glm::vec2 b(x1, top);
-                    glm::vec2 c(x1, bottom);
-                    glm::vec2 d(x0, bottom);
-                    pushQuad(g_cache.vertices,
-                             pixelToNDC(a, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(b, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(c, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(d, layout.screenWidth, layout.screenHeight),
-                             bodyColor);
-                    if (lipBottom > top + 0.5f) {
-                        glm::vec2 la(x0, top);
-                        glm::vec2 lb(x1, top);
-                        glm::vec2 lc(x1, lipBottom);
-                        glm::vec2 ld(x0, lipBottom);
-                        pushQuad(g_cache.vertices,
-                                 pixelToNDC(la, layout.screenWidth, layout.screenHeight),
-                                 pixelToNDC(lb, layout.screenWidth, layout.screenHeight),
-                                 pixelToNDC(lc, layout.screenWidth, layout.screenHeight),
-                                 pixelToNDC(ld, layout.screenWidth, layout.screenHeight),
-                                 lipColor);
-                    }
-                    if (beatStepSamples > 0 && x1 > x0 + 2.0f) {
-                        uint64_t visibleStartSample = static_cast<uint64_t>(std::max(visibleStart, 0.0));
-                        uint64_t visibleEndSample = static_cast<uint64_t>(std::max(visibleEnd, 0.0));
-                        if (visibleEndSample > visibleStartSample) {
-                            const uint64_t clipStartSample = clip.startSample;
-                            uint64_t tick = clipStartSample;
-                            if (visibleStartSample > clipStartSample) {
-                                uint64_t delta = visibleStartSample - clipStartSample;
-                                uint64_t steps = (delta + beatStepSamples - 1) / beatStepSamples;
-                                tick = clipStartSample + steps * beatStepSamples;
-                            }
-                            int guard = 0;
-                            float markerTop = lipBottom + 1.0f;
-                            float maxTickHeight = std::max(3.0f, bottom - markerTop - 2.0f);
-                            float beatTickHeight = std::clamp(maxTickHeight * 0.30f, 3.0f, 8.0f);
-                            float barTickHeight = std::clamp(maxTickHeight * 0.52f, 5.0f, 13.0f);
-                            float phraseTickHeight = std::clamp(maxTickHeight * 0.68f, 7.0f, 16.0f);
-                            float lastLabelX = -10000.0f;
-                            while (tick < visibleEndSample && guard < 512) {
-                                float tt = static_cast<float>((static_cast<double>(tick) - offsetSamples) / windowSamples);
-                                float x = laneLeft + (laneRight - laneLeft) * tt;
-                                x = std::clamp(x, x0 + 1.0f, x1 - 1.0f);
-                                uint64_t localBeat = (tick >= clipStartSample)
-                                    ? ((tick - clipStartSample) / beatStepSamples)
-                                    : 0;
-                                bool isBar = ((localBeat % 4ull) == 0ull);
-                                bool isPhrase = ((localBeat % 16ull) == 0ull);
-                                float lineHalf = isBar ? 0.9f : 0.45f;
-                                glm::vec3 lineColor = isBar ? glm::vec3(0.02f, 0.02f, 0.02f)
-                                                            : glm::vec3(0.06f, 0.06f, 0.06f);
-                                float markerBottom = markerTop + (isPhrase ? phraseTickHeight : (isBar ? barTickHeight : beatTickHeight));
-                                markerBottom = std::min(markerBottom, bottom - 1.0f);
-                                pushQuad(g_cache.vertices,
-                                         pixelToNDC({x - lineHalf, markerTop}, layout.screenWidth, layout.screenHeight),
-                                         pixelToNDC({x + lineHalf, markerTop}, layout.screenWidth, layout.screenHeight),
-                                         pixelToNDC({x + lineHalf, markerBottom}, layout.screenWidth, layout.screenHeight),
-                                         pixelToNDC({x - lineHalf, markerBottom}, layout.screenWidth, layout.screenHeight),
-                                         lineColor);
-                                if ((x - lastLabelX) >= 46.0f
-                                    && (x + 30.0f) <= (x1 - 2.0f)
-                                    && (markerBottom + 10.0f) <= (bottom - 2.0f)) {
-                                    uint64_t barIndex = (localBeat / 4ull) + 1ull;
-                                    uint64_t beatInBar = (localBeat % 4ull) + 1ull;
-                                    char label[24];
-                                    std::snprintf(label, sizeof(label), "%llu.%llu.1",
-                                                  static_cast<unsigned long long>(barIndex),
-                                                  static_cast<unsigned long long>(beatInBar));
-                                    pushText(g_cache.vertices,
-                                             x + 2.0f,
-                                             markerBottom + 2.0f,
-                                             label,
-                                             glm::vec3(0.04f, 0.04f, 0.04f),
-                                             layout.screenWidth,
-                                             layout.screenHeight);
-                                    lastLabelX = x;
-                                }
-                                tick += beatStepSamples;
-                                ++guard;
-                            }
-                        }
-                    }
+                const TrackGeometry& geometry = g_cache.tracks[static_cast<size_t>(t)];
+                for (size_t ci = 0; ci < clips.size() && ci < geometry.clips.size(); ++ci) {
+                    LaneGeometry::planClip(plan, store, geometry.clips[ci].body.id, geometry.clips[ci].layout,
+                                           static_cast<uint32_t>(t), centerY, layout.laneHalfH, view,
+                                           clips[ci].startSample, clips[ci].length, beatStepSamples, label);
                 }
             }
-
-            float waveHeight = layout.laneHeight * 0.8f;
-            float ampScale = waveHeight * 0.5f;
-            int pixelWidth = static_cast<int>(laneRight - laneLeft);
-            if (pixelWidth > 0) {
-                for (int t = 0; t < audioTrackCount; ++t) {
-                    const DawTrack& track = daw.tracks[t];
-                    if (track.waveformMin.empty() || track.waveformMax.empty()) continue;
-                    size_t blockCount = track.waveformMin.size();
-                    if (blockCount == 0) continue;
-                    bool trackHasStereoClip = false;
-                    for (const auto& clip : track.clips) {
-                        if (clip.audioId < 0 || clip.audioId >= static_cast<int>(daw.clipAudio.size())) continue;
-                        const DawClipAudio& clipAudio = daw.clipAudio[clip.audioId];
-                        if (clipAudio.channels > 1 && !clipAudio.right.empty()) {
-                            trackHasStereoClip = true;
-                            break;
-                        }
-                    }
-                    const bool hasRightWave =
-                        trackHasStereoClip
-                        && (track.waveformMinRight.size() == blockCount)
-                        && (track.waveformMaxRight.size() == blockCount);
-                    int laneIndex = audioLaneIndex[static_cast<size_t>(t)];
-                    if (laneIndex < 0) continue;
-                    int displayIndex = computeDisplayIndex(laneIndex);
-                    if (displayIndex < 0) continue;
-                    float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                    float top = centerY - laneHalfH;
-                    float bottom = centerY + laneHalfH;
-                    if (hasRightWave) {
-                        const float splitY = 0.5f * (top + bottom);
-                        const float splitHalf = 0.5f;
-                        pushQuad(g_cache.vertices,
-                                 pixelToNDC({laneLeft, splitY - splitHalf}, layout.screenWidth, layout.screenHeight),
-                                 pixelToNDC({laneRight, splitY - splitHalf}, layout.screenWidth, layout.screenHeight),
-                                 pixelToNDC({laneRight, splitY + splitHalf}, layout.screenWidth, layout.screenHeight),
-                                 pixelToNDC({laneLeft, splitY + splitHalf}, layout.screenWidth, layout.screenHeight),
-                                 glm::vec3(0.03f, 0.03f, 0.03f));
-                    }
-                    for (int x = 0; x < pixelWidth; ++x) {
-                        double samplePos = offsetSamples + (static_cast<double>(x) / static_cast<double>(pixelWidth)) * windowSamples;
-                        if (samplePos < 0.0) continue;
-                        size_t idx = static_cast<size_t>(samplePos) / kWaveformBlockSize;
-                        if (idx >= blockCount) continue;
-                        float minVal = track.waveformMin[idx];
-                        float maxVal = track.waveformMax[idx];
-                        float yTop = centerY - maxVal * ampScale;
-                        float yBottom = centerY - minVal * ampScale;
-                        yTop = std::max(yTop, top);
-                        yBottom = std::min(yBottom, bottom);
-                        float xPos = laneLeft + static_cast<float>(x);
-                        float lineWidth = 1.0f;
-                        glm::vec3 blockColor = waveformBaseColor;
-                        if (idx < track.waveformColor.size()) {
-                            blockColor = track.waveformColor[idx];
-                        }
-                        if (hasRightWave) {
-                            const float splitY = 0.5f * (top + bottom);
-                            const float regionGap = 1.0f;
-                            const float topRegionTop = top;
-                            const float topRegionBottom = splitY - regionGap;
-                            const float bottomRegionTop = splitY + regionGap;
-                            const float bottomRegionBottom = bottom;
-                            const float topCenter = 0.5f * (topRegionTop + topRegionBottom);
-                            const float bottomCenter = 0.5f * (bottomRegionTop + bottomRegionBottom);
-                            const float topAmp = std::max(1.0f, (topRegionBottom - topRegionTop) * 0.45f);
-                            const float bottomAmp = std::max(1.0f, (bottomRegionBottom - bottomRegionTop) * 0.45f);
-
-                            float yTopL = topCenter - maxVal * topAmp;
-                            float yBottomL = topCenter - minVal * topAmp;
-                            yTopL = std::clamp(yTopL, topRegionTop, topRegionBottom);
-                            yBottomL = std::clamp(yBottomL, topRegionTop, topRegionBottom);
-                            pushQuad(g_cache.vertices,
-                                     pixelToNDC({xPos - lineWidth, yTopL}, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC({xPos + lineWidth, yTopL}, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC({xPos + lineWidth, yBottomL}, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC({xPos - lineWidth, yBottomL}, layout.screenWidth, layout.screenHeight),
-                                     blockColor);
-
-                            float minValR = track.waveformMinRight[idx];
-                            float maxValR = track.waveformMaxRight[idx];
-                            float yTopR = bottomCenter - maxValR * bottomAmp;
-                            float yBottomR = bottomCenter - minValR * bottomAmp;
-                            yTopR = std::clamp(yTopR, bottomRegionTop, bottomRegionBottom);
-                            yBottomR = std::clamp(yBottomR, bottomRegionTop, bottomRegionBottom);
-                            glm::vec3 rightColor = glm::clamp(blockColor + glm::vec3(0.16f, 0.04f, 0.08f),
-                                                              glm::vec3(0.0f), glm::vec3(1.0f));
-                            pushQuad(g_cache.vertices,
-                                     pixelToNDC({xPos - lineWidth, yTopR}, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC({xPos + lineWidth, yTopR}, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC({xPos + lineWidth, yBottomR}, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC({xPos - lineWidth, yBottomR}, layout.screenWidth, layout.screenHeight),
-                                     rightColor);
-                        } else {
-                            glm::vec2 a(xPos - lineWidth, yTop);
-                            glm::vec2 b(xPos + lineWidth, yTop);
-                            glm::vec2 c(xPos + lineWidth, yBottom);
-                            glm::vec2 d(xPos - lineWidth, yBottom);
-                            pushQuad(g_cache.vertices,
-                                     pixelToNDC(a, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC(b, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC(c, layout.screenWidth, layout.screenHeight),
-                                     pixelToNDC(d, layout.screenWidth, layout.screenHeight),
-                                     blockColor);
-                        }
-                    }
-                }
+            for (int t = 0; t < audioTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                const TrackGeometry& geometry = g_cache.tracks[static_cast<size_t>(t)];
+                plan.add(store, geometry.wave.id, static_cast<uint32_t>(t), centerY, view);
             }
-
-            {
-                float handleSize = std::min(kTrackHandleSize, std::max(14.0f, layout.laneHeight));
-                float handleHalf = handleSize * 0.5f;
-                float handleCenterX = laneRight + kTrackHandleInset + handleHalf;
-                float minCenterX = laneLeft + 4.0f + handleHalf;
-                if (handleCenterX < minCenterX) handleCenterX = minCenterX;
-                glm::vec3 handleFront = glm::clamp(laneColor + glm::vec3(0.03f), glm::vec3(0.0f), glm::vec3(1.0f));
-                glm::vec3 handleTop = glm::clamp(laneHighlight + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
-                glm::vec3 handleSide = laneShadow;
-                float handleDepth = std::min(6.0f, handleHalf * 0.5f);
-                for (int t = 0; t < audioTrackCount; ++t) {
-                    int laneIndex = audioLaneIndex[static_cast<size_t>(t)];
-                    if (laneIndex < 0) continue;
-                    int displayIndex = computeDisplayIndex(laneIndex);
-                    if (displayIndex < 0) continue;
-                    float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                    float top = centerY - handleHalf;
-                    float bottom = centerY + handleHalf;
-                    glm::vec2 frontA(handleCenterX - handleHalf, top);
-                    glm::vec2 frontB(handleCenterX + handleHalf, top);
-                    glm::vec2 frontC(handleCenterX + handleHalf, bottom);
-                    glm::vec2 frontD(handleCenterX - handleHalf, bottom);
-                    glm::vec2 topA = frontA;
-                    glm::vec2 topB = frontB;
-                    glm::vec2 topC(frontB.x - handleDepth, frontB.y - handleDepth);
-                    glm::vec2 topD(frontA.x - handleDepth, frontA.y - handleDepth);
-                    glm::vec2 leftA = frontA;
-                    glm::vec2 leftB = frontD;
-                    glm::vec2 leftC(frontD.x - handleDepth, frontD.y - handleDepth);
-                    glm::vec2 leftD(frontA.x - handleDepth, frontA.y - handleDepth);
-                    pushQuad(g_cache.vertices,
-                             pixelToNDC(frontA, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(frontB, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(frontC, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(frontD, layout.screenWidth, layout.screenHeight),
-                             handleFront);
-                    pushQuad(g_cache.vertices,
-                             pixelToNDC(topA, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(topB, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(topC, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(topD, layout.screenWidth, layout.screenHeight),
-                             handleTop);
-                    pushQuad(g_cache.vertices,
-                             pixelToNDC(leftA, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(leftB, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(leftC, layout.screenWidth, layout.screenHeight),
-                             pixelToNDC(leftD, layout.screenWidth, layout.screenHeight),
-                             handleSide);
-                }
+            for (int t = 0; t < audioTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                const TrackGeometry& geometry = g_cache.tracks[static_cast<size_t>(t)];
+                plan.add(store, geometry.handle.id, static_cast<uint32_t>(t), centerY, view);
             }
+            plan.mark();
+        }
 
-            g_cache.staticVertexCount = g_cache.vertices.size();
-            if (g_cache.waveVersions.size() != static_cast<size_t>(audioTrackCount)) {
-                g_cache.waveVersions.assign(static_cast<size_t>(audioTrackCount), 0);
-            }
-            for (int t = 0; t < audioTrackCount; ++t) {
-                g_cache.waveVersions[static_cast<size_t>(t)] = daw.tracks[t].waveformVersion;
+        // Lane centers for the shader; lanes not drawn keep 0.
+        void placeLanes(const LaneGeometry::Rows& rows, const std::vector<int>& audioLaneIndex) {
+            std::vector<float>& centers = g_cache.store.transform.centerY;
+            centers.assign(audioLaneIndex.size(), 0.0f);
+            for (size_t t = 0; t < audioLaneIndex.size(); ++t) {
+                if (audioLaneIndex[t] < 0) continue;
+                int displayIndex = rows.displayIndex(audioLaneIndex[t]);
+                if (displayIndex >= 0) centers[t] = rows.centerY(displayIndex);
             }
         }
     }
 
     using UiVertex = DawLaneTimelineSystemLogic::UiVertex;
 
-    const std::vector<UiVertex>& GetLaneVertices() { return g_cache.vertices; }
-    std::vector<UiVertex>& GetLaneVerticesMutable() { return g_cache.vertices; }
-    size_t GetLaneStaticVertexCount() { return g_cache.staticVertexCount; }
-    void SetLaneTotalVertexCount(size_t count) { g_cache.totalVertexCount = count; }
-    size_t GetLaneTotalVertexCount() { return g_cache.totalVertexCount; }
+    bool LanesReady() { return g_cache.composed; }
+    std::vector<UiVertex>& GetLaneOverlayVertices() { return g_cache.vertices; }
+    UIBatch::TextOverlay& GetLaneOverlayLabels() { return g_cache.labels; }
+
+    // Ruler and grid, then the lanes from the store, at the lane alpha.
+    void SubmitDawLanes(BaseSystem& baseSystem, UIBatch::Builder& batch, float alpha) {
+        if (!g_cache.composed) return;
+        batch.addColored(g_cache.rulerVertices, alpha);
+        g_cache.store.transform.setAlpha(alpha);
+        UIBatchSystemLogic::UseLaneStore(baseSystem, g_cache.store);
+        g_cache.plan.submit(batch, g_cache.store);
+    }
 
+    // Keeps the lane store and plan current. Segments are rewritten only when
+    // their own inputs change; scrolling, zooming and lane drags move them
+    // through the transform, except the waveform columns, which are sampled
+    // per pixel and follow the view horizontally.
     void UpdateDawLaneResources(BaseSystem& baseSystem, std::vector<Entity>&, float, GLFWwindow* win) {
         if (!baseSystem.ui || !baseSystem.daw || !baseSystem.renderer || !baseSystem.world || !baseSystem.level || !win) return;
         UIContext& ui = *baseSystem.ui;
@@ -679,103 +572,56 @@ namespace DawLaneResourceSystemLogic {
         if (baseSystem.midi && baseSystem.midi->pianoRollActive) return;
         if (!DawLaneTimelineSystemLogic::hasDawUiWorld(*baseSystem.level)) return;
 
-        RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
-        ensureResources(renderer, world);
 
         DawContext& daw = *baseSystem.daw;
         const auto layout = DawLaneTimelineSystemLogic::ComputeLaneLayout(baseSystem, daw, win);
-        const int audioTrackCount = layout.audioTrackCount;
-        const double secondsPerScreen = layout.secondsPerScreen;
-
-        bool rebuildStatic = (static_cast<int>(layout.screenWidth) != g_cache.cachedWidth)
-            || (static_cast<int>(layout.screenHeight) != g_cache.cachedHeight);
-        if (std::abs(layout.scrollY - g_cache.cachedScrollY) > 0.01f) {
-            rebuildStatic = true;
-        }
-        if (std::abs(layout.startY - g_cache.cachedStartY) > 0.01f) {
-            rebuildStatic = true;
-        }
-        if (std::abs(layout.laneHeight - g_cache.cachedLaneHeight) > 0.01f) {
-            rebuildStatic = true;
-        }
-        if (audioTrackCount != g_cache.cachedTrackCount) {
-            rebuildStatic = true;
-        }
-        if (std::abs(secondsPerScreen - g_cache.cachedSecondsPerScreen) > 0.0001) {
-            rebuildStatic = true;
-        }
         double bpm = daw.bpm.load(std::memory_order_relaxed);
         if (bpm <= 0.0) bpm = 120.0;
-        if (std::abs(bpm - g_cache.cachedBpm) > 0.001) {
-            rebuildStatic = true;
-        }
-        if (daw.timelineOffsetSamples != g_cache.cachedTimelineOffset) {
-            rebuildStatic = true;
-        }
-        if (daw.themeRevision != g_cache.cachedThemeRevision) {
-            rebuildStatic = true;
-        }
-        {
-            std::vector<uint64_t> clipSig;
-            clipSig.reserve(static_cast<size_t>(audioTrackCount) * 4);
-            for (int t = 0; t < audioTrackCount; ++t) {
-                clipSig.push_back(static_cast<uint64_t>(t));
-                const auto& clips = daw.tracks[static_cast<size_t>(t)].clips;
-                clipSig.push_back(static_cast<uint64_t>(clips.size()));
-                for (const auto& clip : clips) {
-                    clipSig.push_back(static_cast<uint64_t>(clip.audioId));
-                    clipSig.push_back(clip.startSample);
-                    clipSig.push_back(clip.length);
-                    clipSig.push_back(clip.sourceOffset);
-                }
-            }
-            clipSig.push_back(static_cast<uint64_t>(daw.selectedClipTrack + 1));
-            clipSig.push_back(static_cast<uint64_t>(daw.selectedClipIndex + 1));
-            if (clipSig != g_cache.cachedClipSignature) {
-                rebuildStatic = true;
-                g_cache.cachedClipSignature = std::move(clipSig);
-            }
-        }
-        if (g_cache.waveVersions.size() != static_cast<size_t>(audioTrackCount)) {
-            g_cache.waveVersions.assign(static_cast<size_t>(audioTrackCount), 0);
-            rebuildStatic = true;
-        }
-        for (int t = 0; t < audioTrackCount; ++t) {
-            if (daw.tracks[t].waveformVersion != g_cache.waveVersions[static_cast<size_t>(t)]) {
-                rebuildStatic = true;
-                break;
-            }
-        }
-
-        std::vector<int> laneSignature;
-        laneSignature.reserve(daw.laneOrder.size() * 2);
-        for (const auto& entry : daw.laneOrder) {
-            laneSignature.push_back(entry.type);
-            laneSignature.push_back(entry.trackIndex);
-        }
-        if (laneSignature != g_cache.cachedLaneSignature) {
-            rebuildStatic = true;
-            g_cache.cachedLaneSignature = laneSignature;
-        }
 
-        if (rebuildStatic) {
-            buildLanes(baseSystem, daw, world, layout, -1, bpm);
-        }
-
-        int previewSlot = -1;
+        LaneGeometry::Rows rows;
+        rows.startY = layout.startY;
+        rows.rowSpan = layout.rowSpan;
         if (daw.dragActive && daw.dragLaneType == 0) {
-            previewSlot = daw.dragDropIndex;
+            rows.previewSlot = daw.dragDropIndex;
         } else if (daw.externalDropActive && daw.externalDropType == 0) {
-            previewSlot = daw.externalDropIndex;
+            rows.previewSlot = daw.externalDropIndex;
+        }
+        rows.previewingDrag = rows.previewSlot >= 0 && daw.dragActive && daw.dragLaneType == 0 && daw.dragLaneIndex >= 0;
+        rows.draggedLaneIndex = daw.dragLaneIndex;
+
+        LaneGeometry::View view;
+        view.offsetSamples = static_cast<double>(daw.timelineOffsetSamples);
+        view.windowSamples = std::max(0.0, layout.secondsPerScreen * static_cast<double>(daw.sampleRate));
+        view.laneLeft = layout.laneLeft;
+        view.laneRight = layout.laneRight;
+        view.screenWidth = layout.screenWidth;
+        view.screenHeight = layout.screenHeight;
+
+        const LanePalette palette = lanePalette(world);
+        const auto audioLaneIndex = DawLaneTimelineSystemLogic::BuildAudioLaneIndex(daw, layout.audioTrackCount);
+        refreshGeometry(daw, layout, rows, audioLaneIndex, view, palette);
+        g_cache.store.transform.setView(view);
+        placeLanes(rows, audioLaneIndex);
+
+        LaneGeometry::Key composeKey;
+        composeKey.addReal(layout.screenWidth).addReal(layout.screenHeight)
+            .addReal(view.offsetSamples).addReal(view.windowSamples)
+            .addReal(layout.laneLeft).addReal(layout.laneRight).addReal(layout.laneHalfH)
+            .addReal(layout.startY).addReal(layout.rowSpan).addReal(layout.topBound).addReal(layout.visualBottomBound)
+            .add(static_cast<uint64_t>(layout.audioTrackCount))
+            .add(static_cast<uint64_t>(rows.previewSlot + 1)).add(rows.previewingDrag ? 1u : 0u)
+            .add(static_cast<uint64_t>(rows.draggedLaneIndex + 1)).addReal(bpm).add(daw.themeRevision)
+            .add(static_cast<uint64_t>(daw.laneOrder.size()));
+        for (const auto& entry : daw.laneOrder) {
+            composeKey.add(static_cast<uint64_t>(entry.type)).add(static_cast<uint64_t>(entry.trackIndex));
         }
-        if (previewSlot >= 0) {
-            buildLanes(baseSystem, daw, world, layout, previewSlot, bpm);
-        } else if (g_cache.cachedPreviewSlot >= 0 && !rebuildStatic) {
-            // Drag preview just ended; rebuild static vertices immediately
-            // so no preview-only lane offsets linger in cache.
-            buildLanes(baseSystem, daw, world, layout, -1, bpm);
+        if (!g_cache.composed || composeKey.value() != g_cache.composedKey
+            || g_cache.store.revision() != g_cache.composedRevision) {
+            composeLanes(daw, layout, rows, audioLaneIndex, view, palette, bpm);
+            g_cache.composedKey = composeKey.value();
+            g_cache.composedRevision = g_cache.store.revision();
+            g_cache.composed = true;
         }
-        g_cache.cachedPreviewSlot = previewSlot;
     }
 }
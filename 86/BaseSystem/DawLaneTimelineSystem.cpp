@@ -7,7 +7,7 @@
 #include <vector>
 
 namespace DawClipSystemLogic {
-    void RebuildTrackCacheFromClips(DawContext& daw, DawTrack& track);
+    void RefreshTrackFromClips(DawContext& daw, DawTrack& track);
 }
 namespace MidiLaneSystemLogic {
     void OnTimelineRebased(uint64_t shiftSamples);
@@ -161,7 +161,6 @@ namespace DawLaneTimelineSystemLogic {
         uint64_t maxSamples = daw.playheadSample.load(std::memory_order_relaxed);
         maxSamples = std::max<uint64_t>(maxSamples, daw.loopEndSamples);
         for (const auto& track : daw.tracks) {
-            maxSamples = std::max<uint64_t>(maxSamples, static_cast<uint64_t>(track.audio.size()));
             for (const auto& clip : track.clips) {
                 maxSamples = std::max<uint64_t>(maxSamples, clip.startSample + clip.length);
             }
@@ -258,7 +257,7 @@ namespace DawTimelineRebaseLogic {
                 addWithSaturation(track.recordLoopStartSample, shiftSamples);
                 addWithSaturation(track.recordLoopEndSample, shiftSamples);
                 addWithSaturation(track.loopTakeRangeStartSample, shiftSamples);
-                DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+                DawClipSystemLogic::RefreshTrackFromClips(daw, track);
             }
 
             for (auto& track : midi->tracks) {
@@ -330,7 +329,7 @@ namespace DawTimelineRebaseLogic {
             addWithSaturation(track.recordLoopStartSample, shiftSamples);
             addWithSaturation(track.recordLoopEndSample, shiftSamples);
             addWithSaturation(track.loopTakeRangeStartSample, shiftSamples);
-            DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+            DawClipSystemLogic::RefreshTrackFromClips(daw, track);
         }
 
         for (auto& track : daw.automationTracks) {
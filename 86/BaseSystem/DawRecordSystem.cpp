@@ -0,0 +1,399 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "BaseSystem/WavStreamWriter.h"
+
+namespace DawWaveformSystemLogic {
+    void UpdateWaveformRange(DawContext& daw, DawTrack& track, size_t startSample, size_t endSample);
+    void TrimRecordPreview(DawTrack& track);
+}
+
+// One armed track's take. The recorder thread drains the track's record rings
+// into `writer`; the frames it wrote are also queued in preview* for the main
+// thread's live waveform. `mutex` is held while the take touches its file, so
+// the recorder thread and FinishTakes/Abort* never write it at the same time.
+struct DawRecordTake {
+    std::mutex mutex;
+    jack_ringbuffer_t* ringLeft = nullptr;
+    jack_ringbuffer_t* ringRight = nullptr;
+    bool stereo = false;
+    std::string path;
+    WavStreamWriter writer;
+    bool failed = false;
+    bool closed = false;
+    uint64_t framesWritten = 0;
+    uint64_t writeFailedFrames = 0;
+    std::chrono::steady_clock::time_point lastHeaderFixup;
+    std::vector<float> scratchLeft;
+    std::vector<float> scratchRight;
+    std::vector<float> previewLeft;
+    std::vector<float> previewRight;
+};
+
+// `mutex` only guards the `takes` list and the thread flags; it is never held
+// across a disk write. The recorder thread snapshots the list and drains each
+// take under its own mutex.
+struct DawDiskRecorder {
+    std::mutex mutex;
+    std::mutex previewMutex;
+    std::condition_variable cv;
+    std::thread worker;
+    bool running = false;
+    bool stop = false;
+    std::vector<std::shared_ptr<DawRecordTake>> takes;
+    uint64_t takeCounter = 0;
+    // Finished takes handed to tracks (main thread only). Their files belong
+    // to this process and are swept once no clip plays from them.
+    std::vector<std::string> keptTakes;
+
+    ~DawDiskRecorder() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+};
+
+namespace DawRecordSystemLogic {
+
+    namespace {
+        constexpr auto kDrainInterval = std::chrono::milliseconds(10);
+        constexpr auto kHeaderFixupInterval = std::chrono::seconds(1);
+        constexpr size_t kDrainChunkFrames = 8192;
+
+        std::filesystem::path takeDirectory(const DawContext& daw) {
+            std::error_code ec;
+            std::filesystem::path dir = daw.mirrorAvailable
+                ? std::filesystem::path(daw.mirrorPath) / "recordings"
+                : std::filesystem::temp_directory_path(ec) / "salamander_recordings";
+            std::filesystem::create_directories(dir, ec);
+            return dir;
+        }
+
+        // Caller holds take.mutex. Moves whatever the audio thread has produced
+        // so far from the rings to disk. A stereo take reads the same number of
+        // frames from both rings; anything one ring holds beyond the other stays
+        // there for the next pass, so the channels never slip against each other.
+        void drainTake(DawDiskRecorder& recorder, DawRecordTake& take) {
+            if (!take.ringLeft || take.closed) return;
+            while (true) {
+                size_t frames = jack_ringbuffer_read_space(take.ringLeft) / sizeof(float);
+                if (take.stereo) {
+                    frames = std::min(frames, jack_ringbuffer_read_space(take.ringRight) / sizeof(float));
+                }
+                if (frames == 0) break;
+                frames = std::min(frames, kDrainChunkFrames);
+                if (take.scratchLeft.size() < frames) take.scratchLeft.resize(frames);
+                jack_ringbuffer_read(take.ringLeft,
+                                     reinterpret_cast<char*>(take.scratchLeft.data()),
+                                     frames * sizeof(float));
+                if (take.stereo) {
+                    if (take.scratchRight.size() < frames) take.scratchRight.resize(frames);
+                    jack_ringbuffer_read(take.ringRight,
+                                         reinterpret_cast<char*>(take.scratchRight.data()),
+                                         frames * sizeof(float));
+                } else if (take.ringRight) {
+                    size_t rightFrames = jack_ringbuffer_read_space(take.ringRight) / sizeof(float);
+                    jack_ringbuffer_read_advance(take.ringRight, rightFrames * sizeof(float));
+                }
+
+                if (!take.failed) {
+                    if (take.writer.writePlanar(take.scratchLeft.data(),
+                                                take.stereo ? take.scratchRight.data() : nullptr,
+                                                frames)) {
+                        take.framesWritten += frames;
+                    } else {
+                        take.failed = true;
+                        std::cerr << "DawRecordSystem: write failed for " << take.path << "\n";
+                    }
+                }
+                if (take.failed) {
+                    take.writeFailedFrames += frames;
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> previewLock(recorder.previewMutex);
+                take.previewLeft.insert(take.previewLeft.end(),
+                                        take.scratchLeft.begin(),
+                                        take.scratchLeft.begin() + static_cast<std::ptrdiff_t>(frames));
+                if (take.stereo) {
+                    take.previewRight.insert(take.previewRight.end(),
+                                             take.scratchRight.begin(),
+                                             take.scratchRight.begin() + static_cast<std::ptrdiff_t>(frames));
+                }
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (!take.failed && now - take.lastHeaderFixup >= kHeaderFixupInterval) {
+                // Keeps the partial file playable if the process dies mid-take.
+                take.writer.updateHeader();
+                take.lastHeaderFixup = now;
+            }
+        }
+
+        void ensureRecorderThread(DawDiskRecorder& recorder) {
+            if (recorder.running) return;
+            recorder.stop = false;
+            recorder.running = true;
+            recorder.worker = std::thread([&recorder]() {
+                std::vector<std::shared_ptr<DawRecordTake>> snapshot;
+                std::unique_lock<std::mutex> lock(recorder.mutex);
+                while (!recorder.stop) {
+                    snapshot = recorder.takes;
+                    lock.unlock();
+                    for (auto& take : snapshot) {
+                        std::lock_guard<std::mutex> takeLock(take->mutex);
+                        drainTake(recorder, *take);
+                    }
+                    // A take finished meanwhile is released here, after its
+                    // owner has closed it.
+                    snapshot.clear();
+                    lock.lock();
+                    recorder.cv.wait_for(lock, kDrainInterval, [&recorder]() { return recorder.stop; });
+                }
+            });
+        }
+
+        // Takes the whole list away from the recorder thread; a drain already
+        // in flight finishes under the take's own mutex.
+        std::vector<std::shared_ptr<DawRecordTake>> detachTakes(DawDiskRecorder& recorder) {
+            std::vector<std::shared_ptr<DawRecordTake>> takes;
+            std::lock_guard<std::mutex> lock(recorder.mutex);
+            takes.swap(recorder.takes);
+            return takes;
+        }
+
+        // Caller holds take.mutex.
+        void discardTake(DawRecordTake& take) {
+            take.writer.close();
+            take.closed = true;
+            std::error_code ec;
+            if (!take.path.empty()) std::filesystem::remove(take.path, ec);
+        }
+
+        DawTrack* findTrackForTake(DawContext& daw, const DawRecordTake& take) {
+            for (auto& track : daw.tracks) {
+                if (track.recordRing && track.recordRing == take.ringLeft) return &track;
+            }
+            return nullptr;
+        }
+    }
+
+    void WriteRecordInputRT(DawTrack& track, const float* left, const float* right, size_t frames) {
+        // Both rings take the same frames, or neither does: the drain pairs
+        // them up by position, so a frame lost on one side only would shift
+        // the channels for the rest of the take.
+        size_t space = jack_ringbuffer_write_space(track.recordRing) / sizeof(float);
+        if (track.recordRingRight) {
+            space = std::min(space, jack_ringbuffer_write_space(track.recordRingRight) / sizeof(float));
+        }
+        const size_t written = std::min(frames, space);
+        if (written > 0) {
+            jack_ringbuffer_write(track.recordRing, reinterpret_cast<const char*>(left), written * sizeof(float));
+            if (track.recordRingRight) {
+                jack_ringbuffer_write(track.recordRingRight,
+                                      reinterpret_cast<const char*>(right ? right : left),
+                                      written * sizeof(float));
+            }
+        }
+        if (written < frames) {
+            track.recordDroppedFrames.fetch_add(frames - written, std::memory_order_relaxed);
+        }
+    }
+
+    bool BeginTakes(DawContext& daw) {
+        if (!daw.diskRecorder) daw.diskRecorder = std::make_shared<DawDiskRecorder>();
+        DawDiskRecorder& recorder = *daw.diskRecorder;
+        for (auto& take : detachTakes(recorder)) {
+            std::lock_guard<std::mutex> takeLock(take->mutex);
+            discardTake(*take);
+        }
+
+        const std::filesystem::path dir = takeDirectory(daw);
+        const uint32_t sampleRate = static_cast<uint32_t>(std::max(1.0f, daw.sampleRate));
+        const auto stamp = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        bool allOpened = true;
+        std::vector<std::shared_ptr<DawRecordTake>> takes;
+        for (size_t i = 0; i < daw.tracks.size(); ++i) {
+            DawTrack& track = daw.tracks[i];
+            track.recordTakePath.clear();
+            track.recordTakeFrames = 0;
+            if (!track.recordingActive || !track.recordRing) continue;
+            track.recordDroppedFrames.store(0, std::memory_order_relaxed);
+            auto take = std::make_shared<DawRecordTake>();
+            take->ringLeft = track.recordRing;
+            take->ringRight = track.recordRingRight;
+            take->stereo = track.stereoInputPair12 && track.recordRingRight;
+            recorder.takeCounter += 1;
+            take->path = (dir / ("take_" + std::to_string(stamp) + "_" + std::to_string(recorder.takeCounter)
+                                 + "_track" + std::to_string(i + 1) + ".wav")).string();
+            // RF64 space is always reserved: a take's final length is unknown.
+            if (!take->writer.open(take->path, take->stereo ? 2 : 1, sampleRate, true)) {
+                std::cerr << "DawRecordSystem: failed to open " << take->path << "\n";
+                take->failed = true;
+                allOpened = false;
+            }
+            take->lastHeaderFixup = std::chrono::steady_clock::now();
+            takes.push_back(std::move(take));
+        }
+        if (!takes.empty()) {
+            std::lock_guard<std::mutex> lock(recorder.mutex);
+            recorder.takes = std::move(takes);
+            ensureRecorderThread(recorder);
+        }
+        return allOpened;
+    }
+
+    void FinishTakes(DawContext& daw) {
+        if (!daw.diskRecorder) return;
+        DawDiskRecorder& recorder = *daw.diskRecorder;
+        for (auto& take : detachTakes(recorder)) {
+            std::lock_guard<std::mutex> takeLock(take->mutex);
+            drainTake(recorder, *take);
+            const bool closed = take->writer.close();
+            take->closed = true;
+            DawTrack* track = findTrackForTake(daw, *take);
+            const uint64_t ringDropped = track ? track->recordDroppedFrames.load(std::memory_order_relaxed) : 0;
+            const uint64_t dropped = ringDropped + take->writeFailedFrames;
+            if (dropped > 0) {
+                std::cerr << "DawRecordSystem: " << take->path << " lost " << dropped << " frame(s) ("
+                          << ringDropped << " ring overflow, " << take->writeFailedFrames << " disk)\n";
+            }
+            if (!track || take->failed || !closed || take->framesWritten == 0) {
+                discardTake(*take);
+                continue;
+            }
+            track->recordTakePath = take->path;
+            track->recordTakeFrames = take->framesWritten;
+            recorder.keptTakes.push_back(take->path);
+        }
+    }
+
+    void AbortTakes(DawContext& daw) {
+        if (!daw.diskRecorder) return;
+        for (auto& take : detachTakes(*daw.diskRecorder)) {
+            std::lock_guard<std::mutex> takeLock(take->mutex);
+            discardTake(*take);
+        }
+    }
+
+    void AbortTrackTake(DawContext& daw, const DawTrack& track) {
+        if (!daw.diskRecorder || !track.recordRing) return;
+        DawDiskRecorder& recorder = *daw.diskRecorder;
+        std::shared_ptr<DawRecordTake> take;
+        {
+            std::lock_guard<std::mutex> lock(recorder.mutex);
+            auto it = std::find_if(recorder.takes.begin(), recorder.takes.end(),
+                                   [&track](const std::shared_ptr<DawRecordTake>& candidate) {
+                                       return candidate->ringLeft == track.recordRing;
+                                   });
+            if (it == recorder.takes.end()) return;
+            take = std::move(*it);
+            recorder.takes.erase(it);
+        }
+        std::lock_guard<std::mutex> takeLock(take->mutex);
+        discardTake(*take);
+    }
+
+    void DrainRecordPreview(DawContext& daw) {
+        if (!daw.diskRecorder) return;
+        DawDiskRecorder& recorder = *daw.diskRecorder;
+        // Only the main thread changes `takes`, so it is walked without
+        // recorder.mutex.
+        std::vector<float> left;
+        std::vector<float> right;
+        for (auto& take : recorder.takes) {
+            {
+                std::lock_guard<std::mutex> previewLock(recorder.previewMutex);
+                left.swap(take->previewLeft);
+                right.swap(take->previewRight);
+            }
+            DawTrack* track = findTrackForTake(daw, *take);
+            if (track && !left.empty()) {
+                const size_t oldSize = track->pendingRecord.size();
+                track->pendingRecord.insert(track->pendingRecord.end(), left.begin(), left.end());
+                if (take->stereo) {
+                    track->pendingRecordRight.resize(oldSize, 0.0f);
+                    track->pendingRecordRight.insert(track->pendingRecordRight.end(), right.begin(), right.end());
+                }
+                const size_t start = static_cast<size_t>(track->recordStartSample + track->pendingRecordBase + oldSize);
+                DawWaveformSystemLogic::UpdateWaveformRange(daw, *track, start, start + left.size());
+                DawWaveformSystemLogic::TrimRecordPreview(*track);
+            }
+            left.clear();
+            right.clear();
+        }
+    }
+
+    // Main thread. Deletes the files of finished takes no clip plays from any
+    // more (discarded, undone or replaced by a session load); saved sessions
+    // hold their own copies. keepReferenced false drops every one of them.
+    void SweepTakeFiles(DawContext& daw, bool keepReferenced) {
+        if (!daw.diskRecorder) return;
+        DawDiskRecorder& recorder = *daw.diskRecorder;
+        if (recorder.keptTakes.empty()) return;
+        std::unordered_set<std::string> inUse;
+        if (keepReferenced) {
+            auto markClips = [&](const std::vector<DawClip>& clips) {
+                for (const auto& clip : clips) {
+                    if (clip.audioId < 0 || clip.audioId >= static_cast<int>(daw.clipAudio.size())) continue;
+                    const DawClipAudio& audio = daw.clipAudio[static_cast<size_t>(clip.audioId)];
+                    if (audio.isStreamed()) inUse.insert(DawStreamSystemLogic::StreamSourcePath(daw, audio));
+                }
+            };
+            for (const auto& track : daw.tracks) {
+                markClips(track.clips);
+                markClips(track.loopTakeClips);
+                if (!track.recordTakePath.empty()) inUse.insert(track.recordTakePath);
+            }
+        }
+        std::unordered_set<std::string> removed;
+        auto swept = std::remove_if(recorder.keptTakes.begin(), recorder.keptTakes.end(),
+                                    [&inUse, &removed](const std::string& path) {
+                                        if (inUse.count(path) != 0) return false;
+                                        std::error_code ec;
+                                        std::filesystem::remove(path, ec);
+                                        removed.insert(path);
+                                        return true;
+                                    });
+        if (keepReferenced && !removed.empty()) {
+            // No clip plays from these pool entries any more; hand their
+            // stream slots back.
+            std::lock_guard<std::mutex> lock(daw.trackMutex);
+            for (auto& audio : daw.clipAudio) {
+                if (audio.isStreamed() && removed.count(DawStreamSystemLogic::StreamSourcePath(daw, audio)) != 0) {
+                    DawStreamSystemLogic::ReleaseStream(daw, audio);
+                }
+            }
+        }
+        recorder.keptTakes.erase(swept, recorder.keptTakes.end());
+    }
+
+    void ShutdownRecorder(DawContext& daw) {
+        if (!daw.diskRecorder) return;
+        AbortTakes(daw);
+        SweepTakeFiles(daw, false);
+        DawDiskRecorder& recorder = *daw.diskRecorder;
+        {
+            std::lock_guard<std::mutex> lock(recorder.mutex);
+            recorder.stop = true;
+        }
+        recorder.cv.notify_all();
+        if (recorder.worker.joinable()) recorder.worker.join();
+        recorder.running = false;
+    }
+}
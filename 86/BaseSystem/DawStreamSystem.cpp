@@ -0,0 +1,682 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem& baseSystem, const std::string& key, int fallback);
+}
+
+// A memory-mapped 32-bit float WAV (RIFF or RF64). Frames stay interleaved in
+// the mapping; the prefetch thread deinterleaves them into cache pages.
+struct DawSampleStreamFile {
+    std::string path;
+    int fd = -1;
+    void* mapping = nullptr;
+    size_t mappingBytes = 0;
+    const float* samples = nullptr;
+    uint16_t channels = 1;
+    uint32_t sampleRate = 0;
+    uint64_t frames = 0;
+    uint64_t pageCount = 0;
+    // Page owner key. Unlike the stream id, which is recycled, it is unique
+    // per open, so a page left over from a released file never matches.
+    uint32_t serial = 0;
+    std::unique_ptr<std::atomic<int32_t>[]> pageSlots;
+
+    ~DawSampleStreamFile() {
+        if (mapping && mapping != MAP_FAILED) munmap(mapping, mappingBytes);
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+// One fixed-size slot of the page cache. `sequence` is a seqlock: it is odd
+// while the prefetch thread refills the slot, so the audio thread can detect a
+// torn read without taking a lock.
+struct DawSampleCachePage {
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<int64_t> owner{-1};
+    std::atomic<uint64_t> lastUse{0};
+    uint64_t pinnedPass = 0;
+    DawSampleStreamFile* ownerFile = nullptr;
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+struct DawStreamSpan {
+    int streamId = -1;
+    uint64_t timelineStart = 0;
+    uint64_t length = 0;
+    uint64_t sourceOffset = 0;
+    bool operator==(const DawStreamSpan& other) const {
+        return streamId == other.streamId && timelineStart == other.timelineStart
+            && length == other.length && sourceOffset == other.sourceOffset;
+    }
+};
+
+// What one prefetch pass reads: a copy of the state the main thread publishes,
+// taken under DawSampleCache::mutex so the pass itself can run unlocked.
+struct DawStreamPrefetchWindow {
+    std::vector<DawStreamSpan> spans;
+    uint64_t spansVersion = 0;
+    uint64_t readAheadFrames = 0;
+    bool loopEnabled = false;
+    uint64_t loopStart = 0;
+    uint64_t loopEnd = 0;
+};
+
+struct DawStreamPageRequest {
+    int32_t streamId = -1;
+    uint32_t page = 0;
+};
+
+struct DawSampleCache {
+    static constexpr int kMaxStreams = 1024;
+    static constexpr uint32_t kPageFrames = 8192;
+    static constexpr int kMaxPagesPerPass = 32;
+
+    // Live files by stream id, null when the id is free. A released file is
+    // moved to `retired` and freed by the prefetch thread once it has dropped
+    // the file's pages, so a release never waits for a pass.
+    std::array<std::atomic<DawSampleStreamFile*>, kMaxStreams> streams{};
+    std::atomic<int> liveStreams{0};
+    std::unique_ptr<DawSampleCachePage[]> pages;
+    int pageCount = 0;
+    jack_ringbuffer_t* missRing = nullptr;
+    std::atomic<uint64_t> useClock{1};
+    std::atomic<uint64_t> underrunBlocks{0};
+    std::atomic<uint64_t> underrunFrames{0};
+    std::atomic<uint64_t> missRingOverflows{0};
+    uint64_t reportedUnderrunBlocks = 0;
+    double lastUnderrunReportTime = -1.0;
+
+    // Prefetch thread state; spans/loop/readAhead and the id bookkeeping are
+    // guarded by `mutex`, which the worker only holds to copy them between
+    // passes.
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<int> freeStreamIds;
+    int nextStreamId = 0;
+    uint32_t nextSerial = 1;
+    std::vector<std::unique_ptr<DawSampleStreamFile>> retired;
+    std::thread worker;
+    bool running = false;
+    bool stop = false;
+    uint64_t pass = 0;
+    std::vector<DawStreamSpan> spans;
+    uint64_t spansVersion = 0;
+    uint64_t readAheadFrames = 0;
+    bool loopEnabled = false;
+    uint64_t loopStart = 0;
+    uint64_t loopEnd = 0;
+    const std::atomic<uint64_t>* playhead = nullptr;
+
+    ~DawSampleCache() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+        for (auto& slot : streams) delete slot.exchange(nullptr);
+        if (missRing) {
+            jack_ringbuffer_free(missRing);
+            missRing = nullptr;
+        }
+    }
+};
+
+namespace DawStreamSystemLogic {
+
+    namespace {
+        int64_t pageKey(uint32_t serial, uint64_t page) {
+            return (static_cast<int64_t>(serial) << 32) | static_cast<int64_t>(page & 0xFFFFFFFFull);
+        }
+
+        DawSampleStreamFile* liveStream(const DawSampleCache& cache, int streamId) {
+            if (streamId < 0 || streamId >= DawSampleCache::kMaxStreams) return nullptr;
+            return cache.streams[static_cast<size_t>(streamId)].load(std::memory_order_acquire);
+        }
+
+        bool parseMappedWav(DawSampleStreamFile& file) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(file.mapping);
+            const size_t size = file.mappingBytes;
+            if (size < 12) return false;
+            const bool isRiff = std::memcmp(bytes, "RIFF", 4) == 0;
+            const bool isRf64 = std::memcmp(bytes, "RF64", 4) == 0;
+            if ((!isRiff && !isRf64) || std::memcmp(bytes + 8, "WAVE", 4) != 0) return false;
+
+            uint16_t audioFormat = 0;
+            uint16_t bitsPerSample = 0;
+            uint64_t ds64DataSize = 0;
+            bool fmtFound = false;
+            size_t pos = 12;
+            while (pos + 8 <= size) {
+                const uint8_t* chunk = bytes + pos;
+                uint32_t chunkSize = 0;
+                std::memcpy(&chunkSize, chunk + 4, sizeof(chunkSize));
+                const size_t body = pos + 8;
+                if (std::memcmp(chunk, "ds64", 4) == 0 && body + 16 <= size) {
+                    std::memcpy(&ds64DataSize, bytes + body + 8, sizeof(ds64DataSize));
+                } else if (std::memcmp(chunk, "fmt ", 4) == 0 && body + 16 <= size) {
+                    std::memcpy(&audioFormat, bytes + body, sizeof(audioFormat));
+                    std::memcpy(&file.channels, bytes + body + 2, sizeof(file.channels));
+                    std::memcpy(&file.sampleRate, bytes + body + 4, sizeof(file.sampleRate));
+                    std::memcpy(&bitsPerSample, bytes + body + 14, sizeof(bitsPerSample));
+                    fmtFound = true;
+                } else if (std::memcmp(chunk, "data", 4) == 0) {
+                    if (!fmtFound) return false;
+                    if (audioFormat != 3 || bitsPerSample != 32) return false;
+                    if (file.channels != 1 && file.channels != 2) return false;
+                    uint64_t dataBytes = (isRf64 && chunkSize == 0xFFFFFFFFu) ? ds64DataSize : chunkSize;
+                    dataBytes = std::min<uint64_t>(dataBytes, size - body);
+                    file.samples = reinterpret_cast<const float*>(bytes + body);
+                    file.frames = dataBytes / (sizeof(float) * file.channels);
+                    return file.frames > 0;
+                }
+                pos = body + chunkSize + (chunkSize & 1u);
+            }
+            return false;
+        }
+
+        void copyFromMapping(const DawSampleStreamFile& file,
+                             uint64_t frameOffset,
+                             size_t count,
+                             float* outL,
+                             float* outR) {
+            size_t available = 0;
+            if (frameOffset < file.frames) {
+                available = static_cast<size_t>(std::min<uint64_t>(count, file.frames - frameOffset));
+            }
+            const float* src = file.samples + frameOffset * file.channels;
+            if (file.channels == 1) {
+                std::memcpy(outL, src, available * sizeof(float));
+                if (outR) std::memcpy(outR, src, available * sizeof(float));
+            } else {
+                for (size_t i = 0; i < available; ++i) {
+                    outL[i] = src[i * 2];
+                    if (outR) outR[i] = src[i * 2 + 1];
+                }
+            }
+            if (available < count) {
+                std::fill(outL + available, outL + count, 0.0f);
+                if (outR) std::fill(outR + available, outR + count, 0.0f);
+            }
+        }
+
+        // Drops the pages of released files, then frees them. Runs on the
+        // prefetch thread between passes, or on the releasing thread when no
+        // prefetch thread is running.
+        void reclaimRetired(DawSampleCache& cache, std::vector<std::unique_ptr<DawSampleStreamFile>>& files) {
+            if (files.empty()) return;
+            for (int i = 0; i < cache.pageCount; ++i) {
+                DawSampleCachePage& page = cache.pages[i];
+                if (!page.ownerFile) continue;
+                for (const auto& file : files) {
+                    if (page.ownerFile != file.get()) continue;
+                    page.sequence.fetch_add(1, std::memory_order_acq_rel);
+                    page.owner.store(-1, std::memory_order_relaxed);
+                    page.sequence.fetch_add(1, std::memory_order_release);
+                    page.lastUse.store(0, std::memory_order_relaxed);
+                    page.pinnedPass = 0;
+                    page.ownerFile = nullptr;
+                    break;
+                }
+            }
+            files.clear();
+        }
+
+        // Caller holds cache.mutex. The id can be handed out again at once:
+        // pages are keyed by the file's serial, not by the id.
+        void retireStream(DawSampleCache& cache, int streamId) {
+            if (streamId < 0 || streamId >= DawSampleCache::kMaxStreams) return;
+            DawSampleStreamFile* file = cache.streams[static_cast<size_t>(streamId)].exchange(nullptr, std::memory_order_acq_rel);
+            if (!file) return;
+            cache.retired.emplace_back(file);
+            cache.freeStreamIds.push_back(streamId);
+            cache.liveStreams.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void finishRelease(DawSampleCache& cache) {
+            std::vector<std::unique_ptr<DawSampleStreamFile>> files;
+            {
+                std::lock_guard<std::mutex> lock(cache.mutex);
+                if (cache.running) {
+                    cache.cv.notify_one();
+                    return;
+                }
+                files.swap(cache.retired);
+            }
+            reclaimRetired(cache, files);
+        }
+
+        void drainMissRing(DawSampleCache& cache, std::vector<DawStreamPageRequest>* out) {
+            if (!cache.missRing) return;
+            DawStreamPageRequest request;
+            while (jack_ringbuffer_read_space(cache.missRing) >= sizeof(request)) {
+                jack_ringbuffer_read(cache.missRing, reinterpret_cast<char*>(&request), sizeof(request));
+                if (out) out->push_back(request);
+            }
+        }
+
+        // Prefetch thread only. Makes sure `page` of `streamId` is resident and
+        // pinned for this pass, evicting the least recently used unpinned slot.
+        bool ensurePage(DawSampleCache& cache, int streamId, uint64_t page) {
+            DawSampleStreamFile* file = liveStream(cache, streamId);
+            if (!file || page >= file->pageCount) return false;
+            const int64_t key = pageKey(file->serial, page);
+
+            int32_t resident = file->pageSlots[page].load(std::memory_order_acquire);
+            if (resident >= 0 && cache.pages[resident].owner.load(std::memory_order_relaxed) == key) {
+                cache.pages[resident].pinnedPass = cache.pass;
+                return true;
+            }
+
+            int victim = -1;
+            uint64_t oldestUse = UINT64_MAX;
+            for (int i = 0; i < cache.pageCount; ++i) {
+                const DawSampleCachePage& candidate = cache.pages[i];
+                if (candidate.pinnedPass == cache.pass) continue;
+                if (candidate.owner.load(std::memory_order_relaxed) < 0) {
+                    victim = i;
+                    break;
+                }
+                uint64_t use = candidate.lastUse.load(std::memory_order_relaxed);
+                if (use < oldestUse) {
+                    oldestUse = use;
+                    victim = i;
+                }
+            }
+            if (victim < 0) return false;
+
+            DawSampleCachePage& slot = cache.pages[victim];
+            int64_t oldKey = slot.owner.load(std::memory_order_relaxed);
+            if (oldKey >= 0 && slot.ownerFile) {
+                uint64_t oldPage = static_cast<uint64_t>(oldKey & 0xFFFFFFFFll);
+                if (oldPage < slot.ownerFile->pageCount) {
+                    slot.ownerFile->pageSlots[oldPage].store(-1, std::memory_order_release);
+                }
+            }
+
+            slot.sequence.fetch_add(1, std::memory_order_acq_rel);
+            slot.owner.store(key, std::memory_order_relaxed);
+            slot.ownerFile = file;
+            std::atomic_thread_fence(std::memory_order_release);
+            copyFromMapping(*file,
+                            page * DawSampleCache::kPageFrames,
+                            DawSampleCache::kPageFrames,
+                            slot.left.data(),
+                            slot.right.data());
+            slot.sequence.fetch_add(1, std::memory_order_release);
+            slot.lastUse.store(cache.useClock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            slot.pinnedPass = cache.pass;
+            file->pageSlots[page].store(victim, std::memory_order_release);
+            return true;
+        }
+
+        void prefetchSourceRange(DawSampleCache& cache, int streamId, uint64_t srcStart, uint64_t srcEnd, int& budget) {
+            if (srcEnd <= srcStart) return;
+            uint64_t firstPage = srcStart / DawSampleCache::kPageFrames;
+            uint64_t lastPage = (srcEnd - 1) / DawSampleCache::kPageFrames;
+            for (uint64_t page = firstPage; page <= lastPage && budget > 0; ++page) {
+                if (!ensurePage(cache, streamId, page)) return;
+                budget -= 1;
+            }
+        }
+
+        void prefetchWindow(DawSampleCache& cache,
+                            const std::vector<DawStreamSpan>& spans,
+                            uint64_t windowStart,
+                            uint64_t windowEnd,
+                            int& budget) {
+            for (const auto& span : spans) {
+                uint64_t spanEnd = span.timelineStart + span.length;
+                if (spanEnd <= windowStart || span.timelineStart >= windowEnd) continue;
+                uint64_t overlapStart = std::max(span.timelineStart, windowStart);
+                uint64_t overlapEnd = std::min(spanEnd, windowEnd);
+                uint64_t srcStart = span.sourceOffset + (overlapStart - span.timelineStart);
+                prefetchSourceRange(cache, span.streamId, srcStart, srcStart + (overlapEnd - overlapStart), budget);
+                if (budget <= 0) return;
+            }
+        }
+
+        // Prefetch thread only, with the cache mutex released.
+        void runPrefetchPass(DawSampleCache& cache, const DawStreamPrefetchWindow& window) {
+            cache.pass += 1;
+            int budget = DawSampleCache::kMaxPagesPerPass;
+
+            // Pages the audio thread missed are serviced first: after a seek
+            // they are exactly what the next callback needs.
+            thread_local std::vector<DawStreamPageRequest> requests;
+            requests.clear();
+            drainMissRing(cache, &requests);
+            for (const auto& request : requests) {
+                if (budget <= 0) break;
+                if (ensurePage(cache, request.streamId, request.page)) budget -= 1;
+            }
+
+            if (!cache.playhead || window.readAheadFrames == 0) return;
+            const uint64_t playhead = cache.playhead->load(std::memory_order_relaxed);
+            uint64_t windowEnd = playhead + window.readAheadFrames;
+            if (window.loopEnabled && window.loopEnd > window.loopStart
+                && playhead >= window.loopStart && playhead < window.loopEnd && windowEnd > window.loopEnd) {
+                uint64_t wrapped = windowEnd - window.loopEnd;
+                prefetchWindow(cache, window.spans, playhead, window.loopEnd, budget);
+                prefetchWindow(cache, window.spans, window.loopStart, window.loopStart + wrapped, budget);
+            } else {
+                prefetchWindow(cache, window.spans, playhead, windowEnd, budget);
+            }
+            cache.useClock.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void ensurePrefetchThread(DawSampleCache& cache) {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            if (cache.running) return;
+            cache.stop = false;
+            cache.running = true;
+            cache.worker = std::thread([&cache]() {
+                DawStreamPrefetchWindow window;
+                std::vector<std::unique_ptr<DawSampleStreamFile>> released;
+                std::unique_lock<std::mutex> lock(cache.mutex);
+                while (!cache.stop) {
+                    released.swap(cache.retired);
+                    if (window.spansVersion != cache.spansVersion) {
+                        window.spans = cache.spans;
+                        window.spansVersion = cache.spansVersion;
+                    }
+                    window.readAheadFrames = cache.readAheadFrames;
+                    window.loopEnabled = cache.loopEnabled;
+                    window.loopStart = cache.loopStart;
+                    window.loopEnd = cache.loopEnd;
+                    // Page copies can fault from disk; publishSpans, opens and
+                    // releases must not wait on them.
+                    lock.unlock();
+                    reclaimRetired(cache, released);
+                    runPrefetchPass(cache, window);
+                    lock.lock();
+                    cache.cv.wait_for(lock, std::chrono::milliseconds(4), [&cache]() { return cache.stop; });
+                }
+            });
+        }
+
+        DawSampleCache& ensureCache(DawContext& daw) {
+            if (!daw.sampleCache) {
+                auto cache = std::make_shared<DawSampleCache>();
+                cache->pageCount = std::max(4, daw.streamCachePages);
+                cache->pages = std::make_unique<DawSampleCachePage[]>(static_cast<size_t>(cache->pageCount));
+                for (int i = 0; i < cache->pageCount; ++i) {
+                    cache->pages[i].left.assign(DawSampleCache::kPageFrames, 0.0f);
+                    cache->pages[i].right.assign(DawSampleCache::kPageFrames, 0.0f);
+                }
+                cache->missRing = jack_ringbuffer_create(sizeof(DawStreamPageRequest) * 1024);
+                cache->playhead = &daw.playheadSample;
+                daw.sampleCache = std::move(cache);
+            }
+            return *daw.sampleCache;
+        }
+
+        void requestPageRT(DawSampleCache& cache, int streamId, uint64_t page) {
+            if (!cache.missRing) return;
+            DawStreamPageRequest request;
+            request.streamId = streamId;
+            request.page = static_cast<uint32_t>(page);
+            if (jack_ringbuffer_write_space(cache.missRing) < sizeof(request)) {
+                cache.missRingOverflows.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            jack_ringbuffer_write(cache.missRing, reinterpret_cast<const char*>(&request), sizeof(request));
+        }
+
+        bool readPageRT(DawSampleCache& cache,
+                        const DawSampleStreamFile& file,
+                        uint64_t page,
+                        size_t within,
+                        size_t count,
+                        float* outL,
+                        float* outR) {
+            int32_t slotIndex = file.pageSlots[page].load(std::memory_order_acquire);
+            if (slotIndex < 0 || slotIndex >= cache.pageCount) return false;
+            DawSampleCachePage& slot = cache.pages[slotIndex];
+            const uint32_t seq = slot.sequence.load(std::memory_order_acquire);
+            if ((seq & 1u) != 0u) return false;
+            if (slot.owner.load(std::memory_order_relaxed) != pageKey(file.serial, page)) return false;
+            std::memcpy(outL, slot.left.data() + within, count * sizeof(float));
+            std::memcpy(outR, slot.right.data() + within, count * sizeof(float));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != seq) return false;
+            slot.lastUse.store(cache.useClock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return true;
+        }
+
+        void publishSpans(DawContext& daw, DawSampleCache& cache) {
+            thread_local std::vector<DawStreamSpan> spans;
+            spans.clear();
+            for (const auto& track : daw.tracks) {
+                for (const auto& clip : track.clips) {
+                    if (clip.length == 0) continue;
+                    if (clip.audioId < 0 || clip.audioId >= static_cast<int>(daw.clipAudio.size())) continue;
+                    const DawClipAudio& data = daw.clipAudio[static_cast<size_t>(clip.audioId)];
+                    if (!data.isStreamed()) continue;
+                    DawStreamSpan span;
+                    span.streamId = data.streamId;
+                    span.timelineStart = clip.startSample;
+                    span.length = clip.length;
+                    span.sourceOffset = clip.sourceOffset;
+                    spans.push_back(span);
+                }
+            }
+            const double sampleRate = (daw.sampleRate > 0.0f) ? static_cast<double>(daw.sampleRate) : 44100.0;
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            if (cache.spans != spans) {
+                cache.spans = spans;
+                cache.spansVersion += 1;
+            }
+            cache.readAheadFrames = static_cast<uint64_t>(std::max(0.0, daw.streamReadAheadSeconds) * sampleRate);
+            cache.loopEnabled = daw.loopEnabled.load(std::memory_order_relaxed);
+            cache.loopStart = daw.loopStartSamples;
+            cache.loopEnd = daw.loopEndSamples;
+        }
+    }
+
+    bool OpenStreamedClipAudio(DawContext& daw, const std::string& path, DawClipAudio& outClip, uint32_t& outRate) {
+        DawSampleCache& cache = ensureCache(daw);
+        auto file = std::make_unique<DawSampleStreamFile>();
+        file->path = path;
+        file->fd = ::open(path.c_str(), O_RDONLY);
+        if (file->fd < 0) return false;
+        struct stat info {};
+        if (fstat(file->fd, &info) != 0 || info.st_size <= 0) return false;
+        file->mappingBytes = static_cast<size_t>(info.st_size);
+        file->mapping = mmap(nullptr, file->mappingBytes, PROT_READ, MAP_PRIVATE, file->fd, 0);
+        if (file->mapping == MAP_FAILED) {
+            file->mapping = nullptr;
+            return false;
+        }
+        madvise(file->mapping, file->mappingBytes, MADV_SEQUENTIAL);
+        if (!parseMappedWav(*file)) return false;
+        file->pageCount = (file->frames + DawSampleCache::kPageFrames - 1) / DawSampleCache::kPageFrames;
+        file->pageSlots = std::make_unique<std::atomic<int32_t>[]>(static_cast<size_t>(file->pageCount));
+        for (uint64_t i = 0; i < file->pageCount; ++i) {
+            file->pageSlots[i].store(-1, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        int streamId = -1;
+        if (!cache.freeStreamIds.empty()) {
+            streamId = cache.freeStreamIds.back();
+            cache.freeStreamIds.pop_back();
+        } else if (cache.nextStreamId < DawSampleCache::kMaxStreams) {
+            streamId = cache.nextStreamId++;
+        } else {
+            std::cerr << "DawStreamSystem: all " << DawSampleCache::kMaxStreams
+                      << " stream slots are in use; loading " << path << " into memory instead\n";
+            return false;
+        }
+        file->serial = cache.nextSerial;
+        cache.nextSerial = (cache.nextSerial % 0x7FFFFFFFu) + 1u;
+        outRate = file->sampleRate;
+        outClip.channels = file->channels;
+        outClip.left.clear();
+        outClip.right.clear();
+        outClip.streamId = streamId;
+        outClip.streamFrames = file->frames;
+        cache.streams[static_cast<size_t>(streamId)].store(file.release(), std::memory_order_release);
+        cache.liveStreams.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void ReleaseStream(DawContext& daw, DawClipAudio& clipAudio) {
+        if (!daw.sampleCache || !clipAudio.isStreamed()) return;
+        DawSampleCache& cache = *daw.sampleCache;
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            retireStream(cache, clipAudio.streamId);
+        }
+        clipAudio.streamId = -1;
+        clipAudio.streamFrames = 0;
+        finishRelease(cache);
+    }
+
+    void ReleaseStreams(DawContext& daw) {
+        if (!daw.sampleCache) return;
+        DawSampleCache& cache = *daw.sampleCache;
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            for (int i = 0; i < cache.nextStreamId; ++i) {
+                retireStream(cache, i);
+            }
+            cache.spans.clear();
+            cache.spansVersion += 1;
+        }
+        finishRelease(cache);
+    }
+
+    size_t ReadStreamFramesRT(DawContext& daw,
+                              const DawClipAudio& clipAudio,
+                              uint64_t frameOffset,
+                              size_t count,
+                              float* outL,
+                              float* outR) {
+        DawSampleCache* cache = daw.sampleCache.get();
+        const int streamId = clipAudio.streamId;
+        const DawSampleStreamFile* live = cache ? liveStream(*cache, streamId) : nullptr;
+        if (!live) {
+            std::fill(outL, outL + count, 0.0f);
+            std::fill(outR, outR + count, 0.0f);
+            return 0;
+        }
+        const DawSampleStreamFile& file = *live;
+        size_t served = 0;
+        size_t done = 0;
+        uint64_t lastMissPage = UINT64_MAX;
+        while (done < count) {
+            const uint64_t pos = frameOffset + done;
+            const uint64_t page = pos / DawSampleCache::kPageFrames;
+            const size_t within = static_cast<size_t>(pos % DawSampleCache::kPageFrames);
+            const size_t n = std::min<size_t>(count - done, DawSampleCache::kPageFrames - within);
+            if (page < file.pageCount && readPageRT(*cache, file, page, within, n, outL + done, outR + done)) {
+                served += n;
+            } else {
+                std::fill(outL + done, outL + done + n, 0.0f);
+                std::fill(outR + done, outR + done + n, 0.0f);
+                if (page < file.pageCount && page != lastMissPage) {
+                    requestPageRT(*cache, streamId, page);
+                    lastMissPage = page;
+                }
+            }
+            done += n;
+        }
+        if (served < count) {
+            cache->underrunBlocks.fetch_add(1, std::memory_order_relaxed);
+            cache->underrunFrames.fetch_add(count - served, std::memory_order_relaxed);
+        }
+        return served;
+    }
+
+    bool ReadStreamFrames(DawContext& daw,
+                          const DawClipAudio& clipAudio,
+                          uint64_t frameOffset,
+                          size_t count,
+                          float* outL,
+                          float* outR) {
+        DawSampleCache* cache = daw.sampleCache.get();
+        const DawSampleStreamFile* file = cache ? liveStream(*cache, clipAudio.streamId) : nullptr;
+        if (!file) {
+            std::fill(outL, outL + count, 0.0f);
+            if (outR) std::fill(outR, outR + count, 0.0f);
+            return false;
+        }
+        copyFromMapping(*file, frameOffset, count, outL, outR);
+        return true;
+    }
+
+    std::string StreamSourcePath(const DawContext& daw, const DawClipAudio& clipAudio) {
+        const DawSampleCache* cache = daw.sampleCache.get();
+        const DawSampleStreamFile* file = cache ? liveStream(*cache, clipAudio.streamId) : nullptr;
+        return file ? file->path : std::string();
+    }
+
+    void UpdateDawStreaming(BaseSystem& baseSystem, std::vector<Entity>&, float, GLFWwindow*) {
+        if (!baseSystem.daw) return;
+        DawContext& daw = *baseSystem.daw;
+        if (!daw.streamConfigLoaded) {
+            daw.streamConfigLoaded = true;
+            daw.streamCachePages = RenderInitSystemLogic::getRegistryInt(baseSystem, "dawStreamCachePages", daw.streamCachePages);
+            int thresholdMb = RenderInitSystemLogic::getRegistryInt(baseSystem, "dawStreamThresholdMB",
+                                                                    static_cast<int>(daw.streamThresholdBytes >> 20));
+            daw.streamThresholdBytes = static_cast<uint64_t>(std::max(0, thresholdMb)) << 20;
+            int readAheadMs = RenderInitSystemLogic::getRegistryInt(baseSystem, "dawStreamReadAheadMs",
+                                                                    static_cast<int>(daw.streamReadAheadSeconds * 1000.0));
+            daw.streamReadAheadSeconds = static_cast<double>(std::max(0, readAheadMs)) / 1000.0;
+        }
+        if (!daw.sampleCache) return;
+        DawSampleCache& cache = *daw.sampleCache;
+        if (cache.liveStreams.load(std::memory_order_acquire) == 0) return;
+        ensurePrefetchThread(cache);
+        publishSpans(daw, cache);
+        cache.cv.notify_one();
+
+        const uint64_t underruns = cache.underrunBlocks.load(std::memory_order_relaxed);
+        const double now = glfwGetTime();
+        if (underruns != cache.reportedUnderrunBlocks && now - cache.lastUnderrunReportTime >= 1.0) {
+            std::cerr << "DawStreamSystem: " << (underruns - cache.reportedUnderrunBlocks)
+                      << " streaming underrun(s), " << cache.underrunFrames.load(std::memory_order_relaxed)
+                      << " frames zero-filled in total\n";
+            cache.reportedUnderrunBlocks = underruns;
+            cache.lastUnderrunReportTime = now;
+        }
+    }
+
+    void CleanupDawStreaming(BaseSystem& baseSystem, std::vector<Entity>&, float, GLFWwindow*) {
+        if (!baseSystem.daw || !baseSystem.daw->sampleCache) return;
+        DawSampleCache& cache = *baseSystem.daw->sampleCache;
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            cache.stop = true;
+        }
+        cache.cv.notify_all();
+        if (cache.worker.joinable()) cache.worker.join();
+        std::vector<std::unique_ptr<DawSampleStreamFile>> files;
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            cache.running = false;
+            files.swap(cache.retired);
+        }
+        reclaimRetired(cache, files);
+    }
+}
@@ -27,6 +27,11 @@ namespace DawIOSystemLogic {
     void LoadTracksIfAvailable(DawContext& daw);
     void LoadMetronomeSample(DawContext& daw);
     void WriteTrackAt(DawContext& daw, int trackIndex);
+    void ShutdownAutosave();
+}
+namespace DawRecordSystemLogic {
+    void AbortTrackTake(DawContext& daw, const DawTrack& track);
+    void ShutdownRecorder(DawContext& daw);
 }
 
 namespace DawTrackSystemLogic {
@@ -370,6 +375,7 @@ namespace DawTrackSystemLogic {
             } else if (desired < current) {
                 int oldCount = current;
                 for (int i = current - 1; i >= desired; --i) {
+                    DawRecordSystemLogic::AbortTrackTake(daw, daw.tracks[static_cast<size_t>(i)]);
                     cleanupTrack(daw.tracks[static_cast<size_t>(i)]);
                 }
                 daw.tracks.erase(daw.tracks.begin() + desired, daw.tracks.end());
@@ -390,6 +396,7 @@ namespace DawTrackSystemLogic {
             if (baseSystem.vst3) {
                 Vst3SystemLogic::RemoveAudioTrackChain(*baseSystem.vst3, trackIndex);
             }
+            DawRecordSystemLogic::AbortTrackTake(daw, daw.tracks[static_cast<size_t>(trackIndex)]);
             cleanupTrack(daw.tracks[static_cast<size_t>(trackIndex)]);
             daw.tracks.erase(daw.tracks.begin() + trackIndex);
             daw.trackCount = getTrackCount(daw);
@@ -514,7 +521,7 @@ namespace DawTrackSystemLogic {
         AudioContext& audio = *baseSystem.audio;
         UIContext& ui = *baseSystem.ui;
 
-        if (!daw.initialized && audio.client) {
+        if (!daw.initialized && (audio.client || audio.offlineDriver)) {
             initializeDaw(daw, audio);
         }
         if (!daw.initialized) return;
@@ -657,10 +664,9 @@ namespace DawTrackSystemLogic {
             for (int i = 0; i < getTrackCount(daw); ++i) {
                 auto& track = daw.tracks[static_cast<size_t>(i)];
                 if (!track.clearPending) continue;
-                track.audio.clear();
-                track.audioRight.clear();
                 track.pendingRecord.clear();
                 track.pendingRecordRight.clear();
+                track.pendingRecordBase = 0;
                 track.clips.clear();
                 track.loopTakeClips.clear();
                 track.waveformMin.clear();
@@ -675,6 +681,7 @@ namespace DawTrackSystemLogic {
                 track.loopTakeRangeStartSample = 0;
                 track.loopTakeRangeLength = 0;
                 track.recordLoopCapture = false;
+                DawRecordSystemLogic::AbortTrackTake(daw, track);
                 if (track.recordRing) {
                     jack_ringbuffer_reset(track.recordRing);
                 }
@@ -730,6 +737,9 @@ namespace DawTrackSystemLogic {
     void CleanupDawTracks(BaseSystem& baseSystem, std::vector<Entity>&, float, GLFWwindow*) {
         if (!baseSystem.daw) return;
         DawContext& daw = *baseSystem.daw;
+        DawIOSystemLogic::CancelStemExport(baseSystem, true);
+        DawIOSystemLogic::ShutdownAutosave();
+        DawRecordSystemLogic::ShutdownRecorder(daw);
         for (auto& track : daw.tracks) {
             if (track.recordRing) {
                 jack_ringbuffer_free(track.recordRing);
@@ -15,8 +15,11 @@ namespace DawIOSystemLogic {
     void TickStemExport(BaseSystem& baseSystem, float dt);
     void EnsureThemeState(BaseSystem& baseSystem);
 }
-namespace DawWaveformSystemLogic {
-    void UpdateWaveformRange(DawTrack& track, size_t startSample, size_t endSample);
+namespace DawRecordSystemLogic {
+    bool BeginTakes(DawContext& daw);
+    void FinishTakes(DawContext& daw);
+    void AbortTakes(DawContext& daw);
+    void DrainRecordPreview(DawContext& daw);
 }
 namespace DawUiSystemLogic {
     void ClampTimelineOffset(DawContext& daw);
@@ -41,47 +44,11 @@ namespace DawTransportSystemLogic {
             return false;
         }
 
-        bool hasRingData(const DawContext& daw) {
-            for (const auto& track : daw.tracks) {
-                if (!track.recordRing) continue;
-                if (jack_ringbuffer_read_space(track.recordRing) > 0) return true;
-            }
-            return false;
-        }
-
-        void drainRecordRings(DawContext& daw) {
-            for (auto& track : daw.tracks) {
-                if (!track.recordRing) continue;
-                size_t bytes = jack_ringbuffer_read_space(track.recordRing);
-                if (bytes == 0) continue;
-                size_t frames = bytes / sizeof(float);
-                if (frames == 0) continue;
-                size_t oldSize = track.pendingRecord.size();
-                track.pendingRecord.resize(oldSize + frames);
-                jack_ringbuffer_read(track.recordRing,
-                                     reinterpret_cast<char*>(track.pendingRecord.data() + oldSize),
-                                     frames * sizeof(float));
-                if (track.stereoInputPair12 && track.recordRingRight) {
-                    size_t rightBytes = jack_ringbuffer_read_space(track.recordRingRight);
-                    size_t rightFrames = rightBytes / sizeof(float);
-                    size_t readRight = std::min(frames, rightFrames);
-                    size_t oldRight = track.pendingRecordRight.size();
-                    track.pendingRecordRight.resize(oldRight + frames, 0.0f);
-                    if (readRight > 0) {
-                        jack_ringbuffer_read(track.recordRingRight,
-                                             reinterpret_cast<char*>(track.pendingRecordRight.data() + oldRight),
-                                             readRight * sizeof(float));
-                    }
-                }
-                size_t start = static_cast<size_t>(track.recordStartSample + oldSize);
-                size_t end = static_cast<size_t>(track.recordStartSample + track.pendingRecord.size());
-                DawWaveformSystemLogic::UpdateWaveformRange(track, start, end);
-            }
-        }
-
         void startRecording(DawContext& daw, uint64_t playhead) {
             bool loopCapture = daw.loopEnabled.load(std::memory_order_relaxed)
                 && daw.loopEndSamples > daw.loopStartSamples;
+            // The recorder thread must let go of the rings before they are reset.
+            DawRecordSystemLogic::AbortTakes(daw);
             for (auto& track : daw.tracks) {
                 int armMode = track.armMode.load(std::memory_order_relaxed);
                 bool enable = (armMode > 0);
@@ -99,6 +66,7 @@ namespace DawTransportSystemLogic {
                 track.recordArmMode = armMode;
                 track.pendingRecord.clear();
                 track.pendingRecordRight.clear();
+                track.pendingRecordBase = 0;
                 if (track.recordRing) {
                     jack_ringbuffer_reset(track.recordRing);
                 }
@@ -106,6 +74,7 @@ namespace DawTransportSystemLogic {
                     jack_ringbuffer_reset(track.recordRingRight);
                 }
             }
+            DawRecordSystemLogic::BeginTakes(daw);
         }
 
         void stopRecording(DawContext& daw) {
@@ -141,7 +110,7 @@ namespace DawTransportSystemLogic {
         DawIOSystemLogic::EnsureThemeState(baseSystem);
 
         DawIOSystemLogic::TickStemExport(baseSystem, dt);
-        drainRecordRings(daw);
+        DawRecordSystemLogic::DrainRecordPreview(daw);
 
         if (ui.active && ui.actionDelayFrames == 0 && !ui.pendingActionType.empty()) {
             if (ui.pendingActionType == "DawTransport") {
@@ -281,7 +250,8 @@ namespace DawTransportSystemLogic {
 
         if (daw.recordStopPending) {
             if (!daw.transportPlaying.load(std::memory_order_relaxed) &&
-                daw.audioThreadIdle.load(std::memory_order_relaxed) && !hasRingData(daw)) {
+                daw.audioThreadIdle.load(std::memory_order_relaxed)) {
+                DawRecordSystemLogic::FinishTakes(daw);
                 DawClipSystemLogic::MergePendingRecords(daw);
                 DawIOSystemLogic::WriteTracksIfNeeded(daw);
                 daw.recordStopPending = false;
@@ -125,7 +125,7 @@ namespace DawUiSystemLogic {
             uint64_t maxSamples = daw.playheadSample.load(std::memory_order_relaxed);
             maxSamples = std::max<uint64_t>(maxSamples, daw.loopEndSamples);
             for (const auto& track : daw.tracks) {
-                maxSamples = std::max<uint64_t>(maxSamples, static_cast<uint64_t>(track.audio.size()));
+                maxSamples = std::max<uint64_t>(maxSamples, DawClipSystemLogic::TrackEndSample(track));
             }
             return maxSamples;
         }
@@ -221,6 +221,7 @@ namespace DawUiSystemLogic {
                 added = true;
             }
             if (added) {
+                level.worlds[screenWorldIndex].instanceEdits += 1;
                 if (baseSystem.ui) baseSystem.ui->buttonCacheBuilt = false;
                 if (baseSystem.font) baseSystem.font->textCacheBuilt = false;
                 daw.uiCacheBuilt = false;
@@ -3,12 +3,16 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 namespace DawWaveformSystemLogic {
 
     namespace {
         constexpr size_t kWaveformBlockSize = 256;
+        constexpr unsigned kWaveformBlockShift = 8;
+        static_assert((size_t(1) << kWaveformBlockShift) == kWaveformBlockSize, "block shift mismatch");
+        static_assert(kWaveformBlockSize == DawWaveformPyramid::kBaseBlockFrames, "pyramid base block mismatch");
         constexpr int kFrequencyStepsPerColor = 23;
         constexpr int kFrequencyBaseColorCount = 4;
         constexpr int kFrequencyTotalSteps = kFrequencyStepsPerColor * (kFrequencyBaseColorCount - 1);
@@ -48,41 +52,81 @@ namespace DawWaveformSystemLogic {
             return { a.r * b.r - a.i * b.i, a.r * b.i + a.i * b.r };
         }
 
-        void fft(std::vector<Complex>& data) {
-            size_t n = data.size();
-            if (n <= 1) return;
+        Complex conj(const Complex& a) {
+            return { a.r, -a.i };
+        }
 
-            std::vector<Complex> even(n / 2), odd(n / 2);
-            for (size_t i = 0; i < n / 2; ++i) {
-                even[i] = data[2 * i];
-                odd[i] = data[2 * i + 1];
-            }
-            fft(even);
-            fft(odd);
-            for (size_t k = 0; k < n / 2; ++k) {
-                float angle = -2.0f * 3.14159265358979f * static_cast<float>(k) / static_cast<float>(n);
-                Complex wk = { std::cos(angle), std::sin(angle) };
-                Complex temp = mul(wk, odd[k]);
-                data[k] = add(even[k], temp);
-                data[k + n / 2] = sub(even[k], temp);
+        // Real FFT of one waveform block: the kSize real samples are packed
+        // into a kHalf-point complex FFT (evens real, odds imaginary), run
+        // iteratively in place, then split back into the real spectrum.
+        struct RealFftPlan {
+            static constexpr size_t kSize = kWaveformBlockSize;
+            static constexpr size_t kHalf = kSize / 2;
+            std::array<float, kSize> window{};
+            std::array<Complex, kHalf / 2> twiddle{};
+            std::array<Complex, kHalf> split{};
+            std::array<uint16_t, kHalf> bitReverse{};
+
+            RealFftPlan() {
+                const double twoPi = 6.283185307179586;
+                for (size_t n = 0; n < kSize; ++n) {
+                    window[n] = static_cast<float>(0.5 - 0.5 * std::cos(twoPi * static_cast<double>(n) / static_cast<double>(kSize)));
+                }
+                for (size_t k = 0; k < kHalf / 2; ++k) {
+                    double angle = -twoPi * static_cast<double>(k) / static_cast<double>(kHalf);
+                    twiddle[k] = { static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)) };
+                }
+                for (size_t k = 0; k < kHalf; ++k) {
+                    double angle = -twoPi * static_cast<double>(k) / static_cast<double>(kSize);
+                    split[k] = { static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)) };
+                }
+                size_t bits = 0;
+                while ((size_t(1) << bits) < kHalf) ++bits;
+                for (size_t i = 0; i < kHalf; ++i) {
+                    size_t r = 0;
+                    for (size_t b = 0; b < bits; ++b) {
+                        if (i & (size_t(1) << b)) r |= size_t(1) << (bits - 1 - b);
+                    }
+                    bitReverse[i] = static_cast<uint16_t>(r);
+                }
             }
+        };
+
+        const RealFftPlan& realFftPlan() {
+            static const RealFftPlan plan;
+            return plan;
         }
 
-        float computeDominantFrequency(const float* samples,
-                                       size_t sampleCount,
-                                       float sampleRate,
-                                       std::vector<Complex>& buffer) {
-            if (sampleCount == 0) return 0.0f;
-            if (buffer.size() != sampleCount) buffer.resize(sampleCount);
-            for (size_t i = 0; i < sampleCount; ++i) {
-                buffer[i] = { samples[i], 0.0f };
+        float computeDominantFrequency(const float* samples, float sampleRate) {
+            const RealFftPlan& plan = realFftPlan();
+            constexpr size_t kHalf = RealFftPlan::kHalf;
+            std::array<Complex, kHalf> z;
+            for (size_t n = 0; n < kHalf; ++n) {
+                z[plan.bitReverse[n]] = { samples[2 * n] * plan.window[2 * n],
+                                          samples[2 * n + 1] * plan.window[2 * n + 1] };
+            }
+            for (size_t len = 2; len <= kHalf; len <<= 1) {
+                const size_t halfLen = len / 2;
+                const size_t step = kHalf / len;
+                for (size_t i = 0; i < kHalf; i += len) {
+                    for (size_t k = 0; k < halfLen; ++k) {
+                        Complex u = z[i + k];
+                        Complex v = mul(z[i + k + halfLen], plan.twiddle[k * step]);
+                        z[i + k] = add(u, v);
+                        z[i + k + halfLen] = sub(u, v);
+                    }
+                }
             }
-            fft(buffer);
-            size_t half = sampleCount / 2;
             float maxMagSq = 0.0f;
             size_t maxIdx = 0;
-            for (size_t k = 1; k < half; ++k) {
-                float magSq = buffer[k].r * buffer[k].r + buffer[k].i * buffer[k].i;
+            for (size_t k = 1; k < kHalf; ++k) {
+                Complex zk = z[k];
+                Complex zn = conj(z[kHalf - k]);
+                Complex even = { 0.5f * (zk.r + zn.r), 0.5f * (zk.i + zn.i) };
+                // (zk - zn) / 2i
+                Complex odd = { 0.5f * (zk.i - zn.i), -0.5f * (zk.r - zn.r) };
+                Complex x = add(even, mul(plan.split[k], odd));
+                float magSq = x.r * x.r + x.i * x.i;
                 if (magSq > maxMagSq) {
                     maxMagSq = magSq;
                     maxIdx = k;
@@ -90,7 +134,7 @@ namespace DawWaveformSystemLogic {
             }
             if (maxMagSq <= kFrequencySilenceThreshold) return 0.0f;
             if (sampleRate <= 0.0f) sampleRate = 44100.0f;
-            return (sampleRate * static_cast<float>(maxIdx)) / static_cast<float>(sampleCount);
+            return (sampleRate * static_cast<float>(maxIdx)) / static_cast<float>(RealFftPlan::kSize);
         }
 
         glm::vec3 frequencyToColor(float freq) {
@@ -110,86 +154,221 @@ namespace DawWaveformSystemLogic {
             const glm::vec3& b = kFrequencyBaseColors[colorSegment + 1];
             return glm::vec3(lerp(a.x, b.x, t), lerp(a.y, b.y, t), lerp(a.z, b.z, t));
         }
+
+        constexpr uint64_t kPyramidFramesPerUpdate = uint64_t(1) << 21;
+        constexpr size_t kPyramidChunkBlocks = 64;
+
+        void allocatePyramid(DawWaveformPyramid& pyramid, uint64_t totalFrames) {
+            pyramid.levels.clear();
+            pyramid.totalFrames = totalFrames;
+            pyramid.builtFrames = 0;
+            size_t blocks = static_cast<size_t>((totalFrames + kWaveformBlockSize - 1) / kWaveformBlockSize);
+            while (blocks > 0) {
+                DawWaveformLevel level;
+                level.minL.assign(blocks, 0.0f);
+                level.maxL.assign(blocks, 0.0f);
+                level.minR.assign(blocks, 0.0f);
+                level.maxR.assign(blocks, 0.0f);
+                level.rmsL.assign(blocks, 0.0f);
+                level.rmsR.assign(blocks, 0.0f);
+                level.color.assign(blocks, kWaveformFallbackColor);
+                pyramid.levels.push_back(std::move(level));
+                if (blocks == 1) break;
+                blocks = (blocks + 1) / 2;
+            }
+        }
+
+        void readClipFrames(DawContext& daw,
+                            const DawClipAudio& clipAudio,
+                            uint64_t start,
+                            size_t count,
+                            float* outL,
+                            float* outR) {
+            if (clipAudio.isStreamed()) {
+                DawStreamSystemLogic::ReadStreamFrames(daw, clipAudio, start, count, outL, outR);
+                return;
+            }
+            const bool stereo = clipAudio.channels > 1;
+            for (size_t i = 0; i < count; ++i) {
+                const size_t src = static_cast<size_t>(start + i);
+                const float left = (src < clipAudio.left.size()) ? clipAudio.left[src] : 0.0f;
+                outL[i] = left;
+                outR[i] = (stereo && src < clipAudio.right.size()) ? clipAudio.right[src] : left;
+            }
+        }
+
+        uint64_t blockFramesAt(const DawWaveformPyramid& pyramid, size_t level, size_t index) {
+            const uint64_t span = uint64_t(kWaveformBlockSize) << level;
+            const uint64_t start = static_cast<uint64_t>(index) * span;
+            if (start >= pyramid.totalFrames) return 0;
+            return std::min<uint64_t>(span, pyramid.totalFrames - start);
+        }
+
+        void updateBaseBlocks(DawContext& daw, DawClipAudio& clipAudio, size_t firstBlock, size_t endBlock) {
+            DawWaveformPyramid& pyramid = clipAudio.waveform;
+            DawWaveformLevel& base = pyramid.levels[0];
+            std::vector<float> left(kPyramidChunkBlocks * kWaveformBlockSize);
+            std::vector<float> right(kPyramidChunkBlocks * kWaveformBlockSize);
+            std::array<float, kWaveformBlockSize> mono{};
+            for (size_t chunk = firstBlock; chunk < endBlock; chunk += kPyramidChunkBlocks) {
+                const size_t chunkEnd = std::min(endBlock, chunk + kPyramidChunkBlocks);
+                const uint64_t chunkStart = static_cast<uint64_t>(chunk) * kWaveformBlockSize;
+                const uint64_t chunkFrames = std::min<uint64_t>(
+                    static_cast<uint64_t>(chunkEnd - chunk) * kWaveformBlockSize, pyramid.totalFrames - chunkStart);
+                readClipFrames(daw, clipAudio, chunkStart, static_cast<size_t>(chunkFrames), left.data(), right.data());
+                for (size_t block = chunk; block < chunkEnd; ++block) {
+                    const size_t offset = (block - chunk) * kWaveformBlockSize;
+                    const size_t frames = static_cast<size_t>(blockFramesAt(pyramid, 0, block));
+                    float minL = 1.0f;
+                    float maxL = -1.0f;
+                    float minR = 1.0f;
+                    float maxR = -1.0f;
+                    double sumL = 0.0;
+                    double sumR = 0.0;
+                    for (size_t i = 0; i < frames; ++i) {
+                        const float l = left[offset + i];
+                        const float r = right[offset + i];
+                        minL = std::min(minL, l);
+                        maxL = std::max(maxL, l);
+                        minR = std::min(minR, r);
+                        maxR = std::max(maxR, r);
+                        sumL += static_cast<double>(l) * l;
+                        sumR += static_cast<double>(r) * r;
+                        mono[i] = 0.5f * (l + r);
+                    }
+                    if (frames == 0) {
+                        minL = maxL = minR = maxR = 0.0f;
+                        base.color[block] = kWaveformFallbackColor;
+                    } else {
+                        for (size_t i = frames; i < kWaveformBlockSize; ++i) {
+                            mono[i] = mono[frames - 1];
+                        }
+                        float domFreq = computeDominantFrequency(mono.data(), daw.sampleRate);
+                        base.color[block] = (domFreq <= 0.0f) ? kWaveformFallbackColor : frequencyToColor(domFreq);
+                    }
+                    base.minL[block] = minL;
+                    base.maxL[block] = maxL;
+                    base.minR[block] = minR;
+                    base.maxR[block] = maxR;
+                    base.rmsL[block] = frames ? static_cast<float>(std::sqrt(sumL / static_cast<double>(frames))) : 0.0f;
+                    base.rmsR[block] = frames ? static_cast<float>(std::sqrt(sumR / static_cast<double>(frames))) : 0.0f;
+                }
+            }
+        }
+
+        // Recomputes parents of base blocks [firstBlock, endBlock) level by level.
+        void propagatePyramid(DawWaveformPyramid& pyramid, size_t firstBlock, size_t endBlock) {
+            for (size_t level = 1; level < pyramid.levels.size(); ++level) {
+                const DawWaveformLevel& child = pyramid.levels[level - 1];
+                DawWaveformLevel& parent = pyramid.levels[level];
+                firstBlock /= 2;
+                endBlock = std::min(parent.minL.size(), (endBlock + 1) / 2);
+                for (size_t i = firstBlock; i < endBlock; ++i) {
+                    const size_t a = i * 2;
+                    const size_t b = a + 1;
+                    parent.minL[i] = child.minL[a];
+                    parent.maxL[i] = child.maxL[a];
+                    parent.minR[i] = child.minR[a];
+                    parent.maxR[i] = child.maxR[a];
+                    parent.rmsL[i] = child.rmsL[a];
+                    parent.rmsR[i] = child.rmsR[a];
+                    parent.color[i] = child.color[a];
+                    if (b >= child.minL.size()) continue;
+                    const double wa = static_cast<double>(blockFramesAt(pyramid, level - 1, a));
+                    const double wb = static_cast<double>(blockFramesAt(pyramid, level - 1, b));
+                    parent.minL[i] = std::min(child.minL[a], child.minL[b]);
+                    parent.maxL[i] = std::max(child.maxL[a], child.maxL[b]);
+                    parent.minR[i] = std::min(child.minR[a], child.minR[b]);
+                    parent.maxR[i] = std::max(child.maxR[a], child.maxR[b]);
+                    const double wsum = std::max(1.0, wa + wb);
+                    parent.rmsL[i] = static_cast<float>(std::sqrt((child.rmsL[a] * child.rmsL[a] * wa
+                                                                   + child.rmsL[b] * child.rmsL[b] * wb) / wsum));
+                    parent.rmsR[i] = static_cast<float>(std::sqrt((child.rmsR[a] * child.rmsR[a] * wa
+                                                                   + child.rmsR[b] * child.rmsR[b] * wb) / wsum));
+                    // The louder half decides the colour of the coarser block.
+                    parent.color[i] = (child.rmsL[b] + child.rmsR[b] > child.rmsL[a] + child.rmsR[a])
+                        ? child.color[b]
+                        : child.color[a];
+                }
+            }
+        }
     }
 
-    void RebuildWaveform(DawTrack& track, float sampleRate) {
+    // The per-track waveform now only carries the live recording preview;
+    // committed audio is drawn from each clip's pyramid.
+    void ClearRecordPreview(DawTrack& track) {
         track.waveformMin.clear();
         track.waveformMax.clear();
         track.waveformMinRight.clear();
         track.waveformMaxRight.clear();
         track.waveformColor.clear();
-        if (track.audio.empty() && track.audioRight.empty()) {
-            track.waveformVersion += 1;
-            return;
-        }
-        size_t frameCount = std::max(track.audio.size(), track.audioRight.size());
-        size_t blockCount = (frameCount + kWaveformBlockSize - 1) / kWaveformBlockSize;
-        track.waveformMin.assign(blockCount, 0.0f);
-        track.waveformMax.assign(blockCount, 0.0f);
-        track.waveformMinRight.assign(blockCount, 0.0f);
-        track.waveformMaxRight.assign(blockCount, 0.0f);
-        track.waveformColor.assign(blockCount, kWaveformFallbackColor);
-        std::vector<float> fftSamples(kWaveformBlockSize, 0.0f);
-        std::vector<Complex> fftBuffer(kWaveformBlockSize);
-        for (size_t block = 0; block < blockCount; ++block) {
-            size_t start = block * kWaveformBlockSize;
-            size_t end = std::min(start + kWaveformBlockSize, frameCount);
-            float minValL = 1.0f;
-            float maxValL = -1.0f;
-            float minValR = 1.0f;
-            float maxValR = -1.0f;
-            for (size_t i = start; i < end; ++i) {
-                float left = (i < track.audio.size()) ? track.audio[i] : 0.0f;
-                float right = (i < track.audioRight.size()) ? track.audioRight[i] : left;
-                minValL = std::min(minValL, left);
-                maxValL = std::max(maxValL, left);
-                minValR = std::min(minValR, right);
-                maxValR = std::max(maxValR, right);
-            }
-            if (end == start) {
-                minValL = 0.0f;
-                maxValL = 0.0f;
-                minValR = 0.0f;
-                maxValR = 0.0f;
-            }
-            track.waveformMin[block] = minValL;
-            track.waveformMax[block] = maxValL;
-            track.waveformMinRight[block] = minValR;
-            track.waveformMaxRight[block] = maxValR;
+        track.waveformVersion += 1;
+    }
 
-            if (end == start) {
-                track.waveformColor[block] = kWaveformFallbackColor;
-                continue;
-            }
-            for (size_t i = 0; i < kWaveformBlockSize; ++i) {
-                size_t sampleIndex = start + i;
-                if (sampleIndex < end) {
-                    float left = (sampleIndex < track.audio.size()) ? track.audio[sampleIndex] : 0.0f;
-                    float right = (sampleIndex < track.audioRight.size()) ? track.audioRight[sampleIndex] : left;
-                    fftSamples[i] = 0.5f * (left + right);
-                } else if (end > start) {
-                    size_t tail = end - 1;
-                    float left = (tail < track.audio.size()) ? track.audio[tail] : 0.0f;
-                    float right = (tail < track.audioRight.size()) ? track.audioRight[tail] : left;
-                    fftSamples[i] = 0.5f * (left + right);
-                }
-            }
-            float domFreq = computeDominantFrequency(fftSamples.data(), fftSamples.size(), sampleRate, fftBuffer);
-            if (domFreq <= 0.0f) {
-                track.waveformColor[block] = kWaveformFallbackColor;
-            } else {
-                track.waveformColor[block] = frequencyToColor(domFreq);
+    void UpdateClipWaveformRange(DawContext& daw, DawClipAudio& clipAudio, uint64_t startFrame, uint64_t endFrame) {
+        const uint64_t totalFrames = clipAudio.frameCount();
+        DawWaveformPyramid& pyramid = clipAudio.waveform;
+        if (pyramid.totalFrames != totalFrames || pyramid.levels.empty()) {
+            allocatePyramid(pyramid, totalFrames);
+        }
+        endFrame = std::min(endFrame, totalFrames);
+        if (endFrame <= startFrame) return;
+        const size_t firstBlock = static_cast<size_t>(startFrame / kWaveformBlockSize);
+        const size_t endBlock = static_cast<size_t>((endFrame + kWaveformBlockSize - 1) / kWaveformBlockSize);
+        updateBaseBlocks(daw, clipAudio, firstBlock, endBlock);
+        propagatePyramid(pyramid, firstBlock, endBlock);
+        if (startFrame <= pyramid.builtFrames) {
+            pyramid.builtFrames = std::max(pyramid.builtFrames, endFrame);
+        }
+        daw.clipWaveformVersion += 1;
+    }
+
+    bool QueryClipWaveform(const DawClipAudio& clipAudio, uint64_t startFrame, uint64_t endFrame, DawWaveformSpan& out) {
+        const DawWaveformPyramid& pyramid = clipAudio.waveform;
+        if (pyramid.levels.empty()) return false;
+        endFrame = std::min(endFrame, pyramid.builtFrames);
+        if (endFrame <= startFrame) return false;
+        const uint64_t span = endFrame - startFrame;
+        size_t level = 0;
+        while (level + 1 < pyramid.levels.size() && (uint64_t(kWaveformBlockSize) << (level + 1)) <= span) {
+            ++level;
+        }
+        const DawWaveformLevel& data = pyramid.levels[level];
+        const unsigned shift = static_cast<unsigned>(level) + kWaveformBlockShift;
+        const size_t first = static_cast<size_t>(startFrame >> shift);
+        const size_t last = std::min(data.minL.size() - 1, static_cast<size_t>((endFrame - 1) >> shift));
+        out.minL = data.minL[first];
+        out.maxL = data.maxL[first];
+        out.minR = data.minR[first];
+        out.maxR = data.maxR[first];
+        float sumSqL = 0.0f;
+        float sumSqR = 0.0f;
+        float loudest = -1.0f;
+        for (size_t i = first; i <= last; ++i) {
+            out.minL = std::min(out.minL, data.minL[i]);
+            out.maxL = std::max(out.maxL, data.maxL[i]);
+            out.minR = std::min(out.minR, data.minR[i]);
+            out.maxR = std::max(out.maxR, data.maxR[i]);
+            sumSqL += data.rmsL[i] * data.rmsL[i];
+            sumSqR += data.rmsR[i] * data.rmsR[i];
+            const float loudness = data.rmsL[i] + data.rmsR[i];
+            if (loudness > loudest) {
+                loudest = loudness;
+                out.color = data.color[i];
             }
         }
-        track.waveformVersion += 1;
+        const float count = static_cast<float>(last - first + 1);
+        out.rmsL = std::sqrt(sumSqL / count);
+        out.rmsR = std::sqrt(sumSqR / count);
+        return true;
     }
 
-    void UpdateWaveformRange(DawTrack& track, size_t startSample, size_t endSample) {
-        size_t recordedStart = static_cast<size_t>(track.recordStartSample);
+    void UpdateWaveformRange(DawContext& daw, DawTrack& track, size_t startSample, size_t endSample) {
+        size_t recordedStart = static_cast<size_t>(track.recordStartSample + track.pendingRecordBase);
         size_t recordedEnd = recordedStart + track.pendingRecord.size();
         size_t recordedEndRight = recordedStart + track.pendingRecordRight.size();
-        size_t combinedLength = std::max(std::max(track.audio.size(), track.audioRight.size()),
-                                         std::max(recordedEnd, recordedEndRight));
+        size_t clipEnd = static_cast<size_t>(DawClipSystemLogic::TrackEndSample(track));
+        size_t combinedLength = std::max(clipEnd, std::max(recordedEnd, recordedEndRight));
         if (combinedLength == 0 || endSample <= startSample) return;
 
         size_t blockCount = (combinedLength + kWaveformBlockSize - 1) / kWaveformBlockSize;
@@ -202,6 +381,13 @@ namespace DawWaveformSystemLogic {
         size_t blockStart = startSample / kWaveformBlockSize;
         size_t blockEnd = (endSample + kWaveformBlockSize - 1) / kWaveformBlockSize;
         blockEnd = std::min(blockEnd, blockCount);
+        if (blockEnd <= blockStart) return;
+        // Existing clip audio under the take, read for just the blocks touched.
+        const size_t baseStart = blockStart * kWaveformBlockSize;
+        const size_t baseCount = std::min(blockEnd * kWaveformBlockSize, combinedLength) - baseStart;
+        std::vector<float> baseLeft(baseCount);
+        std::vector<float> baseRight(baseCount);
+        DawClipSystemLogic::RenderTrackRange(daw, track, baseStart, baseCount, baseLeft.data(), baseRight.data());
         for (size_t block = blockStart; block < blockEnd; ++block) {
             size_t sampleStart = block * kWaveformBlockSize;
             size_t sampleEnd = std::min(sampleStart + kWaveformBlockSize, combinedLength);
@@ -210,8 +396,8 @@ namespace DawWaveformSystemLogic {
             float minValR = 1.0f;
             float maxValR = -1.0f;
             for (size_t i = sampleStart; i < sampleEnd; ++i) {
-                float baseL = (i < track.audio.size()) ? track.audio[i] : 0.0f;
-                float baseR = (i < track.audioRight.size()) ? track.audioRight[i] : baseL;
+                float baseL = baseLeft[i - baseStart];
+                float baseR = baseRight[i - baseStart];
                 float recL = 0.0f;
                 float recR = 0.0f;
                 if (i >= recordedStart && i < recordedEnd) {
@@ -247,6 +433,43 @@ namespace DawWaveformSystemLogic {
         track.waveformVersion += 1;
     }
 
-    void UpdateDawWaveforms(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*) {
+    // Drops preview samples whose waveform blocks are final, keeping the block
+    // the next UpdateWaveformRange call will extend.
+    void TrimRecordPreview(DawTrack& track) {
+        const uint64_t recordedStart = track.recordStartSample + track.pendingRecordBase;
+        const uint64_t recordedEnd = recordedStart + track.pendingRecord.size();
+        if (recordedEnd == recordedStart) return;
+        const uint64_t keepFrom = std::max<uint64_t>(recordedStart, ((recordedEnd - 1) / kWaveformBlockSize) * kWaveformBlockSize);
+        const size_t drop = static_cast<size_t>(keepFrom - recordedStart);
+        if (drop == 0) return;
+        track.pendingRecord.erase(track.pendingRecord.begin(), track.pendingRecord.begin() + drop);
+        if (!track.pendingRecordRight.empty()) {
+            const size_t dropRight = std::min(drop, track.pendingRecordRight.size());
+            track.pendingRecordRight.erase(track.pendingRecordRight.begin(),
+                                           track.pendingRecordRight.begin() + dropRight);
+        }
+        track.pendingRecordBase += drop;
+    }
+
+    // Clip audio never changes after it enters the pool, so each pyramid is
+    // built once, a bounded number of frames per tick, and clip edits only
+    // change which part of it the lanes read.
+    void UpdateDawWaveforms(BaseSystem& baseSystem, std::vector<Entity>&, float, GLFWwindow*) {
+        if (!baseSystem.daw) return;
+        DawContext& daw = *baseSystem.daw;
+        uint64_t budget = kPyramidFramesPerUpdate;
+        for (auto& clipAudio : daw.clipAudio) {
+            if (budget == 0) break;
+            const uint64_t totalFrames = clipAudio.frameCount();
+            DawWaveformPyramid& pyramid = clipAudio.waveform;
+            if (pyramid.totalFrames != totalFrames) {
+                allocatePyramid(pyramid, totalFrames);
+            }
+            if (pyramid.builtFrames >= totalFrames) continue;
+            const uint64_t start = pyramid.builtFrames;
+            const uint64_t end = std::min(totalFrames, start + budget);
+            UpdateClipWaveformRange(daw, clipAudio, start, end);
+            budget -= end - start;
+        }
     }
 }
@@ -2,6 +2,8 @@
 
 #include <GLFW/glfw3.h>
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace DebugWireframeSystemLogic {
     namespace {
         bool DebugWireframeEnabled(const BaseSystem& baseSystem) {
@@ -30,14 +32,15 @@ namespace DebugWireframeSystemLogic {
         RendererContext& renderer = *baseSystem.renderer;
         PlayerContext& player = *baseSystem.player;
         LevelContext& level = *baseSystem.level;
+        RenderDevice::Device& device = RenderDevice::current();
 
-        glEnable(GL_DEPTH_TEST);
-        glDisable(GL_BLEND);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        device.enable(GL_DEPTH_TEST);
+        device.disable(GL_BLEND);
+        device.polygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
         // Replace the normal frame (and UI) with a pure wireframe pass.
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        device.clearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        device.clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         glm::mat4 view = player.viewMatrix;
         glm::mat4 projection = player.projectionMatrix;
@@ -80,17 +83,17 @@ namespace DebugWireframeSystemLogic {
                 if (behavior == RenderBehavior::STATIC_BRANCH) {
                     if (branchInstances.empty()) continue;
                     renderer.blockShader->setInt("behaviorType", i);
-                    glBindVertexArray(renderer.behaviorVAOs[i]);
-                    glBindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[i]);
-                    glBufferData(GL_ARRAY_BUFFER, branchInstances.size() * sizeof(BranchInstanceData), branchInstances.data(), GL_DYNAMIC_DRAW);
-                    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, branchInstances.size());
+                    device.bindVertexArray(renderer.behaviorVAOs[i]);
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[i]);
+                    device.bufferData(GL_ARRAY_BUFFER, branchInstances.size() * sizeof(BranchInstanceData), branchInstances.data(), GL_DYNAMIC_DRAW);
+                    device.drawArraysInstanced(GL_TRIANGLES, 0, 36, branchInstances.size());
                 } else {
                     if (behaviorInstances[i].empty()) continue;
                     renderer.blockShader->setInt("behaviorType", i);
-                    glBindVertexArray(renderer.behaviorVAOs[i]);
-                    glBindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[i]);
-                    glBufferData(GL_ARRAY_BUFFER, behaviorInstances[i].size() * sizeof(InstanceData), behaviorInstances[i].data(), GL_DYNAMIC_DRAW);
-                    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, behaviorInstances[i].size());
+                    device.bindVertexArray(renderer.behaviorVAOs[i]);
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[i]);
+                    device.bufferData(GL_ARRAY_BUFFER, behaviorInstances[i].size() * sizeof(InstanceData), behaviorInstances[i].data(), GL_DYNAMIC_DRAW);
+                    device.drawArraysInstanced(GL_TRIANGLES, 0, 36, behaviorInstances[i].size());
                 }
             }
         }
@@ -104,11 +107,11 @@ namespace DebugWireframeSystemLogic {
             renderer.blockShader->setInt("wireframeDebug", 0);
         }
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        device.polygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
         // Keep debug text visible after the wireframe pass.
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         FontSystemLogic::UpdateFonts(baseSystem, prototypes, dt, win);
     }
 }
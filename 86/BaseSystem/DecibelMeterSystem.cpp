@@ -6,6 +6,9 @@
 #include <vector>
 
 #include "DawMixerLayout.h"
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic { UIBatch::Builder& Frame(BaseSystem& baseSystem); }
 
 namespace DecibelMeterSystemLogic {
     struct UiVertex {
@@ -61,17 +64,6 @@ namespace DecibelMeterSystemLogic {
             return meterTop + (1.0f - t) * meterHeight;
         }
 
-        void ensureResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.uiColorShader) {
-                renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(),
-                                                                 world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.uiMeterVAO == 0) {
-                glGenVertexArrays(1, &renderer.uiMeterVAO);
-                glGenBuffers(1, &renderer.uiMeterVBO);
-            }
-        }
-
         void renderChannelMeter(std::vector<UiVertex>& verts,
                                 float meterLeft,
                                 float meterRight,
@@ -218,11 +210,6 @@ namespace DecibelMeterSystemLogic {
         PanelRect bottomRect = (panel.bottomRenderRect.w > 0.0f) ? panel.bottomRenderRect : panel.bottomRect;
         if (bottomRect.w <= 1.0f || bottomRect.h <= 1.0f) return;
 
-        RendererContext& renderer = *baseSystem.renderer;
-        WorldContext& world = *baseSystem.world;
-        ensureResources(renderer, world);
-        if (!renderer.uiColorShader) return;
-
         int windowWidth = 0, windowHeight = 0;
         int fbWidth = 0, fbHeight = 0;
         glfwGetWindowSize(win, &windowWidth, &windowHeight);
@@ -332,7 +319,6 @@ namespace DecibelMeterSystemLogic {
 
         if (vertices.empty()) return;
 
-        glEnable(GL_SCISSOR_TEST);
         float scaleX = (windowWidth > 0) ? static_cast<float>(fbWidth) / static_cast<float>(windowWidth) : 1.0f;
         float scaleY = (windowHeight > 0) ? static_cast<float>(fbHeight) / static_cast<float>(windowHeight) : 1.0f;
         float bleed = DawMixerLayout::kMixerScissorBleed;
@@ -344,22 +330,14 @@ namespace DecibelMeterSystemLogic {
         int scissorY = std::max(0, static_cast<int>(scissorYf));
         int scissorW = std::max(0, std::min(fbWidth, static_cast<int>(scissorWf)));
         int scissorH = std::max(0, std::min(fbHeight, static_cast<int>(scissorHf)));
-        glScissor(scissorX, scissorY, scissorW, scissorH);
-
-        glDisable(GL_DEPTH_TEST);
-        glDisable(GL_BLEND);
-        glBindVertexArray(renderer.uiMeterVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.uiMeterVBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(UiVertex), vertices.data(), GL_DYNAMIC_DRAW);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, pos));
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, color));
-        glEnableVertexAttribArray(1);
-
-        renderer.uiColorShader->use();
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
-        glEnable(GL_BLEND);
-        glEnable(GL_DEPTH_TEST);
-        glDisable(GL_SCISSOR_TEST);
+        UIBatch::Clip clip;
+        clip.enabled = true;
+        clip.x = scissorX;
+        clip.y = scissorY;
+        clip.w = scissorW;
+        clip.h = scissorH;
+
+        // Meters are opaque.
+        UIBatchSystemLogic::Frame(baseSystem).addColored(vertices, 1.0f, clip);
     }
 }
@@ -198,6 +198,12 @@ namespace ExpanseBiomeSystemLogic {
         ensureNoise(world.expanse);
     }
 
+    // Seeds the shared noise up front so SampleTerrain only reads it and can
+    // be called from worker threads.
+    void PrepareTerrainSampling(const WorldContext& worldCtx) {
+        if (worldCtx.expanse.loaded) ensureNoise(worldCtx.expanse);
+    }
+
     bool SampleTerrain(const WorldContext& worldCtx, float x, float z, float& outHeight) {
         if (!worldCtx.expanse.loaded) return false;
         const ExpanseConfig& cfg = worldCtx.expanse;
@@ -11,6 +11,8 @@
 #include <sstream>
 #include <vector>
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace RenderInitSystemLogic { int FaceTileIndexFor(const WorldContext* worldCtx, const Entity& proto, int faceType); }
 namespace BlockSelectionSystemLogic { bool HasBlockAt(BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position); }
 
@@ -264,21 +266,7 @@ namespace FishingSystemLogic {
         }
 
         bool triggerFishingSfx(BaseSystem& baseSystem, const std::string& scriptPath, float cooldownSeconds = 0.0f) {
-            if (!baseSystem.audio || !baseSystem.audio->chuck) return false;
-            static std::unordered_map<std::string, double> s_lastTrigger;
-            double now = glfwGetTime();
-            auto it = s_lastTrigger.find(scriptPath);
-            if (it != s_lastTrigger.end() && (now - it->second) < static_cast<double>(cooldownSeconds)) {
-                return false;
-            }
-
-            std::vector<t_CKUINT> ids;
-            bool ok = baseSystem.audio->chuck->compileFile(scriptPath, "", 1, FALSE, &ids);
-            if (ok && !ids.empty()) {
-                s_lastTrigger[scriptPath] = now;
-                return true;
-            }
-            return false;
+            return ChucKSystemLogic::TriggerSfx(baseSystem, scriptPath, cooldownSeconds);
         }
 
         int currentLocalDayKey() {
@@ -1668,6 +1656,7 @@ namespace FishingSystemLogic {
         if (!baseSystem.renderer || !baseSystem.player || !baseSystem.world || !baseSystem.fishing) return;
 
         RendererContext& renderer = *baseSystem.renderer;
+        RenderDevice::Device& device = RenderDevice::current();
         PlayerContext& player = *baseSystem.player;
         WorldContext& world = *baseSystem.world;
         FishingContext& fishing = *baseSystem.fishing;
@@ -1695,8 +1684,8 @@ namespace FishingSystemLogic {
                     shader.setInt("tilesPerCol", renderer.atlasTilesPerCol);
                     shader.setInt("atlasTexture", 0);
                     if (renderer.atlasTexture != 0) {
-                        glActiveTexture(GL_TEXTURE0);
-                        glBindTexture(GL_TEXTURE_2D, renderer.atlasTexture);
+                        device.activeTexture(GL_TEXTURE0);
+                        device.bindTexture(GL_TEXTURE_2D, renderer.atlasTexture);
                     }
                 };
 
@@ -1719,13 +1708,13 @@ namespace FishingSystemLogic {
                 constexpr float kHalfY = kRodY * 0.5f;
                 constexpr float kHalfZ = kRodZ * 0.5f;
 
-                if (renderHeldRod) glDisable(GL_DEPTH_TEST);
-                else glEnable(GL_DEPTH_TEST);
-                glEnable(GL_CULL_FACE);
-                glFrontFace(GL_CCW);
-                glCullFace(GL_BACK);
-                glBindVertexArray(renderer.faceVAO);
-                glBindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
+                if (renderHeldRod) device.disable(GL_DEPTH_TEST);
+                else device.enable(GL_DEPTH_TEST);
+                device.enable(GL_CULL_FACE);
+                device.frontFace(GL_CCW);
+                device.cullFace(GL_BACK);
+                device.bindVertexArray(renderer.faceVAO);
+                device.bindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
 
                 auto drawRodFace = [&](int faceType, const glm::vec3& offset, const glm::vec2& scale) {
                     FaceInstanceRenderData face;
@@ -1738,8 +1727,8 @@ namespace FishingSystemLogic {
                     face.scale = scale;
                     face.uvScale = scale;
                     renderer.faceShader->setInt("faceType", faceType);
-                    glBufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &face, GL_DYNAMIC_DRAW);
-                    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
+                    device.bufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &face, GL_DYNAMIC_DRAW);
+                    device.drawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
                 };
 
                 drawRodFace(0, glm::vec3( kHalfX, 0.0f,   0.0f), glm::vec2(kRodZ, kRodY));
@@ -1749,9 +1738,9 @@ namespace FishingSystemLogic {
                 drawRodFace(4, glm::vec3( 0.0f,   0.0f,   kHalfZ), glm::vec2(kRodX, kRodY));
                 drawRodFace(5, glm::vec3( 0.0f,   0.0f,  -kHalfZ), glm::vec2(kRodX, kRodY));
 
-                glBindVertexArray(0);
-                glDisable(GL_CULL_FACE);
-                glEnable(GL_DEPTH_TEST);
+                device.bindVertexArray(0);
+                device.disable(GL_CULL_FACE);
+                device.enable(GL_DEPTH_TEST);
             }
         }
 
@@ -1778,15 +1767,15 @@ namespace FishingSystemLogic {
         }
 
         if (renderer.fishingVAO == 0) {
-            glGenVertexArrays(1, &renderer.fishingVAO);
-            glGenBuffers(1, &renderer.fishingVBO);
-            glBindVertexArray(renderer.fishingVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.fishingVBO);
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-            glBindVertexArray(0);
+            renderer.fishingVAO = device.createVertexArray();
+            renderer.fishingVBO = device.createBuffer();
+            device.bindVertexArray(renderer.fishingVAO);
+            device.bindBuffer(GL_ARRAY_BUFFER, renderer.fishingVBO);
+            device.enableVertexAttribArray(0);
+            device.vertexAttribPointer(0, 3, GL_FLOAT, false, 6 * sizeof(float), 0);
+            device.enableVertexAttribArray(1);
+            device.vertexAttribPointer(1, 3, GL_FLOAT, false, 6 * sizeof(float), 3 * sizeof(float));
+            device.bindVertexArray(0);
         }
 
         std::vector<FishingVertex> lineVerts;
@@ -1844,34 +1833,28 @@ namespace FishingSystemLogic {
         renderer.fishingVertexCount = static_cast<int>(lineVerts.size() + fillVerts.size());
         if (renderer.fishingVertexCount <= 0) return;
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDepthMask(GL_FALSE);
-        glEnable(GL_DEPTH_TEST);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.depthMask(false);
+        device.enable(GL_DEPTH_TEST);
 
         renderer.audioRayShader->use();
         renderer.audioRayShader->setMat4("view", player.viewMatrix);
         renderer.audioRayShader->setMat4("projection", player.projectionMatrix);
-        glBindVertexArray(renderer.fishingVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.fishingVBO);
+        device.bindVertexArray(renderer.fishingVAO);
+        device.bindBuffer(GL_ARRAY_BUFFER, renderer.fishingVBO);
         if (!fillVerts.empty()) {
-            glBufferData(GL_ARRAY_BUFFER,
-                         static_cast<GLsizeiptr>(fillVerts.size() * sizeof(FishingVertex)),
-                         fillVerts.data(),
-                         GL_DYNAMIC_DRAW);
-            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(fillVerts.size()));
+            device.bufferData(GL_ARRAY_BUFFER, fillVerts.size() * sizeof(FishingVertex), fillVerts.data(), GL_DYNAMIC_DRAW);
+            device.drawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(fillVerts.size()));
         }
         if (!lineVerts.empty()) {
-            glBufferData(GL_ARRAY_BUFFER,
-                         static_cast<GLsizeiptr>(lineVerts.size() * sizeof(FishingVertex)),
-                         lineVerts.data(),
-                         GL_DYNAMIC_DRAW);
-            glLineWidth(2.0f);
-            glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(lineVerts.size()));
-            glLineWidth(1.0f);
+            device.bufferData(GL_ARRAY_BUFFER, lineVerts.size() * sizeof(FishingVertex), lineVerts.data(), GL_DYNAMIC_DRAW);
+            device.lineWidth(2.0f);
+            device.drawArrays(GL_LINES, 0, static_cast<GLsizei>(lineVerts.size()));
+            device.lineWidth(1.0f);
         }
 
-        glDepthMask(GL_TRUE);
-        glBindVertexArray(0);
+        device.depthMask(true);
+        device.bindVertexArray(0);
     }
 }
@@ -13,6 +13,13 @@
 
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "stb_truetype.h"
+#include "BaseSystem/UIBatch.h"
+#include "BaseSystem/TextLayout.h"
+
+namespace UIBatchSystemLogic {
+    UIBatch::Builder& Frame(BaseSystem& baseSystem);
+    void Flush(BaseSystem& baseSystem);
+}
 
 namespace FontSystemLogic {
     struct FontAtlas {
@@ -28,20 +35,31 @@ namespace FontSystemLogic {
         float lineGap = 0.0f;
         float lineHeight = 24.0f;
         bool loaded = false;
-    };
-
-    struct FontVertex {
-        glm::vec2 pos;
-        glm::vec2 uv;
-        glm::vec3 color;
+        TextLayout::Face face;
     };
 
     struct FontBatch {
         FontAtlas* atlas = nullptr;
-        std::vector<FontVertex> vertices;
+        std::vector<UIBatch::Vertex> vertices;
+    };
+
+    // Last drawn form of one text instance; reused while none of its
+    // inputs change.
+    struct TextRun {
+        std::string text;
+        uint32_t faceId = 0;
+        uint32_t color = 0;
+        glm::vec2 position{0.0f};
+        double screenWidth = 0.0;
+        double screenHeight = 0.0;
+        std::vector<UIBatch::Vertex> vertices;
     };
 
     static std::unordered_map<std::string, FontAtlas> g_atlases;
+    static TextLayout::Cache g_layouts;
+    static std::unordered_map<uint64_t, TextRun> g_runs; // (world index << 32) | instance id
+    static std::vector<FontBatch> g_batches;
+    static uint32_t g_faceSerial = 0;
 
     enum class FontRenderPass {
         Timeline,
@@ -59,6 +77,7 @@ namespace FontSystemLogic {
         constexpr int kAtlasPadding = 1;
         constexpr int kSmallFontOversample = 2;
         constexpr float kSmallFontThreshold = 18.0f;
+        constexpr float kLabelFontSize = 11.0f; // lane and piano-roll labels
 
         EntityInstance* findInstanceById(LevelContext& level, int worldIndex, int instanceId) {
             if (worldIndex < 0 || worldIndex >= static_cast<int>(level.worlds.size())) return nullptr;
@@ -83,12 +102,6 @@ namespace FontSystemLogic {
             fontCtx.textCacheBuilt = true;
         }
 
-        glm::vec2 pixelToNDC(const glm::vec2& pixel, double width, double height) {
-            float ndcX = static_cast<float>((pixel.x / width) * 2.0 - 1.0);
-            float ndcY = static_cast<float>(1.0 - (pixel.y / height) * 2.0);
-            return {ndcX, ndcY};
-        }
-
         glm::vec3 resolveColor(const WorldContext* world, const std::string& name, const glm::vec3& fallback) {
             if (world && !name.empty()) {
                 auto it = world->colorLibrary.find(name);
@@ -121,25 +134,6 @@ namespace FontSystemLogic {
             return isTopButtonLabel(inst);
         }
 
-        void ensureResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.fontShader) {
-                renderer.fontShader = std::make_unique<Shader>(world.shaders["FONT_VERTEX_SHADER"].c_str(), world.shaders["FONT_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.fontVAO == 0) {
-                glGenVertexArrays(1, &renderer.fontVAO);
-                glGenBuffers(1, &renderer.fontVBO);
-                glBindVertexArray(renderer.fontVAO);
-                glBindBuffer(GL_ARRAY_BUFFER, renderer.fontVBO);
-                glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(FontVertex), (void*)offsetof(FontVertex, pos));
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(FontVertex), (void*)offsetof(FontVertex, uv));
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(FontVertex), (void*)offsetof(FontVertex, color));
-                glEnableVertexAttribArray(2);
-            }
-        }
-
         std::optional<FontAtlas*> loadAtlas(const std::string& fontName, float size) {
             int pixelSize = static_cast<int>(std::round(size <= 0.0f ? kDefaultFontSize : size));
             std::string key = fontName + "|" + std::to_string(pixelSize);
@@ -196,6 +190,28 @@ namespace FontSystemLogic {
                 atlas.lineHeight = atlas.size;
             }
 
+            atlas.face.id = ++g_faceSerial;
+            atlas.face.pixelSize = pixelSize;
+            atlas.face.firstChar = kFirstChar;
+            atlas.face.ascent = atlas.ascent;
+            atlas.face.lineHeight = (atlas.lineHeight > 0.0f) ? atlas.lineHeight : atlas.size;
+            atlas.face.glyphs.resize(kCharCount);
+            const float invWidth = 1.0f / static_cast<float>(atlas.width);
+            const float invHeight = 1.0f / static_cast<float>(atlas.height);
+            for (int i = 0; i < kCharCount; ++i) {
+                const stbtt_packedchar& bc = atlas.cdata[i];
+                TextLayout::GlyphMetrics& g = atlas.face.glyphs[static_cast<size_t>(i)];
+                g.xoff = bc.xoff;
+                g.yoff = bc.yoff;
+                g.xoff2 = bc.xoff2;
+                g.yoff2 = bc.yoff2;
+                g.s0 = bc.x0 * invWidth;
+                g.t0 = bc.y0 * invHeight;
+                g.s1 = bc.x1 * invWidth;
+                g.t1 = bc.y1 * invHeight;
+                g.xadvance = bc.xadvance;
+            }
+
             glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
             glGenTextures(1, &atlas.texture);
             glBindTexture(GL_TEXTURE_2D, atlas.texture);
@@ -211,103 +227,72 @@ namespace FontSystemLogic {
             return &newIt->second;
         }
 
-        void measureText(const std::string& text, const FontAtlas& atlas, float& outWidth, float& outHeight) {
-            float lineHeight = (atlas.lineHeight > 0.0f) ? atlas.lineHeight : atlas.size;
-            float lineWidth = 0.0f;
-            float maxWidth = 0.0f;
-            int lineCount = 1;
-
-            for (char c : text) {
-                if (c == '\n') {
-                    maxWidth = std::max(maxWidth, lineWidth);
-                    lineWidth = 0.0f;
-                    ++lineCount;
-                    continue;
-                }
-                unsigned char uc = static_cast<unsigned char>(c);
-                if (uc < kFirstChar || uc >= kFirstChar + kCharCount) continue;
-                const stbtt_packedchar& bc = atlas.cdata[uc - kFirstChar];
-                lineWidth += bc.xadvance;
-            }
+        uint64_t runKey(int worldIndex, int instanceId) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(worldIndex)) << 32)
+                | static_cast<uint64_t>(static_cast<uint32_t>(instanceId));
+        }
 
-            maxWidth = std::max(maxWidth, lineWidth);
-            outWidth = maxWidth;
-            outHeight = lineHeight * lineCount;
+        // Rebuilds `run` unless text, face, color, position and screen size
+        // all match what it was last built from.
+        const std::vector<UIBatch::Vertex>& layoutRun(TextRun& run,
+                                                      const FontAtlas& atlas,
+                                                      const std::string& text,
+                                                      uint32_t color,
+                                                      const glm::vec2& position,
+                                                      double screenWidth,
+                                                      double screenHeight) {
+            if (run.faceId == atlas.face.id && run.color == color && run.position == position
+                && run.screenWidth == screenWidth && run.screenHeight == screenHeight && run.text == text) {
+                return run.vertices;
+            }
+            const TextLayout::Layout& layout = g_layouts.get(atlas.face, text, 0.0f);
+            run.vertices.clear();
+            // Centered on the instance position, as text entities always were.
+            TextLayout::emit(layout,
+                             position.x - layout.width * 0.5f,
+                             position.y - layout.height * 0.5f,
+                             color,
+                             screenWidth,
+                             screenHeight,
+                             run.vertices);
+            run.text = text;
+            run.faceId = atlas.face.id;
+            run.color = color;
+            run.position = position;
+            run.screenWidth = screenWidth;
+            run.screenHeight = screenHeight;
+            return run.vertices;
         }
 
-        void appendTextVertices(std::vector<FontVertex>& verts,
-                                const FontAtlas& atlas,
-                                const std::string& text,
-                                const glm::vec3& color,
-                                const glm::vec2& position,
-                                double screenWidth,
-                                double screenHeight) {
-            if (text.empty()) return;
-
-            float textWidth = 0.0f;
-            float textHeight = 0.0f;
-            measureText(text, atlas, textWidth, textHeight);
-            float lineHeight = (atlas.lineHeight > 0.0f) ? atlas.lineHeight : atlas.size;
-
-            float startX = position.x - textWidth * 0.5f;
-            float startY = position.y - textHeight * 0.5f;
-            float x = startX;
-            float y = startY + atlas.ascent;
-
-            int lineIndex = 0;
-            for (char c : text) {
-                if (c == '\n') {
-                    ++lineIndex;
-                    x = startX;
-                    y = startY + atlas.ascent + lineIndex * lineHeight;
-                    continue;
-                }
-                unsigned char uc = static_cast<unsigned char>(c);
-                if (uc < kFirstChar || uc >= kFirstChar + kCharCount) continue;
-
-                stbtt_aligned_quad q;
-                float xCursor = x;
-                float yCursor = y;
-                stbtt_GetPackedQuad(atlas.cdata, atlas.width, atlas.height, uc - kFirstChar, &xCursor, &yCursor, &q, 1);
-                x = xCursor;
-
-                glm::vec2 p0 = pixelToNDC({q.x0, q.y0}, screenWidth, screenHeight);
-                glm::vec2 p1 = pixelToNDC({q.x1, q.y0}, screenWidth, screenHeight);
-                glm::vec2 p2 = pixelToNDC({q.x1, q.y1}, screenWidth, screenHeight);
-                glm::vec2 p3 = pixelToNDC({q.x0, q.y1}, screenWidth, screenHeight);
-
-                verts.push_back({p0, {q.s0, q.t0}, color});
-                verts.push_back({p1, {q.s1, q.t0}, color});
-                verts.push_back({p2, {q.s1, q.t1}, color});
-                verts.push_back({p0, {q.s0, q.t0}, color});
-                verts.push_back({p2, {q.s1, q.t1}, color});
-                verts.push_back({p3, {q.s0, q.t1}, color});
+        FontBatch& batchFor(FontAtlas* atlas) {
+            for (FontBatch& batch : g_batches) {
+                if (batch.atlas == atlas) return batch;
             }
+            g_batches.push_back(FontBatch{atlas, {}});
+            return g_batches.back();
         }
     }
 
     namespace {
         void renderFontsPass(BaseSystem& baseSystem, std::vector<Entity>& prototypes, GLFWwindow* win, FontRenderPass pass) {
             if (!baseSystem.renderer || !baseSystem.world || !baseSystem.level || !baseSystem.font || !baseSystem.ui || !win) return;
-            RendererContext& renderer = *baseSystem.renderer;
             WorldContext& world = *baseSystem.world;
             FontContext& fontCtx = *baseSystem.font;
             UIContext& ui = *baseSystem.ui;
 
-            ensureResources(renderer, world);
-
             int windowWidth = 0, windowHeight = 0;
             glfwGetWindowSize(win, &windowWidth, &windowHeight);
             double screenWidth = windowWidth > 0 ? static_cast<double>(windowWidth) : 1920.0;
             double screenHeight = windowHeight > 0 ? static_cast<double>(windowHeight) : 1080.0;
 
-            std::vector<FontBatch> batches;
-            std::unordered_map<std::string, size_t> batchIndex;
+            for (FontBatch& batch : g_batches) batch.vertices.clear();
 
             if (!fontCtx.textCacheBuilt) {
                 buildTextCache(baseSystem, prototypes, fontCtx);
+                g_runs.clear();
             }
             bool cacheValid = true;
+            std::string textValue;
             for (const auto& ref : fontCtx.textInstances) {
                 EntityInstance* inst = findInstanceById(*baseSystem.level, ref.first, ref.second);
                 if (!inst) { cacheValid = false; continue; }
@@ -316,7 +301,6 @@ namespace FontSystemLogic {
                 bool uiOnly = (inst->textType == "UIOnly" || inst->textType == "VariableUI");
                 if (uiOnly && !ui.active) continue;
 
-                std::string textValue;
                 bool isVariable = (inst->textType == "VariableText" || inst->textType == "VariableUI");
                 if (isVariable) {
                     auto it = fontCtx.variables.find(inst->textKey);
@@ -334,59 +318,61 @@ namespace FontSystemLogic {
                 FontAtlas* atlas = *atlasOpt;
 
                 glm::vec3 baseColor = resolveColor(&world, inst->colorName, inst->color);
-
-                int pixelSize = static_cast<int>(std::round(fontSize));
-                std::string key = fontName + "|" + std::to_string(pixelSize);
-                size_t index = 0;
-                auto idxIt = batchIndex.find(key);
-                if (idxIt == batchIndex.end()) {
-                    index = batches.size();
-                    batchIndex[key] = index;
-                    batches.push_back(FontBatch{atlas, {}});
-                } else {
-                    index = idxIt->second;
-                }
-
-                glm::vec2 pos(inst->position.x, inst->position.y);
-                appendTextVertices(batches[index].vertices,
-                                   *atlas,
-                                   textValue,
-                                   baseColor,
-                                   pos,
-                                   screenWidth,
-                                   screenHeight);
+                const uint32_t color = UIBatch::packColor(baseColor.r, baseColor.g, baseColor.b, 1.0f);
+
+                const std::vector<UIBatch::Vertex>& runVertices = layoutRun(g_runs[runKey(ref.first, ref.second)],
+                                                                            *atlas,
+                                                                            textValue,
+                                                                            color,
+                                                                            glm::vec2(inst->position.x, inst->position.y),
+                                                                            screenWidth,
+                                                                            screenHeight);
+                std::vector<UIBatch::Vertex>& out = batchFor(atlas).vertices;
+                out.insert(out.end(), runVertices.begin(), runVertices.end());
             }
             if (!cacheValid) {
                 fontCtx.textCacheBuilt = false;
             }
 
-            if (batches.empty() || !renderer.fontShader) return;
-
-            glDisable(GL_DEPTH_TEST);
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            renderer.fontShader->use();
-            renderer.fontShader->setInt("fontTex", 0);
-            glBindVertexArray(renderer.fontVAO);
-
-            for (auto& batch : batches) {
-                if (!batch.atlas || batch.vertices.empty()) continue;
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, batch.atlas->texture);
-                glBindBuffer(GL_ARRAY_BUFFER, renderer.fontVBO);
-                glBufferData(GL_ARRAY_BUFFER, batch.vertices.size() * sizeof(FontVertex), batch.vertices.data(), GL_DYNAMIC_DRAW);
-                glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(batch.vertices.size()));
+            UIBatch::Builder& uiBatch = UIBatchSystemLogic::Frame(baseSystem);
+            for (const FontBatch& batch : g_batches) {
+                uiBatch.addPacked(UIBatch::Program::Text,
+                                  batch.atlas->texture,
+                                  batch.vertices.data(),
+                                  batch.vertices.size(),
+                                  1.0f);
             }
-
-            glBindTexture(GL_TEXTURE_2D, 0);
-            glDisable(GL_BLEND);
-            glEnable(GL_DEPTH_TEST);
         }
     }
 
+    // Lays out `text` in the UI label face with its top-left at (x, y)
+    // window pixels and adds it to `labels` at colored vertex `at`.
+    // Returns false when the label font is unavailable.
+    bool AppendUiLabel(UIBatch::TextOverlay& labels,
+                       size_t at,
+                       float x,
+                       float y,
+                       const char* text,
+                       const glm::vec3& color,
+                       double screenWidth,
+                       double screenHeight) {
+        if (!text || text[0] == '\0') return true;
+        auto atlasOpt = loadAtlas(kDefaultFontName, kLabelFontSize);
+        if (!atlasOpt.has_value()) return false;
+        const FontAtlas& atlas = **atlasOpt;
+        const TextLayout::Layout& layout = g_layouts.get(atlas.face, std::string(text), 0.0f);
+        const size_t first = labels.vertices.size();
+        TextLayout::emit(layout, x, y, UIBatch::packColor(color.r, color.g, color.b, 1.0f),
+                         screenWidth, screenHeight, labels.vertices);
+        labels.mark(at, atlas.texture, first);
+        return true;
+    }
+
     void UpdateFonts(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
         (void)dt;
         renderFontsPass(baseSystem, prototypes, win, FontRenderPass::All);
+        // The full pass runs outside the UI span, so it draws right away.
+        UIBatchSystemLogic::Flush(baseSystem);
     }
 
     void RenderFontsTimeline(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
@@ -412,5 +398,8 @@ namespace FontSystemLogic {
             }
         }
         g_atlases.clear();
+        g_layouts.clear();
+        g_runs.clear();
+        g_batches.clear();
     }
 }
@@ -12,6 +12,8 @@
 #include <vector>
 #include "../stb_image.h"
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace GemSystemLogic {
     namespace {
         struct GemVertex {
@@ -419,6 +421,56 @@ namespace GemSystemLogic {
             return true;
         }
 
+        // Pushes the sphere out of one unit box centred on `cellCenter` and
+        // reflects the inward velocity. Returns false when they do not touch.
+        bool resolveSphereAgainstBox(glm::vec3& center,
+                                     glm::vec3& velocity,
+                                     float r,
+                                     const glm::vec3& cellCenter,
+                                     float bounce,
+                                     float groundFriction,
+                                     bool& groundedOut) {
+            const glm::vec3 boxMin = cellCenter - glm::vec3(0.5f);
+            const glm::vec3 boxMax = cellCenter + glm::vec3(0.5f);
+            glm::vec3 closest = glm::clamp(center, boxMin, boxMax);
+            glm::vec3 delta = center - closest;
+            float dist2 = glm::dot(delta, delta);
+            if (dist2 >= r * r) return false;
+
+            glm::vec3 normal(0.0f, 1.0f, 0.0f);
+            float penetration = 0.0f;
+
+            if (dist2 > 1e-8f) {
+                float dist = std::sqrt(dist2);
+                normal = delta / dist;
+                penetration = r - dist;
+            } else {
+                // Center is exactly on/in closest point; pick a stable axis away from block center.
+                glm::vec3 fromCell = center - cellCenter;
+                glm::vec3 absC = glm::abs(fromCell);
+                if (absC.x >= absC.y && absC.x >= absC.z) {
+                    normal = glm::vec3((fromCell.x >= 0.0f) ? 1.0f : -1.0f, 0.0f, 0.0f);
+                } else if (absC.y >= absC.x && absC.y >= absC.z) {
+                    normal = glm::vec3(0.0f, (fromCell.y >= 0.0f) ? 1.0f : -1.0f, 0.0f);
+                } else {
+                    normal = glm::vec3(0.0f, 0.0f, (fromCell.z >= 0.0f) ? 1.0f : -1.0f);
+                }
+                penetration = r;
+            }
+
+            center += normal * (penetration + 0.0008f);
+            float vn = glm::dot(velocity, normal);
+            if (vn < 0.0f) {
+                velocity -= (1.0f + bounce) * vn * normal;
+            }
+            if (normal.y > 0.45f) {
+                groundedOut = true;
+                velocity.x *= groundFriction;
+                velocity.z *= groundFriction;
+            }
+            return true;
+        }
+
         bool resolveSphereAgainstVoxelWorld(const BaseSystem& baseSystem,
                                             const std::vector<Entity>& prototypes,
                                             glm::vec3& center,
@@ -431,7 +483,6 @@ namespace GemSystemLogic {
             if (!baseSystem.voxelWorld || !baseSystem.voxelWorld->enabled) return false;
             bool collidedAny = false;
             const float r = std::max(0.02f, radius);
-            const float r2 = r * r;
             const float extent = r + 0.5f;
 
             for (int iter = 0; iter < 4; ++iter) {
@@ -447,53 +498,12 @@ namespace GemSystemLogic {
                     for (int y = minY; y <= maxY; ++y) {
                         for (int x = minX; x <= maxX; ++x) {
                             if (!isSolidVoxelCell(baseSystem, prototypes, x, y, z)) continue;
-
-                            glm::vec3 boxMin(static_cast<float>(x) - 0.5f,
-                                             static_cast<float>(y) - 0.5f,
-                                             static_cast<float>(z) - 0.5f);
-                            glm::vec3 boxMax(static_cast<float>(x) + 0.5f,
-                                             static_cast<float>(y) + 0.5f,
-                                             static_cast<float>(z) + 0.5f);
-                            glm::vec3 closest = glm::clamp(center, boxMin, boxMax);
-                            glm::vec3 delta = center - closest;
-                            float dist2 = glm::dot(delta, delta);
-                            if (dist2 >= r2) continue;
-
+                            const glm::vec3 cellCenter(static_cast<float>(x),
+                                                       static_cast<float>(y),
+                                                       static_cast<float>(z));
+                            if (!resolveSphereAgainstBox(center, velocity, r, cellCenter, bounce, groundFriction, groundedOut)) continue;
                             collidedThisPass = true;
                             collidedAny = true;
-                            glm::vec3 normal(0.0f, 1.0f, 0.0f);
-                            float penetration = 0.0f;
-
-                            if (dist2 > 1e-8f) {
-                                float dist = std::sqrt(dist2);
-                                normal = delta / dist;
-                                penetration = r - dist;
-                            } else {
-                                // Center is exactly on/in closest point; pick a stable axis away from block center.
-                                glm::vec3 fromCell = center - glm::vec3(static_cast<float>(x),
-                                                                        static_cast<float>(y),
-                                                                        static_cast<float>(z));
-                                glm::vec3 absC = glm::abs(fromCell);
-                                if (absC.x >= absC.y && absC.x >= absC.z) {
-                                    normal = glm::vec3((fromCell.x >= 0.0f) ? 1.0f : -1.0f, 0.0f, 0.0f);
-                                } else if (absC.y >= absC.x && absC.y >= absC.z) {
-                                    normal = glm::vec3(0.0f, (fromCell.y >= 0.0f) ? 1.0f : -1.0f, 0.0f);
-                                } else {
-                                    normal = glm::vec3(0.0f, 0.0f, (fromCell.z >= 0.0f) ? 1.0f : -1.0f);
-                                }
-                                penetration = r;
-                            }
-
-                            center += normal * (penetration + 0.0008f);
-                            float vn = glm::dot(velocity, normal);
-                            if (vn < 0.0f) {
-                                velocity -= (1.0f + bounce) * vn * normal;
-                            }
-                            if (normal.y > 0.45f) {
-                                groundedOut = true;
-                                velocity.x *= groundFriction;
-                                velocity.z *= groundFriction;
-                            }
                         }
                     }
                 }
@@ -502,6 +512,33 @@ namespace GemSystemLogic {
             return collidedAny;
         }
 
+        // Same response against candidate boxes from the collision broadphase
+        // (instance worlds); the candidates must cover the whole frame's travel.
+        bool resolveSphereAgainstBoxes(glm::vec3& center,
+                                       glm::vec3& velocity,
+                                       float radius,
+                                       const glm::vec3* boxMin,
+                                       const glm::vec3* boxMax,
+                                       int boxCount,
+                                       float bounce,
+                                       float groundFriction,
+                                       bool& groundedOut) {
+            groundedOut = false;
+            bool collidedAny = false;
+            const float r = std::max(0.02f, radius);
+            for (int iter = 0; iter < 4; ++iter) {
+                bool collidedThisPass = false;
+                for (int i = 0; i < boxCount; ++i) {
+                    const glm::vec3 cellCenter = (boxMin[i] + boxMax[i]) * 0.5f;
+                    if (!resolveSphereAgainstBox(center, velocity, r, cellCenter, bounce, groundFriction, groundedOut)) continue;
+                    collidedThisPass = true;
+                    collidedAny = true;
+                }
+                if (!collidedThisPass) break;
+            }
+            return collidedAny;
+        }
+
         bool raySphereHit(const glm::vec3& origin,
                           const glm::vec3& directionNorm,
                           const glm::vec3& center,
@@ -813,7 +850,32 @@ namespace GemSystemLogic {
                 gems.drops.pop_back();
                 continue;
             }
+            ++i;
+        }
 
+        // Instance worlds have no voxel grid to probe, so fetch every drop's
+        // candidate blocks for this frame in one broadphase batch.
+        const bool useVoxel = baseSystem.voxelWorld && baseSystem.voxelWorld->enabled;
+        std::vector<int> candidateOffsets;
+        std::vector<glm::vec3> candidateMin;
+        std::vector<glm::vec3> candidateMax;
+        if (!useVoxel && baseSystem.level && !gems.drops.empty()) {
+            std::vector<glm::vec3> queryMin;
+            std::vector<glm::vec3> queryMax;
+            queryMin.reserve(gems.drops.size());
+            queryMax.reserve(gems.drops.size());
+            const float reach = maxSpeed * dt + 0.05f;
+            for (const GemDropState& drop : gems.drops) {
+                const glm::vec3 pad(std::max(0.03f, drop.collisionRadius) + reach);
+                queryMin.push_back(drop.position - pad);
+                queryMax.push_back(drop.position + pad);
+            }
+            CollisionSystemLogic::QueryColliderBatch(baseSystem, prototypes, queryMin, queryMax,
+                                                     candidateOffsets, candidateMin, candidateMax);
+        }
+
+        for (i = 0; i < gems.drops.size(); ++i) {
+            GemDropState& drop = gems.drops[i];
             // Keep orientation static once spawned.
             drop.velocity.y += gravity * dt;
             drop.velocity *= dragPow;
@@ -829,8 +891,8 @@ namespace GemSystemLogic {
 
             for (int step = 0; step < substeps; ++step) {
                 drop.position += drop.velocity * stepDt;
-                if (baseSystem.voxelWorld && baseSystem.voxelWorld->enabled) {
-                    bool grounded = false;
+                bool grounded = false;
+                if (useVoxel) {
                     resolveSphereAgainstVoxelWorld(baseSystem,
                                                    prototypes,
                                                    drop.position,
@@ -839,14 +901,24 @@ namespace GemSystemLogic {
                                                    bounce,
                                                    groundFriction,
                                                    grounded);
-                    if (grounded && std::abs(drop.velocity.y) < restThreshold) {
-                        drop.velocity.y = 0.0f;
-                        drop.velocity.x *= groundFriction;
-                        drop.velocity.z *= groundFriction;
-                    }
+                } else if (i + 1 < candidateOffsets.size()) {
+                    const int first = candidateOffsets[i];
+                    resolveSphereAgainstBoxes(drop.position,
+                                              drop.velocity,
+                                              std::max(0.03f, drop.collisionRadius),
+                                              candidateMin.data() + first,
+                                              candidateMax.data() + first,
+                                              candidateOffsets[i + 1] - first,
+                                              bounce,
+                                              groundFriction,
+                                              grounded);
+                }
+                if (grounded && std::abs(drop.velocity.y) < restThreshold) {
+                    drop.velocity.y = 0.0f;
+                    drop.velocity.x *= groundFriction;
+                    drop.velocity.z *= groundFriction;
                 }
             }
-            ++i;
         }
     }
 
@@ -858,6 +930,7 @@ namespace GemSystemLogic {
         if (!readRegistryBool(baseSystem, "GemDropsEnabled", true)) return;
 
         RendererContext& renderer = *baseSystem.renderer;
+        RenderDevice::Device& device = RenderDevice::current();
         PlayerContext& player = *baseSystem.player;
         WorldContext& world = *baseSystem.world;
         GemContext& gems = *baseSystem.gems;
@@ -887,15 +960,15 @@ namespace GemSystemLogic {
         }
 
         if (renderer.gemVAO == 0) {
-            glGenVertexArrays(1, &renderer.gemVAO);
-            glGenBuffers(1, &renderer.gemVBO);
-            glBindVertexArray(renderer.gemVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.gemVBO);
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-            glBindVertexArray(0);
+            renderer.gemVAO = device.createVertexArray();
+            renderer.gemVBO = device.createBuffer();
+            device.bindVertexArray(renderer.gemVAO);
+            device.bindBuffer(GL_ARRAY_BUFFER, renderer.gemVBO);
+            device.enableVertexAttribArray(0);
+            device.vertexAttribPointer(0, 3, GL_FLOAT, false, 6 * sizeof(float), 0);
+            device.enableVertexAttribArray(1);
+            device.vertexAttribPointer(1, 3, GL_FLOAT, false, 6 * sizeof(float), 3 * sizeof(float));
+            device.bindVertexArray(0);
         }
 
         std::vector<GemVertex> fillVerts;
@@ -1031,33 +1104,30 @@ namespace GemSystemLogic {
         renderer.gemVertexCount = fillCount + lineCount;
         if (renderer.gemVertexCount <= 0) return;
 
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
+        device.disable(GL_BLEND);
+        device.depthMask(true);
+        device.enable(GL_DEPTH_TEST);
 
         renderer.audioRayShader->use();
         renderer.audioRayShader->setMat4("view", player.viewMatrix);
         renderer.audioRayShader->setMat4("projection", player.projectionMatrix);
-        glBindVertexArray(renderer.gemVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.gemVBO);
+        device.bindVertexArray(renderer.gemVAO);
+        device.bindBuffer(GL_ARRAY_BUFFER, renderer.gemVBO);
         if (fillCount > 0 || lineCount > 0) {
             std::vector<GemVertex> upload;
             upload.reserve(static_cast<size_t>(fillCount + lineCount));
             upload.insert(upload.end(), fillVerts.begin(), fillVerts.end());
             upload.insert(upload.end(), lineVerts.begin(), lineVerts.end());
-            glBufferData(GL_ARRAY_BUFFER,
-                         static_cast<GLsizeiptr>(upload.size() * sizeof(GemVertex)),
-                         upload.data(),
-                         GL_DYNAMIC_DRAW);
+            device.bufferData(GL_ARRAY_BUFFER, upload.size() * sizeof(GemVertex), upload.data(), GL_DYNAMIC_DRAW);
             if (fillCount > 0) {
-                glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(fillCount));
+                device.drawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(fillCount));
             }
             if (lineCount > 0) {
-                glLineWidth(1.0f);
-                glDrawArrays(GL_LINES, fillCount, static_cast<GLsizei>(lineCount));
+                device.lineWidth(1.0f);
+                device.drawArrays(GL_LINES, fillCount, static_cast<GLsizei>(lineCount));
             }
         }
 
-        glBindVertexArray(0);
+        device.bindVertexArray(0);
     }
 }
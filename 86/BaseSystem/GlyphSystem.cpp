@@ -8,6 +8,8 @@
 #include <unordered_map>
 #include <cctype>
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace ButtonSystemLogic { float GetButtonPressOffset(int instanceID); }
 
 namespace GlyphSystemLogic {
@@ -45,7 +47,7 @@ namespace GlyphSystemLogic {
                                                                world.shaders["GLYPH_FRAGMENT_SHADER"].c_str());
             }
             if (renderer.glyphVAO == 0) {
-                glGenVertexArrays(1, &renderer.glyphVAO);
+                renderer.glyphVAO = RenderDevice::current().createVertexArray();
             }
         }
     }
@@ -99,14 +101,15 @@ namespace GlyphSystemLogic {
         double scaleX = (winW > 0) ? (static_cast<double>(fbw) / static_cast<double>(winW)) : 1.0;
         double scaleY = (winH > 0) ? (static_cast<double>(fbh) / static_cast<double>(winH)) : 1.0;
 
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendColor(0.0f, 0.0f, 0.0f, kGlyphAlpha);
-        glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+        RenderDevice::Device& device = RenderDevice::current();
+        device.disable(GL_DEPTH_TEST);
+        device.enable(GL_BLEND);
+        device.blendColor(0.0f, 0.0f, 0.0f, kGlyphAlpha);
+        device.blendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
         renderer.glyphShader->use();
         renderer.glyphShader->setVec2("uResolution", glm::vec2(static_cast<float>(screenWidth),
                                                                static_cast<float>(screenHeight)));
-        glBindVertexArray(renderer.glyphVAO);
+        device.bindVertexArray(renderer.glyphVAO);
 
         auto drawGlyph = [&](const glm::vec2& centerPx,
                              const glm::vec2& sizePx,
@@ -118,7 +121,7 @@ namespace GlyphSystemLogic {
             renderer.glyphShader->setFloat("uPressOffset", pressOffset);
             renderer.glyphShader->setInt("uType", typeId);
             renderer.glyphShader->setVec3("uColor", color);
-            glDrawArrays(GL_TRIANGLES, 0, 3);
+            device.drawArrays(GL_TRIANGLES, 0, 3);
         };
 
         if (!glyphs.empty()) {
@@ -149,7 +152,7 @@ namespace GlyphSystemLogic {
             }
         }
 
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_DEPTH_TEST);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.enable(GL_DEPTH_TEST);
     }
 }
@@ -27,21 +27,8 @@ namespace GravitySystemLogic {
         }
 
         bool triggerGameplaySfx(BaseSystem& baseSystem, const char* fileName, float cooldownSeconds = 0.0f) {
-            if (!fileName || !baseSystem.audio || !baseSystem.audio->chuck) return false;
-            const std::string scriptPath = std::string("Procedures/chuck/gameplay/") + fileName;
-            static std::unordered_map<std::string, double> s_lastTrigger;
-            const double now = glfwGetTime();
-            auto it = s_lastTrigger.find(scriptPath);
-            if (it != s_lastTrigger.end() && (now - it->second) < static_cast<double>(cooldownSeconds)) {
-                return false;
-            }
-            std::vector<t_CKUINT> ids;
-            bool ok = baseSystem.audio->chuck->compileFile(scriptPath, "", 1, FALSE, &ids);
-            if (ok && !ids.empty()) {
-                s_lastTrigger[scriptPath] = now;
-                return true;
-            }
-            return false;
+            if (!fileName) return false;
+            return ChucKSystemLogic::TriggerSfx(baseSystem, std::string("Procedures/chuck/gameplay/") + fileName, cooldownSeconds);
         }
 
         int resolveWaterPrototypeID(const std::vector<Entity>& prototypes) {
@@ -138,13 +125,8 @@ namespace GravitySystemLogic {
             }
             if (!baseSystem.level) return false;
             if (worldIndexHint < 0 || worldIndexHint >= static_cast<int>(baseSystem.level->worlds.size())) return false;
-            const Entity& world = baseSystem.level->worlds[static_cast<size_t>(worldIndexHint)];
-            const glm::vec3 targetPos = glm::vec3(cell);
-            for (const auto& inst : world.instances) {
-                if (glm::distance(inst.position, targetPos) > 0.05f) continue;
-                if (isWallStonePrototypeID(prototypes, inst.prototypeID)) return true;
-            }
-            return false;
+            const EntityInstance* inst = BlockSelectionSystemLogic::FindBlockInstance(baseSystem, prototypes, worldIndexHint, glm::vec3(cell));
+            return inst && isWallStonePrototypeID(prototypes, inst->prototypeID);
         }
 
         bool findWaterSurfaceInColumn(const VoxelWorldContext& voxelWorld,
@@ -19,12 +19,14 @@ namespace KeyboardInputSystemLogic {
         Entity& activeWorld = level.worlds[level.activeWorldIndex];
 
         // --- UAV (Player Movement) Controls ---
+        const size_t uavCount = activeWorld.instances.size();
         if (glfwGetKey(win, GLFW_KEY_W) == GLFW_PRESS) activeWorld.instances.push_back(HostLogic::CreateInstance(baseSystem, prototypes, "UAV_W", {}, {}));
         if (glfwGetKey(win, GLFW_KEY_A) == GLFW_PRESS) activeWorld.instances.push_back(HostLogic::CreateInstance(baseSystem, prototypes, "UAV_A", {}, {}));
         if (glfwGetKey(win, GLFW_KEY_S) == GLFW_PRESS) activeWorld.instances.push_back(HostLogic::CreateInstance(baseSystem, prototypes, "UAV_S", {}, {}));
         if (glfwGetKey(win, GLFW_KEY_D) == GLFW_PRESS) activeWorld.instances.push_back(HostLogic::CreateInstance(baseSystem, prototypes, "UAV_D", {}, {}));
         if (glfwGetKey(win, GLFW_KEY_SPACE) == GLFW_PRESS) activeWorld.instances.push_back(HostLogic::CreateInstance(baseSystem, prototypes, "UAV_SPACE", {}, {}));
         if (glfwGetKey(win, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) activeWorld.instances.push_back(HostLogic::CreateInstance(baseSystem, prototypes, "UAV_LSHIFT", {}, {}));
+        if (activeWorld.instances.size() != uavCount) activeWorld.instanceEdits += 1;
     
         // --- World Switching ---
         static bool tab_pressed_last_frame = false;
@@ -0,0 +1,1049 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "BaseSystem/UIBatch.h"
+
+// Retained geometry for the timeline lanes. Vertices live in a Store that
+// the render side keeps in its own GL buffer and re-uploads only where a
+// segment was rewritten. A vertex is placed in the vertex shader
+// (Procedures/Shaders/UILane.vert.glsl): x from the timeline samples it is
+// anchored to and the view's scroll and zoom, y from its lane's center, both
+// of which are uniforms -- so scrolling, zooming and dragging lanes upload
+// nothing. place() is the same placement on the CPU, and the per-frame
+// decisions the immediate path made (which clips and ticks show, where labels
+// go) are made here with its exact arithmetic, so the lanes draw as they did.
+// Nothing here touches GL.
+namespace LaneGeometry {
+
+    // Order-sensitive hash of the values a segment was built from.
+    class Key {
+    public:
+        Key& add(uint64_t value) {
+            h ^= value + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            return *this;
+        }
+        Key& addReal(double value) {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return add(bits);
+        }
+        uint64_t value() const { return h; }
+
+    private:
+        uint64_t h = 1469598103934665603ull;
+    };
+
+    // The lane systems' clip rectangle and tick constants.
+    constexpr float kClipHorizontalPad = 2.0f;
+    constexpr float kClipVerticalInset = 0.0f;
+    constexpr float kClipMinHeight = 2.0f;
+    constexpr float kClipLipMinHeight = 6.0f;
+    constexpr float kClipLipMaxHeight = 12.0f;
+    constexpr int kBeatTickGuard = 512;        // ticks drawn per clip and frame
+    constexpr uint32_t kMaxClipTicks = 16384;  // ticks kept per clip segment
+    constexpr uint32_t kLanesPerPage = 256;    // lane centers per upload; uCenterY in UILane.vert.glsl
+
+    // What the lanes show this frame.
+    struct View {
+        double offsetSamples = 0.0;  // timeline sample at laneLeft
+        double windowSamples = 0.0;  // samples across the lane width
+        float laneLeft = 0.0f;
+        float laneRight = 0.0f;
+        double screenWidth = 1.0;
+        double screenHeight = 1.0;
+
+        bool valid() const { return windowSamples > 0.0 && laneRight > laneLeft; }
+    };
+
+    // Lane rows on screen, with the gap a lane drag previews at its drop
+    // slot. displayIndex() is -1 for the lane being dragged.
+    struct Rows {
+        float startY = 0.0f;
+        float rowSpan = 0.0f;
+        int previewSlot = -1;
+        bool previewingDrag = false;
+        int draggedLaneIndex = -1;
+
+        int displayIndex(int laneIndex) const {
+            int index = laneIndex;
+            if (previewSlot < 0) return index;
+            if (previewingDrag) {
+                if (laneIndex == draggedLaneIndex) return -1;
+                if (laneIndex > draggedLaneIndex) {
+                    index -= 1;
+                }
+            }
+            if (index >= previewSlot) {
+                index += 1;
+            }
+            return index;
+        }
+        float centerY(int displayIndex) const {
+            return startY + static_cast<float>(displayIndex) * rowSpan;
+        }
+        // Lanes wholly off screen are neither built nor drawn.
+        bool onScreen(float centerY, double screenHeight) const {
+            return centerY + rowSpan >= 0.0f && centerY - rowSpan <= static_cast<float>(screenHeight);
+        }
+    };
+
+    // How the shader finds a vertex's x. Timeline positions are X(s) =
+    // laneLeft + (laneRight - laneLeft) * ((s - offset) / window).
+    enum class Kind : uint32_t {
+        Window = 0,  // x = dx, in window pixels
+        Edge = 1,    // clip edge: clamp(X(anchor) + dx, laneLeft, laneRight)
+        Tick = 2,    // beat tick: clamp(X(anchor), laneLeft + 1, laneRight - 1) + dx
+        Note = 3,    // note edge, clamped inside its clip; see place()
+    };
+
+    // Samples are split into a multiple of 65536 and the rest so that their
+    // distance to the view offset, split the same way, is exact in float.
+    struct Vertex {
+        float anchor[4] = {0.0f, 0.0f, 0.0f, 0.0f};  // own sample, other note edge (hi, lo)
+        float clip[4] = {0.0f, 0.0f, 0.0f, 0.0f};    // clip start and end (hi, lo), for notes
+        float dx = 0.0f;
+        float dy[2] = {0.0f, 0.0f};  // y = (center + dy[0]) + dy[1]
+        uint32_t color = 0;          // rgb as packColor; alpha comes from the layer
+        uint32_t meta = 0;           // kind | side << 4 | lane << 8
+    };
+    static_assert(sizeof(Vertex) == 52, "UIBatchSystem's lane attribute layout expects 52-byte vertices");
+
+    inline void splitSample(uint64_t sample, float* out) {
+        out[0] = static_cast<float>(sample & ~uint64_t{0xffff});
+        out[1] = static_cast<float>(sample & uint64_t{0xffff});
+    }
+
+    inline uint32_t meta(Kind kind, uint32_t lane, uint32_t side = 0) {
+        return static_cast<uint32_t>(kind) | (side << 4u) | (lane << 8u);
+    }
+
+    // The uniforms a Store's layer is drawn with.
+    struct Transform {
+        float offset[2] = {0.0f, 0.0f};
+        float window[2] = {1.0f, 0.0f};  // windowSamples as hi + lo
+        float laneLeft = 0.0f;
+        float laneRight = 0.0f;
+        float screenWidth = 1.0f;
+        float screenHeight = 1.0f;
+        float alpha = 1.0f;         // already quantized like a packed color
+        std::vector<float> centerY;  // by lane slot
+
+        void setView(const View& view) {
+            splitSample(static_cast<uint64_t>(std::max(view.offsetSamples, 0.0)), offset);
+            window[0] = static_cast<float>(view.windowSamples);
+            window[1] = static_cast<float>(view.windowSamples - static_cast<double>(window[0]));
+            laneLeft = view.laneLeft;
+            laneRight = view.laneRight;
+            screenWidth = static_cast<float>(view.screenWidth);
+            screenHeight = static_cast<float>(view.screenHeight);
+        }
+        void setAlpha(float value) {
+            alpha = static_cast<float>(UIBatch::packColor(0.0f, 0.0f, 0.0f, value) >> 24u) / 255.0f;
+        }
+    };
+
+    // The immediate pass rounded timeline positions and NDC from doubles. The
+    // shader has only floats, and GL may fuse a multiply into the add after
+    // it, so it carries those quotients as unevaluated float pairs (hi + lo)
+    // built from products of 12-bit halves, which are exact fused or not.
+    // Each result is the double computation's float unless the exact value
+    // lies within about 2^-20 ulp of a rounding tie.
+    namespace detail {
+        // std::clamp's order of tests, which also decides when lo > hi.
+        inline float clampOrdered(float v, float lo, float hi) {
+            return v < lo ? lo : (hi < v ? hi : v);
+        }
+
+        // a == hi + lo, hi keeping the top 12 significant bits.
+        inline void split(float a, float& hi, float& lo) {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &a, sizeof(bits));
+            bits &= 0xfffff000u;
+            std::memcpy(&hi, &bits, sizeof(hi));
+            lo = a - hi;
+        }
+
+        // s + e == a + b exactly.
+        inline void twoSum(float a, float b, float& s, float& e) {
+            s = a + b;
+            const float bb = s - a;
+            e = (a - (s - bb)) + (b - bb);
+        }
+
+        // p + e == a * b, p the rounded product.
+        inline void twoProd(float a, float b, float& p, float& e) {
+            float ah = 0.0f, al = 0.0f, bh = 0.0f, bl = 0.0f;
+            split(a, ah, al);
+            split(b, bh, bl);
+            float s0 = 0.0f, e0 = 0.0f, s1 = 0.0f, e1 = 0.0f, s2 = 0.0f, e2 = 0.0f;
+            twoSum(ah * bh, ah * bl, s0, e0);
+            twoSum(s0, al * bh, s1, e1);
+            twoSum(s1, al * bl, s2, e2);
+            const float rest = (e0 + e1) + e2;
+            p = s2 + rest;
+            e = rest - (p - s2);
+        }
+
+        // (nh + nl) / (dh + dl) as q + qe, q the rounded quotient.
+        inline void divide(float nh, float nl, float dh, float dl, float& q, float& qe) {
+            const float q0 = nh / dh;
+            float p = 0.0f, pe = 0.0f, r = 0.0f, re = 0.0f;
+            twoProd(q0, dh, p, pe);
+            twoSum(nh, -p, r, re);
+            float ql = 0.0f, qle = 0.0f;
+            twoProd(q0, dl, ql, qle);
+            const float q1 = ((r + (re - pe)) + (nl - ql)) / dh;
+            q = q0 + q1;
+            qe = q1 - (q - q0);
+        }
+
+        // float(laneLeft + (laneRight - laneLeft) * float((s - offset) / window)).
+        inline float timelineX(const Transform& t, const float* sample) {
+            float dh = 0.0f, dl = 0.0f, ratio = 0.0f, ratioLo = 0.0f, span = 0.0f, spanLo = 0.0f;
+            twoSum(sample[0] - t.offset[0], sample[1] - t.offset[1], dh, dl);
+            divide(dh, dl, t.window[0], t.window[1], ratio, ratioLo);
+            twoProd(t.laneRight - t.laneLeft, ratio, span, spanLo);
+            return t.laneLeft + span;
+        }
+    }
+
+    // Window-pixel position of `v` under `t`, as UILane.vert.glsl computes it.
+    inline void place(const Transform& t, const Vertex& v, float& x, float& y) {
+        const Kind kind = static_cast<Kind>(v.meta & 15u);
+        x = v.dx;
+        if (kind == Kind::Edge) {
+            x = std::min(std::max(detail::timelineX(t, v.anchor) + v.dx, t.laneLeft), t.laneRight);
+        } else if (kind == Kind::Tick) {
+            x = std::min(std::max(detail::timelineX(t, v.anchor), t.laneLeft + 1.0f), t.laneRight - 1.0f) + v.dx;
+        } else if (kind == Kind::Note) {
+            // A note collapses to its left edge when the old pass skipped it.
+            const float lo = std::max(detail::timelineX(t, v.clip), t.laneLeft) + 1.0f;
+            const float hi = std::min(detail::timelineX(t, v.clip + 2), t.laneRight) - 1.0f;
+            const float own = detail::clampOrdered(detail::timelineX(t, v.anchor), lo, hi);
+            const float other = detail::clampOrdered(detail::timelineX(t, v.anchor + 2), lo, hi);
+            const bool right = ((v.meta >> 4u) & 1u) != 0u;
+            const float x0 = right ? other : own;
+            const float x1 = right ? own : other;
+            x = (x1 <= x0 + 0.5f) ? x0 : own;
+        }
+        const uint32_t lane = v.meta >> 8u;
+        const float center = lane < t.centerY.size() ? t.centerY[lane] : 0.0f;
+        y = (center + v.dy[0]) + v.dy[1];
+    }
+
+    // The shader's gl_Position for window pixel (x, y): the immediate pass's
+    // pixelToNDC, float((x / width) * 2.0 - 1.0) and float(1.0 - (y / height) * 2.0).
+    // Both are divided as (2x - width) / width with the numerator exact, so
+    // points near the middle of the screen keep their precision.
+    inline void toNdc(const Transform& t, float x, float y, float& ndcX, float& ndcY) {
+        float s = 0.0f, e = 0.0f, qe = 0.0f;
+        detail::twoSum(2.0f * x, -t.screenWidth, s, e);
+        detail::divide(s, e, t.screenWidth, 0.0f, ndcX, qe);
+        detail::twoSum(t.screenHeight, -2.0f * y, s, e);
+        detail::divide(s, e, t.screenHeight, 0.0f, ndcY, qe);
+    }
+
+    // Lane vertices kept across frames. Each segment owns a span of the
+    // vertex array; rewriting it in place marks only that span dirty, and a
+    // segment that outgrows its span moves to the end. Moves leave holes that
+    // are compacted away once they outweigh the live vertices, which bumps
+    // generation() so the render side replaces its copy whole.
+    class Store {
+    public:
+        static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+        // Pixel extent of a segment: window x of its Window vertices, the
+        // samples and dx its timeline vertices are placed from, and y
+        // relative to its lane.
+        struct Extent {
+            float minX = 0.0f;
+            float maxX = 0.0f;
+            float minY = 0.0f;
+            float maxY = 0.0f;
+            double minSample = 0.0;
+            double maxSample = 0.0;
+            float minDx = 0.0f;
+            float maxDx = 0.0f;
+            bool window = false;
+            bool timeline = false;
+        };
+
+        Transform transform;
+
+        Store() : storeId(nextId()) {}
+        Store(const Store&) = delete;
+        Store& operator=(const Store&) = delete;
+
+        // Names the render side's buffer; UIBatch layers are id() | page << 16.
+        uint32_t id() const { return storeId; }
+        uint64_t generation() const { return gen; }
+        // Changes with every write; plans composed before it are stale.
+        uint64_t revision() const { return rev; }
+        const std::vector<Vertex>& vertices() const { return data; }
+
+        // Makes `segment` hold `source`, allocating it when it is kNone.
+        void write(uint32_t& segment, const std::vector<Vertex>& source) {
+            if (segment >= spans.size() || !spans[segment].live) segment = allocate();
+            Span& span = spans[segment];
+            const uint32_t count = static_cast<uint32_t>(source.size());
+            if (count > span.capacity) {
+                wasted += span.capacity;
+                span.first = static_cast<uint32_t>(data.size());
+                span.capacity = count + count / 4;
+                data.resize(data.size() + span.capacity);
+            }
+            std::copy(source.begin(), source.end(), data.begin() + span.first);
+            span.count = count;
+            span.extent = measure(source);
+            touch(span.first, count);
+            rev += 1;
+            if (wasted > kCompactSlack && wasted * 2 > data.size()) compact();
+        }
+
+        void release(uint32_t& segment) {
+            if (segment < spans.size() && spans[segment].live) {
+                wasted += spans[segment].capacity;
+                spans[segment] = Span{};
+                freeList.push_back(segment);
+                rev += 1;
+            }
+            segment = kNone;
+        }
+
+        UIBatch::Range range(uint32_t segment) const {
+            if (segment >= spans.size()) return {};
+            return {spans[segment].first, spans[segment].count};
+        }
+
+        Extent extent(uint32_t segment) const {
+            return segment < spans.size() ? spans[segment].extent : Extent{};
+        }
+
+        // Vertex ranges written since the last call, sorted and merged.
+        std::vector<UIBatch::Range> takeDirty() {
+            std::vector<UIBatch::Range> merged;
+            std::sort(dirty.begin(), dirty.end(),
+                      [](const UIBatch::Range& a, const UIBatch::Range& b) { return a.first < b.first; });
+            for (const UIBatch::Range& range : dirty) {
+                if (!merged.empty() && range.first <= merged.back().first + merged.back().count) {
+                    const uint32_t end = std::max(merged.back().first + merged.back().count, range.first + range.count);
+                    merged.back().count = end - merged.back().first;
+                } else {
+                    merged.push_back(range);
+                }
+            }
+            dirty.clear();
+            return merged;
+        }
+
+    private:
+        static constexpr size_t kCompactSlack = 64 * 1024;
+
+        struct Span {
+            uint32_t first = 0;
+            uint32_t count = 0;
+            uint32_t capacity = 0;
+            bool live = false;
+            Extent extent;
+        };
+
+        uint32_t storeId = 0;
+        uint64_t gen = 0;
+        uint64_t rev = 0;
+        size_t wasted = 0;
+        std::vector<Vertex> data;
+        std::vector<Span> spans;
+        std::vector<uint32_t> freeList;
+        std::vector<UIBatch::Range> dirty;
+
+        static uint32_t nextId() {
+            static uint32_t next = 0;
+            return ++next;
+        }
+
+        uint32_t allocate() {
+            uint32_t segment = 0;
+            if (!freeList.empty()) {
+                segment = freeList.back();
+                freeList.pop_back();
+            } else {
+                segment = static_cast<uint32_t>(spans.size());
+                spans.emplace_back();
+            }
+            spans[segment].live = true;
+            return segment;
+        }
+
+        void touch(uint32_t first, uint32_t count) {
+            if (count > 0) dirty.push_back({first, count});
+        }
+
+        static Extent measure(const std::vector<Vertex>& source) {
+            Extent extent;
+            extent.minX = extent.minY = std::numeric_limits<float>::max();
+            extent.maxX = extent.maxY = -std::numeric_limits<float>::max();
+            for (const Vertex& v : source) {
+                const float y = v.dy[0] + v.dy[1];
+                extent.minY = std::min(extent.minY, y);
+                extent.maxY = std::max(extent.maxY, y);
+                if ((v.meta & 15u) == static_cast<uint32_t>(Kind::Window)) {
+                    extent.minX = std::min(extent.minX, v.dx);
+                    extent.maxX = std::max(extent.maxX, v.dx);
+                    extent.window = true;
+                } else {
+                    // A note is placed inside its clip.
+                    const float* sample = (v.meta & 15u) == static_cast<uint32_t>(Kind::Note) ? v.clip : v.anchor;
+                    const double first = static_cast<double>(sample[0]) + static_cast<double>(sample[1]);
+                    const double last = (v.meta & 15u) == static_cast<uint32_t>(Kind::Note)
+                        ? static_cast<double>(sample[2]) + static_cast<double>(sample[3])
+                        : first;
+                    if (!extent.timeline) {
+                        extent.minSample = first;
+                        extent.maxSample = last;
+                        extent.minDx = extent.maxDx = v.dx;
+                    }
+                    extent.minSample = std::min(extent.minSample, first);
+                    extent.maxSample = std::max(extent.maxSample, last);
+                    extent.minDx = std::min(extent.minDx, v.dx);
+                    extent.maxDx = std::max(extent.maxDx, v.dx);
+                    extent.timeline = true;
+                }
+            }
+            return extent;
+        }
+
+        void compact() {
+            std::vector<uint32_t> order;
+            for (uint32_t s = 0; s < spans.size(); ++s) {
+                if (spans[s].live) order.push_back(s);
+            }
+            std::sort(order.begin(), order.end(),
+                      [&](uint32_t a, uint32_t b) { return spans[a].first < spans[b].first; });
+            std::vector<Vertex> packed;
+            for (uint32_t s : order) {
+                Span& span = spans[s];
+                const uint32_t first = static_cast<uint32_t>(packed.size());
+                packed.insert(packed.end(), data.begin() + span.first, data.begin() + span.first + span.count);
+                span.first = first;
+                span.capacity = span.count;
+            }
+            data.swap(packed);
+            wasted = 0;
+            dirty.clear();
+            gen += 1;
+        }
+    };
+
+    // A segment of a Store as the lane systems keep it: rewritten when the
+    // inputs it was keyed on change.
+    struct Segment {
+        uint64_t key = 0;
+        bool built = false;
+        uint32_t id = Store::kNone;
+
+        // True, recording `newKey`, unless the segment was built from it.
+        bool rebuild(uint64_t newKey) {
+            if (built && key == newKey) return false;
+            key = newKey;
+            built = true;
+            return true;
+        }
+    };
+
+    // What one frame draws from a Store, in painter's order: steps of vertex
+    // ranges with the text that goes between them. Composed again only when
+    // the view, the rows or a segment change; submitted every frame.
+    class Plan {
+    public:
+        void clear() {
+            ranges.clear();
+            steps.clear();
+            text.clear();
+            open = false;
+        }
+
+        UIBatch::TextOverlay& labels() { return text; }
+        const UIBatch::TextOverlay& labels() const { return text; }
+        size_t rangeCount() const { return ranges.size(); }
+
+        // Queues vertices [first, first + count) of `segment`, drawn for
+        // `lane` at `centerY`.
+        void add(const Store& store, uint32_t segment, uint32_t first, uint32_t count,
+                 uint32_t lane, float centerY, const View& view) {
+            add(store, segment, first, count, lane, boundsOf(store.extent(segment), centerY, view));
+        }
+
+        // The same with the window-pixel rectangle those vertices cover, for
+        // callers that place them exactly as the shader will.
+        void add(const Store& store, uint32_t segment, uint32_t first, uint32_t count,
+                 uint32_t lane, float minX, float maxX, float minY, float maxY, const View& view) {
+            add(store, segment, first, count, lane, pixelBounds(minX, maxX, minY, maxY, view));
+        }
+
+        void add(const Store& store, uint32_t segment, uint32_t lane, float centerY, const View& view) {
+            add(store, segment, 0, store.range(segment).count, lane, centerY, view);
+        }
+
+        // Closes the current step and returns the `at` for text drawn after
+        // everything queued so far.
+        size_t mark() {
+            open = false;
+            return steps.size();
+        }
+
+        void submit(UIBatch::Builder& batch, const Store& store, const UIBatch::Clip& clip = UIBatch::Clip{}) const {
+            size_t nextMark = 0;
+            for (size_t s = 0; s <= steps.size(); ++s) {
+                while (nextMark < text.marks.size() && text.marks[nextMark].at <= s) {
+                    const UIBatch::TextOverlay::Mark& mark = text.marks[nextMark++];
+                    batch.addPacked(UIBatch::Program::Text, mark.texture, text.vertices.data() + mark.first,
+                                    mark.count, store.transform.alpha, clip);
+                }
+                if (s == steps.size()) break;
+                const Step& step = steps[s];
+                batch.addRanges(store.id() | (step.page << 16u), ranges.data() + step.firstRange, step.rangeCount,
+                                step.bounds, clip);
+            }
+        }
+
+    private:
+        void add(const Store& store, uint32_t segment, uint32_t first, uint32_t count, uint32_t lane,
+                 const UIBatch::Bounds& bounds) {
+            const UIBatch::Range whole = store.range(segment);
+            if (segment == Store::kNone || first >= whole.count) return;
+            count = std::min(count, whole.count - first);
+            if (count == 0) return;
+            const uint32_t page = lane / kLanesPerPage;
+            if (!open || steps.back().page != page) {
+                steps.push_back({page, static_cast<uint32_t>(ranges.size()), 0, bounds});
+                open = true;
+            }
+            Step& step = steps.back();
+            step.bounds.merge(bounds);
+            const uint32_t start = whole.first + first;
+            if (step.rangeCount > 0 && ranges.back().first + ranges.back().count == start) {
+                ranges.back().count += count;
+                return;
+            }
+            ranges.push_back({start, count});
+            step.rangeCount += 1;
+        }
+
+        struct Step {
+            uint32_t page = 0;
+            uint32_t firstRange = 0;
+            uint32_t rangeCount = 0;
+            UIBatch::Bounds bounds;
+        };
+
+        std::vector<UIBatch::Range> ranges;
+        std::vector<Step> steps;
+        UIBatch::TextOverlay text;
+        bool open = false;
+
+        // NDC rectangle, a pixel wider on every side than `extent` on a lane
+        // at `centerY`.
+        static UIBatch::Bounds boundsOf(const Store::Extent& extent, float centerY, const View& view) {
+            float minX = std::numeric_limits<float>::max();
+            float maxX = -std::numeric_limits<float>::max();
+            if (extent.window) {
+                minX = extent.minX;
+                maxX = extent.maxX;
+            }
+            if (extent.timeline) {
+                // Timeline x is clamped to the lane (a tick or note edge to a
+                // pixel inside it) before dx, so a pixel more either side of
+                // its samples' positions covers every vertex.
+                float left = view.laneLeft;
+                float right = view.laneRight;
+                if (view.valid()) {
+                    auto at = [&](double sample) {
+                        const double t = (sample - view.offsetSamples) / view.windowSamples;
+                        const double x = view.laneLeft + (static_cast<double>(view.laneRight) - view.laneLeft) * t;
+                        return static_cast<float>(std::clamp(x, static_cast<double>(view.laneLeft),
+                                                             static_cast<double>(view.laneRight)));
+                    };
+                    left = at(extent.minSample) + std::min(extent.minDx, 0.0f) - 1.0f;
+                    right = at(extent.maxSample) + std::max(extent.maxDx, 0.0f) + 1.0f;
+                }
+                minX = std::min(minX, left);
+                maxX = std::max(maxX, right);
+            }
+            return pixelBounds(minX - 1.0f, maxX + 1.0f, centerY + extent.minY - 1.0f, centerY + extent.maxY + 1.0f,
+                               view);
+        }
+
+        // NDC rectangle of window pixels, converted as pixelToNDC converts vertices.
+        static UIBatch::Bounds pixelBounds(float minX, float maxX, float minY, float maxY, const View& view) {
+            const double w = view.screenWidth;
+            const double h = view.screenHeight;
+            UIBatch::Bounds bounds;
+            bounds.minX = static_cast<float>((minX / w) * 2.0 - 1.0);
+            bounds.maxX = static_cast<float>((maxX / w) * 2.0 - 1.0);
+            bounds.minY = static_cast<float>(1.0 - (maxY / h) * 2.0);
+            bounds.maxY = static_cast<float>(1.0 - (minY / h) * 2.0);
+            return bounds;
+        }
+    };
+
+    // The lane systems' computeClipRect.
+    inline void clipRect(float centerY, float laneHalfH, float& top, float& bottom, float& lipBottom) {
+        top = centerY - laneHalfH + kClipVerticalInset;
+        bottom = centerY + laneHalfH - kClipVerticalInset;
+        if (bottom < top + kClipMinHeight) {
+            float mid = (top + bottom) * 0.5f;
+            top = mid - (kClipMinHeight * 0.5f);
+            bottom = mid + (kClipMinHeight * 0.5f);
+        }
+        float lipHeight = std::clamp((bottom - top) * 0.18f, kClipLipMinHeight, kClipLipMaxHeight);
+        lipBottom = std::min(bottom, top + lipHeight);
+    }
+
+    // Vertex builders. y is given as the two dy terms; quads are written in
+    // pushQuad's order (a b c, a c d) with corners a b c d clockwise from the
+    // top left.
+    namespace detail {
+        inline Vertex windowVertex(uint32_t lane, float x, float dy0, float dy1, uint32_t color) {
+            Vertex v;
+            v.dx = x;
+            v.dy[0] = dy0;
+            v.dy[1] = dy1;
+            v.color = color;
+            v.meta = meta(Kind::Window, lane);
+            return v;
+        }
+
+        inline Vertex timelineVertex(Kind kind, uint32_t lane, uint64_t sample, float dx, float dy0, float dy1,
+                                     uint32_t color) {
+            Vertex v;
+            splitSample(sample, v.anchor);
+            v.dx = dx;
+            v.dy[0] = dy0;
+            v.dy[1] = dy1;
+            v.color = color;
+            v.meta = meta(kind, lane);
+            return v;
+        }
+
+        inline void pushQuad(std::vector<Vertex>& out, const Vertex& a, const Vertex& b, const Vertex& c,
+                             const Vertex& d) {
+            out.push_back(a);
+            out.push_back(b);
+            out.push_back(c);
+            out.push_back(a);
+            out.push_back(c);
+            out.push_back(d);
+        }
+
+        inline void pushWindowRect(std::vector<Vertex>& out, uint32_t lane, float x0, float x1,
+                                   float top0, float top1, float bottom0, float bottom1, uint32_t color) {
+            pushQuad(out,
+                     windowVertex(lane, x0, top0, top1, color),
+                     windowVertex(lane, x1, top0, top1, color),
+                     windowVertex(lane, x1, bottom0, bottom1, color),
+                     windowVertex(lane, x0, bottom0, bottom1, color));
+        }
+
+        // dy terms for std::clamp(base + delta, lo, hi) as the immediate pass
+        // rounded it with base, lo and hi already on the lane: the clamp is
+        // decided exactly, and an unclamped y keeps base and delta apart so
+        // the shader adds them to the center in the old order.
+        inline void clampedDy(float base, float delta, float lo, float hi, float* dy) {
+            const double y = static_cast<double>(base) + static_cast<double>(delta);
+            if (y < lo) {
+                dy[0] = lo;
+                dy[1] = 0.0f;
+            } else if (hi < y) {
+                dy[0] = hi;
+                dy[1] = 0.0f;
+            } else {
+                dy[0] = base;
+                dy[1] = delta;
+            }
+        }
+    }
+
+    // The systems' pushBevelBox for a box centered on the lane: a front
+    // face with its top and left bevels drawn over it.
+    inline void pushBevelBox(std::vector<Vertex>& out, uint32_t lane, float left, float halfHeight, float right,
+                             float bevelDepth, uint32_t front, uint32_t topColor, uint32_t side) {
+        using detail::windowVertex;
+        const Vertex frontA = windowVertex(lane, left, -halfHeight, 0.0f, front);
+        const Vertex frontB = windowVertex(lane, right, -halfHeight, 0.0f, front);
+        const Vertex frontC = windowVertex(lane, right, halfHeight, 0.0f, front);
+        const Vertex frontD = windowVertex(lane, left, halfHeight, 0.0f, front);
+        detail::pushQuad(out, frontA, frontB, frontC, frontD);
+        auto recolor = [](Vertex v, uint32_t color) {
+            v.color = color;
+            return v;
+        };
+        detail::pushQuad(out,
+                         recolor(frontA, topColor),
+                         recolor(frontB, topColor),
+                         windowVertex(lane, right - bevelDepth, -halfHeight, -bevelDepth, topColor),
+                         windowVertex(lane, left - bevelDepth, -halfHeight, -bevelDepth, topColor));
+        detail::pushQuad(out,
+                         recolor(frontA, side),
+                         recolor(frontD, side),
+                         windowVertex(lane, left - bevelDepth, halfHeight, -bevelDepth, side),
+                         windowVertex(lane, left - bevelDepth, -halfHeight, -bevelDepth, side));
+    }
+
+    // Stereo divider across the lane.
+    inline void pushSplit(std::vector<Vertex>& out, uint32_t lane, float laneLeft, float laneRight, uint32_t color) {
+        detail::pushWindowRect(out, lane, laneLeft, laneRight, 0.0f, -0.5f, 0.0f, 0.5f, color);
+    }
+
+    // Layout of a clip segment written by pushClip.
+    struct ClipLayout {
+        uint32_t bodyVertices = 0;  // body and lip
+        uint32_t ticks = 0;         // beat ticks from the clip start, six vertices each
+    };
+
+    // A clip's body, lip and every beat tick it has (up to kMaxClipTicks);
+    // planClip picks the ones a frame shows.
+    inline ClipLayout pushClip(std::vector<Vertex>& out, uint32_t lane, float laneHalfH, uint64_t clipStart,
+                               uint64_t clipLength, uint64_t beatStepSamples, uint32_t bodyColor, uint32_t lipColor) {
+        ClipLayout layout;
+        if (clipLength == 0) return layout;
+        const size_t base = out.size();
+        float top = 0.0f;
+        float bottom = 0.0f;
+        float lipBottom = 0.0f;
+        clipRect(0.0f, laneHalfH, top, bottom, lipBottom);
+        const uint64_t clipEnd = clipStart + clipLength;
+        auto rect = [&](float yTop0, float yTop1, float yBottom0, float yBottom1, uint32_t color) {
+            using detail::timelineVertex;
+            detail::pushQuad(out,
+                             timelineVertex(Kind::Edge, lane, clipStart, -kClipHorizontalPad, yTop0, yTop1, color),
+                             timelineVertex(Kind::Edge, lane, clipEnd, kClipHorizontalPad, yTop0, yTop1, color),
+                             timelineVertex(Kind::Edge, lane, clipEnd, kClipHorizontalPad, yBottom0, yBottom1, color),
+                             timelineVertex(Kind::Edge, lane, clipStart, -kClipHorizontalPad, yBottom0, yBottom1, color));
+        };
+        // The immediate pass computed top as centerY - laneHalfH and the lip
+        // from there; keeping those as separate terms places them the same.
+        const bool unclamped = top == -laneHalfH && bottom == laneHalfH;
+        const float topTerm = unclamped ? -laneHalfH : top;
+        const float lipHeight = lipBottom - top;
+        rect(topTerm, 0.0f, unclamped ? laneHalfH : bottom, 0.0f, bodyColor);
+        if (lipBottom > top + 0.5f) {
+            if (lipBottom == bottom) {
+                rect(topTerm, 0.0f, unclamped ? laneHalfH : bottom, 0.0f, lipColor);
+            } else {
+                rect(topTerm, 0.0f, topTerm, lipHeight, lipColor);
+            }
+        }
+        layout.bodyVertices = static_cast<uint32_t>(out.size() - base);
+        if (beatStepSamples == 0) return layout;
+
+        const float markerTop = lipBottom + 1.0f;
+        const float maxTickHeight = std::max(3.0f, bottom - markerTop - 2.0f);
+        const float beatTickHeight = std::clamp(maxTickHeight * 0.30f, 3.0f, 8.0f);
+        const float barTickHeight = std::clamp(maxTickHeight * 0.52f, 5.0f, 13.0f);
+        const float phraseTickHeight = std::clamp(maxTickHeight * 0.68f, 7.0f, 16.0f);
+        const uint32_t barColor = UIBatch::packColor(0.02f, 0.02f, 0.02f, 0.0f);
+        const uint32_t beatColor = UIBatch::packColor(0.06f, 0.06f, 0.06f, 0.0f);
+        for (uint64_t localBeat = 0; localBeat < kMaxClipTicks; ++localBeat) {
+            const uint64_t offset = localBeat * beatStepSamples;
+            if (offset >= clipLength) break;
+            const uint64_t tick = clipStart + offset;
+            const bool isBar = ((localBeat % 4ull) == 0ull);
+            const bool isPhrase = ((localBeat % 16ull) == 0ull);
+            const float lineHalf = isBar ? 0.9f : 0.45f;
+            const uint32_t color = isBar ? barColor : beatColor;
+            const float height = isPhrase ? phraseTickHeight : (isBar ? barTickHeight : beatTickHeight);
+            const bool reachesBottom = markerTop + height > bottom - 1.0f;
+            const float topTerm0 = unclamped ? -laneHalfH : markerTop;
+            const float topTerm1 = unclamped ? (lipBottom - top) + 1.0f : 0.0f;
+            float bottomTerm0 = topTerm0;
+            float bottomTerm1 = unclamped ? topTerm1 + height : height;
+            if (reachesBottom) {
+                bottomTerm0 = unclamped ? laneHalfH : bottom;
+                bottomTerm1 = -1.0f;
+            }
+            using detail::timelineVertex;
+            detail::pushQuad(out,
+                             timelineVertex(Kind::Tick, lane, tick, -lineHalf, topTerm0, topTerm1, color),
+                             timelineVertex(Kind::Tick, lane, tick, lineHalf, topTerm0, topTerm1, color),
+                             timelineVertex(Kind::Tick, lane, tick, lineHalf, bottomTerm0, bottomTerm1, color),
+                             timelineVertex(Kind::Tick, lane, tick, -lineHalf, bottomTerm0, bottomTerm1, color));
+            layout.ticks += 1;
+        }
+        return layout;
+    }
+
+    // Queues what the view shows of a clip written by pushClip: its body and
+    // lip, then the ticks from the first visible one on, and calls
+    // label(at, x, y, text) wherever the immediate pass placed a bar.beat
+    // label, splitting the ticks around it. Every decision uses the
+    // immediate pass's arithmetic. False if the clip is out of view.
+    template <class LabelFn>
+    bool planClip(Plan& plan, const Store& store, uint32_t segment, const ClipLayout& layout, uint32_t lane,
+                  float centerY, float laneHalfH, const View& view, uint64_t clipStartSample, uint64_t clipLength,
+                  uint64_t beatStepSamples, LabelFn&& label) {
+        if (segment == Store::kNone || clipLength == 0 || !view.valid()) return false;
+        const double offsetSamples = view.offsetSamples;
+        const double windowSamples = view.windowSamples;
+        const float laneLeft = view.laneLeft;
+        const float laneRight = view.laneRight;
+        const double clipStart = static_cast<double>(clipStartSample);
+        const double clipEnd = static_cast<double>(clipStartSample + clipLength);
+        if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) return false;
+        const double visibleStart = std::max(clipStart, offsetSamples);
+        const double visibleEnd = std::min(clipEnd, offsetSamples + windowSamples);
+        const float t0 = static_cast<float>((visibleStart - offsetSamples) / windowSamples);
+        const float t1 = static_cast<float>((visibleEnd - offsetSamples) / windowSamples);
+        float x0 = laneLeft + (laneRight - laneLeft) * t0 - kClipHorizontalPad;
+        float x1 = laneLeft + (laneRight - laneLeft) * t1 + kClipHorizontalPad;
+        x0 = std::max(x0, laneLeft);
+        x1 = std::min(x1, laneRight);
+        if (x1 < laneLeft || x0 > laneRight) return false;
+        plan.add(store, segment, 0, layout.bodyVertices, lane, centerY, view);
+        if (beatStepSamples == 0 || !(x1 > x0 + 2.0f)) return true;
+        const uint64_t visibleStartSample = static_cast<uint64_t>(std::max(visibleStart, 0.0));
+        const uint64_t visibleEndSample = static_cast<uint64_t>(std::max(visibleEnd, 0.0));
+        if (visibleEndSample <= visibleStartSample) return true;
+
+        uint64_t tick = clipStartSample;
+        uint64_t localBeat = 0;
+        if (visibleStartSample > clipStartSample) {
+            uint64_t delta = visibleStartSample - clipStartSample;
+            localBeat = (delta + beatStepSamples - 1) / beatStepSamples;
+            tick = clipStartSample + localBeat * beatStepSamples;
+        }
+        float top = 0.0f;
+        float bottom = 0.0f;
+        float lipBottom = 0.0f;
+        clipRect(centerY, laneHalfH, top, bottom, lipBottom);
+        const float markerTop = lipBottom + 1.0f;
+        const float maxTickHeight = std::max(3.0f, bottom - markerTop - 2.0f);
+        const float beatTickHeight = std::clamp(maxTickHeight * 0.30f, 3.0f, 8.0f);
+        const float barTickHeight = std::clamp(maxTickHeight * 0.52f, 5.0f, 13.0f);
+        const float phraseTickHeight = std::clamp(maxTickHeight * 0.68f, 7.0f, 16.0f);
+        float lastLabelX = -10000.0f;
+        // Ticks are queued in runs between labels, each with the pixels it
+        // covers, so labels and ticks that do not overlap still batch.
+        uint64_t runStart = localBeat;
+        float runLeft = std::numeric_limits<float>::max();
+        float runRight = -std::numeric_limits<float>::max();
+        float runBottom = markerTop;
+        auto flushTicks = [&](uint64_t end) {
+            if (end <= runStart) return;
+            plan.add(store, segment, layout.bodyVertices + static_cast<uint32_t>(runStart) * 6u,
+                     static_cast<uint32_t>(end - runStart) * 6u, lane, runLeft, runRight, markerTop, runBottom, view);
+            runStart = end;
+            runLeft = std::numeric_limits<float>::max();
+            runRight = -std::numeric_limits<float>::max();
+            runBottom = markerTop;
+        };
+        int guard = 0;
+        while (tick < visibleEndSample && guard < kBeatTickGuard && localBeat < layout.ticks) {
+            float tt = static_cast<float>((static_cast<double>(tick) - offsetSamples) / windowSamples);
+            float x = laneLeft + (laneRight - laneLeft) * tt;
+            x = std::clamp(x, x0 + 1.0f, x1 - 1.0f);
+            bool isBar = ((localBeat % 4ull) == 0ull);
+            bool isPhrase = ((localBeat % 16ull) == 0ull);
+            float lineHalf = isBar ? 0.9f : 0.45f;
+            float markerBottom = markerTop + (isPhrase ? phraseTickHeight : (isBar ? barTickHeight : beatTickHeight));
+            markerBottom = std::min(markerBottom, bottom - 1.0f);
+            runLeft = std::min(runLeft, x - lineHalf);
+            runRight = std::max(runRight, x + lineHalf);
+            runBottom = std::max(runBottom, markerBottom);
+            if ((x - lastLabelX) >= 46.0f
+                && (x + 30.0f) <= (x1 - 2.0f)
+                && (markerBottom + 10.0f) <= (bottom - 2.0f)) {
+                flushTicks(localBeat + 1);
+                uint64_t barIndex = (localBeat / 4ull) + 1ull;
+                uint64_t beatInBar = (localBeat % 4ull) + 1ull;
+                char text[24];
+                std::snprintf(text, sizeof(text), "%llu.%llu.1",
+                              static_cast<unsigned long long>(barIndex),
+                              static_cast<unsigned long long>(beatInBar));
+                label(plan.mark(), x + 2.0f, markerBottom + 2.0f, text);
+                lastLabelX = x;
+            }
+            tick += beatStepSamples;
+            ++guard;
+            ++localBeat;
+        }
+        flushTicks(localBeat);
+        return true;
+    }
+
+    // Notes of a MIDI clip on the immediate pass's 84-row pitch scale, their
+    // x clamped inside the clip by the shader. color(pitch) gives the packed
+    // color. Notes is a container of {pitch, startSample, length} with start
+    // relative to the clip.
+    constexpr int kNoteBasePitch = 24;
+    constexpr int kNoteRows = 84;
+
+    template <class Notes, class ColorFn>
+    void pushNotes(std::vector<Vertex>& out, uint32_t lane, float laneHalfH, uint64_t clipStart, uint64_t clipLength,
+                   const Notes& notes, ColorFn&& color) {
+        if (clipLength == 0) return;
+        float top = 0.0f;
+        float bottom = 0.0f;
+        float lipBottom = 0.0f;
+        clipRect(0.0f, laneHalfH, top, bottom, lipBottom);
+        float noteTop = std::min(bottom, lipBottom + 1.0f);
+        float noteBottom = std::max(noteTop + 1.0f, bottom - 1.0f);
+        float noteHeight = noteBottom - noteTop;
+        if (noteHeight <= 0.5f) return;
+        Vertex base;
+        splitSample(clipStart, base.clip);
+        splitSample(clipStart + clipLength, base.clip + 2);
+        for (const auto& note : notes) {
+            if (note.length == 0) continue;
+            int row = std::clamp(note.pitch - kNoteBasePitch, 0, kNoteRows - 1);
+            float rowT0 = static_cast<float>(row) / static_cast<float>(kNoteRows);
+            float rowT1 = static_cast<float>(row + 1) / static_cast<float>(kNoteRows);
+            float y0 = noteBottom - rowT1 * noteHeight;
+            float y1 = noteBottom - rowT0 * noteHeight;
+            if (y1 < y0 + 1.0f) y1 = y0 + 1.0f;
+            if (y0 < noteTop) y0 = noteTop;
+            if (y1 > noteBottom) y1 = noteBottom;
+            if (y1 <= y0) continue;
+            const uint64_t noteStart = clipStart + note.startSample;
+            const uint64_t noteEnd = noteStart + note.length;
+            auto edge = [&](uint32_t side, float y) {
+                Vertex v = base;
+                splitSample(side == 0 ? noteStart : noteEnd, v.anchor);
+                splitSample(side == 0 ? noteEnd : noteStart, v.anchor + 2);
+                v.dy[0] = y;
+                v.color = color(note.pitch);
+                v.meta = meta(Kind::Note, lane, side);
+                return v;
+            };
+            detail::pushQuad(out, edge(0, y0), edge(1, y0), edge(1, y1), edge(0, y1));
+        }
+    }
+
+    // Whether the immediate pass drew a MIDI clip's notes this frame.
+    inline bool notesVisible(const View& view, uint64_t clipStartSample, uint64_t clipLength) {
+        if (clipLength == 0 || !view.valid()) return false;
+        const double offsetSamples = view.offsetSamples;
+        const double windowSamples = view.windowSamples;
+        const double clipStart = static_cast<double>(clipStartSample);
+        const double clipEnd = static_cast<double>(clipStartSample + clipLength);
+        if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) return false;
+        const double clipVisibleStart = std::max(clipStart, offsetSamples);
+        const double clipVisibleEnd = std::min(clipEnd, offsetSamples + windowSamples);
+        float clipT0 = static_cast<float>((clipVisibleStart - offsetSamples) / windowSamples);
+        float clipT1 = static_cast<float>((clipVisibleEnd - offsetSamples) / windowSamples);
+        float clipX0 = view.laneLeft + (view.laneRight - view.laneLeft) * clipT0;
+        float clipX1 = view.laneLeft + (view.laneRight - view.laneLeft) * clipT1;
+        clipX0 = std::max(clipX0, view.laneLeft);
+        clipX1 = std::min(clipX1, view.laneRight);
+        return clipX1 > clipX0;
+    }
+
+    // Waveform columns are sampled per window pixel, so they are rebuilt
+    // whenever the view moves horizontally. Each takes the immediate pass's
+    // column loop and writes what its column quad did.
+
+    // column(x, s0, s1) for each lane pixel an audio clip covers.
+    template <class ColumnFn>
+    void clipColumns(const View& view, uint64_t clipStartSample, uint64_t clipLength, ColumnFn&& column) {
+        const double offsetSamples = view.offsetSamples;
+        const double windowSamples = view.windowSamples;
+        const int pixelWidth = static_cast<int>(view.laneRight - view.laneLeft);
+        if (pixelWidth <= 0 || windowSamples <= 0.0 || clipLength == 0) return;
+        const double samplesPerPixel = windowSamples / static_cast<double>(pixelWidth);
+        const double clipStart = static_cast<double>(clipStartSample);
+        const double clipEnd = static_cast<double>(clipStartSample + clipLength);
+        if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) return;
+        const int xBegin = std::max(0, static_cast<int>(std::floor((clipStart - offsetSamples) / samplesPerPixel)));
+        const int xEnd = std::min(pixelWidth, static_cast<int>(std::ceil((clipEnd - offsetSamples) / samplesPerPixel)));
+        for (int x = xBegin; x < xEnd; ++x) {
+            const double s0 = std::max(clipStart, offsetSamples + static_cast<double>(x) * samplesPerPixel);
+            const double s1 = std::min(clipEnd, offsetSamples + static_cast<double>(x + 1) * samplesPerPixel);
+            if (s1 <= s0) continue;
+            column(x, s0, s1);
+        }
+    }
+
+    // column(x, samplePos) for each lane pixel inside a recording preview.
+    template <class ColumnFn>
+    void previewColumns(const View& view, uint64_t previewStart, uint64_t previewEnd, ColumnFn&& column) {
+        const int pixelWidth = static_cast<int>(view.laneRight - view.laneLeft);
+        if (pixelWidth <= 0 || view.windowSamples <= 0.0) return;
+        const double samplesPerPixel = view.windowSamples / static_cast<double>(pixelWidth);
+        for (int x = 0; x < pixelWidth; ++x) {
+            double samplePos = view.offsetSamples + static_cast<double>(x) * samplesPerPixel;
+            if (samplePos < static_cast<double>(previewStart) || samplePos >= static_cast<double>(previewEnd)) continue;
+            column(x, samplePos);
+        }
+    }
+
+    // column(px, s0, s1) for each lane pixel of a MIDI track's rendered audio.
+    template <class ColumnFn>
+    void trackColumns(const View& view, ColumnFn&& column) {
+        const int pixelWidth = static_cast<int>(view.laneRight - view.laneLeft);
+        if (pixelWidth <= 0) return;
+        for (int px = 0; px < pixelWidth; ++px) {
+            double t0 = static_cast<double>(px) / static_cast<double>(pixelWidth);
+            double t1 = static_cast<double>(px + 1) / static_cast<double>(pixelWidth);
+            double s0 = view.offsetSamples + t0 * view.windowSamples;
+            double s1 = view.offsetSamples + t1 * view.windowSamples;
+            column(px, s0, s1);
+        }
+    }
+
+    // An audio column two pixels wide at window x xPos: mono about the lane
+    // center, or left over right in two regions either side of the split.
+    inline void pushWaveColumn(std::vector<Vertex>& out, uint32_t lane, float xPos, float laneHalfH, float ampScale,
+                               bool hasRightWave, float minVal, float maxVal, float minValR, float maxValR,
+                               uint32_t color, uint32_t rightColor) {
+        const float lineWidth = 1.0f;
+        const float x0 = xPos - lineWidth;
+        const float x1 = xPos + lineWidth;
+        if (hasRightWave) {
+            const float top = -laneHalfH;
+            const float bottom = laneHalfH;
+            const float splitY = 0.5f * (top + bottom);
+            const float regionGap = 1.0f;
+            const float topRegionTop = top;
+            const float topRegionBottom = splitY - regionGap;
+            const float bottomRegionTop = splitY + regionGap;
+            const float bottomRegionBottom = bottom;
+            const float topCenter = 0.5f * (topRegionTop + topRegionBottom);
+            const float bottomCenter = 0.5f * (bottomRegionTop + bottomRegionBottom);
+            const float topAmp = std::max(1.0f, (topRegionBottom - topRegionTop) * 0.45f);
+            const float bottomAmp = std::max(1.0f, (bottomRegionBottom - bottomRegionTop) * 0.45f);
+            float yTopL[2];
+            float yBottomL[2];
+            detail::clampedDy(topCenter, -(maxVal * topAmp), topRegionTop, topRegionBottom, yTopL);
+            detail::clampedDy(topCenter, -(minVal * topAmp), topRegionTop, topRegionBottom, yBottomL);
+            detail::pushWindowRect(out, lane, x0, x1, yTopL[0], yTopL[1], yBottomL[0], yBottomL[1], color);
+            float yTopR[2];
+            float yBottomR[2];
+            detail::clampedDy(bottomCenter, -(maxValR * bottomAmp), bottomRegionTop, bottomRegionBottom, yTopR);
+            detail::clampedDy(bottomCenter, -(minValR * bottomAmp), bottomRegionTop, bottomRegionBottom, yBottomR);
+            detail::pushWindowRect(out, lane, x0, x1, yTopR[0], yTopR[1], yBottomR[0], yBottomR[1], rightColor);
+        } else {
+            // max/min commute with adding the center, so these match
+            // max(centerY - maxVal * ampScale, top) and its mirror exactly.
+            const float yTop = std::max(-(maxVal * ampScale), -laneHalfH);
+            const float yBottom = std::min(-(minVal * ampScale), laneHalfH);
+            detail::pushWindowRect(out, lane, x0, x1, yTop, 0.0f, yBottom, 0.0f, color);
+        }
+    }
+
+    // A MIDI track's rendered-audio column one pixel wide at window x `x`.
+    inline void pushTrackWaveColumn(std::vector<Vertex>& out, uint32_t lane, float x, float laneHalfH, float ampScale,
+                                    float minVal, float maxVal, uint32_t color) {
+        float yMin = minVal * ampScale;
+        float yMax = maxVal * ampScale;
+        if (yMax < yMin) std::swap(yMax, yMin);
+        yMin = std::clamp(yMin, -laneHalfH, laneHalfH);
+        yMax = std::clamp(yMax, -laneHalfH, laneHalfH);
+        detail::pushWindowRect(out, lane, x, x + 1.0f, yMin, 0.0f, yMax, 0.0f, color);
+    }
+}
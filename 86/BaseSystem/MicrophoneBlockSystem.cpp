@@ -41,24 +41,25 @@ namespace RayTracedAudioSystemLogic {
                             int debugRayCount);
     void EmitRayStates(BaseSystem& baseSystem,
                        RayTraceBatch& batch,
+                       RayTracePropagationCache* propagation,
                        float maxDistance,
                        const glm::vec3& earForward,
                        const glm::vec3& earRight,
                        const glm::vec3& earUp,
-                       std::map<int, AudioSourceState>& states,
+                       AudioSourceStateBuffer& states,
                        int& statesVersion,
                        int finishedRaysCount,
                        bool finalUpdate);
-    void StepRayBatch(BaseSystem& baseSystem,
-                      RayTraceBatch& batch,
-                      float maxDistance,
-                      int maxBounces,
-                      int bounceStepsPerFrame,
-                      std::vector<RayDebugSegment>* debugSegments,
-                      const glm::vec3& whiteColor,
-                      const glm::vec3& blueColor,
-                      const glm::vec3& greenColor,
-                      const glm::vec3& orangeColor);
+    void TraceRayBatch(BaseSystem& baseSystem,
+                       RayTraceBatch& batch,
+                       RayTracePropagationCache* propagation,
+                       float maxDistance,
+                       int maxBounces,
+                       std::vector<RayDebugSegment>* debugSegments,
+                       const glm::vec3& whiteColor,
+                       const glm::vec3& blueColor,
+                       const glm::vec3& greenColor,
+                       const glm::vec3& orangeColor);
 }
 
 namespace MicrophoneBlockSystemLogic {
@@ -191,49 +192,37 @@ namespace MicrophoneBlockSystemLogic {
 
             if (!micBatch.active) return;
 
-            const int micBounceStepsPerFrame = 6;
             const glm::vec3 dummyColor(0.0f);
-            RayTracedAudioSystemLogic::StepRayBatch(baseSystem,
-                                                    micBatch,
-                                                    maxDistance,
-                                                    maxBounces,
-                                                    micBounceStepsPerFrame,
-                                                    nullptr,
-                                                    dummyColor,
-                                                    dummyColor,
-                                                    dummyColor,
-                                                    dummyColor);
-
-            auto emitMicStates = [&](int finishedRaysCount, bool finalUpdate) {
-                glm::vec3 earForward = micForward;
-                glm::vec3 earRight = glm::normalize(glm::cross(earForward, glm::vec3(0.0f, 1.0f, 0.0f)));
-                if (glm::length(earRight) < 1e-4f) earRight = glm::vec3(1.0f, 0.0f, 0.0f);
-                glm::vec3 earUp = glm::normalize(glm::cross(earRight, earForward));
-                if (glm::length(earUp) < 1e-4f) earUp = glm::vec3(0.0f, 1.0f, 0.0f);
+            RayTracedAudioSystemLogic::TraceRayBatch(baseSystem,
+                                                     micBatch,
+                                                     &rtAudio.micPropagation,
+                                                     maxDistance,
+                                                     maxBounces,
+                                                     nullptr,
+                                                     dummyColor,
+                                                     dummyColor,
+                                                     dummyColor,
+                                                     dummyColor);
 
-                RayTracedAudioSystemLogic::EmitRayStates(baseSystem,
-                                                         micBatch,
-                                                         maxDistance,
-                                                         earForward,
-                                                         earRight,
-                                                         earUp,
-                                                         rtAudio.micSourceStates,
-                                                         rtAudio.micStatesVersion,
-                                                         finishedRaysCount,
-                                                         finalUpdate);
-            };
+            glm::vec3 earForward = micForward;
+            glm::vec3 earRight = glm::normalize(glm::cross(earForward, glm::vec3(0.0f, 1.0f, 0.0f)));
+            if (glm::length(earRight) < 1e-4f) earRight = glm::vec3(1.0f, 0.0f, 0.0f);
+            glm::vec3 earUp = glm::normalize(glm::cross(earRight, earForward));
+            if (glm::length(earUp) < 1e-4f) earUp = glm::vec3(0.0f, 1.0f, 0.0f);
 
-            if (micBatch.finishedRays > 0 && micBatch.finishedRays != micBatch.lastPublishedFinishedRays) {
-                emitMicStates(micBatch.finishedRays, false);
-                micBatch.lastPublishedFinishedRays = micBatch.finishedRays;
-            }
-
-            bool micBatchComplete = micBatch.finishedRays >= micBatch.totalRays;
-            if (micBatchComplete) {
-                emitMicStates(micBatch.finishedRays, true);
-                micBatch.active = false;
-                rtAudio.lastMicBatchCompleteTime = now;
-            }
+            RayTracedAudioSystemLogic::EmitRayStates(baseSystem,
+                                                     micBatch,
+                                                     &rtAudio.micPropagation,
+                                                     maxDistance,
+                                                     earForward,
+                                                     earRight,
+                                                     earUp,
+                                                     rtAudio.micSourceStates,
+                                                     rtAudio.micStatesVersion,
+                                                     micBatch.finishedRays,
+                                                     true);
+            micBatch.active = false;
+            rtAudio.lastMicBatchCompleteTime = now;
         }
     }
 
@@ -11,8 +11,17 @@
 #include <limits>
 #include <vector>
 
-#include "stb_easy_font.h"
+#include "BaseSystem/LaneGeometry.h"
+#include "BaseSystem/UIBatch.h"
 
+namespace UIBatchSystemLogic {
+    UIBatch::Builder& Frame(BaseSystem& baseSystem);
+    void UseLaneStore(BaseSystem& baseSystem, LaneGeometry::Store& store);
+}
+namespace FontSystemLogic {
+    bool AppendUiLabel(UIBatch::TextOverlay& labels, size_t at, float x, float y, const char* text,
+                       const glm::vec3& color, double screenWidth, double screenHeight);
+}
 namespace MidiTrackSystemLogic { bool MoveTrack(BaseSystem& baseSystem, int fromIndex, int toIndex); }
 namespace DawLaneTimelineSystemLogic {
     struct LaneLayout;
@@ -45,25 +54,49 @@ namespace MidiLaneSystemLogic {
         constexpr float kTrimEdgeHitWidth = 8.0f;
         constexpr uint64_t kMinClipSamples = 1;
         constexpr size_t kWaveformBlockSize = 256;
-        constexpr int kPreviewBasePitch = 24;
-        constexpr int kPreviewRows = 84;
 
+        // Drag, trim and selection overlay, drawn over the lanes each frame.
         struct UiVertex { glm::vec2 pos; glm::vec3 color; };
         static std::vector<UiVertex> g_laneVertices;
-        static size_t g_staticVertexCount = 0;
-        static std::vector<uint64_t> g_waveVersions;
-        static int g_cachedTrackCount = 0;
-        static int g_cachedAudioTrackCount = 0;
-        static int64_t g_cachedTimelineOffset = 0;
-        static double g_cachedSecondsPerScreen = 10.0;
-        static float g_cachedScrollY = 0.0f;
-        static int g_cachedWidth = 0;
-        static int g_cachedHeight = 0;
-        static std::vector<int> g_cachedLaneSignature;
-        static std::vector<uint64_t> g_cachedClipSignature;
-        static int g_cachedPreviewSlot = -1;
-        static float g_cachedLaneHeight = kLaneHeight;
-        static uint64_t g_cachedThemeRevision = 0;
+        static UIBatch::TextOverlay g_laneLabels;
+
+        struct MidiClipGeometry {
+            LaneGeometry::Segment body;  // body, lip and beat ticks
+            LaneGeometry::ClipLayout layout;
+            LaneGeometry::Segment notes;
+        };
+
+        // One MIDI lane's segments in the store; see LaneGeometry.h.
+        struct MidiTrackGeometry {
+            std::vector<MidiClipGeometry> clips;
+            LaneGeometry::Segment background;
+            LaneGeometry::Segment handle;
+            LaneGeometry::Segment wave;  // rendered-audio columns, in window x
+        };
+
+        struct LanePalette {
+            glm::vec3 lane{0.14f, 0.14f, 0.14f};
+            glm::vec3 highlight{0.2f, 0.2f, 0.2f};
+            glm::vec3 shadow{0.08f, 0.08f, 0.08f};
+            glm::vec3 waveform{0.05f, 0.05f, 0.05f};
+            glm::vec3 clip{0.0f};
+            glm::vec3 clipLip{0.0f};
+            glm::vec3 selectedClip{0.0f};
+            glm::vec3 selectedClipLip{0.0f};
+        };
+
+        // The lanes' store and what of it the current view draws.
+        struct MidiLaneCache {
+            LaneGeometry::Store store;
+            LaneGeometry::Plan plan;
+            std::vector<LaneGeometry::Vertex> scratch;
+            std::vector<MidiTrackGeometry> tracks;
+            uint64_t composedKey = 0;
+            uint64_t composedRevision = 0;
+            bool composed = false;
+        };
+
+        static MidiLaneCache g_laneCache;
         static double g_lastClipClickTime = -1.0;
         static int g_lastClipClickTrack = -1;
         static int g_lastClipClickIndex = -1;
@@ -115,32 +148,6 @@ namespace MidiLaneSystemLogic {
             verts.push_back({d, color});
         }
 
-        void pushText(std::vector<UiVertex>& verts,
-                      float x,
-                      float y,
-                      const char* text,
-                      const glm::vec3& color,
-                      double width,
-                      double height) {
-            if (!text || text[0] == '\0') return;
-            char buffer[99999];
-            int numQuads = stb_easy_font_print(x, y, const_cast<char*>(text), nullptr, buffer, sizeof(buffer));
-            float* vertsRaw = reinterpret_cast<float*>(buffer);
-            for (int i = 0; i < numQuads; ++i) {
-                const int base = i * 16;
-                glm::vec2 v0{vertsRaw[base + 0], vertsRaw[base + 1]};
-                glm::vec2 v1{vertsRaw[base + 4], vertsRaw[base + 5]};
-                glm::vec2 v2{vertsRaw[base + 8], vertsRaw[base + 9]};
-                glm::vec2 v3{vertsRaw[base + 12], vertsRaw[base + 13]};
-                pushQuad(verts,
-                         pixelToNDC(v0, width, height),
-                         pixelToNDC(v1, width, height),
-                         pixelToNDC(v2, width, height),
-                         pixelToNDC(v3, width, height),
-                         color);
-            }
-        }
-
         void computeClipRect(float centerY,
                              float laneHalfH,
                              float& top,
@@ -162,6 +169,305 @@ namespace MidiLaneSystemLogic {
             return std::clamp(laneHeight * 0.26f, kTakeRowMinHeight, kTakeRowMaxHeight);
         }
 
+        LanePalette lanePalette(const WorldContext& world) {
+            LanePalette palette;
+            auto itBase = world.colorLibrary.find("MiraLaneBase");
+            if (itBase != world.colorLibrary.end()) {
+                palette.lane = itBase->second;
+                auto itHighlight = world.colorLibrary.find("MiraLaneHighlight");
+                if (itHighlight != world.colorLibrary.end()) {
+                    palette.highlight = itHighlight->second;
+                } else {
+                    palette.highlight = glm::clamp(palette.lane + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+                }
+                auto itShadow = world.colorLibrary.find("MiraLaneShadow");
+                if (itShadow != world.colorLibrary.end()) {
+                    palette.shadow = itShadow->second;
+                } else {
+                    palette.shadow = glm::clamp(palette.lane - glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+                }
+                auto itWave = world.colorLibrary.find("MiraWaveform");
+                if (itWave != world.colorLibrary.end()) {
+                    palette.waveform = itWave->second;
+                } else {
+                    palette.waveform = glm::clamp(palette.shadow - glm::vec3(0.2f), glm::vec3(0.0f), glm::vec3(1.0f));
+                }
+            }
+            palette.clip = glm::clamp(palette.highlight + glm::vec3(0.12f), glm::vec3(0.0f), glm::vec3(1.0f));
+            palette.clipLip = glm::clamp(palette.clip - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
+            palette.selectedClip = glm::clamp(palette.clip + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+            auto itSelectedClip = world.colorLibrary.find("MiraLaneSelected");
+            if (itSelectedClip != world.colorLibrary.end()) {
+                palette.selectedClip = itSelectedClip->second;
+            }
+            palette.selectedClipLip = glm::clamp(palette.selectedClip - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
+            return palette;
+        }
+
+        uint32_t packRgb(const glm::vec3& color) {
+            return UIBatch::packColor(color.r, color.g, color.b, 0.0f);
+        }
+
+        void writeSegment(LaneGeometry::Segment& segment) {
+            g_laneCache.store.write(segment.id, g_laneCache.scratch);
+        }
+
+        void releaseTrack(MidiTrackGeometry& geometry) {
+            for (MidiClipGeometry& clip : geometry.clips) {
+                g_laneCache.store.release(clip.body.id);
+                g_laneCache.store.release(clip.notes.id);
+            }
+            g_laneCache.store.release(geometry.background.id);
+            g_laneCache.store.release(geometry.handle.id);
+            g_laneCache.store.release(geometry.wave.id);
+        }
+
+        void buildBackground(MidiTrackGeometry& geometry, uint32_t lane, float laneLeft, float laneRight,
+                             float laneHalfH, const LanePalette& palette, uint64_t themeRevision) {
+            const uint64_t key = LaneGeometry::Key()
+                .addReal(laneLeft).addReal(laneRight).addReal(laneHalfH).add(themeRevision).value();
+            if (!geometry.background.rebuild(key)) return;
+            g_laneCache.scratch.clear();
+            LaneGeometry::pushBevelBox(g_laneCache.scratch, lane, laneLeft, laneHalfH, laneRight, 6.0f,
+                                       packRgb(palette.lane), packRgb(palette.highlight), packRgb(palette.shadow));
+            writeSegment(geometry.background);
+        }
+
+        void buildHandle(MidiTrackGeometry& geometry, uint32_t lane, float laneLeft, float laneRight,
+                         float laneHeight, const LanePalette& palette, uint64_t themeRevision) {
+            const uint64_t key = LaneGeometry::Key()
+                .addReal(laneLeft).addReal(laneRight).addReal(laneHeight).add(themeRevision).value();
+            if (!geometry.handle.rebuild(key)) return;
+            float handleSize = std::min(kTrackHandleSize, std::max(14.0f, laneHeight));
+            float handleHalf = handleSize * 0.5f;
+            float handleCenterX = laneRight + kTrackHandleInset + handleHalf;
+            float minCenterX = laneLeft + 4.0f + handleHalf;
+            if (handleCenterX < minCenterX) handleCenterX = minCenterX;
+            glm::vec3 handleFront = glm::clamp(palette.lane + glm::vec3(0.03f), glm::vec3(0.0f), glm::vec3(1.0f));
+            glm::vec3 handleTop = glm::clamp(palette.highlight + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
+            float handleDepth = std::min(6.0f, handleHalf * 0.5f);
+            g_laneCache.scratch.clear();
+            LaneGeometry::pushBevelBox(g_laneCache.scratch, lane, handleCenterX - handleHalf, handleHalf,
+                                       handleCenterX + handleHalf, handleDepth,
+                                       packRgb(handleFront), packRgb(handleTop), packRgb(palette.shadow));
+            writeSegment(geometry.handle);
+        }
+
+        // Every beat tick of the clip is kept, so only edits rebuild it.
+        void buildClipBody(MidiClipGeometry& geometry,
+                           uint32_t lane,
+                           const MidiClip& clip,
+                           bool selected,
+                           const LanePalette& palette,
+                           float laneHalfH,
+                           uint64_t beatStepSamples,
+                           uint64_t themeRevision) {
+            const uint64_t key = LaneGeometry::Key()
+                .add(clip.startSample).add(clip.length).add(selected ? 1u : 0u)
+                .add(beatStepSamples).addReal(laneHalfH).add(themeRevision).value();
+            if (!geometry.body.rebuild(key)) return;
+            const glm::vec3& bodyColor = selected ? palette.selectedClip : palette.clip;
+            const glm::vec3& lipColor = selected ? palette.selectedClipLip : palette.clipLip;
+            g_laneCache.scratch.clear();
+            geometry.layout = LaneGeometry::pushClip(g_laneCache.scratch, lane, laneHalfH, clip.startSample, clip.length,
+                                                     beatStepSamples, packRgb(bodyColor), packRgb(lipColor));
+            writeSegment(geometry.body);
+        }
+
+        // Notes have no revision counter, so the key hashes them; that is
+        // one pass over the clip without the allocation the old signature
+        // vector needed.
+        void buildClipNotes(MidiClipGeometry& geometry, uint32_t lane, const MidiClip& clip, float laneHalfH) {
+            LaneGeometry::Key key;
+            key.add(clip.startSample).add(clip.length).addReal(laneHalfH)
+                .add(static_cast<uint64_t>(clip.notes.size()));
+            for (const auto& note : clip.notes) {
+                key.add(static_cast<uint64_t>(note.pitch + 256)).add(note.startSample).add(note.length);
+            }
+            if (!geometry.notes.rebuild(key.value())) return;
+            g_laneCache.scratch.clear();
+            LaneGeometry::pushNotes(g_laneCache.scratch, lane, laneHalfH, clip.startSample, clip.length, clip.notes,
+                                    [](int pitch) {
+                                        int noteIndex = pitch % 12;
+                                        if (noteIndex < 0) noteIndex += 12;
+                                        float nr = 0.75f, ng = 0.85f, nb = 0.9f;
+                                        PianoRollResourceSystemLogic::NoteColor(noteIndex, nr, ng, nb);
+                                        return UIBatch::packColor(nr, ng, nb, 0.0f);
+                                    });
+            writeSegment(geometry.notes);
+        }
+
+        // One-pixel columns of the track's rendered audio, merging every
+        // block a column covers. Sampled per lane pixel as before, so this
+        // segment follows the view horizontally.
+        void buildTrackWave(MidiTrackGeometry& geometry,
+                            uint32_t lane,
+                            const MidiTrack& track,
+                            const LaneGeometry::View& view,
+                            float laneHalfH,
+                            float ampScale) {
+            const size_t blockCount = track.waveformMin.size();
+            const uint64_t key = LaneGeometry::Key()
+                .addReal(view.offsetSamples).addReal(view.windowSamples).addReal(view.laneLeft).addReal(view.laneRight)
+                .add(track.waveformVersion).add(static_cast<uint64_t>(blockCount))
+                .addReal(laneHalfH).addReal(ampScale).value();
+            if (!geometry.wave.rebuild(key)) return;
+            g_laneCache.scratch.clear();
+            if (blockCount > 0 && track.waveformMax.size() >= blockCount && track.waveformColor.size() >= blockCount) {
+                LaneGeometry::trackColumns(view, [&](int px, double s0, double s1) {
+                    size_t block0 = static_cast<size_t>(s0 / static_cast<double>(kWaveformBlockSize));
+                    size_t block1 = static_cast<size_t>(s1 / static_cast<double>(kWaveformBlockSize));
+                    if (block0 >= blockCount) return;
+                    block1 = std::min(block1, blockCount - 1);
+                    float minVal = track.waveformMin[block0];
+                    float maxVal = track.waveformMax[block0];
+                    glm::vec3 color = track.waveformColor[block0];
+                    for (size_t b = block0 + 1; b <= block1; ++b) {
+                        minVal = std::min(minVal, track.waveformMin[b]);
+                        maxVal = std::max(maxVal, track.waveformMax[b]);
+                        color = (color + track.waveformColor[b]) * 0.5f;
+                    }
+                    LaneGeometry::pushTrackWaveColumn(g_laneCache.scratch, lane, view.laneLeft + static_cast<float>(px),
+                                                      laneHalfH, ampScale, minVal, maxVal, packRgb(color));
+                });
+            }
+            writeSegment(geometry.wave);
+        }
+
+        // Rewrites whatever segments of on-screen lanes went stale.
+        void refreshGeometry(const MidiContext& midi,
+                             const DawContext& daw,
+                             const DawLaneTimelineSystemLogic::LaneLayout& layout,
+                             const LaneGeometry::Rows& rows,
+                             const std::vector<int>& midiLaneIndex,
+                             const LaneGeometry::View& view,
+                             const LanePalette& palette) {
+            const int midiTrackCount = static_cast<int>(midi.tracks.size());
+            if (g_laneCache.tracks.size() != static_cast<size_t>(midiTrackCount)) {
+                for (size_t t = static_cast<size_t>(midiTrackCount); t < g_laneCache.tracks.size(); ++t) {
+                    releaseTrack(g_laneCache.tracks[t]);
+                }
+                g_laneCache.tracks.resize(static_cast<size_t>(midiTrackCount));
+            }
+
+            double bpmNow = daw.bpm.load(std::memory_order_relaxed);
+            if (bpmNow <= 0.0) bpmNow = 120.0;
+            uint64_t beatStepSamples = std::max<uint64_t>(1,
+                static_cast<uint64_t>(std::llround((60.0 / bpmNow) * static_cast<double>(daw.sampleRate))));
+            const float ampScale = layout.laneHeight * 0.8f * 0.5f;
+
+            for (int t = 0; t < midiTrackCount; ++t) {
+                int laneIndex = midiLaneIndex[static_cast<size_t>(t)];
+                if (laneIndex < 0) continue;
+                int displayIndex = rows.displayIndex(laneIndex);
+                if (displayIndex < 0) continue;
+                if (!rows.onScreen(rows.centerY(displayIndex), layout.screenHeight)) continue;
+                const MidiTrack& track = midi.tracks[static_cast<size_t>(t)];
+                MidiTrackGeometry& geometry = g_laneCache.tracks[static_cast<size_t>(t)];
+                const uint32_t lane = static_cast<uint32_t>(t);
+                buildBackground(geometry, lane, layout.laneLeft, layout.laneRight, layout.laneHalfH, palette,
+                                daw.themeRevision);
+                buildHandle(geometry, lane, layout.laneLeft, layout.laneRight, layout.laneHeight, palette,
+                            daw.themeRevision);
+                if (geometry.clips.size() != track.clips.size()) {
+                    for (size_t ci = track.clips.size(); ci < geometry.clips.size(); ++ci) {
+                        g_laneCache.store.release(geometry.clips[ci].body.id);
+                        g_laneCache.store.release(geometry.clips[ci].notes.id);
+                    }
+                    geometry.clips.resize(track.clips.size());
+                }
+                for (size_t ci = 0; ci < track.clips.size(); ++ci) {
+                    const MidiClip& clip = track.clips[ci];
+                    MidiClipGeometry& clipGeometry = geometry.clips[ci];
+                    bool selectedClip = (t == midi.selectedClipTrack) && (static_cast<int>(ci) == midi.selectedClipIndex);
+                    buildClipBody(clipGeometry, lane, clip, selectedClip, palette,
+                                  layout.laneHalfH, beatStepSamples, daw.themeRevision);
+                    buildClipNotes(clipGeometry, lane, clip, layout.laneHalfH);
+                }
+                buildTrackWave(geometry, lane, track, view, layout.laneHalfH, ampScale);
+            }
+        }
+
+        // Lays out what this view shows of the store. Painter's order
+        // matches the old single pass: lane bodies, clip bodies with their
+        // labels, waveforms, notes, handles.
+        void composeLanes(const MidiContext& midi,
+                          const DawContext& daw,
+                          const DawLaneTimelineSystemLogic::LaneLayout& layout,
+                          const LaneGeometry::Rows& rows,
+                          const std::vector<int>& midiLaneIndex,
+                          const LaneGeometry::View& view) {
+            const int midiTrackCount = static_cast<int>(midi.tracks.size());
+            LaneGeometry::Plan& plan = g_laneCache.plan;
+            const LaneGeometry::Store& store = g_laneCache.store;
+            plan.clear();
+
+            double bpmNow = daw.bpm.load(std::memory_order_relaxed);
+            if (bpmNow <= 0.0) bpmNow = 120.0;
+            uint64_t beatStepSamples = std::max<uint64_t>(1,
+                static_cast<uint64_t>(std::llround((60.0 / bpmNow) * static_cast<double>(daw.sampleRate))));
+            auto laneCenter = [&](int t, float& centerY) -> bool {
+                int laneIndex = midiLaneIndex[static_cast<size_t>(t)];
+                if (laneIndex < 0) return false;
+                int displayIndex = rows.displayIndex(laneIndex);
+                if (displayIndex < 0) return false;
+                centerY = rows.centerY(displayIndex);
+                return rows.onScreen(centerY, layout.screenHeight);
+            };
+            auto label = [&](size_t at, float x, float y, const char* text) {
+                FontSystemLogic::AppendUiLabel(plan.labels(), at, x, y, text, glm::vec3(0.04f, 0.04f, 0.04f),
+                                               layout.screenWidth, layout.screenHeight);
+            };
+
+            float centerY = 0.0f;
+            for (int t = 0; t < midiTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                plan.add(store, g_laneCache.tracks[static_cast<size_t>(t)].background.id,
+                         static_cast<uint32_t>(t), centerY, view);
+            }
+            for (int t = 0; t < midiTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                const auto& clips = midi.tracks[static_cast<size_t>(t)].clips;
+                const MidiTrackGeometry& geometry = g_laneCache.tracks[static_cast<size_t>(t)];
+                for (size_t ci = 0; ci < clips.size() && ci < geometry.clips.size(); ++ci) {
+                    LaneGeometry::planClip(plan, store, geometry.clips[ci].body.id, geometry.clips[ci].layout,
+                                           static_cast<uint32_t>(t), centerY, layout.laneHalfH, view,
+                                           clips[ci].startSample, clips[ci].length, beatStepSamples, label);
+                }
+            }
+            for (int t = 0; t < midiTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                plan.add(store, g_laneCache.tracks[static_cast<size_t>(t)].wave.id,
+                         static_cast<uint32_t>(t), centerY, view);
+            }
+            for (int t = 0; t < midiTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                const auto& clips = midi.tracks[static_cast<size_t>(t)].clips;
+                const MidiTrackGeometry& geometry = g_laneCache.tracks[static_cast<size_t>(t)];
+                for (size_t ci = 0; ci < clips.size() && ci < geometry.clips.size(); ++ci) {
+                    if (!LaneGeometry::notesVisible(view, clips[ci].startSample, clips[ci].length)) continue;
+                    plan.add(store, geometry.clips[ci].notes.id, static_cast<uint32_t>(t), centerY, view);
+                }
+            }
+            for (int t = 0; t < midiTrackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                plan.add(store, g_laneCache.tracks[static_cast<size_t>(t)].handle.id,
+                         static_cast<uint32_t>(t), centerY, view);
+            }
+            plan.mark();
+        }
+
+        // Lane centers for the shader; lanes not drawn keep 0.
+        void placeLanes(const LaneGeometry::Rows& rows, const std::vector<int>& midiLaneIndex) {
+            std::vector<float>& centers = g_laneCache.store.transform.centerY;
+            centers.assign(midiLaneIndex.size(), 0.0f);
+            for (size_t t = 0; t < midiLaneIndex.size(); ++t) {
+                if (midiLaneIndex[t] < 0) continue;
+                int displayIndex = rows.displayIndex(midiLaneIndex[t]);
+                if (displayIndex >= 0) centers[t] = rows.centerY(displayIndex);
+            }
+        }
+
         int laneIndexFromCursorY(float y, float startY, float laneHalfH, float rowSpan, int laneCount) {
             for (int i = 0; i < laneCount; ++i) {
                 float centerY = startY + static_cast<float>(i) * rowSpan;
@@ -413,17 +719,6 @@ namespace MidiLaneSystemLogic {
             });
         }
 
-        void ensureResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.uiColorShader) {
-                renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(),
-                                                                 world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.uiMidiLaneVAO == 0) {
-                glGenVertexArrays(1, &renderer.uiMidiLaneVAO);
-                glGenBuffers(1, &renderer.uiMidiLaneVBO);
-            }
-        }
-
         bool isCursorOverOpenPanel(const BaseSystem& baseSystem, const UIContext& ui) {
             if (!baseSystem.panel) return false;
             const PanelContext& panel = *baseSystem.panel;
@@ -452,10 +747,7 @@ namespace MidiLaneSystemLogic {
         UIContext& ui = *baseSystem.ui;
         if (!ui.active || ui.loadingActive) return;
 
-        RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
-        ensureResources(renderer, world);
-        if (!renderer.uiColorShader) return;
 
         int windowWidth = 0, windowHeight = 0;
         glfwGetWindowSize(win, &windowWidth, &windowHeight);
@@ -482,7 +774,6 @@ namespace MidiLaneSystemLogic {
         const auto laneLayout = DawLaneTimelineSystemLogic::ComputeLaneLayout(baseSystem, daw, win);
         float laneLeft = laneLayout.laneLeft;
         float laneRight = laneLayout.laneRight;
-        float scrollY = laneLayout.startY;
         int audioTrackCount = static_cast<int>(daw.tracks.size());
         int laneCount = laneLayout.laneCount;
         float startY = laneLayout.startY;
@@ -494,91 +785,6 @@ namespace MidiLaneSystemLogic {
         float laneHalfH = laneLayout.laneHalfH;
         double secondsPerScreen = laneLayout.secondsPerScreen;
 
-        glm::vec3 laneColor(0.14f, 0.14f, 0.14f);
-        glm::vec3 laneHighlight(0.2f, 0.2f, 0.2f);
-        glm::vec3 laneShadow(0.08f, 0.08f, 0.08f);
-        glm::vec3 waveformBaseColor(0.05f, 0.05f, 0.05f);
-        auto itBase = world.colorLibrary.find("MiraLaneBase");
-        if (itBase != world.colorLibrary.end()) {
-            laneColor = itBase->second;
-            auto itHighlight = world.colorLibrary.find("MiraLaneHighlight");
-            if (itHighlight != world.colorLibrary.end()) {
-                laneHighlight = itHighlight->second;
-            } else {
-                laneHighlight = glm::clamp(laneColor + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
-            }
-            auto itShadow = world.colorLibrary.find("MiraLaneShadow");
-            if (itShadow != world.colorLibrary.end()) {
-                laneShadow = itShadow->second;
-            } else {
-                laneShadow = glm::clamp(laneColor - glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
-            }
-            auto itWave = world.colorLibrary.find("MiraWaveform");
-            if (itWave != world.colorLibrary.end()) {
-                waveformBaseColor = itWave->second;
-            } else {
-                waveformBaseColor = glm::clamp(laneShadow - glm::vec3(0.2f), glm::vec3(0.0f), glm::vec3(1.0f));
-            }
-        }
-
-        bool rebuildStatic = (windowWidth != g_cachedWidth) || (windowHeight != g_cachedHeight);
-        if (std::abs(scrollY - g_cachedScrollY) > 0.01f) {
-            rebuildStatic = true;
-        }
-        if (midiTrackCount != g_cachedTrackCount) {
-            rebuildStatic = true;
-        }
-        if (audioTrackCount != g_cachedAudioTrackCount) {
-            rebuildStatic = true;
-        }
-        if (std::abs(secondsPerScreen - g_cachedSecondsPerScreen) > 0.0001) {
-            rebuildStatic = true;
-        }
-        if (daw.timelineOffsetSamples != g_cachedTimelineOffset) {
-            rebuildStatic = true;
-        }
-        if (daw.themeRevision != g_cachedThemeRevision) {
-            rebuildStatic = true;
-        }
-        if (std::abs(laneLayout.laneHeight - g_cachedLaneHeight) > 0.01f) {
-            rebuildStatic = true;
-        }
-        {
-            std::vector<uint64_t> clipSig;
-            clipSig.reserve(static_cast<size_t>(midiTrackCount) * 4);
-            for (int t = 0; t < midiTrackCount; ++t) {
-                clipSig.push_back(static_cast<uint64_t>(t));
-                const auto& clips = midi.tracks[static_cast<size_t>(t)].clips;
-                clipSig.push_back(static_cast<uint64_t>(clips.size()));
-                for (const auto& clip : clips) {
-                    clipSig.push_back(clip.startSample);
-                    clipSig.push_back(clip.length);
-                    clipSig.push_back(static_cast<uint64_t>(clip.notes.size()));
-                    for (const auto& note : clip.notes) {
-                        clipSig.push_back(static_cast<uint64_t>(note.pitch + 256));
-                        clipSig.push_back(note.startSample);
-                        clipSig.push_back(note.length);
-                    }
-                }
-            }
-            clipSig.push_back(static_cast<uint64_t>(midi.selectedClipTrack + 1));
-            clipSig.push_back(static_cast<uint64_t>(midi.selectedClipIndex + 1));
-            if (clipSig != g_cachedClipSignature) {
-                rebuildStatic = true;
-                g_cachedClipSignature = std::move(clipSig);
-            }
-        }
-        if (g_waveVersions.size() != static_cast<size_t>(midiTrackCount)) {
-            g_waveVersions.assign(static_cast<size_t>(midiTrackCount), 0);
-            rebuildStatic = true;
-        }
-        for (int t = 0; t < midiTrackCount; ++t) {
-            if (midi.tracks[static_cast<size_t>(t)].waveformVersion != g_waveVersions[static_cast<size_t>(t)]) {
-                rebuildStatic = true;
-                break;
-            }
-        }
-
         std::vector<int> midiLaneIndex(static_cast<size_t>(midiTrackCount), -1);
         if (!daw.laneOrder.empty()) {
             for (size_t laneIdx = 0; laneIdx < daw.laneOrder.size(); ++laneIdx) {
@@ -593,17 +799,6 @@ namespace MidiLaneSystemLogic {
             }
         }
 
-        std::vector<int> laneSignature;
-        laneSignature.reserve(daw.laneOrder.size() * 2);
-        for (const auto& entry : daw.laneOrder) {
-            laneSignature.push_back(entry.type);
-            laneSignature.push_back(entry.trackIndex);
-        }
-        if (laneSignature != g_cachedLaneSignature) {
-            rebuildStatic = true;
-            g_cachedLaneSignature = laneSignature;
-        }
-
         MidiTrimHit trimHover;
         bool trimCursorWanted = false;
         if (allowLaneInput && !g_clipDragActive && !g_clipTrimActive) {
@@ -962,453 +1157,52 @@ namespace MidiLaneSystemLogic {
             }
         }
 
-        auto buildLanes = [&](int previewSlot) {
-            g_cachedWidth = windowWidth;
-            g_cachedHeight = windowHeight;
-            g_cachedScrollY = scrollY;
-            g_cachedTrackCount = midiTrackCount;
-            g_cachedAudioTrackCount = audioTrackCount;
-            g_cachedTimelineOffset = daw.timelineOffsetSamples;
-            g_cachedSecondsPerScreen = secondsPerScreen;
-            g_cachedLaneHeight = laneLayout.laneHeight;
-            g_cachedThemeRevision = daw.themeRevision;
-            g_laneVertices.clear();
-            g_laneVertices.reserve(static_cast<size_t>(midiTrackCount) * 60 * 6);
-            const bool previewingMidiLaneDrag = (previewSlot >= 0
-                && daw.dragActive
-                && daw.dragLaneType == 1
-                && daw.dragLaneIndex >= 0);
-            const int draggedLaneIndex = daw.dragLaneIndex;
-            auto computeDisplayIndex = [&](int laneIndex) -> int {
-                int displayIndex = laneIndex;
-                if (previewSlot < 0) return displayIndex;
-                if (previewingMidiLaneDrag) {
-                    if (laneIndex == draggedLaneIndex) return -1;
-                    if (laneIndex > draggedLaneIndex) {
-                        displayIndex -= 1;
-                    }
-                }
-                if (displayIndex >= previewSlot) {
-                    displayIndex += 1;
-                }
-                return displayIndex;
-            };
-
-            for (int t = 0; t < midiTrackCount; ++t) {
-                int laneIndex = midiLaneIndex[static_cast<size_t>(t)];
-                if (laneIndex < 0) continue;
-                int displayIndex = computeDisplayIndex(laneIndex);
-                if (displayIndex < 0) continue;
-                float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                float top = centerY - laneHalfH;
-                float bottom = centerY + laneHalfH;
-
-                float bevelDepth = 6.0f;
-                glm::vec2 frontA(laneLeft, top);
-                glm::vec2 frontB(laneRight, top);
-                glm::vec2 frontC(laneRight, bottom);
-                glm::vec2 frontD(laneLeft, bottom);
-
-                glm::vec2 topA = frontA;
-                glm::vec2 topB = frontB;
-                glm::vec2 topC(frontB.x - bevelDepth, frontB.y - bevelDepth);
-                glm::vec2 topD(frontA.x - bevelDepth, frontA.y - bevelDepth);
-
-                glm::vec2 leftA = frontA;
-                glm::vec2 leftB = frontD;
-                glm::vec2 leftC(frontD.x - bevelDepth, frontD.y - bevelDepth);
-                glm::vec2 leftD(frontA.x - bevelDepth, frontA.y - bevelDepth);
-
-                pushQuad(g_laneVertices,
-                         pixelToNDC(frontA, screenWidth, screenHeight),
-                         pixelToNDC(frontB, screenWidth, screenHeight),
-                         pixelToNDC(frontC, screenWidth, screenHeight),
-                         pixelToNDC(frontD, screenWidth, screenHeight),
-                         laneColor);
-                pushQuad(g_laneVertices,
-                         pixelToNDC(topA, screenWidth, screenHeight),
-                         pixelToNDC(topB, screenWidth, screenHeight),
-                         pixelToNDC(topC, screenWidth, screenHeight),
-                         pixelToNDC(topD, screenWidth, screenHeight),
-                         laneHighlight);
-                pushQuad(g_laneVertices,
-                         pixelToNDC(leftA, screenWidth, screenHeight),
-                         pixelToNDC(leftB, screenWidth, screenHeight),
-                         pixelToNDC(leftC, screenWidth, screenHeight),
-                         pixelToNDC(leftD, screenWidth, screenHeight),
-                         laneShadow);
-            }
-
-            double offsetSamples = static_cast<double>(daw.timelineOffsetSamples);
-            double windowSamples = secondsPerScreen * static_cast<double>(daw.sampleRate);
-            if (windowSamples < 0.0) windowSamples = 0.0;
-            glm::vec3 clipColor = glm::clamp(laneHighlight + glm::vec3(0.12f), glm::vec3(0.0f), glm::vec3(1.0f));
-            glm::vec3 clipLipColor = glm::clamp(clipColor - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
-            glm::vec3 selectedClipColor = glm::clamp(clipColor + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
-            auto itSelectedClip = world.colorLibrary.find("MiraLaneSelected");
-            if (itSelectedClip != world.colorLibrary.end()) {
-                selectedClipColor = itSelectedClip->second;
-            }
-            glm::vec3 selectedClipLipColor = glm::clamp(selectedClipColor - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
-            double bpmNow = daw.bpm.load(std::memory_order_relaxed);
-            if (bpmNow <= 0.0) bpmNow = 120.0;
-            uint64_t beatStepSamples = std::max<uint64_t>(1,
-                static_cast<uint64_t>(std::llround((60.0 / bpmNow) * static_cast<double>(daw.sampleRate))));
-            for (int t = 0; t < midiTrackCount; ++t) {
-                const auto& clips = midi.tracks[static_cast<size_t>(t)].clips;
-                if (clips.empty()) continue;
-                int laneIndex = midiLaneIndex[static_cast<size_t>(t)];
-                if (laneIndex < 0) continue;
-                int displayIndex = computeDisplayIndex(laneIndex);
-                if (displayIndex < 0) continue;
-                float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                float top = 0.0f;
-                float bottom = 0.0f;
-                float lipBottom = 0.0f;
-                computeClipRect(centerY, laneHalfH, top, bottom, lipBottom);
-                for (size_t ci = 0; ci < clips.size(); ++ci) {
-                    const auto& clip = clips[ci];
-                    if (clip.length == 0) continue;
-                    bool selectedClip = (t == midi.selectedClipTrack) && (static_cast<int>(ci) == midi.selectedClipIndex);
-                    const glm::vec3& bodyColor = selectedClip ? selectedClipColor : clipColor;
-                    const glm::vec3& lipColor = selectedClip ? selectedClipLipColor : clipLipColor;
-                    double clipStart = static_cast<double>(clip.startSample);
-                    double clipEnd = static_cast<double>(clip.startSample + clip.length);
-                    if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) continue;
-                    double visibleStart = std::max(clipStart, offsetSamples);
-                    double visibleEnd = std::min(clipEnd, offsetSamples + windowSamples);
-                    float t0 = (windowSamples > 0.0)
-                        ? static_cast<float>((visibleStart - offsetSamples) / windowSamples)
-                        : 0.0f;
-                    float t1 = (windowSamples > 0.0)
-                        ? static_cast<float>((visibleEnd - offsetSamples) / windowSamples)
-                        : 0.0f;
-                    float x0 = laneLeft + (laneRight - laneLeft) * t0 - kClipHorizontalPad;
-                    float x1 = laneLeft + (laneRight - laneLeft) * t1 + kClipHorizontalPad;
-                    x0 = std::max(x0, laneLeft);
-                    x1 = std::min(x1, laneRight);
-                    if (x1 < laneLeft || x0 > laneRight) continue;
-                    glm::vec2 a(x0, top);
-                    glm::vec2 b(x1, top);
-                    glm::vec2 c(x1, bottom);
-                    glm::vec2 d(x0, bottom);
-                    pushQuad(g_laneVertices,
-                             pixelToNDC(a, screenWidth, screenHeight),
-                             pixelToNDC(b, screenWidth, screenHeight),
-                             pixelToNDC(c, screenWidth, screenHeight),
-                             pixelToNDC(d, screenWidth, screenHeight),
-                             bodyColor);
-                    if (lipBottom > top + 0.5f) {
-                        glm::vec2 la(x0, top);
-                        glm::vec2 lb(x1, top);
-                        glm::vec2 lc(x1, lipBottom);
-                        glm::vec2 ld(x0, lipBottom);
-                        pushQuad(g_laneVertices,
-                                 pixelToNDC(la, screenWidth, screenHeight),
-                                 pixelToNDC(lb, screenWidth, screenHeight),
-                                 pixelToNDC(lc, screenWidth, screenHeight),
-                                 pixelToNDC(ld, screenWidth, screenHeight),
-                                 lipColor);
-                    }
-                    if (beatStepSamples > 0 && x1 > x0 + 2.0f) {
-                        uint64_t visibleStartSample = static_cast<uint64_t>(std::max(visibleStart, 0.0));
-                        uint64_t visibleEndSample = static_cast<uint64_t>(std::max(visibleEnd, 0.0));
-                        if (visibleEndSample > visibleStartSample) {
-                            const uint64_t clipStartSample = clip.startSample;
-                            uint64_t tick = clipStartSample;
-                            if (visibleStartSample > clipStartSample) {
-                                uint64_t delta = visibleStartSample - clipStartSample;
-                                uint64_t steps = (delta + beatStepSamples - 1) / beatStepSamples;
-                                tick = clipStartSample + steps * beatStepSamples;
-                            }
-                            int guard = 0;
-                            float markerTop = lipBottom + 1.0f;
-                            float maxTickHeight = std::max(3.0f, bottom - markerTop - 2.0f);
-                            float beatTickHeight = std::clamp(maxTickHeight * 0.30f, 3.0f, 8.0f);
-                            float barTickHeight = std::clamp(maxTickHeight * 0.52f, 5.0f, 13.0f);
-                            float phraseTickHeight = std::clamp(maxTickHeight * 0.68f, 7.0f, 16.0f);
-                            float lastLabelX = -10000.0f;
-                            while (tick < visibleEndSample && guard < 512) {
-                                float tt = static_cast<float>((static_cast<double>(tick) - offsetSamples) / windowSamples);
-                                float x = laneLeft + (laneRight - laneLeft) * tt;
-                                x = std::clamp(x, x0 + 1.0f, x1 - 1.0f);
-                                uint64_t localBeat = (tick >= clipStartSample)
-                                    ? ((tick - clipStartSample) / beatStepSamples)
-                                    : 0;
-                                bool isBar = ((localBeat % 4ull) == 0ull);
-                                bool isPhrase = ((localBeat % 16ull) == 0ull);
-                                float lineHalf = isBar ? 0.9f : 0.45f;
-                                glm::vec3 lineColor = isBar ? glm::vec3(0.02f, 0.02f, 0.02f)
-                                                            : glm::vec3(0.06f, 0.06f, 0.06f);
-                                float markerBottom = markerTop + (isPhrase ? phraseTickHeight : (isBar ? barTickHeight : beatTickHeight));
-                                markerBottom = std::min(markerBottom, bottom - 1.0f);
-                                pushQuad(g_laneVertices,
-                                         pixelToNDC({x - lineHalf, markerTop}, screenWidth, screenHeight),
-                                         pixelToNDC({x + lineHalf, markerTop}, screenWidth, screenHeight),
-                                         pixelToNDC({x + lineHalf, markerBottom}, screenWidth, screenHeight),
-                                         pixelToNDC({x - lineHalf, markerBottom}, screenWidth, screenHeight),
-                                         lineColor);
-                                if ((x - lastLabelX) >= 46.0f
-                                    && (x + 30.0f) <= (x1 - 2.0f)
-                                    && (markerBottom + 10.0f) <= (bottom - 2.0f)) {
-                                    uint64_t barIndex = (localBeat / 4ull) + 1ull;
-                                    uint64_t beatInBar = (localBeat % 4ull) + 1ull;
-                                    char label[24];
-                                    std::snprintf(label, sizeof(label), "%llu.%llu.1",
-                                                  static_cast<unsigned long long>(barIndex),
-                                                  static_cast<unsigned long long>(beatInBar));
-                                    pushText(g_laneVertices,
-                                             x + 2.0f,
-                                             markerBottom + 2.0f,
-                                             label,
-                                             glm::vec3(0.04f, 0.04f, 0.04f),
-                                             screenWidth,
-                                             screenHeight);
-                                    lastLabelX = x;
-                                }
-                                tick += beatStepSamples;
-                                ++guard;
-                            }
-                        }
-                    }
-                }
-            }
-
-            float waveHeight = laneLayout.laneHeight * 0.8f;
-            float ampScale = waveHeight * 0.5f;
-            int pixelWidth = static_cast<int>(laneRight - laneLeft);
-            if (pixelWidth > 0) {
-                for (int t = 0; t < midiTrackCount; ++t) {
-                    const MidiTrack& track = midi.tracks[static_cast<size_t>(t)];
-                    if (track.waveformMin.empty()) continue;
-                    size_t blockCount = track.waveformMin.size();
-                    if (blockCount == 0) continue;
-                    int laneIndex = midiLaneIndex[static_cast<size_t>(t)];
-                    if (laneIndex < 0) continue;
-                    int displayIndex = computeDisplayIndex(laneIndex);
-                    if (displayIndex < 0) continue;
-                    float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                    float top = centerY - laneHalfH;
-                    float bottom = centerY + laneHalfH;
-                    for (int px = 0; px < pixelWidth; ++px) {
-                        double t0 = static_cast<double>(px) / static_cast<double>(pixelWidth);
-                        double t1 = static_cast<double>(px + 1) / static_cast<double>(pixelWidth);
-                        double s0 = offsetSamples + t0 * windowSamples;
-                        double s1 = offsetSamples + t1 * windowSamples;
-                        size_t block0 = static_cast<size_t>(s0 / static_cast<double>(kWaveformBlockSize));
-                        size_t block1 = static_cast<size_t>(s1 / static_cast<double>(kWaveformBlockSize));
-                        if (block0 >= blockCount) continue;
-                        block1 = std::min(block1, blockCount - 1);
-
-                        float minVal = 0.0f;
-                        float maxVal = 0.0f;
-                        glm::vec3 color = waveformBaseColor;
-                        bool init = false;
-                        for (size_t b = block0; b <= block1; ++b) {
-                            float minB = track.waveformMin[b];
-                            float maxB = track.waveformMax[b];
-                            if (!init) {
-                                minVal = minB;
-                                maxVal = maxB;
-                                color = track.waveformColor[b];
-                                init = true;
-                            } else {
-                                minVal = std::min(minVal, minB);
-                                maxVal = std::max(maxVal, maxB);
-                                color = (color + track.waveformColor[b]) * 0.5f;
-                            }
-                        }
-                        if (!init) continue;
-                        float x = laneLeft + static_cast<float>(px);
-                        float yCenter = centerY;
-                        float yMin = yCenter + minVal * ampScale;
-                        float yMax = yCenter + maxVal * ampScale;
-                        if (yMax < yMin) std::swap(yMax, yMin);
-                        yMin = std::clamp(yMin, top, bottom);
-                        yMax = std::clamp(yMax, top, bottom);
-                        glm::vec2 a(x, yMin);
-                        glm::vec2 b(x + 1.0f, yMin);
-                        glm::vec2 c(x + 1.0f, yMax);
-                        glm::vec2 d(x, yMax);
-                        pushQuad(g_laneVertices,
-                                 pixelToNDC(a, screenWidth, screenHeight),
-                                 pixelToNDC(b, screenWidth, screenHeight),
-                                 pixelToNDC(c, screenWidth, screenHeight),
-                                 pixelToNDC(d, screenWidth, screenHeight),
-                                 color);
-                    }
-                }
-            }
-
-            for (int t = 0; t < midiTrackCount; ++t) {
-                const auto& clips = midi.tracks[static_cast<size_t>(t)].clips;
-                if (clips.empty()) continue;
-                int laneIndex = midiLaneIndex[static_cast<size_t>(t)];
-                if (laneIndex < 0) continue;
-                int displayIndex = computeDisplayIndex(laneIndex);
-                if (displayIndex < 0) continue;
-                float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                float top = 0.0f;
-                float bottom = 0.0f;
-                float lipBottom = 0.0f;
-                computeClipRect(centerY, laneHalfH, top, bottom, lipBottom);
-                float noteTop = std::min(bottom, lipBottom + 1.0f);
-                float noteBottom = std::max(noteTop + 1.0f, bottom - 1.0f);
-                float noteHeight = noteBottom - noteTop;
-                if (noteHeight <= 0.5f) continue;
-
-                for (const auto& clip : clips) {
-                    if (clip.length == 0 || clip.notes.empty()) continue;
-                    double clipStart = static_cast<double>(clip.startSample);
-                    double clipEnd = static_cast<double>(clip.startSample + clip.length);
-                    if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) continue;
-                    double clipVisibleStart = std::max(clipStart, offsetSamples);
-                    double clipVisibleEnd = std::min(clipEnd, offsetSamples + windowSamples);
-                    float clipT0 = static_cast<float>((clipVisibleStart - offsetSamples) / windowSamples);
-                    float clipT1 = static_cast<float>((clipVisibleEnd - offsetSamples) / windowSamples);
-                    float clipX0 = laneLeft + (laneRight - laneLeft) * clipT0;
-                    float clipX1 = laneLeft + (laneRight - laneLeft) * clipT1;
-                    clipX0 = std::max(clipX0, laneLeft);
-                    clipX1 = std::min(clipX1, laneRight);
-                    if (clipX1 <= clipX0) continue;
-
-                    for (const auto& note : clip.notes) {
-                        if (note.length == 0) continue;
-                        double noteStart = static_cast<double>(clip.startSample + note.startSample);
-                        double noteEnd = noteStart + static_cast<double>(note.length);
-                        if (noteEnd <= offsetSamples || noteStart >= offsetSamples + windowSamples) continue;
-                        double noteVisibleStart = std::max(noteStart, offsetSamples);
-                        double noteVisibleEnd = std::min(noteEnd, offsetSamples + windowSamples);
-                        float noteT0 = static_cast<float>((noteVisibleStart - offsetSamples) / windowSamples);
-                        float noteT1 = static_cast<float>((noteVisibleEnd - offsetSamples) / windowSamples);
-                        float x0 = laneLeft + (laneRight - laneLeft) * noteT0;
-                        float x1 = laneLeft + (laneRight - laneLeft) * noteT1;
-                        x0 = std::clamp(x0, clipX0 + 1.0f, clipX1 - 1.0f);
-                        x1 = std::clamp(x1, clipX0 + 1.0f, clipX1 - 1.0f);
-                        if (x1 <= x0 + 0.5f) continue;
-
-                        int row = std::clamp(note.pitch - kPreviewBasePitch, 0, kPreviewRows - 1);
-                        float rowT0 = static_cast<float>(row) / static_cast<float>(kPreviewRows);
-                        float rowT1 = static_cast<float>(row + 1) / static_cast<float>(kPreviewRows);
-                        float y0 = noteBottom - rowT1 * noteHeight;
-                        float y1 = noteBottom - rowT0 * noteHeight;
-                        if (y1 < y0 + 1.0f) y1 = y0 + 1.0f;
-                        if (y0 < noteTop) y0 = noteTop;
-                        if (y1 > noteBottom) y1 = noteBottom;
-                        if (y1 <= y0) continue;
-
-                        int noteIndex = note.pitch % 12;
-                        if (noteIndex < 0) noteIndex += 12;
-                        float nr = 0.75f, ng = 0.85f, nb = 0.9f;
-                        PianoRollResourceSystemLogic::NoteColor(noteIndex, nr, ng, nb);
-                        glm::vec3 noteColor(nr, ng, nb);
-                        pushQuad(g_laneVertices,
-                                 pixelToNDC({x0, y0}, screenWidth, screenHeight),
-                                 pixelToNDC({x1, y0}, screenWidth, screenHeight),
-                                 pixelToNDC({x1, y1}, screenWidth, screenHeight),
-                                 pixelToNDC({x0, y1}, screenWidth, screenHeight),
-                                 noteColor);
-                    }
-                }
-            }
-
-            {
-                float handleSize = std::min(kTrackHandleSize, std::max(14.0f, laneLayout.laneHeight));
-                float handleHalf = handleSize * 0.5f;
-                float handleCenterX = laneRight + kTrackHandleInset + handleHalf;
-                float minCenterX = laneLeft + 4.0f + handleHalf;
-                if (handleCenterX < minCenterX) handleCenterX = minCenterX;
-                glm::vec3 handleFront = glm::clamp(laneColor + glm::vec3(0.03f), glm::vec3(0.0f), glm::vec3(1.0f));
-                glm::vec3 handleTop = glm::clamp(laneHighlight + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
-                glm::vec3 handleSide = laneShadow;
-                float handleDepth = std::min(6.0f, handleHalf * 0.5f);
-                for (int t = 0; t < midiTrackCount; ++t) {
-                    int laneIndex = midiLaneIndex[static_cast<size_t>(t)];
-                    if (laneIndex < 0) continue;
-                    int displayIndex = computeDisplayIndex(laneIndex);
-                    if (displayIndex < 0) continue;
-                    float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
-                    float top = centerY - handleHalf;
-                    float bottom = centerY + handleHalf;
-                    glm::vec2 frontA(handleCenterX - handleHalf, top);
-                    glm::vec2 frontB(handleCenterX + handleHalf, top);
-                    glm::vec2 frontC(handleCenterX + handleHalf, bottom);
-                    glm::vec2 frontD(handleCenterX - handleHalf, bottom);
-                    glm::vec2 topA = frontA;
-                    glm::vec2 topB = frontB;
-                    glm::vec2 topC(frontB.x - handleDepth, frontB.y - handleDepth);
-                    glm::vec2 topD(frontA.x - handleDepth, frontA.y - handleDepth);
-                    glm::vec2 leftA = frontA;
-                    glm::vec2 leftB = frontD;
-                    glm::vec2 leftC(frontD.x - handleDepth, frontD.y - handleDepth);
-                    glm::vec2 leftD(frontA.x - handleDepth, frontA.y - handleDepth);
-                    pushQuad(g_laneVertices,
-                             pixelToNDC(frontA, screenWidth, screenHeight),
-                             pixelToNDC(frontB, screenWidth, screenHeight),
-                             pixelToNDC(frontC, screenWidth, screenHeight),
-                             pixelToNDC(frontD, screenWidth, screenHeight),
-                             handleFront);
-                    pushQuad(g_laneVertices,
-                             pixelToNDC(topA, screenWidth, screenHeight),
-                             pixelToNDC(topB, screenWidth, screenHeight),
-                             pixelToNDC(topC, screenWidth, screenHeight),
-                             pixelToNDC(topD, screenWidth, screenHeight),
-                             handleTop);
-                    pushQuad(g_laneVertices,
-                             pixelToNDC(leftA, screenWidth, screenHeight),
-                             pixelToNDC(leftB, screenWidth, screenHeight),
-                             pixelToNDC(leftC, screenWidth, screenHeight),
-                             pixelToNDC(leftD, screenWidth, screenHeight),
-                             handleSide);
-                }
-            }
-
-            g_staticVertexCount = g_laneVertices.size();
-            for (int t = 0; t < midiTrackCount; ++t) {
-                g_waveVersions[static_cast<size_t>(t)] = midi.tracks[static_cast<size_t>(t)].waveformVersion;
-            }
-        };
-
-        if (rebuildStatic) {
-            buildLanes(-1);
-        }
-
-        int previewSlot = -1;
+        LaneGeometry::Rows rows;
+        rows.startY = startY;
+        rows.rowSpan = rowSpan;
         if (daw.dragActive && daw.dragLaneType == 1) {
-            previewSlot = daw.dragDropIndex;
+            rows.previewSlot = daw.dragDropIndex;
         } else if (daw.externalDropActive && daw.externalDropType == 1) {
-            previewSlot = daw.externalDropIndex;
+            rows.previewSlot = daw.externalDropIndex;
         }
-        const bool previewingMidiLaneDrag = (previewSlot >= 0
-            && daw.dragActive
-            && daw.dragLaneType == 1
-            && daw.dragLaneIndex >= 0);
-        const int draggedLaneIndex = daw.dragLaneIndex;
-        auto computeDisplayIndex = [&](int laneIndex) -> int {
-            int displayIndex = laneIndex;
-            if (previewSlot < 0) return displayIndex;
-            if (previewingMidiLaneDrag) {
-                if (laneIndex == draggedLaneIndex) return -1;
-                if (laneIndex > draggedLaneIndex) {
-                    displayIndex -= 1;
-                }
-            }
-            if (displayIndex >= previewSlot) {
-                displayIndex += 1;
-            }
-            return displayIndex;
-        };
-        if (previewSlot >= 0) {
-            buildLanes(previewSlot);
-        } else if (g_cachedPreviewSlot >= 0 && !rebuildStatic) {
-            // Preview ended; refresh cached static lane vertices immediately.
-            buildLanes(-1);
+        rows.previewingDrag = rows.previewSlot >= 0 && daw.dragActive && daw.dragLaneType == 1 && daw.dragLaneIndex >= 0;
+        rows.draggedLaneIndex = daw.dragLaneIndex;
+
+        // Segments are rewritten only when their own inputs change;
+        // scrolling, zooming and lane drags move them through the transform,
+        // except the waveform columns, which follow the view horizontally.
+        LaneGeometry::View view;
+        view.offsetSamples = static_cast<double>(daw.timelineOffsetSamples);
+        view.windowSamples = std::max(0.0, secondsPerScreen * static_cast<double>(daw.sampleRate));
+        view.laneLeft = laneLeft;
+        view.laneRight = laneRight;
+        view.screenWidth = laneLayout.screenWidth;
+        view.screenHeight = laneLayout.screenHeight;
+        refreshGeometry(midi, daw, laneLayout, rows, midiLaneIndex, view, lanePalette(world));
+        g_laneCache.store.transform.setView(view);
+        placeLanes(rows, midiLaneIndex);
+
+        LaneGeometry::Key composeKey;
+        composeKey.addReal(laneLayout.screenWidth).addReal(laneLayout.screenHeight)
+            .addReal(view.offsetSamples).addReal(view.windowSamples)
+            .addReal(laneLeft).addReal(laneRight).addReal(laneHalfH)
+            .addReal(startY).addReal(rowSpan).addReal(daw.bpm.load(std::memory_order_relaxed))
+            .add(static_cast<uint64_t>(rows.previewSlot + 1)).add(rows.previewingDrag ? 1u : 0u)
+            .add(static_cast<uint64_t>(rows.draggedLaneIndex + 1))
+            .add(static_cast<uint64_t>(midiLaneIndex.size()));
+        for (int laneIndex : midiLaneIndex) {
+            composeKey.add(static_cast<uint64_t>(laneIndex + 1));
+        }
+        if (!g_laneCache.composed || composeKey.value() != g_laneCache.composedKey
+            || g_laneCache.store.revision() != g_laneCache.composedRevision) {
+            composeLanes(midi, daw, laneLayout, rows, midiLaneIndex, view);
+            g_laneCache.composedKey = composeKey.value();
+            g_laneCache.composedRevision = g_laneCache.store.revision();
+            g_laneCache.composed = true;
         }
-        g_cachedPreviewSlot = previewSlot;
-
-        if (g_laneVertices.empty()) return;
 
-        g_laneVertices.resize(g_staticVertexCount);
+        g_laneVertices.clear();
+        g_laneLabels.clear();
         glm::vec3 selectedColor(0.45f, 0.72f, 1.0f);
         auto itSelected = world.colorLibrary.find("MiraLaneSelected");
         if (itSelected != world.colorLibrary.end()) {
@@ -1500,7 +1294,7 @@ namespace MidiLaneSystemLogic {
                     ? midiLaneIndex[static_cast<size_t>(t)]
                     : -1;
                 if (laneIndex < 0) continue;
-                int displayIndex = computeDisplayIndex(laneIndex);
+                int displayIndex = rows.displayIndex(laneIndex);
                 if (displayIndex < 0) continue;
                 float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
                 float top = 0.0f;
@@ -1603,7 +1397,7 @@ namespace MidiLaneSystemLogic {
             if (targetTrack >= 0 && targetTrack < midiTrackCount) {
                 int laneIndex = midiLaneIndex[static_cast<size_t>(targetTrack)];
                 if (laneIndex >= 0) {
-                    int displayIndex = computeDisplayIndex(laneIndex);
+                    int displayIndex = rows.displayIndex(laneIndex);
                     if (displayIndex >= 0) {
                         float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
                         float top = 0.0f;
@@ -1650,7 +1444,7 @@ namespace MidiLaneSystemLogic {
             && g_clipTrimIndex < static_cast<int>(midi.tracks[static_cast<size_t>(g_clipTrimTrack)].clips.size())) {
             int laneIndex = midiLaneIndex[static_cast<size_t>(g_clipTrimTrack)];
             if (laneIndex >= 0) {
-                int displayIndex = computeDisplayIndex(laneIndex);
+                int displayIndex = rows.displayIndex(laneIndex);
                 if (displayIndex >= 0) {
                     float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
                     float top = 0.0f;
@@ -1692,7 +1486,7 @@ namespace MidiLaneSystemLogic {
             }
         }
         if (daw.selectedLaneType == 1 && daw.selectedLaneIndex >= 0) {
-            int displayIndex = computeDisplayIndex(daw.selectedLaneIndex);
+            int displayIndex = rows.displayIndex(daw.selectedLaneIndex);
             if (displayIndex < 0) {
                 displayIndex = -1;
             }
@@ -1771,8 +1565,8 @@ namespace MidiLaneSystemLogic {
                      pixelToNDC({centerX - handleHalf - bevelDepth, ghostBottom - bevelDepth}, screenWidth, screenHeight),
                      pixelToNDC({centerX - handleHalf - bevelDepth, ghostTop - bevelDepth}, screenWidth, screenHeight),
                      glm::clamp(ghostColor - glm::vec3(0.06f), glm::vec3(0.0f), glm::vec3(1.0f)));
-            if (previewSlot >= 0) {
-                float insertY = startY + (static_cast<float>(previewSlot) - 0.5f) * rowSpan;
+            if (rows.previewSlot >= 0) {
+                float insertY = startY + (static_cast<float>(rows.previewSlot) - 0.5f) * rowSpan;
                 float lineHalf = 2.0f;
                 pushQuad(g_laneVertices,
                          pixelToNDC({laneLeft, insertY - lineHalf}, screenWidth, screenHeight),
@@ -1785,27 +1579,15 @@ namespace MidiLaneSystemLogic {
 
         DawLaneInputSystemLogic::ApplyLaneResizeCursor(win, trimCursorWanted || g_clipTrimActive);
 
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
         float laneAlpha = kLaneAlphaDefault;
         if (baseSystem.daw) {
             laneAlpha = std::clamp(baseSystem.daw->activeThemeBackground.a, 0.0f, 1.0f);
         }
-        glBlendColor(0.0f, 0.0f, 0.0f, laneAlpha);
-        glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-        glBindVertexArray(renderer.uiMidiLaneVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.uiMidiLaneVBO);
-        glBufferData(GL_ARRAY_BUFFER, g_laneVertices.size() * sizeof(UiVertex), g_laneVertices.data(), GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)0);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)(sizeof(glm::vec2)));
-
-        renderer.uiColorShader->use();
-        renderer.uiColorShader->setFloat("alpha", laneAlpha);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(g_laneVertices.size()));
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_DEPTH_TEST);
+        UIBatch::Builder& batch = UIBatchSystemLogic::Frame(baseSystem);
+        g_laneCache.store.transform.setAlpha(laneAlpha);
+        UIBatchSystemLogic::UseLaneStore(baseSystem, g_laneCache.store);
+        g_laneCache.plan.submit(batch, g_laneCache.store);
+        batch.addColored(g_laneVertices, laneAlpha, g_laneLabels);
     }
 
     void OnTimelineRebased(uint64_t shiftSamples) {
@@ -67,6 +67,7 @@ namespace MidiStampingSystemLogic {
                 applyTokens(inst, midi.stampSourceInstances[i], row);
                 world.instances[i] = std::move(inst);
             }
+            world.instanceEdits += 1;
         }
 
         void updateMidiStamping(BaseSystem& baseSystem, MidiContext& midi, const DawContext& daw) {
@@ -86,6 +87,7 @@ namespace MidiStampingSystemLogic {
                     if (worldIndex < 0 || worldIndex >= static_cast<int>(level.worlds.size())) continue;
                     if (protectedWorlds.find(worldIndex) != protectedWorlds.end()) continue;
                     level.worlds[worldIndex].instances.clear();
+                    level.worlds[worldIndex].instanceEdits += 1;
                 }
                 // UIStampingSystem owns row replication when lane order is active.
                 // Keep legacy MidiStamping bookkeeping inert to avoid cross-system
@@ -129,6 +131,7 @@ namespace MidiStampingSystemLogic {
                     stampRow(sourceWorld, midi, 0, true, baseSystem);
                 } else {
                     sourceWorld.instances.clear();
+                    sourceWorld.instanceEdits += 1;
                 }
             }
 
@@ -152,6 +155,7 @@ namespace MidiStampingSystemLogic {
                     int worldIndex = midi.stampRowWorldIndices[row];
                     if (worldIndex < 0 || worldIndex >= static_cast<int>(level.worlds.size())) continue;
                     level.worlds[worldIndex].instances.clear();
+                    level.worlds[worldIndex].instanceEdits += 1;
                 }
                 if (baseSystem.ui) baseSystem.ui->buttonCacheBuilt = false;
                 if (baseSystem.font) baseSystem.font->textCacheBuilt = false;
@@ -174,6 +178,7 @@ namespace MidiStampingSystemLogic {
                 for (size_t i = 0; i < count; ++i) {
                     world.instances[i].position.y = midi.stampSourceBaseY[i] + rowOffset;
                 }
+                world.instanceEdits += 1;
             }
         }
     }
@@ -263,7 +263,7 @@ namespace MidiTrackSystemLogic {
         UIContext& ui = *baseSystem.ui;
         DawContext& daw = *baseSystem.daw;
 
-        if (!midi.initialized && audio.client) {
+        if (!midi.initialized && (audio.client || audio.offlineDriver)) {
             initializeMidi(baseSystem, midi, audio, daw);
         }
         if (!midi.initialized) return;
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Bucketed (pitch, time) grid over one clip's notes. Each note is filed under
+// every time bucket of its pitch row that [start, start + max(length, 1))
+// covers, so a query only visits the buckets its own window covers and
+// reports each note once. Ids are indices into the clip's note vector.
+// sync() diffs the notes against what was filed and re-files only the notes
+// that moved, so edits made anywhere (piano roll, lane trims, recording)
+// keep the index exact without hooks at each edit site; a shrinking vector
+// renumbers ids and is rebuilt. Bucket width is picked at rebuild from the
+// note count and extent; notes that later land past the extent go in the
+// last bucket, which is open-ended.
+struct NoteGridIndex {
+    static constexpr int kPitchCount = 128;
+    static constexpr size_t kNotesPerBucket = 4;
+    static constexpr uint32_t kMaxBuckets = 512;
+
+    struct Filed {
+        int row = 0;
+        uint64_t start = 0;
+        uint64_t end = 0;
+    };
+
+    uint64_t bucketSamples = 1;
+    uint32_t bucketCount = 0;
+    size_t builtCount = 0;
+    std::vector<Filed> filed;
+    std::vector<std::vector<uint32_t>> cells;  // row * bucketCount + bucket
+
+    template <class Note>
+    static Filed extentOf(const Note& note) {
+        Filed f;
+        f.row = std::clamp(note.pitch, 0, kPitchCount - 1);
+        f.start = note.startSample;
+        f.end = note.startSample + std::max<uint64_t>(note.length, 1);
+        return f;
+    }
+
+    uint32_t bucketOf(uint64_t sample) const {
+        const uint64_t bucket = sample / bucketSamples;
+        return bucket >= bucketCount ? bucketCount - 1 : static_cast<uint32_t>(bucket);
+    }
+
+    template <class Note>
+    void rebuild(const std::vector<Note>& notes) {
+        filed.clear();
+        filed.reserve(notes.size());
+        uint64_t extent = 1;
+        bool usedRows[kPitchCount] = {};
+        size_t rowCount = 0;
+        for (const auto& note : notes) {
+            filed.push_back(extentOf(note));
+            extent = std::max(extent, filed.back().end);
+            if (!usedRows[filed.back().row]) {
+                usedRows[filed.back().row] = true;
+                ++rowCount;
+            }
+        }
+        const size_t perRow = notes.size() / (kNotesPerBucket * std::max<size_t>(rowCount, 1));
+        bucketCount = static_cast<uint32_t>(std::clamp<size_t>(perRow, 1, kMaxBuckets));
+        bucketSamples = std::max<uint64_t>(1, (extent + bucketCount - 1) / bucketCount);
+        // Keep the cells' storage across rebuilds; erases rebuild.
+        cells.resize(static_cast<size_t>(kPitchCount) * bucketCount);
+        for (auto& cell : cells) {
+            cell.clear();
+        }
+        for (uint32_t id = 0; id < filed.size(); ++id) {
+            file(id);
+        }
+        builtCount = notes.size();
+    }
+
+    // Brings the index up to date with `notes`; returns true if anything was
+    // re-filed.
+    template <class Note>
+    bool sync(const std::vector<Note>& notes) {
+        // Rebuild on erase, and when appends have outgrown the bucket width.
+        if (bucketCount == 0 || notes.size() < filed.size() || notes.size() > 2 * builtCount + 64) {
+            rebuild(notes);
+            return true;
+        }
+        bool changed = false;
+        for (uint32_t id = 0; id < filed.size(); ++id) {
+            const Filed now = extentOf(notes[id]);
+            const Filed& was = filed[id];
+            if (now.row == was.row && now.start == was.start && now.end == was.end) continue;
+            unfile(id);
+            filed[id] = now;
+            file(id);
+            changed = true;
+        }
+        while (filed.size() < notes.size()) {
+            filed.push_back(extentOf(notes[filed.size()]));
+            file(static_cast<uint32_t>(filed.size() - 1));
+            changed = true;
+        }
+        return changed;
+    }
+
+    // Appends to `out`, in ascending id order, every note filed in pitch
+    // rows [rowMin, rowMax] (clamped to 0..127, as notes are) whose span
+    // meets samples [t0, t1]. Callers pad the window for minimum drawn widths
+    // and run the exact test, pitch included.
+    void query(int rowMin, int rowMax, uint64_t t0, uint64_t t1, std::vector<uint32_t>& out) const {
+        if (bucketCount == 0 || t1 < t0 || rowMax < rowMin) return;
+        rowMin = std::clamp(rowMin, 0, kPitchCount - 1);
+        rowMax = std::clamp(rowMax, 0, kPitchCount - 1);
+        const size_t base = out.size();
+        const uint32_t b0 = bucketOf(t0);
+        const uint32_t b1 = bucketOf(t1);
+        for (int row = rowMin; row <= rowMax; ++row) {
+            const size_t rowBase = static_cast<size_t>(row) * bucketCount;
+            for (uint32_t b = b0; b <= b1; ++b) {
+                for (uint32_t id : cells[rowBase + b]) {
+                    const Filed& f = filed[id];
+                    if (f.start > t1 || f.end <= t0) continue;
+                    // Report once, from the first bucket both spans share.
+                    if (std::max(bucketOf(f.start), b0) != b) continue;
+                    out.push_back(id);
+                }
+            }
+        }
+        std::sort(out.begin() + static_cast<std::ptrdiff_t>(base), out.end());
+    }
+
+    // Clip-local sample window covering window pixels [left, right] of a
+    // clip drawn from clipX at pxPerSample, widened for rounding; false if
+    // it ends before the clip does.
+    static bool pixelWindow(double clipX, double pxPerSample, double left, double right,
+                            uint64_t& t0, uint64_t& t1) {
+        constexpr uint64_t kAll = std::numeric_limits<uint64_t>::max();
+        if (!(pxPerSample > 0.0)) {
+            t0 = 0;
+            t1 = kAll;
+            return true;
+        }
+        const double lo = std::floor((left - clipX) / pxPerSample) - 1.0;
+        const double hi = std::ceil((right - clipX) / pxPerSample) + 1.0;
+        if (!(hi >= 0.0)) return false;
+        t0 = lo > 0.0 ? (lo < 1.0e19 ? static_cast<uint64_t>(lo) : kAll) : 0;
+        t1 = hi < 1.0e19 ? static_cast<uint64_t>(hi) : kAll;
+        return true;
+    }
+
+private:
+    void file(uint32_t id) {
+        const Filed& f = filed[id];
+        const size_t rowBase = static_cast<size_t>(f.row) * bucketCount;
+        const uint32_t last = bucketOf(f.end - 1);
+        for (uint32_t b = bucketOf(f.start); b <= last; ++b) {
+            cells[rowBase + b].push_back(id);
+        }
+    }
+
+    void unfile(uint32_t id) {
+        const Filed& f = filed[id];
+        const size_t rowBase = static_cast<size_t>(f.row) * bucketCount;
+        const uint32_t last = bucketOf(f.end - 1);
+        for (uint32_t b = bucketOf(f.start); b <= last; ++b) {
+            auto& cell = cells[rowBase + b];
+            auto it = std::find(cell.begin(), cell.end(), id);
+            if (it != cell.end()) {
+                *it = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+};
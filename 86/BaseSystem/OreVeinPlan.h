@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Ore veins are discs scattered one per `cellSize` XZ cell; a column takes
+// the variant of the nearest disc covering it among the 3x3 cells around its
+// own. Plan evaluates each cell's disc once for a whole footprint and then
+// resolves columns against that small grid, instead of hashing nine cells
+// per column. Results match variantForColumn exactly.
+namespace OreVeinPlan {
+
+    struct Params {
+        bool enabled = true;
+        int seed = 4242;
+        int cellSize = 14;
+        float radiusMin = 2.0f;
+        float radiusMax = 4.5f;
+        float chance = 0.18f;
+    };
+
+    // The 2D cell hash the vein layout has always been seeded with.
+    inline uint32_t hash2D(int x, int z) {
+        uint32_t ux = static_cast<uint32_t>(x) * 73856093u;
+        uint32_t uz = static_cast<uint32_t>(z) * 19349663u;
+        uint32_t h = ux ^ uz;
+        h ^= (h >> 13);
+        h *= 1274126177u;
+        h ^= (h >> 16);
+        return h;
+    }
+
+    inline int floorDiv(int value, int divisor) {
+        if (value >= 0) return value / divisor;
+        return -(((-value) + divisor - 1) / divisor);
+    }
+
+    // radius2 < 0 marks a cell without a vein; no column distance passes it.
+    struct Cell {
+        float centerX = 0.0f;
+        float centerZ = 0.0f;
+        float radius2 = -1.0f;
+        int variant = -1;
+    };
+
+    inline Cell evaluateCell(const Params& params, int vx, int vz) {
+        Cell cell;
+        const uint32_t seed = hash2D(vx + params.seed * 17, vz - params.seed * 23);
+        const float chanceRoll = static_cast<float>((seed >> 24u) & 0xffu) / 255.0f;
+        if (chanceRoll > params.chance) return cell;
+        const float offsetX = static_cast<float>(seed & 0xffu) / 255.0f;
+        const float offsetZ = static_cast<float>((seed >> 8u) & 0xffu) / 255.0f;
+        cell.centerX = (static_cast<float>(vx) + offsetX) * static_cast<float>(params.cellSize);
+        cell.centerZ = (static_cast<float>(vz) + offsetZ) * static_cast<float>(params.cellSize);
+        const uint32_t radiusSeed = hash2D(vx * 131 + params.seed, vz * 197 - params.seed);
+        const float radiusT = static_cast<float>(radiusSeed & 0xffu) / 255.0f;
+        const float radius = params.radiusMin + (params.radiusMax - params.radiusMin) * radiusT;
+        cell.radius2 = radius * radius;
+        const uint32_t variantSeed = hash2D(vx * 313 + params.seed * 7, vz * 571 - params.seed * 11);
+        cell.variant = static_cast<int>((variantSeed >> 5u) & 0x3u);
+        return cell;
+    }
+
+    // Per-column reference path.
+    inline int variantForColumn(const Params& params, int worldX, int worldZ) {
+        if (!params.enabled) return -1;
+        const int cellX = floorDiv(worldX, params.cellSize);
+        const int cellZ = floorDiv(worldZ, params.cellSize);
+        int bestVariant = -1;
+        float bestDist2 = std::numeric_limits<float>::max();
+        for (int oz = -1; oz <= 1; ++oz) {
+            for (int ox = -1; ox <= 1; ++ox) {
+                const Cell cell = evaluateCell(params, cellX + ox, cellZ + oz);
+                const float dx = static_cast<float>(worldX) - cell.centerX;
+                const float dz = static_cast<float>(worldZ) - cell.centerZ;
+                const float dist2 = dx * dx + dz * dz;
+                if (dist2 > cell.radius2) continue;
+                if (dist2 < bestDist2) {
+                    bestDist2 = dist2;
+                    bestVariant = cell.variant;
+                }
+            }
+        }
+        return bestVariant;
+    }
+
+    // Cell features for every cell within one of the footprint, kept as
+    // separate arrays so the column pass runs over plain floats.
+    struct Grid {
+        int cellX0 = 0;
+        int cellZ0 = 0;
+        int cellsX = 0;
+        int cellsZ = 0;
+        std::vector<float> centerX;
+        std::vector<float> centerZ;
+        std::vector<float> radius2;
+        std::vector<int8_t> variant;
+        std::vector<int> columnCell; // grid column of each planned column, reused per row
+
+        void build(const Params& params, int minX, int minZ, int maxX, int maxZ) {
+            cellX0 = floorDiv(minX, params.cellSize) - 1;
+            cellZ0 = floorDiv(minZ, params.cellSize) - 1;
+            cellsX = floorDiv(maxX, params.cellSize) + 1 - cellX0 + 1;
+            cellsZ = floorDiv(maxZ, params.cellSize) + 1 - cellZ0 + 1;
+            const size_t count = static_cast<size_t>(cellsX) * static_cast<size_t>(cellsZ);
+            centerX.resize(count);
+            centerZ.resize(count);
+            radius2.resize(count);
+            variant.resize(count);
+            for (int cz = 0; cz < cellsZ; ++cz) {
+                for (int cx = 0; cx < cellsX; ++cx) {
+                    const Cell cell = evaluateCell(params, cellX0 + cx, cellZ0 + cz);
+                    const size_t i = static_cast<size_t>(cz) * static_cast<size_t>(cellsX) + static_cast<size_t>(cx);
+                    centerX[i] = cell.centerX;
+                    centerZ[i] = cell.centerZ;
+                    radius2[i] = cell.radius2;
+                    variant[i] = static_cast<int8_t>(cell.variant);
+                }
+            }
+        }
+    };
+
+    // Variants for a count x count block of columns `step` world units apart
+    // starting at (originX, originZ), x fastest; -1 where no vein reaches.
+    // step is 1 << lod, so one plan serves any LOD.
+    inline void planColumns(const Params& params, int originX, int originZ, int count, int step,
+                            Grid& grid, std::vector<int8_t>& out) {
+        const size_t columns = static_cast<size_t>(count) * static_cast<size_t>(count);
+        out.assign(columns, static_cast<int8_t>(-1));
+        if (!params.enabled || count <= 0) return;
+        const int span = (count - 1) * step;
+        grid.build(params, originX, originZ, originX + span, originZ + span);
+        grid.columnCell.resize(static_cast<size_t>(count));
+        for (int x = 0; x < count; ++x) {
+            grid.columnCell[static_cast<size_t>(x)] = floorDiv(originX + x * step, params.cellSize) - grid.cellX0;
+        }
+        for (int z = 0; z < count; ++z) {
+            const int worldZ = originZ + z * step;
+            const int rowZ = floorDiv(worldZ, params.cellSize) - grid.cellZ0;
+            for (int x = 0; x < count; ++x) {
+                const int worldX = originX + x * step;
+                const int colX = grid.columnCell[static_cast<size_t>(x)];
+                int8_t bestVariant = -1;
+                float bestDist2 = std::numeric_limits<float>::max();
+                for (int oz = -1; oz <= 1; ++oz) {
+                    const size_t row = static_cast<size_t>(rowZ + oz) * static_cast<size_t>(grid.cellsX);
+                    for (int ox = -1; ox <= 1; ++ox) {
+                        const size_t i = row + static_cast<size_t>(colX + ox);
+                        const float dx = static_cast<float>(worldX) - grid.centerX[i];
+                        const float dz = static_cast<float>(worldZ) - grid.centerZ[i];
+                        const float dist2 = dx * dx + dz * dz;
+                        const bool better = dist2 <= grid.radius2[i] && dist2 < bestDist2;
+                        bestDist2 = better ? dist2 : bestDist2;
+                        bestVariant = better ? grid.variant[i] : bestVariant;
+                    }
+                }
+                out[static_cast<size_t>(z) * static_cast<size_t>(count) + static_cast<size_t>(x)] = bestVariant;
+            }
+        }
+    }
+}
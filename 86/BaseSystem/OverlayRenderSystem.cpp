@@ -4,6 +4,8 @@
 #include <cmath>
 #include <vector>
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace ExpanseBiomeSystemLogic { bool SampleTerrain(const WorldContext& worldCtx, float x, float z, float& outHeight); }
 namespace LeyLineSystemLogic { float SampleLeyStress(const WorldContext& worldCtx, float x, float z); float SampleLeyUplift(const WorldContext& worldCtx, float x, float z); }
 
@@ -168,6 +170,7 @@ namespace OverlayRenderSystemLogic {
         if (!baseSystem.renderer || !baseSystem.player) return;
         RendererContext& renderer = *baseSystem.renderer;
         PlayerContext& player = *baseSystem.player;
+        RenderDevice::Device& device = RenderDevice::current();
 
         float time = static_cast<float>(glfwGetTime());
         glm::mat4 view = player.viewMatrix;
@@ -194,19 +197,19 @@ namespace OverlayRenderSystemLogic {
             renderer.selectionShader->setMat4("projection", projection);
             renderer.selectionShader->setVec3("cameraPos", playerPos);
             renderer.selectionShader->setFloat("time", time);
-            glBindVertexArray(renderer.selectionVAO);
-            glDrawArrays(GL_LINES, 0, renderer.selectionVertexCount);
+            device.bindVertexArray(renderer.selectionVAO);
+            device.drawArrays(GL_LINES, 0, renderer.selectionVertexCount);
         }
 
         if (renderer.audioRayShader && renderer.audioRayVAO && renderer.audioRayVertexCount > 0) {
-            glEnable(GL_BLEND);
+            device.enable(GL_BLEND);
             renderer.audioRayShader->use();
             renderer.audioRayShader->setMat4("view", view);
             renderer.audioRayShader->setMat4("projection", projection);
-            glBindVertexArray(renderer.audioRayVAO);
-            glLineWidth(1.6f);
-            glDrawArrays(GL_LINES, 0, renderer.audioRayVertexCount);
-            glLineWidth(1.0f);
+            device.bindVertexArray(renderer.audioRayVAO);
+            device.lineWidth(1.6f);
+            device.drawArrays(GL_LINES, 0, renderer.audioRayVertexCount);
+            device.lineWidth(1.0f);
         }
 
         const bool leyLineDebugVisualizerEnabled = readRegistryBool(baseSystem, "LeyLineDebugVisualizerEnabled", false);
@@ -217,21 +220,18 @@ namespace OverlayRenderSystemLogic {
             std::vector<LeyLineDebugVertex> vertices = buildLeyLineDebugVertices(baseSystem);
             renderer.leyLineDebugVertexCount = static_cast<int>(vertices.size());
             if (!vertices.empty()) {
-                glBindBuffer(GL_ARRAY_BUFFER, renderer.leyLineDebugVBO);
-                glBufferData(GL_ARRAY_BUFFER,
-                             static_cast<GLsizeiptr>(vertices.size() * sizeof(LeyLineDebugVertex)),
-                             vertices.data(),
-                             GL_DYNAMIC_DRAW);
-                glDepthMask(GL_FALSE);
-                glEnable(GL_BLEND);
+                device.bindBuffer(GL_ARRAY_BUFFER, renderer.leyLineDebugVBO);
+                device.bufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(LeyLineDebugVertex), vertices.data(), GL_DYNAMIC_DRAW);
+                device.depthMask(false);
+                device.enable(GL_BLEND);
                 renderer.audioRayShader->use();
                 renderer.audioRayShader->setMat4("view", view);
                 renderer.audioRayShader->setMat4("projection", projection);
-                glBindVertexArray(renderer.leyLineDebugVAO);
-                glLineWidth(1.4f);
-                glDrawArrays(GL_LINES, 0, renderer.leyLineDebugVertexCount);
-                glLineWidth(1.0f);
-                glDepthMask(GL_TRUE);
+                device.bindVertexArray(renderer.leyLineDebugVAO);
+                device.lineWidth(1.4f);
+                device.drawArrays(GL_LINES, 0, renderer.leyLineDebugVertexCount);
+                device.lineWidth(1.0f);
+                device.depthMask(true);
             }
         } else {
             renderer.leyLineDebugVertexCount = 0;
@@ -249,13 +249,13 @@ namespace OverlayRenderSystemLogic {
             }
         }
         if (crosshairEnabled && renderer.crosshairShader && renderer.crosshairVAO && renderer.crosshairVertexCount > 0) {
-            glDisable(GL_DEPTH_TEST);
+            device.disable(GL_DEPTH_TEST);
             renderer.crosshairShader->use();
-            glBindVertexArray(renderer.crosshairVAO);
-            glLineWidth(1.0f);
-            glDrawArrays(GL_LINES, 0, renderer.crosshairVertexCount);
-            glLineWidth(1.0f);
-            glEnable(GL_DEPTH_TEST);
+            device.bindVertexArray(renderer.crosshairVAO);
+            device.lineWidth(1.0f);
+            device.drawArrays(GL_LINES, 0, renderer.crosshairVertexCount);
+            device.lineWidth(1.0f);
+            device.enable(GL_DEPTH_TEST);
         }
 
         bool legacyMeterEnabled = false;
@@ -268,7 +268,7 @@ namespace OverlayRenderSystemLogic {
         if (legacyMeterEnabled && baseSystem.hud && renderer.hudShader && renderer.hudVAO) {
             HUDContext& hud = *baseSystem.hud;
             if (hud.showCharge) {
-                glDisable(GL_DEPTH_TEST);
+                device.disable(GL_DEPTH_TEST);
                 renderer.hudShader->use();
                 renderer.hudShader->setFloat("fillAmount", glm::clamp(hud.chargeValue, 0.0f, 1.0f));
                 renderer.hudShader->setInt("ready", hud.chargeReady ? 1 : 0);
@@ -283,12 +283,12 @@ namespace OverlayRenderSystemLogic {
                 renderer.hudShader->setInt("tilesPerCol", renderer.atlasTilesPerCol);
                 renderer.hudShader->setInt("atlasTexture", 0);
                 if (renderer.atlasTexture != 0) {
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, renderer.atlasTexture);
+                    device.activeTexture(GL_TEXTURE0);
+                    device.bindTexture(GL_TEXTURE_2D, renderer.atlasTexture);
                 }
-                glBindVertexArray(renderer.hudVAO);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                glEnable(GL_DEPTH_TEST);
+                device.bindVertexArray(renderer.hudVAO);
+                device.drawArrays(GL_TRIANGLES, 0, 6);
+                device.enable(GL_DEPTH_TEST);
             }
         }
     }
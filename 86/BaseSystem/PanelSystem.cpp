@@ -5,6 +5,10 @@
 #include <cmath>
 #include <limits>
 
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic { UIBatch::Builder& Frame(BaseSystem& baseSystem); }
+
 namespace PanelSystemLogic {
     namespace {
         constexpr float kLeftFraction = 0.2f;
@@ -170,17 +174,6 @@ namespace PanelSystemLogic {
             pushQuad(verts, leftA, leftB, leftC, leftD, leftColor, width, height);
         }
 
-        void ensureResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.uiColorShader) {
-                renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(),
-                                                                 world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.uiPanelVAO == 0) {
-                glGenVertexArrays(1, &renderer.uiPanelVAO);
-                glGenBuffers(1, &renderer.uiPanelVBO);
-            }
-        }
-
         int findWorldIndex(const LevelContext& level, const std::string& name) {
             for (size_t i = 0; i < level.worlds.size(); ++i) {
                 if (level.worlds[i].name == name) return static_cast<int>(i);
@@ -275,6 +268,7 @@ namespace PanelSystemLogic {
             inst->position.y = rect.y + rect.h * 0.5f;
             inst->size.x = rect.w * 0.5f;
             inst->size.y = rect.h * 0.5f;
+            level.worlds[worldIndex].instanceEdits += 1;
         }
 
         void updateTimelineButtons(LevelContext& level, PanelContext& panel, float laneLeft, float topOffset) {
@@ -308,6 +302,7 @@ namespace PanelSystemLogic {
                     insts[idx].position.x = rightX;
                 }
             }
+            level.worlds[panel.screenWorldIndex].instanceEdits += 1;
             panel.timelineOffsetY = appliedOffset;
         }
 
@@ -322,6 +317,7 @@ namespace PanelSystemLogic {
             for (size_t i = 0; i < insts.size(); ++i) {
                 insts[i].position = panel.transportBasePositions[i] + glm::vec3(0.0f, appliedOffset, 0.0f);
             }
+            level.worlds[panel.transportWorldIndex].instanceEdits += 1;
             panel.transportOffsetY = appliedOffset;
         }
     }
@@ -544,10 +540,8 @@ namespace PanelSystemLogic {
 
             PanelContext& panel = *baseSystem.panel;
             if (!panel.cacheBuilt) return;
-            RendererContext& renderer = *baseSystem.renderer;
             WorldContext& world = *baseSystem.world;
             LevelContext& level = *baseSystem.level;
-            ensureResources(renderer, world);
 
             int windowWidth = 0, windowHeight = 0;
             glfwGetWindowSize(win, &windowWidth, &windowHeight);
@@ -621,28 +615,13 @@ namespace PanelSystemLogic {
                 appendPanel(bottomRect, panel.panelBottomIndex);
             }
 
-            if (vertices.empty() || !renderer.uiColorShader) return;
+            if (vertices.empty()) return;
 
-            glDisable(GL_DEPTH_TEST);
-            glEnable(GL_BLEND);
             float panelAlpha = kPanelAlphaDefault;
             if (baseSystem.daw) {
                 panelAlpha = std::clamp(baseSystem.daw->activeThemePanel.a, 0.0f, 1.0f);
             }
-            glBlendColor(0.0f, 0.0f, 0.0f, panelAlpha);
-            glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-            glBindVertexArray(renderer.uiPanelVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.uiPanelVBO);
-            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(PanelVertex), vertices.data(), GL_DYNAMIC_DRAW);
-            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(PanelVertex), (void*)offsetof(PanelVertex, pos));
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(PanelVertex), (void*)offsetof(PanelVertex, color));
-            glEnableVertexAttribArray(1);
-
-            renderer.uiColorShader->use();
-            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glEnable(GL_DEPTH_TEST);
+            UIBatchSystemLogic::Frame(baseSystem).addColored(vertices, panelAlpha);
         }
     }
 
@@ -1,5 +1,9 @@
 #pragma once
 #include "../Host.h"
+#include "BaseSystem/RenderDevice.h"
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic { UIBatch::Stats LastFrameStats(); }
 
 namespace PerfSystemLogic {
     namespace {
@@ -23,6 +27,8 @@ namespace PerfSystemLogic {
             perf.enabled = data.value("enabled", false);
             perf.reportInterval = data.value("intervalSeconds", 1.0);
             perf.hitchThresholdMs = data.value("hitchThresholdMs", 16.0);
+            perf.drawCallBudget = data.value("drawCallBudget", 0u);
+            perf.uploadByteBudget = data.value("uploadByteBudget", static_cast<size_t>(0));
             perf.allowlist.clear();
             if (data.contains("allowlist") && data["allowlist"].is_array()) {
                 for (const auto& entry : data["allowlist"]) {
@@ -33,6 +39,19 @@ namespace PerfSystemLogic {
             }
             perf.configLoaded = true;
         }
+
+        // Tallies the device's last completed frame against the budgets.
+        void checkFrameBudget(PerfContext& perf) {
+            if (!RenderDevice::hasCurrent()) return;
+            const RenderDevice::FrameStats& stats = RenderDevice::current().lastFrameStats();
+            RenderDevice::Budget budget;
+            budget.maxDrawCalls = perf.drawCallBudget;
+            budget.maxUploadBytes = perf.uploadByteBudget;
+            if (RenderDevice::overDrawBudget(stats, budget)) perf.overDrawBudgetFrames += 1;
+            if (RenderDevice::overUploadBudget(stats, budget)) perf.overUploadBudgetFrames += 1;
+            perf.peakDrawCalls = std::max(perf.peakDrawCalls, stats.drawCalls);
+            perf.peakUploadBytes = std::max(perf.peakUploadBytes, stats.uploadBytes);
+        }
     }
 
     void UpdatePerf(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
@@ -43,6 +62,7 @@ namespace PerfSystemLogic {
             loadPerfConfig(perf);
         }
         if (!perf.enabled) return;
+        checkFrameBudget(perf);
 
         double now = glfwGetTime();
         if (perf.lastReportTime <= 0.0) {
@@ -55,6 +75,27 @@ namespace PerfSystemLogic {
         double fps = elapsed > 0.0 ? static_cast<double>(perf.frameCount) / elapsed : 0.0;
         std::cout << "[Perf] " << perf.frameCount << " frames in "
                   << elapsed << "s (~" << fps << " fps)" << std::endl;
+        if (RenderDevice::hasCurrent()) {
+            const RenderDevice::FrameStats& frame = RenderDevice::current().lastFrameStats();
+            std::cout << "[Perf] GPU: " << frame.drawCalls << " draws (" << frame.instances << " instances, "
+                      << frame.vertices << " vertices), " << frame.uploads << " uploads, "
+                      << frame.uploadBytes << " bytes, " << frame.programBinds << " program binds (last frame); peak "
+                      << perf.peakDrawCalls << " draws, " << perf.peakUploadBytes << " bytes" << std::endl;
+            if (perf.overDrawBudgetFrames > 0) {
+                std::cerr << "[Perf] over draw budget (" << perf.drawCallBudget << ") in "
+                          << perf.overDrawBudgetFrames << " frames" << std::endl;
+            }
+            if (perf.overUploadBudgetFrames > 0) {
+                std::cerr << "[Perf] over upload budget (" << perf.uploadByteBudget << " bytes) in "
+                          << perf.overUploadBudgetFrames << " frames" << std::endl;
+            }
+        }
+        const UIBatch::Stats uiStats = UIBatchSystemLogic::LastFrameStats();
+        if (uiStats.submits > 0) {
+            std::cout << "[Perf] UI batch: " << uiStats.submits << " submits -> " << uiStats.draws
+                      << " draws in " << uiStats.flushes << " flushes, " << uiStats.vertices << " vertices, "
+                      << uiStats.bytes << " bytes (last frame)" << std::endl;
+        }
 
         std::vector<std::pair<std::string, double>> sortedTotals;
         sortedTotals.reserve(perf.totalsMs.size());
@@ -77,6 +118,10 @@ namespace PerfSystemLogic {
         perf.maxMs.clear();
         perf.counts.clear();
         perf.hitchCounts.clear();
+        perf.overDrawBudgetFrames = 0;
+        perf.overUploadBudgetFrames = 0;
+        perf.peakDrawCalls = 0;
+        perf.peakUploadBytes = 0;
         perf.frameCount = 0;
         perf.lastReportTime = now;
     }
@@ -4,9 +4,12 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "BaseSystem/NoteGridIndex.h"
+
 namespace PianoRollResourceSystemLogic {
     struct PianoRollState;
     struct PianoRollConfig;
@@ -30,6 +33,7 @@ namespace PianoRollResourceSystemLogic {
     int FindNoteAtStart(const std::vector<MidiNote>& notes, int pitch, double startSample, int excludeIndex);
     int FindOverlappingNote(const std::vector<MidiNote>& notes, int pitch, double startSample, int excludeIndex);
     double GetNextNoteStart(const std::vector<MidiNote>& notes, int pitch, double startSample, int excludeIndex);
+    const std::vector<NoteGridIndex>& SyncNoteIndex(PianoRollState& state, int trackIndex, const std::vector<MidiClip>& clips);
     bool PlaceNote(std::vector<MidiNote>& notes,
                    int pitch,
                    double& startSample,
@@ -66,6 +70,8 @@ namespace PianoRollInputSystemLogic {
             state.scaleButton.value = name;
         }
 
+        std::vector<uint32_t> g_noteHits;
+
         bool isInsideRect(float x, float y, float w, float h, float mx, float my) {
             return mx >= x && mx <= x + w && my >= y && my <= y + h;
         }
@@ -396,10 +402,15 @@ namespace PianoRollInputSystemLogic {
         if (startRow < 0) startRow = 0;
         if (endRow > totalRows - 1) endRow = totalRows - 1;
 
-        int hoverNote = -1;
-        int hoverClip = -1;
-        if (inGridArea) {
-            for (int row = startRow; row <= endRow; ++row) {
+        // First note, in row then clip then note order, whose rect grown by
+        // padX/padY holds the cursor. Only rows within reach of the cursor
+        // are visited, and only notes the clip's index places there.
+        const auto& clipNoteIndex = PianoRollResourceSystemLogic::SyncNoteIndex(state, trackIndex, laneClips);
+        auto findNoteAt = [&](float padX, float padY, int& outRow, int& outClip, int& outNote) {
+            outRow = outClip = outNote = -1;
+            int rowLo = std::max(startRow, static_cast<int>(std::floor((gridOrigin - mouseY - padY) / gridStep)) - 1);
+            int rowHi = std::min(endRow, static_cast<int>(std::ceil((gridOrigin - mouseY + padY) / gridStep)));
+            for (int row = rowLo; row <= rowHi; ++row) {
                 if (row < 0 || row >= totalRows) continue;
                 int pitch = 24 + row;
                 float ny = gridOrigin - (row + 1) * gridStep;
@@ -408,23 +419,35 @@ namespace PianoRollInputSystemLogic {
                     if (laneClip.length == 0) continue;
                     float laneClipStartX = gridLeft + state.scrollOffsetX
                         + static_cast<float>(static_cast<double>(laneClip.startSample) * pxPerSample);
-                    for (int i = 0; i < static_cast<int>(laneClip.notes.size()); ++i) {
-                        const MidiNote& note = laneClip.notes[static_cast<size_t>(i)];
+                    uint64_t t0 = 0;
+                    uint64_t t1 = 0;
+                    if (!NoteGridIndex::pixelWindow(laneClipStartX, pxPerSample,
+                                                    mouseX - padX - 3.0, mouseX + padX + 1.0, t0, t1)) {
+                        continue;
+                    }
+                    g_noteHits.clear();
+                    clipNoteIndex[static_cast<size_t>(ci)].query(pitch, pitch, t0, t1, g_noteHits);
+                    for (uint32_t i : g_noteHits) {
+                        const MidiNote& note = laneClip.notes[i];
                         if (note.pitch != pitch) continue;
                         float nx = laneClipStartX + static_cast<float>(note.startSample * pxPerSample);
                         float nw = std::max(2.0f, static_cast<float>(note.length * pxPerSample));
-                        if (isInsideRect(nx, ny, nw, gridStep, mouseX, mouseY)) {
-                            hoverNote = i;
-                            hoverClip = ci;
-                            break;
+                        if (isInsideRect(nx - padX, ny - padY, nw + 2.0f * padX, gridStep + 2.0f * padY, mouseX, mouseY)) {
+                            outRow = row;
+                            outClip = ci;
+                            outNote = static_cast<int>(i);
+                            return;
                         }
                     }
-                    if (hoverNote >= 0) {
-                        break;
-                    }
                 }
-                if (hoverNote >= 0) break;
             }
+        };
+
+        int hoverNote = -1;
+        int hoverClip = -1;
+        if (inGridArea) {
+            int hoverRow = -1;
+            findNoteAt(0.0f, 0.0f, hoverRow, hoverClip, hoverNote);
         }
 
         GLFWcursor* desiredCursor = state.cursorDefault;
@@ -724,35 +747,9 @@ namespace PianoRollInputSystemLogic {
             int deleteRow = -1;
             const float deletePadX = 6.0f;
             const float deletePadY = 4.0f;
-            for (int row = startRow; row <= endRow; ++row) {
-                if (row < 0 || row >= totalRows) continue;
-                int pitch = 24 + row;
-                float ny = gridOrigin - (row + 1) * gridStep;
-                for (int ci = 0; ci < static_cast<int>(laneClips.size()); ++ci) {
-                    const auto& laneClip = laneClips[static_cast<size_t>(ci)];
-                    if (laneClip.length == 0) continue;
-                    float noteStartX = gridLeft + state.scrollOffsetX
-                        + static_cast<float>(static_cast<double>(laneClip.startSample) * pxPerSample);
-                    for (int i = 0; i < static_cast<int>(laneClip.notes.size()); ++i) {
-                        const MidiNote& note = laneClip.notes[static_cast<size_t>(i)];
-                        if (note.pitch != pitch) continue;
-                        float nx = noteStartX + static_cast<float>(note.startSample * pxPerSample);
-                        float nw = std::max(2.0f, static_cast<float>(note.length * pxPerSample));
-                        if (isInsideRect(nx - deletePadX, ny - deletePadY,
-                                         nw + 2.0f * deletePadX, gridStep + 2.0f * deletePadY,
-                                         mouseX, mouseY)) {
-                            deleteIndex = i;
-                            deleteClipIndex = ci;
-                            deleteRow = row;
-                            break;
-                        }
-                    }
-                    if (deleteIndex >= 0) {
-                        break;
-                    }
-                }
-                if (deleteIndex >= 0) break;
-            }
+            // Edits above may have moved notes since the hover test.
+            PianoRollResourceSystemLogic::SyncNoteIndex(state, trackIndex, laneClips);
+            findNoteAt(deletePadX, deletePadY, deleteRow, deleteClipIndex, deleteIndex);
             if (deleteIndex >= 0 && deleteClipIndex >= 0 && deleteClipIndex < static_cast<int>(laneClips.size())) {
                 MidiClip& deleteClip = laneClips[static_cast<size_t>(deleteClipIndex)];
                 if (deleteIndex < 0 || deleteIndex >= static_cast<int>(deleteClip.notes.size())) {
@@ -5,13 +5,21 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <string>
 #include <vector>
 
 #include <glm/glm.hpp>
 
-#include "stb_easy_font.h"
+#include "BaseSystem/NoteGridIndex.h"
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic { UIBatch::Builder& Frame(BaseSystem& baseSystem); }
+namespace FontSystemLogic {
+    bool AppendUiLabel(UIBatch::TextOverlay& labels, size_t at, float x, float y, const char* text,
+                       const glm::vec3& color, double screenWidth, double screenHeight);
+}
 
 namespace PianoRollResourceSystemLogic {
     struct UiVertex;
@@ -27,11 +35,14 @@ namespace PianoRollResourceSystemLogic {
     const std::vector<std::string>& SnapOptions();
     void NoteColor(int noteIndex, float& r, float& g, float& b);
     std::string FormatButtonValue(const std::string& value);
+    const std::vector<NoteGridIndex>& SyncNoteIndex(PianoRollState& state, int trackIndex, const std::vector<MidiClip>& clips);
 }
 
 namespace PianoRollRenderSystemLogic {
     namespace {
         std::vector<PianoRollResourceSystemLogic::UiVertex> g_vertices;
+        std::vector<uint32_t> g_visibleNotes;
+        UIBatch::TextOverlay g_labels;
 
         glm::vec2 pixelToNDC(const glm::vec2& pixel, double width, double height) {
             float ndcX = static_cast<float>((pixel.x / width) * 2.0 - 1.0);
@@ -82,29 +93,18 @@ namespace PianoRollRenderSystemLogic {
             pushLine(verts, x, y + h, x, y, thickness, color, width, height);
         }
 
-        void pushText(std::vector<PianoRollResourceSystemLogic::UiVertex>& verts, float x, float y, const char* text, const glm::vec3& color, double width, double height) {
-            if (!text || text[0] == '\0') return;
-            char buffer[99999];
-            int numQuads = stb_easy_font_print(x, y, const_cast<char*>(text), nullptr, buffer, sizeof(buffer));
-            float* vertsRaw = reinterpret_cast<float*>(buffer);
-            for (int i = 0; i < numQuads; ++i) {
-                int base = i * 16;
-                glm::vec2 v0{vertsRaw[base + 0], vertsRaw[base + 1]};
-                glm::vec2 v1{vertsRaw[base + 4], vertsRaw[base + 5]};
-                glm::vec2 v2{vertsRaw[base + 8], vertsRaw[base + 9]};
-                glm::vec2 v3{vertsRaw[base + 12], vertsRaw[base + 13]};
-                pushQuad(verts, v0, v1, v2, v3, color, width, height);
-            }
+        void pushText(std::vector<PianoRollResourceSystemLogic::UiVertex>& verts, UIBatch::TextOverlay& labels, float x, float y, const char* text, const glm::vec3& color, double width, double height) {
+            FontSystemLogic::AppendUiLabel(labels, verts.size(), x, y, text, color, width, height);
         }
 
-        void pushMultilineText(std::vector<PianoRollResourceSystemLogic::UiVertex>& verts, float x, float y, const std::string& text, float lineHeight, const glm::vec3& color, double width, double height) {
+        void pushMultilineText(std::vector<PianoRollResourceSystemLogic::UiVertex>& verts, UIBatch::TextOverlay& labels, float x, float y, const std::string& text, float lineHeight, const glm::vec3& color, double width, double height) {
             size_t start = 0;
             float lineY = y;
             while (start <= text.size()) {
                 size_t end = text.find('\n', start);
                 std::string line = (end == std::string::npos) ? text.substr(start) : text.substr(start, end - start);
                 if (!line.empty()) {
-                    pushText(verts, x, lineY, line.c_str(), color, width, height);
+                    pushText(verts, labels, x, lineY, line.c_str(), color, width, height);
                 }
                 if (end == std::string::npos) break;
                 start = end + 1;
@@ -152,12 +152,9 @@ namespace PianoRollRenderSystemLogic {
         if (!state.active || !state.layoutReady) return;
         if (!baseSystem.renderer || !baseSystem.world || !baseSystem.midi || !win) return;
 
-        RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
         MidiContext& midi = *baseSystem.midi;
 
-        if (!renderer.uiColorShader) return;
-
         int trackIndex = state.layout.trackIndex;
         int clipIndex = state.layout.clipIndex;
         if (trackIndex < 0 || trackIndex >= static_cast<int>(midi.tracks.size())) return;
@@ -180,6 +177,7 @@ namespace PianoRollRenderSystemLogic {
 
         g_vertices.clear();
         g_vertices.reserve(4096);
+        g_labels.clear();
 
         auto clampColorOffset = [](const glm::vec3& color, float offset) -> glm::vec3 {
             return glm::clamp(color + glm::vec3(offset), glm::vec3(0.0f), glm::vec3(1.0f));
@@ -293,7 +291,7 @@ namespace PianoRollRenderSystemLogic {
             int64_t barLabelValue = (barZeroBased >= 0) ? (barZeroBased + 1) : barZeroBased;
             char label[16];
             std::snprintf(label, sizeof(label), "%lld", static_cast<long long>(barLabelValue));
-            pushText(g_vertices, x + 4.0f, viewTop + 14.0f, label, glm::vec3(0.62f, 0.72f, 0.72f), screenWidth, screenHeight);
+            pushText(g_vertices, g_labels, x + 4.0f, viewTop + 14.0f, label, glm::vec3(0.62f, 0.72f, 0.72f), screenWidth, screenHeight);
         }
         int beatIndexStart = static_cast<int>(std::floor(visibleStartSample / std::max(1.0, beatSamples))) - 1;
         int beatIndexEnd = static_cast<int>(std::ceil(visibleEndSample / std::max(1.0, beatSamples))) + 1;
@@ -325,9 +323,10 @@ namespace PianoRollRenderSystemLogic {
             float y1 = gridOrigin - row * gridStep;
             if (y1 < viewTop || y0 > viewBottom) continue;
             float labelY = y0 + gridStep * 0.65f;
-            pushText(g_vertices, gridLeft + 6.0f, labelY, label, glm::vec3(0.6f, 0.7f, 0.7f), screenWidth, screenHeight);
+            pushText(g_vertices, g_labels, gridLeft + 6.0f, labelY, label, glm::vec3(0.6f, 0.7f, 0.7f), screenWidth, screenHeight);
         }
 
+        const auto& clipNoteIndex = PianoRollResourceSystemLogic::SyncNoteIndex(state, trackIndex, track.clips);
         for (size_t laneClipIndex = 0; laneClipIndex < track.clips.size(); ++laneClipIndex) {
             const MidiClip& laneClip = track.clips[laneClipIndex];
             if (laneClip.length == 0) continue;
@@ -339,7 +338,17 @@ namespace PianoRollRenderSystemLogic {
             glm::vec3 clipEdge(0.24f, 0.40f, 0.44f);
             pushLine(g_vertices, laneClipStartX, viewTop, laneClipStartX, viewBottom, 1.0f, clipEdge, screenWidth, screenHeight);
             pushLine(g_vertices, laneClipEndX, viewTop, laneClipEndX, viewBottom, 1.0f, clipEdge, screenWidth, screenHeight);
-            for (const auto& note : laneClip.notes) {
+            // Only notes the index places near the visible rows and columns
+            // reach the exact cull below; 3 px of slack covers the 2 px
+            // minimum width and float rounding of nx.
+            g_visibleNotes.clear();
+            uint64_t t0 = 0;
+            uint64_t t1 = 0;
+            if (NoteGridIndex::pixelWindow(laneClipStartX, pxPerSample, gridLeft - 3.0f, gridRight + 1.0f, t0, t1)) {
+                clipNoteIndex[laneClipIndex].query(startRow + 24, endRow + 24, t0, t1, g_visibleNotes);
+            }
+            for (uint32_t noteId : g_visibleNotes) {
+                const MidiNote& note = laneClip.notes[noteId];
                 int row = note.pitch - 24;
                 if (row < startRow || row > endRow) continue;
                 float nx = laneClipStartX + static_cast<float>(note.startSample * pxPerSample);
@@ -355,7 +364,7 @@ namespace PianoRollRenderSystemLogic {
                 char label[16];
                 int octave = (note.pitch / 12) - 1;
                 std::snprintf(label, sizeof(label), "%s%d", noteNames[noteIndex], octave);
-                pushText(g_vertices, nx + 4.0f, ny + gridStep - 12.0f, label, glm::vec3(0.1f, 0.2f, 0.25f), screenWidth, screenHeight);
+                pushText(g_vertices, g_labels, nx + 4.0f, ny + gridStep - 12.0f, label, glm::vec3(0.1f, 0.2f, 0.25f), screenWidth, screenHeight);
             }
         }
 
@@ -387,7 +396,7 @@ namespace PianoRollRenderSystemLogic {
             std::snprintf(label, sizeof(label), "%s%d", noteNames[key.note], key.octave);
             float labelX = key.x + key.w - 22.0f;
             float labelY = y + key.h - 10.0f;
-            pushText(g_vertices, labelX, labelY, label, glm::vec3(0.0f), screenWidth, screenHeight);
+            pushText(g_vertices, g_labels, labelX, labelY, label, glm::vec3(0.0f), screenWidth, screenHeight);
         }
         for (const auto& key : state.blackKeys) {
             float y = key.y + state.scrollOffsetY;
@@ -395,7 +404,7 @@ namespace PianoRollRenderSystemLogic {
             std::snprintf(label, sizeof(label), "%s%d", noteNames[key.note], key.octave);
             float labelX = key.x + key.w - 22.0f;
             float labelY = y + key.h - 10.0f;
-            pushText(g_vertices, labelX, labelY, label, glm::vec3(0.9f), screenWidth, screenHeight);
+            pushText(g_vertices, g_labels, labelX, labelY, label, glm::vec3(0.9f), screenWidth, screenHeight);
         }
 
         pushRect(g_vertices, 0.0f, 0.0f, static_cast<float>(screenWidth), cfg.borderHeight, borderColor, screenWidth, screenHeight);
@@ -409,8 +418,8 @@ namespace PianoRollRenderSystemLogic {
             pushRect(g_vertices, state.scaleButton.x, state.scaleButton.y, state.scaleButton.w, state.scaleButton.h, pianoAccent, screenWidth, screenHeight);
         }
 
-        pushText(g_vertices, state.modeDrawButton.x + 6.0f, 33.0f, "Draw", glm::vec3(0.85f, 0.9f, 0.9f), screenWidth, screenHeight);
-        pushText(g_vertices, state.modePaintButton.x + 6.0f, 33.0f, "Paint", glm::vec3(0.85f, 0.9f, 0.9f), screenWidth, screenHeight);
+        pushText(g_vertices, g_labels, state.modeDrawButton.x + 6.0f, 33.0f, "Draw", glm::vec3(0.85f, 0.9f, 0.9f), screenWidth, screenHeight);
+        pushText(g_vertices, g_labels, state.modePaintButton.x + 6.0f, 33.0f, "Paint", glm::vec3(0.85f, 0.9f, 0.9f), screenWidth, screenHeight);
 
         pushRect(g_vertices, layout.closeLeft, layout.closeTop, layout.closeSize, layout.closeSize, glm::vec3(0.75f, 0.28f, 0.25f), screenWidth, screenHeight);
         pushLine(g_vertices, layout.closeLeft + 7.0f, layout.closeTop + 7.0f, layout.closeLeft + layout.closeSize - 7.0f, layout.closeTop + layout.closeSize - 7.0f, 2.0f, glm::vec3(0.95f), screenWidth, screenHeight);
@@ -426,30 +435,30 @@ namespace PianoRollRenderSystemLogic {
         } else {
             drawBeveledQuadTint(drawKey, 0.0f, 0.8f, 0.8f, 0.8f, g_vertices, screenWidth, screenHeight);
         }
-        pushText(g_vertices, drawKey.x + 6.0f, drawKey.y + 18.0f, "Draw", glm::vec3(0.0f), screenWidth, screenHeight);
+        pushText(g_vertices, g_labels, drawKey.x + 6.0f, drawKey.y + 18.0f, "Draw", glm::vec3(0.0f), screenWidth, screenHeight);
 
         if (state.modePaintButton.isToggled) {
             drawBeveledQuadTint(paintKey, 0.0f, 0.85f, 0.9f, 0.9f, g_vertices, screenWidth, screenHeight);
         } else {
             drawBeveledQuadTint(paintKey, 0.0f, 0.8f, 0.8f, 0.8f, g_vertices, screenWidth, screenHeight);
         }
-        pushText(g_vertices, paintKey.x + 6.0f, paintKey.y + 18.0f, "Paint", glm::vec3(0.0f), screenWidth, screenHeight);
+        pushText(g_vertices, g_labels, paintKey.x + 6.0f, paintKey.y + 18.0f, "Paint", glm::vec3(0.0f), screenWidth, screenHeight);
 
         if (state.scaleButton.isToggled) {
             drawBeveledQuadTint(scaleKey, 0.0f, 0.85f, 0.9f, 0.9f, g_vertices, screenWidth, screenHeight);
         } else {
             drawBeveledQuadTint(scaleKey, 0.0f, 0.8f, 0.8f, 0.8f, g_vertices, screenWidth, screenHeight);
         }
-        pushText(g_vertices, scaleKey.x + 4.0f, scaleKey.y + 3.0f, "Scale", glm::vec3(0.0f), screenWidth, screenHeight);
-        pushText(g_vertices, scaleKey.x + 4.0f, scaleKey.y + 18.0f, state.scaleButton.value.c_str(), glm::vec3(0.0f), screenWidth, screenHeight);
+        pushText(g_vertices, g_labels, scaleKey.x + 4.0f, scaleKey.y + 3.0f, "Scale", glm::vec3(0.0f), screenWidth, screenHeight);
+        pushText(g_vertices, g_labels, scaleKey.x + 4.0f, scaleKey.y + 18.0f, state.scaleButton.value.c_str(), glm::vec3(0.0f), screenWidth, screenHeight);
 
         if (state.gridButton.isToggled) {
             drawBeveledQuadTint(buttonKey, 0.0f, 0.85f, 0.9f, 0.9f, g_vertices, screenWidth, screenHeight);
         } else {
             drawBeveledQuadTint(buttonKey, 0.0f, 0.8f, 0.8f, 0.8f, g_vertices, screenWidth, screenHeight);
         }
-        pushText(g_vertices, buttonKey.x + 4.0f, buttonKey.y + 3.0f, "Snap", glm::vec3(0.0f), screenWidth, screenHeight);
-        pushMultilineText(g_vertices, buttonKey.x + 4.0f, buttonKey.y + 15.0f, PianoRollResourceSystemLogic::FormatButtonValue(state.gridButton.value), 10.0f, glm::vec3(0.0f), screenWidth, screenHeight);
+        pushText(g_vertices, g_labels, buttonKey.x + 4.0f, buttonKey.y + 3.0f, "Snap", glm::vec3(0.0f), screenWidth, screenHeight);
+        pushMultilineText(g_vertices, g_labels, buttonKey.x + 4.0f, buttonKey.y + 15.0f, PianoRollResourceSystemLogic::FormatButtonValue(state.gridButton.value), 10.0f, glm::vec3(0.0f), screenWidth, screenHeight);
 
         if (state.menuOpen) {
             float menuX = state.gridButton.x;
@@ -468,7 +477,7 @@ namespace PianoRollRenderSystemLogic {
             }
             for (int i = 0; i < static_cast<int>(snapOptions.size()); ++i) {
                 float textY = menuY + menuPadding + i * menuRowHeight + 3.0f;
-                pushText(g_vertices, menuX + 8.0f, textY, snapOptions[i].c_str(), glm::vec3(0.0f), screenWidth, screenHeight);
+                pushText(g_vertices, g_labels, menuX + 8.0f, textY, snapOptions[i].c_str(), glm::vec3(0.0f), screenWidth, screenHeight);
             }
         }
 
@@ -499,9 +508,9 @@ namespace PianoRollRenderSystemLogic {
                 float textY = scaleMenuY + menuPadding + (i + 1) * menuRowHeight + 3.0f;
                 float markOffset = 2.0f;
                 if (state.scaleRoot == i && state.scaleType != PianoRollResourceSystemLogic::ScaleType::None) {
-                    pushText(g_vertices, rootX + markOffset, textY, "x", glm::vec3(0.0f), screenWidth, screenHeight);
+                    pushText(g_vertices, g_labels, rootX + markOffset, textY, "x", glm::vec3(0.0f), screenWidth, screenHeight);
                 }
-                pushText(g_vertices, rootX + 12.0f, textY, noteNamesLocal[i], glm::vec3(0.0f), screenWidth, screenHeight);
+                pushText(g_vertices, g_labels, rootX + 12.0f, textY, noteNamesLocal[i], glm::vec3(0.0f), screenWidth, screenHeight);
 
                 if ((i == 0 && state.scaleType == PianoRollResourceSystemLogic::ScaleType::None) ||
                     (i == 1 && state.scaleType == PianoRollResourceSystemLogic::ScaleType::Major) ||
@@ -510,36 +519,17 @@ namespace PianoRollRenderSystemLogic {
                     (i == 4 && state.scaleType == PianoRollResourceSystemLogic::ScaleType::HungarianMinor) ||
                     (i == 5 && state.scaleType == PianoRollResourceSystemLogic::ScaleType::NeapolitanMajor) ||
                     (i == 6 && state.scaleType == PianoRollResourceSystemLogic::ScaleType::DoubleHarmonicMinor)) {
-                    pushText(g_vertices, scaleX + markOffset, textY, "x", glm::vec3(0.0f), screenWidth, screenHeight);
+                    pushText(g_vertices, g_labels, scaleX + markOffset, textY, "x", glm::vec3(0.0f), screenWidth, screenHeight);
                 }
-                pushText(g_vertices, scaleX + 12.0f, textY, scaleNames[i], glm::vec3(0.0f), screenWidth, screenHeight);
+                pushText(g_vertices, g_labels, scaleX + 12.0f, textY, scaleNames[i], glm::vec3(0.0f), screenWidth, screenHeight);
 
                 if (state.scaleMode == i && state.scaleType != PianoRollResourceSystemLogic::ScaleType::None) {
-                    pushText(g_vertices, modeX + markOffset, textY, "x", glm::vec3(0.0f), screenWidth, screenHeight);
+                    pushText(g_vertices, g_labels, modeX + markOffset, textY, "x", glm::vec3(0.0f), screenWidth, screenHeight);
                 }
-                pushText(g_vertices, modeX + 12.0f, textY, modeNames[i], glm::vec3(0.0f), screenWidth, screenHeight);
+                pushText(g_vertices, g_labels, modeX + 12.0f, textY, modeNames[i], glm::vec3(0.0f), screenWidth, screenHeight);
             }
         }
 
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-
-        glBindVertexArray(renderer.uiPianoRollVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, renderer.uiPianoRollVBO);
-        glBufferData(GL_ARRAY_BUFFER, g_vertices.size() * sizeof(PianoRollResourceSystemLogic::UiVertex), g_vertices.data(), GL_DYNAMIC_DRAW);
-
-        renderer.uiColorShader->use();
-        renderer.uiColorShader->setFloat("alpha", 1.0f);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(PianoRollResourceSystemLogic::UiVertex), (void*)0);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(PianoRollResourceSystemLogic::UiVertex), (void*)offsetof(PianoRollResourceSystemLogic::UiVertex, color));
-        glEnableVertexAttribArray(1);
-
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(g_vertices.size()));
-        glBindVertexArray(0);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_DEPTH_TEST);
+        UIBatchSystemLogic::Frame(baseSystem).addColored(g_vertices, 1.0f, g_labels);
     }
 }
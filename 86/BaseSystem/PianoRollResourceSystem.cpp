@@ -12,6 +12,8 @@
 
 #include "stb_image.h"
 
+#include "BaseSystem/NoteGridIndex.h"
+
 namespace PianoRollResourceSystemLogic {
     struct UiVertex {
         glm::vec2 pos;
@@ -180,6 +182,10 @@ namespace PianoRollResourceSystemLogic {
         int cachedTrack = -1;
         int cachedClip = -1;
 
+        // One note index per clip of noteIndexTrack; see SyncNoteIndex.
+        std::vector<NoteGridIndex> noteIndex;
+        int noteIndexTrack = -1;
+
         PianoRollLayout layout;
     };
 
@@ -415,6 +421,21 @@ namespace PianoRollResourceSystemLogic {
         return nextStart;
     }
 
+    // Brings the per-clip note indexes up to date with the notes of `clips`.
+    // Called by input and render each frame, so edits from any system are
+    // picked up before the next hit test or draw.
+    const std::vector<NoteGridIndex>& SyncNoteIndex(PianoRollState& state, int trackIndex, const std::vector<MidiClip>& clips) {
+        if (state.noteIndexTrack != trackIndex) {
+            state.noteIndex.clear();
+            state.noteIndexTrack = trackIndex;
+        }
+        state.noteIndex.resize(clips.size());
+        for (size_t i = 0; i < clips.size(); ++i) {
+            state.noteIndex[i].sync(clips[i].notes);
+        }
+        return state.noteIndex;
+    }
+
     bool PlaceNote(std::vector<MidiNote>& notes,
                    int pitch,
                    double& startSample,
@@ -463,17 +484,6 @@ namespace PianoRollResourceSystemLogic {
         return x >= left && x <= right && y >= top && y <= bottom;
     }
 
-    void EnsureResources(RendererContext& renderer, WorldContext& world) {
-        if (!renderer.uiColorShader) {
-            renderer.uiColorShader = std::make_unique<Shader>(world.shaders["UI_COLOR_VERTEX_SHADER"].c_str(),
-                                                             world.shaders["UI_COLOR_FRAGMENT_SHADER"].c_str());
-        }
-        if (renderer.uiPianoRollVAO == 0) {
-            glGenVertexArrays(1, &renderer.uiPianoRollVAO);
-            glGenBuffers(1, &renderer.uiPianoRollVBO);
-        }
-    }
-
     void ResetStateForClip(PianoRollState& state) {
         const PianoRollConfig& cfg = Config();
         state.scrollOffsetX = 0.0f;
@@ -623,11 +633,6 @@ namespace PianoRollResourceSystemLogic {
             return;
         }
 
-        RendererContext& renderer = *baseSystem.renderer;
-        WorldContext& world = *baseSystem.world;
-        EnsureResources(renderer, world);
-        if (!renderer.uiColorShader) return;
-
         int trackIndex = midi.pianoRollTrack;
         int clipIndex = midi.pianoRollClipIndex;
         if (trackIndex < 0 || trackIndex >= static_cast<int>(midi.tracks.size())) return;
@@ -93,17 +93,17 @@ namespace PinkNoiseSystemLogic {
         bool micStateFound = false;
 
         if (blockEmitter) {
-            if (rtAudio.sourceStates.count(blockEmitter->instanceID)) {
-                blockState = rtAudio.sourceStates[blockEmitter->instanceID];
+            if (const AudioSourceState* found = rtAudio.sourceStates.front().find(blockEmitter->instanceID)) {
+                blockState = *found;
             }
-            if (rtAudio.micSourceStates.count(blockEmitter->instanceID)) {
-                micState = rtAudio.micSourceStates[blockEmitter->instanceID];
+            if (const AudioSourceState* found = rtAudio.micSourceStates.front().find(blockEmitter->instanceID)) {
+                micState = *found;
                 micStateFound = true;
             }
         }
         if (headEmitter) {
-            if (rtAudio.sourceStates.count(headEmitter->instanceID)) {
-                headState = rtAudio.sourceStates[headEmitter->instanceID];
+            if (const AudioSourceState* found = rtAudio.sourceStates.front().find(headEmitter->instanceID)) {
+                headState = *found;
             }
         }
 
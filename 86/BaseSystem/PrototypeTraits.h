@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Per-prototype classification bits for voxel passes. The table is built from
+// prototype names and flags once per prototype load, so hot loops test a bit
+// by block id instead of comparing names. Needs Entity to be defined first.
+namespace PrototypeTraits {
+
+    enum Trait : uint32_t {
+        Block           = 1u << 0,
+        Solid           = 1u << 1,
+        Opaque          = 1u << 2,
+        Transparent     = 1u << 3,  // renderable block that does not occlude
+        Chunkable       = 1u << 4,
+        Water           = 1u << 5,
+        Leaf            = 1u << 6,
+        PineVerticalLog = 1u << 7,
+        PineLog         = 1u << 8,  // any fir log, vertical, fallen or nub
+        GroundProp      = 1u << 9,  // grass, flowers, sticks, pebbles, wall/ceiling stones
+        WallStone       = 1u << 10,
+        CeilingStone    = 1u << 11,
+        GrassSurface    = 1u << 12,
+        StoneSurface    = 1u << 13,
+        CaveSlope       = 1u << 14,
+        FoliageGround   = 1u << 15, // solid block foliage may stand on (water excluded by id)
+        MeshLeaf        = 1u << 16, // meshed as leaves: "Leaf" or animated non-solid wireframe
+        Plant           = 1u << 17, // crossed-quad grass and flowers
+        NarrowLog       = 1u << 18, // meshed with a narrow profile: logs, sticks, pebbles, cave stones
+    };
+
+    enum class SlopeDir : uint8_t { None = 0, PosX = 1, NegX = 2, PosZ = 3, NegZ = 4 };
+
+    struct Table {
+        std::vector<uint32_t> bits;
+        std::vector<SlopeDir> slopeDir;
+        std::unordered_map<std::string, int> idByName; // first prototype with each name
+        const Entity* source = nullptr;
+        size_t sourceCount = 0;
+
+        bool has(uint32_t id, uint32_t mask) const {
+            return id < bits.size() && (bits[id] & mask) == mask;
+        }
+        bool hasAny(uint32_t id, uint32_t mask) const {
+            return id < bits.size() && (bits[id] & mask) != 0u;
+        }
+        SlopeDir slope(uint32_t id) const {
+            return id < slopeDir.size() ? slopeDir[id] : SlopeDir::None;
+        }
+        int idOf(const std::string& name) const {
+            auto it = idByName.find(name);
+            return it == idByName.end() ? -1 : it->second;
+        }
+    };
+
+    inline bool nameHasAffixes(const std::string& name, const char* prefix, const char* suffix) {
+        const std::string pre(prefix);
+        const std::string suf(suffix);
+        return name.size() >= pre.size() && name.size() >= suf.size()
+            && name.compare(0, pre.size(), pre) == 0
+            && name.compare(name.size() - suf.size(), suf.size(), suf) == 0;
+    }
+
+    inline uint32_t classify(const Entity& proto, SlopeDir& outSlope) {
+        const std::string& name = proto.name;
+        uint32_t bits = 0u;
+        if (proto.isBlock) bits |= Block;
+        if (proto.isSolid) bits |= Solid;
+        if (proto.isOpaque) bits |= Opaque;
+        if (proto.isBlock && proto.isRenderable && !proto.isOpaque) bits |= Transparent;
+        if (proto.isChunkable) bits |= Chunkable;
+        if (name == "Water") bits |= Water;
+        if (name == "Leaf") bits |= Leaf;
+        if (name == "Leaf" || (proto.isAnimated && proto.hasWireframe && !proto.isSolid)) bits |= MeshLeaf;
+        if (name == "GrassTuft" || name == "GrassTuftShort" || name == "Flower") bits |= Plant;
+
+        if (name == "FirLog1Tex" || name == "FirLog2Tex"
+            || name == "FirLog1TopTex" || name == "FirLog2TopTex") {
+            bits |= PineVerticalLog | PineLog;
+        } else if (name == "FirLog1TexX" || name == "FirLog2TexX"
+            || name == "FirLog1TexZ" || name == "FirLog2TexZ"
+            || name == "FirLog1NubTexX" || name == "FirLog2NubTexX"
+            || name == "FirLog1NubTexZ" || name == "FirLog2NubTexZ") {
+            bits |= PineLog;
+        }
+
+        if (name == "WallStoneTexPosX" || name == "WallStoneTexNegX"
+            || name == "WallStoneTexPosZ" || name == "WallStoneTexNegZ") {
+            bits |= WallStone | GroundProp;
+        } else if (name == "CeilingStoneTexX" || name == "CeilingStoneTexZ") {
+            bits |= CeilingStone | GroundProp;
+        } else if (name == "GrassTuft" || name == "GrassTuftShort" || name == "Flower"
+            || name == "StickTexX" || name == "StickTexZ"
+            || name == "StonePebbleTexX" || name == "StonePebbleTexZ") {
+            bits |= GroundProp;
+        }
+
+        if ((bits & (PineLog | WallStone | CeilingStone)) != 0u
+            || name == "StickTexX" || name == "StickTexZ"
+            || nameHasAffixes(name, "StonePebble", "TexX") || nameHasAffixes(name, "StonePebble", "TexZ")) {
+            bits |= NarrowLog;
+        }
+
+        if (name == "GrassBlockTex" || name == "ScaffoldBlock") bits |= GrassSurface;
+        if (name == "StoneBlockTex" || name == "ScaffoldBlock") bits |= StoneSurface;
+
+        outSlope = SlopeDir::None;
+        if (name == "DebugSlopeTexPosX") outSlope = SlopeDir::PosX;
+        else if (name == "DebugSlopeTexNegX") outSlope = SlopeDir::NegX;
+        else if (name == "DebugSlopeTexPosZ") outSlope = SlopeDir::PosZ;
+        else if (name == "DebugSlopeTexNegZ") outSlope = SlopeDir::NegZ;
+        if (outSlope != SlopeDir::None) bits |= CaveSlope;
+
+        if ((bits & (Block | Solid)) == (Block | Solid) && (bits & (Leaf | GroundProp)) == 0u) {
+            bits |= FoliageGround;
+        }
+        return bits;
+    }
+
+    inline Table& storage() {
+        static Table table;
+        return table;
+    }
+
+    inline const Table& Rebuild(const std::vector<Entity>& prototypes) {
+        Table& table = storage();
+        table.bits.assign(prototypes.size(), 0u);
+        table.slopeDir.assign(prototypes.size(), SlopeDir::None);
+        table.idByName.clear();
+        table.idByName.reserve(prototypes.size());
+        for (size_t i = 0; i < prototypes.size(); ++i) {
+            table.bits[i] = classify(prototypes[i], table.slopeDir[i]);
+            table.idByName.emplace(prototypes[i].name, static_cast<int>(i));
+        }
+        // Id 0 is air in the voxel world whatever prototype sits there.
+        if (!table.bits.empty()) table.bits[0] &= ~FoliageGround;
+        table.source = prototypes.data();
+        table.sourceCount = prototypes.size();
+        return table;
+    }
+
+    // Table for `prototypes`, rebuilt if they were reloaded since the last
+    // build. Cheap enough to call once per pass.
+    inline const Table& For(const std::vector<Entity>& prototypes) {
+        const Table& table = storage();
+        if (table.source == prototypes.data() && table.sourceCount == prototypes.size()) return table;
+        return Rebuild(prototypes);
+    }
+
+    // Same result as HostLogic::findPrototype without the linear name scan.
+    inline const Entity* findPrototype(const std::string& name, const std::vector<Entity>& prototypes) {
+        const int id = For(prototypes).idOf(name);
+        if (id < 0 || id >= static_cast<int>(prototypes.size())) return nullptr;
+        return &prototypes[static_cast<size_t>(id)];
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join pool for the audio ray tracer and tree decoration. run() hands
+// task indices to the workers and the calling thread from one atomic counter
+// and returns once all of them are done, so a task may only write state that
+// its index owns.
+struct RayTraceWorkerPool {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::condition_variable doneCv;
+    std::vector<std::thread> threads;
+    bool stop = false;
+    uint64_t generation = 0;
+    const std::function<void(size_t)>* task = nullptr;
+    size_t taskCount = 0;
+    size_t busyWorkers = 0;
+    std::atomic<size_t> nextTask{0};
+
+    explicit RayTraceWorkerPool(int workerCount) {
+        for (int i = 0; i < workerCount; ++i) {
+            threads.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~RayTraceWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& thread : threads) {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+    void run(size_t count, const std::function<void(size_t)>& fn) {
+        if (threads.empty() || count <= 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &fn;
+            taskCount = count;
+            nextTask.store(0, std::memory_order_relaxed);
+            busyWorkers = threads.size();
+            generation += 1;
+        }
+        cv.notify_all();
+        drain(fn, count);
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCv.wait(lock, [this]() { return busyWorkers == 0; });
+        task = nullptr;
+    }
+
+private:
+    void drain(const std::function<void(size_t)>& fn, size_t count) {
+        for (size_t i = nextTask.fetch_add(1); i < count; i = nextTask.fetch_add(1)) fn(i);
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(size_t)>* fn = nullptr;
+            size_t count = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                fn = task;
+                count = taskCount;
+            }
+            drain(*fn, count);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyWorkers == 0) doneCv.notify_one();
+        }
+    }
+};
@@ -8,6 +8,14 @@
 #include <utility>
 #include <algorithm>
 #include <string>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "BaseSystem/DampingBrickmap.h"
+#include "BaseSystem/RayTraceWorkerPool.h"
 
 // Forward Declarations
 struct BaseSystem;
@@ -26,10 +34,110 @@ namespace BlockSelectionSystemLogic {
     bool SampleBlockDamping(BaseSystem& baseSystem,
                             const glm::ivec3& cell,
                             float& dampingOut);
+    const DampingBrickmap* GetDampingBrickmap(BaseSystem& baseSystem);
+}
+
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem& baseSystem, const std::string& key, int fallback);
 }
 
 namespace RayTracedAudioSystemLogic {
 
+    namespace {
+        constexpr int kRaysPerPacket = 4;
+
+        // "RayTracedAudioWorkerThreads" counts helpers besides the main thread;
+        // 0 picks one fewer than the hardware threads, capped at 7.
+        RayTraceWorkerPool* workerPool(BaseSystem& baseSystem) {
+            if (!baseSystem.rayTracedAudio) return nullptr;
+            RayTracedAudioContext& rtAudio = *baseSystem.rayTracedAudio;
+            int threads = RenderInitSystemLogic::getRegistryInt(baseSystem, "RayTracedAudioWorkerThreads", 0);
+            if (threads <= 0) {
+                int hardware = static_cast<int>(std::thread::hardware_concurrency());
+                threads = std::clamp(hardware - 1, 0, 7);
+            }
+            threads = std::min(threads, 31);
+            if (!rtAudio.workerPool || rtAudio.workerPoolThreads != threads) {
+                rtAudio.workerPool.reset();
+                rtAudio.workerPool = std::make_shared<RayTraceWorkerPool>(threads);
+                rtAudio.workerPoolThreads = threads;
+            }
+            return rtAudio.workerPool.get();
+        }
+
+        void runTasks(RayTraceWorkerPool* pool, size_t count, const std::function<void(size_t)>& fn) {
+            if (pool) {
+                pool->run(count, fn);
+            } else {
+                for (size_t i = 0; i < count; ++i) fn(i);
+            }
+        }
+
+        constexpr float kProbeReuseCos = 0.97f;
+
+        void resetPropagation(RayTracePropagationCache& cache) {
+            for (int32_t slot : cache.usedSlots) cache.slots[static_cast<size_t>(slot)] = -1;
+            cache.usedSlots.clear();
+            cache.entries.clear();
+            cache.rays.clear();
+            cache.fieldValid = false;
+        }
+
+        bool boundsContain(const glm::ivec3& lo, const glm::ivec3& hi, const glm::ivec3& cell) {
+            return cell.x >= lo.x && cell.y >= lo.y && cell.z >= lo.z
+                && cell.x <= hi.x && cell.y <= hi.y && cell.z <= hi.z;
+        }
+
+        bool propagationSlot(const RayTracePropagationCache& cache, const glm::vec3& sourcePos, size_t& out) {
+            const int dims = RayTracePropagationCache::kDims;
+            const glm::ivec3 local = glm::ivec3(glm::floor(sourcePos)) - cache.listenerCell
+                + glm::ivec3(RayTracePropagationCache::kRadius);
+            if (local.x < 0 || local.y < 0 || local.z < 0) return false;
+            if (local.x >= dims || local.y >= dims || local.z >= dims) return false;
+            out = (static_cast<size_t>(local.z) * dims + static_cast<size_t>(local.y)) * dims + static_cast<size_t>(local.x);
+            return true;
+        }
+
+        RayTracePropagationEntry* findPropagationEntry(RayTracePropagationCache& cache, const glm::vec3& sourcePos) {
+            size_t slot = 0;
+            if (!cache.fieldValid || cache.slots.empty() || !propagationSlot(cache, sourcePos, slot)) return nullptr;
+            const int32_t index = cache.slots[slot];
+            return index < 0 ? nullptr : &cache.entries[static_cast<size_t>(index)];
+        }
+
+        RayTracePropagationEntry* insertPropagationEntry(RayTracePropagationCache& cache, const glm::vec3& sourcePos) {
+            size_t slot = 0;
+            if (!cache.fieldValid || !propagationSlot(cache, sourcePos, slot)) return nullptr;
+            if (cache.slots.empty()) {
+                const size_t dims = static_cast<size_t>(RayTracePropagationCache::kDims);
+                cache.slots.assign(dims * dims * dims, -1);
+            }
+            int32_t& index = cache.slots[slot];
+            if (index < 0) {
+                index = static_cast<int32_t>(cache.entries.size());
+                cache.entries.emplace_back();
+                cache.usedSlots.push_back(static_cast<int32_t>(slot));
+            }
+            return &cache.entries[static_cast<size_t>(index)];
+        }
+
+        // A block edit inside the listener rays' bounds may change any result;
+        // elsewhere it only drops the entries whose paths reach that cell.
+        void invalidatePropagationCell(RayTracePropagationCache& cache, const glm::ivec3& cell) {
+            if (!cache.fieldValid) return;
+            if (boundsContain(cache.fieldMin, cache.fieldMax, cell)) {
+                resetPropagation(cache);
+                return;
+            }
+            for (int32_t slot : cache.usedSlots) {
+                int32_t& index = cache.slots[static_cast<size_t>(slot)];
+                if (index < 0) continue;
+                const RayTracePropagationEntry& entry = cache.entries[static_cast<size_t>(index)];
+                if (boundsContain(entry.boundsMin, entry.boundsMax, cell)) index = -1;
+            }
+        }
+    }
+
     EntityInstance* findInstanceById(LevelContext& level, int worldIndex, int instanceId) {
             if (worldIndex < 0 || worldIndex >= static_cast<int>(level.worlds.size())) return nullptr;
             Entity& world = level.worlds[worldIndex];
@@ -75,9 +183,12 @@ namespace RayTracedAudioSystemLogic {
             float dirLenSq = glm::dot(dir, dir);
             if (dirLenSq < 1e-6f) return false;
             glm::vec3 rayDir = dir / std::sqrt(dirLenSq);
+            const DampingBrickmap* bricks = BlockSelectionSystemLogic::GetDampingBrickmap(baseSystem);
+            if (!bricks) return false;
 
             glm::ivec3 currentVoxel = glm::floor(start);
             glm::vec3 step = glm::sign(rayDir);
+            const glm::ivec3 stepCells(step);
             glm::vec3 nextBoundary = glm::vec3(currentVoxel) + 0.5f + step * 0.5f;
             glm::vec3 tMax = (nextBoundary - start) / rayDir;
             glm::vec3 tDelta = glm::abs(1.0f / rayDir);
@@ -87,37 +198,43 @@ namespace RayTracedAudioSystemLogic {
             int hitAxis = -1;
 
             while (distanceTraveled < maxDist && maxSteps > 0) {
-                --maxSteps;
-                if (tMax.x < tMax.y) {
-                    if (tMax.x < tMax.z) {
-                        currentVoxel.x += static_cast<int>(step.x);
-                        distanceTraveled = tMax.x;
-                        tMax.x += tDelta.x;
-                        hitAxis = 0;
-                    } else {
-                        currentVoxel.z += static_cast<int>(step.z);
-                        distanceTraveled = tMax.z;
-                        tMax.z += tDelta.z;
-                        hitAxis = 2;
-                    }
+                float previousDistance = distanceTraveled;
+                int skipped = bricks->skipEmptyBrick(currentVoxel, tMax, tDelta, stepCells, maxSteps, -1.0f,
+                                                     distanceTraveled, previousDistance, hitAxis);
+                if (skipped > 0) {
+                    maxSteps -= skipped;
                 } else {
-                    if (tMax.y < tMax.z) {
-                        currentVoxel.y += static_cast<int>(step.y);
-                        distanceTraveled = tMax.y;
-                        tMax.y += tDelta.y;
-                        hitAxis = 1;
+                    --maxSteps;
+                    if (tMax.x < tMax.y) {
+                        if (tMax.x < tMax.z) {
+                            currentVoxel.x += static_cast<int>(step.x);
+                            distanceTraveled = tMax.x;
+                            tMax.x += tDelta.x;
+                            hitAxis = 0;
+                        } else {
+                            currentVoxel.z += static_cast<int>(step.z);
+                            distanceTraveled = tMax.z;
+                            tMax.z += tDelta.z;
+                            hitAxis = 2;
+                        }
                     } else {
-                        currentVoxel.z += static_cast<int>(step.z);
-                        distanceTraveled = tMax.z;
-                        tMax.z += tDelta.z;
-                        hitAxis = 2;
+                        if (tMax.y < tMax.z) {
+                            currentVoxel.y += static_cast<int>(step.y);
+                            distanceTraveled = tMax.y;
+                            tMax.y += tDelta.y;
+                            hitAxis = 1;
+                        } else {
+                            currentVoxel.z += static_cast<int>(step.z);
+                            distanceTraveled = tMax.z;
+                            tMax.z += tDelta.z;
+                            hitAxis = 2;
+                        }
                     }
                 }
 
                 if (distanceTraveled >= maxDist) break;
 
-                float dummy = 0.0f;
-                if (BlockSelectionSystemLogic::SampleBlockDamping(baseSystem, currentVoxel, dummy)) {
+                if (bricks->cellValue(currentVoxel) != 0) {
                     outHitDist = distanceTraveled;
                     outHitPos = start + rayDir * distanceTraveled;
                     outNormal = glm::vec3(0.0f);
@@ -137,9 +254,12 @@ namespace RayTracedAudioSystemLogic {
             float rayLen = std::sqrt(rayLenSq);
             if (rayLen > maxDistance) rayLen = maxDistance;
             rayDir /= rayLen;
+            const DampingBrickmap* bricks = BlockSelectionSystemLogic::GetDampingBrickmap(baseSystem);
+            if (!bricks) return true;
 
             glm::ivec3 currentVoxel = glm::floor(start);
             glm::vec3 step = glm::sign(rayDir);
+            const glm::ivec3 stepCells(step);
             glm::vec3 nextBoundary = glm::vec3(currentVoxel) + 0.5f + step * 0.5f;
             glm::vec3 tMax = (nextBoundary - start) / rayDir;
             glm::vec3 tDelta = glm::abs(1.0f / rayDir);
@@ -147,23 +267,29 @@ namespace RayTracedAudioSystemLogic {
 
             float distanceTraveled = 0.0f;
             int maxSteps = 2048;
+            int skipAxis = -1;
             while (distanceTraveled < rayLen && maxSteps > 0) {
                 float lastDistance = distanceTraveled;
-                --maxSteps;
-                if (tMax.x < tMax.y) {
-                    if (tMax.x < tMax.z) { currentVoxel.x += static_cast<int>(step.x); distanceTraveled = tMax.x; tMax.x += tDelta.x; }
-                    else { currentVoxel.z += static_cast<int>(step.z); distanceTraveled = tMax.z; tMax.z += tDelta.z; }
+                int skipped = bricks->skipEmptyBrick(currentVoxel, tMax, tDelta, stepCells, maxSteps, 1e-6f,
+                                                     distanceTraveled, lastDistance, skipAxis);
+                if (skipped > 0) {
+                    maxSteps -= skipped;
                 } else {
-                    if (tMax.y < tMax.z) { currentVoxel.y += static_cast<int>(step.y); distanceTraveled = tMax.y; tMax.y += tDelta.y; }
-                    else { currentVoxel.z += static_cast<int>(step.z); distanceTraveled = tMax.z; tMax.z += tDelta.z; }
+                    --maxSteps;
+                    if (tMax.x < tMax.y) {
+                        if (tMax.x < tMax.z) { currentVoxel.x += static_cast<int>(step.x); distanceTraveled = tMax.x; tMax.x += tDelta.x; }
+                        else { currentVoxel.z += static_cast<int>(step.z); distanceTraveled = tMax.z; tMax.z += tDelta.z; }
+                    } else {
+                        if (tMax.y < tMax.z) { currentVoxel.y += static_cast<int>(step.y); distanceTraveled = tMax.y; tMax.y += tDelta.y; }
+                        else { currentVoxel.z += static_cast<int>(step.z); distanceTraveled = tMax.z; tMax.z += tDelta.z; }
+                    }
                 }
 
                 if (distanceTraveled >= rayLen) break;
 
                 if (currentVoxel == endCell) continue;
 
-                float dummy = 0.0f;
-                if (BlockSelectionSystemLogic::SampleBlockDamping(baseSystem, currentVoxel, dummy)) {
+                if (bricks->cellValue(currentVoxel) != 0) {
                     return false;
                 }
 
@@ -179,9 +305,12 @@ namespace RayTracedAudioSystemLogic {
             float rayLen = std::sqrt(rayLenSq);
             if (rayLen > maxDistance) rayLen = maxDistance;
             rayDir /= rayLen;
+            const DampingBrickmap* bricks = BlockSelectionSystemLogic::GetDampingBrickmap(baseSystem);
+            if (!bricks) return 0.0f;
 
             glm::ivec3 currentVoxel = glm::floor(start);
             glm::vec3 step = glm::sign(rayDir);
+            const glm::ivec3 stepCells(step);
             glm::vec3 nextBoundary = glm::vec3(currentVoxel) + 0.5f + step * 0.5f;
             glm::vec3 tMax = (nextBoundary - start) / rayDir;
             glm::vec3 tDelta = glm::abs(1.0f / rayDir);
@@ -190,25 +319,29 @@ namespace RayTracedAudioSystemLogic {
             float distanceTraveled = 0.0f;
             float wallDistance = 0.0f;
             int maxSteps = 2048;
+            int skipAxis = -1;
             while (distanceTraveled < rayLen && maxSteps > 0) {
                 float lastDistance = distanceTraveled;
-                --maxSteps;
-                if (tMax.x < tMax.y) {
-                    if (tMax.x < tMax.z) { currentVoxel.x += static_cast<int>(step.x); distanceTraveled = tMax.x; tMax.x += tDelta.x; }
-                    else { currentVoxel.z += static_cast<int>(step.z); distanceTraveled = tMax.z; tMax.z += tDelta.z; }
+                int skipped = bricks->skipEmptyBrick(currentVoxel, tMax, tDelta, stepCells, maxSteps, 1e-6f,
+                                                     distanceTraveled, lastDistance, skipAxis);
+                if (skipped > 0) {
+                    maxSteps -= skipped;
                 } else {
-                    if (tMax.y < tMax.z) { currentVoxel.y += static_cast<int>(step.y); distanceTraveled = tMax.y; tMax.y += tDelta.y; }
-                    else { currentVoxel.z += static_cast<int>(step.z); distanceTraveled = tMax.z; tMax.z += tDelta.z; }
+                    --maxSteps;
+                    if (tMax.x < tMax.y) {
+                        if (tMax.x < tMax.z) { currentVoxel.x += static_cast<int>(step.x); distanceTraveled = tMax.x; tMax.x += tDelta.x; }
+                        else { currentVoxel.z += static_cast<int>(step.z); distanceTraveled = tMax.z; tMax.z += tDelta.z; }
+                    } else {
+                        if (tMax.y < tMax.z) { currentVoxel.y += static_cast<int>(step.y); distanceTraveled = tMax.y; tMax.y += tDelta.y; }
+                        else { currentVoxel.z += static_cast<int>(step.z); distanceTraveled = tMax.z; tMax.z += tDelta.z; }
+                    }
                 }
 
                 float stepLength = distanceTraveled - lastDistance;
                 if (distanceTraveled >= rayLen) break;
 
-                if (currentVoxel != endCell) {
-                    float dummy = 0.0f;
-                    if (BlockSelectionSystemLogic::SampleBlockDamping(baseSystem, currentVoxel, dummy)) {
-                        wallDistance += stepLength;
-                    }
+                if (currentVoxel != endCell && bricks->cellValue(currentVoxel) != 0) {
+                    wallDistance += stepLength;
                 }
 
                 if (distanceTraveled <= lastDistance + 1e-6f) break;
@@ -242,26 +375,18 @@ namespace RayTracedAudioSystemLogic {
             RayTraceRayState& ray = batch.rays[rayIndex];
             ray.pos = batch.listenerPos;
             ray.dir = fibonacciSphereDirection(rayIndex, batch.totalRays);
-            ray.bounceIndex = 0;
-            ray.initDone = false;
-            ray.finished = false;
-            ray.escaped = false;
             ray.debug = debugActive && rayIndex < debugRayCount;
-            ray.blueLenSum = 0.0f;
-            ray.blueLenCount = 0;
-            ray.blueLenMax = 0.0f;
-            ray.lastDirPerSource.assign(batch.sourcePositions.size(), glm::vec3(0.0f));
-            ray.hasLastDirPerSource.assign(batch.sourcePositions.size(), false);
         }
     }
 
     void EmitRayStates(BaseSystem& baseSystem,
                        RayTraceBatch& batch,
+                       RayTracePropagationCache* propagation,
                        float maxDistance,
                        const glm::vec3& earForward,
                        const glm::vec3& earRight,
                        const glm::vec3& earUp,
-                       std::map<int, AudioSourceState>& states,
+                       AudioSourceStateBuffer& states,
                        int& statesVersion,
                        int finishedRaysCount,
                        bool finalUpdate) {
@@ -288,33 +413,58 @@ namespace RayTracedAudioSystemLogic {
         const float earOffset = 0.6f;
         const float probeOffset = 0.4f;
 
-        std::map<int, AudioSourceState> newStates;
-        for (size_t s = 0; s < batch.sourceIds.size(); ++s) {
-            float directRatio = 0.0f;
-            if (earOffset > 0.0f) {
-                glm::vec3 leftEar = batch.listenerPos - earRight * earOffset;
-                glm::vec3 rightEar = batch.listenerPos + earRight * earOffset;
-                bool leftLos = hasLineOfSight(baseSystem, leftEar, batch.sourcePositions[s], maxDistance);
-                bool rightLos = hasLineOfSight(baseSystem, rightEar, batch.sourcePositions[s], maxDistance);
-                directRatio = 0.5f * (static_cast<float>(leftLos) + static_cast<float>(rightLos));
-            }
-            float probeRatio = 0.0f;
-            if (probeOffset > 0.0f) {
-                glm::vec3 rightProbe = batch.listenerPos + earRight * probeOffset;
-                glm::vec3 leftProbe = batch.listenerPos - earRight * probeOffset;
-                glm::vec3 forwardProbe = batch.listenerPos + earForward * probeOffset;
-                glm::vec3 backProbe = batch.listenerPos - earForward * probeOffset;
-                glm::vec3 upProbe = batch.listenerPos + earUp * probeOffset;
-                glm::vec3 downProbe = batch.listenerPos - earUp * probeOffset;
-                int probeHits = 0;
-                probeHits += hasLineOfSight(baseSystem, rightProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
-                probeHits += hasLineOfSight(baseSystem, leftProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
-                probeHits += hasLineOfSight(baseSystem, forwardProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
-                probeHits += hasLineOfSight(baseSystem, backProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
-                probeHits += hasLineOfSight(baseSystem, upProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
-                probeHits += hasLineOfSight(baseSystem, downProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
-                probeRatio = static_cast<float>(probeHits) / 6.0f;
+        // Slots are created up front so the per-source tasks below only write
+        // into entries they own.
+        const AudioSourceStateTable& previous = states.front();
+        AudioSourceStateTable& next = states.back();
+        next.clear();
+        for (int id : batch.sourceIds) next.insert(id);
+
+        // Probe ratios cached for a source's cell are reused while the ear
+        // frame stays within about 14 degrees of the one they were traced for.
+        const size_t sourceCount = batch.sourceIds.size();
+        std::vector<float> directRatios(sourceCount, 0.0f);
+        std::vector<float> probeRatios(sourceCount, 0.0f);
+        std::vector<uint8_t> probesCached(sourceCount, 0);
+        BlockSelectionSystemLogic::GetDampingBrickmap(baseSystem);
+        for (size_t s = 0; s < sourceCount && propagation; ++s) {
+            const RayTracePropagationEntry* entry = findPropagationEntry(*propagation, batch.sourcePositions[s]);
+            if (!entry || !entry->probesValid) continue;
+            if (glm::dot(entry->probeForward, earForward) < kProbeReuseCos) continue;
+            if (glm::dot(entry->probeRight, earRight) < kProbeReuseCos) continue;
+            directRatios[s] = entry->directRatio;
+            probeRatios[s] = entry->probeRatio;
+            probesCached[s] = 1;
+        }
+
+        runTasks(workerPool(baseSystem), sourceCount, [&](size_t s) {
+            if (!probesCached[s]) {
+                if (earOffset > 0.0f) {
+                    glm::vec3 leftEar = batch.listenerPos - earRight * earOffset;
+                    glm::vec3 rightEar = batch.listenerPos + earRight * earOffset;
+                    bool leftLos = hasLineOfSight(baseSystem, leftEar, batch.sourcePositions[s], maxDistance);
+                    bool rightLos = hasLineOfSight(baseSystem, rightEar, batch.sourcePositions[s], maxDistance);
+                    directRatios[s] = 0.5f * (static_cast<float>(leftLos) + static_cast<float>(rightLos));
+                }
+                if (probeOffset > 0.0f) {
+                    glm::vec3 rightProbe = batch.listenerPos + earRight * probeOffset;
+                    glm::vec3 leftProbe = batch.listenerPos - earRight * probeOffset;
+                    glm::vec3 forwardProbe = batch.listenerPos + earForward * probeOffset;
+                    glm::vec3 backProbe = batch.listenerPos - earForward * probeOffset;
+                    glm::vec3 upProbe = batch.listenerPos + earUp * probeOffset;
+                    glm::vec3 downProbe = batch.listenerPos - earUp * probeOffset;
+                    int probeHits = 0;
+                    probeHits += hasLineOfSight(baseSystem, rightProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
+                    probeHits += hasLineOfSight(baseSystem, leftProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
+                    probeHits += hasLineOfSight(baseSystem, forwardProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
+                    probeHits += hasLineOfSight(baseSystem, backProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
+                    probeHits += hasLineOfSight(baseSystem, upProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
+                    probeHits += hasLineOfSight(baseSystem, downProbe, batch.sourcePositions[s], maxDistance) ? 1 : 0;
+                    probeRatios[s] = static_cast<float>(probeHits) / 6.0f;
+                }
             }
+            const float directRatio = directRatios[s];
+            const float probeRatio = probeRatios[s];
             AudioSourceState st;
             float greenRatio = (batch.accum[s].greenChecks > 0)
                 ? static_cast<float>(batch.accum[s].greenHits) / static_cast<float>(batch.accum[s].greenChecks)
@@ -373,14 +523,14 @@ namespace RayTracedAudioSystemLogic {
             }
 
             glm::vec3 outDir = newDir;
-            auto prevIt = states.find(batch.sourceIds[s]);
+            const AudioSourceState* prevState = previous.find(batch.sourceIds[s]);
             if (!finalUpdate) {
-                if (prevIt != states.end()) {
-                    outDir = prevIt->second.direction;
+                if (prevState) {
+                    outDir = prevState->direction;
                 }
             } else {
-                if (prevIt != states.end()) {
-                    glm::vec3 oldDir = prevIt->second.direction;
+                if (prevState) {
+                    glm::vec3 oldDir = prevState->direction;
                     if (glm::length(oldDir) < 1e-4f) {
                         oldDir = newDir;
                     }
@@ -401,130 +551,238 @@ namespace RayTracedAudioSystemLogic {
             }
             st.direction = outDir;
             st.pan = 0.0f;
-            newStates[batch.sourceIds[s]] = st;
+            next.slots[static_cast<size_t>(batch.sourceIds[s])] = st;
+        });
+        for (size_t s = 0; s < sourceCount && propagation; ++s) {
+            if (probesCached[s]) continue;
+            RayTracePropagationEntry* entry = findPropagationEntry(*propagation, batch.sourcePositions[s]);
+            if (!entry) continue;
+            entry->probesValid = true;
+            entry->probeForward = earForward;
+            entry->probeRight = earRight;
+            entry->directRatio = directRatios[s];
+            entry->probeRatio = probeRatios[s];
         }
-        states = std::move(newStates);
+        states.publish();
         statesVersion += 1;
     }
 
-    void StepRayBatch(BaseSystem& baseSystem,
-                      RayTraceBatch& batch,
-                      float maxDistance,
-                      int maxBounces,
-                      int bounceStepsPerFrame,
-                      std::vector<RayDebugSegment>* debugSegments,
-                      const glm::vec3& whiteColor,
-                      const glm::vec3& blueColor,
-                      const glm::vec3& greenColor,
-                      const glm::vec3& orangeColor) {
-        int stepsThisFrame = 0;
-        int attempts = 0;
-
-        auto finalizeRay = [&](RayTraceRayState& ray) {
-            if (ray.finished) return;
-            ray.finished = true;
-            batch.finishedRays += 1;
-            if (ray.escaped) {
-                batch.escapeCount += 1;
-            } else if (ray.blueLenCount > 0) {
-                batch.blueLenSum += ray.blueLenSum;
-                batch.blueLenCount += ray.blueLenCount;
-                batch.blueLenMax = std::max(batch.blueLenMax, ray.blueLenMax);
+    // Traces the whole batch in two fork-join passes. The first follows each
+    // packet of rays through its bounces; the second checks every (source,
+    // packet) pair of hits against that source and fills its own slot of
+    // batch.packetAccum. Those slots and the per-ray results are then summed
+    // in fixed order, so the result does not depend on the worker count.
+    // With a propagation cache, the first pass is skipped while the listener
+    // stays in its cell and the second only runs for sources without an entry.
+    void TraceRayBatch(BaseSystem& baseSystem,
+                       RayTraceBatch& batch,
+                       RayTracePropagationCache* propagation,
+                       float maxDistance,
+                       int maxBounces,
+                       std::vector<RayDebugSegment>* debugSegments,
+                       const glm::vec3& whiteColor,
+                       const glm::vec3& blueColor,
+                       const glm::vec3& greenColor,
+                       const glm::vec3& orangeColor) {
+        const size_t sourceCount = batch.sourcePositions.size();
+        const size_t rayCount = batch.rays.size();
+        const size_t packetCount = (rayCount + kRaysPerPacket - 1) / kRaysPerPacket;
+        RayTraceWorkerPool* pool = workerPool(baseSystem);
+        // Rebuilds a dirty brickmap here so the workers only ever read it; a
+        // rebuild also drops the propagation caches.
+        BlockSelectionSystemLogic::GetDampingBrickmap(baseSystem);
+
+        const glm::ivec3 listenerCell = glm::ivec3(glm::floor(batch.listenerPos));
+        bool fieldCached = propagation
+            && propagation->fieldValid
+            && propagation->listenerCell == listenerCell
+            && propagation->rays.size() == rayCount
+            && propagation->maxBounces == maxBounces
+            && propagation->maxDistance == maxDistance;
+        if (fieldCached) {
+            for (size_t r = 0; r < rayCount; ++r) {
+                const bool debug = batch.rays[r].debug;
+                batch.rays[r] = propagation->rays[r];
+                batch.rays[r].debug = debug;
             }
-            for (size_t s = 0; s < batch.sourcePositions.size(); ++s) {
-                if (ray.hasLastDirPerSource[s]) {
-                    batch.accum[s].dirSum += ray.lastDirPerSource[s];
-                    batch.accum[s].dirCount += 1;
+        } else {
+            runTasks(pool, packetCount, [&](size_t packet) {
+                const size_t first = packet * kRaysPerPacket;
+                const size_t last = std::min(rayCount, first + kRaysPerPacket);
+                for (size_t r = first; r < last; ++r) {
+                    RayTraceRayState& ray = batch.rays[r];
+                    ray.hits.clear();
+                    while (static_cast<int>(ray.hits.size()) < maxBounces) {
+                        glm::vec3 hitPos(0.0f);
+                        glm::vec3 hitNormal(0.0f);
+                        float hitDist = 0.0f;
+                        if (!traceToBlock(baseSystem, ray.pos, ray.dir, maxDistance, hitPos, hitNormal, hitDist)) {
+                            ray.escaped = true;
+                            break;
+                        }
+                        RayTraceHit hit;
+                        hit.from = ray.pos;
+                        hit.pos = hitPos;
+                        hit.hasBlue = hasLineOfSight(baseSystem, hitPos, batch.listenerPos, maxDistance);
+                        if (hit.hasBlue) {
+                            float blueLen = glm::length(hitPos - batch.listenerPos);
+                            ray.blueLenSum += blueLen;
+                            ray.blueLenCount += 1;
+                            ray.blueLenMax = std::max(ray.blueLenMax, blueLen);
+                            hit.blueDir = glm::normalize(hitPos - batch.listenerPos);
+                        }
+                        ray.hits.push_back(hit);
+                        ray.dir = glm::normalize(ray.dir - 2.0f * glm::dot(ray.dir, hitNormal) * hitNormal);
+                        ray.pos = hitPos + hitNormal * 0.02f;
+                    }
                 }
-            }
-        };
-
-        while (stepsThisFrame < bounceStepsPerFrame &&
-               batch.finishedRays < batch.totalRays &&
-               attempts < batch.totalRays) {
-            int rayIndex = batch.nextRayIndex;
-            batch.nextRayIndex = (batch.nextRayIndex + 1) % batch.totalRays;
-            attempts += 1;
-            RayTraceRayState& ray = batch.rays[rayIndex];
-            if (ray.finished) continue;
-
-            if (ray.bounceIndex >= maxBounces) {
-                finalizeRay(ray);
-                stepsThisFrame += 1;
-                continue;
-            }
-
-            if (!ray.initDone) {
-                for (size_t s = 0; s < batch.sourcePositions.size(); ++s) {
-                    batch.accum[s].greenChecks += 1;
-                    if (hasLineOfSight(baseSystem, ray.pos, batch.sourcePositions[s], maxDistance)) {
-                        batch.accum[s].greenHits += 1;
+            });
+            if (propagation) {
+                resetPropagation(*propagation);
+                glm::vec3 lo = batch.listenerPos;
+                glm::vec3 hi = batch.listenerPos;
+                for (const RayTraceRayState& ray : batch.rays) {
+                    for (const RayTraceHit& hit : ray.hits) {
+                        lo = glm::min(lo, hit.pos);
+                        hi = glm::max(hi, hit.pos);
+                    }
+                    if (ray.escaped) {
+                        const glm::vec3 end = ray.pos + ray.dir * maxDistance;
+                        lo = glm::min(lo, end);
+                        hi = glm::max(hi, end);
                     }
                 }
-                ray.initDone = true;
-            }
-
-            glm::vec3 hitPos(0.0f);
-            glm::vec3 hitNormal(0.0f);
-            float hitDist = 0.0f;
-            if (!traceToBlock(baseSystem, ray.pos, ray.dir, maxDistance, hitPos, hitNormal, hitDist)) {
-                ray.escaped = true;
-                finalizeRay(ray);
-                stepsThisFrame += 1;
-                continue;
+                propagation->fieldValid = true;
+                propagation->listenerCell = listenerCell;
+                propagation->rayCount = static_cast<int>(rayCount);
+                propagation->maxBounces = maxBounces;
+                propagation->maxDistance = maxDistance;
+                propagation->fieldMin = glm::ivec3(glm::floor(lo)) - glm::ivec3(1);
+                propagation->fieldMax = glm::ivec3(glm::floor(hi)) + glm::ivec3(1);
+                propagation->rays = batch.rays;
             }
+        }
 
-            if (debugSegments && ray.debug) {
-                debugSegments->push_back({ray.pos, hitPos, whiteColor});
+        batch.accum.assign(sourceCount, {});
+        std::vector<size_t> pending;
+        pending.reserve(sourceCount);
+        for (size_t s = 0; s < sourceCount; ++s) {
+            const RayTracePropagationEntry* entry = propagation
+                ? findPropagationEntry(*propagation, batch.sourcePositions[s])
+                : nullptr;
+            if (entry) {
+                batch.accum[s] = entry->accum;
+            } else {
+                pending.push_back(s);
             }
+        }
 
-            bool hasBlue = hasLineOfSight(baseSystem, hitPos, batch.listenerPos, maxDistance);
-            glm::vec3 blueDir(0.0f);
-            if (hasBlue) {
-                float blueLen = glm::length(hitPos - batch.listenerPos);
-                ray.blueLenSum += blueLen;
-                ray.blueLenCount += 1;
-                ray.blueLenMax = std::max(ray.blueLenMax, blueLen);
-                blueDir = glm::normalize(hitPos - batch.listenerPos);
-                if (debugSegments && ray.debug) {
-                    debugSegments->push_back({hitPos, batch.listenerPos, blueColor});
+        batch.packetAccum.assign(pending.size() * packetCount, {});
+        runTasks(pool, pending.size() * packetCount, [&](size_t taskIndex) {
+            const size_t s = pending[taskIndex / packetCount];
+            const size_t packet = taskIndex % packetCount;
+            const glm::vec3& sourcePos = batch.sourcePositions[s];
+            RayTraceSourceAccum& acc = batch.packetAccum[taskIndex];
+            const size_t first = packet * kRaysPerPacket;
+            const size_t last = std::min(rayCount, first + kRaysPerPacket);
+            if (maxBounces > 0) {
+                // Every ray starts at the listener, so its first check is the same
+                // line of sight; it is traced once and counted per ray.
+                const int raysHere = static_cast<int>(last - first);
+                acc.greenChecks += raysHere;
+                if (hasLineOfSight(baseSystem, batch.listenerPos, sourcePos, maxDistance)) {
+                    acc.greenHits += raysHere;
                 }
             }
-
-            for (size_t s = 0; s < batch.sourcePositions.size(); ++s) {
-                bool greenOk = hasLineOfSight(baseSystem, hitPos, batch.sourcePositions[s], maxDistance);
-                batch.accum[s].greenChecks += 1;
-                if (greenOk) {
-                    batch.accum[s].greenHits += 1;
-                    if (hasBlue) {
-                        ray.lastDirPerSource[s] = blueDir;
-                        ray.hasLastDirPerSource[s] = true;
-                    }
-                    if (debugSegments && ray.debug && s == 0) {
-                        debugSegments->push_back({hitPos, batch.sourcePositions[s], greenColor});
+            for (size_t r = first; r < last; ++r) {
+                const RayTraceRayState& ray = batch.rays[r];
+                bool hasLastDir = false;
+                glm::vec3 lastDir(0.0f);
+                for (const RayTraceHit& hit : ray.hits) {
+                    bool greenOk = hasLineOfSight(baseSystem, hit.pos, sourcePos, maxDistance);
+                    acc.greenChecks += 1;
+                    if (greenOk) {
+                        acc.greenHits += 1;
+                        if (hit.hasBlue) {
+                            lastDir = hit.blueDir;
+                            hasLastDir = true;
+                        }
                     }
-                }
 
-                float wallDistance = accumulateWallDistance(baseSystem, hitPos, batch.sourcePositions[s], maxDistance);
-                if (greenOk) {
-                    batch.accum[s].orangeVisibleChecks += 1;
-                    batch.accum[s].orangeVisibleWallSum += wallDistance;
-                } else {
-                    batch.accum[s].orangeOccludedChecks += 1;
-                    batch.accum[s].orangeOccludedWallSum += wallDistance;
+                    float wallDistance = accumulateWallDistance(baseSystem, hit.pos, sourcePos, maxDistance);
+                    if (greenOk) {
+                        acc.orangeVisibleChecks += 1;
+                        acc.orangeVisibleWallSum += wallDistance;
+                    } else {
+                        acc.orangeOccludedChecks += 1;
+                        acc.orangeOccludedWallSum += wallDistance;
+                    }
                 }
-                if (debugSegments && ray.debug && s == 0) {
-                    debugSegments->push_back({hitPos, batch.sourcePositions[s], orangeColor});
+                if (hasLastDir) {
+                    acc.dirSum += lastDir;
+                    acc.dirCount += 1;
                 }
             }
+        });
+
+        for (size_t i = 0; i < pending.size(); ++i) {
+            const size_t s = pending[i];
+            RayTraceSourceAccum& total = batch.accum[s];
+            for (size_t packet = 0; packet < packetCount; ++packet) {
+                const RayTraceSourceAccum& part = batch.packetAccum[i * packetCount + packet];
+                total.greenHits += part.greenHits;
+                total.greenChecks += part.greenChecks;
+                total.orangeVisibleWallSum += part.orangeVisibleWallSum;
+                total.orangeVisibleChecks += part.orangeVisibleChecks;
+                total.orangeOccludedWallSum += part.orangeOccludedWallSum;
+                total.orangeOccludedChecks += part.orangeOccludedChecks;
+                total.dirSum += part.dirSum;
+                total.dirCount += part.dirCount;
+            }
+            if (!propagation) continue;
+            RayTracePropagationEntry* entry = insertPropagationEntry(*propagation, batch.sourcePositions[s]);
+            if (!entry) continue;
+            const glm::ivec3 sourceCell = glm::ivec3(glm::floor(batch.sourcePositions[s]));
+            *entry = RayTracePropagationEntry{};
+            entry->accum = total;
+            entry->boundsMin = glm::min(propagation->fieldMin, sourceCell - glm::ivec3(1));
+            entry->boundsMax = glm::max(propagation->fieldMax, sourceCell + glm::ivec3(1));
+        }
 
-            ray.dir = glm::normalize(ray.dir - 2.0f * glm::dot(ray.dir, hitNormal) * hitNormal);
-            ray.pos = hitPos + hitNormal * 0.02f;
-            ray.bounceIndex += 1;
-            stepsThisFrame += 1;
+        for (const RayTraceRayState& ray : batch.rays) {
+            batch.finishedRays += 1;
+            if (ray.escaped) {
+                batch.escapeCount += 1;
+            } else if (ray.blueLenCount > 0) {
+                batch.blueLenSum += ray.blueLenSum;
+                batch.blueLenCount += ray.blueLenCount;
+                batch.blueLenMax = std::max(batch.blueLenMax, ray.blueLenMax);
+            }
+            if (!debugSegments || !ray.debug) continue;
+            for (const RayTraceHit& hit : ray.hits) {
+                debugSegments->push_back({hit.from, hit.pos, whiteColor});
+                if (hit.hasBlue) debugSegments->push_back({hit.pos, batch.listenerPos, blueColor});
+                if (sourceCount == 0) continue;
+                if (hasLineOfSight(baseSystem, hit.pos, batch.sourcePositions[0], maxDistance)) {
+                    debugSegments->push_back({hit.pos, batch.sourcePositions[0], greenColor});
+                }
+                debugSegments->push_back({hit.pos, batch.sourcePositions[0], orangeColor});
+            }
         }
     }
 
+    void InvalidatePropagationCell(BaseSystem& baseSystem, const glm::ivec3& cell) {
+        if (!baseSystem.rayTracedAudio) return;
+        invalidatePropagationCell(baseSystem.rayTracedAudio->propagation, cell);
+        invalidatePropagationCell(baseSystem.rayTracedAudio->micPropagation, cell);
+    }
+
+    void InvalidatePropagation(BaseSystem& baseSystem) {
+        if (!baseSystem.rayTracedAudio) return;
+        resetPropagation(baseSystem.rayTracedAudio->propagation);
+        resetPropagation(baseSystem.rayTracedAudio->micPropagation);
+    }
+
     void InvalidateSourceCache(BaseSystem& baseSystem) {
         if (!baseSystem.rayTracedAudio) return;
         RayTracedAudioContext& rtAudio = *baseSystem.rayTracedAudio;
@@ -666,57 +924,46 @@ namespace RayTracedAudioSystemLogic {
         }
 
         if (batch.active) {
-            const int bounceStepsPerFrame = 6;
             std::vector<RayDebugSegment>* debugSegments =
                 batch.debugActive ? &rtAudio.debugSegments : nullptr;
-            StepRayBatch(baseSystem,
-                         batch,
-                         maxDistance,
-                         maxBounces,
-                         bounceStepsPerFrame,
-                         debugSegments,
-                         whiteColor,
-                         blueColor,
-                         greenColor,
-                         orangeColor);
-
-            auto emitStates = [&](int finishedRaysCount, bool finalUpdate) {
-                glm::vec3 earRight(1.0f, 0.0f, 0.0f);
-                glm::vec3 earForward(0.0f, 0.0f, -1.0f);
-                glm::vec3 earUp(0.0f, 1.0f, 0.0f);
-                glm::vec3 forward;
-                forward.x = std::cos(glm::radians(player.cameraYaw)) * std::cos(glm::radians(player.cameraPitch));
-                forward.y = std::sin(glm::radians(player.cameraPitch));
-                forward.z = std::sin(glm::radians(player.cameraYaw)) * std::cos(glm::radians(player.cameraPitch));
-                forward = glm::normalize(forward);
-                earRight = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
-                if (glm::length(earRight) < 1e-4f) earRight = glm::vec3(1.0f, 0.0f, 0.0f);
-                earForward = forward;
-                earUp = glm::normalize(glm::cross(earRight, earForward));
-                if (glm::length(earUp) < 1e-4f) earUp = glm::vec3(0.0f, 1.0f, 0.0f);
-
-                EmitRayStates(baseSystem,
-                              batch,
-                              maxDistance,
-                              earForward,
-                              earRight,
-                              earUp,
-                              rtAudio.sourceStates,
-                              rtAudio.sourceStatesVersion,
-                              finishedRaysCount,
-                              finalUpdate);
-            };
-
-            if (batch.finishedRays > 0 && batch.finishedRays != batch.lastPublishedFinishedRays) {
-                emitStates(batch.finishedRays, false);
-                batch.lastPublishedFinishedRays = batch.finishedRays;
-            }
-
-            if (batch.finishedRays >= batch.totalRays) {
-                emitStates(batch.finishedRays, true);
-                batch.active = false;
-                rtAudio.lastBatchCompleteTime = now;
-            }
+            TraceRayBatch(baseSystem,
+                          batch,
+                          &rtAudio.propagation,
+                          maxDistance,
+                          maxBounces,
+                          debugSegments,
+                          whiteColor,
+                          blueColor,
+                          greenColor,
+                          orangeColor);
+
+            glm::vec3 earRight(1.0f, 0.0f, 0.0f);
+            glm::vec3 earForward(0.0f, 0.0f, -1.0f);
+            glm::vec3 earUp(0.0f, 1.0f, 0.0f);
+            glm::vec3 forward;
+            forward.x = std::cos(glm::radians(player.cameraYaw)) * std::cos(glm::radians(player.cameraPitch));
+            forward.y = std::sin(glm::radians(player.cameraPitch));
+            forward.z = std::sin(glm::radians(player.cameraYaw)) * std::cos(glm::radians(player.cameraPitch));
+            forward = glm::normalize(forward);
+            earRight = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+            if (glm::length(earRight) < 1e-4f) earRight = glm::vec3(1.0f, 0.0f, 0.0f);
+            earForward = forward;
+            earUp = glm::normalize(glm::cross(earRight, earForward));
+            if (glm::length(earUp) < 1e-4f) earUp = glm::vec3(0.0f, 1.0f, 0.0f);
+
+            EmitRayStates(baseSystem,
+                          batch,
+                          &rtAudio.propagation,
+                          maxDistance,
+                          earForward,
+                          earRight,
+                          earUp,
+                          rtAudio.sourceStates,
+                          rtAudio.sourceStatesVersion,
+                          batch.finishedRays,
+                          true);
+            batch.active = false;
+            rtAudio.lastBatchCompleteTime = now;
         }
 
     }
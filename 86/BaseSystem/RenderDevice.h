@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// The GL calls the render systems make, through one concrete Device. Systems
+// keep passing GL enum values (targets, capabilities, modes) straight
+// through as integers; only the calls go through the device. The backend is
+// picked by which file defines the Device calls in the build, not by
+// virtual dispatch, the same way the audio path picks JACK or the offline
+// driver without a class hierarchy: the game includes
+// Host/HostRenderDevice.cpp (GL 3.3), the Tools include
+// BaseSystem/RenderDeviceRecording.h, which keeps every command, buffer size
+// and draw so the CPU side of a render system (visibility, batching, buffer
+// sizing) can be driven and checked with no GPU. Nothing here touches GL.
+namespace RenderDevice {
+
+    using Fence = uintptr_t;  // 0 is never a live fence
+
+    // Counted by the device itself, so every backend reports the same.
+    struct FrameStats {
+        uint32_t drawCalls = 0;
+        uint64_t vertices = 0;     // vertices per instance times instances
+        uint64_t instances = 0;
+        uint32_t uploads = 0;      // bufferData calls with data, bufferSubData calls, mapped writes
+        size_t uploadBytes = 0;
+        uint32_t programBinds = 0;
+        uint32_t uniformSets = 0;
+    };
+
+    // Per-frame ceilings; a zero field is not checked.
+    struct Budget {
+        uint32_t maxDrawCalls = 0;
+        size_t maxUploadBytes = 0;
+    };
+
+    inline bool overDrawBudget(const FrameStats& stats, const Budget& budget) {
+        return budget.maxDrawCalls > 0 && stats.drawCalls > budget.maxDrawCalls;
+    }
+
+    inline bool overUploadBudget(const FrameStats& stats, const Budget& budget) {
+        return budget.maxUploadBytes > 0 && stats.uploadBytes > budget.maxUploadBytes;
+    }
+
+    // Whatever per-device state the built-in backend keeps; defined by the
+    // backend file along with the Device calls below.
+    struct Backend;
+
+    class Device {
+    public:
+        Device();
+        ~Device();
+        Device(const Device&) = delete;
+        Device& operator=(const Device&) = delete;
+
+        Backend& backend() { return *state; }
+        const Backend& backend() const { return *state; }
+
+        // Objects. Handles are the backend's names; 0 means none.
+        uint32_t createVertexArray();
+        uint32_t createBuffer();
+        void deleteVertexArray(uint32_t vao);
+        void deleteBuffer(uint32_t buffer);
+        // Compiles and links; logs and still returns the program on failure,
+        // as glLinkProgram would leave it.
+        uint32_t createProgram(const char* vertexSource, const char* fragmentSource);
+
+        // Bindings and fixed-function state.
+        void bindVertexArray(uint32_t vao);
+        void bindBuffer(uint32_t target, uint32_t buffer);
+        void bindFramebuffer(uint32_t target, uint32_t framebuffer);
+        void activeTexture(uint32_t unit);
+        void bindTexture(uint32_t target, uint32_t texture);
+        void enable(uint32_t capability);
+        void disable(uint32_t capability);
+        void depthMask(bool write);
+        void blendFunc(uint32_t source, uint32_t destination);
+        void blendColor(float r, float g, float b, float a);
+        void frontFace(uint32_t mode);
+        void cullFace(uint32_t mode);
+        void lineWidth(float width);
+        void polygonMode(uint32_t face, uint32_t mode);
+        void viewport(int32_t x, int32_t y, int32_t width, int32_t height);
+        void getViewport(int32_t out[4]);
+        void scissor(int32_t x, int32_t y, int32_t width, int32_t height);
+        void clearColor(float r, float g, float b, float a);
+        void clear(uint32_t mask);
+        int32_t getInteger(uint32_t name);
+
+        // Vertex layout of the bound vertex array, reading the bound
+        // GL_ARRAY_BUFFER at byte `offset`.
+        void vertexAttribPointer(uint32_t index, int32_t size, uint32_t type, bool normalized,
+                                 int32_t stride, size_t offset);
+        void vertexAttribIPointer(uint32_t index, int32_t size, uint32_t type, int32_t stride, size_t offset);
+        void enableVertexAttribArray(uint32_t index);
+        void vertexAttribDivisor(uint32_t index, uint32_t divisor);
+
+        // Buffer storage. mapBufferRange returns null on failure.
+        bool hasBufferStorage() const;
+        void bufferStorage(uint32_t target, size_t bytes, const void* data, uint32_t flags);
+        void* mapBufferRange(uint32_t target, size_t offset, size_t bytes, uint32_t access);
+        bool unmapBuffer(uint32_t target);
+
+        // Fences. waitFence is true once the fence has signaled (or the wait
+        // failed), false if `timeoutNs` ran out first.
+        Fence fenceSync();
+        bool waitFence(Fence fence, uint64_t timeoutNs);
+        void deleteFence(Fence fence);
+
+        void bufferData(uint32_t target, size_t bytes, const void* data, uint32_t usage) {
+            if (data) {
+                frame.uploads += 1;
+                frame.uploadBytes += bytes;
+            }
+            doBufferData(target, bytes, data, usage);
+        }
+
+        // Rewrites bytes [offset, offset + bytes) of the buffer bound to
+        // `target`, which must already be at least that large.
+        void bufferSubData(uint32_t target, size_t offset, size_t bytes, const void* data) {
+            if (bytes == 0) return;
+            frame.uploads += 1;
+            frame.uploadBytes += bytes;
+            doBufferSubData(target, offset, bytes, data);
+        }
+
+        // For writes through a mapped pointer, which the device cannot see.
+        void wroteMapped(size_t bytes) {
+            frame.uploads += 1;
+            frame.uploadBytes += bytes;
+        }
+
+        void useProgram(uint32_t program) {
+            frame.programBinds += 1;
+            doUseProgram(program);
+        }
+
+        // Uniforms by name on `program`, which must be in use.
+        void uniformMat4(uint32_t program, const std::string& name, const float* values) {
+            frame.uniformSets += 1;
+            doUniform(program, name, values, 16, false);
+        }
+        void uniformVec3(uint32_t program, const std::string& name, const float* values) {
+            frame.uniformSets += 1;
+            doUniform(program, name, values, 3, false);
+        }
+        void uniformVec2(uint32_t program, const std::string& name, const float* values) {
+            frame.uniformSets += 1;
+            doUniform(program, name, values, 2, false);
+        }
+        void uniformFloat(uint32_t program, const std::string& name, float value) {
+            frame.uniformSets += 1;
+            doUniform(program, name, &value, 1, false);
+        }
+        void uniformInt(uint32_t program, const std::string& name, int value) {
+            frame.uniformSets += 1;
+            const float asFloat = static_cast<float>(value);
+            doUniform(program, name, &asFloat, 1, true);
+        }
+        // `count` vec4s from `values` into the uniform array `name`.
+        void uniformVec4Array(uint32_t program, const std::string& name, const float* values, int count) {
+            if (count <= 0) return;
+            frame.uniformSets += 1;
+            doUniformVec4Array(program, name, values, count);
+        }
+
+        void drawArrays(uint32_t mode, int32_t first, int32_t count) {
+            if (count <= 0) return;
+            frame.drawCalls += 1;
+            frame.instances += 1;
+            frame.vertices += static_cast<uint64_t>(count);
+            doDrawArrays(mode, first, count, 1, false);
+        }
+
+        void drawArraysInstanced(uint32_t mode, int32_t first, int32_t count, int32_t instances) {
+            if (count <= 0 || instances <= 0) return;
+            frame.drawCalls += 1;
+            frame.instances += static_cast<uint64_t>(instances);
+            frame.vertices += static_cast<uint64_t>(count) * static_cast<uint64_t>(instances);
+            doDrawArrays(mode, first, count, instances, true);
+        }
+
+        // One draw call over `drawCount` vertex ranges, like glMultiDrawArrays.
+        void multiDrawArrays(uint32_t mode, const int32_t* firsts, const int32_t* counts, int32_t drawCount) {
+            if (drawCount <= 0) return;
+            uint64_t total = 0;
+            for (int32_t i = 0; i < drawCount; ++i) {
+                if (counts[i] > 0) total += static_cast<uint64_t>(counts[i]);
+            }
+            if (total == 0) return;
+            frame.drawCalls += 1;
+            frame.instances += 1;
+            frame.vertices += total;
+            doMultiDrawArrays(mode, firsts, counts, drawCount);
+        }
+
+        // Closes the frame: frameStats() starts over and lastFrameStats()
+        // holds what it counted.
+        void endFrame() {
+            last = frame;
+            frame = FrameStats{};
+        }
+        const FrameStats& frameStats() const { return frame; }
+        const FrameStats& lastFrameStats() const { return last; }
+
+    private:
+        void doBufferData(uint32_t target, size_t bytes, const void* data, uint32_t usage);
+        void doBufferSubData(uint32_t target, size_t offset, size_t bytes, const void* data);
+        void doUseProgram(uint32_t program);
+        void doUniform(uint32_t program, const std::string& name, const float* values, int count, bool integer);
+        void doUniformVec4Array(uint32_t program, const std::string& name, const float* values, int count);
+        void doDrawArrays(uint32_t mode, int32_t first, int32_t count, int32_t instances, bool instanced);
+        void doMultiDrawArrays(uint32_t mode, const int32_t* firsts, const int32_t* counts, int32_t drawCount);
+
+        std::unique_ptr<Backend> state;
+        FrameStats frame;
+        FrameStats last;
+    };
+
+    namespace detail {
+        inline Device*& currentSlot() {
+            static Device* device = nullptr;
+            return device;
+        }
+    }
+
+    // The device render systems draw through, like GL's current context.
+    // The host sets it right after the GL loader comes up.
+    inline Device& current() { return *detail::currentSlot(); }
+    inline bool hasCurrent() { return detail::currentSlot() != nullptr; }
+    inline void setCurrent(Device* device) { detail::currentSlot() = device; }
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+
+#include "BaseSystem/RenderDevice.h"
+
+// The recording backend: the Device keeps every call as a Command instead of
+// issuing it. Handles are handed out from 1 per kind; buffers remember the
+// size last given to them, and mapped ranges are backed by host memory so
+// writers can fill them as they would a GL mapping. Include this instead of
+// Host/HostRenderDevice.cpp where there is no GPU.
+namespace RenderDevice {
+
+    struct Backend {
+        enum class Op : uint8_t {
+            CreateVertexArray, CreateBuffer, DeleteVertexArray, DeleteBuffer, CreateProgram,
+            BindVertexArray, BindBuffer, BindFramebuffer, ActiveTexture, BindTexture,
+            Enable, Disable, DepthMask, BlendFunc, BlendColor, FrontFace, CullFace, LineWidth, PolygonMode,
+            Viewport, Scissor, ClearColor, Clear, GetInteger,
+            VertexAttribPointer, VertexAttribIPointer, EnableVertexAttribArray, VertexAttribDivisor,
+            BufferData, BufferSubData, BufferStorage, MapBufferRange, UnmapBuffer,
+            FenceSync, WaitFence, DeleteFence,
+            UseProgram, Uniform, UniformArray, DrawArrays, DrawArraysInstanced, MultiDrawArrays,
+        };
+
+        // a..d hold the call's integer arguments in order (object handles
+        // resolved, so BufferData's `a` is the buffer, not the target);
+        // `bytes` the size of uploads and mappings; `values` float arguments
+        // (MultiDrawArrays keeps its first, count pairs there).
+        struct Command {
+            Op op;
+            uint32_t a = 0;
+            uint32_t b = 0;
+            uint32_t c = 0;
+            uint32_t d = 0;
+            size_t bytes = 0;
+            std::string name;
+            std::vector<float> values;
+        };
+
+        std::vector<Command> commands;
+        std::unordered_map<uint32_t, int32_t> integers;  // answers for getInteger
+        bool bufferStorageAvailable = true;
+
+        // Size in bytes of `buffer` as last specified; 0 if unknown.
+        size_t bufferBytes(uint32_t buffer) const {
+            auto it = buffers.find(buffer);
+            return it != buffers.end() ? it->second.size() : 0;
+        }
+        // Host copy of a buffer's contents (uploads and mapped writes).
+        const std::vector<uint8_t>* bufferContents(uint32_t buffer) const {
+            auto it = buffers.find(buffer);
+            return it != buffers.end() ? &it->second : nullptr;
+        }
+        size_t count(Op op) const {
+            return static_cast<size_t>(std::count_if(commands.begin(), commands.end(),
+                                                     [op](const Command& command) { return command.op == op; }));
+        }
+
+        Command& push(Op op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint32_t d = 0) {
+            commands.push_back(Command{op, a, b, c, d, 0, {}, {}});
+            return commands.back();
+        }
+        uint32_t record(Op op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint32_t d = 0) {
+            push(op, a, b, c, d);
+            return a;
+        }
+        void recordValues(Op op, std::initializer_list<float> values) { push(op).values.assign(values); }
+
+        uint32_t bound(uint32_t target) const {
+            auto it = boundBuffers.find(target);
+            return it != boundBuffers.end() ? it->second : 0;
+        }
+        void resizeBuffer(uint32_t buffer, size_t bytes, const void* data) {
+            if (buffer == 0) return;
+            std::vector<uint8_t>& contents = buffers[buffer];
+            contents.assign(bytes, 0);
+            if (data && bytes > 0) {
+                const auto* source = static_cast<const uint8_t*>(data);
+                std::copy(source, source + bytes, contents.begin());
+            }
+        }
+
+        uint32_t lastVertexArray = 0;
+        uint32_t lastBuffer = 0;
+        uint32_t lastProgram = 0;
+        Fence lastFence = 0;
+        std::unordered_map<uint32_t, uint32_t> boundBuffers;  // target -> buffer
+        std::unordered_map<uint32_t, std::vector<uint8_t>> buffers;
+        int32_t currentViewport[4] = {0, 0, 0, 0};
+    };
+
+    using Op = Backend::Op;
+
+    inline Device::Device() : state(std::make_unique<Backend>()) {}
+    inline Device::~Device() = default;
+
+    inline uint32_t Device::createVertexArray() { return state->record(Op::CreateVertexArray, ++state->lastVertexArray); }
+    inline uint32_t Device::createBuffer() {
+        const uint32_t buffer = ++state->lastBuffer;
+        state->buffers[buffer];
+        return state->record(Op::CreateBuffer, buffer);
+    }
+    inline void Device::deleteVertexArray(uint32_t vao) { state->record(Op::DeleteVertexArray, vao); }
+    inline void Device::deleteBuffer(uint32_t buffer) {
+        state->buffers.erase(buffer);
+        for (auto& [target, bound] : state->boundBuffers) {
+            if (bound == buffer) bound = 0;
+        }
+        state->record(Op::DeleteBuffer, buffer);
+    }
+    inline uint32_t Device::createProgram(const char*, const char*) { return state->record(Op::CreateProgram, ++state->lastProgram); }
+
+    inline void Device::bindVertexArray(uint32_t vao) { state->record(Op::BindVertexArray, vao); }
+    inline void Device::bindBuffer(uint32_t target, uint32_t buffer) {
+        state->boundBuffers[target] = buffer;
+        state->record(Op::BindBuffer, buffer, target);
+    }
+    inline void Device::bindFramebuffer(uint32_t target, uint32_t framebuffer) { state->record(Op::BindFramebuffer, framebuffer, target); }
+    inline void Device::activeTexture(uint32_t unit) { state->record(Op::ActiveTexture, unit); }
+    inline void Device::bindTexture(uint32_t target, uint32_t texture) { state->record(Op::BindTexture, texture, target); }
+    inline void Device::enable(uint32_t capability) { state->record(Op::Enable, capability); }
+    inline void Device::disable(uint32_t capability) { state->record(Op::Disable, capability); }
+    inline void Device::depthMask(bool write) { state->record(Op::DepthMask, write ? 1u : 0u); }
+    inline void Device::blendFunc(uint32_t source, uint32_t destination) { state->record(Op::BlendFunc, source, destination); }
+    inline void Device::blendColor(float r, float g, float b, float a) { state->recordValues(Op::BlendColor, {r, g, b, a}); }
+    inline void Device::frontFace(uint32_t mode) { state->record(Op::FrontFace, mode); }
+    inline void Device::cullFace(uint32_t mode) { state->record(Op::CullFace, mode); }
+    inline void Device::lineWidth(float width) { state->recordValues(Op::LineWidth, {width}); }
+    inline void Device::polygonMode(uint32_t face, uint32_t mode) { state->record(Op::PolygonMode, face, mode); }
+    inline void Device::viewport(int32_t x, int32_t y, int32_t width, int32_t height) {
+        state->currentViewport[0] = x;
+        state->currentViewport[1] = y;
+        state->currentViewport[2] = width;
+        state->currentViewport[3] = height;
+        state->record(Op::Viewport, static_cast<uint32_t>(x), static_cast<uint32_t>(y),
+                      static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    }
+    inline void Device::getViewport(int32_t out[4]) { std::copy(state->currentViewport, state->currentViewport + 4, out); }
+    inline void Device::scissor(int32_t x, int32_t y, int32_t width, int32_t height) {
+        state->record(Op::Scissor, static_cast<uint32_t>(x), static_cast<uint32_t>(y),
+                      static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    }
+    inline void Device::clearColor(float r, float g, float b, float a) { state->recordValues(Op::ClearColor, {r, g, b, a}); }
+    inline void Device::clear(uint32_t mask) { state->record(Op::Clear, mask); }
+    inline int32_t Device::getInteger(uint32_t name) {
+        state->record(Op::GetInteger, name);
+        auto it = state->integers.find(name);
+        return it != state->integers.end() ? it->second : 0;
+    }
+
+    inline void Device::vertexAttribPointer(uint32_t index, int32_t size, uint32_t type, bool normalized,
+                                            int32_t stride, size_t offset) {
+        Backend::Command& command = state->push(Op::VertexAttribPointer, index, static_cast<uint32_t>(size), type,
+                                                static_cast<uint32_t>(stride));
+        command.bytes = offset;
+        command.values = {normalized ? 1.0f : 0.0f};
+    }
+    inline void Device::vertexAttribIPointer(uint32_t index, int32_t size, uint32_t type, int32_t stride, size_t offset) {
+        state->push(Op::VertexAttribIPointer, index, static_cast<uint32_t>(size), type,
+                    static_cast<uint32_t>(stride)).bytes = offset;
+    }
+    inline void Device::enableVertexAttribArray(uint32_t index) { state->record(Op::EnableVertexAttribArray, index); }
+    inline void Device::vertexAttribDivisor(uint32_t index, uint32_t divisor) { state->record(Op::VertexAttribDivisor, index, divisor); }
+
+    inline bool Device::hasBufferStorage() const { return state->bufferStorageAvailable; }
+    inline void Device::bufferStorage(uint32_t target, size_t bytes, const void* data, uint32_t flags) {
+        const uint32_t buffer = state->bound(target);
+        state->resizeBuffer(buffer, bytes, data);
+        state->push(Op::BufferStorage, buffer, target, flags).bytes = bytes;
+    }
+    inline void* Device::mapBufferRange(uint32_t target, size_t offset, size_t bytes, uint32_t access) {
+        const uint32_t buffer = state->bound(target);
+        state->push(Op::MapBufferRange, buffer, target, access, static_cast<uint32_t>(offset)).bytes = bytes;
+        auto it = state->buffers.find(buffer);
+        if (it == state->buffers.end() || offset + bytes > it->second.size()) return nullptr;
+        return it->second.data() + offset;
+    }
+    inline bool Device::unmapBuffer(uint32_t target) {
+        state->record(Op::UnmapBuffer, state->bound(target), target);
+        return true;
+    }
+
+    inline Fence Device::fenceSync() {
+        state->record(Op::FenceSync, static_cast<uint32_t>(++state->lastFence));
+        return state->lastFence;
+    }
+    inline bool Device::waitFence(Fence fence, uint64_t) {
+        state->record(Op::WaitFence, static_cast<uint32_t>(fence));
+        return true;
+    }
+    inline void Device::deleteFence(Fence fence) { state->record(Op::DeleteFence, static_cast<uint32_t>(fence)); }
+
+    inline void Device::doBufferData(uint32_t target, size_t bytes, const void* data, uint32_t usage) {
+        const uint32_t buffer = state->bound(target);
+        state->resizeBuffer(buffer, bytes, data);
+        state->push(Op::BufferData, buffer, target, usage).bytes = bytes;
+    }
+    inline void Device::doBufferSubData(uint32_t target, size_t offset, size_t bytes, const void* data) {
+        const uint32_t buffer = state->bound(target);
+        auto it = state->buffers.find(buffer);
+        if (it != state->buffers.end() && data && offset + bytes <= it->second.size()) {
+            const auto* source = static_cast<const uint8_t*>(data);
+            std::copy(source, source + bytes, it->second.begin() + static_cast<std::ptrdiff_t>(offset));
+        }
+        state->push(Op::BufferSubData, buffer, target, 0, static_cast<uint32_t>(offset)).bytes = bytes;
+    }
+    inline void Device::doUseProgram(uint32_t program) { state->record(Op::UseProgram, program); }
+    inline void Device::doUniform(uint32_t program, const std::string& name, const float* values, int count, bool integer) {
+        Backend::Command& command = state->push(Op::Uniform, program, static_cast<uint32_t>(count), integer ? 1u : 0u);
+        command.name = name;
+        command.values.assign(values, values + count);
+    }
+    inline void Device::doUniformVec4Array(uint32_t program, const std::string& name, const float* values, int count) {
+        Backend::Command& command = state->push(Op::UniformArray, program, static_cast<uint32_t>(count));
+        command.name = name;
+        command.values.assign(values, values + static_cast<size_t>(count) * 4);
+    }
+    inline void Device::doDrawArrays(uint32_t mode, int32_t first, int32_t count, int32_t instances, bool instanced) {
+        state->push(instanced ? Op::DrawArraysInstanced : Op::DrawArrays, mode, static_cast<uint32_t>(first),
+                    static_cast<uint32_t>(count), static_cast<uint32_t>(instances));
+    }
+    inline void Device::doMultiDrawArrays(uint32_t mode, const int32_t* firsts, const int32_t* counts, int32_t drawCount) {
+        Backend::Command& command = state->push(Op::MultiDrawArrays, mode, static_cast<uint32_t>(drawCount));
+        command.values.reserve(static_cast<size_t>(drawCount) * 2);
+        for (int32_t i = 0; i < drawCount; ++i) {
+            command.values.push_back(static_cast<float>(firsts[i]));
+            command.values.push_back(static_cast<float>(counts[i]));
+        }
+    }
+}
@@ -475,6 +475,10 @@ namespace RenderInitSystemLogic {
             world.shaders["COLOR_EMOTION_FRAGMENT_SHADER"].c_str()
         );
         renderer.crosshairShader = std::make_unique<Shader>(world.shaders["CROSSHAIR_VERTEX_SHADER"].c_str(), world.shaders["CROSSHAIR_FRAGMENT_SHADER"].c_str());
+        // The charge meter and crosshair stay off the UI batch: both are
+        // static buffers uploaded once here, the crosshair draws GL_LINES and
+        // the meter samples the block atlas through per-draw uniforms, neither
+        // of which the batch's two triangle programs can express.
         float hudVertices[] = {
             0.035f, -0.05f, 0.0f, 0.0f,
             0.08f,  -0.05f, 1.0f, 0.0f,
@@ -572,12 +576,6 @@ namespace RenderInitSystemLogic {
         if (renderer.colorEmotionVBO) glDeleteBuffers(1, &renderer.colorEmotionVBO);
         if (renderer.crosshairVAO) glDeleteVertexArrays(1, &renderer.crosshairVAO);
         if (renderer.crosshairVBO) glDeleteBuffers(1, &renderer.crosshairVBO);
-        if (renderer.uiVAO) glDeleteVertexArrays(1, &renderer.uiVAO);
-        if (renderer.uiVBO) glDeleteBuffers(1, &renderer.uiVBO);
-        if (renderer.uiButtonVAO) glDeleteVertexArrays(1, &renderer.uiButtonVAO);
-        if (renderer.uiButtonVBO) glDeleteBuffers(1, &renderer.uiButtonVBO);
-        if (renderer.fontVAO) glDeleteVertexArrays(1, &renderer.fontVAO);
-        if (renderer.fontVBO) glDeleteBuffers(1, &renderer.fontVBO);
         if (renderer.audioRayVAO) glDeleteVertexArrays(1, &renderer.audioRayVAO);
         if (renderer.audioRayVBO) glDeleteBuffers(1, &renderer.audioRayVBO);
         if (renderer.leyLineDebugVAO) glDeleteVertexArrays(1, &renderer.leyLineDebugVAO);
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "json.hpp"
+
+// Binary twin of the salamander_session JSON ("SLMS"). The session root is
+// split into chunks -- HEAD (everything but the pool and the tracks), POOL
+// (the audio pool) and one ATRK / MTRK / AUTO chunk per audio, MIDI and
+// automation track -- each stored as MessagePack under a hash of its
+// payload, so a reader verifies every chunk and a writer can tell which
+// tracks changed since it last wrote without comparing payloads. Joining
+// the chunks gives back the JSON root the loader already understands.
+//
+// File layout (little-endian):
+//   u32 magic, u32 version, u32 chunkCount,
+//   { u32 id, u64 size, u64 hash, bytes[size] } * chunkCount,
+//   u32 endMagic, u64 hash of the chunk ids and hashes
+// A file cut short anywhere fails the end check.
+namespace SessionBinary {
+
+    constexpr uint32_t kMagic = 0x534D4C53u;    // "SLMS"
+    constexpr uint32_t kEndMagic = 0x444E4553u; // "SEND"
+    constexpr uint32_t kVersion = 1;
+    constexpr uint64_t kHashSeed = 0x9e3779b97f4a7c15ull;
+
+    constexpr uint32_t chunkId(const char (&tag)[5]) {
+        return static_cast<uint32_t>(static_cast<uint8_t>(tag[0]))
+            | (static_cast<uint32_t>(static_cast<uint8_t>(tag[1])) << 8)
+            | (static_cast<uint32_t>(static_cast<uint8_t>(tag[2])) << 16)
+            | (static_cast<uint32_t>(static_cast<uint8_t>(tag[3])) << 24);
+    }
+    constexpr uint32_t kHead = chunkId("HEAD");
+    constexpr uint32_t kPool = chunkId("POOL");
+    constexpr uint32_t kAudioTrack = chunkId("ATRK");
+    constexpr uint32_t kMidiTrack = chunkId("MTRK");
+    constexpr uint32_t kAutomationTrack = chunkId("AUTO");
+
+    // 64-bit content hash, eight bytes per step. Not cryptographic; it names
+    // asset files and flags changed chunks.
+    class Hasher {
+    public:
+        explicit Hasher(uint64_t seed = kHashSeed) : h(seed) {}
+
+        Hasher& add(const void* data, size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                uint64_t word = 0;
+                std::memcpy(&word, bytes + i, 8);
+                mix(word);
+            }
+            uint64_t tail = 0;
+            if (size > i) std::memcpy(&tail, bytes + i, size - i);
+            mix(tail ^ (static_cast<uint64_t>(size) << 56));
+            return *this;
+        }
+        Hasher& addU64(uint64_t value) {
+            mix(value);
+            return *this;
+        }
+        Hasher& addString(const std::string& value) { return add(value.data(), value.size()); }
+
+        uint64_t value() const {
+            uint64_t x = h;
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdull;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ull;
+            x ^= x >> 33;
+            return x;
+        }
+
+    private:
+        void mix(uint64_t word) {
+            word *= 0x87c37b91114253d5ull;
+            word = (word << 31) | (word >> 33);
+            word *= 0x4cf5ad432745937full;
+            h ^= word;
+            h = ((h << 27) | (h >> 37)) * 5 + 0x52dce729;
+        }
+
+        uint64_t h;
+    };
+
+    inline uint64_t hashBytes(const void* data, size_t size) {
+        return Hasher().add(data, size).value();
+    }
+
+    struct Chunk {
+        uint32_t id = 0;
+        uint64_t hash = 0;
+        std::vector<uint8_t> payload;
+    };
+
+    inline Chunk makeChunk(uint32_t id, const nlohmann::json& value) {
+        Chunk chunk;
+        chunk.id = id;
+        chunk.payload = nlohmann::json::to_msgpack(value);
+        chunk.hash = hashBytes(chunk.payload.data(), chunk.payload.size());
+        return chunk;
+    }
+
+    // Hash of every chunk's id and payload hash, in order; equal for two
+    // chunk lists exactly when they would write the same file.
+    inline uint64_t combinedHash(const std::vector<Chunk>& chunks) {
+        Hasher hasher;
+        for (const Chunk& chunk : chunks) {
+            hasher.addU64(chunk.id).addU64(chunk.hash);
+        }
+        return hasher.value();
+    }
+
+    namespace detail {
+        struct TrackList {
+            const char* key;
+            uint32_t id;
+        };
+        constexpr TrackList kTrackLists[] = {
+            {"audio_tracks", kAudioTrack},
+            {"midi_tracks", kMidiTrack},
+            {"automation_tracks", kAutomationTrack},
+        };
+
+        inline void putU32(std::vector<uint8_t>& out, uint32_t v) {
+            for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+        }
+
+        inline void putU64(std::vector<uint8_t>& out, uint64_t v) {
+            for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+        }
+
+        struct Reader {
+            const uint8_t* data = nullptr;
+            size_t size = 0;
+            size_t pos = 0;
+            bool ok = true;
+
+            uint32_t u32() {
+                if (size - pos < 4) { ok = false; return 0; }
+                uint32_t v = 0;
+                for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(data[pos + i]) << (i * 8);
+                pos += 4;
+                return v;
+            }
+
+            uint64_t u64() {
+                if (size - pos < 8) { ok = false; return 0; }
+                uint64_t v = 0;
+                for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(data[pos + i]) << (i * 8);
+                pos += 8;
+                return v;
+            }
+        };
+    }
+
+    // Splits a session root into HEAD, POOL and per-track chunks.
+    inline std::vector<Chunk> split(const nlohmann::json& root) {
+        std::vector<Chunk> chunks;
+        nlohmann::json head = root;
+        head.erase("audio_pool");
+        for (const auto& list : detail::kTrackLists) head.erase(list.key);
+        chunks.push_back(makeChunk(kHead, head));
+        auto pool = root.find("audio_pool");
+        chunks.push_back(makeChunk(kPool, pool != root.end() ? *pool : nlohmann::json::array()));
+        for (const auto& list : detail::kTrackLists) {
+            auto tracks = root.find(list.key);
+            if (tracks == root.end() || !tracks->is_array()) continue;
+            for (const auto& track : *tracks) {
+                chunks.push_back(makeChunk(list.id, track));
+            }
+        }
+        return chunks;
+    }
+
+    // Inverse of split(). Unknown chunk ids are skipped so later versions can
+    // add chunks older readers ignore.
+    inline bool join(const std::vector<Chunk>& chunks, nlohmann::json& root, std::string& error) {
+        root = nlohmann::json::object();
+        bool haveHead = false;
+        nlohmann::json pool = nlohmann::json::array();
+        nlohmann::json tracks[std::size(detail::kTrackLists)];
+        for (auto& list : tracks) list = nlohmann::json::array();
+        for (const Chunk& chunk : chunks) {
+            nlohmann::json value = nlohmann::json::from_msgpack(chunk.payload, true, false);
+            if (value.is_discarded()) { error = "bad chunk payload"; return false; }
+            if (chunk.id == kHead) {
+                if (!value.is_object()) { error = "bad HEAD chunk"; return false; }
+                root = std::move(value);
+                haveHead = true;
+            } else if (chunk.id == kPool) {
+                pool = std::move(value);
+            } else {
+                for (size_t i = 0; i < std::size(detail::kTrackLists); ++i) {
+                    if (chunk.id == detail::kTrackLists[i].id) tracks[i].push_back(std::move(value));
+                }
+            }
+        }
+        if (!haveHead) { error = "missing HEAD chunk"; return false; }
+        root["audio_pool"] = std::move(pool);
+        for (size_t i = 0; i < std::size(detail::kTrackLists); ++i) {
+            root[detail::kTrackLists[i].key] = std::move(tracks[i]);
+        }
+        return true;
+    }
+
+    inline std::vector<uint8_t> encode(const std::vector<Chunk>& chunks) {
+        size_t total = 12 + 12;
+        for (const Chunk& chunk : chunks) total += 20 + chunk.payload.size();
+        std::vector<uint8_t> out;
+        out.reserve(total);
+        detail::putU32(out, kMagic);
+        detail::putU32(out, kVersion);
+        detail::putU32(out, static_cast<uint32_t>(chunks.size()));
+        for (const Chunk& chunk : chunks) {
+            detail::putU32(out, chunk.id);
+            detail::putU64(out, chunk.payload.size());
+            detail::putU64(out, chunk.hash);
+            out.insert(out.end(), chunk.payload.begin(), chunk.payload.end());
+        }
+        detail::putU32(out, kEndMagic);
+        detail::putU64(out, combinedHash(chunks));
+        return out;
+    }
+
+    inline bool decode(const uint8_t* data, size_t size, std::vector<Chunk>& chunks, std::string& error) {
+        detail::Reader r{data, size};
+        chunks.clear();
+        if (r.u32() != kMagic || !r.ok) { error = "not a session binary"; return false; }
+        uint32_t version = r.u32();
+        if (version != kVersion) { error = "unsupported version " + std::to_string(version); return false; }
+        uint32_t count = r.u32();
+        if (!r.ok || count > size / 20) { error = "bad chunk count"; return false; }
+        chunks.resize(count);
+        for (Chunk& chunk : chunks) {
+            chunk.id = r.u32();
+            uint64_t length = r.u64();
+            chunk.hash = r.u64();
+            if (!r.ok || length > size - r.pos) { error = "truncated"; return false; }
+            chunk.payload.assign(data + r.pos, data + r.pos + length);
+            r.pos += static_cast<size_t>(length);
+            if (hashBytes(chunk.payload.data(), chunk.payload.size()) != chunk.hash) {
+                error = "chunk hash mismatch";
+                return false;
+            }
+        }
+        if (r.u32() != kEndMagic || r.u64() != combinedHash(chunks) || !r.ok) {
+            error = "truncated";
+            return false;
+        }
+        return true;
+    }
+
+    inline bool isBinaryFile(const std::filesystem::path& path) {
+        std::ifstream f(path, std::ios::binary);
+        uint8_t magic[4] = {};
+        if (!f.read(reinterpret_cast<char*>(magic), sizeof(magic))) return false;
+        detail::Reader r{magic, sizeof(magic)};
+        return r.u32() == kMagic;
+    }
+
+    inline std::filesystem::path backupPathFor(const std::filesystem::path& path) {
+        std::filesystem::path backup = path;
+        backup += ".bak";
+        return backup;
+    }
+
+    // Renames `from` over `to` in one step where the platform can.
+    inline bool replaceFile(const std::filesystem::path& from, const std::filesystem::path& to) {
+#if defined(_WIN32)
+        return ::MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        std::error_code ec;
+        std::filesystem::rename(from, to, ec);
+        return !ec;
+#endif
+    }
+
+    // Writes `bytes` to a sibling temp file, flushes it to disk and renames
+    // it over `path`, so a crash leaves either the old file or the new one.
+    // Where the replace itself fails, the old file is moved to `.bak` first
+    // and only removed once the new one is in place; recoverInterruptedSave
+    // puts it back if the process died in between.
+    inline bool saveFileAtomic(const std::filesystem::path& path, const std::vector<uint8_t>& bytes, std::string& error) {
+        std::filesystem::path tmpPath = path;
+        tmpPath += ".tmp";
+        std::FILE* f = std::fopen(tmpPath.string().c_str(), "wb");
+        if (!f) { error = "cannot write " + tmpPath.string(); return false; }
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        ok = std::fflush(f) == 0 && ok;
+#if defined(__unix__) || defined(__APPLE__)
+        ok = ::fsync(fileno(f)) == 0 && ok;
+#endif
+        ok = std::fclose(f) == 0 && ok;
+        std::error_code ec;
+        if (!ok) {
+            std::filesystem::remove(tmpPath, ec);
+            error = "write failed for " + tmpPath.string();
+            return false;
+        }
+        if (replaceFile(tmpPath, path)) return true;
+
+        const std::filesystem::path backupPath = backupPathFor(path);
+        const bool hadOld = std::filesystem::exists(path, ec);
+        if (hadOld) {
+            std::filesystem::remove(backupPath, ec);
+            std::filesystem::rename(path, backupPath, ec);
+            if (ec) {
+                std::filesystem::remove(tmpPath, ec);
+                error = "cannot replace " + path.string();
+                return false;
+            }
+        }
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            if (hadOld) std::filesystem::rename(backupPath, path, ec);
+            std::filesystem::remove(tmpPath, ec);
+            error = "cannot replace " + path.string();
+            return false;
+        }
+        if (hadOld) std::filesystem::remove(backupPath, ec);
+        return true;
+    }
+
+    // Restores `path` from the `.bak` a save left behind if it died between
+    // moving the old file aside and putting the new one in place. True if
+    // `path` exists afterwards.
+    inline bool recoverInterruptedSave(const std::filesystem::path& path) {
+        std::error_code ec;
+        if (std::filesystem::exists(path, ec)) return true;
+        const std::filesystem::path backupPath = backupPathFor(path);
+        if (!std::filesystem::exists(backupPath, ec)) return false;
+        std::filesystem::rename(backupPath, path, ec);
+        return !ec;
+    }
+
+    inline bool loadFile(const std::filesystem::path& path, nlohmann::json& root, std::string& error) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f.is_open()) { error = "cannot read " + path.string(); return false; }
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        std::vector<Chunk> chunks;
+        if (!decode(bytes.data(), bytes.size(), chunks, error)) return false;
+        return join(chunks, root, error);
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "../Host.h"
+#include "BaseSystem/RenderDevice.h"
 
 namespace SkyboxSystemLogic {
 
@@ -18,6 +19,7 @@ namespace SkyboxSystemLogic {
         if (!baseSystem.renderer || !baseSystem.world) return;
         RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
+        RenderDevice::Device& device = RenderDevice::current();
 
         glm::vec3 skyTop, skyBottom;
         getCurrentSkyColors(dayFraction, world.skyKeys, skyTop, skyBottom);
@@ -49,27 +51,27 @@ namespace SkyboxSystemLogic {
         };
 
         // Occlusion pass (downsampled)
-        GLint prevViewport[4]; glGetIntegerv(GL_VIEWPORT, prevViewport);
-        glViewport(0, 0, renderer.godrayWidth, renderer.godrayHeight);
-        glBindFramebuffer(GL_FRAMEBUFFER, renderer.godrayOcclusionFBO);
-        glClearColor(0,0,0,0);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glDisable(GL_DEPTH_TEST);
-        glDepthMask(GL_FALSE);
-        glDisable(GL_BLEND);
+        GLint prevViewport[4]; device.getViewport(prevViewport);
+        device.viewport(0, 0, renderer.godrayWidth, renderer.godrayHeight);
+        device.bindFramebuffer(GL_FRAMEBUFFER, renderer.godrayOcclusionFBO);
+        device.clearColor(0, 0, 0, 0);
+        device.clear(GL_COLOR_BUFFER_BIT);
+        device.disable(GL_DEPTH_TEST);
+        device.depthMask(false);
+        device.disable(GL_BLEND);
         renderer.sunMoonShader->use(); renderer.sunMoonShader->setMat4("v", view); renderer.sunMoonShader->setMat4("p", projection); renderer.sunMoonShader->setFloat("time", time);
         glm::mat4 sunM = billboard(playerPos + sunDir * 500.0f, 42.0f);
         renderer.sunMoonShader->setMat4("m",sunM); renderer.sunMoonShader->setVec3("c",glm::vec3(1,1,0.8f));
-        glBindVertexArray(renderer.sunMoonVAO); glDrawArrays(GL_TRIANGLES,0,6);
+        device.bindVertexArray(renderer.sunMoonVAO); device.drawArrays(GL_TRIANGLES, 0, 6);
         glm::mat4 moonM = billboard(playerPos + moonDir * 500.0f, 42.0f);
         renderer.sunMoonShader->setMat4("m",moonM); renderer.sunMoonShader->setVec3("c",glm::vec3(0.9f,0.9f,1));
-        glDrawArrays(GL_TRIANGLES,0,6);
+        device.drawArrays(GL_TRIANGLES, 0, 6);
 
         // Radial blur
-        glBindFramebuffer(GL_FRAMEBUFFER, renderer.godrayBlurFBO);
-        glClearColor(0,0,0,0);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glBindVertexArray(renderer.godrayQuadVAO);
+        device.bindFramebuffer(GL_FRAMEBUFFER, renderer.godrayBlurFBO);
+        device.clearColor(0, 0, 0, 0);
+        device.clear(GL_COLOR_BUFFER_BIT);
+        device.bindVertexArray(renderer.godrayQuadVAO);
         renderer.godrayRadialShader->use();
         renderer.godrayRadialShader->setInt("occlusionTex", 0);
         renderer.godrayRadialShader->setVec2("lightPos", lightScreen);
@@ -79,65 +81,65 @@ namespace SkyboxSystemLogic {
         renderer.godrayRadialShader->setFloat("weight", 0.3f);
         renderer.godrayRadialShader->setFloat("time", time);
         renderer.godrayRadialShader->setInt("samples", 64);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, renderer.godrayOcclusionTex);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        device.activeTexture(GL_TEXTURE0);
+        device.bindTexture(GL_TEXTURE_2D, renderer.godrayOcclusionTex);
+        device.drawArrays(GL_TRIANGLES, 0, 6);
 
         // Restore framebuffer/viewport
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+        device.bindFramebuffer(GL_FRAMEBUFFER, 0);
+        device.viewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
 
         // Skybox
-        glDepthMask(GL_FALSE);
+        device.depthMask(false);
         renderer.skyboxShader->use();
         renderer.skyboxShader->setVec3("sT", skyTop);
         renderer.skyboxShader->setVec3("sB", skyBottom);
         glm::mat4 viewNoTranslation = glm::mat4(glm::mat3(view));
         renderer.skyboxShader->setMat4("projection", projection);
         renderer.skyboxShader->setMat4("view", viewNoTranslation);
-        glBindVertexArray(renderer.skyboxVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        device.bindVertexArray(renderer.skyboxVAO);
+        device.drawArrays(GL_TRIANGLES, 0, 6);
 
         // Stars
-        glDisable(GL_DEPTH_TEST);
-        glDepthMask(GL_FALSE);
+        device.disable(GL_DEPTH_TEST);
+        device.depthMask(false);
         if (!starPositions.empty()) {
-            glBindVertexArray(renderer.starVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.starVBO);
-            glBufferData(GL_ARRAY_BUFFER, starPositions.size() * sizeof(glm::vec3), starPositions.data(), GL_DYNAMIC_DRAW);
-            glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,sizeof(glm::vec3),(void*)0);glEnableVertexAttribArray(0);
+            device.bindVertexArray(renderer.starVAO);
+            device.bindBuffer(GL_ARRAY_BUFFER, renderer.starVBO);
+            device.bufferData(GL_ARRAY_BUFFER, starPositions.size() * sizeof(glm::vec3), starPositions.data(), GL_DYNAMIC_DRAW);
+            device.vertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(glm::vec3), 0); device.enableVertexAttribArray(0);
             renderer.starShader->use();
             renderer.starShader->setFloat("t", time);
             glm::mat4 viewNoTranslationStars = glm::mat4(glm::mat3(view));
             renderer.starShader->setMat4("v", viewNoTranslationStars);
             renderer.starShader->setMat4("p", projection);
-            glEnable(GL_PROGRAM_POINT_SIZE);
-            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(starPositions.size()));
+            device.enable(GL_PROGRAM_POINT_SIZE);
+            device.drawArrays(GL_POINTS, 0, static_cast<GLsizei>(starPositions.size()));
         }
 
         // Sun and moon main pass
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         renderer.sunMoonShader->use(); renderer.sunMoonShader->setMat4("v", view); renderer.sunMoonShader->setMat4("p", projection); renderer.sunMoonShader->setFloat("time", time);
         renderer.sunMoonShader->setMat4("m", sunM); renderer.sunMoonShader->setVec3("c", glm::vec3(1,1,0.8f));
-        glBindVertexArray(renderer.sunMoonVAO); glDrawArrays(GL_TRIANGLES,0,6);
+        device.bindVertexArray(renderer.sunMoonVAO); device.drawArrays(GL_TRIANGLES, 0, 6);
         renderer.sunMoonShader->setMat4("m", moonM); renderer.sunMoonShader->setVec3("c", glm::vec3(0.9f,0.9f,1));
-        glDrawArrays(GL_TRIANGLES,0,6);
-        glDisable(GL_BLEND);
+        device.drawArrays(GL_TRIANGLES, 0, 6);
+        device.disable(GL_BLEND);
 
         // Composite godrays additively
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_ONE, GL_ONE);
-        glBindVertexArray(renderer.godrayQuadVAO);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_ONE, GL_ONE);
+        device.bindVertexArray(renderer.godrayQuadVAO);
         renderer.godrayCompositeShader->use();
         renderer.godrayCompositeShader->setInt("godrayTex", 0);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, renderer.godrayBlurTex);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glDisable(GL_BLEND);
+        device.activeTexture(GL_TEXTURE0);
+        device.bindTexture(GL_TEXTURE_2D, renderer.godrayBlurTex);
+        device.drawArrays(GL_TRIANGLES, 0, 6);
+        device.disable(GL_BLEND);
 
-        glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
+        device.depthMask(true);
+        device.enable(GL_DEPTH_TEST);
     }
 
 }
@@ -16,10 +16,11 @@ struct AudioContext;
 namespace SoundPhysicsSystemLogic {
 
     namespace {
-        void applyDistanceFalloff(std::map<int, AudioSourceState>& states, const glm::vec3& listenerPos) {
+        void applyDistanceFalloff(AudioSourceStateTable& states, const glm::vec3& listenerPos) {
             const float refDist = 4.0f;
             const float falloffPower = 1.5f;
-            for (auto& [id, st] : states) {
+            for (int id : states.ids) {
+                AudioSourceState& st = states.slots[static_cast<size_t>(id)];
                 float dist = glm::length(listenerPos - st.sourcePos);
                 float clampedDist = std::max(dist, refDist);
                 float airLoss = std::pow(refDist / clampedDist, falloffPower);
@@ -27,7 +28,7 @@ namespace SoundPhysicsSystemLogic {
             }
         }
 
-        void applyMicCardioid(std::map<int, AudioSourceState>& states,
+        void applyMicCardioid(AudioSourceStateTable& states,
                               const glm::vec3& listenerPos,
                               const glm::vec3& micForward) {
             glm::vec3 earForward = micForward;
@@ -37,7 +38,8 @@ namespace SoundPhysicsSystemLogic {
                 earForward = glm::normalize(earForward);
             }
 
-            for (auto& [id, st] : states) {
+            for (int id : states.ids) {
+                AudioSourceState& st = states.slots[static_cast<size_t>(id)];
                 glm::vec3 dirForMic = st.direction;
                 if (glm::length(dirForMic) < 1e-4f) {
                     dirForMic = st.sourcePos - listenerPos;
@@ -52,7 +54,7 @@ namespace SoundPhysicsSystemLogic {
             }
         }
 
-        void applyMicDistanceHf(std::map<int, AudioSourceState>& states,
+        void applyMicDistanceHf(AudioSourceStateTable& states,
                                 const glm::vec3& listenerPos,
                                 float sampleRate) {
             const float distCutoffMin = 7500.0f;
@@ -60,7 +62,8 @@ namespace SoundPhysicsSystemLogic {
             const float distStart = 4.0f;
             const float distEnd = 60.0f;
 
-            for (auto& [id, st] : states) {
+            for (int id : states.ids) {
+                AudioSourceState& st = states.slots[static_cast<size_t>(id)];
                 float dist = glm::length(listenerPos - st.sourcePos);
                 if (sampleRate > 0.0f) {
                     float distT = 0.0f;
@@ -97,7 +100,9 @@ namespace SoundPhysicsSystemLogic {
             const float widthNear = 2.0f;
             const float widthFar = 7.0f;
 
-            for (auto& [id, st] : rtAudio.sourceStates) {
+            AudioSourceStateTable& states = rtAudio.sourceStates.front();
+            for (int id : states.ids) {
+                AudioSourceState& st = states.slots[static_cast<size_t>(id)];
                 glm::vec3 dir = st.direction;
                 float dirLen = glm::length(dir);
                 float dotForward = 1.0f;
@@ -145,16 +150,16 @@ namespace SoundPhysicsSystemLogic {
 
         if (!rtAudio.sourceStates.empty() &&
             rtAudio.sourceStatesVersion != lastSourceVersion) {
-            applyDistanceFalloff(rtAudio.sourceStates, rtAudio.batch.listenerPos);
+            applyDistanceFalloff(rtAudio.sourceStates.front(), rtAudio.batch.listenerPos);
             lastSourceVersion = rtAudio.sourceStatesVersion;
         }
 
         if (!rtAudio.micSourceStates.empty() &&
             rtAudio.micStatesVersion != lastMicVersion) {
-            applyDistanceFalloff(rtAudio.micSourceStates, rtAudio.micBatch.listenerPos);
-            applyMicCardioid(rtAudio.micSourceStates, rtAudio.micBatch.listenerPos, rtAudio.micListenerForward);
+            applyDistanceFalloff(rtAudio.micSourceStates.front(), rtAudio.micBatch.listenerPos);
+            applyMicCardioid(rtAudio.micSourceStates.front(), rtAudio.micBatch.listenerPos, rtAudio.micListenerForward);
             float sampleRate = baseSystem.audio ? baseSystem.audio->sampleRate : 0.0f;
-            applyMicDistanceHf(rtAudio.micSourceStates, rtAudio.micBatch.listenerPos, sampleRate);
+            applyMicDistanceHf(rtAudio.micSourceStates.front(), rtAudio.micBatch.listenerPos, sampleRate);
             lastMicVersion = rtAudio.micStatesVersion;
         }
 
@@ -1,25 +1,108 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
 #include <limits>
+#include <mutex>
+#include <numeric>
 #include <random>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/event.h>
+#include <unistd.h>
+#endif
+
+#include "BaseSystem/WavStreamWriter.h"
+
+// One background load. The main thread keeps the shared_ptr, polls `done`,
+// and may set `cancelled` at any time; `ok` and `audio` are only touched by
+// the loader thread until `done` is set.
+struct SoundtrackLoadJob {
+    std::string path;
+    bool stereo = false;
+    uint32_t targetRate = 0;
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> done{false};
+    bool ok = false;
+    SoundtrackAudio audio;
+};
+
+// Owns the decode thread and the soundtrack folder watcher. Both threads stop
+// and join when the loader is destroyed.
+struct SoundtrackLoader {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+    std::thread watcher;
+    bool stop = false;
+    std::deque<std::shared_ptr<SoundtrackLoadJob>> jobs;
+    std::shared_ptr<SoundtrackLoadJob> current;
+    std::string cacheDir;
+    // Folder the watcher follows, and the last listing it published for it.
+    std::string watchFolder;
+    std::string tracksFolder;
+    std::vector<std::string> tracks;
+    uint64_t tracksVersion = 0;
+
+    ~SoundtrackLoader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+            if (current) current->cancelled.store(true, std::memory_order_relaxed);
+            for (auto& job : jobs) job->cancelled.store(true, std::memory_order_relaxed);
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+        if (watcher.joinable()) watcher.join();
+    }
+};
+
 namespace SoundtrackSystemLogic {
 
     namespace {
+        constexpr size_t kDecodeChunkFrames = 16384;
+        constexpr size_t kCacheWriteChunkFrames = 65536;
+        constexpr int kWatchWaitMs = 250;
+        constexpr auto kMissingFolderRetry = std::chrono::seconds(2);
+
+        // Resampler: Kaiser-windowed sinc. The kernel is tabulated over
+        // kSincZeroCrossings lobes at kSincTableResolution points per lobe.
+        // Bump kResamplerVersion whenever these change so stale cache files
+        // are not reused.
+        constexpr int kSincZeroCrossings = 48;
+        constexpr int kSincTableResolution = 512;
+        constexpr double kSincRolloff = 0.93;
+        constexpr double kKaiserBeta = 10.0;
+        constexpr uint64_t kMaxPolyphaseBank = 4096;
+        constexpr int kResamplerVersion = 1;
+
         struct WavInfo {
             uint16_t audioFormat = 0;
             uint16_t numChannels = 0;
             uint32_t sampleRate = 0;
             uint16_t bitsPerSample = 0;
-            uint32_t dataSize = 0;
+            uint16_t blockAlign = 0;
+            uint64_t dataSize = 0;
             std::streampos dataPos = 0;
         };
 
@@ -36,8 +119,10 @@ namespace SoundtrackSystemLogic {
             if (!file.read(reinterpret_cast<char*>(&riffSize), sizeof(riffSize))) return false;
             char wave[4] = {0};
             if (!file.read(wave, 4)) return false;
-            if (std::string(riff, 4) != "RIFF" || std::string(wave, 4) != "WAVE") return false;
+            const std::string riffId(riff, 4);
+            if ((riffId != "RIFF" && riffId != "RF64") || std::string(wave, 4) != "WAVE") return false;
 
+            uint64_t ds64DataSize = 0;
             bool fmtFound = false;
             bool dataFound = false;
             while (file && (!fmtFound || !dataFound)) {
@@ -45,7 +130,13 @@ namespace SoundtrackSystemLogic {
                 uint32_t chunkSize = 0;
                 if (!readChunkHeader(file, chunkId, chunkSize)) break;
                 std::string id(chunkId, 4);
-                if (id == "fmt ") {
+                const std::streamoff padded = static_cast<std::streamoff>(chunkSize) + (chunkSize & 1u);
+                if (id == "ds64" && chunkSize >= 16) {
+                    uint64_t riffSize64 = 0;
+                    file.read(reinterpret_cast<char*>(&riffSize64), sizeof(riffSize64));
+                    file.read(reinterpret_cast<char*>(&ds64DataSize), sizeof(ds64DataSize));
+                    file.seekg(padded - 16, std::ios::cur);
+                } else if (id == "fmt " && chunkSize >= 16) {
                     fmtFound = true;
                     uint16_t audioFormat = 0;
                     uint16_t numChannels = 0;
@@ -59,67 +150,354 @@ namespace SoundtrackSystemLogic {
                     file.read(reinterpret_cast<char*>(&byteRate), sizeof(byteRate));
                     file.read(reinterpret_cast<char*>(&blockAlign), sizeof(blockAlign));
                     file.read(reinterpret_cast<char*>(&bitsPerSample), sizeof(bitsPerSample));
-                    if (chunkSize > 16) {
-                        file.seekg(chunkSize - 16, std::ios::cur);
+                    std::streamoff consumed = 16;
+                    if (audioFormat == 0xFFFE && chunkSize >= 26) {
+                        // WAVE_FORMAT_EXTENSIBLE: the real format code leads the
+                        // sub-format GUID after cbSize, valid bits and channel mask.
+                        char extension[8] = {0};
+                        file.read(extension, sizeof(extension));
+                        uint16_t subFormat = 0;
+                        file.read(reinterpret_cast<char*>(&subFormat), sizeof(subFormat));
+                        audioFormat = subFormat;
+                        consumed += 10;
                     }
+                    file.seekg(padded - consumed, std::ios::cur);
                     info.audioFormat = audioFormat;
                     info.numChannels = numChannels;
                     info.sampleRate = sampleRate;
                     info.bitsPerSample = bitsPerSample;
+                    info.blockAlign = blockAlign;
                 } else if (id == "data") {
                     dataFound = true;
-                    info.dataSize = chunkSize;
+                    info.dataSize = (chunkSize == 0xFFFFFFFFu && ds64DataSize > 0) ? ds64DataSize : chunkSize;
                     info.dataPos = file.tellg();
-                    file.seekg(chunkSize, std::ios::cur);
+                    if (!fmtFound) {
+                        file.seekg(static_cast<std::streamoff>(info.dataSize + (info.dataSize & 1u)), std::ios::cur);
+                    }
                 } else {
-                    file.seekg(chunkSize, std::ios::cur);
+                    file.seekg(padded, std::ios::cur);
                 }
             }
             return fmtFound && dataFound;
         }
 
-        bool loadWavMono(const std::string& path, std::vector<float>& outSamples, uint32_t& outRate) {
+        using SampleReader = float (*)(const unsigned char*);
+
+        float readPcm8(const unsigned char* p) {
+            return (static_cast<float>(p[0]) - 128.0f) / 128.0f;
+        }
+
+        float readPcm16(const unsigned char* p) {
+            int16_t v = 0;
+            std::memcpy(&v, p, sizeof(v));
+            return static_cast<float>(v) / 32768.0f;
+        }
+
+        float readPcm24(const unsigned char* p) {
+            const uint32_t bits = static_cast<uint32_t>(p[0])
+                | (static_cast<uint32_t>(p[1]) << 8)
+                | (static_cast<uint32_t>(p[2]) << 16);
+            const int32_t v = static_cast<int32_t>(bits << 8) >> 8;
+            return static_cast<float>(v) / 8388608.0f;
+        }
+
+        float readPcm32(const unsigned char* p) {
+            int32_t v = 0;
+            std::memcpy(&v, p, sizeof(v));
+            return static_cast<float>(static_cast<double>(v) / 2147483648.0);
+        }
+
+        float readFloat32(const unsigned char* p) {
+            float v = 0.0f;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        float readFloat64(const unsigned char* p) {
+            double v = 0.0;
+            std::memcpy(&v, p, sizeof(v));
+            return static_cast<float>(v);
+        }
+
+        SampleReader sampleReaderFor(const WavInfo& info) {
+            if (info.audioFormat == 1) {
+                switch (info.bitsPerSample) {
+                    case 8: return readPcm8;
+                    case 16: return readPcm16;
+                    case 24: return readPcm24;
+                    case 32: return readPcm32;
+                    default: return nullptr;
+                }
+            }
+            if (info.audioFormat == 3) {
+                if (info.bitsPerSample == 32) return readFloat32;
+                if (info.bitsPerSample == 64) return readFloat64;
+            }
+            return nullptr;
+        }
+
+        // Reads the data chunk in kDecodeChunkFrames blocks. With `stereo` the
+        // first two channels become left/right; otherwise all channels are
+        // averaged to mono. Returns false on unsupported formats or when
+        // `cancelled` is raised mid-file.
+        bool decodeWav(const std::string& path, bool stereo, const std::atomic<bool>& cancelled,
+                       SoundtrackAudio& out) {
             std::ifstream file(path, std::ios::binary);
             if (!file.is_open()) return false;
             WavInfo info;
             if (!readWavInfo(file, info)) return false;
-            if (info.dataSize == 0 || info.numChannels == 0) return false;
+            if (info.dataSize == 0 || info.numChannels == 0 || info.sampleRate == 0) return false;
+            SampleReader reader = sampleReaderFor(info);
+            if (!reader) return false;
+            const size_t sampleBytes = info.bitsPerSample / 8;
+            const size_t frameBytes = sampleBytes * info.numChannels;
+            if (info.blockAlign != 0 && info.blockAlign != frameBytes) return false;
 
-            outRate = info.sampleRate;
-            file.seekg(info.dataPos);
+            const size_t frameCount = static_cast<size_t>(info.dataSize / frameBytes);
+            const bool splitStereo = stereo && info.numChannels >= 2;
+            out.sampleRate = info.sampleRate;
+            out.left.assign(frameCount, 0.0f);
+            out.right.clear();
+            if (splitStereo) out.right.assign(frameCount, 0.0f);
 
-            if (info.audioFormat == 3 && info.bitsPerSample == 32) {
-                size_t frameCount = info.dataSize / (sizeof(float) * info.numChannels);
-                outSamples.assign(frameCount, 0.0f);
-                for (size_t i = 0; i < frameCount; ++i) {
-                    float sample = 0.0f;
-                    for (uint16_t ch = 0; ch < info.numChannels; ++ch) {
-                        float v = 0.0f;
-                        file.read(reinterpret_cast<char*>(&v), sizeof(float));
-                        sample += v;
+            file.seekg(info.dataPos);
+            std::vector<unsigned char> chunk(kDecodeChunkFrames * frameBytes);
+            const float monoScale = 1.0f / static_cast<float>(info.numChannels);
+            size_t decoded = 0;
+            while (decoded < frameCount) {
+                if (cancelled.load(std::memory_order_relaxed)) return false;
+                const size_t want = std::min(kDecodeChunkFrames, frameCount - decoded);
+                file.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(want * frameBytes));
+                const size_t got = static_cast<size_t>(file.gcount()) / frameBytes;
+                if (got == 0) break;
+                const unsigned char* frame = chunk.data();
+                for (size_t i = 0; i < got; ++i, frame += frameBytes) {
+                    if (splitStereo) {
+                        out.left[decoded + i] = reader(frame);
+                        out.right[decoded + i] = reader(frame + sampleBytes);
+                    } else {
+                        float sum = 0.0f;
+                        for (uint16_t ch = 0; ch < info.numChannels; ++ch) {
+                            sum += reader(frame + ch * sampleBytes);
+                        }
+                        out.left[decoded + i] = sum * monoScale;
                     }
-                    outSamples[i] = sample / static_cast<float>(info.numChannels);
                 }
-                return true;
+                decoded += got;
+                if (got < want) break;
+            }
+            if (decoded == 0) return false;
+            // A header that overstates the data (e.g. an unfinished recording)
+            // just yields a shorter track.
+            out.left.resize(decoded);
+            if (splitStereo) out.right.resize(decoded);
+            return true;
+        }
+
+        double besselI0(double x) {
+            double sum = 1.0;
+            double term = 1.0;
+            const double halfX = 0.5 * x;
+            for (int k = 1; k < 64; ++k) {
+                term *= (halfX / k) * (halfX / k);
+                sum += term;
+                if (term < sum * 1e-17) break;
+            }
+            return sum;
+        }
+
+        // sinc(u) * kaiser(u / kSincZeroCrossings) for u in [0, kSincZeroCrossings],
+        // one entry past the end so interpolation never reads out of range.
+        const std::vector<float>& sincTable() {
+            static const std::vector<float> table = []() {
+                const size_t count = static_cast<size_t>(kSincZeroCrossings) * kSincTableResolution + 2;
+                std::vector<float> values(count, 0.0f);
+                const double pi = 3.14159265358979323846;
+                const double norm = besselI0(kKaiserBeta);
+                for (size_t i = 0; i < count; ++i) {
+                    const double u = static_cast<double>(i) / kSincTableResolution;
+                    const double r = u / kSincZeroCrossings;
+                    if (r >= 1.0) break;
+                    const double sinc = (i == 0) ? 1.0 : std::sin(pi * u) / (pi * u);
+                    const double window = besselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / norm;
+                    values[i] = static_cast<float>(sinc * window);
+                }
+                return values;
+            }();
+            return table;
+        }
+
+        double sincKernel(const std::vector<float>& table, double u) {
+            const double pos = std::fabs(u) * kSincTableResolution;
+            const size_t index = static_cast<size_t>(pos);
+            if (index + 1 >= table.size()) return 0.0;
+            const double frac = pos - static_cast<double>(index);
+            return table[index] + frac * (table[index + 1] - table[index]);
+        }
+
+        // Fills `coeffs` (taps entries) for an output that lands `frac` input
+        // samples past the newest tap-centre, normalised to unity DC gain.
+        void buildPhase(const std::vector<float>& table, double frac, double cutoff, int halfTaps,
+                        float* coeffs) {
+            const int taps = halfTaps * 2;
+            double sum = 0.0;
+            for (int j = 0; j < taps; ++j) {
+                const double x = frac + static_cast<double>(halfTaps - 1 - j);
+                const double h = sincKernel(table, x * cutoff);
+                coeffs[j] = static_cast<float>(h);
+                sum += h;
+            }
+            if (sum != 0.0) {
+                const float scale = static_cast<float>(1.0 / sum);
+                for (int j = 0; j < taps; ++j) coeffs[j] *= scale;
+            }
+        }
+
+        // Band-limited conversion of `in` to `outRate`. Output n sits at input
+        // position n * inRate / outRate, tracked as an exact integer ratio so
+        // long tracks do not drift. Standard rate pairs have few distinct
+        // phases, so their coefficients are built once up front.
+        bool resampleSinc(const SoundtrackAudio& in, uint32_t outRate, const std::atomic<bool>& cancelled,
+                          SoundtrackAudio& out) {
+            if (in.sampleRate == 0 || outRate == 0 || in.left.empty()) return false;
+            const uint64_t g = std::gcd(static_cast<uint64_t>(in.sampleRate), static_cast<uint64_t>(outRate));
+            const uint64_t phases = outRate / g;
+            const uint64_t step = in.sampleRate / g;
+            const double ratio = static_cast<double>(outRate) / static_cast<double>(in.sampleRate);
+            const double cutoff = std::min(1.0, ratio) * kSincRolloff;
+            const int halfTaps = static_cast<int>(std::ceil(kSincZeroCrossings / cutoff));
+            const int taps = halfTaps * 2;
+            const std::vector<float>& table = sincTable();
+
+            std::vector<float> bank;
+            if (phases <= kMaxPolyphaseBank) {
+                bank.resize(static_cast<size_t>(phases) * taps);
+                for (uint64_t p = 0; p < phases; ++p) {
+                    buildPhase(table, static_cast<double>(p) / static_cast<double>(phases), cutoff, halfTaps,
+                               bank.data() + p * taps);
+                }
             }
+            std::vector<float> scratch(bank.empty() ? static_cast<size_t>(taps) : 0);
+
+            const bool stereo = !in.right.empty();
+            const uint64_t inCount = in.left.size();
+            const uint64_t outCount = (inCount * phases + step - 1) / step;
+            out.sampleRate = outRate;
+            out.left.assign(static_cast<size_t>(outCount), 0.0f);
+            out.right.clear();
+            if (stereo) out.right.assign(static_cast<size_t>(outCount), 0.0f);
 
-            if (info.audioFormat == 1 && info.bitsPerSample == 16) {
-                size_t frameCount = info.dataSize / (sizeof(int16_t) * info.numChannels);
-                outSamples.assign(frameCount, 0.0f);
-                for (size_t i = 0; i < frameCount; ++i) {
-                    int32_t sum = 0;
-                    for (uint16_t ch = 0; ch < info.numChannels; ++ch) {
-                        int16_t v = 0;
-                        file.read(reinterpret_cast<char*>(&v), sizeof(int16_t));
-                        sum += v;
+            const float* srcL = in.left.data();
+            const float* srcR = stereo ? in.right.data() : nullptr;
+            for (uint64_t n = 0; n < outCount; ++n) {
+                if ((n & 4095u) == 0 && cancelled.load(std::memory_order_relaxed)) return false;
+                const uint64_t position = n * step;
+                const uint64_t base = position / phases;
+                const uint64_t phase = position % phases;
+                const float* coeffs = nullptr;
+                if (!bank.empty()) {
+                    coeffs = bank.data() + phase * taps;
+                } else {
+                    buildPhase(table, static_cast<double>(phase) / static_cast<double>(phases), cutoff, halfTaps,
+                               scratch.data());
+                    coeffs = scratch.data();
+                }
+                const int64_t first = static_cast<int64_t>(base) - halfTaps + 1;
+                int jBegin = 0;
+                int jEnd = taps;
+                if (first < 0) jBegin = static_cast<int>(-first);
+                if (first + taps > static_cast<int64_t>(inCount)) {
+                    jEnd = static_cast<int>(static_cast<int64_t>(inCount) - first);
+                }
+                float accL = 0.0f;
+                float accR = 0.0f;
+                const float* rowL = srcL + first;
+                if (srcR) {
+                    const float* rowR = srcR + first;
+                    for (int j = jBegin; j < jEnd; ++j) {
+                        accL += coeffs[j] * rowL[j];
+                        accR += coeffs[j] * rowR[j];
                     }
-                    float sample = static_cast<float>(sum) / (static_cast<float>(info.numChannels) * 32768.0f);
-                    outSamples[i] = sample;
+                    out.right[static_cast<size_t>(n)] = accR;
+                } else {
+                    for (int j = jBegin; j < jEnd; ++j) accL += coeffs[j] * rowL[j];
                 }
-                return true;
+                out.left[static_cast<size_t>(n)] = accL;
+            }
+            return true;
+        }
+
+        // Cache file for `path` converted to `targetRate`. Keyed on the source's
+        // identity (canonical path, size, mtime) so an edited file is converted
+        // again. Empty when the source cannot be stat'ed.
+        std::string cachePathFor(const std::string& cacheDir, const std::string& path, bool stereo,
+                                 uint32_t targetRate) {
+            if (cacheDir.empty()) return {};
+            namespace fs = std::filesystem;
+            std::error_code ec;
+            const fs::path canonical = fs::weakly_canonical(fs::path(path), ec);
+            if (ec) return {};
+            const uintmax_t size = fs::file_size(canonical, ec);
+            if (ec) return {};
+            const auto mtime = fs::last_write_time(canonical, ec);
+            if (ec) return {};
+            std::ostringstream key;
+            key << canonical.string() << '|' << size << '|' << mtime.time_since_epoch().count()
+                << '|' << (stereo ? 2 : 1) << '|' << targetRate << '|' << kResamplerVersion;
+            std::ostringstream name;
+            name << canonical.stem().string() << '_' << std::hex << std::setw(16) << std::setfill('0')
+                 << std::hash<std::string>{}(key.str()) << std::dec << '_' << targetRate << ".wav";
+            return (fs::path(cacheDir) / name.str()).string();
+        }
+
+        void writeCacheFile(const std::string& cachePath, const SoundtrackAudio& audio) {
+            const std::string partPath = cachePath + ".part";
+            WavStreamWriter writer;
+            const uint16_t channels = audio.right.empty() ? 1 : 2;
+            bool ok = writer.open(partPath, channels, audio.sampleRate, false);
+            for (size_t i = 0; ok && i < audio.left.size(); i += kCacheWriteChunkFrames) {
+                const size_t frames = std::min(kCacheWriteChunkFrames, audio.left.size() - i);
+                ok = writer.writePlanar(audio.left.data() + i,
+                                        audio.right.empty() ? nullptr : audio.right.data() + i,
+                                        frames);
+            }
+            ok = writer.close() && ok;
+            std::error_code ec;
+            if (ok) std::filesystem::rename(partPath, cachePath, ec);
+            if (!ok || ec) {
+                std::filesystem::remove(partPath, ec);
+                std::cerr << "SoundtrackSystem: could not write resample cache '" << cachePath << "'." << std::endl;
+            }
+        }
+
+        // Loader thread. Uses the on-disk conversion when present, otherwise
+        // decodes, converts to the engine rate once and stores the result.
+        bool runLoadJob(const std::string& cacheDir, SoundtrackLoadJob& job) {
+            const bool needsRate = job.targetRate != 0;
+            const std::string cachePath = needsRate ? cachePathFor(cacheDir, job.path, job.stereo, job.targetRate)
+                                                    : std::string();
+            std::error_code ec;
+            if (!cachePath.empty() && std::filesystem::exists(cachePath, ec)) {
+                SoundtrackAudio cached;
+                if (decodeWav(cachePath, job.stereo, job.cancelled, cached) && cached.sampleRate == job.targetRate) {
+                    job.audio = std::move(cached);
+                    return true;
+                }
+                if (job.cancelled.load(std::memory_order_relaxed)) return false;
+                std::filesystem::remove(cachePath, ec);
             }
 
-            return false;
+            SoundtrackAudio decoded;
+            if (!decodeWav(job.path, job.stereo, job.cancelled, decoded)) return false;
+            if (!needsRate || decoded.sampleRate == job.targetRate) {
+                job.audio = std::move(decoded);
+                return true;
+            }
+            SoundtrackAudio converted;
+            if (!resampleSinc(decoded, job.targetRate, job.cancelled, converted)) return false;
+            if (!cachePath.empty()) writeCacheFile(cachePath, converted);
+            job.audio = std::move(converted);
+            return true;
         }
 
         std::string toLower(std::string s) {
@@ -215,6 +593,253 @@ namespace SoundtrackSystemLogic {
             lastScanError.clear();
         }
 
+        // Folder change notification: inotify on Linux, a kqueue vnode filter on
+        // macOS, and a directory mtime comparison elsewhere. waitFolderChange
+        // blocks for at most timeoutMs and reports whether the listing may have
+        // changed; `broken` means the watch must be re-armed (folder removed or
+        // renamed).
+#if defined(__linux__)
+        struct FolderWatch {
+            int fd = -1;
+        };
+
+        void closeFolderWatch(FolderWatch& watch) {
+            if (watch.fd >= 0) ::close(watch.fd);
+            watch.fd = -1;
+        }
+
+        bool openFolderWatch(FolderWatch& watch, const std::string& folder) {
+            closeFolderWatch(watch);
+            watch.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (watch.fd < 0) return false;
+            const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE
+                | IN_DELETE_SELF | IN_MOVE_SELF;
+            if (inotify_add_watch(watch.fd, folder.c_str(), mask) < 0) {
+                closeFolderWatch(watch);
+                return false;
+            }
+            return true;
+        }
+
+        bool waitFolderChange(FolderWatch& watch, int timeoutMs, bool& broken) {
+            pollfd pfd{watch.fd, POLLIN, 0};
+            if (::poll(&pfd, 1, timeoutMs) <= 0) return false;
+            alignas(inotify_event) char buffer[4096];
+            bool changed = false;
+            while (true) {
+                const ssize_t bytes = ::read(watch.fd, buffer, sizeof(buffer));
+                if (bytes <= 0) break;
+                for (ssize_t offset = 0; offset < bytes;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) broken = true;
+                    changed = true;
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+            return changed;
+        }
+#elif defined(__APPLE__)
+        struct FolderWatch {
+            int kq = -1;
+            int dirFd = -1;
+        };
+
+        void closeFolderWatch(FolderWatch& watch) {
+            if (watch.dirFd >= 0) ::close(watch.dirFd);
+            if (watch.kq >= 0) ::close(watch.kq);
+            watch.dirFd = -1;
+            watch.kq = -1;
+        }
+
+        bool openFolderWatch(FolderWatch& watch, const std::string& folder) {
+            closeFolderWatch(watch);
+            watch.dirFd = ::open(folder.c_str(), O_EVTONLY);
+            if (watch.dirFd < 0) return false;
+            watch.kq = kqueue();
+            if (watch.kq < 0) {
+                closeFolderWatch(watch);
+                return false;
+            }
+            struct kevent change;
+            EV_SET(&change, watch.dirFd, EVFILT_VNODE, EV_ADD | EV_CLEAR,
+                   NOTE_WRITE | NOTE_EXTEND | NOTE_DELETE | NOTE_RENAME, 0, nullptr);
+            if (kevent(watch.kq, &change, 1, nullptr, 0, nullptr) < 0) {
+                closeFolderWatch(watch);
+                return false;
+            }
+            return true;
+        }
+
+        bool waitFolderChange(FolderWatch& watch, int timeoutMs, bool& broken) {
+            struct kevent event;
+            timespec timeout{timeoutMs / 1000, static_cast<long>(timeoutMs % 1000) * 1000000L};
+            if (kevent(watch.kq, nullptr, 0, &event, 1, &timeout) <= 0) return false;
+            if (event.fflags & (NOTE_DELETE | NOTE_RENAME)) broken = true;
+            return true;
+        }
+#else
+        struct FolderWatch {
+            std::string folder;
+            std::filesystem::file_time_type stamp;
+        };
+
+        void closeFolderWatch(FolderWatch& watch) {
+            watch.folder.clear();
+        }
+
+        bool openFolderWatch(FolderWatch& watch, const std::string& folder) {
+            std::error_code ec;
+            watch.stamp = std::filesystem::last_write_time(folder, ec);
+            if (ec) return false;
+            watch.folder = folder;
+            return true;
+        }
+
+        bool waitFolderChange(FolderWatch& watch, int timeoutMs, bool& broken) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            std::error_code ec;
+            const auto stamp = std::filesystem::last_write_time(watch.folder, ec);
+            if (ec) {
+                broken = true;
+                return true;
+            }
+            if (stamp == watch.stamp) return false;
+            watch.stamp = stamp;
+            return true;
+        }
+#endif
+
+        void runWatcher(SoundtrackLoader& loader) {
+            FolderWatch watch;
+            std::string folder;
+            std::string scanError;
+            bool watching = false;
+            bool rescan = false;
+            auto nextRetry = std::chrono::steady_clock::now();
+            while (true) {
+                std::string desired;
+                {
+                    std::lock_guard<std::mutex> lock(loader.mutex);
+                    if (loader.stop) break;
+                    desired = loader.watchFolder;
+                }
+                if (desired != folder) {
+                    folder = desired;
+                    closeFolderWatch(watch);
+                    watching = false;
+                    nextRetry = std::chrono::steady_clock::now();
+                }
+                if (!folder.empty() && !watching && std::chrono::steady_clock::now() >= nextRetry) {
+                    // Arm before scanning so nothing added in between is missed.
+                    watching = openFolderWatch(watch, folder);
+                    nextRetry = std::chrono::steady_clock::now() + kMissingFolderRetry;
+                    rescan = true;
+                }
+
+                if (rescan) {
+                    rescan = false;
+                    std::vector<std::string> tracks;
+                    scanSoundtrackFolder(folder, tracks, scanError);
+                    std::lock_guard<std::mutex> lock(loader.mutex);
+                    if (loader.tracksFolder != folder || loader.tracks != tracks) {
+                        loader.tracksFolder = folder;
+                        loader.tracks = std::move(tracks);
+                        loader.tracksVersion += 1;
+                    }
+                }
+
+                if (watching) {
+                    bool broken = false;
+                    if (waitFolderChange(watch, kWatchWaitMs, broken)) rescan = true;
+                    if (broken) {
+                        closeFolderWatch(watch);
+                        watching = false;
+                    }
+                } else {
+                    std::unique_lock<std::mutex> lock(loader.mutex);
+                    loader.cv.wait_for(lock, std::chrono::milliseconds(kWatchWaitMs),
+                                       [&loader]() { return loader.stop; });
+                }
+            }
+            closeFolderWatch(watch);
+        }
+
+        void runWorker(SoundtrackLoader& loader) {
+            while (true) {
+                std::shared_ptr<SoundtrackLoadJob> job;
+                {
+                    std::unique_lock<std::mutex> lock(loader.mutex);
+                    loader.cv.wait(lock, [&loader]() { return loader.stop || !loader.jobs.empty(); });
+                    if (loader.stop) break;
+                    job = std::move(loader.jobs.front());
+                    loader.jobs.pop_front();
+                    loader.current = job;
+                }
+                if (!job->cancelled.load(std::memory_order_relaxed)) {
+                    job->ok = runLoadJob(loader.cacheDir, *job);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(loader.mutex);
+                    loader.current.reset();
+                }
+                job->done.store(true, std::memory_order_release);
+            }
+        }
+
+        SoundtrackLoader& ensureLoader(AudioContext& audio) {
+            if (!audio.soundtrackLoader) {
+                auto loader = std::make_shared<SoundtrackLoader>();
+                std::error_code ec;
+                std::filesystem::path dir = std::filesystem::temp_directory_path(ec) / "salamander_soundtrack_cache";
+                if (!ec) std::filesystem::create_directories(dir, ec);
+                if (!ec) loader->cacheDir = dir.string();
+                SoundtrackLoader& ref = *loader;
+                loader->worker = std::thread([&ref]() { runWorker(ref); });
+                loader->watcher = std::thread([&ref]() { runWatcher(ref); });
+                audio.soundtrackLoader = std::move(loader);
+            }
+            return *audio.soundtrackLoader;
+        }
+
+        std::shared_ptr<SoundtrackLoadJob> submitLoad(SoundtrackLoader& loader, const std::string& path,
+                                                      bool stereo, uint32_t targetRate) {
+            auto job = std::make_shared<SoundtrackLoadJob>();
+            job->path = path;
+            job->stereo = stereo;
+            job->targetRate = targetRate;
+            {
+                std::lock_guard<std::mutex> lock(loader.mutex);
+                loader.jobs.push_back(job);
+            }
+            loader.cv.notify_all();
+            return job;
+        }
+
+        void cancelLoad(std::shared_ptr<SoundtrackLoadJob>& job) {
+            if (job) job->cancelled.store(true, std::memory_order_relaxed);
+            job.reset();
+        }
+
+        bool loadFinished(const std::shared_ptr<SoundtrackLoadJob>& job) {
+            return job && job->done.load(std::memory_order_acquire);
+        }
+
+        // Main thread. Frees the track the audio callback last replaced, then
+        // publishes `track`; a track still waiting to be adopted was never
+        // seen by the callback and is freed here.
+        void publishTrack(SoundtrackSlot& slot, SoundtrackSlot::Track* track) {
+            delete slot.retired.exchange(nullptr, std::memory_order_acq_rel);
+            delete slot.pending.exchange(track, std::memory_order_acq_rel);
+        }
+
+        // A track counts as playing from the frame it is published with
+        // `start` set, before the callback has adopted it.
+        bool headTrackPlaying(const AudioContext& audio) {
+            if (audio.headTrackActive.load(std::memory_order_relaxed)) return true;
+            const SoundtrackSlot::Track* pending = audio.headTrack.pending.load(std::memory_order_acquire);
+            return pending && pending->start;
+        }
+
         double randomRange(std::mt19937& rng, double minValue, double maxValue) {
             if (maxValue <= minValue) return minValue;
             std::uniform_real_distribution<double> dist(minValue, maxValue);
@@ -229,11 +854,14 @@ namespace SoundtrackSystemLogic {
         static std::string lastHeadPath;
         static std::string lastRayError;
         static std::string lastHeadError;
+        static std::shared_ptr<SoundtrackLoadJob> rayJob;
+        static std::shared_ptr<SoundtrackLoadJob> headJob;
+        static bool headJobFromPlaylist = false;
         static std::vector<std::string> playlistTracks;
         static std::string playlistFolder;
-        static std::string playlistScanError;
-        static size_t lastTrackIndex = std::numeric_limits<size_t>::max();
-        static double playlistRescanTimerSec = 0.0;
+        static uint64_t playlistVersion = 0;
+        static bool playlistListed = false;
+        static std::string lastTrackPath;
         static double waitRemainingSec = 0.0;
         static bool waitArmed = false;
         static bool firstTrackStarted = false;
@@ -241,33 +869,57 @@ namespace SoundtrackSystemLogic {
         static bool warnedNoTracks = false;
         static std::mt19937 rng(std::random_device{}());
 
-        auto loadTrack = [&](const std::string& path,
-                             std::vector<float>& buffer,
-                             uint32_t& sampleRate,
-                             double& pos,
-                             const char* label,
-                             std::string& lastPath,
-                             std::string& lastError) {
-            if (path.empty()) return;
-            if (!buffer.empty() && lastPath == path) return;
-            std::vector<float> samples;
-            uint32_t rate = 0;
-            if (!loadWavMono(path, samples, rate)) {
-                if (lastError != path) {
-                    std::cerr << "SoundtrackSystem: failed to load " << label << " '" << path
-                              << "' (expect mono 16-bit PCM or 32-bit float WAV)." << std::endl;
-                    lastError = path;
+        SoundtrackLoader& loader = ensureLoader(audio);
+        const uint32_t engineRate = audio.sampleRate > 0.0f
+            ? static_cast<uint32_t>(std::lround(audio.sampleRate))
+            : 0u;
+
+        // Requests `path` unless it is already loaded, already loading, or last
+        // failed; a different pending request in the same slot is cancelled.
+        auto requestTrack = [&](std::shared_ptr<SoundtrackLoadJob>& job,
+                                const std::string& path,
+                                bool stereo,
+                                const std::string& lastPath,
+                                const std::string& lastError) {
+            if (path.empty() || path == lastPath || path == lastError) return;
+            if (job && job->path == path) return;
+            cancelLoad(job);
+            job = submitLoad(loader, path, stereo, engineRate);
+        };
+
+        // Hands a finished job's audio to the callback through `slot`. Returns
+        // false (after logging once per path) when the load failed.
+        auto installTrack = [&](std::shared_ptr<SoundtrackLoadJob>& job,
+                                SoundtrackSlot& slot,
+                                std::unique_ptr<SoundtrackSlot::Track> track,
+                                const char* label,
+                                std::string& lastPath,
+                                std::string& lastError) {
+            std::shared_ptr<SoundtrackLoadJob> finished = std::move(job);
+            if (!finished->ok || finished->audio.left.empty() || finished->audio.sampleRate == 0) {
+                if (lastError != finished->path) {
+                    std::cerr << "SoundtrackSystem: failed to load " << label << " '" << finished->path
+                              << "' (expect 8/16/24/32-bit PCM or 32/64-bit float WAV)." << std::endl;
+                    lastError = finished->path;
                 }
-                return;
+                return false;
             }
-            buffer = std::move(samples);
-            sampleRate = rate;
-            pos = 0.0;
-            lastPath = path;
+            track->audio = std::move(finished->audio);
+            publishTrack(slot, track.release());
+            lastPath = finished->path;
+            lastError.clear();
+            return true;
         };
 
-        loadTrack(audio.rayTestPath, audio.rayTestBuffer, audio.rayTestSampleRate, audio.rayTestPos,
-                  "ray track", lastRayPath, lastRayError);
+        // Frees whatever the callback handed back since the last frame.
+        delete audio.rayTestTrack.retired.exchange(nullptr, std::memory_order_acq_rel);
+        delete audio.headTrack.retired.exchange(nullptr, std::memory_order_acq_rel);
+
+        requestTrack(rayJob, audio.rayTestPath, false, lastRayPath, lastRayError);
+        if (loadFinished(rayJob)) {
+            installTrack(rayJob, audio.rayTestTrack, std::make_unique<SoundtrackSlot::Track>(), "ray track",
+                         lastRayPath, lastRayError);
+        }
 
         bool playlistEnabled = getRegistryBool(baseSystem, "SoundtrackPlaylistEnabled", true);
         double gapMinSec = getRegistryDouble(baseSystem, "SoundtrackGapMinSeconds", 120.0);
@@ -286,42 +938,56 @@ namespace SoundtrackSystemLogic {
         double dtSec = (std::isfinite(dt) && dt > 0.0f) ? static_cast<double>(dt) : 0.0;
 
         if (!playlistEnabled) {
-            loadTrack(audio.headTrackPath, audio.headTrackBuffer, audio.headTrackSampleRate, audio.headTrackPos,
-                      "head track", lastHeadPath, lastHeadError);
+            if (headJobFromPlaylist) cancelLoad(headJob);
+            headJobFromPlaylist = false;
+            requestTrack(headJob, audio.headTrackPath, true, lastHeadPath, lastHeadError);
+            if (loadFinished(headJob)) {
+                installTrack(headJob, audio.headTrack, std::make_unique<SoundtrackSlot::Track>(), "head track",
+                             lastHeadPath, lastHeadError);
+            }
             if (skipRequested) {
-                audio.headTrackActive = false;
+                audio.headTrackActive.store(false, std::memory_order_relaxed);
             }
-            wasHeadTrackPlaying = audio.headTrackActive && !audio.headTrackBuffer.empty();
+            wasHeadTrackPlaying = headTrackPlaying(audio);
             firstTrackStarted = wasHeadTrackPlaying;
             waitArmed = false;
             waitRemainingSec = 0.0;
             warnedNoTracks = false;
             return;
         }
+        if (headJob && !headJobFromPlaylist) cancelLoad(headJob);
 
         std::string desiredFolder = getRegistryString(baseSystem, "SoundtrackFolder", "Procedures/soundtrack");
         if (playlistFolder != desiredFolder) {
             playlistFolder = desiredFolder;
             playlistTracks.clear();
-            playlistRescanTimerSec = 0.0;
+            playlistListed = false;
             warnedNoTracks = false;
-            lastTrackIndex = std::numeric_limits<size_t>::max();
+            lastTrackPath.clear();
+            cancelLoad(headJob);
+            std::lock_guard<std::mutex> lock(loader.mutex);
+            loader.watchFolder = playlistFolder;
         }
-
-        playlistRescanTimerSec -= dtSec;
-        if (playlistTracks.empty() || playlistRescanTimerSec <= 0.0) {
-            scanSoundtrackFolder(playlistFolder, playlistTracks, playlistScanError);
-            playlistRescanTimerSec = 2.0;
+        {
+            // The watcher thread publishes a fresh listing whenever the folder
+            // changes on disk.
+            std::lock_guard<std::mutex> lock(loader.mutex);
+            if (loader.tracksFolder == playlistFolder && loader.tracksVersion != playlistVersion) {
+                playlistTracks = loader.tracks;
+                playlistVersion = loader.tracksVersion;
+                playlistListed = true;
+            }
         }
 
-        bool currentlyPlaying = audio.headTrackActive && !audio.headTrackBuffer.empty();
+        bool currentlyPlaying = headTrackPlaying(audio);
         if (currentlyPlaying) firstTrackStarted = true;
         bool forceStartNow = false;
 
         if (skipRequested) {
             if (currentlyPlaying) {
-                audio.headTrackActive = false;
-                audio.headTrackPos = static_cast<double>(audio.headTrackBuffer.size());
+                // A start still waiting for the callback is withdrawn too.
+                publishTrack(audio.headTrack, nullptr);
+                audio.headTrackActive.store(false, std::memory_order_relaxed);
                 currentlyPlaying = false;
             }
             waitArmed = false;
@@ -355,45 +1021,51 @@ namespace SoundtrackSystemLogic {
             }
         }
 
-        if (shouldStartTrack && !playlistTracks.empty()) {
+        if (shouldStartTrack && !headJob && !playlistTracks.empty()) {
             size_t count = playlistTracks.size();
             std::uniform_int_distribution<size_t> dist(0, count - 1);
             size_t pickIndex = dist(rng);
-            if (count > 1 && lastTrackIndex < count && pickIndex == lastTrackIndex) {
+            if (count > 1 && playlistTracks[pickIndex] == lastTrackPath) {
                 pickIndex = (pickIndex + 1 + (dist(rng) % (count - 1))) % count;
             }
+            // Decoding and rate conversion happen on the loader thread; the
+            // track starts on the frame its job finishes.
+            headJob = submitLoad(loader, playlistTracks[pickIndex], true, engineRate);
+            headJobFromPlaylist = true;
+        }
 
-            const std::string chosenTrack = playlistTracks[pickIndex];
-            audio.headTrackPath = chosenTrack;
-            loadTrack(audio.headTrackPath, audio.headTrackBuffer, audio.headTrackSampleRate, audio.headTrackPos,
-                      "head track", lastHeadPath, lastHeadError);
-
-            bool loaded = (lastHeadPath == chosenTrack)
-                && !audio.headTrackBuffer.empty()
-                && audio.headTrackSampleRate > 0;
+        if (loadFinished(headJob)) {
+            const std::string chosenTrack = headJob->path;
+            auto track = std::make_unique<SoundtrackSlot::Track>();
+            track->start = true;
+            track->gain = static_cast<float>(soundtrackGain);
+            track->loop = false;
+            bool loaded = installTrack(headJob, audio.headTrack, std::move(track), "head track",
+                                       lastHeadPath, lastHeadError);
             if (!loaded) {
-                playlistTracks.erase(playlistTracks.begin() + static_cast<std::ptrdiff_t>(pickIndex));
-                if (lastTrackIndex >= playlistTracks.size()) {
-                    lastTrackIndex = std::numeric_limits<size_t>::max();
-                }
+                playlistTracks.erase(std::remove(playlistTracks.begin(), playlistTracks.end(), chosenTrack),
+                                     playlistTracks.end());
             } else {
-                audio.headTrackPos = 0.0;
-                audio.headTrackGain = static_cast<float>(soundtrackGain);
-                audio.headTrackLoop = false;
-                audio.headTrackActive = true;
+                audio.headTrackPath = chosenTrack;
                 firstTrackStarted = true;
-                lastTrackIndex = pickIndex;
+                lastTrackPath = chosenTrack;
                 warnedNoTracks = false;
                 std::cout << "SoundtrackSystem: playing '" << chosenTrack << "'." << std::endl;
             }
         }
 
-        if (!currentlyPlaying && playlistTracks.empty() && !warnedNoTracks) {
+        if (!currentlyPlaying && !headJob && playlistListed && playlistTracks.empty() && !warnedNoTracks) {
             std::cerr << "SoundtrackSystem: no soundtrack WAV files found in '"
                       << playlistFolder << "'." << std::endl;
             warnedNoTracks = true;
         }
 
-        wasHeadTrackPlaying = audio.headTrackActive && !audio.headTrackBuffer.empty();
+        wasHeadTrackPlaying = headTrackPlaying(audio);
+    }
+
+    void CleanupSoundtracks(BaseSystem& baseSystem, std::vector<Entity>&, float, GLFWwindow*) {
+        if (!baseSystem.audio) return;
+        // Cancels any in-flight decode and joins the loader threads.
+        baseSystem.audio->soundtrackLoader.reset();
     }
 }
@@ -0,0 +1,454 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "json.hpp"
+
+// Binary twin of the palette_rle_v1 structure JSON ("VSTB"). Cells are
+// ordered x-fastest, then y, then z -- the VoxelSection layout -- so a run
+// maps onto whole section rows. Levels past the first are optional mips built
+// with the voxel world's majority rule, treating everything outside the
+// structure as empty.
+//
+// File layout (little-endian, varints are LEB128):
+//   u32 magic, u32 version, i32 min[3], str id, str world,
+//   varint paletteCount, { str prototype, f32 color[3] } * paletteCount,
+//   varint levelCount, { i32 size[3], varint runCount,
+//                        { varint count, varint palette + 1 } * runCount } * levelCount
+// where str is a varint length followed by the bytes. Palette 0 on disk is an
+// empty cell.
+namespace StructureBinary {
+
+    constexpr uint32_t kMagic = 0x42545356u; // "VSTB"
+    constexpr uint32_t kVersion = 1;
+    constexpr int32_t kEmpty = -1;
+    constexpr int kDefaultMipLevels = 4;
+    constexpr size_t kMaxCells = size_t(1) << 30;
+
+    struct PaletteEntry {
+        std::string prototype;
+        glm::vec3 color{1.0f};
+    };
+
+    struct Run {
+        uint32_t count = 0;
+        int32_t palette = kEmpty;
+    };
+
+    struct Level {
+        glm::ivec3 size{0};
+        std::vector<Run> runs;
+    };
+
+    struct Structure {
+        std::string id;
+        std::string world;
+        glm::ivec3 minCorner{0};
+        std::vector<PaletteEntry> palette;
+        std::vector<Level> levels; // [0] full resolution, [n] mip n
+
+        glm::ivec3 size() const { return levels.empty() ? glm::ivec3(0) : levels[0].size; }
+    };
+
+    inline size_t cellCount(const glm::ivec3& dims) {
+        if (dims.x <= 0 || dims.y <= 0 || dims.z <= 0) return 0;
+        return static_cast<size_t>(dims.x) * static_cast<size_t>(dims.y) * static_cast<size_t>(dims.z);
+    }
+
+    inline size_t cellIndex(const glm::ivec3& local, const glm::ivec3& dims) {
+        return static_cast<size_t>(local.x)
+            + static_cast<size_t>(dims.x) * (static_cast<size_t>(local.y) + static_cast<size_t>(dims.y) * static_cast<size_t>(local.z));
+    }
+
+    inline std::filesystem::path binaryPathFor(const std::filesystem::path& jsonPath) {
+        std::filesystem::path out(jsonPath);
+        out.replace_extension(".vstb");
+        return out;
+    }
+
+    inline std::vector<Run> encodeRuns(const std::vector<int32_t>& cells) {
+        std::vector<Run> runs;
+        for (int32_t value : cells) {
+            if (!runs.empty() && runs.back().palette == value) {
+                runs.back().count += 1;
+            } else {
+                runs.push_back({1u, value});
+            }
+        }
+        return runs;
+    }
+
+    // Expands runs into `total` cells; missing tail cells stay empty and extra
+    // run data is dropped. Returns false if the run total was not `total`.
+    inline bool decodeRuns(const std::vector<Run>& runs, size_t total, std::vector<int32_t>& cells) {
+        cells.assign(total, kEmpty);
+        size_t cursor = 0;
+        for (const Run& run : runs) {
+            if (cursor >= total) return false;
+            size_t count = std::min(static_cast<size_t>(run.count), total - cursor);
+            std::fill(cells.begin() + static_cast<std::ptrdiff_t>(cursor),
+                      cells.begin() + static_cast<std::ptrdiff_t>(cursor + count), run.palette);
+            cursor += count;
+            if (count != run.count) return false;
+        }
+        return cursor == total;
+    }
+
+    // Rebuilds levels[1..] from levels[0]. Each mip cell takes the prototype
+    // held by most of its eight children (first to lead wins a tie) and the
+    // palette entry of the first child carrying it, as VoxelWorldContext does.
+    inline void buildMips(Structure& s, int maxLevels = kDefaultMipLevels) {
+        if (s.levels.empty()) return;
+        s.levels.resize(1);
+        auto isSolid = [&](int32_t p) {
+            return p >= 0 && p < static_cast<int32_t>(s.palette.size()) && !s.palette[static_cast<size_t>(p)].prototype.empty();
+        };
+        std::vector<int32_t> child;
+        decodeRuns(s.levels[0].runs, cellCount(s.levels[0].size), child);
+        glm::ivec3 childDims = s.levels[0].size;
+        for (int level = 1; level <= maxLevels; ++level) {
+            if (childDims.x <= 1 && childDims.y <= 1 && childDims.z <= 1) break;
+            glm::ivec3 dims = (childDims + glm::ivec3(1)) / 2;
+            std::vector<int32_t> parent(cellCount(dims), kEmpty);
+            for (int z = 0; z < dims.z; ++z) {
+                for (int y = 0; y < dims.y; ++y) {
+                    for (int x = 0; x < dims.x; ++x) {
+                        int32_t samples[8];
+                        int s8 = 0;
+                        for (int dz = 0; dz < 2; ++dz) {
+                            for (int dy = 0; dy < 2; ++dy) {
+                                for (int dx = 0; dx < 2; ++dx) {
+                                    glm::ivec3 c(x * 2 + dx, y * 2 + dy, z * 2 + dz);
+                                    int32_t p = kEmpty;
+                                    if (c.x < childDims.x && c.y < childDims.y && c.z < childDims.z) {
+                                        p = child[cellIndex(c, childDims)];
+                                    }
+                                    samples[s8++] = isSolid(p) ? p : kEmpty;
+                                }
+                            }
+                        }
+                        const std::string* best = nullptr;
+                        int bestCount = 0;
+                        for (int i = 0; i < 8; ++i) {
+                            if (samples[i] == kEmpty) continue;
+                            const std::string& name = s.palette[static_cast<size_t>(samples[i])].prototype;
+                            int count = 0;
+                            for (int j = 0; j <= i; ++j) {
+                                if (samples[j] != kEmpty && s.palette[static_cast<size_t>(samples[j])].prototype == name) count += 1;
+                            }
+                            if (count > bestCount) {
+                                bestCount = count;
+                                best = &name;
+                            }
+                        }
+                        if (!best) continue;
+                        for (int i = 0; i < 8; ++i) {
+                            if (samples[i] != kEmpty && s.palette[static_cast<size_t>(samples[i])].prototype == *best) {
+                                parent[cellIndex(glm::ivec3(x, y, z), dims)] = samples[i];
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            s.levels.push_back({dims, encodeRuns(parent)});
+            child.swap(parent);
+            childDims = dims;
+        }
+    }
+
+    namespace detail {
+        inline void putU32(std::vector<uint8_t>& out, uint32_t v) {
+            for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+        }
+
+        inline void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<uint8_t>(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(v));
+        }
+
+        inline void putString(std::vector<uint8_t>& out, const std::string& s) {
+            putVarint(out, s.size());
+            out.insert(out.end(), s.begin(), s.end());
+        }
+
+        inline void putFloat(std::vector<uint8_t>& out, float f) {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &f, sizeof(bits));
+            putU32(out, bits);
+        }
+
+        struct Reader {
+            const uint8_t* data = nullptr;
+            size_t size = 0;
+            size_t pos = 0;
+            bool ok = true;
+
+            uint32_t u32() {
+                if (size - pos < 4) { ok = false; return 0; }
+                uint32_t v = 0;
+                for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(data[pos + i]) << (i * 8);
+                pos += 4;
+                return v;
+            }
+
+            uint64_t varint() {
+                uint64_t v = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    if (pos >= size) break;
+                    uint8_t b = data[pos++];
+                    v |= static_cast<uint64_t>(b & 0x7f) << shift;
+                    if ((b & 0x80) == 0) return v;
+                }
+                ok = false;
+                return 0;
+            }
+
+            std::string string() {
+                uint64_t len = varint();
+                if (!ok || len > size - pos) { ok = false; return {}; }
+                std::string s(reinterpret_cast<const char*>(data + pos), static_cast<size_t>(len));
+                pos += static_cast<size_t>(len);
+                return s;
+            }
+
+            float f32() {
+                uint32_t bits = u32();
+                float f = 0.0f;
+                std::memcpy(&f, &bits, sizeof(f));
+                return f;
+            }
+        };
+    }
+
+    inline std::vector<uint8_t> encode(const Structure& s) {
+        std::vector<uint8_t> out;
+        detail::putU32(out, kMagic);
+        detail::putU32(out, kVersion);
+        for (int i = 0; i < 3; ++i) detail::putU32(out, static_cast<uint32_t>(s.minCorner[i]));
+        detail::putString(out, s.id);
+        detail::putString(out, s.world);
+        detail::putVarint(out, s.palette.size());
+        for (const PaletteEntry& entry : s.palette) {
+            detail::putString(out, entry.prototype);
+            for (int i = 0; i < 3; ++i) detail::putFloat(out, entry.color[i]);
+        }
+        detail::putVarint(out, s.levels.size());
+        for (const Level& level : s.levels) {
+            for (int i = 0; i < 3; ++i) detail::putU32(out, static_cast<uint32_t>(level.size[i]));
+            detail::putVarint(out, level.runs.size());
+            for (const Run& run : level.runs) {
+                detail::putVarint(out, run.count);
+                detail::putVarint(out, static_cast<uint64_t>(static_cast<int64_t>(run.palette) + 1));
+            }
+        }
+        return out;
+    }
+
+    inline bool decode(const uint8_t* data, size_t size, Structure& s, std::string& error) {
+        detail::Reader r{data, size};
+        s = Structure{};
+        if (r.u32() != kMagic || !r.ok) { error = "not a structure binary"; return false; }
+        uint32_t version = r.u32();
+        if (version != kVersion) { error = "unsupported version " + std::to_string(version); return false; }
+        for (int i = 0; i < 3; ++i) s.minCorner[i] = static_cast<int32_t>(r.u32());
+        s.id = r.string();
+        s.world = r.string();
+        uint64_t paletteCount = r.varint();
+        if (!r.ok || paletteCount > size) { error = "bad palette"; return false; }
+        s.palette.resize(static_cast<size_t>(paletteCount));
+        for (PaletteEntry& entry : s.palette) {
+            entry.prototype = r.string();
+            for (int i = 0; i < 3; ++i) entry.color[i] = r.f32();
+        }
+        uint64_t levelCount = r.varint();
+        if (!r.ok || levelCount == 0 || levelCount > 32) { error = "bad level count"; return false; }
+        s.levels.resize(static_cast<size_t>(levelCount));
+        for (Level& level : s.levels) {
+            for (int i = 0; i < 3; ++i) level.size[i] = static_cast<int32_t>(r.u32());
+            size_t cells = cellCount(level.size);
+            if (!r.ok || cells == 0 || cells > kMaxCells) { error = "bad level size"; return false; }
+            uint64_t runCount = r.varint();
+            if (!r.ok || runCount > size - r.pos || runCount > cells) { error = "bad run count"; return false; }
+            level.runs.resize(static_cast<size_t>(runCount));
+            for (Run& run : level.runs) {
+                uint64_t count = r.varint();
+                uint64_t palette = r.varint();
+                if (!r.ok || count > cells || palette > paletteCount) { error = "bad run"; return false; }
+                run.count = static_cast<uint32_t>(count);
+                run.palette = static_cast<int32_t>(palette) - 1;
+            }
+        }
+        if (!r.ok) { error = "truncated"; return false; }
+        return true;
+    }
+
+    inline bool saveFile(const std::filesystem::path& path, const Structure& s, std::string& error) {
+        std::vector<uint8_t> bytes = encode(s);
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (!f.is_open()) { error = "cannot write " + path.string(); return false; }
+        f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!f) { error = "write failed for " + path.string(); return false; }
+        return true;
+    }
+
+    inline bool loadFile(const std::filesystem::path& path, Structure& s, std::string& error) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f.is_open()) { error = "cannot read " + path.string(); return false; }
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        return decode(bytes.data(), bytes.size(), s, error);
+    }
+
+    namespace detail {
+        inline glm::ivec3 vecFromJson(const nlohmann::json& arr) {
+            if (!arr.is_array() || arr.size() != 3) return glm::ivec3(0);
+            return glm::ivec3(arr[0].get<int>(), arr[1].get<int>(), arr[2].get<int>());
+        }
+
+        inline glm::vec3 colorFromJson(const nlohmann::json& entry) {
+            glm::vec3 color(1.0f);
+            if (entry.contains("color")) {
+                const auto& c = entry["color"];
+                if (c.is_array() && c.size() == 3) {
+                    color = glm::vec3(c[0].get<float>(), c[1].get<float>(), c[2].get<float>());
+                }
+            }
+            return color;
+        }
+    }
+
+    // Accepts palette_rle_v1 (runs over y, then x, then z-fastest cells) and
+    // the older per-block "blocks" list. Level 0 only; call buildMips after.
+    inline bool fromJson(const nlohmann::json& data, Structure& s, std::string& error) {
+        s = Structure{};
+        s.id = data.value("id", "");
+        s.world = data.value("world", "");
+        glm::ivec3 dims(0);
+        if (data.contains("bounds")) {
+            const auto& bounds = data["bounds"];
+            if (bounds.contains("min")) s.minCorner = detail::vecFromJson(bounds["min"]);
+            if (bounds.contains("size")) dims = detail::vecFromJson(bounds["size"]);
+        }
+        if (data.contains("size")) dims = detail::vecFromJson(data["size"]);
+
+        if (data.contains("runs") && data.contains("palette")) {
+            const size_t total = cellCount(dims);
+            if (total == 0 || total > kMaxCells) { error = "bad size"; return false; }
+            for (const auto& entry : data["palette"]) {
+                s.palette.push_back({entry.value("prototype", ""), detail::colorFromJson(entry)});
+            }
+            const int32_t paletteCount = static_cast<int32_t>(s.palette.size());
+            std::vector<int32_t> cells(total, kEmpty);
+            size_t cursor = 0;
+            int x = 0, y = 0, z = 0;
+            for (const auto& run : data["runs"]) {
+                int32_t palette = run.value("palette", -1);
+                int count = run.value("count", 0);
+                if (palette < 0 || palette >= paletteCount) palette = kEmpty;
+                for (int i = 0; i < count && cursor < total; ++i, ++cursor) {
+                    cells[cellIndex(glm::ivec3(x, y, z), dims)] = palette;
+                    if (++z == dims.z) {
+                        z = 0;
+                        if (++x == dims.x) { x = 0; ++y; }
+                    }
+                }
+            }
+            if (cursor < total) error = "run data shorter than expected";
+            s.levels.push_back({dims, encodeRuns(cells)});
+            return true;
+        }
+
+        if (data.contains("blocks")) {
+            const auto& blocks = data["blocks"];
+            if (cellCount(dims) == 0) {
+                for (const auto& entry : blocks) {
+                    if (entry.contains("offset")) dims = glm::max(dims, detail::vecFromJson(entry["offset"]) + glm::ivec3(1));
+                }
+            }
+            const size_t total = cellCount(dims);
+            if (total == 0 || total > kMaxCells) { error = "bad size"; return false; }
+            std::vector<int32_t> cells(total, kEmpty);
+            std::map<std::tuple<std::string, float, float, float>, int32_t> paletteLookup;
+            for (const auto& entry : blocks) {
+                std::string name = entry.value("prototype", "");
+                if (name.empty() || !entry.contains("offset")) continue;
+                glm::ivec3 offset = detail::vecFromJson(entry["offset"]);
+                if (offset.x < 0 || offset.y < 0 || offset.z < 0) continue;
+                if (offset.x >= dims.x || offset.y >= dims.y || offset.z >= dims.z) continue;
+                glm::vec3 color = detail::colorFromJson(entry);
+                auto key = std::make_tuple(name, color.x, color.y, color.z);
+                auto it = paletteLookup.find(key);
+                if (it == paletteLookup.end()) {
+                    it = paletteLookup.emplace(key, static_cast<int32_t>(s.palette.size())).first;
+                    s.palette.push_back({name, color});
+                }
+                cells[cellIndex(offset, dims)] = it->second;
+            }
+            s.levels.push_back({dims, encodeRuns(cells)});
+            return true;
+        }
+
+        error = "no usable data";
+        return false;
+    }
+
+    inline nlohmann::json toJson(const Structure& s) {
+        using nlohmann::json;
+        const glm::ivec3 dims = s.size();
+        std::vector<int32_t> cells;
+        if (!s.levels.empty()) decodeRuns(s.levels[0].runs, cellCount(dims), cells);
+
+        json runsJson = json::array();
+        int32_t current = kEmpty;
+        int count = 0;
+        for (int y = 0; y < dims.y; ++y) {
+            for (int x = 0; x < dims.x; ++x) {
+                for (int z = 0; z < dims.z; ++z) {
+                    int32_t value = cells[cellIndex(glm::ivec3(x, y, z), dims)];
+                    if (count > 0 && value != current) {
+                        runsJson.push_back({{"palette", current}, {"count", count}});
+                        count = 0;
+                    }
+                    current = value;
+                    count += 1;
+                }
+            }
+        }
+        if (count > 0) runsJson.push_back({{"palette", current}, {"count", count}});
+
+        json paletteJson = json::array();
+        for (const PaletteEntry& entry : s.palette) {
+            paletteJson.push_back({
+                {"prototype", entry.prototype},
+                {"color", { entry.color.x, entry.color.y, entry.color.z }}
+            });
+        }
+
+        json output;
+        output["format"] = "palette_rle_v1";
+        output["id"] = s.id;
+        output["world"] = s.world;
+        output["bounds"] = {
+            {"min", {s.minCorner.x, s.minCorner.y, s.minCorner.z}},
+            {"size", {dims.x, dims.y, dims.z}}
+        };
+        output["size"] = { dims.x, dims.y, dims.z };
+        output["palette"] = paletteJson;
+        output["runs"] = runsJson;
+        return output;
+    }
+}
@@ -4,21 +4,29 @@
 #include <unordered_map>
 #include <fstream>
 #include <vector>
-#include <sstream>
-#include <iomanip>
+#include <cstring>
 #include <glm/glm.hpp>
 
+#include "BaseSystem/StructureBinary.h"
+
 namespace HostLogic { const Entity* findPrototype(const std::string& name, const std::vector<Entity>& prototypes); EntityInstance CreateInstance(BaseSystem& baseSystem, int prototypeID, glm::vec3 position, glm::vec3 color); }
 namespace BlockSelectionSystemLogic { void EnsureAllCaches(BaseSystem& baseSystem, const std::vector<Entity>& prototypes); void AddBlockToCache(BaseSystem& baseSystem, std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position, int prototypeID); }
 
 namespace StructureCaptureSystemLogic {
 
-    struct IVec3Hash {
-        std::size_t operator()(const glm::ivec3& v) const noexcept {
-            std::size_t hx = std::hash<int>()(v.x);
-            std::size_t hy = std::hash<int>()(v.y);
-            std::size_t hz = std::hash<int>()(v.z);
-            return hx ^ (hy << 1) ^ (hz << 2);
+    struct PaletteKey {
+        int prototypeID = -1;
+        uint32_t color[3] = {0, 0, 0};
+        bool operator==(const PaletteKey& other) const noexcept {
+            return prototypeID == other.prototypeID && std::memcmp(color, other.color, sizeof(color)) == 0;
+        }
+    };
+
+    struct PaletteKeyHash {
+        std::size_t operator()(const PaletteKey& key) const noexcept {
+            uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(key.prototypeID)) * 0x9E3779B185EBCA87ull;
+            for (uint32_t c : key.color) h = (h ^ c) * 0xC2B2AE3D27D4EB4Full;
+            return static_cast<std::size_t>(h ^ (h >> 29));
         }
     };
 
@@ -128,6 +136,7 @@ namespace StructureCaptureSystemLogic {
                     for (int z = 0; z < bench.size.z; ++z) {
                         glm::vec3 pos = glm::vec3(bench.minCorner.x + x, y, bench.minCorner.z + z);
                         world.instances.push_back(HostLogic::CreateInstance(baseSystem, scaffoldProto->prototypeID, pos, g_scaffoldColor));
+                        world.instanceEdits += 1;
                         BlockSelectionSystemLogic::AddBlockToCache(baseSystem, prototypes, bench.worldIndex, pos, scaffoldProto->prototypeID);
                     }
                 }
@@ -147,105 +156,50 @@ namespace StructureCaptureSystemLogic {
 
             glm::ivec3 dims = bench.size;
             if (dims.x <= 0 || dims.y <= 0 || dims.z <= 0) return;
-            const int totalCells = dims.x * dims.y * dims.z;
+            const size_t totalCells = StructureBinary::cellCount(dims);
 
-            struct BlockInfo { std::string prototype; glm::vec3 color; };
-            std::unordered_map<glm::ivec3, BlockInfo, IVec3Hash> blockMap;
-            for (const auto& inst : world.instances) {
+            // Last mutable block instance filed under each cell, x-fastest.
+            std::vector<int32_t> occupant(totalCells, -1);
+            for (size_t i = 0; i < world.instances.size(); ++i) {
+                const EntityInstance& inst = world.instances[i];
                 if (inst.prototypeID < 0 || inst.prototypeID >= static_cast<int>(prototypes.size())) continue;
                 const Entity& proto = prototypes[inst.prototypeID];
                 if (!proto.isBlock || !proto.isMutable) continue;
                 glm::ivec3 cell = glm::ivec3(glm::round(inst.position));
                 if (!contains(bench, cell)) continue;
-                blockMap[cell] = { proto.name, inst.color };
+                occupant[StructureBinary::cellIndex(cell - bench.minCorner, dims)] = static_cast<int32_t>(i);
             }
 
-            auto paletteKey = [](const std::string& proto, const glm::vec3& color) {
-                std::ostringstream oss;
-                oss << proto << "|" << std::fixed << std::setprecision(6)
-                    << color.x << "," << color.y << "," << color.z;
-                return oss.str();
-            };
-
-            std::unordered_map<std::string, int> paletteLookup;
-            struct PaletteEntry { std::string prototype; glm::vec3 color; };
-            std::vector<PaletteEntry> palette;
-            auto getPaletteIndex = [&](const std::string& proto, const glm::vec3& color) {
-                std::string key = paletteKey(proto, color);
-                auto it = paletteLookup.find(key);
-                if (it != paletteLookup.end()) return it->second;
-                int idx = static_cast<int>(palette.size());
-                paletteLookup[key] = idx;
-                palette.push_back({ proto, color });
-                return idx;
-            };
-
-            std::vector<int> stream;
-            stream.reserve(totalCells);
+            StructureBinary::Structure structure;
+            structure.id = bench.id;
+            structure.world = bench.worldName;
+            structure.minCorner = bench.minCorner;
+            std::unordered_map<PaletteKey, int32_t, PaletteKeyHash> paletteLookup;
+            std::vector<int32_t> cells(totalCells, StructureBinary::kEmpty);
+            // Palette indices are handed out in the JSON's y, x, z scan order
+            // so re-exports keep their palette order.
             for (int y = 0; y < dims.y; ++y) {
                 for (int x = 0; x < dims.x; ++x) {
                     for (int z = 0; z < dims.z; ++z) {
-                        glm::ivec3 cell = bench.minCorner + glm::ivec3(x, y, z);
-                        auto it = blockMap.find(cell);
-                        if (it != blockMap.end()) {
-                            stream.push_back(getPaletteIndex(it->second.prototype, it->second.color));
-                        } else {
-                            stream.push_back(-1);
+                        const size_t index = StructureBinary::cellIndex(glm::ivec3(x, y, z), dims);
+                        if (occupant[index] < 0) continue;
+                        const EntityInstance& inst = world.instances[static_cast<size_t>(occupant[index])];
+                        PaletteKey key;
+                        key.prototypeID = inst.prototypeID;
+                        std::memcpy(key.color, &inst.color[0], sizeof(key.color));
+                        auto [it, inserted] = paletteLookup.emplace(key, static_cast<int32_t>(structure.palette.size()));
+                        if (inserted) {
+                            structure.palette.push_back({ prototypes[inst.prototypeID].name, inst.color });
                         }
+                        cells[index] = it->second;
                     }
                 }
             }
-
-            struct Run { int paletteIndex; int count; };
-            std::vector<Run> runs;
-            if (!stream.empty()) {
-                int current = stream[0];
-                int count = 1;
-                for (size_t i = 1; i < stream.size(); ++i) {
-                    if (stream[i] == current) {
-                        count++;
-                    } else {
-                        runs.push_back({ current, count });
-                        current = stream[i];
-                        count = 1;
-                    }
-                }
-                runs.push_back({ current, count });
-            }
-
-            json output;
-            output["format"] = "palette_rle_v1";
-            output["id"] = bench.id;
-            output["world"] = bench.worldName;
-            output["bounds"] = {
-                {"min", {bench.minCorner.x, bench.minCorner.y, bench.minCorner.z}},
-                {"size", {bench.size.x, bench.size.y, bench.size.z}}
-            };
-            output["size"] = { dims.x, dims.y, dims.z };
-
-            json paletteJson = json::array();
-            for (const auto& entry : palette) {
-                paletteJson.push_back({
-                    {"prototype", entry.prototype},
-                    {"color", { entry.color.x, entry.color.y, entry.color.z }}
-                });
-            }
-            output["palette"] = paletteJson;
-
-            json runsJson = json::array();
-            for (const auto& run : runs) {
-                runsJson.push_back({
-                    {"palette", run.paletteIndex},
-                    {"count", run.count}
-                });
-            }
-            output["runs"] = runsJson;
+            structure.levels.push_back({ dims, StructureBinary::encodeRuns(cells) });
+            StructureBinary::buildMips(structure);
 
             try {
                 fs::path outPath(bench.outputPath);
-                if (outPath.is_relative()) {
-                    outPath = fs::path(bench.outputPath);
-                }
                 if (outPath.has_parent_path()) {
                     fs::create_directories(outPath.parent_path());
                 }
@@ -253,7 +207,12 @@ namespace StructureCaptureSystemLogic {
                 if (!ofs.is_open()) {
                     std::cerr << "StructureCaptureSystem: Failed to write " << outPath << "\n";
                 } else {
-                    ofs << output.dump(2);
+                    ofs << StructureBinary::toJson(structure).dump(2);
+                    ofs.close();
+                    std::string error;
+                    if (!StructureBinary::saveFile(StructureBinary::binaryPathFor(outPath), structure, error)) {
+                        std::cerr << "StructureCaptureSystem: " << error << "\n";
+                    }
                 }
             } catch (const std::exception& e) {
                 std::cerr << "StructureCaptureSystem: export error (" << e.what() << ")\n";
@@ -4,11 +4,16 @@
 #include <fstream>
 #include <vector>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
+#include "BaseSystem/StructureBinary.h"
+
 namespace HostLogic { const Entity* findPrototype(const std::string& name, const std::vector<Entity>& prototypes); EntityInstance CreateInstance(BaseSystem& baseSystem, int prototypeID, glm::vec3 position, glm::vec3 color); }
 namespace BlockSelectionSystemLogic { void RemoveBlockFromCache(BaseSystem& baseSystem, const std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position); void AddBlockToCache(BaseSystem& baseSystem, std::vector<Entity>& prototypes, int worldIndex, const glm::vec3& position, int prototypeID); }
+namespace VoxelMeshingSystemLogic { void RequestPriorityVoxelRemesh(BaseSystem& baseSystem, std::vector<Entity>& prototypes, const glm::ivec3& worldCell); }
 
 namespace StructurePlacementSystemLogic {
 
@@ -27,6 +32,14 @@ namespace StructurePlacementSystemLogic {
 
     namespace fs = std::filesystem;
 
+    // Decoded structures keyed by output path, reused until the file changes.
+    struct CachedStructure {
+        fs::file_time_type stamp{};
+        StructureBinary::Structure data;
+        bool valid = false;
+    };
+    static std::unordered_map<std::string, CachedStructure> g_structureCache;
+
     namespace {
         glm::ivec3 vecFromJson(const json& arr) {
             if (!arr.is_array() || arr.size() != 3) return glm::ivec3(0);
@@ -98,6 +111,7 @@ namespace StructurePlacementSystemLogic {
             LevelContext& level = *baseSystem.level;
             Entity& world = level.worlds[bench.worldIndex];
             auto& instances = world.instances;
+            const size_t before = instances.size();
             instances.erase(std::remove_if(instances.begin(), instances.end(),
                 [&](const EntityInstance& inst) {
                     if (inst.prototypeID < 0 || inst.prototypeID >= static_cast<int>(prototypes.size())) return false;
@@ -108,15 +122,92 @@ namespace StructurePlacementSystemLogic {
                     BlockSelectionSystemLogic::RemoveBlockFromCache(baseSystem, prototypes, bench.worldIndex, inst.position);
                     return true;
                 }), instances.end());
+            if (instances.size() != before) world.instanceEdits += 1;
+        }
+
+        uint32_t packColor(const glm::vec3& color) {
+            auto clampByte = [](float v) {
+                int iv = static_cast<int>(std::round(v * 255.0f));
+                if (iv < 0) iv = 0;
+                if (iv > 255) iv = 255;
+                return static_cast<uint32_t>(iv);
+            };
+            uint32_t r = clampByte(color.r);
+            uint32_t g = clampByte(color.g);
+            uint32_t b = clampByte(color.b);
+            return (r << 16) | (g << 8) | b;
         }
 
-        glm::ivec3 coordFromIndex(int index, const glm::ivec3& dims) {
-            int layerSize = dims.x * dims.z;
-            int y = index / layerSize;
-            int rem = index % layerSize;
-            int x = rem / dims.z;
-            int z = rem % dims.z;
-            return glm::ivec3(x, y, z);
+        // A JSON structure is read through its .vstb sibling when that is at
+        // least as new; otherwise the JSON is converted and the sibling
+        // rewritten so the next load skips the parse.
+        const StructureBinary::Structure* loadStructure(const fs::path& path) {
+            std::error_code ec;
+            fs::file_time_type stamp = fs::last_write_time(path, ec);
+            if (ec) return nullptr;
+            CachedStructure& cached = g_structureCache[path.string()];
+            if (cached.valid && cached.stamp == stamp) return &cached.data;
+            cached.valid = false;
+
+            std::string error;
+            if (path.extension() == ".vstb") {
+                if (!StructureBinary::loadFile(path, cached.data, error)) {
+                    std::cerr << "StructurePlacementSystem: invalid structure file " << path << " (" << error << ")\n";
+                    return nullptr;
+                }
+            } else {
+                fs::path binPath = StructureBinary::binaryPathFor(path);
+                fs::file_time_type binStamp = fs::last_write_time(binPath, ec);
+                bool loaded = !ec && binStamp >= stamp && StructureBinary::loadFile(binPath, cached.data, error);
+                if (!loaded) {
+                    std::ifstream f(path);
+                    if (!f.is_open()) {
+                        std::cerr << "StructurePlacementSystem: cannot read " << path << "\n";
+                        return nullptr;
+                    }
+                    json data;
+                    try {
+                        data = json::parse(f);
+                    } catch (const std::exception& e) {
+                        std::cerr << "StructurePlacementSystem: invalid structure file (" << e.what() << ")\n";
+                        return nullptr;
+                    }
+                    error.clear();
+                    if (!StructureBinary::fromJson(data, cached.data, error)) {
+                        std::cerr << "StructurePlacementSystem: " << error << " in " << path << "\n";
+                        return nullptr;
+                    }
+                    if (!error.empty()) {
+                        std::cerr << "StructurePlacementSystem: " << error << " in " << path << "\n";
+                    }
+                    StructureBinary::buildMips(cached.data);
+                    if (!StructureBinary::saveFile(binPath, cached.data, error)) {
+                        std::cerr << "StructurePlacementSystem: " << error << "\n";
+                    }
+                }
+            }
+            cached.stamp = stamp;
+            cached.valid = true;
+            return &cached.data;
+        }
+
+        // Walks `count` cells of an x-fastest grid from `cursor` one row span
+        // at a time, calling fn(rowStart, length).
+        template <typename Fn>
+        void forEachRowSpan(glm::ivec3& cursor, const glm::ivec3& dims, uint32_t count, Fn&& fn) {
+            while (count > 0) {
+                int span = static_cast<int>(std::min<uint32_t>(count, static_cast<uint32_t>(dims.x - cursor.x)));
+                fn(cursor, span);
+                cursor.x += span;
+                count -= static_cast<uint32_t>(span);
+                if (cursor.x == dims.x) {
+                    cursor.x = 0;
+                    if (++cursor.y == dims.y) {
+                        cursor.y = 0;
+                        ++cursor.z;
+                    }
+                }
+            }
         }
 
         void placeBlocks(BaseSystem& baseSystem, std::vector<Entity>& prototypes, BenchDef& bench) {
@@ -125,98 +216,136 @@ namespace StructurePlacementSystemLogic {
             Entity& world = level.worlds[bench.worldIndex];
 
             fs::path outPath(bench.outputPath);
-            if (outPath.is_relative()) {
-                outPath = fs::path(bench.outputPath);
-            }
             if (!fs::exists(outPath)) {
                 bench.loaded = true;
                 return;
             }
 
-            std::ifstream f(outPath);
-            if (!f.is_open()) {
-                std::cerr << "StructurePlacementSystem: cannot read " << outPath << "\n";
+            const StructureBinary::Structure* structure = loadStructure(outPath);
+            if (!structure || structure->levels.empty()) {
+                std::cerr << "StructurePlacementSystem: no usable data found for " << bench.id << "\n";
                 bench.loaded = true;
                 return;
             }
+            const glm::ivec3 dims = structure->size();
+            const size_t totalCells = StructureBinary::cellCount(dims);
 
-            json data;
-            try {
-                data = json::parse(f);
-            } catch (const std::exception& e) {
-                std::cerr << "StructurePlacementSystem: invalid structure file (" << e.what() << ")\n";
-                bench.loaded = true;
-                return;
+            // Chunkable prototypes go into voxel sections when the voxel world
+            // is live, the rest become block instances, as BuildSystem does.
+            VoxelWorldContext* voxelWorld = (baseSystem.voxelWorld && baseSystem.voxelWorld->enabled)
+                ? baseSystem.voxelWorld.get() : nullptr;
+            struct ResolvedEntry {
+                int prototypeID = -1;
+                bool voxel = false;
+                uint32_t packedColor = 0;
+            };
+            std::vector<ResolvedEntry> palette(structure->palette.size());
+            bool allVoxel = voxelWorld != nullptr;
+            for (size_t i = 0; i < palette.size(); ++i) {
+                const StructureBinary::PaletteEntry& entry = structure->palette[i];
+                if (entry.prototype.empty()) continue;
+                const Entity* proto = HostLogic::findPrototype(entry.prototype, prototypes);
+                if (!proto) {
+                    allVoxel = false;
+                    continue;
+                }
+                palette[i].prototypeID = proto->prototypeID;
+                palette[i].voxel = voxelWorld && proto->isChunkable;
+                palette[i].packedColor = packColor(entry.color);
+                if (!palette[i].voxel) allVoxel = false;
             }
+            auto resolve = [&](int32_t index) -> const ResolvedEntry* {
+                if (index < 0 || index >= static_cast<int32_t>(palette.size())) return nullptr;
+                const ResolvedEntry& entry = palette[static_cast<size_t>(index)];
+                return entry.prototypeID >= 0 ? &entry : nullptr;
+            };
 
-            bool placed = false;
-
-            if (data.contains("runs") && data.contains("palette") && data.contains("size")) {
-                glm::ivec3 dims = vecFromJson(data["size"]);
-                if (dims.x > 0 && dims.y > 0 && dims.z > 0) {
-                    std::vector<std::pair<std::string, glm::vec3>> palette;
-                    for (const auto& entry : data["palette"]) {
-                        std::string protoName = entry.value("prototype", "");
-                        glm::vec3 color(1.0f);
-                        if (entry.contains("color")) {
-                            const auto& c = entry["color"];
-                            if (c.is_array() && c.size() == 3) {
-                                color = glm::vec3(c[0].get<float>(), c[1].get<float>(), c[2].get<float>());
-                            }
-                        }
-                        palette.push_back({ protoName, color });
-                    }
+            clearBenchArea(baseSystem, prototypes, bench);
 
-                    clearBenchArea(baseSystem, prototypes, bench);
-                    const int totalCells = dims.x * dims.y * dims.z;
-                    int cellIndex = 0;
-                    for (const auto& run : data["runs"]) {
-                        int paletteIndex = run.value("palette", -1);
-                        int count = run.value("count", 0);
-                        for (int i = 0; i < count && cellIndex < totalCells; ++i, ++cellIndex) {
-                            if (paletteIndex < 0 || paletteIndex >= static_cast<int>(palette.size())) continue;
-                            const auto& paletteEntry = palette[paletteIndex];
-                            if (paletteEntry.first.empty()) continue;
-                            const Entity* proto = HostLogic::findPrototype(paletteEntry.first, prototypes);
-                            if (!proto) continue;
-                            glm::ivec3 local = coordFromIndex(cellIndex, dims);
-                            glm::vec3 position = glm::vec3(bench.minCorner + local);
-                            world.instances.push_back(HostLogic::CreateInstance(baseSystem, proto->prototypeID, position, paletteEntry.second));
-                            BlockSelectionSystemLogic::AddBlockToCache(baseSystem, prototypes, bench.worldIndex, position, proto->prototypeID);
-                        }
+            size_t instanceCells = 0;
+            size_t cellIndex = 0;
+            for (const auto& run : structure->levels[0].runs) {
+                const ResolvedEntry* entry = resolve(run.palette);
+                if (entry && !entry->voxel) instanceCells += run.count;
+            }
+            world.instances.reserve(world.instances.size() + std::min(instanceCells, totalCells));
+
+            // The structure owns its whole box in the voxel world: empty and
+            // instance cells clear whatever voxel was there.
+            glm::ivec3 cursor(0);
+            for (const auto& run : structure->levels[0].runs) {
+                if (cellIndex >= totalCells) break;
+                const uint32_t count = static_cast<uint32_t>(std::min<size_t>(run.count, totalCells - cellIndex));
+                cellIndex += count;
+                const ResolvedEntry* entry = resolve(run.palette);
+                const bool asVoxel = entry && entry->voxel;
+                const bool asInstance = entry && !entry->voxel;
+                if (!voxelWorld && !asInstance) {
+                    forEachRowSpan(cursor, dims, count, [](const glm::ivec3&, int) {});
+                    continue;
+                }
+                const glm::vec3 color = asInstance ? structure->palette[static_cast<size_t>(run.palette)].color : glm::vec3(1.0f);
+                forEachRowSpan(cursor, dims, count, [&](const glm::ivec3& local, int span) {
+                    const glm::ivec3 rowStart = bench.minCorner + local;
+                    if (voxelWorld) {
+                        voxelWorld->fillRowLod(0, rowStart, span,
+                                               asVoxel ? static_cast<uint32_t>(entry->prototypeID) : 0u,
+                                               asVoxel ? entry->packedColor : 0u);
                     }
-                    if (cellIndex < totalCells) {
-                        std::cerr << "StructurePlacementSystem: run data shorter than expected for " << bench.id << "\n";
+                    if (!asInstance) return;
+                    for (int i = 0; i < span; ++i) {
+                        glm::vec3 position = glm::vec3(rowStart + glm::ivec3(i, 0, 0));
+                        world.instances.push_back(HostLogic::CreateInstance(baseSystem, entry->prototypeID, position, color));
+                        world.instanceEdits += 1;
+                        BlockSelectionSystemLogic::AddBlockToCache(baseSystem, prototypes, bench.worldIndex, position, entry->prototypeID);
                     }
-                    placed = true;
-                }
+                });
+            }
+            if (cellIndex < totalCells) {
+                std::cerr << "StructurePlacementSystem: run data shorter than expected for " << bench.id << "\n";
             }
 
-            if (!placed && data.contains("blocks")) {
-                clearBenchArea(baseSystem, prototypes, bench);
-                const auto& blocks = data["blocks"];
-                for (const auto& entry : blocks) {
-                    std::string protoName = entry.value("prototype", "");
-                    if (protoName.empty()) continue;
-                    const Entity* proto = HostLogic::findPrototype(protoName, prototypes);
-                    if (!proto) continue;
-                    glm::ivec3 offset = vecFromJson(entry["offset"]);
-                    glm::vec3 color(1.0f);
-                    if (entry.contains("color")) {
-                        const auto& c = entry["color"];
-                        if (c.is_array() && c.size() == 3) {
-                            color = glm::vec3(c[0].get<float>(), c[1].get<float>(), c[2].get<float>());
+            if (voxelWorld) {
+                // Stored mips hold when every block is a voxel and the box sits
+                // on the mip grid; coarser LODs are rebuilt from the level below.
+                int rebuildFromLod = 1;
+                if (allVoxel) {
+                    for (int lod = 1; lod < static_cast<int>(structure->levels.size()) && lod <= voxelWorld->maxLod; ++lod) {
+                        const int mask = (1 << lod) - 1;
+                        if (((bench.minCorner.x | bench.minCorner.y | bench.minCorner.z) & mask) != 0) break;
+                        if (((dims.x | dims.y | dims.z) & mask) != 0) break;
+                        const StructureBinary::Level& mip = structure->levels[static_cast<size_t>(lod)];
+                        const size_t mipCells = StructureBinary::cellCount(mip.size);
+                        const glm::ivec3 mipOrigin = bench.minCorner / (1 << lod);
+                        glm::ivec3 mipCursor(0);
+                        size_t mipIndex = 0;
+                        for (const auto& run : mip.runs) {
+                            if (mipIndex >= mipCells) break;
+                            const uint32_t count = static_cast<uint32_t>(std::min<size_t>(run.count, mipCells - mipIndex));
+                            mipIndex += count;
+                            const ResolvedEntry* entry = resolve(run.palette);
+                            forEachRowSpan(mipCursor, mip.size, count, [&](const glm::ivec3& local, int span) {
+                                voxelWorld->fillRowLod(lod, mipOrigin + local, span,
+                                                       entry ? static_cast<uint32_t>(entry->prototypeID) : 0u,
+                                                       entry ? entry->packedColor : 0u);
+                            });
                         }
+                        rebuildFromLod = lod + 1;
                     }
-                    glm::vec3 position = glm::vec3(bench.minCorner + offset);
-                    world.instances.push_back(HostLogic::CreateInstance(baseSystem, proto->prototypeID, position, color));
-                    BlockSelectionSystemLogic::AddBlockToCache(baseSystem, prototypes, bench.worldIndex, position, proto->prototypeID);
                 }
-                placed = true;
-            }
+                voxelWorld->rebuildMipsWorld(bench.minCorner, bench.minCorner + dims - glm::ivec3(1), rebuildFromLod);
 
-            if (!placed) {
-                std::cerr << "StructurePlacementSystem: no usable data found for " << bench.id << "\n";
+                const int sectionSize = voxelWorld->sectionSize > 0 ? voxelWorld->sectionSize : 64;
+                glm::ivec3 lo = bench.minCorner - glm::ivec3(1);
+                glm::ivec3 hi = bench.minCorner + dims;
+                for (int sz = VoxelMeshInitSystemLogic::FloorDivInt(lo.z, sectionSize); sz <= VoxelMeshInitSystemLogic::FloorDivInt(hi.z, sectionSize); ++sz) {
+                    for (int sy = VoxelMeshInitSystemLogic::FloorDivInt(lo.y, sectionSize); sy <= VoxelMeshInitSystemLogic::FloorDivInt(hi.y, sectionSize); ++sy) {
+                        for (int sx = VoxelMeshInitSystemLogic::FloorDivInt(lo.x, sectionSize); sx <= VoxelMeshInitSystemLogic::FloorDivInt(hi.x, sectionSize); ++sx) {
+                            glm::ivec3 requestCell = glm::ivec3(sx, sy, sz) * sectionSize + glm::ivec3(sectionSize / 2);
+                            VoxelMeshingSystemLogic::RequestPriorityVoxelRemesh(baseSystem, prototypes, requestCell);
+                        }
+                    }
+                }
             }
             bench.loaded = true;
         }
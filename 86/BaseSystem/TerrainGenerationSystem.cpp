@@ -9,8 +9,13 @@
 #include <cmath>
 #include <chrono>
 #include <limits>
+#include <thread>
 #include <glm/glm.hpp>
 
+#include "BaseSystem/CaveFieldTiles.h"
+#include "BaseSystem/OreVeinPlan.h"
+#include "BaseSystem/PrototypeTraits.h"
+
 namespace HostLogic { const Entity* findPrototype(const std::string& name, const std::vector<Entity>& prototypes); EntityInstance CreateInstance(BaseSystem& baseSystem, int prototypeID, glm::vec3 position, glm::vec3 color); }
 namespace ExpanseBiomeSystemLogic { bool SampleTerrain(const WorldContext& worldCtx, float x, float z, float& outHeight); }
 
@@ -124,8 +129,7 @@ namespace TerrainSystemLogic {
         int dimX = 0;
         int dimY = 0;
         int dimZ = 0;
-        std::vector<uint8_t> a;
-        std::vector<uint8_t> b;
+        CaveFieldTiles tiles;
     };
 
     using ConfigMap = std::unordered_map<std::string, TerrainConfig>;
@@ -328,6 +332,7 @@ namespace TerrainSystemLogic {
                 GenerateIslandWorld(baseSystem, prototypes, world, worldCtx, config.island);
             }
             size_t afterCount = world.instances.size();
+            world.instanceEdits += 1;
             auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::steady_clock::now() - start
             ).count();
@@ -359,69 +364,6 @@ namespace TerrainSystemLogic {
         static CaveField g_caveField;
         
 
-        void ensureCaveField(const ExpanseConfig& cfg) {
-            if (g_caveField.ready) return;
-            const int step = 4;
-            const int sizeXZ = 2304;
-            const int halfXZ = sizeXZ / 2;
-            const int minY = -96;
-            const int heightY = 256; // -96..160
-            g_caveField.step = step;
-            g_caveField.origin = glm::vec3(-halfXZ, minY, -halfXZ);
-            g_caveField.dimX = sizeXZ / step + 1;
-            g_caveField.dimZ = sizeXZ / step + 1;
-            g_caveField.dimY = heightY / step + 1;
-            const size_t count = static_cast<size_t>(g_caveField.dimX)
-                * static_cast<size_t>(g_caveField.dimY)
-                * static_cast<size_t>(g_caveField.dimZ);
-            g_caveField.a.assign(count, 0);
-            g_caveField.b.assign(count, 0);
-
-            PerlinNoise3D caveNoiseA(cfg.elevationSeed + 1337);
-            PerlinNoise3D caveNoiseB(cfg.ridgeSeed + 7331);
-            auto idx = [&](int x, int y, int z) {
-                return (static_cast<size_t>(x) * g_caveField.dimY + static_cast<size_t>(y)) * g_caveField.dimZ + static_cast<size_t>(z);
-            };
-            for (int x = 0; x < g_caveField.dimX; ++x) {
-                float wx = g_caveField.origin.x + static_cast<float>(x * step);
-                for (int z = 0; z < g_caveField.dimZ; ++z) {
-                    float wz = g_caveField.origin.z + static_cast<float>(z * step);
-                    for (int y = 0; y < g_caveField.dimY; ++y) {
-                        float wy = g_caveField.origin.y + static_cast<float>(y * step);
-                        float v1 = (caveNoiseA.noise(wx / 64.0f, wy / 48.0f, wz / 64.0f) + 1.0f) * 0.5f;
-                        float v2 = (caveNoiseB.noise(wx / 128.0f, wy / 128.0f, wz / 128.0f) + 1.0f) * 0.5f;
-                        uint8_t q1 = static_cast<uint8_t>(std::clamp(v1, 0.0f, 1.0f) * 255.0f);
-                        uint8_t q2 = static_cast<uint8_t>(std::clamp(v2, 0.0f, 1.0f) * 255.0f);
-                        g_caveField.a[idx(x, y, z)] = q1;
-                        g_caveField.b[idx(x, y, z)] = q2;
-                    }
-                }
-            }
-            g_caveField.ready = true;
-            std::cout << "TerrainGeneration: precomputed cave field "
-                      << g_caveField.dimX << "x" << g_caveField.dimY << "x" << g_caveField.dimZ
-                      << " step=" << step << std::endl;
-        }
-
-        inline bool sampleCaveField(float worldX, float worldY, float worldZ, float& outA, float& outB) {
-            if (!g_caveField.ready) return false;
-            float fx = (worldX - g_caveField.origin.x) / static_cast<float>(g_caveField.step);
-            float fy = (worldY - g_caveField.origin.y) / static_cast<float>(g_caveField.step);
-            float fz = (worldZ - g_caveField.origin.z) / static_cast<float>(g_caveField.step);
-            int ix = static_cast<int>(std::round(fx));
-            int iy = static_cast<int>(std::round(fy));
-            int iz = static_cast<int>(std::round(fz));
-            if (ix < 0 || iy < 0 || iz < 0 || ix >= g_caveField.dimX || iy >= g_caveField.dimY || iz >= g_caveField.dimZ) {
-                return false;
-            }
-            size_t idx = (static_cast<size_t>(ix) * g_caveField.dimY + static_cast<size_t>(iy)) * g_caveField.dimZ + static_cast<size_t>(iz);
-            outA = static_cast<float>(g_caveField.a[idx]) / 255.0f;
-            outB = static_cast<float>(g_caveField.b[idx]) / 255.0f;
-            return true;
-        }
-
-        
-
         int findWorldIndexByName(const LevelContext& level, const std::string& name) {
             for (size_t i = 0; i < level.worlds.size(); ++i) {
                 if (level.worlds[i].name == name) return static_cast<int>(i);
@@ -498,14 +440,109 @@ namespace TerrainSystemLogic {
             }
         }
 
-        uint32_t hash2DInt(int x, int z) {
-            uint32_t ux = static_cast<uint32_t>(x) * 73856093u;
-            uint32_t uz = static_cast<uint32_t>(z) * 19349663u;
-            uint32_t h = ux ^ uz;
-            h ^= (h >> 13);
-            h *= 1274126177u;
-            h ^= (h >> 16);
-            return h;
+        std::string getRegistryString(const BaseSystem& baseSystem, const std::string& key, const std::string& fallback) {
+            if (!baseSystem.registry) return fallback;
+            auto it = baseSystem.registry->find(key);
+            if (it == baseSystem.registry->end()) return fallback;
+            if (!std::holds_alternative<std::string>(it->second)) return fallback;
+            return std::get<std::string>(it->second);
+        }
+
+        // The cave lattice covers a fixed box around the origin; its XZ column
+        // tiles are filled on worker threads as sections sample them.
+        // "CaveFieldTileSize" is the tile edge in lattice points,
+        // "CaveFieldTileCacheTiles" the resident tile budget,
+        // "CaveFieldWorkerThreads" 0 picks one fewer than the hardware threads
+        // (capped at 4), and a non-empty "CaveFieldCacheDir" persists tiles
+        // there keyed by seeds and lattice parameters.
+        void ensureCaveField(const BaseSystem& baseSystem, const ExpanseConfig& cfg) {
+            if (g_caveField.ready) return;
+            const int step = 4;
+            const int sizeXZ = 2304;
+            const int halfXZ = sizeXZ / 2;
+            const int minY = -96;
+            const int heightY = 256; // -96..160
+            g_caveField.step = step;
+            g_caveField.origin = glm::vec3(-halfXZ, minY, -halfXZ);
+            g_caveField.dimX = sizeXZ / step + 1;
+            g_caveField.dimZ = sizeXZ / step + 1;
+            g_caveField.dimY = heightY / step + 1;
+
+            const int seedA = cfg.elevationSeed + 1337;
+            const int seedB = cfg.ridgeSeed + 7331;
+            const int tileSize = std::max(4, getRegistryInt(baseSystem, "CaveFieldTileSize", 32));
+            const int capacity = std::max(4, getRegistryInt(baseSystem, "CaveFieldTileCacheTiles", 64));
+            int workers = getRegistryInt(baseSystem, "CaveFieldWorkerThreads", 0);
+            if (workers <= 0) {
+                int hardware = static_cast<int>(std::thread::hardware_concurrency());
+                workers = std::clamp(hardware - 1, 1, 4);
+            }
+            const std::string cacheDir = getRegistryString(baseSystem, "CaveFieldCacheDir", "");
+
+            uint64_t paramKey = 0xcbf29ce484222325ull;
+            for (int v : {1, seedA, seedB, step, sizeXZ, minY, heightY}) {
+                paramKey = (paramKey ^ static_cast<uint32_t>(v)) * 0x100000001b3ull;
+            }
+
+            const glm::vec3 origin = g_caveField.origin;
+            PerlinNoise3D caveNoiseA(seedA);
+            PerlinNoise3D caveNoiseB(seedB);
+            g_caveField.tiles.configure(g_caveField.dimX, g_caveField.dimY, g_caveField.dimZ, tileSize,
+                                        static_cast<size_t>(capacity), workers, paramKey, cacheDir,
+                [origin, step, caveNoiseA, caveNoiseB](CaveFieldTile& tile) {
+                    for (int lx = 0; lx < tile.nx; ++lx) {
+                        float wx = origin.x + static_cast<float>((tile.x0 + lx) * step);
+                        for (int lz = 0; lz < tile.nz; ++lz) {
+                            float wz = origin.z + static_cast<float>((tile.z0 + lz) * step);
+                            for (int y = 0; y < tile.dimY; ++y) {
+                                float wy = origin.y + static_cast<float>(y * step);
+                                float v1 = (caveNoiseA.noise(wx / 64.0f, wy / 48.0f, wz / 64.0f) + 1.0f) * 0.5f;
+                                float v2 = (caveNoiseB.noise(wx / 128.0f, wy / 128.0f, wz / 128.0f) + 1.0f) * 0.5f;
+                                tile.a[tile.index(lx, y, lz)] = static_cast<uint8_t>(std::clamp(v1, 0.0f, 1.0f) * 255.0f);
+                                tile.b[tile.index(lx, y, lz)] = static_cast<uint8_t>(std::clamp(v2, 0.0f, 1.0f) * 255.0f);
+                            }
+                        }
+                    }
+                });
+            g_caveField.ready = true;
+            std::cout << "TerrainGeneration: cave field "
+                      << g_caveField.dimX << "x" << g_caveField.dimY << "x" << g_caveField.dimZ
+                      << " step=" << step << " in " << tileSize << "-point tiles" << std::endl;
+        }
+
+        int caveLatticeIndex(float world, float origin) {
+            return static_cast<int>(std::round((world - origin) / static_cast<float>(g_caveField.step)));
+        }
+
+        // Queues the tiles a LOD0 section's cave samples can touch, including
+        // the one-block neighbours ore placement probes.
+        void prefetchCaveTiles(int minWorldX, int minWorldZ, int maxWorldX, int maxWorldZ) {
+            if (!g_caveField.ready) return;
+            g_caveField.tiles.requestRange(
+                caveLatticeIndex(static_cast<float>(minWorldX - 1), g_caveField.origin.x),
+                caveLatticeIndex(static_cast<float>(minWorldZ - 1), g_caveField.origin.z),
+                caveLatticeIndex(static_cast<float>(maxWorldX + 1), g_caveField.origin.x),
+                caveLatticeIndex(static_cast<float>(maxWorldZ + 1), g_caveField.origin.z));
+        }
+
+        inline bool sampleCaveField(float worldX, float worldY, float worldZ, float& outA, float& outB) {
+            if (!g_caveField.ready) return false;
+            float fx = (worldX - g_caveField.origin.x) / static_cast<float>(g_caveField.step);
+            float fy = (worldY - g_caveField.origin.y) / static_cast<float>(g_caveField.step);
+            float fz = (worldZ - g_caveField.origin.z) / static_cast<float>(g_caveField.step);
+            int ix = static_cast<int>(std::round(fx));
+            int iy = static_cast<int>(std::round(fy));
+            int iz = static_cast<int>(std::round(fz));
+            if (ix < 0 || iy < 0 || iz < 0 || ix >= g_caveField.dimX || iy >= g_caveField.dimY || iz >= g_caveField.dimZ) {
+                return false;
+            }
+            const CaveFieldTile* tile = g_caveField.tiles.find(ix, iz);
+            if (!tile) tile = g_caveField.tiles.acquire(ix, iz);
+            if (!tile) return false;
+            size_t idx = tile->index(ix - tile->x0, iy, iz - tile->z0);
+            outA = static_cast<float>(tile->a[idx]) / 255.0f;
+            outB = static_cast<float>(tile->b[idx]) / 255.0f;
+            return true;
         }
 
         uint32_t hash3DInt(int x, int y, int z) {
@@ -564,7 +601,7 @@ namespace TerrainSystemLogic {
             int scale = 1 << lod;
             auto pickBlockProto = [&](std::initializer_list<const char*> names) -> const Entity* {
                 for (const char* name : names) {
-                    const Entity* proto = HostLogic::findPrototype(name, prototypes);
+                    const Entity* proto = PrototypeTraits::findPrototype(name, prototypes);
                     if (proto && proto->prototypeID != 0) return proto;
                 }
                 return findNonZeroBlockProto(prototypes);
@@ -573,18 +610,18 @@ namespace TerrainSystemLogic {
             const Entity* sandProto = pickBlockProto({"ScaffoldBlock", "SandBlockTex"});
             const Entity* soilProto = pickBlockProto({"DirtBlockTex", "GrassBlockTex", "ScaffoldBlock"});
             const Entity* stoneProto = pickBlockProto({"StoneBlockTex", "ScaffoldBlock"});
-            const Entity* rubyOreProto = HostLogic::findPrototype("RubyOreTex", prototypes);
-            const Entity* silverOreProto = HostLogic::findPrototype("SilverOreTex", prototypes);
-            const Entity* amethystOreProto = HostLogic::findPrototype("AmethystOreTex", prototypes);
-            const Entity* flouriteOreProto = HostLogic::findPrototype("FlouriteOreTex", prototypes);
-            const Entity* waterProto = HostLogic::findPrototype("Water", prototypes);
+            const Entity* rubyOreProto = PrototypeTraits::findPrototype("RubyOreTex", prototypes);
+            const Entity* silverOreProto = PrototypeTraits::findPrototype("SilverOreTex", prototypes);
+            const Entity* amethystOreProto = PrototypeTraits::findPrototype("AmethystOreTex", prototypes);
+            const Entity* flouriteOreProto = PrototypeTraits::findPrototype("FlouriteOreTex", prototypes);
+            const Entity* waterProto = PrototypeTraits::findPrototype("Water", prototypes);
             if (!surfaceProto || !waterProto) return false;
             if (!sandProto) sandProto = surfaceProto;
             if (!soilProto) soilProto = surfaceProto;
             if (!stoneProto) stoneProto = surfaceProto;
 
             if (lod == 0) {
-                ensureCaveField(cfg);
+                ensureCaveField(baseSystem, cfg);
             }
 
             glm::vec3 grassColor = GetColor(worldCtx, cfg.colorGrass, glm::vec3(0.2f, 0.8f, 0.2f));
@@ -610,39 +647,13 @@ namespace TerrainSystemLogic {
             const float oreStoneReplaceChance = glm::clamp(getRegistryFloat(baseSystem, "OreStoneReplaceChance", 0.60f), 0.0f, 1.0f);
             const int oreMinDepthFromSurface = std::max(1, getRegistryInt(baseSystem, "OreMinDepthFromSurface", 4));
             const float oreCaveAdjacencyBoost = glm::clamp(getRegistryFloat(baseSystem, "OreCaveAdjacencyBoost", 0.35f), 0.0f, 1.0f);
-            auto oreVariantForColumn = [&](int worldXi, int worldZi) -> int {
-                if (!oreEnabled) return -1;
-                const int cellX = floorDivInt(worldXi, oreVeinCellSize);
-                const int cellZ = floorDivInt(worldZi, oreVeinCellSize);
-                int bestVariant = -1;
-                float bestDist2 = std::numeric_limits<float>::max();
-                for (int oz = -1; oz <= 1; ++oz) {
-                    for (int ox = -1; ox <= 1; ++ox) {
-                        const int vx = cellX + ox;
-                        const int vz = cellZ + oz;
-                        const uint32_t seed = hash2DInt(vx + oreSeed * 17, vz - oreSeed * 23);
-                        const float chanceRoll = static_cast<float>((seed >> 24u) & 0xffu) / 255.0f;
-                        if (chanceRoll > oreVeinChance) continue;
-                        const float offsetX = static_cast<float>(seed & 0xffu) / 255.0f;
-                        const float offsetZ = static_cast<float>((seed >> 8u) & 0xffu) / 255.0f;
-                        const float centerX = (static_cast<float>(vx) + offsetX) * static_cast<float>(oreVeinCellSize);
-                        const float centerZ = (static_cast<float>(vz) + offsetZ) * static_cast<float>(oreVeinCellSize);
-                        const uint32_t radiusSeed = hash2DInt(vx * 131 + oreSeed, vz * 197 - oreSeed);
-                        const float radiusT = static_cast<float>(radiusSeed & 0xffu) / 255.0f;
-                        const float radius = oreVeinRadiusMin + (oreVeinRadiusMax - oreVeinRadiusMin) * radiusT;
-                        const float dx = static_cast<float>(worldXi) - centerX;
-                        const float dz = static_cast<float>(worldZi) - centerZ;
-                        const float dist2 = dx * dx + dz * dz;
-                        if (dist2 > radius * radius) continue;
-                        if (dist2 < bestDist2) {
-                            bestDist2 = dist2;
-                            const uint32_t oreSeedValue = hash2DInt(vx * 313 + oreSeed * 7, vz * 571 - oreSeed * 11);
-                            bestVariant = static_cast<int>((oreSeedValue >> 5u) & 0x3u);
-                        }
-                    }
-                }
-                return bestVariant;
-            };
+            OreVeinPlan::Params orePlan;
+            orePlan.enabled = oreEnabled;
+            orePlan.seed = oreSeed;
+            orePlan.cellSize = oreVeinCellSize;
+            orePlan.radiusMin = oreVeinRadiusMin;
+            orePlan.radiusMax = oreVeinRadiusMax;
+            orePlan.chance = oreVeinChance;
             auto caveCarvedAt = [&](float sampleX, float sampleY, float sampleZ, int surfaceY, bool allowCaves) -> bool {
                 if (!allowCaves) return false;
                 if (sampleY > static_cast<float>(surfaceY)) return false;
@@ -669,6 +680,26 @@ namespace TerrainSystemLogic {
             int maxY = computeExpanseMaxY(baseSystem, worldCtx, cfg);
             if (sectionMaxY < minY || sectionMinY > maxY) return true;
 
+            // Per-section material plan: ore veins resolved for every column
+            // of the footprint at once, and the packed colors every voxel uses.
+            std::vector<int8_t> oreColumns;
+            if (lod == 0 && oreEnabled) {
+                OreVeinPlan::Grid oreGrid;
+                OreVeinPlan::planColumns(orePlan,
+                                         sectionCoord.x * size * scale,
+                                         sectionCoord.z * size * scale,
+                                         size,
+                                         scale,
+                                         oreGrid,
+                                         oreColumns);
+            }
+            const uint32_t grassPacked = packColor(grassColor);
+            const uint32_t sandPacked = packColor(sandColor);
+            const uint32_t soilPacked = packColor(soilColor);
+            const uint32_t stonePacked = packColor(stoneColor);
+            const uint32_t waterPacked = packColor(waterColor);
+            const uint32_t seabedPacked = packColor(seabedColor);
+
             bool wroteAny = false;
             for (int z = 0; z < size; ++z) {
                 for (int x = 0; x < size; ++x) {
@@ -687,9 +718,7 @@ namespace TerrainSystemLogic {
                     }
                     int oreVariant = -1;
                     if (lod == 0 && oreEnabled && isLand && !isBeach) {
-                        const int worldXi = static_cast<int>(std::floor(worldX));
-                        const int worldZi = static_cast<int>(std::floor(worldZ));
-                        oreVariant = oreVariantForColumn(worldXi, worldZi);
+                        oreVariant = oreColumns[static_cast<size_t>(z) * static_cast<size_t>(size) + static_cast<size_t>(x)];
                     }
 
 
@@ -704,14 +733,14 @@ namespace TerrainSystemLogic {
                             wroteAny = true;
                         };
                         if (!isLand) {
-                            trySetCell(floorDivInt(waterFloorY, scale), sandProto->prototypeID, packColor(seabedColor));
+                            trySetCell(floorDivInt(waterFloorY, scale), sandProto->prototypeID, seabedPacked);
                             if (waterSurfaceY > waterFloorY) {
-                                trySetCell(floorDivInt(waterSurfaceY, scale), waterProto->prototypeID, packColor(waterColor));
+                                trySetCell(floorDivInt(waterSurfaceY, scale), waterProto->prototypeID, waterPacked);
                             }
                         } else {
                             trySetCell(floorDivInt(surfaceY, scale),
                                        (isBeach ? sandProto->prototypeID : surfaceProto->prototypeID),
-                                       packColor(isBeach ? sandColor : grassColor));
+                                       (isBeach ? sandPacked : grassPacked));
                         }
                         continue;
                     }
@@ -755,19 +784,19 @@ namespace TerrainSystemLogic {
                         if (!isLand) {
                             if (carve) {
                                 if (worldY <= waterSurfaceY) {
-                                    voxelWorld.setBlockLod(lod, lodCoord, waterProto->prototypeID, packColor(waterColor), false);
+                                    voxelWorld.setBlockLod(lod, lodCoord, waterProto->prototypeID, waterPacked, false);
                                     wroteAny = true;
                                 }
                                 continue;
                             }
                             if (rangeContains(waterFloorY)) {
-                                voxelWorld.setBlockLod(lod, lodCoord, sandProto->prototypeID, packColor(seabedColor), false);
+                                voxelWorld.setBlockLod(lod, lodCoord, sandProto->prototypeID, seabedPacked, false);
                                 wroteAny = true;
                             } else if (waterSurfaceY > waterFloorY) {
                                 int waterMin = waterFloorY + 1;
                                 int waterMax = waterSurfaceY;
                                 if (rangeOverlaps(waterMin, waterMax)) {
-                                    voxelWorld.setBlockLod(lod, lodCoord, waterProto->prototypeID, packColor(waterColor), false);
+                                    voxelWorld.setBlockLod(lod, lodCoord, waterProto->prototypeID, waterPacked, false);
                                     wroteAny = true;
                                 }
                             }
@@ -776,18 +805,17 @@ namespace TerrainSystemLogic {
 
                         if (carve) {
                             if (worldY <= waterSurfaceY) {
-                                voxelWorld.setBlockLod(lod, lodCoord, waterProto->prototypeID, packColor(waterColor), false);
+                                voxelWorld.setBlockLod(lod, lodCoord, waterProto->prototypeID, waterPacked, false);
                                 wroteAny = true;
                             }
                             continue;
                         }
 
                         if (rangeContains(surfaceY)) {
-                            glm::vec3 topColor = isBeach ? sandColor : grassColor;
                             voxelWorld.setBlockLod(lod,
                                                    lodCoord,
                                                    (isBeach ? sandProto->prototypeID : surfaceProto->prototypeID),
-                                                   packColor(topColor),
+                                                   (isBeach ? sandPacked : grassPacked),
                                                    false);
                             wroteAny = true;
                             continue;
@@ -797,7 +825,7 @@ namespace TerrainSystemLogic {
                             int soilMin = surfaceY - cfg.soilDepth;
                             int stoneMin = surfaceY - cfg.soilDepth - cfg.stoneDepth;
                             if (rangeContains(waterFloorY)) {
-                                voxelWorld.setBlockLod(lod, lodCoord, sandProto->prototypeID, packColor(seabedColor), false);
+                                voxelWorld.setBlockLod(lod, lodCoord, sandProto->prototypeID, seabedPacked, false);
                                 wroteAny = true;
                                 continue;
                             }
@@ -842,9 +870,9 @@ namespace TerrainSystemLogic {
                                                            false);
                                 } else {
                                     if (inSoilLayer) {
-                                        voxelWorld.setBlockLod(lod, lodCoord, soilProto->prototypeID, packColor(soilColor), false);
+                                        voxelWorld.setBlockLod(lod, lodCoord, soilProto->prototypeID, soilPacked, false);
                                     } else {
-                                        voxelWorld.setBlockLod(lod, lodCoord, stoneProto->prototypeID, packColor(stoneColor), false);
+                                        voxelWorld.setBlockLod(lod, lodCoord, stoneProto->prototypeID, stonePacked, false);
                                     }
                                 }
                                 wroteAny = true;
@@ -1402,6 +1430,37 @@ namespace TerrainSystemLogic {
                 }
             }
 
+            // Start the cave tiles the next LOD0 sections will carve against so
+            // the workers fill them while earlier sections generate.
+            const int cavePrefetch = std::max(0, getRegistryInt(baseSystem, "CaveFieldPrefetchSections", 16));
+            if (cavePrefetch > 0 && cfg.islandRadius > 0.0f) {
+                const int size = sectionSizeForLod(voxelWorld, 0);
+                int queued = 0;
+                for (const auto& key : g_voxelStreaming.pending) {
+                    if (queued >= cavePrefetch) break;
+                    if (key.lod != 0) continue;
+                    const int minX = key.coord.x * size;
+                    const int minY = key.coord.y * size;
+                    const int minZ = key.coord.z * size;
+                    const int maxX = minX + size - 1;
+                    const int maxY = minY + size - 1;
+                    const int maxZ = minZ + size - 1;
+                    float nearX = std::clamp(cfg.islandCenterX, static_cast<float>(minX), static_cast<float>(maxX));
+                    float nearZ = std::clamp(cfg.islandCenterZ, static_cast<float>(minZ), static_cast<float>(maxZ));
+                    float dx = nearX - cfg.islandCenterX;
+                    float dz = nearZ - cfg.islandCenterZ;
+                    if (dx * dx + dz * dz >= cfg.islandRadius * cfg.islandRadius) continue;
+                    ensureCaveField(baseSystem, cfg);
+                    const float fieldTop = g_caveField.origin.y + static_cast<float>((g_caveField.dimY - 1) * g_caveField.step);
+                    if (static_cast<float>(maxY + 1) < g_caveField.origin.y - 2.0f
+                        || static_cast<float>(minY - 1) > fieldTop + 2.0f) {
+                        continue;
+                    }
+                    prefetchCaveTiles(minX, minZ, maxX, maxZ);
+                    queued += 1;
+                }
+            }
+
             int generationBudget = getRegistryInt(baseSystem, "voxelSectionsPerFrame", 0);
             const int minSectionsBeforeTimeCap = std::max(0, getRegistryInt(baseSystem, "voxelSectionGenMinSectionsPerFrame", 1));
             const float generationTimeBudgetMs = std::max(0.0f, getRegistryFloat(baseSystem, "voxelSectionGenMaxMsPerFrame", 6.0f));
@@ -1438,6 +1497,9 @@ namespace TerrainSystemLogic {
                 g_voxelStreaming.pending.erase(g_voxelStreaming.pending.begin(),
                                                g_voxelStreaming.pending.begin() + consumed);
             }
+            if (g_caveField.ready) {
+                g_caveField.tiles.trim();
+            }
 
             auto now = std::chrono::steady_clock::now();
             if (now - g_lastVoxelPerf >= std::chrono::seconds(1)) {
@@ -1482,8 +1544,7 @@ namespace TerrainSystemLogic {
             g_voxelStreaming.lastCenterSections.clear();
             g_voxelStreaming.lastRadii.clear();
             g_caveField.ready = false;
-            g_caveField.a.clear();
-            g_caveField.b.clear();
+            g_caveField.tiles.reset();
         }
 
         UpdateExpanseVoxelWorld(baseSystem, prototypes, worldCtx, worldCtx.expanse);
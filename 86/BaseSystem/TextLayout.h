@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BaseSystem/UIBatch.h"
+
+// Text shaping for atlas fonts, split from drawing so a string is laid out
+// once and then placed anywhere. A Layout holds lines of glyph advances and
+// quads; emit() walks them from the final position and snaps each quad to
+// whole pixels the same way stbtt_GetPackedQuad does, so cached layouts draw
+// exactly like text shaped in place. Nothing here touches GL.
+namespace TextLayout {
+
+    // Packed glyph metrics in pixels; uv already divided by the atlas size.
+    struct GlyphMetrics {
+        float xoff = 0.0f;
+        float yoff = 0.0f;
+        float xoff2 = 0.0f;
+        float yoff2 = 0.0f;
+        float s0 = 0.0f;
+        float t0 = 0.0f;
+        float s1 = 0.0f;
+        float t1 = 0.0f;
+        float xadvance = 0.0f;
+    };
+
+    // One atlas as the shaper sees it. `id` must change whenever the atlas
+    // is rebuilt; cached layouts are keyed on it.
+    struct Face {
+        uint32_t id = 0;
+        int pixelSize = 0;
+        int firstChar = 32;
+        float ascent = 0.0f;
+        float lineHeight = 0.0f;
+        std::vector<GlyphMetrics> glyphs;
+
+        const GlyphMetrics* glyph(unsigned char c) const {
+            const int index = static_cast<int>(c) - firstChar;
+            if (index < 0 || index >= static_cast<int>(glyphs.size())) return nullptr;
+            return &glyphs[static_cast<size_t>(index)];
+        }
+    };
+
+    // Glyph box relative to the pen, and its atlas rectangle.
+    struct Quad {
+        float xoff = 0.0f;
+        float yoff = 0.0f;
+        float xoff2 = 0.0f;
+        float yoff2 = 0.0f;
+        float s0 = 0.0f;
+        float t0 = 0.0f;
+        float s1 = 0.0f;
+        float t1 = 0.0f;
+    };
+
+    // Every laid-out character keeps its advance, and its quad unless the
+    // glyph is blank, so emit() can walk the pen from the final origin in
+    // the same order stbtt_GetPackedQuad did; sums taken relative to the box
+    // and shifted afterwards can round to a different pixel.
+    struct Layout {
+        std::vector<float> advances;
+        std::vector<int32_t> quadIndex;     // per advance; -1 for blank glyphs
+        std::vector<uint32_t> lineStarts;   // first advance of each line
+        std::vector<Quad> quads;
+        float ascent = 0.0f;
+        float lineHeight = 0.0f;
+        float width = 0.0f;   // widest line, by advance
+        float height = 0.0f;  // lines * lineHeight
+        int lines = 0;
+    };
+
+    // Lays out `text`: '\n' breaks a line, and with wrapWidth > 0 a line
+    // that would pass wrapWidth breaks at its last space (a single word
+    // longer than the width stays whole). Characters outside the atlas are
+    // skipped; blank glyphs such as space advance without a quad.
+    inline void shape(const Face& face, const std::string& text, float wrapWidth, Layout& out) {
+        out.advances.clear();
+        out.quadIndex.clear();
+        out.lineStarts.assign(1, 0u);
+        out.quads.clear();
+        out.ascent = face.ascent;
+        out.lineHeight = face.lineHeight > 0.0f ? face.lineHeight : static_cast<float>(face.pixelSize);
+        out.width = 0.0f;
+        float penX = 0.0f;
+        size_t breakAt = 0;        // first advance after the line's last space
+        float breakPen = -1.0f;    // pen just past that space, < 0 if none
+        float widthBeforeBreak = 0.0f;
+
+        for (char ch : text) {
+            if (ch == '\n') {
+                out.width = std::max(out.width, penX);
+                penX = 0.0f;
+                out.lineStarts.push_back(static_cast<uint32_t>(out.advances.size()));
+                breakPen = -1.0f;
+                continue;
+            }
+            const unsigned char uc = static_cast<unsigned char>(ch);
+            const GlyphMetrics* g = face.glyph(uc);
+            if (!g) continue;
+            if (wrapWidth > 0.0f && ch != ' ' && breakPen > 0.0f && penX + g->xadvance > wrapWidth) {
+                out.width = std::max(out.width, widthBeforeBreak);
+                out.lineStarts.push_back(static_cast<uint32_t>(breakAt));
+                penX = 0.0f;
+                for (size_t i = breakAt; i < out.advances.size(); ++i) penX += out.advances[i];
+                breakPen = -1.0f;
+            }
+            if (ch == ' ') widthBeforeBreak = penX;
+            if (g->xoff2 > g->xoff && g->yoff2 > g->yoff) {
+                out.quadIndex.push_back(static_cast<int32_t>(out.quads.size()));
+                out.quads.push_back({g->xoff, g->yoff, g->xoff2, g->yoff2, g->s0, g->t0, g->s1, g->t1});
+            } else {
+                out.quadIndex.push_back(-1);
+            }
+            out.advances.push_back(g->xadvance);
+            penX += g->xadvance;
+            if (ch == ' ') {
+                breakAt = out.advances.size();
+                breakPen = penX;
+            }
+        }
+        out.width = std::max(out.width, penX);
+        out.lines = static_cast<int>(out.lineStarts.size());
+        out.height = out.lineHeight * static_cast<float>(out.lines);
+    }
+
+    // Appends two triangles per quad with the box's top-left at
+    // (originX, originY) window pixels, converted to NDC.
+    inline void emit(const Layout& layout, float originX, float originY, uint32_t color,
+                     double screenWidth, double screenHeight, std::vector<UIBatch::Vertex>& out) {
+        auto ndcX = [screenWidth](float px) { return static_cast<float>((px / screenWidth) * 2.0 - 1.0); };
+        auto ndcY = [screenHeight](float py) { return static_cast<float>(1.0 - (py / screenHeight) * 2.0); };
+        size_t v = out.size();
+        out.resize(v + layout.quads.size() * 6);
+        const float top = originY + layout.ascent;
+        for (size_t line = 0; line < layout.lineStarts.size(); ++line) {
+            const size_t end = line + 1 < layout.lineStarts.size() ? layout.lineStarts[line + 1] : layout.advances.size();
+            const float y = top + static_cast<float>(line) * layout.lineHeight;
+            float x = originX;
+            for (size_t i = layout.lineStarts[line]; i < end; ++i) {
+                if (layout.quadIndex[i] >= 0) {
+                    const Quad& q = layout.quads[static_cast<size_t>(layout.quadIndex[i])];
+                    const float x0 = std::floor(x + q.xoff + 0.5f);
+                    const float y0 = std::floor(y + q.yoff + 0.5f);
+                    const float nx0 = ndcX(x0);
+                    const float nx1 = ndcX(x0 + q.xoff2 - q.xoff);
+                    const float ny0 = ndcY(y0);
+                    const float ny1 = ndcY(y0 + q.yoff2 - q.yoff);
+                    const UIBatch::Vertex a{nx0, ny0, q.s0, q.t0, color};
+                    const UIBatch::Vertex b{nx1, ny0, q.s1, q.t0, color};
+                    const UIBatch::Vertex c{nx1, ny1, q.s1, q.t1, color};
+                    const UIBatch::Vertex d{nx0, ny1, q.s0, q.t1, color};
+                    out[v++] = a;
+                    out[v++] = b;
+                    out[v++] = c;
+                    out[v++] = a;
+                    out[v++] = c;
+                    out[v++] = d;
+                }
+                x += layout.advances[i];
+            }
+        }
+    }
+
+    inline uint64_t hashText(const std::string& text) {
+        uint64_t h = 1469598103934665603ull;
+        for (char ch : text) {
+            h ^= static_cast<unsigned char>(ch);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Layouts keyed by (face, size, text hash, wrap width). An entry is
+    // only replaced when its key changes, i.e. the text or the atlas did.
+    // When full, the least recently used half is dropped.
+    class Cache {
+    public:
+        explicit Cache(size_t maxEntries = 4096) : capacity(std::max<size_t>(maxEntries, 2)) {}
+
+        // The reference stays valid until the next get() or clear().
+        const Layout& get(const Face& face, const std::string& text, float wrapWidth) {
+            const Key key{face.id, face.pixelSize, hashText(text), wrapWidth > 0.0f ? wrapWidth : 0.0f};
+            auto it = entries.find(key);
+            if (it != entries.end() && it->second.text == text) {
+                it->second.lastUse = ++clock;
+                hitCount += 1;
+                return it->second.layout;
+            }
+            missCount += 1;
+            if (it == entries.end()) {
+                if (entries.size() >= capacity) evict();
+                it = entries.emplace(key, Entry{}).first;
+            }
+            it->second.text = text;
+            it->second.lastUse = ++clock;
+            shape(face, text, key.wrapWidth, it->second.layout);
+            return it->second.layout;
+        }
+
+        void clear() { entries.clear(); }
+        size_t size() const { return entries.size(); }
+        uint64_t hits() const { return hitCount; }
+        uint64_t misses() const { return missCount; }
+
+    private:
+        struct Key {
+            uint32_t faceId = 0;
+            int pixelSize = 0;
+            uint64_t textHash = 0;
+            float wrapWidth = 0.0f;
+
+            bool operator==(const Key& other) const {
+                return faceId == other.faceId && pixelSize == other.pixelSize
+                    && textHash == other.textHash && wrapWidth == other.wrapWidth;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const {
+                uint64_t h = key.textHash;
+                h ^= (static_cast<uint64_t>(key.faceId) << 32) ^ static_cast<uint64_t>(static_cast<uint32_t>(key.pixelSize));
+                h *= 0x9e3779b97f4a7c15ull;
+                h ^= static_cast<uint64_t>(std::lround(key.wrapWidth * 8.0f));
+                return static_cast<size_t>(h ^ (h >> 29));
+            }
+        };
+
+        struct Entry {
+            std::string text;
+            Layout layout;
+            uint64_t lastUse = 0;
+        };
+
+        std::unordered_map<Key, Entry, KeyHash> entries;
+        size_t capacity;
+        uint64_t clock = 0;
+        uint64_t hitCount = 0;
+        uint64_t missCount = 0;
+
+        void evict() {
+            std::vector<uint64_t> stamps;
+            stamps.reserve(entries.size());
+            for (const auto& [_, entry] : entries) stamps.push_back(entry.lastUse);
+            std::nth_element(stamps.begin(), stamps.begin() + stamps.size() / 2, stamps.end());
+            const uint64_t cutoff = stamps[stamps.size() / 2];
+            for (auto it = entries.begin(); it != entries.end();) {
+                if (it->second.lastUse < cutoff) it = entries.erase(it);
+                else ++it;
+            }
+        }
+    };
+}
@@ -4,16 +4,24 @@
 #include <cmath>
 #include <cstring>
 #include <cstdint>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <queue>
 #include <array>
 
-namespace HostLogic { const Entity* findPrototype(const std::string& name, const std::vector<Entity>& prototypes); }
-namespace ExpanseBiomeSystemLogic { bool SampleTerrain(const WorldContext& worldCtx, float x, float z, float& outHeight); }
+#include "BaseSystem/PrototypeTraits.h"
+#include "BaseSystem/RayTraceWorkerPool.h"
+
+namespace ExpanseBiomeSystemLogic {
+    bool SampleTerrain(const WorldContext& worldCtx, float x, float z, float& outHeight);
+    void PrepareTerrainSampling(const WorldContext& worldCtx);
+}
 namespace VoxelMeshingSystemLogic { void RequestPriorityVoxelRemesh(BaseSystem& baseSystem, std::vector<Entity>& prototypes, const glm::ivec3& worldCell); }
 
 namespace TreeGenerationSystemLogic {
@@ -68,6 +76,10 @@ namespace TreeGenerationSystemLogic {
         static std::unordered_set<VoxelSectionKey, VoxelSectionKeyHash> g_treeBackfillVisited;
         static std::string g_treeLevelKey;
         static std::vector<std::pair<glm::ivec3, int>> g_pendingPineLogRemovals;
+        // Same fork-join pool the audio ray tracer uses; decoration jobs only
+        // write their own DecorationJob slot.
+        static std::unique_ptr<RayTraceWorkerPool> g_treeDecorationPool;
+        static int g_treeDecorationPoolThreads = -1;
 
         bool cellBelongsToSection(const glm::ivec3& worldCell, const glm::ivec3& sectionCoord, int sectionSize);
 
@@ -111,21 +123,8 @@ namespace TreeGenerationSystemLogic {
         }
 
         bool triggerGameplaySfx(BaseSystem& baseSystem, const char* fileName, float cooldownSeconds = 0.0f) {
-            if (!fileName || !baseSystem.audio || !baseSystem.audio->chuck) return false;
-            const std::string scriptPath = std::string("Procedures/chuck/gameplay/") + fileName;
-            static std::unordered_map<std::string, double> s_lastTrigger;
-            const double now = glfwGetTime();
-            auto it = s_lastTrigger.find(scriptPath);
-            if (it != s_lastTrigger.end() && (now - it->second) < static_cast<double>(cooldownSeconds)) {
-                return false;
-            }
-            std::vector<t_CKUINT> ids;
-            bool ok = baseSystem.audio->chuck->compileFile(scriptPath, "", 1, FALSE, &ids);
-            if (ok && !ids.empty()) {
-                s_lastTrigger[scriptPath] = now;
-                return true;
-            }
-            return false;
+            if (!fileName) return false;
+            return ChucKSystemLogic::TriggerSfx(baseSystem, std::string("Procedures/chuck/gameplay/") + fileName, cooldownSeconds);
         }
 
         uint32_t hash2D(int x, int z) {
@@ -158,64 +157,93 @@ namespace TreeGenerationSystemLogic {
             }
         };
 
-        enum class FallDirection : int { PosX = 0, NegX = 1, PosZ = 2, NegZ = 3 };
+        struct DecorationEdit {
+            glm::ivec3 cell = glm::ivec3(0);
+            uint32_t id = 0;
+            uint32_t color = 0;
+            bool intoAir = false; // the job saw air here; dropped if the cell is filled by merge time
+        };
 
-        bool isPineVerticalLogName(const std::string& name) {
-            return name == "FirLog1Tex" || name == "FirLog2Tex"
-                || name == "FirLog1TopTex" || name == "FirLog2TopTex";
-        }
+        // The world as one decoration job sees it: the voxel world as it stood
+        // when the batch was dispatched, plus the job's own writes. Jobs never
+        // write the shared world, so they can run concurrently; writes are
+        // recorded in order, those outside the job's section as spills, and
+        // applied on the main thread afterwards.
+        struct DecorationView {
+            const VoxelWorldContext& world;
+            glm::ivec3 sectionCoord;
+            int sectionSize = 0;
+            bool enabled = false;
+            std::unordered_map<glm::ivec3, std::pair<uint32_t, uint32_t>, IVec3Hash> overlay;
+            std::vector<DecorationEdit> edits;
+            std::vector<DecorationEdit> spills;
+
+            DecorationView(const VoxelWorldContext& sourceWorld, const glm::ivec3& coord, int size)
+                : world(sourceWorld), sectionCoord(coord), sectionSize(size), enabled(sourceWorld.enabled) {}
+
+            bool hasSection(const VoxelSectionKey& key) const {
+                return world.sections.find(key) != world.sections.end();
+            }
 
-        bool isPineAnyLogName(const std::string& name) {
-            return isPineVerticalLogName(name)
-                || name == "FirLog1TexX" || name == "FirLog2TexX"
-                || name == "FirLog1TexZ" || name == "FirLog2TexZ"
-                || name == "FirLog1NubTexX" || name == "FirLog2NubTexX"
-                || name == "FirLog1NubTexZ" || name == "FirLog2NubTexZ";
-        }
+            uint32_t getBlockWorld(const glm::ivec3& cell) const {
+                if (!overlay.empty()) {
+                    auto it = overlay.find(cell);
+                    if (it != overlay.end()) return it->second.first;
+                }
+                return world.getBlockWorld(cell);
+            }
+
+            uint32_t getColorWorld(const glm::ivec3& cell) const {
+                if (!overlay.empty()) {
+                    auto it = overlay.find(cell);
+                    if (it != overlay.end()) return it->second.second;
+                }
+                return world.getColorWorld(cell);
+            }
+
+            // Mirrors VoxelWorldContext::setBlockLod for the LOD0, no-dirty
+            // writes the decoration passes make.
+            void setBlockLod(int lod, const glm::ivec3& cell, uint32_t id, uint32_t color, bool markDirty) {
+                (void)lod;
+                (void)markDirty;
+                if (id == 0) color = 0;
+                DecorationEdit edit{cell, id, color, getBlockWorld(cell) == 0};
+                overlay[cell] = {id, color};
+                if (cellBelongsToSection(cell, sectionCoord, sectionSize)) {
+                    edits.push_back(edit);
+                } else {
+                    spills.push_back(edit);
+                }
+            }
+        };
+
+        struct DecorationJob {
+            VoxelSectionKey key;
+            bool modified = false;
+            std::vector<DecorationEdit> edits;
+            std::vector<DecorationEdit> spills;
+        };
+
+        enum class FallDirection : int { PosX = 0, NegX = 1, PosZ = 2, NegZ = 3 };
 
         bool isPineVerticalLogPrototypeID(const std::vector<Entity>& prototypes, int prototypeID) {
             return prototypeID >= 0
-                && prototypeID < static_cast<int>(prototypes.size())
-                && isPineVerticalLogName(prototypes[prototypeID].name);
+                && PrototypeTraits::For(prototypes).has(static_cast<uint32_t>(prototypeID), PrototypeTraits::PineVerticalLog);
         }
 
         bool isPineAnyLogPrototypeID(const std::vector<Entity>& prototypes, uint32_t prototypeID) {
-            int id = static_cast<int>(prototypeID);
-            return id >= 0
-                && id < static_cast<int>(prototypes.size())
-                && isPineAnyLogName(prototypes[id].name);
+            return PrototypeTraits::For(prototypes).has(prototypeID, PrototypeTraits::PineLog);
         }
 
         bool isLeafPrototypeID(const std::vector<Entity>& prototypes, uint32_t prototypeID) {
-            int id = static_cast<int>(prototypeID);
-            return id >= 0
-                && id < static_cast<int>(prototypes.size())
-                && prototypes[id].name == "Leaf";
+            return PrototypeTraits::For(prototypes).has(prototypeID, PrototypeTraits::Leaf);
         }
 
         bool isFoliageGroundPrototypeID(const std::vector<Entity>& prototypes,
                                         uint32_t prototypeID,
                                         int waterPrototypeID) {
-            int id = static_cast<int>(prototypeID);
-            if (id <= 0 || id >= static_cast<int>(prototypes.size())) return false;
-            if (id == waterPrototypeID) return false;
-            const Entity& proto = prototypes[static_cast<size_t>(id)];
-            if (!proto.isBlock || !proto.isSolid) return false;
-            if (proto.name == "Leaf"
-                || proto.name == "GrassTuft"
-                || proto.name == "GrassTuftShort"
-                || proto.name == "Flower"
-                || proto.name == "StickTexX"
-                || proto.name == "StickTexZ"
-                || proto.name == "StonePebbleTexX"
-                || proto.name == "StonePebbleTexZ"
-                || proto.name == "WallStoneTexPosX"
-                || proto.name == "WallStoneTexNegX"
-                || proto.name == "WallStoneTexPosZ"
-                || proto.name == "WallStoneTexNegZ"
-                || proto.name == "CeilingStoneTexX"
-                || proto.name == "CeilingStoneTexZ") return false;
-            return true;
+            if (static_cast<int>(prototypeID) == waterPrototypeID) return false;
+            return PrototypeTraits::For(prototypes).has(prototypeID, PrototypeTraits::FoliageGround);
         }
 
         uint32_t grassColorForCell(int worldX, int worldZ) {
@@ -249,29 +277,10 @@ namespace TreeGenerationSystemLogic {
             return packColor(c);
         }
 
-        bool isGrassSurfacePrototypeName(const std::string& name) {
-            return name == "GrassBlockTex" || name == "ScaffoldBlock";
-        }
-
-        bool isStoneSurfacePrototypeName(const std::string& name) {
-            return name == "StoneBlockTex" || name == "ScaffoldBlock";
-        }
-
-        bool isWallStonePrototypeName(const std::string& name) {
-            return name == "WallStoneTexPosX"
-                || name == "WallStoneTexNegX"
-                || name == "WallStoneTexPosZ"
-                || name == "WallStoneTexNegZ";
-        }
-
         enum class CaveSlopeDir : int { None = 0, PosX = 1, NegX = 2, PosZ = 3, NegZ = 4 };
 
-        CaveSlopeDir caveSlopeDirFromName(const std::string& name) {
-            if (name == "DebugSlopeTexPosX") return CaveSlopeDir::PosX;
-            if (name == "DebugSlopeTexNegX") return CaveSlopeDir::NegX;
-            if (name == "DebugSlopeTexPosZ") return CaveSlopeDir::PosZ;
-            if (name == "DebugSlopeTexNegZ") return CaveSlopeDir::NegZ;
-            return CaveSlopeDir::None;
+        CaveSlopeDir caveSlopeDirForPrototypeID(const std::vector<Entity>& prototypes, uint32_t prototypeID) {
+            return static_cast<CaveSlopeDir>(PrototypeTraits::For(prototypes).slope(prototypeID));
         }
 
         CaveSlopeDir caveSlopeDirFromExposedAirSide(const glm::ivec3& airOffset) {
@@ -328,7 +337,7 @@ namespace TreeGenerationSystemLogic {
             return packColor(c);
         }
 
-        bool hasLeafCanopyNear(const VoxelWorldContext& voxelWorld,
+        bool hasLeafCanopyNear(const DecorationView& voxelWorld,
                                int leafPrototypeID,
                                int worldX,
                                int groundY,
@@ -392,7 +401,7 @@ namespace TreeGenerationSystemLogic {
 
         void writeGroundFoliageToSection(const std::vector<Entity>& prototypes,
                                          const WorldContext& worldCtx,
-                                         VoxelWorldContext& voxelWorld,
+                                         DecorationView& voxelWorld,
                                          const glm::ivec3& sectionCoord,
                                          int sectionSize,
                                          int grassPrototypeID,
@@ -463,7 +472,7 @@ namespace TreeGenerationSystemLogic {
                         modified = true;
                     } else if (spawnGrass) {
                         bool spawnStick = false;
-                        if (spec.stickEnabled && hasAnyStickPrototype && isGrassSurfacePrototypeName(prototypes[static_cast<size_t>(groundID)].name)) {
+                        if (spec.stickEnabled && hasAnyStickPrototype && PrototypeTraits::For(prototypes).has(groundID, PrototypeTraits::GrassSurface)) {
                             const int stickChance = std::max(0, std::min(100, spec.stickSpawnPercent));
                             if (stickChance > 0) {
                                 const uint32_t stickSeed = hash3D(worldX, groundY, worldZ);
@@ -506,7 +515,7 @@ namespace TreeGenerationSystemLogic {
 
         void writeCaveSlopeToSection(const std::vector<Entity>& prototypes,
                                      const WorldContext& worldCtx,
-                                     VoxelWorldContext& voxelWorld,
+                                     DecorationView& voxelWorld,
                                      const glm::ivec3& sectionCoord,
                                      int sectionSize,
                                      int slopeProtoPosX,
@@ -539,23 +548,21 @@ namespace TreeGenerationSystemLogic {
                     && cell.z >= minZ && cell.z <= maxZ;
             };
 
+            const PrototypeTraits::Table& traits = PrototypeTraits::For(prototypes);
             auto isStoneSurfaceCell = [&](const glm::ivec3& cell) {
                 const uint32_t id = voxelWorld.getBlockWorld(cell);
-                if (id == 0u || id >= prototypes.size()) return false;
-                const Entity& proto = prototypes[id];
-                if (!proto.isBlock) return false;
-                return proto.isSolid && isStoneSurfacePrototypeName(proto.name);
+                if (id == 0u) return false;
+                return traits.has(id, PrototypeTraits::Block | PrototypeTraits::Solid | PrototypeTraits::StoneSurface);
             };
             auto isWallStonePrototypeID = [&](uint32_t id) {
-                if (id == 0u || id >= prototypes.size()) return false;
-                return isWallStonePrototypeName(prototypes[id].name);
+                if (id == 0u) return false;
+                return traits.has(id, PrototypeTraits::WallStone);
             };
             auto isSolidSupportCell = [&](const glm::ivec3& cell) {
                 const uint32_t id = voxelWorld.getBlockWorld(cell);
-                if (id == 0u || id >= prototypes.size()) return false;
-                const Entity& proto = prototypes[id];
-                if (!proto.isBlock || !proto.isSolid) return false;
-                return proto.name != "Water";
+                if (id == 0u) return false;
+                return traits.has(id, PrototypeTraits::Block | PrototypeTraits::Solid)
+                    && !traits.has(id, PrototypeTraits::Water);
             };
 
             const int kNoSurface = std::numeric_limits<int>::min();
@@ -647,11 +654,7 @@ namespace TreeGenerationSystemLogic {
                             if (!inSection(target)) return false;
                             const uint32_t id = voxelWorld.getBlockWorld(target);
                             if (id == 0u) return true;
-                            if (id >= prototypes.size()) return false;
-                            const Entity& proto = prototypes[id];
-                            if (!proto.isBlock) return false;
-                            if (proto.name == "Water") return false;
-                            return true;
+                            return traits.has(id, PrototypeTraits::Block) && !traits.has(id, PrototypeTraits::Water);
                         };
                         struct PriorCellState {
                             glm::ivec3 pos{0};
@@ -735,10 +738,7 @@ namespace TreeGenerationSystemLogic {
                                 const glm::ivec3 target = midCenter + perpDir * lateral + glm::ivec3(0, -1, 0);
                                 if (!inSection(target)) continue;
                                 const uint32_t existingID = voxelWorld.getBlockWorld(target);
-                                if (existingID != 0u && existingID < prototypes.size()) {
-                                    const Entity& existingProto = prototypes[existingID];
-                                    if (existingProto.name == "Water") continue;
-                                }
+                                if (existingID != 0u && traits.has(existingID, PrototypeTraits::Water)) continue;
                                 voxelWorld.setBlockLod(
                                     0,
                                     target,
@@ -753,10 +753,7 @@ namespace TreeGenerationSystemLogic {
                                     const glm::ivec3 extraUnder = target + glm::ivec3(0, -1, 0);
                                     if (!inSection(extraUnder)) continue;
                                     const uint32_t extraID = voxelWorld.getBlockWorld(extraUnder);
-                                    if (extraID != 0u && extraID < prototypes.size()) {
-                                        const Entity& extraProto = prototypes[extraID];
-                                        if (extraProto.name == "Water") continue;
-                                    }
+                                    if (extraID != 0u && traits.has(extraID, PrototypeTraits::Water)) continue;
                                     voxelWorld.setBlockLod(
                                         0,
                                         extraUnder,
@@ -775,7 +772,7 @@ namespace TreeGenerationSystemLogic {
 
         void writeCaveStoneToSection(const std::vector<Entity>& prototypes,
                                      const WorldContext& worldCtx,
-                                     VoxelWorldContext& voxelWorld,
+                                     DecorationView& voxelWorld,
                                      const glm::ivec3& sectionCoord,
                                      int sectionSize,
                                      int stonePrototypeIDX,
@@ -863,7 +860,7 @@ namespace TreeGenerationSystemLogic {
 
         void writeCaveWallStoneToSection(const std::vector<Entity>& prototypes,
                                          const WorldContext& worldCtx,
-                                         VoxelWorldContext& voxelWorld,
+                                         DecorationView& voxelWorld,
                                          const glm::ivec3& sectionCoord,
                                          int sectionSize,
                                          int wallStonePrototypePosX,
@@ -882,6 +879,7 @@ namespace TreeGenerationSystemLogic {
             const int stoneChance = std::max(0, std::min(100, spec.caveWallStoneSpawnPercent));
             if (stoneChance <= 0) return;
             const int minDepthFromSurface = std::max(1, std::min(256, spec.caveWallStoneMinDepthFromSurface));
+            const PrototypeTraits::Table& traits = PrototypeTraits::For(prototypes);
 
             const int minX = sectionCoord.x * sectionSize;
             const int minY = sectionCoord.y * sectionSize;
@@ -931,10 +929,8 @@ namespace TreeGenerationSystemLogic {
                             if (wallStonePrototypeID < 0) return;
                             const glm::ivec3 supportCell = placeCell + offset;
                             const uint32_t supportID = voxelWorld.getBlockWorld(supportCell);
-                            if (supportID == 0u || supportID >= prototypes.size()) return;
-                            const Entity& supportProto = prototypes[supportID];
-                            if (!supportProto.isBlock || !supportProto.isSolid) return;
-                            if (!isStoneSurfacePrototypeName(supportProto.name)) return;
+                            if (supportID == 0u) return;
+                            if (!traits.has(supportID, PrototypeTraits::Block | PrototypeTraits::Solid | PrototypeTraits::StoneSurface)) return;
                             candidates[static_cast<size_t>(candidateCount)] = wallStonePrototypeID;
                             candidateCount += 1;
                         };
@@ -966,7 +962,7 @@ namespace TreeGenerationSystemLogic {
 
         void writeCaveCeilingStoneToSection(const std::vector<Entity>& prototypes,
                                             const WorldContext& worldCtx,
-                                            VoxelWorldContext& voxelWorld,
+                                            DecorationView& voxelWorld,
                                             const glm::ivec3& sectionCoord,
                                             int sectionSize,
                                             int ceilingStonePrototypeIDX,
@@ -981,6 +977,7 @@ namespace TreeGenerationSystemLogic {
             const int stoneChance = std::max(0, std::min(100, spec.caveCeilingStoneSpawnPercent));
             if (stoneChance <= 0) return;
             const int minDepthFromSurface = std::max(1, std::min(256, spec.caveCeilingStoneMinDepthFromSurface));
+            const PrototypeTraits::Table& traits = PrototypeTraits::For(prototypes);
 
             const int minX = sectionCoord.x * sectionSize;
             const int minY = sectionCoord.y * sectionSize;
@@ -1029,10 +1026,8 @@ namespace TreeGenerationSystemLogic {
 
                         const glm::ivec3 supportCell(worldX, worldY + 1, worldZ);
                         const uint32_t supportID = voxelWorld.getBlockWorld(supportCell);
-                        if (supportID == 0u || supportID >= prototypes.size()) continue;
-                        const Entity& supportProto = prototypes[supportID];
-                        if (!supportProto.isBlock || !supportProto.isSolid) continue;
-                        if (!isStoneSurfacePrototypeName(supportProto.name)) continue;
+                        if (supportID == 0u) continue;
+                        if (!traits.has(supportID, PrototypeTraits::Block | PrototypeTraits::Solid | PrototypeTraits::StoneSurface)) continue;
 
                         int stoneID = (((seed >> 10u) & 1u) == 0u) ? ceilingStonePrototypeIDX : ceilingStonePrototypeIDZ;
                         if (stoneID < 0) stoneID = (ceilingStonePrototypeIDX >= 0) ? ceilingStonePrototypeIDX : ceilingStonePrototypeIDZ;
@@ -1177,7 +1172,7 @@ namespace TreeGenerationSystemLogic {
             return false;
         }
 
-        bool hasNearbyConflictingTrunk(const VoxelWorldContext& voxelWorld,
+        bool hasNearbyConflictingTrunk(const DecorationView& voxelWorld,
                                        int trunkPrototypeIDA,
                                        int trunkPrototypeIDB,
                                        int baseX,
@@ -1196,7 +1191,7 @@ namespace TreeGenerationSystemLogic {
             return false;
         }
 
-        bool trunkColumnCanExist(const VoxelWorldContext& voxelWorld,
+        bool trunkColumnCanExist(const DecorationView& voxelWorld,
                                  int trunkPrototypeIDA,
                                  int trunkPrototypeIDB,
                                  int worldX,
@@ -1224,9 +1219,8 @@ namespace TreeGenerationSystemLogic {
         int topLogPrototypeFor(const std::vector<Entity>& prototypes,
                                int sourcePrototypeID);
 
-        void writeTreeToWorld(VoxelWorldContext& voxelWorld,
+        void writeTreeToWorld(DecorationView& voxelWorld,
                               const std::vector<Entity>& prototypes,
-                              int sectionSize,
                               int trunkPrototypeID,
                               int topPrototypeID,
                               int nubPrototypeID,
@@ -1237,16 +1231,10 @@ namespace TreeGenerationSystemLogic {
                               int groundY,
                               int worldZ,
                               const PineSpec& spec,
-                              std::unordered_set<glm::ivec3, IVec3Hash>& outTouchedSections,
                               bool& modified) {
             auto setIfEmpty = [&](const glm::ivec3& cell, uint32_t id, uint32_t color) {
                 if (voxelWorld.getBlockWorld(cell) != 0) return;
                 voxelWorld.setBlockLod(0, cell, id, color, false);
-                outTouchedSections.insert(glm::ivec3(
-                    floorDivInt(cell.x, sectionSize),
-                    floorDivInt(cell.y, sectionSize),
-                    floorDivInt(cell.z, sectionSize)
-                ));
                 modified = true;
             };
 
@@ -1281,10 +1269,7 @@ namespace TreeGenerationSystemLogic {
         }
 
         int findPrototypeIDByName(const std::vector<Entity>& prototypes, const std::string& name) {
-            for (const auto& proto : prototypes) {
-                if (proto.name == name) return proto.prototypeID;
-            }
-            return -1;
+            return PrototypeTraits::For(prototypes).idOf(name);
         }
 
         int horizontalLogPrototypeFor(const std::vector<Entity>& prototypes,
@@ -1606,30 +1591,30 @@ namespace TreeGenerationSystemLogic {
             }
         }
 
-        const Entity* trunkProtoA = HostLogic::findPrototype("FirLog1Tex", prototypes);
-        const Entity* trunkProtoB = HostLogic::findPrototype("FirLog2Tex", prototypes);
-        if (!trunkProtoA) trunkProtoA = HostLogic::findPrototype("Branch", prototypes);
-        if (!trunkProtoA) trunkProtoA = HostLogic::findPrototype("Block", prototypes);
+        const Entity* trunkProtoA = PrototypeTraits::findPrototype("FirLog1Tex", prototypes);
+        const Entity* trunkProtoB = PrototypeTraits::findPrototype("FirLog2Tex", prototypes);
+        if (!trunkProtoA) trunkProtoA = PrototypeTraits::findPrototype("Branch", prototypes);
+        if (!trunkProtoA) trunkProtoA = PrototypeTraits::findPrototype("Block", prototypes);
         if (!trunkProtoB) trunkProtoB = trunkProtoA;
-        const Entity* leafProto = HostLogic::findPrototype("Leaf", prototypes);
-        const Entity* grassProto = HostLogic::findPrototype("GrassTuft", prototypes);
-        const Entity* shortGrassProto = HostLogic::findPrototype("GrassTuftShort", prototypes);
-        const Entity* flowerProto = HostLogic::findPrototype("Flower", prototypes);
-        const Entity* stickProtoX = HostLogic::findPrototype("StickTexX", prototypes);
-        const Entity* stickProtoZ = HostLogic::findPrototype("StickTexZ", prototypes);
-        const Entity* stonePebbleProtoX = HostLogic::findPrototype("StonePebbleTexX", prototypes);
-        const Entity* stonePebbleProtoZ = HostLogic::findPrototype("StonePebbleTexZ", prototypes);
-        const Entity* wallStoneProtoPosX = HostLogic::findPrototype("WallStoneTexPosX", prototypes);
-        const Entity* wallStoneProtoNegX = HostLogic::findPrototype("WallStoneTexNegX", prototypes);
-        const Entity* wallStoneProtoPosZ = HostLogic::findPrototype("WallStoneTexPosZ", prototypes);
-        const Entity* wallStoneProtoNegZ = HostLogic::findPrototype("WallStoneTexNegZ", prototypes);
-        const Entity* ceilingStoneProtoX = HostLogic::findPrototype("CeilingStoneTexX", prototypes);
-        const Entity* ceilingStoneProtoZ = HostLogic::findPrototype("CeilingStoneTexZ", prototypes);
-        const Entity* slopeProtoPosX = HostLogic::findPrototype("DebugSlopeTexPosX", prototypes);
-        const Entity* slopeProtoNegX = HostLogic::findPrototype("DebugSlopeTexNegX", prototypes);
-        const Entity* slopeProtoPosZ = HostLogic::findPrototype("DebugSlopeTexPosZ", prototypes);
-        const Entity* slopeProtoNegZ = HostLogic::findPrototype("DebugSlopeTexNegZ", prototypes);
-        const Entity* waterProto = HostLogic::findPrototype("Water", prototypes);
+        const Entity* leafProto = PrototypeTraits::findPrototype("Leaf", prototypes);
+        const Entity* grassProto = PrototypeTraits::findPrototype("GrassTuft", prototypes);
+        const Entity* shortGrassProto = PrototypeTraits::findPrototype("GrassTuftShort", prototypes);
+        const Entity* flowerProto = PrototypeTraits::findPrototype("Flower", prototypes);
+        const Entity* stickProtoX = PrototypeTraits::findPrototype("StickTexX", prototypes);
+        const Entity* stickProtoZ = PrototypeTraits::findPrototype("StickTexZ", prototypes);
+        const Entity* stonePebbleProtoX = PrototypeTraits::findPrototype("StonePebbleTexX", prototypes);
+        const Entity* stonePebbleProtoZ = PrototypeTraits::findPrototype("StonePebbleTexZ", prototypes);
+        const Entity* wallStoneProtoPosX = PrototypeTraits::findPrototype("WallStoneTexPosX", prototypes);
+        const Entity* wallStoneProtoNegX = PrototypeTraits::findPrototype("WallStoneTexNegX", prototypes);
+        const Entity* wallStoneProtoPosZ = PrototypeTraits::findPrototype("WallStoneTexPosZ", prototypes);
+        const Entity* wallStoneProtoNegZ = PrototypeTraits::findPrototype("WallStoneTexNegZ", prototypes);
+        const Entity* ceilingStoneProtoX = PrototypeTraits::findPrototype("CeilingStoneTexX", prototypes);
+        const Entity* ceilingStoneProtoZ = PrototypeTraits::findPrototype("CeilingStoneTexZ", prototypes);
+        const Entity* slopeProtoPosX = PrototypeTraits::findPrototype("DebugSlopeTexPosX", prototypes);
+        const Entity* slopeProtoNegX = PrototypeTraits::findPrototype("DebugSlopeTexNegX", prototypes);
+        const Entity* slopeProtoPosZ = PrototypeTraits::findPrototype("DebugSlopeTexPosZ", prototypes);
+        const Entity* slopeProtoNegZ = PrototypeTraits::findPrototype("DebugSlopeTexNegZ", prototypes);
+        const Entity* waterProto = PrototypeTraits::findPrototype("Water", prototypes);
         if (!trunkProtoA || !trunkProtoB || !leafProto) return;
 
         // Prototype colors from temp/prismals_game.cpp:
@@ -1747,19 +1732,21 @@ namespace TreeGenerationSystemLogic {
         }
         if (lod0Dirty.empty()) return;
 
-        const int canopyPad = static_cast<int>(std::ceil(spec.canopyBottomRadius + spec.canopyLowerRadiusBoost));
-        for (const auto& key : lod0Dirty) {
+        // Runs before dispatch and again at merge time, where spills from jobs
+        // merged earlier in this batch may have bumped a section it also holds.
+        auto passesVersionGate = [&](const VoxelSectionKey& key, bool& outForceBackfill) {
             const bool wasDirty = voxelWorld.dirtySections.count(key) > 0;
             const bool forceBackfill = backfillLoaded && !wasDirty;
+            outForceBackfill = forceBackfill;
             auto sectionIt = voxelWorld.sections.find(key);
-            if (sectionIt == voxelWorld.sections.end()) continue;
-            if (sectionIt->second.lod != 0) continue;
+            if (sectionIt == voxelWorld.sections.end()) return false;
+            if (sectionIt->second.lod != 0) return false;
 
             auto appliedIt = g_treeAppliedVersion.find(key);
             if (!forceBackfill
                 && appliedIt != g_treeAppliedVersion.end()
                 && appliedIt->second == sectionIt->second.editVersion) {
-                continue;
+                return false;
             }
 
             // Once a section has already been processed by this system, treat any newer
@@ -1770,13 +1757,35 @@ namespace TreeGenerationSystemLogic {
                 && appliedIt != g_treeAppliedVersion.end()
                 && sectionIt->second.editVersion > appliedIt->second) {
                 g_treeAppliedVersion[key] = sectionIt->second.editVersion;
-                continue;
+                return false;
             }
+            return true;
+        };
+
+        std::vector<DecorationJob> jobs;
+        jobs.reserve(lod0Dirty.size());
+        for (const auto& key : lod0Dirty) {
+            bool forceBackfill = false;
+            if (!passesVersionGate(key, forceBackfill)) continue;
+            DecorationJob job;
+            job.key = key;
+            jobs.push_back(std::move(job));
+        }
+        if (jobs.empty()) return;
 
+        // Jobs read these without locking, so settle their lazy state here.
+        ExpanseBiomeSystemLogic::PrepareTerrainSampling(worldCtx);
+        PrototypeTraits::For(prototypes);
+        pineCanopyOffsets(spec);
+
+        const VoxelWorldContext& snapshot = voxelWorld;
+        const int canopyPad = static_cast<int>(std::ceil(spec.canopyBottomRadius + spec.canopyLowerRadiusBoost));
+        const std::function<void(size_t)> decorate = [&](size_t index) {
+            DecorationJob& job = jobs[index];
+            const int sectionSize = snapshot.sections.find(job.key)->second.size;
+            const glm::ivec3 sectionCoord = job.key.coord;
+            DecorationView view(snapshot, sectionCoord, sectionSize);
             bool modified = false;
-            std::unordered_set<glm::ivec3, IVec3Hash> touchedSections;
-            int sectionSize = sectionIt->second.size;
-            glm::ivec3 sectionCoord = key.coord;
             int minX = sectionCoord.x * sectionSize;
             int minZ = sectionCoord.z * sectionSize;
             int maxX = minX + sectionSize - 1;
@@ -1807,7 +1816,7 @@ namespace TreeGenerationSystemLogic {
                     // containing the trunk base. This prevents cross-section duplicates while
                     // still allowing the tree to write into higher sections.
                     if (trunkSectionKey.coord != sectionCoord) continue;
-                    if (voxelWorld.sections.find(trunkSectionKey) == voxelWorld.sections.end()) continue;
+                    if (!view.hasSection(trunkSectionKey)) continue;
 
                     const int trunkPrototypeID = ((hash2D(worldX, worldZ) >> 8u) & 1u) == 0u
                         ? trunkProtoA->prototypeID
@@ -1817,7 +1826,7 @@ namespace TreeGenerationSystemLogic {
                         : trunkProtoA->prototypeID;
                     const int topPrototypeID = topLogPrototypeFor(prototypes, nubPrototypeID);
 
-                    if (!trunkColumnCanExist(voxelWorld,
+                    if (!trunkColumnCanExist(view,
                                              trunkProtoA->prototypeID,
                                              trunkProtoB->prototypeID,
                                              worldX,
@@ -1827,7 +1836,7 @@ namespace TreeGenerationSystemLogic {
                         continue;
                     }
 
-                    if (hasNearbyConflictingTrunk(voxelWorld,
+                    if (hasNearbyConflictingTrunk(view,
                                                   trunkProtoA->prototypeID,
                                                   trunkProtoB->prototypeID,
                                                   worldX,
@@ -1837,9 +1846,8 @@ namespace TreeGenerationSystemLogic {
                         continue;
                     }
 
-                    writeTreeToWorld(voxelWorld,
+                    writeTreeToWorld(view,
                                      prototypes,
-                                     sectionSize,
                                      trunkPrototypeID,
                                      topPrototypeID,
                                      nubPrototypeID,
@@ -1850,7 +1858,6 @@ namespace TreeGenerationSystemLogic {
                                      groundY,
                                      worldZ,
                                      spec,
-                                     touchedSections,
                                      modified);
                 }
             }
@@ -1858,7 +1865,7 @@ namespace TreeGenerationSystemLogic {
             writeGroundFoliageToSection(
                 prototypes,
                 worldCtx,
-                voxelWorld,
+                view,
                 sectionCoord,
                 sectionSize,
                 grassProto ? grassProto->prototypeID : -1,
@@ -1874,7 +1881,7 @@ namespace TreeGenerationSystemLogic {
             writeCaveSlopeToSection(
                 prototypes,
                 worldCtx,
-                voxelWorld,
+                view,
                 sectionCoord,
                 sectionSize,
                 slopeProtoPosX ? slopeProtoPosX->prototypeID : -1,
@@ -1887,7 +1894,7 @@ namespace TreeGenerationSystemLogic {
             writeCaveStoneToSection(
                 prototypes,
                 worldCtx,
-                voxelWorld,
+                view,
                 sectionCoord,
                 sectionSize,
                 stonePebbleProtoX ? stonePebbleProtoX->prototypeID : -1,
@@ -1899,7 +1906,7 @@ namespace TreeGenerationSystemLogic {
             writeCaveWallStoneToSection(
                 prototypes,
                 worldCtx,
-                voxelWorld,
+                view,
                 sectionCoord,
                 sectionSize,
                 wallStoneProtoPosX ? wallStoneProtoPosX->prototypeID : -1,
@@ -1912,7 +1919,7 @@ namespace TreeGenerationSystemLogic {
             writeCaveCeilingStoneToSection(
                 prototypes,
                 worldCtx,
-                voxelWorld,
+                view,
                 sectionCoord,
                 sectionSize,
                 ceilingStoneProtoX ? ceilingStoneProtoX->prototypeID : -1,
@@ -1921,8 +1928,57 @@ namespace TreeGenerationSystemLogic {
                 modified
             );
 
-            if (modified) touchedSections.insert(sectionCoord);
-            if (modified) {
+
+            job.modified = modified;
+            job.edits = std::move(view.edits);
+            job.spills = std::move(view.spills);
+        };
+
+        // "TreeDecorationThreads" counts the main thread; 1 decorates serially
+        // and 0 picks the hardware thread count, capped at 8.
+        int threads = getRegistryInt(baseSystem, "TreeDecorationThreads", 0);
+        if (threads <= 0) {
+            threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 8);
+        }
+        threads = std::min(threads, 32);
+        if (!g_treeDecorationPool || g_treeDecorationPoolThreads != threads) {
+            g_treeDecorationPool.reset();
+            g_treeDecorationPool = std::make_unique<RayTraceWorkerPool>(threads - 1);
+            g_treeDecorationPoolThreads = threads;
+        }
+        g_treeDecorationPool->run(jobs.size(), decorate);
+
+        // Merge in job order so the result does not depend on the thread count.
+        // A placement into a cell the job saw as air yields to whatever an
+        // earlier job put there, along with the job's later writes to it.
+        std::unordered_set<glm::ivec3, IVec3Hash> yielded;
+        for (DecorationJob& job : jobs) {
+            bool forceBackfill = false;
+            if (!passesVersionGate(job.key, forceBackfill)) continue;
+
+            yielded.clear();
+            auto applyEdit = [&](const DecorationEdit& edit) {
+                if (!yielded.empty() && yielded.count(edit.cell) > 0) return false;
+                if (edit.intoAir && voxelWorld.getBlockWorld(edit.cell) != 0) {
+                    yielded.insert(edit.cell);
+                    return false;
+                }
+                voxelWorld.setBlockLod(0, edit.cell, edit.id, edit.color, false);
+                return true;
+            };
+            for (const auto& edit : job.edits) applyEdit(edit);
+
+            std::unordered_set<glm::ivec3, IVec3Hash> touchedSections;
+            for (const auto& spill : job.spills) {
+                if (!applyEdit(spill)) continue;
+                touchedSections.insert(glm::ivec3(
+                    floorDivInt(spill.cell.x, voxelWorld.sectionSize),
+                    floorDivInt(spill.cell.y, voxelWorld.sectionSize),
+                    floorDivInt(spill.cell.z, voxelWorld.sectionSize)
+                ));
+            }
+            if (job.modified) {
+                touchedSections.insert(job.key.coord);
                 for (const auto& touched : touchedSections) {
                     VoxelSectionKey touchedKey{0, touched};
                     auto touchedIt = voxelWorld.sections.find(touchedKey);
@@ -1932,12 +1988,12 @@ namespace TreeGenerationSystemLogic {
                     voxelWorld.dirtySections.insert(touchedKey);
                 }
             }
-            auto finalSectionIt = voxelWorld.sections.find(key);
+            auto finalSectionIt = voxelWorld.sections.find(job.key);
             if (finalSectionIt != voxelWorld.sections.end()) {
-                g_treeAppliedVersion[key] = finalSectionIt->second.editVersion;
+                g_treeAppliedVersion[job.key] = finalSectionIt->second.editVersion;
             }
             if (forceBackfill) {
-                g_treeBackfillVisited.insert(key);
+                g_treeBackfillVisited.insert(job.key);
             }
         }
     }
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Immediate-mode batching for the 2D UI. Systems submit triangle lists that
+// are already in NDC, each tagged with the draw state it needs (program,
+// texture, scissor). A submission joins the most recent run with the same
+// state as long as nothing drawn in between overlaps it, so painter's order
+// is kept while interleaved panels, buttons and labels collapse into a few
+// draws. Nothing here touches GL: the render side copies the ordered
+// vertices into its buffer with write() and issues one draw per run.
+//
+// Lane submissions are the exception: they name vertex ranges of a buffer
+// the render side keeps across frames (see LaneGeometry.h) instead of
+// carrying vertices, and a Lane run is drawn as one multi-draw over them.
+namespace UIBatch {
+
+    // Lane: retained lane geometry; the state's texture names the layer.
+    enum class Program : uint8_t { Color = 0, Text = 1, Lane = 2 };
+
+    // Scissor rectangle in framebuffer pixels, bottom-left origin like glScissor.
+    struct Clip {
+        bool enabled = false;
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+
+        bool operator==(const Clip& other) const {
+            if (!enabled || !other.enabled) return enabled == other.enabled;
+            return x == other.x && y == other.y && w == other.w && h == other.h;
+        }
+        bool operator!=(const Clip& other) const { return !(*this == other); }
+    };
+
+    struct State {
+        Program program = Program::Color;
+        uint32_t texture = 0;
+        Clip clip;
+
+        bool operator==(const State& other) const {
+            return program == other.program && texture == other.texture && clip == other.clip;
+        }
+        bool operator!=(const State& other) const { return !(*this == other); }
+    };
+
+    // Shared vertex format: NDC position, texture coordinate and RGBA8 color
+    // (bytes in r, g, b, a order, read as normalized unsigned bytes).
+    struct Vertex {
+        float x = 0.0f;
+        float y = 0.0f;
+        float u = 0.0f;
+        float v = 0.0f;
+        uint32_t color = 0;
+    };
+
+    inline uint32_t packColor(float r, float g, float b, float a) {
+        auto channel = [](float value) {
+            // Rounds half up like lround on the clamped range, without the libm call.
+            return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        };
+        return channel(r) | (channel(g) << 8u) | (channel(b) << 16u) | (channel(a) << 24u);
+    }
+
+    // Vertices [first, first + count) of a retained buffer.
+    struct Range {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    // For Lane draws, first and count index ranges() instead of the
+    // written vertices.
+    struct Draw {
+        State state;
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    // Rectangle in NDC a submission can touch.
+    struct Bounds {
+        float minX = 0.0f;
+        float minY = 0.0f;
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+
+        bool overlaps(const Bounds& other) const {
+            return minX < other.maxX && other.minX < maxX && minY < other.maxY && other.minY < maxY;
+        }
+        void merge(const Bounds& other) {
+            minX = std::min(minX, other.minX);
+            minY = std::min(minY, other.minY);
+            maxX = std::max(maxX, other.maxX);
+            maxY = std::max(maxY, other.maxY);
+        }
+    };
+
+    struct Stats {
+        uint32_t submits = 0;
+        uint32_t draws = 0;
+        uint32_t vertices = 0;
+        size_t bytes = 0;
+        uint32_t flushes = 0;
+
+        void add(const Stats& other) {
+            submits += other.submits;
+            draws += other.draws;
+            vertices += other.vertices;
+            bytes += other.bytes;
+            flushes += other.flushes;
+        }
+    };
+
+    struct TextOverlay;
+
+    class Builder {
+    public:
+        // How many runs back a submission may move to join a matching one.
+        static constexpr size_t kMergeLookback = 8;
+
+        // Untextured triangles; V needs glm-style `pos` (vec2) and `color` (vec3).
+        template <class V>
+        void addColored(const std::vector<V>& source, float alpha, const Clip& clip = Clip{}) {
+            addColored(source.data(), source.size(), alpha, clip);
+        }
+
+        template <class V>
+        void addColored(const V* source, size_t count, float alpha, const Clip& clip = Clip{}) {
+            if (count == 0) return;
+            State state;
+            state.program = Program::Color;
+            state.clip = clip;
+            const size_t first = vertices.size();
+            vertices.resize(first + count);
+            for (size_t i = 0; i < count; ++i) {
+                Vertex& out = vertices[first + i];
+                out.x = source[i].pos.x;
+                out.y = source[i].pos.y;
+                out.color = packColor(source[i].color.r, source[i].color.g, source[i].color.b, alpha);
+            }
+            commit(state, first, count);
+        }
+
+        // Colored triangles with text laid over them at the points recorded
+        // in `labels`, so each label keeps its place in the painter's order.
+        template <class V>
+        void addColored(const V* source, size_t count, float alpha, const TextOverlay& labels,
+                        const Clip& clip = Clip{});
+
+        template <class V>
+        void addColored(const std::vector<V>& source, float alpha, const TextOverlay& labels,
+                        const Clip& clip = Clip{}) {
+            addColored(source.data(), source.size(), alpha, labels, clip);
+        }
+
+        // Vertices packed ahead of time, such as laid-out glyph quads.
+        // `alpha` replaces the alpha each vertex was packed with.
+        void addPacked(Program program, uint32_t texture, const Vertex* source, size_t count, float alpha,
+                       const Clip& clip = Clip{}) {
+            if (count == 0) return;
+            State state;
+            state.program = program;
+            state.texture = texture;
+            state.clip = clip;
+            const uint32_t alphaBits = packColor(0.0f, 0.0f, 0.0f, alpha) & 0xff000000u;
+            const size_t first = vertices.size();
+            vertices.resize(first + count);
+            for (size_t i = 0; i < count; ++i) {
+                Vertex& out = vertices[first + i];
+                out = source[i];
+                out.color = (out.color & 0x00ffffffu) | alphaBits;
+            }
+            commit(state, first, count);
+        }
+
+        // Ranges of retained layer `layer` (see LaneGeometry.h), all of
+        // which stay inside `bounds`.
+        void addRanges(uint32_t layer, const Range* source, size_t count, const Bounds& bounds,
+                       const Clip& clip = Clip{}) {
+            if (count == 0) return;
+            State state;
+            state.program = Program::Lane;
+            state.texture = layer;
+            state.clip = clip;
+            const size_t first = rangeList.size();
+            rangeList.insert(rangeList.end(), source, source + count);
+            commit(state, first, count, bounds);
+        }
+
+        bool empty() const { return segments.empty(); }
+        size_t vertexCount() const { return vertices.size(); }
+        size_t submitCount() const { return segments.size(); }
+
+        // Draws in submission-safe order. Run i covers
+        // [draws()[i].first, first + count) of the vertices written by
+        // write(), or of ranges() for a Lane run.
+        const std::vector<Draw>& draws() {
+            if (!finalized) finalize();
+            return drawList;
+        }
+
+        // Every Lane submission's ranges in draw order.
+        const std::vector<Range>& ranges() {
+            if (!finalized) finalize();
+            return orderedRanges;
+        }
+
+        // Copies every vertex into `dst` (vertexCount() entries) in draw order.
+        void write(Vertex* dst) {
+            if (!finalized) finalize();
+            std::vector<uint32_t> cursor(runs.size());
+            for (size_t r = 0; r < runs.size(); ++r) cursor[r] = drawList[r].first;
+            for (const Segment& segment : segments) {
+                if (runs[segment.run].state.program == Program::Lane) continue;
+                std::copy(vertices.begin() + segment.first, vertices.begin() + segment.first + segment.count,
+                          dst + cursor[segment.run]);
+                cursor[segment.run] += segment.count;
+            }
+        }
+
+        Stats stats() {
+            Stats result;
+            result.submits = static_cast<uint32_t>(segments.size());
+            result.draws = static_cast<uint32_t>(draws().size());
+            result.vertices = static_cast<uint32_t>(vertices.size());
+            result.bytes = vertices.size() * sizeof(Vertex);
+            return result;
+        }
+
+        void clear() {
+            vertices.clear();
+            rangeList.clear();
+            segments.clear();
+            runs.clear();
+            drawList.clear();
+            orderedRanges.clear();
+            finalized = false;
+        }
+
+    private:
+        struct Run {
+            State state;
+            Bounds bounds;
+            uint32_t count = 0;
+        };
+
+        struct Segment {
+            uint32_t first = 0;
+            uint32_t count = 0;
+            uint32_t run = 0;
+        };
+
+        // A segment's first/count index vertices, or rangeList for Lane.
+        std::vector<Vertex> vertices;
+        std::vector<Range> rangeList;
+        std::vector<Segment> segments;
+        std::vector<Run> runs;
+        std::vector<Draw> drawList;
+        std::vector<Range> orderedRanges;
+        bool finalized = false;
+
+        Bounds boundsOf(size_t first, size_t count) const {
+            Bounds bounds{vertices[first].x, vertices[first].y, vertices[first].x, vertices[first].y};
+            for (size_t i = first + 1; i < first + count; ++i) {
+                bounds.minX = std::min(bounds.minX, vertices[i].x);
+                bounds.minY = std::min(bounds.minY, vertices[i].y);
+                bounds.maxX = std::max(bounds.maxX, vertices[i].x);
+                bounds.maxY = std::max(bounds.maxY, vertices[i].y);
+            }
+            return bounds;
+        }
+
+        // Moving a submission back to run r draws it before every later run,
+        // which is only invisible if it overlaps none of them.
+        void commit(const State& state, size_t first, size_t count) {
+            commit(state, first, count, boundsOf(first, count));
+        }
+
+        void commit(const State& state, size_t first, size_t count, const Bounds& bounds) {
+            finalized = false;
+            size_t target = runs.size();
+            const size_t stop = runs.size() > kMergeLookback ? runs.size() - kMergeLookback : 0;
+            for (size_t r = runs.size(); r > stop; --r) {
+                Run& run = runs[r - 1];
+                if (run.state == state) {
+                    target = r - 1;
+                    break;
+                }
+                if (run.bounds.overlaps(bounds)) break;
+            }
+            if (target == runs.size()) {
+                runs.push_back(Run{state, bounds, 0});
+            } else {
+                runs[target].bounds.merge(bounds);
+            }
+            runs[target].count += static_cast<uint32_t>(count);
+            segments.push_back({static_cast<uint32_t>(first), static_cast<uint32_t>(count), static_cast<uint32_t>(target)});
+        }
+
+        void finalize() {
+            drawList.resize(runs.size());
+            uint32_t offset = 0;
+            uint32_t rangeOffset = 0;
+            for (size_t r = 0; r < runs.size(); ++r) {
+                uint32_t& next = runs[r].state.program == Program::Lane ? rangeOffset : offset;
+                drawList[r].state = runs[r].state;
+                drawList[r].first = next;
+                drawList[r].count = runs[r].count;
+                next += runs[r].count;
+            }
+            orderedRanges.resize(rangeList.size());
+            std::vector<uint32_t> cursor(runs.size());
+            for (size_t r = 0; r < runs.size(); ++r) cursor[r] = drawList[r].first;
+            for (const Segment& segment : segments) {
+                if (runs[segment.run].state.program != Program::Lane) continue;
+                std::copy(rangeList.begin() + segment.first, rangeList.begin() + segment.first + segment.count,
+                          orderedRanges.begin() + cursor[segment.run]);
+                cursor[segment.run] += segment.count;
+            }
+            finalized = true;
+        }
+    };
+
+    // Glyph quads a system lays over its own colored vertex stream. Each mark
+    // says where in that stream its quads were added, so caches that keep a
+    // static prefix of the stream can keep the matching prefix of marks.
+    struct TextOverlay {
+        struct Mark {
+            uint32_t at = 0;      // colored vertices drawn before this text
+            uint32_t texture = 0;
+            uint32_t first = 0;
+            uint32_t count = 0;
+        };
+
+        std::vector<Vertex> vertices;
+        std::vector<Mark> marks;
+
+        // Records vertices [first, end) as text at `at`; joins the previous
+        // mark when nothing was drawn in between.
+        void mark(size_t at, uint32_t texture, size_t first) {
+            const uint32_t count = static_cast<uint32_t>(vertices.size() - first);
+            if (count == 0) return;
+            if (!marks.empty()) {
+                Mark& last = marks.back();
+                if (last.at == at && last.texture == texture && last.first + last.count == first) {
+                    last.count += count;
+                    return;
+                }
+            }
+            marks.push_back({static_cast<uint32_t>(at), texture, static_cast<uint32_t>(first), count});
+        }
+
+        // Size of the overlay at some point, to cut back to later. Marks
+        // added after it may have been joined onto its last mark, so that
+        // mark's count is kept too.
+        struct Prefix {
+            size_t marks = 0;
+            size_t vertices = 0;
+            uint32_t lastCount = 0;
+        };
+
+        Prefix prefix() const {
+            return {marks.size(), vertices.size(), marks.empty() ? 0u : marks.back().count};
+        }
+
+        void truncate(const Prefix& keep) {
+            if (keep.marks > marks.size() || keep.vertices > vertices.size()) return;
+            marks.resize(keep.marks);
+            if (!marks.empty()) marks.back().count = keep.lastCount;
+            vertices.resize(keep.vertices);
+        }
+
+        void clear() {
+            vertices.clear();
+            marks.clear();
+        }
+    };
+
+    template <class V>
+    void Builder::addColored(const V* source, size_t count, float alpha, const TextOverlay& labels, const Clip& clip) {
+        size_t done = 0;
+        for (const TextOverlay::Mark& mark : labels.marks) {
+            const size_t at = std::min<size_t>(mark.at, count);
+            if (at > done) {
+                addColored(source + done, at - done, alpha, clip);
+                done = at;
+            }
+            addPacked(Program::Text, mark.texture, labels.vertices.data() + mark.first, mark.count, alpha, clip);
+        }
+        if (done < count) addColored(source + done, count - done, alpha, clip);
+    }
+}
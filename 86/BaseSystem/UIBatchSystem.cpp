@@ -0,0 +1,422 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+#include "BaseSystem/LaneGeometry.h"
+#include "BaseSystem/RenderDevice.h"
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic {
+    namespace {
+        constexpr size_t kRingInitialVertices = 64 * 1024;
+        constexpr uint64_t kFenceWaitNs = 1000000; // re-check every millisecond
+        constexpr size_t kLaneInitialVertices = 64 * 1024;
+
+        struct FencedRange {
+            RenderDevice::Fence fence = 0;
+            size_t begin = 0;
+            size_t end = 0;
+        };
+
+        UIBatch::Builder g_builder;
+        uint64_t g_builderFrame = 0;
+        bool g_warnedStale = false;
+
+        UIBatch::Stats g_frameStats;
+        UIBatch::Stats g_lastFrameStats;
+        uint64_t g_statsFrame = 0;
+
+        // Vertex ring: one GL buffer written front to back, wrapping to 0.
+        // Every flush fences the range it used; a range is only rewritten
+        // once the GPU has passed its fence.
+        size_t g_ringCapacity = 0; // bytes, a whole number of vertices
+        size_t g_ringHead = 0;
+        unsigned char* g_ringMapped = nullptr; // non-null when persistently mapped
+        std::deque<FencedRange> g_ringFences;
+
+        // A LaneGeometry::Store's copy on the GPU. Only the ranges the store
+        // reports dirty are uploaded; a compaction or growth replaces it.
+        struct LaneLayer {
+            LaneGeometry::Store* store = nullptr;
+            GLuint vao = 0;
+            GLuint vbo = 0;
+            size_t capacity = 0; // vertices
+            uint64_t generation = 0;
+            bool uploaded = false;
+        };
+
+        std::vector<LaneLayer> g_laneLayers;
+
+        void rollFrame(uint64_t frameIndex) {
+            if (g_statsFrame == frameIndex) return;
+            g_lastFrameStats = g_frameStats;
+            g_frameStats = UIBatch::Stats{};
+            g_statsFrame = frameIndex;
+        }
+
+        void waitFence(RenderDevice::Fence fence) {
+            while (!RenderDevice::current().waitFence(fence, kFenceWaitNs)) {}
+        }
+
+        void waitAllFences() {
+            for (FencedRange& range : g_ringFences) {
+                waitFence(range.fence);
+                RenderDevice::current().deleteFence(range.fence);
+            }
+            g_ringFences.clear();
+        }
+
+        void releaseRing(RendererContext& renderer) {
+            waitAllFences();
+            RenderDevice::Device& device = RenderDevice::current();
+            if (renderer.uiBatchVBO) {
+                if (g_ringMapped) {
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.uiBatchVBO);
+                    device.unmapBuffer(GL_ARRAY_BUFFER);
+                }
+                device.deleteBuffer(renderer.uiBatchVBO);
+                renderer.uiBatchVBO = 0;
+            }
+            g_ringMapped = nullptr;
+            g_ringCapacity = 0;
+            g_ringHead = 0;
+        }
+
+        // (Re)creates the ring and points the batch VAO at it. Uses immutable
+        // storage mapped once for the buffer's lifetime when the device has
+        // buffer storage, otherwise maps each flush's range unsynchronized.
+        void allocateRing(RendererContext& renderer, size_t capacityBytes) {
+            releaseRing(renderer);
+            RenderDevice::Device& device = RenderDevice::current();
+            device.bindVertexArray(renderer.uiBatchVAO);
+            renderer.uiBatchVBO = device.createBuffer();
+            device.bindBuffer(GL_ARRAY_BUFFER, renderer.uiBatchVBO);
+#if defined(GL_MAP_PERSISTENT_BIT)
+            if (device.hasBufferStorage()) {
+                const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                device.bufferStorage(GL_ARRAY_BUFFER, capacityBytes, nullptr, flags);
+                g_ringMapped = static_cast<unsigned char*>(device.mapBufferRange(GL_ARRAY_BUFFER, 0, capacityBytes, flags));
+                if (!g_ringMapped) {
+                    // Immutable storage cannot be respecified; start over with a plain buffer.
+                    device.deleteBuffer(renderer.uiBatchVBO);
+                    renderer.uiBatchVBO = device.createBuffer();
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.uiBatchVBO);
+                }
+            }
+#endif
+            if (!g_ringMapped) {
+                device.bufferData(GL_ARRAY_BUFFER, capacityBytes, nullptr, GL_STREAM_DRAW);
+            }
+            g_ringCapacity = capacityBytes;
+            g_ringHead = 0;
+
+            const GLsizei stride = sizeof(UIBatch::Vertex);
+            device.vertexAttribPointer(0, 2, GL_FLOAT, false, stride, offsetof(UIBatch::Vertex, x));
+            device.enableVertexAttribArray(0);
+            device.vertexAttribPointer(1, 2, GL_FLOAT, false, stride, offsetof(UIBatch::Vertex, u));
+            device.enableVertexAttribArray(1);
+            device.vertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, true, stride, offsetof(UIBatch::Vertex, color));
+            device.enableVertexAttribArray(2);
+        }
+
+        void ensureResources(RendererContext& renderer, WorldContext& world) {
+            if (!renderer.uiBatchColorShader) {
+                renderer.uiBatchColorShader = std::make_unique<Shader>(world.shaders["UI_BATCH_VERTEX_SHADER"].c_str(),
+                                                                       world.shaders["UI_BATCH_COLOR_FRAGMENT_SHADER"].c_str());
+            }
+            if (!renderer.uiBatchTextShader) {
+                renderer.uiBatchTextShader = std::make_unique<Shader>(world.shaders["UI_BATCH_VERTEX_SHADER"].c_str(),
+                                                                      world.shaders["UI_BATCH_TEXT_FRAGMENT_SHADER"].c_str());
+            }
+            if (renderer.uiBatchVAO == 0) {
+                renderer.uiBatchVAO = RenderDevice::current().createVertexArray();
+            }
+            if (renderer.uiBatchVBO == 0) {
+                allocateRing(renderer, kRingInitialVertices * sizeof(UIBatch::Vertex));
+            }
+            if (!renderer.uiLaneShader) {
+                renderer.uiLaneShader = std::make_unique<Shader>(world.shaders["UI_LANE_VERTEX_SHADER"].c_str(),
+                                                                 world.shaders["UI_BATCH_COLOR_FRAGMENT_SHADER"].c_str());
+            }
+        }
+
+        LaneLayer* laneLayer(uint32_t storeId) {
+            for (LaneLayer& layer : g_laneLayers) {
+                if (layer.store && layer.store->id() == storeId) return &layer;
+            }
+            return nullptr;
+        }
+
+        // Brings the layer's buffer up to date with its store and leaves its
+        // VAO bound.
+        void syncLaneLayer(LaneLayer& layer) {
+            RenderDevice::Device& device = RenderDevice::current();
+            LaneGeometry::Store& store = *layer.store;
+            const std::vector<LaneGeometry::Vertex>& vertices = store.vertices();
+            if (layer.vao == 0) {
+                layer.vao = device.createVertexArray();
+                layer.vbo = device.createBuffer();
+                device.bindVertexArray(layer.vao);
+                device.bindBuffer(GL_ARRAY_BUFFER, layer.vbo);
+                const GLsizei stride = sizeof(LaneGeometry::Vertex);
+                device.vertexAttribPointer(0, 4, GL_FLOAT, false, stride, offsetof(LaneGeometry::Vertex, anchor));
+                device.enableVertexAttribArray(0);
+                device.vertexAttribPointer(1, 4, GL_FLOAT, false, stride, offsetof(LaneGeometry::Vertex, clip));
+                device.enableVertexAttribArray(1);
+                device.vertexAttribPointer(2, 1, GL_FLOAT, false, stride, offsetof(LaneGeometry::Vertex, dx));
+                device.enableVertexAttribArray(2);
+                device.vertexAttribPointer(3, 2, GL_FLOAT, false, stride, offsetof(LaneGeometry::Vertex, dy));
+                device.enableVertexAttribArray(3);
+                device.vertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, true, stride, offsetof(LaneGeometry::Vertex, color));
+                device.enableVertexAttribArray(4);
+                device.vertexAttribIPointer(5, 1, GL_UNSIGNED_INT, stride, offsetof(LaneGeometry::Vertex, meta));
+                device.enableVertexAttribArray(5);
+            } else {
+                device.bindVertexArray(layer.vao);
+                device.bindBuffer(GL_ARRAY_BUFFER, layer.vbo);
+            }
+            const size_t stride = sizeof(LaneGeometry::Vertex);
+            if (!layer.uploaded || layer.generation != store.generation() || layer.capacity < vertices.size()) {
+                size_t capacity = std::max(layer.capacity, kLaneInitialVertices);
+                while (capacity < vertices.size()) capacity *= 2;
+                device.bufferData(GL_ARRAY_BUFFER, capacity * stride, nullptr, GL_DYNAMIC_DRAW);
+                device.bufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * stride, vertices.data());
+                store.takeDirty();
+                layer.capacity = capacity;
+                layer.generation = store.generation();
+                layer.uploaded = true;
+                return;
+            }
+            for (const UIBatch::Range& range : store.takeDirty()) {
+                device.bufferSubData(GL_ARRAY_BUFFER, range.first * stride, range.count * stride,
+                                     vertices.data() + range.first);
+            }
+        }
+
+        // Uniforms for one Lane run; the layer's page of lane centers goes
+        // in uCenterY.
+        void applyLaneTransform(Shader& shader, const LaneGeometry::Transform& transform, uint32_t page) {
+            shader.setVec2("uOffset", glm::vec2(transform.offset[0], transform.offset[1]));
+            shader.setVec2("uWindow", glm::vec2(transform.window[0], transform.window[1]));
+            shader.setVec2("uLane", glm::vec2(transform.laneLeft, transform.laneRight));
+            shader.setVec2("uScreen", glm::vec2(transform.screenWidth, transform.screenHeight));
+            shader.setFloat("uAlpha", transform.alpha);
+            float centers[LaneGeometry::kLanesPerPage] = {};
+            const size_t first = static_cast<size_t>(page) * LaneGeometry::kLanesPerPage;
+            for (size_t i = 0; i < LaneGeometry::kLanesPerPage && first + i < transform.centerY.size(); ++i) {
+                centers[i] = transform.centerY[first + i];
+            }
+            RenderDevice::current().uniformVec4Array(shader.ID, "uCenterY", centers,
+                                                     static_cast<int>(LaneGeometry::kLanesPerPage / 4));
+        }
+
+        // Byte offset of a free, GPU-idle range of `bytes` in the ring.
+        size_t reserveRing(RendererContext& renderer, size_t bytes) {
+            if (bytes > g_ringCapacity) {
+                size_t capacity = g_ringCapacity;
+                while (capacity < bytes * 2) capacity *= 2;
+                std::cout << "UIBatchSystem: growing vertex ring to " << (capacity / 1024) << " KB" << std::endl;
+                allocateRing(renderer, capacity);
+            }
+            if (g_ringHead + bytes > g_ringCapacity) g_ringHead = 0;
+            const size_t begin = g_ringHead;
+            const size_t end = begin + bytes;
+            // Ranges are fenced in allocation order, so the oldest live range
+            // is always the next one the head runs into.
+            while (!g_ringFences.empty()) {
+                const FencedRange& oldest = g_ringFences.front();
+                if (oldest.end <= begin || oldest.begin >= end) break;
+                waitFence(oldest.fence);
+                RenderDevice::current().deleteFence(oldest.fence);
+                g_ringFences.pop_front();
+            }
+            return begin;
+        }
+
+        Shader* shaderFor(RendererContext& renderer, UIBatch::Program program) {
+            if (program == UIBatch::Program::Lane) return renderer.uiLaneShader.get();
+            return program == UIBatch::Program::Text ? renderer.uiBatchTextShader.get()
+                                                     : renderer.uiBatchColorShader.get();
+        }
+
+        void applyClip(const UIBatch::Clip& clip) {
+            RenderDevice::Device& device = RenderDevice::current();
+            if (clip.enabled) {
+                device.enable(GL_SCISSOR_TEST);
+                device.scissor(clip.x, clip.y, clip.w, clip.h);
+            } else {
+                device.disable(GL_SCISSOR_TEST);
+            }
+        }
+    }
+
+    // Batch collecting this frame's UI. Submissions left over from an
+    // earlier frame that never reached a flush are dropped.
+    UIBatch::Builder& Frame(BaseSystem& baseSystem) {
+        rollFrame(baseSystem.frameIndex);
+        if (g_builderFrame != baseSystem.frameIndex) {
+            if (!g_builder.empty()) {
+                if (!g_warnedStale) {
+                    std::cerr << "UIBatchSystem: dropping UI submitted without a flush (is UIBatchSystem installed?)" << std::endl;
+                    g_warnedStale = true;
+                }
+                g_builder.clear();
+            }
+            g_builderFrame = baseSystem.frameIndex;
+        }
+        return g_builder;
+    }
+
+    // Lets Lane submissions name `store` (see LaneGeometry::Plan::submit).
+    // The store must outlive the batch system; lane systems keep theirs in
+    // statics.
+    void UseLaneStore(BaseSystem& baseSystem, LaneGeometry::Store& store) {
+        (void)baseSystem;
+        if (laneLayer(store.id())) return;
+        LaneLayer layer;
+        layer.store = &store;
+        g_laneLayers.push_back(layer);
+    }
+
+    // Counts for the last completed frame.
+    UIBatch::Stats LastFrameStats() {
+        return g_lastFrameStats;
+    }
+
+    // Uploads everything submitted so far in one write and draws it. Lane
+    // runs draw from their store's own buffer, synced first.
+    void Flush(BaseSystem& baseSystem) {
+        UIBatch::Builder& builder = Frame(baseSystem);
+        if (builder.empty() || !baseSystem.renderer || !baseSystem.world) {
+            builder.clear();
+            return;
+        }
+        RendererContext& renderer = *baseSystem.renderer;
+        ensureResources(renderer, *baseSystem.world);
+
+        const std::vector<UIBatch::Draw>& draws = builder.draws();
+        const std::vector<UIBatch::Range>& ranges = builder.ranges();
+        UIBatch::Stats stats = builder.stats();
+        stats.flushes = 1;
+        RenderDevice::Device& device = RenderDevice::current();
+        size_t offset = 0;
+        if (stats.bytes > 0) {
+            offset = reserveRing(renderer, stats.bytes);
+            device.bindVertexArray(renderer.uiBatchVAO);
+            device.bindBuffer(GL_ARRAY_BUFFER, renderer.uiBatchVBO);
+            if (g_ringMapped) {
+                builder.write(reinterpret_cast<UIBatch::Vertex*>(g_ringMapped + offset));
+            } else {
+                const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+                void* dst = device.mapBufferRange(GL_ARRAY_BUFFER, offset, stats.bytes, access);
+                if (!dst) {
+                    builder.clear();
+                    device.bindVertexArray(0);
+                    return;
+                }
+                builder.write(static_cast<UIBatch::Vertex*>(dst));
+                device.unmapBuffer(GL_ARRAY_BUFFER);
+            }
+            device.wroteMapped(stats.bytes);
+        }
+
+        device.disable(GL_DEPTH_TEST);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.activeTexture(GL_TEXTURE0);
+
+        const GLint baseVertex = static_cast<GLint>(offset / sizeof(UIBatch::Vertex));
+        Shader* boundShader = nullptr;
+        GLuint boundTexture = 0;
+        GLuint boundVAO = 0;
+        bool clipKnown = false;
+        UIBatch::Clip boundClip;
+        std::vector<GLint> laneFirsts;
+        std::vector<GLsizei> laneCounts;
+        for (const UIBatch::Draw& draw : draws) {
+            const bool lane = draw.state.program == UIBatch::Program::Lane;
+            LaneLayer* layer = lane ? laneLayer(draw.state.texture & 0xffffu) : nullptr;
+            if (lane && !layer) continue;
+            Shader* shader = shaderFor(renderer, draw.state.program);
+            if (shader != boundShader) {
+                shader->use();
+                if (draw.state.program == UIBatch::Program::Text) shader->setInt("fontTex", 0);
+                boundShader = shader;
+            }
+            if (lane) {
+                syncLaneLayer(*layer);
+                boundVAO = layer->vao;
+                applyLaneTransform(*shader, layer->store->transform, draw.state.texture >> 16u);
+            } else {
+                if (boundVAO != renderer.uiBatchVAO) {
+                    device.bindVertexArray(renderer.uiBatchVAO);
+                    boundVAO = renderer.uiBatchVAO;
+                }
+                if (draw.state.texture != boundTexture) {
+                    device.bindTexture(GL_TEXTURE_2D, draw.state.texture);
+                    boundTexture = draw.state.texture;
+                }
+            }
+            if (!clipKnown || draw.state.clip != boundClip) {
+                applyClip(draw.state.clip);
+                boundClip = draw.state.clip;
+                clipKnown = true;
+            }
+            if (lane) {
+                laneFirsts.clear();
+                laneCounts.clear();
+                for (uint32_t i = draw.first; i < draw.first + draw.count; ++i) {
+                    laneFirsts.push_back(static_cast<GLint>(ranges[i].first));
+                    laneCounts.push_back(static_cast<GLsizei>(ranges[i].count));
+                }
+                device.multiDrawArrays(GL_TRIANGLES, laneFirsts.data(), laneCounts.data(),
+                                       static_cast<GLsizei>(laneFirsts.size()));
+            } else {
+                device.drawArrays(GL_TRIANGLES, baseVertex + static_cast<GLint>(draw.first),
+                                  static_cast<GLsizei>(draw.count));
+            }
+        }
+
+        if (stats.bytes > 0) {
+            g_ringFences.push_back({device.fenceSync(), offset, offset + stats.bytes});
+            g_ringHead = offset + stats.bytes;
+        }
+
+        device.disable(GL_SCISSOR_TEST);
+        device.bindTexture(GL_TEXTURE_2D, 0);
+        device.bindVertexArray(0);
+        device.enable(GL_DEPTH_TEST);
+
+        g_frameStats.add(stats);
+        builder.clear();
+    }
+
+    void FlushUIBatch(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
+        (void)prototypes; (void)dt; (void)win;
+        Flush(baseSystem);
+    }
+
+    void CleanupUIBatch(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
+        (void)prototypes; (void)dt; (void)win;
+        g_builder.clear();
+        if (!baseSystem.renderer) return;
+        RendererContext& renderer = *baseSystem.renderer;
+        releaseRing(renderer);
+        for (LaneLayer& layer : g_laneLayers) {
+            if (layer.vbo) RenderDevice::current().deleteBuffer(layer.vbo);
+            if (layer.vao) RenderDevice::current().deleteVertexArray(layer.vao);
+        }
+        g_laneLayers.clear();
+        if (renderer.uiBatchVAO) {
+            RenderDevice::current().deleteVertexArray(renderer.uiBatchVAO);
+            renderer.uiBatchVAO = 0;
+        }
+        renderer.uiBatchColorShader.reset();
+        renderer.uiBatchTextShader.reset();
+        renderer.uiLaneShader.reset();
+    }
+}
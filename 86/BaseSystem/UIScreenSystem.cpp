@@ -2,6 +2,10 @@
 
 #include <GLFW/glfw3.h>
 
+#include "BaseSystem/UIBatch.h"
+
+namespace UIBatchSystemLogic { UIBatch::Builder& Frame(BaseSystem& baseSystem); }
+
 namespace UIScreenSystemLogic {
 
     namespace {
@@ -54,29 +58,6 @@ namespace UIScreenSystemLogic {
             return nullptr;
         }
 
-        void ensureUIResources(RendererContext& renderer, WorldContext& world) {
-            if (!renderer.uiShader) {
-                renderer.uiShader = std::make_unique<Shader>(world.shaders["UI_VERTEX_SHADER"].c_str(), world.shaders["UI_FRAGMENT_SHADER"].c_str());
-            }
-            if (renderer.uiVAO == 0) {
-                float quad[] = {
-                    -1.0f, -1.0f,
-                     1.0f, -1.0f,
-                     1.0f,  1.0f,
-                    -1.0f, -1.0f,
-                     1.0f,  1.0f,
-                    -1.0f,  1.0f
-                };
-                glGenVertexArrays(1, &renderer.uiVAO);
-                glGenBuffers(1, &renderer.uiVBO);
-                glBindVertexArray(renderer.uiVAO);
-                glBindBuffer(GL_ARRAY_BUFFER, renderer.uiVBO);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
-                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-                glEnableVertexAttribArray(0);
-            }
-        }
-
         int findWorldIndexByName(BaseSystem& baseSystem, const std::string& name) {
             if (!baseSystem.level) return -1;
             for (size_t i = 0; i < baseSystem.level->worlds.size(); ++i) {
@@ -164,9 +145,7 @@ namespace UIScreenSystemLogic {
         if (!ui.fullscreenActive) return;
 
         if (!baseSystem.renderer || !baseSystem.world) return;
-        RendererContext& renderer = *baseSystem.renderer;
         WorldContext& world = *baseSystem.world;
-        ensureUIResources(renderer, world);
 
         glm::vec3 screenColor(0.1f);
         int screenWorldIndex = findWorldIndexByName(baseSystem, "DAWScreenWorld");
@@ -183,17 +162,13 @@ namespace UIScreenSystemLogic {
             if (it != world.colorLibrary.end()) screenColor = it->second;
         }
 
-        if (renderer.uiShader) {
-            glDisable(GL_DEPTH_TEST);
-            glEnable(GL_BLEND);
-            glBlendColor(0.0f, 0.0f, 0.0f, kScreenAlpha);
-            glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
-            renderer.uiShader->use();
-            renderer.uiShader->setVec3("color", screenColor);
-            glBindVertexArray(renderer.uiVAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glEnable(GL_DEPTH_TEST);
-        }
+        // Full-screen tint under the DAW panels; it opens the UI span, so the
+        // batch keeps it below everything submitted after it.
+        struct ScreenVertex { glm::vec2 pos; glm::vec3 color; };
+        const ScreenVertex quad[] = {
+            {{-1.0f, -1.0f}, screenColor}, {{ 1.0f, -1.0f}, screenColor}, {{ 1.0f,  1.0f}, screenColor},
+            {{-1.0f, -1.0f}, screenColor}, {{ 1.0f,  1.0f}, screenColor}, {{-1.0f,  1.0f}, screenColor}
+        };
+        UIBatchSystemLogic::Frame(baseSystem).addColored(quad, 6, kScreenAlpha);
     }
 }
@@ -320,6 +320,7 @@ namespace UIStampingSystemLogic {
                 }
                 world.instances[i] = std::move(inst);
             }
+            world.instanceEdits += 1;
         }
 
         bool dedupeTrackControlInstanceIds(BaseSystem& baseSystem, LevelContext& level) {
@@ -502,20 +503,24 @@ namespace UIStampingSystemLogic {
                     }
                 } else {
                     row0World.instances.clear();
+                    row0World.instanceEdits += 1;
                 }
             }
             if (stamp.sourceWorldIndex >= 0 && stamp.sourceWorldIndex < static_cast<int>(level.worlds.size())
                 && stamp.sourceWorldIndex != row0WorldIndex) {
                 level.worlds[stamp.sourceWorldIndex].instances.clear();
+                level.worlds[stamp.sourceWorldIndex].instanceEdits += 1;
             }
             if (stamp.midiSourceWorldIndex >= 0 && stamp.midiSourceWorldIndex < static_cast<int>(level.worlds.size())
                 && stamp.midiSourceWorldIndex != row0WorldIndex) {
                 level.worlds[stamp.midiSourceWorldIndex].instances.clear();
+                level.worlds[stamp.midiSourceWorldIndex].instanceEdits += 1;
             }
             if (stamp.automationSourceWorldIndex >= 0
                 && stamp.automationSourceWorldIndex < static_cast<int>(level.worlds.size())
                 && stamp.automationSourceWorldIndex != row0WorldIndex) {
                 level.worlds[stamp.automationSourceWorldIndex].instances.clear();
+                level.worlds[stamp.automationSourceWorldIndex].instanceEdits += 1;
             }
         }
         if (stamp.sourceWorldIndex >= 0 && stamp.sourceWorldIndex < static_cast<int>(level.worlds.size())) {
@@ -524,6 +529,7 @@ namespace UIStampingSystemLogic {
                 stampRow(sourceWorld, stamp.sourceInstances, stamp.sourceBaseY, stamp.rowOverrides, 0, 0, true, baseSystem, prototypes);
             } else if (daw.laneOrder.empty()) {
                 sourceWorld.instances.clear();
+                sourceWorld.instanceEdits += 1;
             }
         }
         if (desiredRows > static_cast<int>(stamp.rowWorldIndices.size())) {
@@ -559,6 +565,7 @@ namespace UIStampingSystemLogic {
                 int worldIndex = stamp.rowWorldIndices[row];
                 if (worldIndex < 0 || worldIndex >= static_cast<int>(level.worlds.size())) continue;
                 level.worlds[worldIndex].instances.clear();
+                level.worlds[worldIndex].instanceEdits += 1;
             }
             if (baseSystem.ui) baseSystem.ui->buttonCacheBuilt = false;
             if (baseSystem.font) baseSystem.font->textCacheBuilt = false;
@@ -613,6 +620,7 @@ namespace UIStampingSystemLogic {
             for (size_t i = 0; i < count; ++i) {
                 world.instances[i].position.y = srcY[i] + rowOffset;
             }
+            world.instanceEdits += 1;
         }
 
         if (dedupeTrackControlInstanceIds(baseSystem, level)) {
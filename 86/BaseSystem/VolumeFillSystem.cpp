@@ -34,6 +34,7 @@ namespace VolumeFillSystemLogic {
             }
 
             size_t afterCount = worldProto.instances.size();
+            worldProto.instanceEdits += 1;
             auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::steady_clock::now() - start
             ).count();
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace RenderInitSystemLogic {
     RenderBehavior BehaviorForPrototype(const Entity& proto);
     void DestroyVoxelGreedyRenderBuffers(VoxelGreedyRenderBuffers& buffers);
@@ -45,33 +47,34 @@ namespace VoxelMeshUploadSystemLogic {
                 }
             }
 
+            RenderDevice::Device& device = RenderDevice::current();
             for (int faceType = 0; faceType < 6; ++faceType) {
                 const auto& opaque = opaqueInstances[faceType];
                 buffers.opaqueCounts[faceType] = static_cast<int>(opaque.size());
                 if (buffers.opaqueCounts[faceType] > 0) {
-                    if (buffers.opaqueVaos[faceType] == 0) glGenVertexArrays(1, &buffers.opaqueVaos[faceType]);
-                    if (buffers.opaqueVBOs[faceType] == 0) glGenBuffers(1, &buffers.opaqueVBOs[faceType]);
+                    if (buffers.opaqueVaos[faceType] == 0) buffers.opaqueVaos[faceType] = device.createVertexArray();
+                    if (buffers.opaqueVBOs[faceType] == 0) buffers.opaqueVBOs[faceType] = device.createBuffer();
 
-                    glBindVertexArray(buffers.opaqueVaos[faceType]);
-                    glBindBuffer(GL_ARRAY_BUFFER, renderer.faceVBO);
-                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-                    glEnableVertexAttribArray(0);
-                    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-                    glEnableVertexAttribArray(1);
-                    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-                    glEnableVertexAttribArray(2);
+                    device.bindVertexArray(buffers.opaqueVaos[faceType]);
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.faceVBO);
+                    device.vertexAttribPointer(0, 3, GL_FLOAT, false, 8 * sizeof(float), 0);
+                    device.enableVertexAttribArray(0);
+                    device.vertexAttribPointer(1, 3, GL_FLOAT, false, 8 * sizeof(float), 3 * sizeof(float));
+                    device.enableVertexAttribArray(1);
+                    device.vertexAttribPointer(2, 2, GL_FLOAT, false, 8 * sizeof(float), 6 * sizeof(float));
+                    device.enableVertexAttribArray(2);
 
-                    glBindBuffer(GL_ARRAY_BUFFER, buffers.opaqueVBOs[faceType]);
-                    glBufferData(GL_ARRAY_BUFFER, opaque.size() * sizeof(FaceInstanceRenderData), opaque.data(), GL_STATIC_DRAW);
-                    glEnableVertexAttribArray(3); glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, position));
-                    glEnableVertexAttribArray(4); glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, color));
-                    glEnableVertexAttribArray(5); glVertexAttribIPointer(5, 1, GL_INT, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, tileIndex));
-                    glEnableVertexAttribArray(6); glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, alpha));
-                    glEnableVertexAttribArray(7); glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, ao));
-                    glEnableVertexAttribArray(8); glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, scale));
-                    glEnableVertexAttribArray(9); glVertexAttribPointer(9, 2, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, uvScale));
-                    glVertexAttribDivisor(3, 1); glVertexAttribDivisor(4, 1); glVertexAttribDivisor(5, 1);
-                    glVertexAttribDivisor(6, 1); glVertexAttribDivisor(7, 1); glVertexAttribDivisor(8, 1); glVertexAttribDivisor(9, 1);
+                    device.bindBuffer(GL_ARRAY_BUFFER, buffers.opaqueVBOs[faceType]);
+                    device.bufferData(GL_ARRAY_BUFFER, opaque.size() * sizeof(FaceInstanceRenderData), opaque.data(), GL_STATIC_DRAW);
+                    device.enableVertexAttribArray(3); device.vertexAttribPointer(3, 3, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, position));
+                    device.enableVertexAttribArray(4); device.vertexAttribPointer(4, 3, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, color));
+                    device.enableVertexAttribArray(5); device.vertexAttribIPointer(5, 1, GL_INT, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, tileIndex));
+                    device.enableVertexAttribArray(6); device.vertexAttribPointer(6, 1, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, alpha));
+                    device.enableVertexAttribArray(7); device.vertexAttribPointer(7, 4, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, ao));
+                    device.enableVertexAttribArray(8); device.vertexAttribPointer(8, 2, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, scale));
+                    device.enableVertexAttribArray(9); device.vertexAttribPointer(9, 2, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, uvScale));
+                    device.vertexAttribDivisor(3, 1); device.vertexAttribDivisor(4, 1); device.vertexAttribDivisor(5, 1);
+                    device.vertexAttribDivisor(6, 1); device.vertexAttribDivisor(7, 1); device.vertexAttribDivisor(8, 1); device.vertexAttribDivisor(9, 1);
                 } else {
                     buffers.opaqueCounts[faceType] = 0;
                 }
@@ -79,34 +82,34 @@ namespace VoxelMeshUploadSystemLogic {
                 const auto& alpha = alphaInstances[faceType];
                 buffers.alphaCounts[faceType] = static_cast<int>(alpha.size());
                 if (buffers.alphaCounts[faceType] > 0) {
-                    if (buffers.alphaVaos[faceType] == 0) glGenVertexArrays(1, &buffers.alphaVaos[faceType]);
-                    if (buffers.alphaVBOs[faceType] == 0) glGenBuffers(1, &buffers.alphaVBOs[faceType]);
+                    if (buffers.alphaVaos[faceType] == 0) buffers.alphaVaos[faceType] = device.createVertexArray();
+                    if (buffers.alphaVBOs[faceType] == 0) buffers.alphaVBOs[faceType] = device.createBuffer();
 
-                    glBindVertexArray(buffers.alphaVaos[faceType]);
-                    glBindBuffer(GL_ARRAY_BUFFER, renderer.faceVBO);
-                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-                    glEnableVertexAttribArray(0);
-                    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-                    glEnableVertexAttribArray(1);
-                    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-                    glEnableVertexAttribArray(2);
+                    device.bindVertexArray(buffers.alphaVaos[faceType]);
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.faceVBO);
+                    device.vertexAttribPointer(0, 3, GL_FLOAT, false, 8 * sizeof(float), 0);
+                    device.enableVertexAttribArray(0);
+                    device.vertexAttribPointer(1, 3, GL_FLOAT, false, 8 * sizeof(float), 3 * sizeof(float));
+                    device.enableVertexAttribArray(1);
+                    device.vertexAttribPointer(2, 2, GL_FLOAT, false, 8 * sizeof(float), 6 * sizeof(float));
+                    device.enableVertexAttribArray(2);
 
-                    glBindBuffer(GL_ARRAY_BUFFER, buffers.alphaVBOs[faceType]);
-                    glBufferData(GL_ARRAY_BUFFER, alpha.size() * sizeof(FaceInstanceRenderData), alpha.data(), GL_STATIC_DRAW);
-                    glEnableVertexAttribArray(3); glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, position));
-                    glEnableVertexAttribArray(4); glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, color));
-                    glEnableVertexAttribArray(5); glVertexAttribIPointer(5, 1, GL_INT, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, tileIndex));
-                    glEnableVertexAttribArray(6); glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, alpha));
-                    glEnableVertexAttribArray(7); glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, ao));
-                    glEnableVertexAttribArray(8); glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, scale));
-                    glEnableVertexAttribArray(9); glVertexAttribPointer(9, 2, GL_FLOAT, GL_FALSE, sizeof(FaceInstanceRenderData), (void*)offsetof(FaceInstanceRenderData, uvScale));
-                    glVertexAttribDivisor(3, 1); glVertexAttribDivisor(4, 1); glVertexAttribDivisor(5, 1);
-                    glVertexAttribDivisor(6, 1); glVertexAttribDivisor(7, 1); glVertexAttribDivisor(8, 1); glVertexAttribDivisor(9, 1);
+                    device.bindBuffer(GL_ARRAY_BUFFER, buffers.alphaVBOs[faceType]);
+                    device.bufferData(GL_ARRAY_BUFFER, alpha.size() * sizeof(FaceInstanceRenderData), alpha.data(), GL_STATIC_DRAW);
+                    device.enableVertexAttribArray(3); device.vertexAttribPointer(3, 3, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, position));
+                    device.enableVertexAttribArray(4); device.vertexAttribPointer(4, 3, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, color));
+                    device.enableVertexAttribArray(5); device.vertexAttribIPointer(5, 1, GL_INT, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, tileIndex));
+                    device.enableVertexAttribArray(6); device.vertexAttribPointer(6, 1, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, alpha));
+                    device.enableVertexAttribArray(7); device.vertexAttribPointer(7, 4, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, ao));
+                    device.enableVertexAttribArray(8); device.vertexAttribPointer(8, 2, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, scale));
+                    device.enableVertexAttribArray(9); device.vertexAttribPointer(9, 2, GL_FLOAT, false, sizeof(FaceInstanceRenderData), offsetof(FaceInstanceRenderData, uvScale));
+                    device.vertexAttribDivisor(3, 1); device.vertexAttribDivisor(4, 1); device.vertexAttribDivisor(5, 1);
+                    device.vertexAttribDivisor(6, 1); device.vertexAttribDivisor(7, 1); device.vertexAttribDivisor(8, 1); device.vertexAttribDivisor(9, 1);
                 } else {
                     buffers.alphaCounts[faceType] = 0;
                 }
             }
-            glBindVertexArray(0);
+            device.bindVertexArray(0);
         }
 
         void BuildVoxelRenderBuffers(BaseSystem& baseSystem,
@@ -157,6 +160,7 @@ namespace VoxelMeshUploadSystemLogic {
                 }
             }
 
+            RenderDevice::Device& device = RenderDevice::current();
             for (int i = 0; i < behaviorCount; ++i) {
                 RenderBehavior behavior = static_cast<RenderBehavior>(i);
                 bool isBranch = behavior == RenderBehavior::STATIC_BRANCH;
@@ -164,31 +168,31 @@ namespace VoxelMeshUploadSystemLogic {
                 buffers.counts[i] = count;
                 if (count == 0) continue;
 
-                if (buffers.vaos[i] == 0) glGenVertexArrays(1, &buffers.vaos[i]);
-                if (buffers.instanceVBOs[i] == 0) glGenBuffers(1, &buffers.instanceVBOs[i]);
+                if (buffers.vaos[i] == 0) buffers.vaos[i] = device.createVertexArray();
+                if (buffers.instanceVBOs[i] == 0) buffers.instanceVBOs[i] = device.createBuffer();
 
-                glBindVertexArray(buffers.vaos[i]);
-                glBindBuffer(GL_ARRAY_BUFFER, renderer.cubeVBO);
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
-                glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
-                glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
+                device.bindVertexArray(buffers.vaos[i]);
+                device.bindBuffer(GL_ARRAY_BUFFER, renderer.cubeVBO);
+                device.vertexAttribPointer(0, 3, GL_FLOAT, false, 8 * sizeof(float), 0); device.enableVertexAttribArray(0);
+                device.vertexAttribPointer(1, 3, GL_FLOAT, false, 8 * sizeof(float), 3 * sizeof(float)); device.enableVertexAttribArray(1);
+                device.vertexAttribPointer(2, 2, GL_FLOAT, false, 8 * sizeof(float), 6 * sizeof(float)); device.enableVertexAttribArray(2);
 
-                glBindBuffer(GL_ARRAY_BUFFER, buffers.instanceVBOs[i]);
+                device.bindBuffer(GL_ARRAY_BUFFER, buffers.instanceVBOs[i]);
                 if (isBranch) {
-                    glBufferData(GL_ARRAY_BUFFER, branchData.size() * sizeof(BranchInstanceData), branchData.data(), GL_STATIC_DRAW);
-                    glEnableVertexAttribArray(3); glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(BranchInstanceData), (void*)offsetof(BranchInstanceData, position));
-                    glEnableVertexAttribArray(4); glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(BranchInstanceData), (void*)offsetof(BranchInstanceData, rotation));
-                    glEnableVertexAttribArray(5); glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(BranchInstanceData), (void*)offsetof(BranchInstanceData, color));
-                    glVertexAttribDivisor(3, 1); glVertexAttribDivisor(4, 1); glVertexAttribDivisor(5, 1);
+                    device.bufferData(GL_ARRAY_BUFFER, branchData.size() * sizeof(BranchInstanceData), branchData.data(), GL_STATIC_DRAW);
+                    device.enableVertexAttribArray(3); device.vertexAttribPointer(3, 3, GL_FLOAT, false, sizeof(BranchInstanceData), offsetof(BranchInstanceData, position));
+                    device.enableVertexAttribArray(4); device.vertexAttribPointer(4, 1, GL_FLOAT, false, sizeof(BranchInstanceData), offsetof(BranchInstanceData, rotation));
+                    device.enableVertexAttribArray(5); device.vertexAttribPointer(5, 3, GL_FLOAT, false, sizeof(BranchInstanceData), offsetof(BranchInstanceData, color));
+                    device.vertexAttribDivisor(3, 1); device.vertexAttribDivisor(4, 1); device.vertexAttribDivisor(5, 1);
                 } else {
-                    glBufferData(GL_ARRAY_BUFFER, behaviorData[i].size() * sizeof(InstanceData), behaviorData[i].data(), GL_STATIC_DRAW);
-                    glEnableVertexAttribArray(3); glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, position));
-                    glEnableVertexAttribArray(4); glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, color));
-                    glVertexAttribDivisor(3, 1); glVertexAttribDivisor(4, 1);
+                    device.bufferData(GL_ARRAY_BUFFER, behaviorData[i].size() * sizeof(InstanceData), behaviorData[i].data(), GL_STATIC_DRAW);
+                    device.enableVertexAttribArray(3); device.vertexAttribPointer(3, 3, GL_FLOAT, false, sizeof(InstanceData), offsetof(InstanceData, position));
+                    device.enableVertexAttribArray(4); device.vertexAttribPointer(4, 3, GL_FLOAT, false, sizeof(InstanceData), offsetof(InstanceData, color));
+                    device.vertexAttribDivisor(3, 1); device.vertexAttribDivisor(4, 1);
                 }
             }
 
-            glBindVertexArray(0);
+            device.bindVertexArray(0);
             buffers.builtWithFaceCulling = faceCullingInitialized;
         }
     }
@@ -13,6 +13,8 @@
 #include <unordered_set>
 #include <vector>
 
+#include "BaseSystem/PrototypeTraits.h"
+
 namespace RenderInitSystemLogic {
     int getRegistryInt(const BaseSystem& baseSystem, const std::string& key, int fallback);
     bool getRegistryBool(const BaseSystem& baseSystem, const std::string& key, bool fallback);
@@ -145,10 +147,6 @@ namespace VoxelMeshingSystemLogic {
             return found ? key : 0;
         }
 
-        bool isLeafPrototype(const Entity& proto) {
-            return proto.name == "Leaf" || (proto.isAnimated && proto.hasWireframe && !proto.isSolid);
-        }
-
         enum class PlantType : int { None = 0, GrassTall = 1, Flower = 2, GrassShort = 3 };
 
         PlantType plantTypeForPrototype(const Entity& proto) {
@@ -158,10 +156,6 @@ namespace VoxelMeshingSystemLogic {
             return PlantType::None;
         }
 
-        bool isPlantPrototype(const Entity& proto) {
-            return plantTypeForPrototype(proto) != PlantType::None;
-        }
-
         bool startsWith(const std::string& value, const char* prefix) {
             if (!prefix) return false;
             const size_t prefixLen = std::strlen(prefix);
@@ -218,10 +212,6 @@ namespace VoxelMeshingSystemLogic {
             return NarrowLogAxis::None;
         }
 
-        bool isNarrowLogPrototype(const Entity& proto) {
-            return narrowLogAxis(proto) != NarrowLogAxis::None;
-        }
-
         NarrowShape narrowShapeForPrototype(const Entity& proto) {
             if (proto.name == "StickTexX" || proto.name == "StickTexZ") return NarrowShape::Stick;
             if (isStonePebbleXName(proto.name) || isStonePebbleZName(proto.name)
@@ -288,18 +278,6 @@ namespace VoxelMeshingSystemLogic {
 
         enum class SlopeDir : int { None = 0, PosX = 1, NegX = 2, PosZ = 3, NegZ = 4 };
 
-        SlopeDir slopeDirForPrototype(const Entity& proto) {
-            if (proto.name == "DebugSlopeTexPosX") return SlopeDir::PosX;
-            if (proto.name == "DebugSlopeTexNegX") return SlopeDir::NegX;
-            if (proto.name == "DebugSlopeTexPosZ") return SlopeDir::PosZ;
-            if (proto.name == "DebugSlopeTexNegZ") return SlopeDir::NegZ;
-            return SlopeDir::None;
-        }
-
-        bool isSlopePrototype(const Entity& proto) {
-            return slopeDirForPrototype(proto) != SlopeDir::None;
-        }
-
         constexpr float kSlopeCapAlphaA = -4.0f;
         constexpr float kSlopeCapAlphaB = -5.0f;
         constexpr float kSlopeTopAlphaPosX = -6.0f;
@@ -511,20 +489,19 @@ namespace VoxelMeshingSystemLogic {
             std::vector<CellInfo> plantCells(static_cast<size_t>(sizeX * sizeY * sizeZ));
             std::vector<CellInfo> slopeCells(static_cast<size_t>(sizeX * sizeY * sizeZ));
 
+            const PrototypeTraits::Table& traits = PrototypeTraits::For(prototypes);
             auto classifyProto = [&](uint32_t id, int& outType) {
-                if (id == 0 || id >= prototypes.size()) { outType = 0; return; }
-                const Entity& proto = prototypes[id];
-                if (!proto.isBlock) {
+                if (id == 0 || !traits.has(id, PrototypeTraits::Block)) {
                     outType = 0;
-                } else if (proto.name == "Water") {
+                } else if (traits.has(id, PrototypeTraits::Water)) {
                     outType = 2;
-                } else if (isSlopePrototype(proto)) {
+                } else if (traits.has(id, PrototypeTraits::CaveSlope)) {
                     outType = 6;
-                } else if (isLeafPrototype(proto)) {
+                } else if (traits.has(id, PrototypeTraits::MeshLeaf)) {
                     outType = 3;
-                } else if (isPlantPrototype(proto)) {
+                } else if (traits.has(id, PrototypeTraits::Plant)) {
                     outType = 5;
-                } else if (isNarrowLogPrototype(proto)) {
+                } else if (traits.has(id, PrototypeTraits::NarrowLog)) {
                     outType = 4;
                 } else {
                     outType = 1;
@@ -536,20 +513,18 @@ namespace VoxelMeshingSystemLogic {
                     for (int x = 0; x < sizeX; ++x) {
                         glm::ivec3 lodCoord = minCoord + glm::ivec3(x, y, z);
                         uint32_t id = VoxelMeshInitSystemLogic::GetVoxelIdAtLod(voxelWorld, section.lod, lodCoord);
-                        if (id == 0 || id >= prototypes.size()) continue;
-                        const Entity& proto = prototypes[id];
+                        if (id == 0 || !traits.has(id, PrototypeTraits::Block)) continue;
                         int idx = cellIndex(glm::ivec3(x, y, z));
                         uint32_t packedColor = VoxelMeshInitSystemLogic::GetVoxelColorAtLod(voxelWorld, section.lod, lodCoord);
                         glm::vec3 color = VoxelMeshInitSystemLogic::UnpackColor(packedColor);
-                        if (!proto.isBlock) continue;
-                        if (proto.name == "Water") {
+                        if (traits.has(id, PrototypeTraits::Water)) {
                             waterCells[idx] = {true, false, PlantType::None, SlopeDir::None, static_cast<int>(id), color};
-                        } else if (isSlopePrototype(proto)) {
-                            slopeCells[idx] = {true, false, PlantType::None, slopeDirForPrototype(proto), static_cast<int>(id), color};
-                        } else if (isLeafPrototype(proto)) {
+                        } else if (traits.has(id, PrototypeTraits::CaveSlope)) {
+                            slopeCells[idx] = {true, false, PlantType::None, static_cast<SlopeDir>(traits.slope(id)), static_cast<int>(id), color};
+                        } else if (traits.has(id, PrototypeTraits::MeshLeaf)) {
                             leafCells[idx] = {true, true, PlantType::None, SlopeDir::None, static_cast<int>(id), color};
-                        } else if (isPlantPrototype(proto)) {
-                            plantCells[idx] = {true, false, plantTypeForPrototype(proto), SlopeDir::None, static_cast<int>(id), color};
+                        } else if (traits.has(id, PrototypeTraits::Plant)) {
+                            plantCells[idx] = {true, false, plantTypeForPrototype(prototypes[id]), SlopeDir::None, static_cast<int>(id), color};
                         } else {
                             solidCells[idx] = {true, false, PlantType::None, SlopeDir::None, static_cast<int>(id), color};
                         }
@@ -564,8 +539,7 @@ namespace VoxelMeshingSystemLogic {
                     int idx = cellIndex(local);
                     if (solidCells[idx].filled) {
                         int sid = solidCells[idx].protoID;
-                        if (sid >= 0 && sid < static_cast<int>(prototypes.size())
-                            && isNarrowLogPrototype(prototypes[static_cast<size_t>(sid)])) {
+                        if (sid >= 0 && traits.has(static_cast<uint32_t>(sid), PrototypeTraits::NarrowLog)) {
                             return 4;
                         }
                         return 1;
@@ -1082,20 +1056,19 @@ namespace VoxelMeshingSystemLogic {
             std::vector<CellInfo> plantCells(static_cast<size_t>(sizeX * sizeY * sizeZ));
             std::vector<CellInfo> slopeCells(static_cast<size_t>(sizeX * sizeY * sizeZ));
 
+            const PrototypeTraits::Table& traits = PrototypeTraits::For(prototypes);
             auto classifyProto = [&](uint32_t id, int& outType) {
-                if (id == 0 || id >= prototypes.size()) { outType = 0; return; }
-                const Entity& proto = prototypes[id];
-                if (!proto.isBlock) {
+                if (id == 0 || !traits.has(id, PrototypeTraits::Block)) {
                     outType = 0;
-                } else if (proto.name == "Water") {
+                } else if (traits.has(id, PrototypeTraits::Water)) {
                     outType = 2;
-                } else if (isSlopePrototype(proto)) {
+                } else if (traits.has(id, PrototypeTraits::CaveSlope)) {
                     outType = 6;
-                } else if (isLeafPrototype(proto)) {
+                } else if (traits.has(id, PrototypeTraits::MeshLeaf)) {
                     outType = 3;
-                } else if (isPlantPrototype(proto)) {
+                } else if (traits.has(id, PrototypeTraits::Plant)) {
                     outType = 5;
-                } else if (isNarrowLogPrototype(proto)) {
+                } else if (traits.has(id, PrototypeTraits::NarrowLog)) {
                     outType = 4;
                 } else {
                     outType = 1;
@@ -1107,20 +1080,18 @@ namespace VoxelMeshingSystemLogic {
                     for (int x = 0; x < sizeX; ++x) {
                         int sIdx = snapIndex(x + 1, y + 1, z + 1);
                         uint32_t id = snap.ids[sIdx];
-                        if (id == 0 || id >= prototypes.size()) continue;
-                        const Entity& proto = prototypes[id];
+                        if (id == 0 || !traits.has(id, PrototypeTraits::Block)) continue;
                         int idx = cellIndex(glm::ivec3(x, y, z));
                         uint32_t packedColor = snap.colors[sIdx];
                         glm::vec3 color = VoxelMeshInitSystemLogic::UnpackColor(packedColor);
-                        if (!proto.isBlock) continue;
-                        if (proto.name == "Water") {
+                        if (traits.has(id, PrototypeTraits::Water)) {
                             waterCells[idx] = {true, false, PlantType::None, SlopeDir::None, static_cast<int>(id), color};
-                        } else if (isSlopePrototype(proto)) {
-                            slopeCells[idx] = {true, false, PlantType::None, slopeDirForPrototype(proto), static_cast<int>(id), color};
-                        } else if (isLeafPrototype(proto)) {
+                        } else if (traits.has(id, PrototypeTraits::CaveSlope)) {
+                            slopeCells[idx] = {true, false, PlantType::None, static_cast<SlopeDir>(traits.slope(id)), static_cast<int>(id), color};
+                        } else if (traits.has(id, PrototypeTraits::MeshLeaf)) {
                             leafCells[idx] = {true, true, PlantType::None, SlopeDir::None, static_cast<int>(id), color};
-                        } else if (isPlantPrototype(proto)) {
-                            plantCells[idx] = {true, false, plantTypeForPrototype(proto), SlopeDir::None, static_cast<int>(id), color};
+                        } else if (traits.has(id, PrototypeTraits::Plant)) {
+                            plantCells[idx] = {true, false, plantTypeForPrototype(prototypes[id]), SlopeDir::None, static_cast<int>(id), color};
                         } else {
                             solidCells[idx] = {true, false, PlantType::None, SlopeDir::None, static_cast<int>(id), color};
                         }
@@ -1576,6 +1547,8 @@ namespace VoxelMeshingSystemLogic {
         void ensureGreedyAsyncStarted(const std::vector<Entity>& prototypes) {
             std::lock_guard<std::mutex> lock(g_voxelGreedyAsync.mutex);
             g_voxelGreedyAsync.prototypes = &prototypes;
+            // The worker reads the trait table; make sure it is current before it starts.
+            PrototypeTraits::For(prototypes);
             if (g_voxelGreedyAsync.running) return;
             g_voxelGreedyAsync.stop = false;
             g_voxelGreedyAsync.running = true;
@@ -22,7 +22,7 @@ namespace DawTrackSystemLogic {
 }
 namespace DawClipSystemLogic {
     void TrimClipsForNewClip(DawTrack& track, const DawClip& clip);
-    void RebuildTrackCacheFromClips(DawContext& daw, DawTrack& track);
+    void RefreshTrackFromClips(DawContext& daw, DawTrack& track);
 }
 namespace MidiTrackSystemLogic { bool InsertTrackAt(BaseSystem& baseSystem, int trackIndex); }
 namespace AutomationTrackSystemLogic { bool InsertTrackAt(BaseSystem& baseSystem, int trackIndex); }
@@ -251,6 +251,7 @@ namespace Vst3BrowserSystemLogic {
                                            return idSet.count(inst.instanceID) != 0;
                                        }),
                         insts.end());
+            level.worlds[worldIndex].instanceEdits += 1;
         }
 
         EntityInstance makeTextInstance(BaseSystem& baseSystem,
@@ -429,6 +430,7 @@ namespace Vst3BrowserSystemLogic {
             ctx.componentsGhostId = ghost.instanceID;
             ctx.componentsInstanceIds.push_back(ghost.instanceID);
             level.worlds[worldIndex].instances.push_back(ghost);
+            level.worlds[worldIndex].instanceEdits += 1;
 
             ctx.componentsCacheBuilt = true;
             ctx.componentsLevel = &level;
@@ -459,6 +461,7 @@ namespace Vst3BrowserSystemLogic {
             ctx.browserGhostId = ghost.instanceID;
             ctx.browserInstanceIds.push_back(ghost.instanceID);
             level.worlds[worldIndex].instances.push_back(ghost);
+            level.worlds[worldIndex].instanceEdits += 1;
 
             ctx.browserCacheBuilt = true;
             ctx.browserLevel = &level;
@@ -492,6 +495,7 @@ namespace Vst3BrowserSystemLogic {
             ctx.samplesGhostId = ghost.instanceID;
             ctx.samplesInstanceIds.push_back(ghost.instanceID);
             level.worlds[worldIndex].instances.push_back(ghost);
+            level.worlds[worldIndex].instanceEdits += 1;
 
             ctx.samplesCacheBuilt = true;
             ctx.samplesLevel = &level;
@@ -798,7 +802,7 @@ namespace Vst3BrowserSystemLogic {
                             if (a.startSample == b.startSample) return a.sourceOffset < b.sourceOffset;
                             return a.startSample < b.startSample;
                         });
-                        DawClipSystemLogic::RebuildTrackCacheFromClips(daw, track);
+                        DawClipSystemLogic::RefreshTrackFromClips(daw, track);
                         ui.consumeClick = true;
                     }
                 }
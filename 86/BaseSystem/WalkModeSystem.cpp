@@ -83,21 +83,8 @@ namespace WalkModeSystemLogic {
         }
 
         bool triggerGameplaySfx(BaseSystem& baseSystem, const char* fileName, float cooldownSeconds = 0.0f) {
-            if (!fileName || !baseSystem.audio || !baseSystem.audio->chuck) return false;
-            const std::string scriptPath = std::string("Procedures/chuck/gameplay/") + fileName;
-            static std::unordered_map<std::string, double> s_lastTrigger;
-            const double now = glfwGetTime();
-            auto it = s_lastTrigger.find(scriptPath);
-            if (it != s_lastTrigger.end() && (now - it->second) < static_cast<double>(cooldownSeconds)) {
-                return false;
-            }
-            std::vector<t_CKUINT> ids;
-            bool ok = baseSystem.audio->chuck->compileFile(scriptPath, "", 1, FALSE, &ids);
-            if (ok && !ids.empty()) {
-                s_lastTrigger[scriptPath] = now;
-                return true;
-            }
-            return false;
+            if (!fileName) return false;
+            return ChucKSystemLogic::TriggerSfx(baseSystem, std::string("Procedures/chuck/gameplay/") + fileName, cooldownSeconds);
         }
 
         bool isWallStonePrototypeName(const std::string& name) {
@@ -130,16 +117,14 @@ namespace WalkModeSystemLogic {
             if (worldIndexHint >= 0 && worldIndexHint < static_cast<int>(level.worlds.size())) {
                 Entity& world = level.worlds[static_cast<size_t>(worldIndexHint)];
                 const glm::vec3 cellPos = glm::vec3(cell);
-                for (size_t i = 0; i < world.instances.size();) {
-                    const EntityInstance& inst = world.instances[i];
-                    if (glm::distance(inst.position, cellPos) <= 0.05f
-                        && isWallStonePrototypeID(prototypes, inst.prototypeID)) {
-                        world.instances[i] = world.instances.back();
-                        world.instances.pop_back();
-                        removed = true;
-                        continue;
-                    }
-                    ++i;
+                const EntityInstance* inst = BlockSelectionSystemLogic::FindBlockInstance(baseSystem, prototypes, worldIndexHint, cellPos);
+                if (inst && isWallStonePrototypeID(prototypes, inst->prototypeID)) {
+                    const size_t i = static_cast<size_t>(inst - world.instances.data());
+                    world.instances[i] = world.instances.back();
+                    world.instances.pop_back();
+                    world.instanceEdits += 1;
+                    BlockSelectionSystemLogic::RemoveBlockFromCache(baseSystem, prototypes, worldIndexHint, cellPos);
+                    removed = true;
                 }
             }
 
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Incremental 32-bit float WAV writer. Samples are appended in chunks and the
+// header sizes are patched on updateHeader()/close(), so the file on disk stays
+// a valid WAV after every fixup. When reserveRf64 is set a 28-byte JUNK chunk
+// is left after the RIFF header and promoted to ds64 (RF64) once the data
+// outgrows the 4 GB RIFF limit; without it the layout is the plain 44-byte
+// header the session/export code has always written.
+struct WavStreamWriter {
+    static constexpr uint32_t kDs64PayloadBytes = 28;
+    static constexpr uint64_t kRiffSizeLimit = 0xFFFFFFFFull;
+
+    std::ofstream file;
+    std::string path;
+    uint16_t channels = 1;
+    uint32_t sampleRate = 44100;
+    bool rf64Reserved = false;
+    bool rf64Active = false;
+    uint64_t dataBytes = 0;
+    std::streamoff dataSizePos = 0;
+    std::streamoff junkPos = 0;
+    std::vector<float> interleaveScratch;
+
+    WavStreamWriter() = default;
+    WavStreamWriter(const WavStreamWriter&) = delete;
+    WavStreamWriter& operator=(const WavStreamWriter&) = delete;
+    ~WavStreamWriter() { close(); }
+
+    bool isOpen() const { return file.is_open(); }
+    uint64_t framesWritten() const {
+        const uint64_t frameBytes = static_cast<uint64_t>(channels) * sizeof(float);
+        return frameBytes > 0 ? dataBytes / frameBytes : 0;
+    }
+
+    bool open(const std::string& outPath, uint16_t numChannels, uint32_t rate, bool reserveRf64) {
+        close();
+        if (numChannels == 0) return false;
+        file.open(outPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        path = outPath;
+        channels = numChannels;
+        sampleRate = rate;
+        rf64Reserved = reserveRf64;
+        rf64Active = false;
+        dataBytes = 0;
+
+        const uint16_t audioFormat = 3;
+        const uint16_t bitsPerSample = 32;
+        const uint32_t byteRate = sampleRate * channels * (bitsPerSample / 8);
+        const uint16_t blockAlign = channels * (bitsPerSample / 8);
+        const uint32_t riffSize = 0;
+        const uint32_t fmtSize = 16;
+        const uint32_t dataSize = 0;
+
+        file.write("RIFF", 4);
+        writeU32(riffSize);
+        file.write("WAVE", 4);
+        if (rf64Reserved) {
+            junkPos = static_cast<std::streamoff>(file.tellp());
+            file.write("JUNK", 4);
+            writeU32(kDs64PayloadBytes);
+            const std::array<char, kDs64PayloadBytes> zeros{};
+            file.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+        }
+        file.write("fmt ", 4);
+        writeU32(fmtSize);
+        file.write(reinterpret_cast<const char*>(&audioFormat), sizeof(audioFormat));
+        file.write(reinterpret_cast<const char*>(&channels), sizeof(channels));
+        writeU32(sampleRate);
+        writeU32(byteRate);
+        file.write(reinterpret_cast<const char*>(&blockAlign), sizeof(blockAlign));
+        file.write(reinterpret_cast<const char*>(&bitsPerSample), sizeof(bitsPerSample));
+        file.write("data", 4);
+        dataSizePos = static_cast<std::streamoff>(file.tellp());
+        writeU32(dataSize);
+        if (!file) {
+            file.close();
+            return false;
+        }
+        return updateHeader();
+    }
+
+    // Appends interleaved frames (channels samples per frame).
+    bool writeInterleaved(const float* samples, size_t frames) {
+        if (!file.is_open()) return false;
+        if (frames == 0) return true;
+        const uint64_t bytes = static_cast<uint64_t>(frames) * channels * sizeof(float);
+        if (!rf64Reserved && headerBytes() - 8 + dataBytes + bytes > kRiffSizeLimit) return false;
+        file.write(reinterpret_cast<const char*>(samples), static_cast<std::streamsize>(bytes));
+        if (!file) return false;
+        dataBytes += bytes;
+        return true;
+    }
+
+    // Appends planar frames; right is ignored for mono files and may be null
+    // for stereo files, in which case left is duplicated.
+    bool writePlanar(const float* left, const float* right, size_t frames) {
+        if (channels == 1) return writeInterleaved(left, frames);
+        if (interleaveScratch.size() < frames * channels) {
+            interleaveScratch.resize(frames * channels);
+        }
+        const float* srcR = right ? right : left;
+        for (size_t i = 0; i < frames; ++i) {
+            interleaveScratch[i * channels] = left[i];
+            interleaveScratch[i * channels + 1] = srcR[i];
+            for (uint16_t c = 2; c < channels; ++c) {
+                interleaveScratch[i * channels + c] = 0.0f;
+            }
+        }
+        return writeInterleaved(interleaveScratch.data(), frames);
+    }
+
+    // Rewrites the size fields for the data written so far and returns the
+    // write position to the end of the file.
+    bool updateHeader() {
+        if (!file.is_open()) return false;
+        const std::streamoff endPos = static_cast<std::streamoff>(file.tellp());
+        const uint64_t riffSize64 = headerBytes() - 8 + dataBytes;
+        if (riffSize64 > kRiffSizeLimit && rf64Reserved) {
+            rf64Active = true;
+        }
+        file.seekp(0, std::ios::beg);
+        if (rf64Active) {
+            file.write("RF64", 4);
+            writeU32(0xFFFFFFFFu);
+            file.seekp(junkPos, std::ios::beg);
+            file.write("ds64", 4);
+            writeU32(kDs64PayloadBytes);
+            writeU64(riffSize64);
+            writeU64(dataBytes);
+            writeU64(framesWritten());
+            writeU32(0);
+            file.seekp(dataSizePos, std::ios::beg);
+            writeU32(0xFFFFFFFFu);
+        } else {
+            file.write("RIFF", 4);
+            writeU32(static_cast<uint32_t>(std::min<uint64_t>(riffSize64, kRiffSizeLimit)));
+            file.seekp(dataSizePos, std::ios::beg);
+            writeU32(static_cast<uint32_t>(std::min<uint64_t>(dataBytes, kRiffSizeLimit)));
+        }
+        file.seekp(endPos, std::ios::beg);
+        file.flush();
+        return static_cast<bool>(file);
+    }
+
+    bool close() {
+        if (!file.is_open()) return true;
+        bool ok = updateHeader();
+        file.close();
+        return ok && !file.fail();
+    }
+
+private:
+    uint64_t headerBytes() const {
+        return 44u + (rf64Reserved ? 8u + kDs64PayloadBytes : 0u);
+    }
+    void writeU32(uint32_t value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    void writeU64(uint64_t value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+};
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <vector>
 
+#include "BaseSystem/RenderDevice.h"
+
 namespace RenderInitSystemLogic {
     RenderBehavior BehaviorForPrototype(const Entity& proto);
     int getRegistryInt(const BaseSystem& baseSystem, const std::string& key, int fallback);
@@ -53,8 +55,9 @@ namespace WorldRenderSystemLogic {
     }
 
     void RenderWorld(BaseSystem& baseSystem, std::vector<Entity>& prototypes, float dt, GLFWwindow* win) {
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        RenderDevice::Device& device = RenderDevice::current();
+        device.clearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        device.clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         if (!baseSystem.renderer || !baseSystem.world || !baseSystem.player || !baseSystem.level) return;
         PlayerContext& player = *baseSystem.player;
@@ -213,15 +216,15 @@ namespace WorldRenderSystemLogic {
         renderer.blockShader->setVec3("ambientLight",glm::vec3(0.4f));
         renderer.blockShader->setVec3("diffuseLight",glm::vec3(0.6f));
         renderer.blockShader->setMat4("model", glm::mat4(1.0f));
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        device.enable(GL_BLEND);
+        device.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         for (int i = 0; i < static_cast<int>(RenderBehavior::COUNT); ++i) {
             RenderBehavior currentBehavior = static_cast<RenderBehavior>(i);
             bool translucent = (currentBehavior == RenderBehavior::ANIMATED_WATER || currentBehavior == RenderBehavior::ANIMATED_TRANSPARENT_WAVE);
             if (translucent) {
                 // Let translucent passes read depth but avoid writing it so surfaces beneath stay visible.
-                glDepthMask(GL_FALSE);
+                device.depthMask(false);
             }
             if (useVoxelRendering) {
                 VoxelWorldContext& voxelWorld = *baseSystem.voxelWorld;
@@ -236,30 +239,30 @@ namespace WorldRenderSystemLogic {
                     renderer.blockShader->setFloat("instanceScale", static_cast<float>(1 << section.lod));
                     renderer.blockShader->setInt("behaviorType", i);
                     if (buffers.vaos[i] == 0) continue;
-                    glBindVertexArray(buffers.vaos[i]);
-                    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, count);
+                    device.bindVertexArray(buffers.vaos[i]);
+                    device.drawArraysInstanced(GL_TRIANGLES, 0, 36, count);
                 }
                 renderer.blockShader->setFloat("instanceScale", 1.0f);
             }
             if (currentBehavior == RenderBehavior::STATIC_BRANCH) {
                 if (!branchInstances.empty()) {
                     renderer.blockShader->setInt("behaviorType", i);
-                    glBindVertexArray(renderer.behaviorVAOs[i]);
-                    glBindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[i]);
-                    glBufferData(GL_ARRAY_BUFFER, branchInstances.size() * sizeof(BranchInstanceData), branchInstances.data(), GL_DYNAMIC_DRAW);
-                    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, branchInstances.size());
+                    device.bindVertexArray(renderer.behaviorVAOs[i]);
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[i]);
+                    device.bufferData(GL_ARRAY_BUFFER, branchInstances.size() * sizeof(BranchInstanceData), branchInstances.data(), GL_DYNAMIC_DRAW);
+                    device.drawArraysInstanced(GL_TRIANGLES, 0, 36, branchInstances.size());
                 }
             } else {
                 if (!behaviorInstances[i].empty()) {
                     renderer.blockShader->setInt("behaviorType", i);
-                    glBindVertexArray(renderer.behaviorVAOs[i]);
-                    glBindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[i]);
-                    glBufferData(GL_ARRAY_BUFFER, behaviorInstances[i].size() * sizeof(InstanceData), behaviorInstances[i].data(), GL_DYNAMIC_DRAW);
-                    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, behaviorInstances[i].size());
+                    device.bindVertexArray(renderer.behaviorVAOs[i]);
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[i]);
+                    device.bufferData(GL_ARRAY_BUFFER, behaviorInstances[i].size() * sizeof(InstanceData), behaviorInstances[i].data(), GL_DYNAMIC_DRAW);
+                    device.drawArraysInstanced(GL_TRIANGLES, 0, 36, behaviorInstances[i].size());
                 }
             }
             if (translucent) {
-                glDepthMask(GL_TRUE);
+                device.depthMask(true);
             }
         }
 
@@ -291,8 +294,8 @@ namespace WorldRenderSystemLogic {
             shader.setFloat("wallStoneUvJitterMaxPixels", wallStoneUvJitterMaxPixels);
             shader.setInt("atlasTexture", 0);
             if (renderer.atlasTexture != 0) {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, renderer.atlasTexture);
+                device.activeTexture(GL_TEXTURE0);
+                device.bindTexture(GL_TEXTURE_2D, renderer.atlasTexture);
             }
             const bool hasAllGrassTextures =
                 renderer.grassTextureCount >= 3
@@ -317,7 +320,7 @@ namespace WorldRenderSystemLogic {
             const bool hasWaterOverlayTexture = false;
             static int sMaxTextureUnits = -1;
             if (sMaxTextureUnits < 0) {
-                glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &sMaxTextureUnits);
+                sMaxTextureUnits = device.getInteger(GL_MAX_TEXTURE_IMAGE_UNITS);
             }
             const bool enoughUnitsForDualGrassSets = (sMaxTextureUnits >= 7);
             const bool enoughUnitsForOreSet = (sMaxTextureUnits >= 11);
@@ -342,54 +345,54 @@ namespace WorldRenderSystemLogic {
             shader.setInt("waterOverlayTextureEnabled", 0);
             shader.setInt("waterOverlayTexture", 13);
             if (hasAllGrassTextures) {
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, renderer.grassTextures[0]);
-                glActiveTexture(GL_TEXTURE2);
-                glBindTexture(GL_TEXTURE_2D, renderer.grassTextures[1]);
-                glActiveTexture(GL_TEXTURE3);
-                glBindTexture(GL_TEXTURE_2D, renderer.grassTextures[2]);
+                device.activeTexture(GL_TEXTURE1);
+                device.bindTexture(GL_TEXTURE_2D, renderer.grassTextures[0]);
+                device.activeTexture(GL_TEXTURE2);
+                device.bindTexture(GL_TEXTURE_2D, renderer.grassTextures[1]);
+                device.activeTexture(GL_TEXTURE3);
+                device.bindTexture(GL_TEXTURE_2D, renderer.grassTextures[2]);
             }
             if (hasAllShortGrassTextures && enoughUnitsForDualGrassSets) {
-                glActiveTexture(GL_TEXTURE4);
-                glBindTexture(GL_TEXTURE_2D, renderer.shortGrassTextures[0]);
-                glActiveTexture(GL_TEXTURE5);
-                glBindTexture(GL_TEXTURE_2D, renderer.shortGrassTextures[1]);
-                glActiveTexture(GL_TEXTURE6);
-                glBindTexture(GL_TEXTURE_2D, renderer.shortGrassTextures[2]);
+                device.activeTexture(GL_TEXTURE4);
+                device.bindTexture(GL_TEXTURE_2D, renderer.shortGrassTextures[0]);
+                device.activeTexture(GL_TEXTURE5);
+                device.bindTexture(GL_TEXTURE_2D, renderer.shortGrassTextures[1]);
+                device.activeTexture(GL_TEXTURE6);
+                device.bindTexture(GL_TEXTURE_2D, renderer.shortGrassTextures[2]);
             }
             if (hasAllOreTextures && enoughUnitsForOreSet) {
-                glActiveTexture(GL_TEXTURE7);
-                glBindTexture(GL_TEXTURE_2D, renderer.oreTextures[0]);
-                glActiveTexture(GL_TEXTURE8);
-                glBindTexture(GL_TEXTURE_2D, renderer.oreTextures[1]);
-                glActiveTexture(GL_TEXTURE9);
-                glBindTexture(GL_TEXTURE_2D, renderer.oreTextures[2]);
-                glActiveTexture(GL_TEXTURE10);
-                glBindTexture(GL_TEXTURE_2D, renderer.oreTextures[3]);
+                device.activeTexture(GL_TEXTURE7);
+                device.bindTexture(GL_TEXTURE_2D, renderer.oreTextures[0]);
+                device.activeTexture(GL_TEXTURE8);
+                device.bindTexture(GL_TEXTURE_2D, renderer.oreTextures[1]);
+                device.activeTexture(GL_TEXTURE9);
+                device.bindTexture(GL_TEXTURE_2D, renderer.oreTextures[2]);
+                device.activeTexture(GL_TEXTURE10);
+                device.bindTexture(GL_TEXTURE_2D, renderer.oreTextures[3]);
             }
             if (hasAllTerrainTextures && enoughUnitsForTerrainSet) {
-                glActiveTexture(GL_TEXTURE11);
-                glBindTexture(GL_TEXTURE_2D, renderer.terrainTextures[0]);
-                glActiveTexture(GL_TEXTURE12);
-                glBindTexture(GL_TEXTURE_2D, renderer.terrainTextures[1]);
+                device.activeTexture(GL_TEXTURE11);
+                device.bindTexture(GL_TEXTURE_2D, renderer.terrainTextures[0]);
+                device.activeTexture(GL_TEXTURE12);
+                device.bindTexture(GL_TEXTURE_2D, renderer.terrainTextures[1]);
             }
             if (hasWaterOverlayTexture && enoughUnitsForWaterOverlay) {
-                glActiveTexture(GL_TEXTURE13);
-                glBindTexture(GL_TEXTURE_2D, renderer.waterOverlayTexture);
+                device.activeTexture(GL_TEXTURE13);
+                device.bindTexture(GL_TEXTURE_2D, renderer.waterOverlayTexture);
             }
-            glActiveTexture(GL_TEXTURE0);
+            device.activeTexture(GL_TEXTURE0);
         };
 
         auto drawFaceBatches = [&](const std::array<std::vector<FaceInstanceRenderData>, 6>& batches, bool depthWrite){
             if (!renderer.faceShader || !renderer.faceVAO) return;
-            if (!depthWrite) glDepthMask(GL_FALSE);
+            if (!depthWrite) device.depthMask(false);
             bool enableCull = depthWrite || !twoSidedAlphaFaces;
             if (enableCull) {
-                glEnable(GL_CULL_FACE);
-                glFrontFace(GL_CCW);
-                glCullFace(GL_BACK);
+                device.enable(GL_CULL_FACE);
+                device.frontFace(GL_CCW);
+                device.cullFace(GL_BACK);
             } else {
-                glDisable(GL_CULL_FACE);
+                device.disable(GL_CULL_FACE);
             }
 
             renderer.faceShader->use();
@@ -409,18 +412,18 @@ namespace WorldRenderSystemLogic {
             renderer.faceShader->setFloat("waterCascadeBrightnessSpeed", waterCascadeBrightnessSpeed);
             renderer.faceShader->setFloat("waterCascadeBrightnessScale", waterCascadeBrightnessScale);
             bindFaceTextureUniforms(*renderer.faceShader);
-            glBindVertexArray(renderer.faceVAO);
+            device.bindVertexArray(renderer.faceVAO);
             for (int faceType = 0; faceType < 6; ++faceType) {
                 const auto& instances = batches[faceType];
                 if (instances.empty()) continue;
                 renderer.faceShader->setInt("faceType", faceType);
-                glBindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
-                glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(FaceInstanceRenderData), instances.data(), GL_DYNAMIC_DRAW);
-                glDrawArraysInstanced(GL_TRIANGLES, 0, 6, instances.size());
+                device.bindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
+                device.bufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(FaceInstanceRenderData), instances.data(), GL_DYNAMIC_DRAW);
+                device.drawArraysInstanced(GL_TRIANGLES, 0, 6, instances.size());
             }
 
-            glDisable(GL_CULL_FACE);
-            if (!depthWrite) glDepthMask(GL_TRUE);
+            device.disable(GL_CULL_FACE);
+            if (!depthWrite) device.depthMask(true);
         };
 
         if (renderer.faceShader && renderer.faceVAO) {
@@ -462,9 +465,9 @@ namespace WorldRenderSystemLogic {
             renderer.faceShader->setFloat("waterCascadeBrightnessScale", waterCascadeBrightnessScale);
             bindFaceTextureUniforms(*renderer.faceShader);
 
-            glEnable(GL_CULL_FACE);
-            glFrontFace(GL_CCW);
-            glCullFace(GL_BACK);
+            device.enable(GL_CULL_FACE);
+            device.frontFace(GL_CCW);
+            device.cullFace(GL_BACK);
 
             for (const auto& [sectionKey, buffers] : voxelGreedy.renderBuffers) {
                 auto secIt = voxelWorld.sections.find(sectionKey);
@@ -486,15 +489,15 @@ namespace WorldRenderSystemLogic {
                     int count = buffers.opaqueCounts[faceType];
                     if (count > 0 && buffers.opaqueVaos[faceType] != 0) {
                         renderer.faceShader->setInt("faceType", faceType);
-                        glBindVertexArray(buffers.opaqueVaos[faceType]);
-                        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+                        device.bindVertexArray(buffers.opaqueVaos[faceType]);
+                        device.drawArraysInstanced(GL_TRIANGLES, 0, 6, count);
                     }
                 }
             }
 
-            glDepthMask(GL_FALSE);
+            device.depthMask(false);
             if (twoSidedAlphaFaces) {
-                glDisable(GL_CULL_FACE);
+                device.disable(GL_CULL_FACE);
             }
             for (const auto& [sectionKey, buffers] : voxelGreedy.renderBuffers) {
                 auto secIt = voxelWorld.sections.find(sectionKey);
@@ -516,13 +519,13 @@ namespace WorldRenderSystemLogic {
                     int count = buffers.alphaCounts[faceType];
                     if (count > 0 && buffers.alphaVaos[faceType] != 0) {
                         renderer.faceShader->setInt("faceType", faceType);
-                        glBindVertexArray(buffers.alphaVaos[faceType]);
-                        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+                        device.bindVertexArray(buffers.alphaVaos[faceType]);
+                        device.drawArraysInstanced(GL_TRIANGLES, 0, 6, count);
                     }
                 }
             }
-            glDepthMask(GL_TRUE);
-            glDisable(GL_CULL_FACE);
+            device.depthMask(true);
+            device.disable(GL_CULL_FACE);
         }
 
         if (!debugSlopeInstances.empty() && renderer.faceShader && renderer.faceVAO) {
@@ -545,11 +548,11 @@ namespace WorldRenderSystemLogic {
             renderer.faceShader->setInt("wireframeDebug", 0);
             bindFaceTextureUniforms(*renderer.faceShader);
 
-            glEnable(GL_CULL_FACE);
-            glFrontFace(GL_CCW);
-            glCullFace(GL_BACK);
-            glBindVertexArray(renderer.faceVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
+            device.enable(GL_CULL_FACE);
+            device.frontFace(GL_CCW);
+            device.cullFace(GL_BACK);
+            device.bindVertexArray(renderer.faceVAO);
+            device.bindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
 
             auto drawSlopeFace = [&](const Entity& proto,
                                      int faceType,
@@ -570,8 +573,8 @@ namespace WorldRenderSystemLogic {
                 face.uvScale = faceUvScale;
                 renderer.faceShader->setMat4("model", modelMat);
                 renderer.faceShader->setInt("faceType", faceType);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &face, GL_DYNAMIC_DRAW);
-                glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
+                device.bufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &face, GL_DYNAMIC_DRAW);
+                device.drawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
             };
 
             for (const auto& slopeInst : debugSlopeInstances) {
@@ -643,7 +646,7 @@ namespace WorldRenderSystemLogic {
                 drawSlopeFace(slopeProto, 2, baseModel, faceCenterOffset(2), glm::vec2(1.0f), glm::vec2(1.0f), topAlpha, slopeInst.color);
             }
 
-            glDisable(GL_CULL_FACE);
+            device.disable(GL_CULL_FACE);
             renderer.faceShader->setMat4("model", glm::mat4(1.0f));
         }
 
@@ -694,11 +697,11 @@ namespace WorldRenderSystemLogic {
                     renderer.faceShader->setFloat("waterCascadeBrightnessScale", waterCascadeBrightnessScale);
                     renderer.faceShader->setInt("wireframeDebug", 0);
                     bindFaceTextureUniforms(*renderer.faceShader);
-                    glEnable(GL_CULL_FACE);
-                    glFrontFace(GL_CCW);
-                    glCullFace(GL_BACK);
-                    glBindVertexArray(renderer.faceVAO);
-                    glBindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
+                    device.enable(GL_CULL_FACE);
+                    device.frontFace(GL_CCW);
+                    device.cullFace(GL_BACK);
+                    device.bindVertexArray(renderer.faceVAO);
+                    device.bindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
 
                     // Cross-plane plants (grass/flower) use the same face path as voxel foliage:
                     // only side faces, centered axis offset, negative alpha mode for shader branch.
@@ -719,10 +722,10 @@ namespace WorldRenderSystemLogic {
                             heldFace.scale = plantScale;
                             heldFace.uvScale = glm::vec2(1.0f);
                             renderer.faceShader->setInt("faceType", faceType);
-                            glBufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &heldFace, GL_DYNAMIC_DRAW);
-                            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
+                            device.bufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &heldFace, GL_DYNAMIC_DRAW);
+                            device.drawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
                         }
-                        glDisable(GL_CULL_FACE);
+                        device.disable(GL_CULL_FACE);
                         drewTextured = true;
                     } else {
                         const bool narrowAlongX = (heldProto.name == "StickTexX"
@@ -793,10 +796,10 @@ namespace WorldRenderSystemLogic {
                             heldFace.scale = faceScale;
                             heldFace.uvScale = faceUvScale;
                             renderer.faceShader->setInt("faceType", faceType);
-                            glBufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &heldFace, GL_DYNAMIC_DRAW);
-                            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
+                            device.bufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &heldFace, GL_DYNAMIC_DRAW);
+                            device.drawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
                         }
-                        glDisable(GL_CULL_FACE);
+                        device.disable(GL_CULL_FACE);
                         drewTextured = true;
                     }
                 }
@@ -817,10 +820,10 @@ namespace WorldRenderSystemLogic {
                 renderer.blockShader->setVec3("diffuseLight", glm::vec3(0.6f));
                 renderer.blockShader->setMat4("model", glm::mat4(1.0f));
                 renderer.blockShader->setInt("behaviorType", behaviorIndex);
-                glBindVertexArray(renderer.behaviorVAOs[behaviorIndex]);
-                glBindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[behaviorIndex]);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData), &heldInstance, GL_DYNAMIC_DRAW);
-                glDrawArraysInstanced(GL_TRIANGLES, 0, 36, 1);
+                device.bindVertexArray(renderer.behaviorVAOs[behaviorIndex]);
+                device.bindBuffer(GL_ARRAY_BUFFER, renderer.behaviorInstanceVBOs[behaviorIndex]);
+                device.bufferData(GL_ARRAY_BUFFER, sizeof(InstanceData), &heldInstance, GL_DYNAMIC_DRAW);
+                device.drawArraysInstanced(GL_TRIANGLES, 0, 36, 1);
             }
         }
 
@@ -914,11 +917,11 @@ namespace WorldRenderSystemLogic {
             renderer.faceShader->setInt("wireframeDebug", 0);
             bindFaceTextureUniforms(*renderer.faceShader);
 
-            glEnable(GL_CULL_FACE);
-            glFrontFace(GL_CCW);
-            glCullFace(GL_BACK);
-            glBindVertexArray(renderer.faceVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
+            device.enable(GL_CULL_FACE);
+            device.frontFace(GL_CCW);
+            device.cullFace(GL_BACK);
+            device.bindVertexArray(renderer.faceVAO);
+            device.bindBuffer(GL_ARRAY_BUFFER, renderer.faceInstanceVBO);
 
             auto drawCuboid = [&](const glm::mat4& model,
                                   const Entity* textureProto,
@@ -957,8 +960,8 @@ namespace WorldRenderSystemLogic {
                     face.scale = faceScale;
                     face.uvScale = faceScale;
                     renderer.faceShader->setInt("faceType", faceType);
-                    glBufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &face, GL_DYNAMIC_DRAW);
-                    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
+                    device.bufferData(GL_ARRAY_BUFFER, sizeof(FaceInstanceRenderData), &face, GL_DYNAMIC_DRAW);
+                    device.drawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
                 }
             };
 
@@ -992,7 +995,7 @@ namespace WorldRenderSystemLogic {
                 glm::mat4 model = buildOrientedModel(player.hatchetPlacedPosition, handleDir, surfaceNormal);
                 glm::vec3 headTint(1.0f);
                 const Entity* headProto = resolveHatchetHeadProtoAndTint(player.hatchetPlacedMaterial, headTint);
-                glEnable(GL_DEPTH_TEST);
+                device.enable(GL_DEPTH_TEST);
                 drawCuboid(model, hatchetStickProto, 12, glm::vec3(0.0f), kHandleHalf);
                 drawCuboid(model, headProto, 6, kHeadCenter, kHeadHalf, headTint);
             }
@@ -1027,13 +1030,13 @@ namespace WorldRenderSystemLogic {
                 const glm::vec3 heldHeadCenter(-kHeadCenter.x, kHeadCenter.y, kHeadCenter.z);
                 glm::vec3 headTint(1.0f);
                 const Entity* headProto = resolveHatchetHeadProtoAndTint(player.hatchetSelectedMaterial, headTint);
-                glDisable(GL_DEPTH_TEST);
+                device.disable(GL_DEPTH_TEST);
                 drawCuboid(model, hatchetStickProto, 12, glm::vec3(0.0f), kHandleHalf);
                 drawCuboid(model, headProto, 6, heldHeadCenter, kHeadHalf, headTint);
-                glEnable(GL_DEPTH_TEST);
+                device.enable(GL_DEPTH_TEST);
             }
 
-            glDisable(GL_CULL_FACE);
+            device.disable(GL_CULL_FACE);
             renderer.faceShader->setMat4("model", glm::mat4(1.0f));
         }
 
@@ -1057,19 +1060,19 @@ namespace WorldRenderSystemLogic {
             renderer.selectionShader->setMat4("projection", projection);
             renderer.selectionShader->setVec3("cameraPos", playerPos);
             renderer.selectionShader->setFloat("time", time);
-            glBindVertexArray(renderer.selectionVAO);
-            glDrawArrays(GL_LINES, 0, renderer.selectionVertexCount);
+            device.bindVertexArray(renderer.selectionVAO);
+            device.drawArrays(GL_LINES, 0, renderer.selectionVertexCount);
         }
 
         if (renderer.audioRayShader && renderer.audioRayVAO && renderer.audioRayVertexCount > 0) {
-            glEnable(GL_BLEND);
+            device.enable(GL_BLEND);
             renderer.audioRayShader->use();
             renderer.audioRayShader->setMat4("view", view);
             renderer.audioRayShader->setMat4("projection", projection);
-            glBindVertexArray(renderer.audioRayVAO);
-            glLineWidth(1.6f);
-            glDrawArrays(GL_LINES, 0, renderer.audioRayVertexCount);
-            glLineWidth(1.0f);
+            device.bindVertexArray(renderer.audioRayVAO);
+            device.lineWidth(1.6f);
+            device.drawArrays(GL_LINES, 0, renderer.audioRayVertexCount);
+            device.lineWidth(1.0f);
         }
 
         bool crosshairEnabled = true;
@@ -1080,13 +1083,13 @@ namespace WorldRenderSystemLogic {
             }
         }
         if (crosshairEnabled && renderer.crosshairShader && renderer.crosshairVAO && renderer.crosshairVertexCount > 0) {
-            glDisable(GL_DEPTH_TEST);
+            device.disable(GL_DEPTH_TEST);
             renderer.crosshairShader->use();
-            glBindVertexArray(renderer.crosshairVAO);
-            glLineWidth(1.0f);
-            glDrawArrays(GL_LINES, 0, renderer.crosshairVertexCount);
-            glLineWidth(1.0f);
-            glEnable(GL_DEPTH_TEST);
+            device.bindVertexArray(renderer.crosshairVAO);
+            device.lineWidth(1.0f);
+            device.drawArrays(GL_LINES, 0, renderer.crosshairVertexCount);
+            device.lineWidth(1.0f);
+            device.enable(GL_DEPTH_TEST);
         }
 
         bool legacyMeterEnabled = false;
@@ -1099,7 +1102,7 @@ namespace WorldRenderSystemLogic {
         if (legacyMeterEnabled && baseSystem.hud && renderer.hudShader && renderer.hudVAO) {
             HUDContext& hud = *baseSystem.hud;
             if (hud.showCharge) {
-                glDisable(GL_DEPTH_TEST);
+                device.disable(GL_DEPTH_TEST);
                 renderer.hudShader->use();
                 renderer.hudShader->setFloat("fillAmount", glm::clamp(hud.chargeValue, 0.0f, 1.0f));
                 renderer.hudShader->setInt("ready", hud.chargeReady ? 1 : 0);
@@ -1108,9 +1111,9 @@ namespace WorldRenderSystemLogic {
                 renderer.hudShader->setInt("channelIndex", hud.buildChannel);
                 renderer.hudShader->setInt("previewTileIndex", hud.buildPreviewTileIndex);
                 bindFaceTextureUniforms(*renderer.hudShader);
-                glBindVertexArray(renderer.hudVAO);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-                glEnable(GL_DEPTH_TEST);
+                device.bindVertexArray(renderer.hudVAO);
+                device.drawArrays(GL_TRIANGLES, 0, 6);
+                device.enable(GL_DEPTH_TEST);
             }
         }
     }
@@ -33,7 +33,7 @@
 #include "chuck.h"
 
 // --- Forward Declarations ---
-struct Entity; struct EntityInstance; struct DawContext; struct Vst3Context;
+struct Entity; struct EntityInstance; struct DawContext; struct Vst3Context; struct DawSampleCache; struct DawDiskRecorder; struct DampingBrickmap; struct RayTraceWorkerPool;
 using json = nlohmann::json; using vec4 = glm::vec4;
 
 enum class RenderBehavior { STATIC_DEFAULT, ANIMATED_WATER, ANIMATED_WIREFRAME, STATIC_BRANCH, ANIMATED_TRANSPARENT_WAVE, COUNT };
@@ -41,7 +41,7 @@ enum class BuildModeType : int { Pickup = 0, Color = 1, Texture = 2, Destroy = 3
 enum class BlockChargeAction : int { None = 0, Pickup = 1, Destroy = 2, Fishing = 3, BoulderPrimary = 4, BoulderSecondary = 5 };
 struct InstanceData { glm::vec3 position; glm::vec3 color; };
 struct BranchInstanceData { glm::vec3 position; float rotation; glm::vec3 color; };
-class Shader { public: unsigned int ID; Shader(const char* v, const char* f); void use(); void setMat4(const std::string&n,const glm::mat4&m)const; void setVec3(const std::string&n,const glm::vec3&v)const; void setVec2(const std::string&n,const glm::vec2&v)const; void setFloat(const std::string&n,float v)const; void setInt(const std::string&n,int v)const; private: void check(unsigned int s,std::string t); };
+class Shader { public: unsigned int ID; Shader(const char* v, const char* f); void use(); void setMat4(const std::string&n,const glm::mat4&m)const; void setVec3(const std::string&n,const glm::vec3&v)const; void setVec2(const std::string&n,const glm::vec2&v)const; void setFloat(const std::string&n,float v)const; void setInt(const std::string&n,int v)const; };
 struct SkyColorKey { float time; glm::vec3 top; glm::vec3 bottom; };
 struct FaceTextureSet { int all = -1; int top = -1; int bottom = -1; int side = -1; };
 struct FaceInstanceRenderData { glm::vec3 position; glm::vec3 color; int tileIndex = -1; float alpha = 1.0f; glm::vec4 ao = glm::vec4(1.0f); glm::vec2 scale = glm::vec2(1.0f); glm::vec2 uvScale = glm::vec2(1.0f); };
@@ -272,7 +272,6 @@ struct InstanceContext { int nextInstanceID = 0; };
 struct RendererContext {
     std::unique_ptr<Shader> blockShader, skyboxShader, sunMoonShader, starShader, selectionShader, hudShader, crosshairShader, colorEmotionShader;
     std::unique_ptr<Shader> faceShader;
-    std::unique_ptr<Shader> fontShader;
     GLuint cubeVBO;
     std::vector<GLuint> behaviorVAOs;
     std::vector<GLuint> behaviorInstanceVBOs;
@@ -290,28 +289,14 @@ struct RendererContext {
     GLuint crosshairVAO = 0;
     GLuint crosshairVBO = 0;
     int crosshairVertexCount = 0;
-    std::unique_ptr<Shader> uiShader;
-    std::unique_ptr<Shader> uiColorShader;
     std::unique_ptr<Shader> glyphShader;
-    GLuint uiVAO = 0;
-    GLuint uiVBO = 0;
-    GLuint uiButtonVAO = 0;
-    GLuint uiButtonVBO = 0;
-    GLuint uiPanelVAO = 0;
-    GLuint uiPanelVBO = 0;
-    GLuint uiMeterVAO = 0;
-    GLuint uiMeterVBO = 0;
-    GLuint uiFaderVAO = 0;
-    GLuint uiFaderVBO = 0;
-    GLuint uiLaneVAO = 0;
-    GLuint uiLaneVBO = 0;
-    GLuint uiMidiLaneVAO = 0;
-    GLuint uiMidiLaneVBO = 0;
-    GLuint uiPianoRollVAO = 0;
-    GLuint uiPianoRollVBO = 0;
     GLuint glyphVAO = 0;
-    GLuint fontVAO = 0;
-    GLuint fontVBO = 0;
+    // Shared 2D UI batch (UIBatchSystem): one VAO over the vertex ring.
+    std::unique_ptr<Shader> uiBatchColorShader;
+    std::unique_ptr<Shader> uiBatchTextShader;
+    std::unique_ptr<Shader> uiLaneShader;
+    GLuint uiBatchVAO = 0;
+    GLuint uiBatchVBO = 0;
     // Audio ray visualization
     std::unique_ptr<Shader> audioRayShader;
     GLuint audioRayVAO = 0;
@@ -388,8 +373,55 @@ struct GameplaySfxVoice {
     float gain = 1.0f;
     bool active = false;
 };
+struct ChuckSfxTrigger {
+    uint16_t soundIndex = 0;
+};
+// One gameplay ChucK script, compiled once into a host shred that keeps a
+// bounded pool of play() voices (ChucKSystem). triggersSent is the running
+// total published to the host's triggerCount global; audio thread only.
+struct ChuckSfxSound {
+    std::string scriptPath;
+    std::string triggerEvent;
+    std::string triggerCount;
+    t_CKINT triggersSent = 0;
+    t_CKUINT hostShredId = 0;
+    std::time_t scriptMTime = 0;
+    bool ready = false;
+    double lastTriggerTime = -1.0e9;
+};
+struct OfflineAudioDriver;
+struct SoundtrackLoader;
+// Decoded soundtrack audio. `right` stays empty for mono sources and for
+// requests that asked for a mono downmix.
+struct SoundtrackAudio {
+    std::vector<float> left;
+    std::vector<float> right;
+    uint32_t sampleRate = 0;
+};
+// Hands whole decoded tracks to the audio callback without a lock. The main
+// thread publishes through `pending`; the callback adopts it at the top of a
+// block and passes back the track it replaces through `retired` for the main
+// thread to free. Neither thread frees or resizes audio the other may read.
+struct SoundtrackSlot {
+    struct Track {
+        SoundtrackAudio audio;
+        bool start = false;  // playback begins once adopted, with gain and loop
+        float gain = 1.0f;
+        bool loop = false;
+    };
+    std::atomic<Track*> pending{nullptr};
+    std::atomic<Track*> retired{nullptr};
+    Track* playing = nullptr;  // audio thread only
+    ~SoundtrackSlot() {
+        delete pending.load();
+        delete retired.load();
+        delete playing;
+    }
+};
 struct AudioContext {
     jack_client_t* client = nullptr;
+    // Set instead of client when the registry selects the offline backend.
+    std::shared_ptr<OfflineAudioDriver> offlineDriver;
     std::vector<jack_port_t*> output_ports;
     std::vector<jack_port_t*> input_ports;
     std::vector<jack_port_t*> midi_input_ports;
@@ -453,8 +485,7 @@ struct AudioContext {
     size_t rayItdWriteIndex = 0;
     std::vector<float> rayItdBuffer;
     std::string rayTestPath = "Procedures/assets/music.wav";
-    std::vector<float> rayTestBuffer;
-    uint32_t rayTestSampleRate = 0;
+    SoundtrackSlot rayTestTrack;
     double rayTestPos = 0.0;
     float rayTestGain = 0.0f;
     float rayTestPan = 0.0f;
@@ -485,12 +516,15 @@ struct AudioContext {
     size_t headRayItdWriteIndex = 0;
     std::vector<float> headRayItdBuffer;
     std::string headTrackPath;
-    std::vector<float> headTrackBuffer;
-    uint32_t headTrackSampleRate = 0;
+    SoundtrackSlot headTrack;
+    // Position, gain and loop belong to the audio thread once a track is
+    // adopted; the main thread only ever clears headTrackActive to stop.
     double headTrackPos = 0.0;
     float headTrackGain = 0.0f;
-    bool headTrackActive = false;
+    std::atomic<bool> headTrackActive{false};
     bool headTrackLoop = true;
+    // Background decode/resample thread and soundtrack folder watcher.
+    std::shared_ptr<SoundtrackLoader> soundtrackLoader;
     std::atomic<float> chuckMainLevelGain{0.0f};
     std::atomic<float> soundtrackLevelGain{0.0f};
     std::atomic<float> speakerBlockLevelGain{0.0f};
@@ -503,10 +537,19 @@ struct AudioContext {
     std::vector<std::string> gameplaySfxNames;
     std::vector<std::vector<float>> gameplaySfxBuffers;
     std::vector<uint32_t> gameplaySfxSampleRates;
+    std::vector<double> gameplaySfxLastTrigger;
     std::vector<GameplaySfxVoice> gameplaySfxVoices;
     jack_ringbuffer_t* gameplaySfxEventRing = nullptr;
     std::atomic<float> gameplaySfxMasterGain{1.0f};
     std::atomic<bool> gameplaySfxEnabled{true};
+    // Sounds are appended into storage reserved once, so the audio thread can
+    // index any id below chuckSfxSoundCount while the main thread adds more.
+    std::vector<ChuckSfxSound> chuckSfxSounds;
+    std::atomic<int> chuckSfxSoundCount{0};
+    jack_ringbuffer_t* chuckSfxTriggerRing = nullptr;
+    int chuckSfxVoicesPerSound = 4;
+    bool chuckSfxPreloaded = false;
+    float chuckSfxReloadTimer = 0.0f;
 };
 struct AudioSourceState {
     bool isOccluded = false;
@@ -531,27 +574,71 @@ struct RayTraceSourceAccum {
     glm::vec3 dirSum = glm::vec3(0.0f);
     int dirCount = 0;
 };
+// Per-source results in a flat array indexed by instance id. `ids` lists the
+// filled slots in insertion order, so iteration never scans empty ones.
+struct AudioSourceStateTable {
+    std::vector<AudioSourceState> slots;
+    std::vector<uint8_t> present;
+    std::vector<int> ids;
+
+    bool empty() const { return ids.empty(); }
+    size_t size() const { return ids.size(); }
+    bool contains(int id) const {
+        return id >= 0 && static_cast<size_t>(id) < present.size() && present[static_cast<size_t>(id)] != 0;
+    }
+    const AudioSourceState* find(int id) const { return contains(id) ? &slots[static_cast<size_t>(id)] : nullptr; }
+    AudioSourceState* find(int id) { return contains(id) ? &slots[static_cast<size_t>(id)] : nullptr; }
+    AudioSourceState& insert(int id) {
+        const size_t index = static_cast<size_t>(id);
+        if (index >= slots.size()) {
+            slots.resize(index + 1);
+            present.resize(index + 1, 0);
+        }
+        if (!present[index]) {
+            present[index] = 1;
+            ids.push_back(id);
+        }
+        return slots[index];
+    }
+    void clear() {
+        for (int id : ids) present[static_cast<size_t>(id)] = 0;
+        ids.clear();
+    }
+};
+// The tracer fills back() and publish() flips it to the front, so systems
+// reading front() between traces always see one complete batch.
+struct AudioSourceStateBuffer {
+    AudioSourceStateTable tables[2];
+    int frontIndex = 0;
+
+    AudioSourceStateTable& front() { return tables[frontIndex]; }
+    const AudioSourceStateTable& front() const { return tables[frontIndex]; }
+    AudioSourceStateTable& back() { return tables[frontIndex ^ 1]; }
+    void publish() { frontIndex ^= 1; }
+    bool empty() const { return front().empty(); }
+    void clear() { tables[0].clear(); tables[1].clear(); }
+};
+struct RayTraceHit {
+    glm::vec3 from = glm::vec3(0.0f);
+    glm::vec3 pos = glm::vec3(0.0f);
+    glm::vec3 blueDir = glm::vec3(0.0f);
+    bool hasBlue = false;
+};
 struct RayTraceRayState {
     glm::vec3 pos = glm::vec3(0.0f);
     glm::vec3 dir = glm::vec3(0.0f);
-    int bounceIndex = 0;
-    bool initDone = false;
-    bool finished = false;
     bool escaped = false;
     bool debug = false;
     float blueLenSum = 0.0f;
     int blueLenCount = 0;
     float blueLenMax = 0.0f;
-    std::vector<glm::vec3> lastDirPerSource;
-    std::vector<bool> hasLastDirPerSource;
+    std::vector<RayTraceHit> hits;
 };
 struct RayTraceBatch {
     bool active = false;
     bool debugActive = false;
     int totalRays = 0;
-    int nextRayIndex = 0;
     int finishedRays = 0;
-    int lastPublishedFinishedRays = 0;
     int escapeCount = 0;
     float blueLenSum = 0.0f;
     int blueLenCount = 0;
@@ -561,8 +648,42 @@ struct RayTraceBatch {
     std::vector<int> sourceIds;
     std::vector<glm::vec3> sourcePositions;
     std::vector<RayTraceSourceAccum> accum;
+    std::vector<RayTraceSourceAccum> packetAccum;
     std::vector<RayTraceRayState> rays;
 };
+// One source's ray-traced terms for a cell of the propagation cache. They are
+// reused while no block edit lands inside [boundsMin, boundsMax]; the probe
+// ratios additionally need the ear frame to stay close to probeForward/Right.
+struct RayTracePropagationEntry {
+    bool valid = false;
+    glm::ivec3 boundsMin = glm::ivec3(0);
+    glm::ivec3 boundsMax = glm::ivec3(0);
+    RayTraceSourceAccum accum;
+    bool probesValid = false;
+    glm::vec3 probeForward = glm::vec3(0.0f);
+    glm::vec3 probeRight = glm::vec3(0.0f);
+    float directRatio = 0.0f;
+    float probeRatio = 0.0f;
+};
+// Listener-centred propagation volume. `rays` holds the listener's traced rays
+// while it stays in `listenerCell`; `slots` is a dense kDims^3 grid around that
+// cell pointing into `entries`, so a static source is answered in O(1).
+struct RayTracePropagationCache {
+    static constexpr int kRadius = 32;
+    static constexpr int kDims = 2 * kRadius + 1;
+
+    bool fieldValid = false;
+    glm::ivec3 listenerCell = glm::ivec3(0);
+    int rayCount = 0;
+    int maxBounces = 0;
+    float maxDistance = 0.0f;
+    glm::ivec3 fieldMin = glm::ivec3(0);
+    glm::ivec3 fieldMax = glm::ivec3(0);
+    std::vector<RayTraceRayState> rays;
+    std::vector<int32_t> slots;
+    std::vector<RayTracePropagationEntry> entries;
+    std::vector<int32_t> usedSlots;
+};
 struct MicrophoneInstance {
     int worldIndex = -1;
     int instanceID = -1;
@@ -570,8 +691,8 @@ struct MicrophoneInstance {
     glm::vec3 forward = glm::vec3(0.0f, 0.0f, -1.0f);
 };
 struct RayTracedAudioContext {
-    std::map<int, AudioSourceState> sourceStates;
-    std::map<int, AudioSourceState> micSourceStates;
+    AudioSourceStateBuffer sourceStates;
+    AudioSourceStateBuffer micSourceStates;
     int sourceStatesVersion = 0;
     int micStatesVersion = 0;
     uint64_t lastCacheEnsureFrame = 0;
@@ -581,6 +702,8 @@ struct RayTracedAudioContext {
     std::vector<std::pair<int, int>> sourceInstances;
     RayTraceBatch batch;
     RayTraceBatch micBatch;
+    RayTracePropagationCache propagation;
+    RayTracePropagationCache micPropagation;
     double lastBatchCompleteTime = -1.0;
     double lastMicBatchCompleteTime = -1.0;
     bool micCaptureActive = false;
@@ -590,6 +713,8 @@ struct RayTracedAudioContext {
     glm::vec3 micListenerForward = glm::vec3(0.0f, 0.0f, -1.0f);
     std::vector<MicrophoneInstance> microphones;
     std::unordered_map<int, glm::vec3> microphoneDirections;
+    std::shared_ptr<RayTraceWorkerPool> workerPool;
+    int workerPoolThreads = -1;
 };
 struct HUDContext {
     bool showCharge = false;
@@ -880,10 +1005,46 @@ struct DawClip {
     uint64_t sourceOffset = 0;
     int takeId = -1;
 };
+struct DawWaveformLevel {
+    std::vector<float> minL;
+    std::vector<float> maxL;
+    std::vector<float> minR;
+    std::vector<float> maxR;
+    std::vector<float> rmsL;
+    std::vector<float> rmsR;
+    std::vector<glm::vec3> color;
+};
+// Min/max/RMS mipmap of one clip's source audio. Level n holds one entry per
+// (kBaseBlockFrames << n) frames; builtFrames tracks incremental construction.
+struct DawWaveformPyramid {
+    static constexpr uint32_t kBaseBlockFrames = 256;
+    std::vector<DawWaveformLevel> levels;
+    uint64_t totalFrames = 0;
+    uint64_t builtFrames = 0;
+};
+struct DawWaveformSpan {
+    float minL = 0.0f;
+    float maxL = 0.0f;
+    float minR = 0.0f;
+    float maxR = 0.0f;
+    float rmsL = 0.0f;
+    float rmsR = 0.0f;
+    glm::vec3 color = glm::vec3(0.0f);
+};
 struct DawClipAudio {
     int channels = 1;
     std::vector<float> left;
     std::vector<float> right;
+    // Large clips stay on disk: streamId indexes DawContext::sampleCache and
+    // left/right are left empty.
+    int streamId = -1;
+    uint64_t streamFrames = 0;
+    bool isStreamed() const { return streamId >= 0; }
+    uint64_t frameCount() const { return isStreamed() ? streamFrames : static_cast<uint64_t>(left.size()); }
+    DawWaveformPyramid waveform;
+    // Pool entries never change once added; this names the session asset
+    // file and keys the track mirrors. 0 until DawIOSystem first needs it.
+    uint64_t contentHash = 0;
 };
 struct MidiNote {
     int pitch = 0;
@@ -921,10 +1082,13 @@ struct AutomationTrack {
     std::string targetParameterLabel = "NONE";
 };
 struct DawTrack {
-    std::vector<float> audio;
-    std::vector<float> audioRight;
+    // Live-preview tail of the take being recorded; the take itself is written
+    // to disk by DawRecordSystem. pendingRecord[0] is take frame pendingRecordBase.
     std::vector<float> pendingRecord;
     std::vector<float> pendingRecordRight;
+    uint64_t pendingRecordBase = 0;
+    std::string recordTakePath;
+    uint64_t recordTakeFrames = 0;
     std::vector<DawClip> clips;
     std::vector<DawClip> loopTakeClips;
     std::vector<float> waveformMin;
@@ -960,6 +1124,7 @@ struct DawTrack {
     int inputIndex = 0;
     jack_ringbuffer_t* recordRing = nullptr;
     jack_ringbuffer_t* recordRingRight = nullptr;
+    std::atomic<uint64_t> recordDroppedFrames{0};
 
     DawTrack() = default;
     DawTrack(const DawTrack&) = delete;
@@ -967,10 +1132,11 @@ struct DawTrack {
     DawTrack(DawTrack&& other) noexcept { *this = std::move(other); }
     DawTrack& operator=(DawTrack&& other) noexcept {
         if (this == &other) return *this;
-        audio = std::move(other.audio);
-        audioRight = std::move(other.audioRight);
         pendingRecord = std::move(other.pendingRecord);
         pendingRecordRight = std::move(other.pendingRecordRight);
+        pendingRecordBase = other.pendingRecordBase;
+        recordTakePath = std::move(other.recordTakePath);
+        recordTakeFrames = other.recordTakeFrames;
         clips = std::move(other.clips);
         loopTakeClips = std::move(other.loopTakeClips);
         waveformMin = std::move(other.waveformMin);
@@ -1006,6 +1172,7 @@ struct DawTrack {
         inputIndex = other.inputIndex;
         recordRing = other.recordRing;
         recordRingRight = other.recordRingRight;
+        recordDroppedFrames.store(other.recordDroppedFrames.load(std::memory_order_relaxed), std::memory_order_relaxed);
         other.recordRing = nullptr;
         other.recordRingRight = nullptr;
         return *this;
@@ -1037,9 +1204,19 @@ struct DawContext {
     bool initialized = false;
     bool mirrorAvailable = false;
     std::string mirrorPath;
+    std::vector<uint64_t> mirrorKeys;  // content last written to Mirror/track_<i+1>.wav
+    std::string sessionPath;           // last saved or loaded; autosave writes beside it
+    double autosaveIntervalSeconds = 60.0;
     std::vector<DawTrack> tracks;
     std::vector<AutomationTrack> automationTracks;
     std::vector<DawClipAudio> clipAudio;
+    std::shared_ptr<DawSampleCache> sampleCache;
+    std::shared_ptr<DawDiskRecorder> diskRecorder;
+    uint64_t clipWaveformVersion = 0;
+    int streamCachePages = 64;
+    uint64_t streamThresholdBytes = 32ull << 20;
+    double streamReadAheadSeconds = 2.0;
+    bool streamConfigLoaded = false;
     std::mutex trackMutex;
     std::atomic<bool> transportPlaying{false};
     std::atomic<bool> transportRecording{false};
@@ -1169,7 +1346,6 @@ struct DawContext {
     uint64_t exportJobStartSample = 0;
     uint64_t exportJobEndSample = 0;
     uint64_t exportJobCursorSample = 0;
-    std::array<std::vector<float>, kBusCount> exportStemBuffers;
     std::vector<std::array<float, 128>> exportMidiHeldVelocities;
     int64_t exportSavedContinuousSamples = 0;
     bool exportSavedTransportPlaying = false;
@@ -1347,6 +1523,12 @@ struct PerfContext {
     double lastReportTime = 0.0;
     int frameCount = 0;
     double hitchThresholdMs = 16.0;
+    uint32_t drawCallBudget = 0;   // per frame; 0 = unchecked
+    size_t uploadByteBudget = 0;   // per frame; 0 = unchecked
+    int overDrawBudgetFrames = 0;
+    int overUploadBudgetFrames = 0;
+    uint32_t peakDrawCalls = 0;
+    size_t peakUploadBytes = 0;
     std::unordered_set<std::string> allowlist;
     std::unordered_map<std::string, double> totalsMs;
     std::unordered_map<std::string, double> maxMs;
@@ -1391,14 +1573,29 @@ using SystemFunction = std::function<void(BaseSystem&, std::vector<Entity>&, flo
 
 // --- SYSTEM FUNCTION DECLARATIONS ---
 namespace HostLogic { void LoadProcedureAssets(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); EntityInstance CreateInstance(BaseSystem&, const std::vector<Entity>&, const std::string&, glm::vec3, glm::vec3); EntityInstance CreateInstance(BaseSystem&, int, glm::vec3, glm::vec3); glm::vec3 hexToVec3(const std::string& hex); const Entity* findPrototype(const std::string&, const std::vector<Entity>&); }
-namespace RayTracedAudioSystemLogic { void ProcessRayTracedAudio(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
+namespace RayTracedAudioSystemLogic {
+    void ProcessRayTracedAudio(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    void InvalidatePropagationCell(BaseSystem&, const glm::ivec3&);
+    void InvalidatePropagation(BaseSystem&);
+}
 namespace PinkNoiseSystemLogic { void ProcessPinkNoiseAudicle(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace AudioSystemLogic {
+    // Fills the offline driver's input channels (pre-zeroed) for the block
+    // that starts at startFrame.
+    using OfflineInputScript = std::function<void(uint64_t startFrame, uint32_t frames, std::vector<std::vector<float>>& inputs)>;
     void InitializeAudio(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    void PumpOfflineAudio(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
     void CleanupAudio(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
-    bool TriggerGameplaySfx(BaseSystem&, const std::string&, float gain = 1.0f);
+    bool TriggerGameplaySfx(BaseSystem&, const std::string&, float gain = 1.0f, float cooldownSeconds = 0.0f);
+    bool OpenOfflineAudio(AudioContext& audio, uint32_t sampleRate, uint32_t bufferFrames);
+    void RenderOfflineBlocks(AudioContext& audio, size_t blockCount);
+    bool StartOfflineCapture(AudioContext& audio, const std::string& wavPath, bool toMemory);
+    void StopOfflineCapture(AudioContext& audio);
+}
+namespace SoundtrackSystemLogic {
+    void UpdateSoundtracks(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    void CleanupSoundtracks(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
 }
-namespace SoundtrackSystemLogic { void UpdateSoundtracks(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace AudicleSystemLogic { void ProcessAudicles(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace AudioVisualizerFollowerSystemLogic { void UpdateAudioVisualizerFollower(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace SpawnSystemLogic { void SetPlayerSpawn(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
@@ -1408,7 +1605,13 @@ namespace MouseInputSystemLogic { void UpdateCameraRotationFromMouse(BaseSystem&
 namespace UAVSystemLogic { void ProcessUAVMovement(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace WalkModeSystemLogic { void ProcessWalkMovement(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace GravitySystemLogic { void ApplyGravity(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
-namespace CollisionSystemLogic { void ResolveCollisions(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
+namespace CollisionSystemLogic {
+    void ResolveCollisions(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    void NotifyBlockAdded(BaseSystem&, const std::vector<Entity>&, int, const glm::vec3&, int prototypeID);
+    void NotifyBlockRemoved(BaseSystem&, int, const glm::vec3&);
+    void InvalidateColliders(int worldIndex);
+    void QueryColliderBatch(BaseSystem&, const std::vector<Entity>&, const std::vector<glm::vec3>&, const std::vector<glm::vec3>&, std::vector<int>&, std::vector<glm::vec3>&, std::vector<glm::vec3>&);
+}
 namespace VolumeFillSystemLogic { void ProcessVolumeFills(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace RenderInitSystemLogic { void InitializeRenderer(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); void CleanupRenderer(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace VoxelMeshInitSystemLogic { void UpdateVoxelMeshInit(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
@@ -1422,10 +1625,12 @@ namespace TerrainSystemLogic { void GenerateTerrain(BaseSystem&, std::vector<Ent
 namespace BlockSelectionSystemLogic {
     void UpdateBlockSelection(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
     bool HasBlockAt(BaseSystem&, const std::vector<Entity>&, int, const glm::vec3&);
+    const EntityInstance* FindBlockInstance(const BaseSystem&, const std::vector<Entity>&, int, const glm::vec3&);
     void AddBlockToCache(BaseSystem&, std::vector<Entity>&, int, const glm::vec3&, int prototypeID);
     void RemoveBlockFromCache(BaseSystem&, const std::vector<Entity>&, int, const glm::vec3&);
     void EnsureAllCaches(BaseSystem&, const std::vector<Entity>&);
     bool SampleBlockDamping(BaseSystem&, const glm::ivec3&, float&);
+    const DampingBrickmap* GetDampingBrickmap(BaseSystem&);
 }
 namespace StructureCaptureSystemLogic { void ProcessStructureCapture(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); void NotifyBlockChanged(BaseSystem&, int, const glm::vec3&); }
 namespace StructurePlacementSystemLogic { void ProcessStructurePlacement(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
@@ -1464,14 +1669,27 @@ namespace FontSystemLogic { void UpdateFonts(BaseSystem&, std::vector<Entity>&,
 namespace DebugHudSystemLogic { void UpdateDebugHud(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace DebugWireframeSystemLogic { void UpdateDebugWireframe(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace PerfSystemLogic { void UpdatePerf(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
-namespace ChucKSystemLogic { void UpdateChucK(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
+namespace ChucKSystemLogic {
+    void UpdateChucK(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    bool TriggerSfx(BaseSystem& baseSystem, const std::string& scriptPath, float cooldownSeconds = 0.0f);
+    void DispatchSfxTriggers(AudioContext& audio);
+}
 namespace Vst3SystemLogic { void InitializeVst3(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); void UpdateVst3(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); void CleanupVst3(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace Vst3BrowserSystemLogic { void UpdateVst3Browser(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace AudioRayVisualizerSystemLogic { void UpdateAudioRayVisualizer(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace DawTrackSystemLogic { void UpdateDawTracks(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); void CleanupDawTracks(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); bool InsertTrackAt(BaseSystem&, int trackIndex); bool RemoveTrackAt(BaseSystem&, int trackIndex); bool MoveTrack(BaseSystem&, int fromIndex, int toIndex); }
 namespace DawTransportSystemLogic { void UpdateDawTransport(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
-namespace DawClipSystemLogic { void UpdateDawClips(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); bool CycleTrackLoopTake(DawContext& daw, int trackIndex, int direction); }
-namespace DawWaveformSystemLogic { void UpdateDawWaveforms(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
+namespace DawClipSystemLogic {
+    void UpdateDawClips(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    bool CycleTrackLoopTake(DawContext& daw, int trackIndex, int direction);
+    uint64_t TrackEndSample(const DawTrack& track);
+    void RenderTrackRange(DawContext& daw, const DawTrack& track, uint64_t startSample, size_t count, float* outLeft, float* outRight);
+}
+namespace DawWaveformSystemLogic {
+    void UpdateDawWaveforms(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    void UpdateClipWaveformRange(DawContext& daw, DawClipAudio& clipAudio, uint64_t startFrame, uint64_t endFrame);
+    bool QueryClipWaveform(const DawClipAudio& clipAudio, uint64_t startFrame, uint64_t endFrame, DawWaveformSpan& out);
+}
 namespace DawUiSystemLogic { void UpdateDawUi(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); void ClampTimelineOffset(DawContext& daw); }
 namespace DawIOSystemLogic {
     void UpdateDawIO(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
@@ -1487,6 +1705,31 @@ namespace DawIOSystemLogic {
     bool PromptAndSaveSession(BaseSystem& baseSystem);
     bool PromptAndLoadSession(BaseSystem& baseSystem);
     void TickStemExport(BaseSystem& baseSystem, float dt);
+    void CancelStemExport(BaseSystem& baseSystem, bool waitForWorker);
+    void ShutdownAutosave();
+    bool LoadClipAudioFile(DawContext& daw, const std::string& path, DawClipAudio& outClip, uint32_t& outRate);
+}
+namespace DawRecordSystemLogic {
+    bool BeginTakes(DawContext& daw);
+    void FinishTakes(DawContext& daw);
+    void AbortTakes(DawContext& daw);
+    void AbortTrackTake(DawContext& daw, const DawTrack& track);
+    void DrainRecordPreview(DawContext& daw);
+    void SweepTakeFiles(DawContext& daw, bool keepReferenced);
+    void ShutdownRecorder(DawContext& daw);
+    void WriteRecordInputRT(DawTrack& track, const float* left, const float* right, size_t frames);
+}
+namespace DawStreamSystemLogic {
+    void UpdateDawStreaming(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    void CleanupDawStreaming(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*);
+    bool OpenStreamedClipAudio(DawContext& daw, const std::string& path, DawClipAudio& outClip, uint32_t& outRate);
+    void ReleaseStream(DawContext& daw, DawClipAudio& clipAudio);
+    void ReleaseStreams(DawContext& daw);
+    size_t ReadStreamFramesRT(DawContext& daw, const DawClipAudio& clipAudio, uint64_t frameOffset,
+                              size_t count, float* outL, float* outR);
+    bool ReadStreamFrames(DawContext& daw, const DawClipAudio& clipAudio, uint64_t frameOffset,
+                          size_t count, float* outL, float* outR);
+    std::string StreamSourcePath(const DawContext& daw, const DawClipAudio& clipAudio);
 }
 namespace DawLaneTimelineSystemLogic { void UpdateDawLaneTimeline(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
 namespace DawLaneInputSystemLogic { void UpdateDawLaneInput(BaseSystem&, std::vector<Entity>&, float, GLFWwindow*); }
@@ -4,6 +4,7 @@
 #include <vector>
 #include <algorithm>
 #include <filesystem>
+#include "BaseSystem/PrototypeTraits.h"
 #include "BaseSystem/Vst3Host.h"
 
 void Host::run() { init(); mainLoop(); cleanup(); }
@@ -13,9 +14,11 @@ void Host::registerSystemFunctions() {
     functionRegistry["SetPlayerSpawn"] = SpawnSystemLogic::SetPlayerSpawn;
     functionRegistry["InitializeAudio"] = AudioSystemLogic::InitializeAudio;
     functionRegistry["InitializeVst3"] = Vst3SystemLogic::InitializeVst3;
+    functionRegistry["PumpOfflineAudio"] = AudioSystemLogic::PumpOfflineAudio;
     functionRegistry["CleanupAudio"] = AudioSystemLogic::CleanupAudio;
     functionRegistry["CleanupVst3"] = Vst3SystemLogic::CleanupVst3;
     functionRegistry["UpdateSoundtracks"] = SoundtrackSystemLogic::UpdateSoundtracks;
+    functionRegistry["CleanupSoundtracks"] = SoundtrackSystemLogic::CleanupSoundtracks;
     functionRegistry["ProcessRayTracedAudio"] = RayTracedAudioSystemLogic::ProcessRayTracedAudio;
     functionRegistry["ProcessPinkNoiseAudicle"] = PinkNoiseSystemLogic::ProcessPinkNoiseAudicle;
     functionRegistry["ProcessAudicles"] = AudicleSystemLogic::ProcessAudicles;
@@ -86,6 +89,8 @@ void Host::registerSystemFunctions() {
     functionRegistry["UpdatePianoRollLayout"] = PianoRollLayoutSystemLogic::UpdatePianoRollLayout;
     functionRegistry["UpdatePianoRollInput"] = PianoRollInputSystemLogic::UpdatePianoRollInput;
     functionRegistry["UpdatePianoRollRender"] = PianoRollRenderSystemLogic::UpdatePianoRollRender;
+    functionRegistry["FlushUIBatch"] = UIBatchSystemLogic::FlushUIBatch;
+    functionRegistry["CleanupUIBatch"] = UIBatchSystemLogic::CleanupUIBatch;
     functionRegistry["UpdateChucK"] = ChucKSystemLogic::UpdateChucK;
     functionRegistry["UpdateVst3"] = Vst3SystemLogic::UpdateVst3;
     functionRegistry["UpdateVst3Browser"] = Vst3BrowserSystemLogic::UpdateVst3Browser;
@@ -93,6 +98,8 @@ void Host::registerSystemFunctions() {
     functionRegistry["UpdateSoundPhysics"] = SoundPhysicsSystemLogic::UpdateSoundPhysics;
     functionRegistry["UpdateRegistry"] = RegistryEditorSystemLogic::UpdateRegistry;
     functionRegistry["UpdateMirrors"] = MirrorSystemLogic::UpdateMirrors;
+    functionRegistry["UpdateDawStreaming"] = DawStreamSystemLogic::UpdateDawStreaming;
+    functionRegistry["CleanupDawStreaming"] = DawStreamSystemLogic::CleanupDawStreaming;
     functionRegistry["UpdateDawTracks"] = DawTrackSystemLogic::UpdateDawTracks;
     functionRegistry["CleanupDawTracks"] = DawTrackSystemLogic::CleanupDawTracks;
     functionRegistry["UpdateDawTransport"] = DawTransportSystemLogic::UpdateDawTransport;
@@ -201,6 +208,7 @@ void Host::init() {
     if (!window) { std::cout << "Failed to create GLFW window\n"; glfwTerminate(); exit(-1); }
     glfwMakeContextCurrent(window);
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { std::cout << "Failed to initialize GLAD\n"; exit(-1); }
+    RenderDevice::setCurrent(&HostLogic::GLDevice());
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetWindowUserPointer(window, this);
@@ -281,6 +289,7 @@ void Host::reloadLevel(const std::string& levelName) {
     if (baseSystem.font) baseSystem.font = std::make_unique<FontContext>();
     if (baseSystem.uiStamp) baseSystem.uiStamp = std::make_unique<UIStampingContext>();
     if (baseSystem.panel) baseSystem.panel = std::make_unique<PanelContext>();
+    CollisionSystemLogic::InvalidateColliders(-1);
     if (baseSystem.rayTracedAudio) {
         baseSystem.rayTracedAudio->sourceCacheBuilt = false;
         baseSystem.rayTracedAudio->sourceInstances.clear();
@@ -288,6 +297,7 @@ void Host::reloadLevel(const std::string& levelName) {
         baseSystem.rayTracedAudio->debugSegments.clear();
         baseSystem.rayTracedAudio->lastDebugTime = -1.0;
         baseSystem.rayTracedAudio->batch = RayTraceBatch{};
+        RayTracedAudioSystemLogic::InvalidatePropagation(baseSystem);
         baseSystem.rayTracedAudio->lastBatchCompleteTime = -1.0;
     }
     // Keep UIContext but clear runtime flags.
@@ -486,6 +496,7 @@ void Host::PopulateWorldsFromLevel() {
         loadEntityFile(filePath);
     }
     loadEntityDirectory("Entities/UI");
+    PrototypeTraits::Rebuild(entityPrototypes);
 
     std::string levelName = std::get<std::string>(registry["level"]);
     std::string levelPath = "Levels/" + levelName + "_level.json";
@@ -688,6 +699,7 @@ void Host::mainLoop() {
             player.leftMouseReleased = false;
             player.middleMouseReleased = false;
         }
+        RenderDevice::current().endFrame();
         auto swapStart = std::chrono::steady_clock::now();
         glfwSwapBuffers(window);
         auto now = std::chrono::steady_clock::now();
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "BaseSystem/RenderDevice.h"
+
+// --- GL 3.3 Render Device ---
+// The game build's RenderDevice backend: every Device call goes straight to
+// GL, which keeps the state itself.
+namespace RenderDevice {
+    namespace {
+        void logShaderStatus(GLuint object, bool program) {
+            GLint ok = 0;
+            char log[1024];
+            if (program) {
+                glGetProgramiv(object, GL_LINK_STATUS, &ok);
+                if (!ok) { glGetProgramInfoLog(object, 1024, 0, log); std::cout << "SHADER LINK ERROR: " << log << std::endl; }
+            } else {
+                glGetShaderiv(object, GL_COMPILE_STATUS, &ok);
+                if (!ok) { glGetShaderInfoLog(object, 1024, 0, log); std::cout << "SHADER COMPILE ERROR: " << log << std::endl; }
+            }
+        }
+
+        GLuint compileStage(GLenum stage, const char* source) {
+            GLuint shader = glCreateShader(stage);
+            glShaderSource(shader, 1, &source, 0);
+            glCompileShader(shader);
+            logShaderStatus(shader, false);
+            return shader;
+        }
+    }
+
+    struct Backend {};
+
+    Device::Device() : state(std::make_unique<Backend>()) {}
+    Device::~Device() = default;
+
+    uint32_t Device::createVertexArray() { GLuint vao = 0; glGenVertexArrays(1, &vao); return vao; }
+    uint32_t Device::createBuffer() { GLuint buffer = 0; glGenBuffers(1, &buffer); return buffer; }
+    void Device::deleteVertexArray(uint32_t vao) { GLuint name = vao; glDeleteVertexArrays(1, &name); }
+    void Device::deleteBuffer(uint32_t buffer) { GLuint name = buffer; glDeleteBuffers(1, &name); }
+    uint32_t Device::createProgram(const char* vertexSource, const char* fragmentSource) {
+        GLuint program = glCreateProgram();
+        GLuint vs = compileStage(GL_VERTEX_SHADER, vertexSource);
+        GLuint fs = compileStage(GL_FRAGMENT_SHADER, fragmentSource);
+        glAttachShader(program, vs);
+        glAttachShader(program, fs);
+        glLinkProgram(program);
+        logShaderStatus(program, true);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        return program;
+    }
+
+    void Device::bindVertexArray(uint32_t vao) { glBindVertexArray(vao); }
+    void Device::bindBuffer(uint32_t target, uint32_t buffer) { glBindBuffer(target, buffer); }
+    void Device::bindFramebuffer(uint32_t target, uint32_t framebuffer) { glBindFramebuffer(target, framebuffer); }
+    void Device::activeTexture(uint32_t unit) { glActiveTexture(unit); }
+    void Device::bindTexture(uint32_t target, uint32_t texture) { glBindTexture(target, texture); }
+    void Device::enable(uint32_t capability) { glEnable(capability); }
+    void Device::disable(uint32_t capability) { glDisable(capability); }
+    void Device::depthMask(bool write) { glDepthMask(write ? GL_TRUE : GL_FALSE); }
+    void Device::blendFunc(uint32_t source, uint32_t destination) { glBlendFunc(source, destination); }
+    void Device::blendColor(float r, float g, float b, float a) { glBlendColor(r, g, b, a); }
+    void Device::frontFace(uint32_t mode) { glFrontFace(mode); }
+    void Device::cullFace(uint32_t mode) { glCullFace(mode); }
+    void Device::lineWidth(float width) { glLineWidth(width); }
+    void Device::polygonMode(uint32_t face, uint32_t mode) { glPolygonMode(face, mode); }
+    void Device::viewport(int32_t x, int32_t y, int32_t width, int32_t height) { glViewport(x, y, width, height); }
+    void Device::getViewport(int32_t out[4]) { glGetIntegerv(GL_VIEWPORT, out); }
+    void Device::scissor(int32_t x, int32_t y, int32_t width, int32_t height) { glScissor(x, y, width, height); }
+    void Device::clearColor(float r, float g, float b, float a) { glClearColor(r, g, b, a); }
+    void Device::clear(uint32_t mask) { glClear(mask); }
+    int32_t Device::getInteger(uint32_t name) { GLint value = 0; glGetIntegerv(name, &value); return value; }
+
+    void Device::vertexAttribPointer(uint32_t index, int32_t size, uint32_t type, bool normalized,
+                                     int32_t stride, size_t offset) {
+        glVertexAttribPointer(index, size, type, normalized ? GL_TRUE : GL_FALSE, stride,
+                              reinterpret_cast<void*>(offset));
+    }
+    void Device::vertexAttribIPointer(uint32_t index, int32_t size, uint32_t type, int32_t stride, size_t offset) {
+        glVertexAttribIPointer(index, size, type, stride, reinterpret_cast<void*>(offset));
+    }
+    void Device::enableVertexAttribArray(uint32_t index) { glEnableVertexAttribArray(index); }
+    void Device::vertexAttribDivisor(uint32_t index, uint32_t divisor) { glVertexAttribDivisor(index, divisor); }
+
+    bool Device::hasBufferStorage() const {
+#if defined(GL_MAP_PERSISTENT_BIT)
+        return glBufferStorage != nullptr;
+#else
+        return false;
+#endif
+    }
+    void Device::bufferStorage(uint32_t target, size_t bytes, const void* data, uint32_t flags) {
+#if defined(GL_MAP_PERSISTENT_BIT)
+        glBufferStorage(target, static_cast<GLsizeiptr>(bytes), data, flags);
+#else
+        (void)target; (void)bytes; (void)data; (void)flags;
+#endif
+    }
+    void* Device::mapBufferRange(uint32_t target, size_t offset, size_t bytes, uint32_t access) {
+        return glMapBufferRange(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), access);
+    }
+    bool Device::unmapBuffer(uint32_t target) { return glUnmapBuffer(target) == GL_TRUE; }
+
+    Fence Device::fenceSync() {
+        return reinterpret_cast<Fence>(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    }
+    bool Device::waitFence(Fence fence, uint64_t timeoutNs) {
+        GLenum status = glClientWaitSync(reinterpret_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+        return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED;
+    }
+    void Device::deleteFence(Fence fence) { glDeleteSync(reinterpret_cast<GLsync>(fence)); }
+
+    void Device::doBufferData(uint32_t target, size_t bytes, const void* data, uint32_t usage) {
+        glBufferData(target, static_cast<GLsizeiptr>(bytes), data, usage);
+    }
+    void Device::doBufferSubData(uint32_t target, size_t offset, size_t bytes, const void* data) {
+        glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), data);
+    }
+    void Device::doUseProgram(uint32_t program) { glUseProgram(program); }
+    void Device::doUniform(uint32_t program, const std::string& name, const float* values, int count, bool integer) {
+        GLint location = glGetUniformLocation(program, name.c_str());
+        if (integer) { glUniform1i(location, static_cast<GLint>(values[0])); return; }
+        switch (count) {
+            case 16: glUniformMatrix4fv(location, 1, GL_FALSE, values); break;
+            case 3: glUniform3fv(location, 1, values); break;
+            case 2: glUniform2fv(location, 1, values); break;
+            default: glUniform1f(location, values[0]); break;
+        }
+    }
+    void Device::doUniformVec4Array(uint32_t program, const std::string& name, const float* values, int count) {
+        glUniform4fv(glGetUniformLocation(program, name.c_str()), count, values);
+    }
+    void Device::doDrawArrays(uint32_t mode, int32_t first, int32_t count, int32_t instances, bool instanced) {
+        if (instanced) glDrawArraysInstanced(mode, first, count, instances);
+        else glDrawArrays(mode, first, count);
+    }
+    void Device::doMultiDrawArrays(uint32_t mode, const int32_t* firsts, const int32_t* counts, int32_t drawCount) {
+        glMultiDrawArrays(mode, firsts, counts, drawCount);
+    }
+}
+
+namespace HostLogic {
+    // The device for the window's GL context; valid once GLAD has loaded.
+    RenderDevice::Device& GLDevice() {
+        static RenderDevice::Device device;
+        return device;
+    }
+}
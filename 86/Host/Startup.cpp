@@ -52,14 +52,14 @@ namespace HostLogic {
             {"COLOR_EMOTION_FRAGMENT_SHADER", "Procedures/Shaders/ColorEmotion.frag.glsl"},
             {"CROSSHAIR_VERTEX_SHADER", "Procedures/Shaders/Crosshair.vert.glsl"},
             {"CROSSHAIR_FRAGMENT_SHADER", "Procedures/Shaders/Crosshair.frag.glsl"},
-            {"UI_VERTEX_SHADER", "Procedures/Shaders/UI.vert.glsl"},
-            {"UI_FRAGMENT_SHADER", "Procedures/Shaders/UI.frag.glsl"},
-            {"UI_COLOR_VERTEX_SHADER", "Procedures/Shaders/UIColor.vert.glsl"},
-            {"UI_COLOR_FRAGMENT_SHADER", "Procedures/Shaders/UIColor.frag.glsl"},
             {"GLYPH_VERTEX_SHADER", "Procedures/Shaders/Glyph.vert.glsl"},
             {"GLYPH_FRAGMENT_SHADER", "Procedures/Shaders/Glyph.frag.glsl"},
             {"FONT_VERTEX_SHADER", "Procedures/Shaders/Font.vert.glsl"},
             {"FONT_FRAGMENT_SHADER", "Procedures/Shaders/Font.frag.glsl"},
+            {"UI_BATCH_VERTEX_SHADER", "Procedures/Shaders/UIBatch.vert.glsl"},
+            {"UI_BATCH_COLOR_FRAGMENT_SHADER", "Procedures/Shaders/UIBatchColor.frag.glsl"},
+            {"UI_BATCH_TEXT_FRAGMENT_SHADER", "Procedures/Shaders/UIBatchText.frag.glsl"},
+            {"UI_LANE_VERTEX_SHADER", "Procedures/Shaders/UILane.vert.glsl"},
             {"AUDIORAY_VERTEX_SHADER", "Procedures/Shaders/AudioRay.vert.glsl"},
             {"AUDIORAY_FRAGMENT_SHADER", "Procedures/Shaders/AudioRay.frag.glsl"},
             {"AUDIORAY_VOXEL_VERTEX_SHADER", "Procedures/Shaders/AudioRayVoxel.vert.glsl"},
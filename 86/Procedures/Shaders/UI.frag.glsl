@@ -1,7 +0,0 @@
-#version 330 core
-uniform vec3 color;
-out vec4 FragColor;
-void main(){
-    FragColor = vec4(color, 1.0);
-}
-
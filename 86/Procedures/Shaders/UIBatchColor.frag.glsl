@@ -1,7 +1,7 @@
 #version 330 core
-in vec3 vColor;
+in vec2 vUV;
+in vec4 vColor;
 out vec4 FragColor;
 void main(){
-    FragColor = vec4(vColor, 1.0);
+    FragColor = vColor;
 }
-
@@ -0,0 +1,9 @@
+#version 330 core
+in vec2 vUV;
+in vec4 vColor;
+uniform sampler2D fontTex;
+out vec4 FragColor;
+void main() {
+    float a = texture(fontTex, vUV).r;
+    FragColor = vec4(vColor.rgb, vColor.a * a);
+}
@@ -0,0 +1,90 @@
+#version 330 core
+// Retained timeline lane geometry (BaseSystem/LaneGeometry.h). x follows the
+// view's scroll and zoom, y the lane's row; LaneGeometry::place and toNdc are
+// the same placement on the CPU.
+layout (location = 0) in vec4 aAnchor;   // own sample, other note edge (hi, lo)
+layout (location = 1) in vec4 aClip;     // clip start and end (hi, lo)
+layout (location = 2) in float aDx;
+layout (location = 3) in vec2 aDy;
+layout (location = 4) in vec4 aColor;
+layout (location = 5) in uint aMeta;     // kind | side << 4 | lane << 8
+uniform vec2 uOffset;                    // view offset in samples, split like the anchors
+uniform vec2 uWindow;                    // samples across the lane, hi + lo
+uniform vec2 uLane;                      // lane left and right in window pixels
+uniform vec2 uScreen;
+uniform float uAlpha;
+uniform vec4 uCenterY[64];               // centers of this page's 256 lanes
+out vec2 vUV;
+out vec4 vColor;
+
+// The immediate pass rounded these quotients from doubles. They are carried
+// as float pairs built from products of 12-bit halves, which are exact
+// whether or not the compiler fuses them into the adds that follow.
+vec2 splitHalves(float a) {
+    float hi = uintBitsToFloat(floatBitsToUint(a) & 0xfffff000u);
+    return vec2(hi, a - hi);
+}
+
+vec2 twoSum(float a, float b) {
+    float s = a + b;
+    float bb = s - a;
+    return vec2(s, (a - (s - bb)) + (b - bb));
+}
+
+vec2 twoProd(float a, float b) {
+    vec2 as = splitHalves(a);
+    vec2 bs = splitHalves(b);
+    vec2 s0 = twoSum(as.x * bs.x, as.x * bs.y);
+    vec2 s1 = twoSum(s0.x, as.y * bs.x);
+    vec2 s2 = twoSum(s1.x, as.y * bs.y);
+    float rest = (s0.y + s1.y) + s2.y;
+    float p = s2.x + rest;
+    return vec2(p, rest - (p - s2.x));
+}
+
+vec2 divide(vec2 n, vec2 d) {
+    float q0 = n.x / d.x;
+    vec2 p = twoProd(q0, d.x);
+    vec2 r = twoSum(n.x, -p.x);
+    vec2 ql = twoProd(q0, d.y);
+    float q1 = ((r.x + (r.y - p.y)) + (n.y - ql.x)) / d.x;
+    float q = q0 + q1;
+    return vec2(q, q1 - (q - q0));
+}
+
+float timelineX(vec2 sampleSplit) {
+    vec2 distance = twoSum(sampleSplit.x - uOffset.x, sampleSplit.y - uOffset.y);
+    float ratio = divide(distance, uWindow).x;
+    return uLane.x + twoProd(uLane.y - uLane.x, ratio).x;
+}
+
+// std::clamp's order of tests, which also decides when lo > hi.
+float clampOrdered(float v, float lo, float hi) {
+    return v < lo ? lo : (hi < v ? hi : v);
+}
+
+void main(){
+    uint kind = aMeta & 15u;
+    uint lane = (aMeta >> 8u) & 255u;
+    float x = aDx;
+    if (kind == 1u) {
+        x = min(max(timelineX(aAnchor.xy) + aDx, uLane.x), uLane.y);
+    } else if (kind == 2u) {
+        x = min(max(timelineX(aAnchor.xy), uLane.x + 1.0), uLane.y - 1.0) + aDx;
+    } else if (kind == 3u) {
+        float lo = max(timelineX(aClip.xy), uLane.x) + 1.0;
+        float hi = min(timelineX(aClip.zw), uLane.y) - 1.0;
+        float own = clampOrdered(timelineX(aAnchor.xy), lo, hi);
+        float other = clampOrdered(timelineX(aAnchor.zw), lo, hi);
+        bool right = ((aMeta >> 4u) & 1u) != 0u;
+        float x0 = right ? other : own;
+        float x1 = right ? own : other;
+        x = (x1 <= x0 + 0.5) ? x0 : own;
+    }
+    float y = (uCenterY[lane >> 2u][lane & 3u] + aDy.x) + aDy.y;
+    float ndcX = divide(twoSum(2.0 * x, -uScreen.x), vec2(uScreen.x, 0.0)).x;
+    float ndcY = divide(twoSum(uScreen.y, -2.0 * y), vec2(uScreen.y, 0.0)).x;
+    vUV = vec2(0.0);
+    vColor = vec4(aColor.rgb, uAlpha);
+    gl_Position = vec4(ndcX, ndcY, 0.0, 1.0);
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Open-addressing hash map with robin-hood probing. The probe array holds
+// only keys and node indices, so lookups scan one small contiguous array;
+// values live in separately allocated nodes. References to values, and
+// Handles, stay valid across inserts and rehashes until that entry is
+// erased. Supports the subset of std::unordered_map the voxel code uses.
+// Erasing an entry never moves the other entries.
+template <class Key, class Value, class Hash>
+class StableFlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+    // Cheap reference to one entry that detects erasure: get() returns
+    // nullptr once the entry is gone, even if its node was reused.
+    struct Handle {
+        uint32_t node = kNone;
+        uint32_t generation = 0;
+    };
+
+    struct ProbeStats {
+        size_t entries = 0;
+        size_t capacity = 0;
+        double meanProbe = 0.0; // slots inspected by a successful lookup
+        uint32_t maxProbe = 0;
+    };
+
+    template <bool IsConst>
+    class Iter {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = StableFlatMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+        using MapPtr = std::conditional_t<IsConst, const StableFlatMap*, StableFlatMap*>;
+
+        Iter() = default;
+        Iter(MapPtr owner, uint32_t index) : map(owner), node(index) {}
+        operator Iter<true>() const { return Iter<true>(map, node); }
+
+        reference operator*() const { return *map->nodes[node]; }
+        pointer operator->() const { return map->nodes[node].get(); }
+        Iter& operator++() {
+            node = map->nextLive(node + 1);
+            return *this;
+        }
+        Iter operator++(int) {
+            Iter copy = *this;
+            ++*this;
+            return copy;
+        }
+        bool operator==(const Iter& other) const { return node == other.node; }
+        bool operator!=(const Iter& other) const { return node != other.node; }
+
+    private:
+        friend class StableFlatMap;
+        MapPtr map = nullptr;
+        uint32_t node = kNone;
+    };
+
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    StableFlatMap() = default;
+    StableFlatMap(const StableFlatMap&) = delete;
+    StableFlatMap& operator=(const StableFlatMap&) = delete;
+    StableFlatMap(StableFlatMap&&) = default;
+    StableFlatMap& operator=(StableFlatMap&&) = default;
+
+    iterator begin() { return iterator(this, nextLive(0)); }
+    iterator end() { return iterator(this, kNone); }
+    const_iterator begin() const { return const_iterator(this, nextLive(0)); }
+    const_iterator end() const { return const_iterator(this, kNone); }
+
+    size_t size() const { return liveCount; }
+    bool empty() const { return liveCount == 0; }
+
+    iterator find(const Key& key) { return iterator(this, findNode(key)); }
+    const_iterator find(const Key& key) const { return const_iterator(this, findNode(key)); }
+    size_t count(const Key& key) const { return findNode(key) == kNone ? 0 : 1; }
+
+    template <class V>
+    std::pair<iterator, bool> emplace(const Key& key, V&& value) {
+        const uint32_t existing = findNode(key);
+        if (existing != kNone) return {iterator(this, existing), false};
+        if ((liveCount + 1) * 5 > slots.size() * 4) grow();
+        const uint32_t node = allocateNode(key, std::forward<V>(value));
+        insertSlot(key, node);
+        liveCount += 1;
+        return {iterator(this, node), true};
+    }
+
+    iterator erase(const_iterator pos) {
+        const uint32_t node = pos.node;
+        const uint32_t next = nextLive(node + 1);
+        eraseSlot(nodes[node]->first);
+        releaseNode(node);
+        return iterator(this, next);
+    }
+
+    size_t erase(const Key& key) {
+        const uint32_t node = findNode(key);
+        if (node == kNone) return 0;
+        eraseSlot(key);
+        releaseNode(node);
+        return 1;
+    }
+
+    void clear() {
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i]) releaseNode(i);
+        }
+        for (Slot& slot : slots) slot.dist = 0;
+    }
+
+    void reserve(size_t count) {
+        size_t capacity = slots.empty() ? 16 : slots.size();
+        while (count * 5 > capacity * 4) capacity *= 2;
+        if (capacity != slots.size()) rehash(capacity);
+    }
+
+    Handle handleOf(const_iterator it) const {
+        if (it.node == kNone) return {};
+        return {it.node, generations[it.node]};
+    }
+    Value* get(const Handle& handle) {
+        if (handle.node >= nodes.size() || generations[handle.node] != handle.generation) return nullptr;
+        return nodes[handle.node] ? &nodes[handle.node]->second : nullptr;
+    }
+    const Value* get(const Handle& handle) const {
+        return const_cast<StableFlatMap*>(this)->get(handle);
+    }
+
+    ProbeStats probeStats() const {
+        ProbeStats stats;
+        stats.entries = liveCount;
+        stats.capacity = slots.size();
+        uint64_t total = 0;
+        for (const Slot& slot : slots) {
+            if (slot.dist == 0) continue;
+            total += slot.dist;
+            if (slot.dist > stats.maxProbe) stats.maxProbe = slot.dist;
+        }
+        if (liveCount > 0) stats.meanProbe = static_cast<double>(total) / static_cast<double>(liveCount);
+        return stats;
+    }
+
+private:
+    static constexpr uint32_t kNone = 0xffffffffu;
+
+    // dist is 1 + the distance from the key's home slot; 0 marks an empty slot.
+    struct Slot {
+        Key key{};
+        uint32_t node = kNone;
+        uint32_t dist = 0;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<std::unique_ptr<value_type>> nodes;
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeNodes;
+    size_t liveCount = 0;
+
+    size_t homeSlot(const Key& key) const {
+        return static_cast<size_t>(Hash()(key)) & (slots.size() - 1);
+    }
+
+    uint32_t findNode(const Key& key) const {
+        if (liveCount == 0) return kNone;
+        const size_t mask = slots.size() - 1;
+        size_t index = homeSlot(key);
+        for (uint32_t dist = 1;; ++dist) {
+            const Slot& slot = slots[index];
+            // Robin-hood order: a key is never stored past a slot that is
+            // closer to its own home than the key would be.
+            if (slot.dist < dist) return kNone;
+            if (slot.key == key) return slot.node;
+            index = (index + 1) & mask;
+        }
+    }
+
+    uint32_t nextLive(uint32_t node) const {
+        while (node < nodes.size()) {
+            if (nodes[node]) return node;
+            node += 1;
+        }
+        return kNone;
+    }
+
+    template <class V>
+    uint32_t allocateNode(const Key& key, V&& value) {
+        uint32_t node;
+        if (!freeNodes.empty()) {
+            node = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            node = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+            generations.push_back(0);
+        }
+        nodes[node] = std::make_unique<value_type>(key, std::forward<V>(value));
+        return node;
+    }
+
+    void releaseNode(uint32_t node) {
+        nodes[node].reset();
+        generations[node] += 1;
+        freeNodes.push_back(node);
+        liveCount -= 1;
+    }
+
+    void insertSlot(Key key, uint32_t node) {
+        const size_t mask = slots.size() - 1;
+        size_t index = homeSlot(key);
+        uint32_t dist = 1;
+        while (true) {
+            Slot& slot = slots[index];
+            if (slot.dist == 0) {
+                slot.key = key;
+                slot.node = node;
+                slot.dist = dist;
+                return;
+            }
+            if (slot.dist < dist) {
+                std::swap(slot.key, key);
+                std::swap(slot.node, node);
+                std::swap(slot.dist, dist);
+            }
+            index = (index + 1) & mask;
+            dist += 1;
+        }
+    }
+
+    // Backward-shift deletion keeps probe sequences free of tombstones.
+    void eraseSlot(const Key& key) {
+        const size_t mask = slots.size() - 1;
+        size_t index = homeSlot(key);
+        while (!(slots[index].key == key && slots[index].dist != 0)) index = (index + 1) & mask;
+        size_t next = (index + 1) & mask;
+        while (slots[next].dist > 1) {
+            slots[index] = slots[next];
+            slots[index].dist -= 1;
+            index = next;
+            next = (next + 1) & mask;
+        }
+        slots[index].dist = 0;
+    }
+
+    void grow() {
+        rehash(slots.empty() ? 16 : slots.size() * 2);
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(capacity, Slot{});
+        for (const Slot& slot : old) {
+            if (slot.dist != 0) insertSlot(slot.key, slot.node);
+        }
+    }
+};
@@ -243,21 +243,27 @@ void VoxelWorldContext::setBlockLod(int lod, const glm::ivec3& lodCoord, uint32_
     glm::ivec3 local = lodCoord - sectionCoord * size;
     VoxelSectionKey key{lod, sectionCoord};
 
-    auto it = sections.find(key);
-    if (it == sections.end()) {
-        if (id == 0) return;
-        VoxelSection section;
-        section.lod = lod;
-        section.size = size;
-        section.coord = sectionCoord;
-        VoxelSectionBuffers buffers = acquireBuffers(*this, size);
-        section.ids = std::move(buffers.ids);
-        section.colors = std::move(buffers.colors);
-        auto [insertedIt, _] = sections.emplace(key, std::move(section));
-        it = insertedIt;
+    VoxelSection* target = (key == hotWriteKey) ? sections.get(hotWriteSection) : nullptr;
+    if (!target) {
+        auto it = sections.find(key);
+        if (it == sections.end()) {
+            if (id == 0) return;
+            VoxelSection section;
+            section.lod = lod;
+            section.size = size;
+            section.coord = sectionCoord;
+            VoxelSectionBuffers buffers = acquireBuffers(*this, size);
+            section.ids = std::move(buffers.ids);
+            section.colors = std::move(buffers.colors);
+            auto [insertedIt, _] = sections.emplace(key, std::move(section));
+            it = insertedIt;
+        }
+        target = &it->second;
+        hotWriteKey = key;
+        hotWriteSection = sections.handleOf(it);
     }
 
-    VoxelSection& section = it->second;
+    VoxelSection& section = *target;
     int idx = voxelIndex(local, section.size);
     uint32_t oldId = section.ids[idx];
     uint32_t oldColor = section.colors[idx];
@@ -277,6 +283,118 @@ void VoxelWorldContext::setBlockLod(int lod, const glm::ivec3& lodCoord, uint32_
     }
 }
 
+void VoxelWorldContext::fillRowLod(int lod, const glm::ivec3& lodCoord, int length, uint32_t id, uint32_t color) {
+    if (lod < 0 || length <= 0) return;
+    const int size = sectionSizeForLod(sectionSize, lod);
+    const uint32_t storedColor = (id == 0) ? 0 : color;
+    glm::ivec3 cursor = lodCoord;
+    int remaining = length;
+    while (remaining > 0) {
+        glm::ivec3 sectionCoord = floorDivVec(cursor, size);
+        glm::ivec3 local = cursor - sectionCoord * size;
+        const int span = std::min(remaining, size - local.x);
+        cursor.x += span;
+        remaining -= span;
+
+        VoxelSectionKey key{lod, sectionCoord};
+        auto it = sections.find(key);
+        if (it == sections.end()) {
+            if (id == 0) continue;
+            VoxelSection section;
+            section.lod = lod;
+            section.size = size;
+            section.coord = sectionCoord;
+            VoxelSectionBuffers buffers = acquireBuffers(*this, size);
+            section.ids = std::move(buffers.ids);
+            section.colors = std::move(buffers.colors);
+            auto [insertedIt, _] = sections.emplace(key, std::move(section));
+            it = insertedIt;
+        }
+
+        VoxelSection& section = it->second;
+        const int base = voxelIndex(local, section.size);
+        bool changed = false;
+        for (int i = 0; i < span; ++i) {
+            uint32_t& cellId = section.ids[base + i];
+            uint32_t& cellColor = section.colors[base + i];
+            if (cellId == id && cellColor == storedColor) continue;
+            if (cellId == 0 && id != 0) section.nonAirCount += 1;
+            if (cellId != 0 && id == 0) section.nonAirCount -= 1;
+            cellId = id;
+            cellColor = storedColor;
+            changed = true;
+        }
+        if (!changed) continue;
+        section.editVersion += 1;
+        section.dirty = true;
+        dirtySections.insert(key);
+    }
+}
+
+void VoxelWorldContext::rebuildMipsWorld(const glm::ivec3& minCell, const glm::ivec3& maxCell, int fromLod) {
+    if (fromLod < 1) fromLod = 1;
+    for (int lod = fromLod; lod <= maxLod; ++lod) {
+        const int childSize = sectionSizeForLod(sectionSize, lod - 1);
+        const glm::ivec3 lo = floorDivVec(minCell, 1 << lod);
+        const glm::ivec3 hi = floorDivVec(maxCell, 1 << lod);
+        const int width = hi.x - lo.x + 1;
+        std::vector<MipSample> row(static_cast<size_t>(width));
+
+        // Section pointers stay valid while fillRowLod inserts parents.
+        const VoxelSection* cached = nullptr;
+        VoxelSectionKey cachedKey{-1, glm::ivec3(0)};
+        auto sampleChild = [&](const glm::ivec3& childCoord, uint32_t& id, uint32_t& color) {
+            glm::ivec3 childSectionCoord = floorDivVec(childCoord, childSize);
+            VoxelSectionKey key{lod - 1, childSectionCoord};
+            if (!(key == cachedKey)) {
+                auto it = sections.find(key);
+                cached = (it == sections.end()) ? nullptr : &it->second;
+                cachedKey = key;
+            }
+            if (!cached) {
+                id = 0;
+                color = 0;
+                return;
+            }
+            int idx = voxelIndex(childCoord - childSectionCoord * childSize, cached->size);
+            id = cached->ids[idx];
+            color = cached->colors[idx];
+        };
+
+        for (int z = lo.z; z <= hi.z; ++z) {
+            for (int y = lo.y; y <= hi.y; ++y) {
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    std::array<uint32_t, 8> samples{};
+                    std::array<uint32_t, 8> sampleColors{};
+                    int s = 0;
+                    glm::ivec3 childBase = glm::ivec3(x, y, z) * 2;
+                    for (int dz = 0; dz < 2; ++dz) {
+                        for (int dy = 0; dy < 2; ++dy) {
+                            for (int dx = 0; dx < 2; ++dx) {
+                                sampleChild(childBase + glm::ivec3(dx, dy, dz), samples[s], sampleColors[s]);
+                                s += 1;
+                            }
+                        }
+                    }
+                    row[static_cast<size_t>(x - lo.x)] = pickMipVoxel(samples, sampleColors);
+                }
+                int start = 0;
+                while (start < width) {
+                    const MipSample& value = row[static_cast<size_t>(start)];
+                    int end = start + 1;
+                    while (end < width
+                           && row[static_cast<size_t>(end)].id == value.id
+                           && row[static_cast<size_t>(end)].color == value.color) {
+                        end += 1;
+                    }
+                    fillRowLod(lod, glm::ivec3(lo.x + start, y, z), end - start, value.id, value.color);
+                    start = end;
+                }
+            }
+        }
+    }
+}
+
 void VoxelWorldContext::releaseSection(const VoxelSectionKey& key) {
     auto it = sections.find(key);
     if (it == sections.end()) return;
@@ -6,6 +6,8 @@
 #include <vector>
 #include <glm/glm.hpp>
 
+#include "Structures/StableFlatMap.h"
+
 struct VoxelSectionKey {
     int lod = 0;
     glm::ivec3 coord{0};
@@ -14,13 +16,23 @@ struct VoxelSectionKey {
     }
 };
 
+// Murmur3 finalizer over the packed key. Plain xor/shift combines collide
+// heavily on the axis-aligned coordinate runs streaming produces.
 struct VoxelSectionKeyHash {
+    static uint64_t mix(uint64_t h) noexcept {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
     std::size_t operator()(const VoxelSectionKey& key) const noexcept {
-        std::size_t hl = std::hash<int>()(key.lod);
-        std::size_t hx = std::hash<int>()(key.coord.x);
-        std::size_t hy = std::hash<int>()(key.coord.y);
-        std::size_t hz = std::hash<int>()(key.coord.z);
-        return hl ^ (hx << 1) ^ (hy << 2) ^ (hz << 3);
+        const uint64_t xz = (static_cast<uint64_t>(static_cast<uint32_t>(key.coord.x)) << 32)
+            | static_cast<uint32_t>(key.coord.z);
+        const uint64_t yl = (static_cast<uint64_t>(static_cast<uint32_t>(key.coord.y)) << 8)
+            ^ static_cast<uint32_t>(key.lod);
+        return static_cast<std::size_t>(mix(xz ^ mix(yl)));
     }
 };
 
@@ -40,18 +52,28 @@ struct VoxelSectionBuffers {
     std::vector<uint32_t> colors;
 };
 
+using VoxelSectionMap = StableFlatMap<VoxelSectionKey, VoxelSection, VoxelSectionKeyHash>;
+
 struct VoxelWorldContext {
     int sectionSize = 128;
     int maxLod = 4;
     bool enabled = false;
-    std::unordered_map<VoxelSectionKey, VoxelSection, VoxelSectionKeyHash> sections;
+    VoxelSectionMap sections;
     std::unordered_set<VoxelSectionKey, VoxelSectionKeyHash> dirtySections;
     std::unordered_map<int, std::vector<VoxelSectionBuffers>> bufferPools;
+    // Section the last setBlockLod wrote; runs of single-voxel writes mostly
+    // stay inside one section and skip the lookup.
+    VoxelSectionKey hotWriteKey{-1, glm::ivec3(0)};
+    VoxelSectionMap::Handle hotWriteSection;
 
     void reset();
     uint32_t getBlockWorld(const glm::ivec3& worldPos) const;
     uint32_t getColorWorld(const glm::ivec3& worldPos) const;
     void setBlockWorld(const glm::ivec3& worldPos, uint32_t id, uint32_t color);
     void setBlockLod(int lod, const glm::ivec3& lodCoord, uint32_t id, uint32_t color, bool markDirty = true);
+    // Bulk writes: fill `length` voxels along +x on one LOD without touching
+    // the mips above it, then rebuild LODs fromLod..maxLod over a LOD0 box.
+    void fillRowLod(int lod, const glm::ivec3& lodCoord, int length, uint32_t id, uint32_t color);
+    void rebuildMipsWorld(const glm::ivec3& minCell, const glm::ivec3& maxCell, int fromLod = 1);
     void releaseSection(const VoxelSectionKey& key);
 };
@@ -0,0 +1,347 @@
+// Standalone golden render and block-size benchmark for the audio process
+// block. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack, ChucK and VST3 SDK include dirs> Tools/AudioGoldenRender.cpp <jack and ChucK libs> -o audio_golden_render
+//   ./audio_golden_render [--update]
+//
+// Run from the repo root. Renders a fixed DAW scene through the offline
+// driver (OpenOfflineAudio/RenderOfflineBlocks, so the same processAudioBlock
+// the JACK callback runs) and compares the main stereo pair and the four DAW
+// bus outputs against Tools/golden/daw_scene.wav, a float WAV. The scene
+// covers a stereo clip split across two buses, a mono clip summed onto one
+// bus with a source offset, a muted track, solo and gain changes part way
+// through, a loop that wraps inside a block and the metronome. The scene
+// rendered at every block size from 64 to 2048 frames must match the
+// reference too, the main pair must be the fold-down of the buses and every
+// other output must stay silent; --update rewrites the reference instead.
+// Ends with the per-callback cost at each block size. Exits nonzero if any
+// check fails. ChucK, VST3, streamed clips and the pink noise source are
+// stand-ins that produce nothing; the scene does not use them.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace PinkNoiseSystemLogic {
+    float generate_filtered_pink_noise(AudioContext*) { return 0.0f; }
+}
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem&, const std::string&, int fallback) { return fallback; }
+}
+namespace ChucKSystemLogic {
+    void DispatchSfxTriggers(AudioContext&) {}
+}
+namespace DawRecordSystemLogic {
+    void WriteRecordInputRT(DawTrack&, const float*, const float*, size_t) {}
+}
+namespace DawStreamSystemLogic {
+    size_t ReadStreamFramesRT(DawContext&, const DawClipAudio&, uint64_t, size_t, float*, float*) { return 0; }
+}
+
+#include "BaseSystem/AudioSystem.cpp"
+
+namespace Vst3SystemLogic {
+    void EnsureMidiTrackCount(Vst3Context&, int) {}
+    bool ProcessEffectChainStereo(Vst3Context&, Vst3TrackChain&, const float*, const float*, float*, float*,
+                                  int, int64_t, bool) { return false; }
+    bool ProcessEffectChain(Vst3Context&, Vst3TrackChain&, const float*, float*, int, int64_t, bool) { return false; }
+    bool ProcessInstrument(Vst3Context&, Vst3TrackChain&, Vst3Plugin&, float*, int, int64_t, bool,
+                           const std::array<float, 128>&, std::array<float, 128>&) { return false; }
+}
+
+namespace {
+    constexpr uint32_t kSampleRate = 16000;
+    constexpr uint32_t kReferenceBlock = 256;
+    // A multiple of every block size, so scene changes land on block edges.
+    constexpr uint64_t kSceneFrames = 12288;
+    constexpr float kTolerance = 1.0e-5f;
+    const char* kReferencePath = "Tools/golden/daw_scene.wav";
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    // Deterministic source material; the noise comes from an integer LCG so
+    // it does not depend on the C library.
+    std::vector<float> sineBurst(size_t frames, double hz, double decay) {
+        std::vector<float> out(frames);
+        for (size_t i = 0; i < frames; ++i) {
+            const double t = static_cast<double>(i) / kSampleRate;
+            out[i] = static_cast<float>(0.6 * std::sin(2.0 * M_PI * hz * t) * std::exp(-decay * t));
+        }
+        return out;
+    }
+
+    std::vector<float> lcgNoise(size_t frames, uint32_t seed) {
+        std::vector<float> out(frames);
+        uint32_t state = seed;
+        float smoothed = 0.0f;
+        for (size_t i = 0; i < frames; ++i) {
+            state = state * 1664525u + 1013904223u;
+            const float white = static_cast<float>(static_cast<int32_t>(state >> 8) - (1 << 23)) / static_cast<float>(1 << 23);
+            smoothed += 0.25f * (white - smoothed);
+            out[i] = smoothed;
+        }
+        return out;
+    }
+
+    DawClip makeClip(int audioId, uint64_t start, uint64_t length, uint64_t sourceOffset) {
+        DawClip clip;
+        clip.audioId = audioId;
+        clip.startSample = start;
+        clip.length = length;
+        clip.sourceOffset = sourceOffset;
+        return clip;
+    }
+
+    struct Scene {
+        AudioContext audio;
+        DawContext daw;
+    };
+
+    void buildScene(Scene& scene, uint32_t blockFrames) {
+        DawContext& daw = scene.daw;
+        daw.sampleRate = static_cast<float>(kSampleRate);
+
+        DawClipAudio stereo;
+        stereo.channels = 2;
+        stereo.left = sineBurst(12000, 220.0, 1.5);
+        stereo.right = sineBurst(12000, 330.0, 0.5);
+        daw.clipAudio.push_back(std::move(stereo));
+        DawClipAudio mono;
+        mono.left = lcgNoise(9000, 0x5eed);
+        daw.clipAudio.push_back(std::move(mono));
+
+        // Track 0: stereo clip split across buses 0/1, running past the loop end.
+        // Track 1: mono clip summed onto bus 2, two clips, one with a source offset.
+        // Track 2: muted until the last section, on bus 3.
+        daw.tracks.resize(3);
+        daw.tracks[0].clips.push_back(makeClip(0, 1000, 11000, 0));
+        daw.tracks[0].gain.store(0.8f);
+        daw.tracks[0].outputBusL.store(0);
+        daw.tracks[0].outputBusR.store(1);
+        daw.tracks[1].clips.push_back(makeClip(1, 0, 4000, 500));
+        daw.tracks[1].clips.push_back(makeClip(1, 7000, 6000, 0));
+        daw.tracks[1].gain.store(0.5f);
+        daw.tracks[1].outputBusL.store(2);
+        daw.tracks[1].outputBusR.store(2);
+        daw.tracks[2].clips.push_back(makeClip(0, 2500, 6000, 3000));
+        daw.tracks[2].mute.store(true);
+        daw.tracks[2].outputBusL.store(3);
+        daw.tracks[2].outputBusR.store(3);
+        daw.trackCount = 3;
+
+        // The loop end is off every block edge, so the wrap lands mid-block.
+        daw.loopEnabled.store(true);
+        daw.loopStartSamples = 3000;
+        daw.loopEndSamples = 11001;
+        daw.bpm.store(150.0);
+        daw.metronomeEnabled.store(true);
+        daw.metronomeLoaded = true;
+        daw.metronomeSampleRate = kSampleRate;
+        daw.metronomeSamples = sineBurst(400, 1000.0, 40.0);
+        daw.metronomeSampleStep = 1.0;
+        daw.playheadSample.store(0);
+        daw.transportPlaying.store(true);
+
+        AudioContext& audio = scene.audio;
+        audio.sampleRate = static_cast<float>(kSampleRate);
+        audio.jackOutputChannels = 16;
+        audio.jackInputChannels = 2;
+        audio.dawOutputStart = 12;
+        audio.daw = &daw;
+        AudioSystemLogic::OpenOfflineAudio(audio, kSampleRate, blockFrames);
+    }
+
+    // Scene changes at fixed frames: solo track 1, then clear the solo,
+    // unmute track 2 and pull track 0 down.
+    void applySceneEvent(DawContext& daw, uint64_t frame) {
+        if (frame == 4096) {
+            daw.tracks[1].solo.store(true);
+        } else if (frame == 10240) {
+            daw.tracks[1].solo.store(false);
+            daw.tracks[2].mute.store(false);
+            daw.tracks[0].gain.store(0.25f);
+        }
+    }
+
+    // Renders the scene and returns the captured outputs, all 16 channels.
+    std::vector<std::vector<float>> renderScene(uint32_t blockFrames, double* callbackUs = nullptr) {
+        auto scene = std::make_unique<Scene>();
+        buildScene(*scene, blockFrames);
+        AudioContext& audio = scene->audio;
+        AudioSystemLogic::StartOfflineCapture(audio, "", true);
+        double renderUs = 0.0;
+        for (uint64_t frame = 0; frame < kSceneFrames; frame += blockFrames) {
+            applySceneEvent(scene->daw, frame);
+            const auto start = std::chrono::steady_clock::now();
+            AudioSystemLogic::RenderOfflineBlocks(audio, 1);
+            renderUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+        AudioSystemLogic::StopOfflineCapture(audio);
+        if (callbackUs) *callbackUs = renderUs / static_cast<double>(kSceneFrames / blockFrames);
+        return audio.offlineDriver->captured;
+    }
+
+    // Main L/R, then the DAW buses.
+    std::vector<std::vector<float>> goldenChannels(const std::vector<std::vector<float>>& outputs) {
+        std::vector<std::vector<float>> channels = {outputs[0], outputs[1]};
+        channels.insert(channels.end(), outputs.begin() + 12, outputs.begin() + 12 + DawContext::kBusCount);
+        return channels;
+    }
+
+    bool writeReference(const std::vector<std::vector<float>>& channels) {
+        WavStreamWriter writer;
+        if (!writer.open(kReferencePath, static_cast<uint16_t>(channels.size()), kSampleRate, false)) return false;
+        std::vector<float> interleaved(channels.size() * channels[0].size());
+        for (size_t i = 0; i < channels[0].size(); ++i) {
+            for (size_t ch = 0; ch < channels.size(); ++ch) interleaved[i * channels.size() + ch] = channels[ch][i];
+        }
+        const bool written = writer.writeInterleaved(interleaved.data(), static_cast<uint32_t>(channels[0].size()));
+        writer.close();
+        return written;
+    }
+
+    // Reads the 32-bit float WAV writeReference() produces.
+    bool readReference(std::vector<std::vector<float>>& channels) {
+        std::ifstream in(kReferencePath, std::ios::binary);
+        char riff[12];
+        if (!in.read(riff, 12) || std::string(riff, 4) != "RIFF" || std::string(riff + 8, 4) != "WAVE") return false;
+        uint16_t format = 0;
+        uint16_t count = 0;
+        uint16_t bits = 0;
+        char id[4];
+        uint32_t size = 0;
+        while (in.read(id, 4) && in.read(reinterpret_cast<char*>(&size), 4)) {
+            const std::string chunk(id, 4);
+            if (chunk == "fmt ") {
+                std::vector<char> fmt(size);
+                if (size < 16 || !in.read(fmt.data(), size)) return false;
+                std::memcpy(&format, fmt.data(), 2);
+                std::memcpy(&count, fmt.data() + 2, 2);
+                std::memcpy(&bits, fmt.data() + 14, 2);
+            } else if (chunk == "data") {
+                if (format != 3 || bits != 32 || count == 0) return false;
+                const size_t frames = size / (count * sizeof(float));
+                std::vector<float> interleaved(frames * count);
+                if (!in.read(reinterpret_cast<char*>(interleaved.data()), frames * count * sizeof(float))) return false;
+                channels.assign(count, std::vector<float>(frames));
+                for (size_t i = 0; i < frames; ++i) {
+                    for (size_t ch = 0; ch < count; ++ch) channels[ch][i] = interleaved[i * count + ch];
+                }
+                return true;
+            } else {
+                in.seekg(size + (size & 1), std::ios::cur);
+            }
+        }
+        return false;
+    }
+
+    void compareChannels(const std::vector<std::vector<float>>& got, const std::vector<std::vector<float>>& expected,
+                         const std::string& label) {
+        if (!check(got.size() == expected.size(), label + ": channel count")) return;
+        for (size_t ch = 0; ch < got.size(); ++ch) {
+            if (!check(got[ch].size() == expected[ch].size(), label + ": channel " + std::to_string(ch) + " length")) continue;
+            size_t worst = 0;
+            float worstError = 0.0f;
+            for (size_t i = 0; i < got[ch].size(); ++i) {
+                const float error = std::fabs(got[ch][i] - expected[ch][i]);
+                if (error > worstError) {
+                    worstError = error;
+                    worst = i;
+                }
+            }
+            check(worstError <= kTolerance, label + ": channel " + std::to_string(ch) + " differs by "
+                  + std::to_string(worstError) + " at frame " + std::to_string(worst));
+        }
+    }
+
+    void checkScene(const std::vector<std::vector<float>>& outputs) {
+        std::vector<std::vector<float>> buses(outputs.begin() + 12, outputs.begin() + 12 + DawContext::kBusCount);
+        for (int b = 0; b < DawContext::kBusCount; ++b) {
+            float peak = 0.0f;
+            for (float s : buses[b]) peak = std::max(peak, std::fabs(s));
+            check(peak > 0.01f, "bus " + std::to_string(b) + " carries signal");
+        }
+        // Main L gets the left bus, main R the right bus, both half of the
+        // two centre buses.
+        bool folded = true;
+        for (size_t i = 0; i < kSceneFrames; ++i) {
+            const float center = 0.5f * (buses[1][i] + buses[2][i]);
+            folded = folded && std::fabs(outputs[0][i] - (buses[0][i] + center)) <= kTolerance
+                && std::fabs(outputs[1][i] - (buses[3][i] + center)) <= kTolerance;
+        }
+        check(folded, "main pair is the bus fold-down");
+        for (int ch = 2; ch < 12; ++ch) {
+            check(std::all_of(outputs[ch].begin(), outputs[ch].end(), [](float s) { return s == 0.0f; }),
+                  "output " + std::to_string(ch) + " is silent");
+        }
+        // Track 1 is soloed for frames [4096, 10240): only bus 2 and the
+        // metronome's buses 0 and 3 can sound, and no beat falls there until 6400.
+        bool quiet = true;
+        for (size_t i = 4096; i < 6400; ++i) {
+            quiet = quiet && buses[0][i] == 0.0f && buses[1][i] == 0.0f && buses[3][i] == 0.0f;
+        }
+        check(quiet, "solo silences the other tracks");
+        // Track 2 is muted before frame 10240 and only it feeds bus 3 besides
+        // the click, which lasts 400 frames from each beat.
+        bool muted = true;
+        for (size_t i = 400; i < 4096; ++i) muted = muted && buses[3][i] == 0.0f;
+        check(muted, "mute silences the muted track");
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool update = argc == 2 && std::string(argv[1]) == "--update";
+    if (argc > 2 || (argc == 2 && !update)) {
+        std::cerr << "usage: " << argv[0] << " [--update]\n";
+        return 2;
+    }
+
+    const std::vector<std::vector<float>> outputs = renderScene(kReferenceBlock);
+    if (!check(outputs.size() == 16 && outputs[0].size() == kSceneFrames, "capture covers every output")) return 1;
+    checkScene(outputs);
+    const std::vector<std::vector<float>> golden = goldenChannels(outputs);
+
+    if (update) {
+        std::filesystem::create_directories(std::filesystem::path(kReferencePath).parent_path());
+        if (!writeReference(golden)) {
+            std::cerr << "cannot write " << kReferencePath << "\n";
+            return 1;
+        }
+        std::cout << "wrote " << kReferencePath << "\n";
+    } else {
+        std::vector<std::vector<float>> reference;
+        if (check(readReference(reference), std::string("cannot read ") + kReferencePath + "; run from the repo root")) {
+            compareChannels(golden, reference, "block 256");
+        }
+    }
+
+    for (uint32_t block = 64; block <= 2048; block *= 2) {
+        double callbackUs = 0.0;
+        double bestUs = 0.0;
+        std::vector<std::vector<float>> rendered;
+        for (int run = 0; run < 5; ++run) {
+            rendered = renderScene(block, &callbackUs);
+            bestUs = run == 0 ? callbackUs : std::min(bestUs, callbackUs);
+        }
+        compareChannels(goldenChannels(rendered), golden, "block " + std::to_string(block));
+        std::printf("block %4u: %8.2f us per callback, %6.1f ns per frame\n",
+                    block, bestUs, bestUs * 1000.0 / block);
+    }
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
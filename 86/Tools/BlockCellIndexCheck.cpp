@@ -0,0 +1,451 @@
+// Standalone checks and benchmark for the block cell index behind
+// FindBlockInstance/HasBlockAt. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. -I<glm> -I<dir holding json.hpp> -I<jack and VST3 SDK include dirs> Tools/BlockCellIndexCheck.cpp -o block_cell_index_check
+//   ./block_cell_index_check [--bench-only]
+//
+// Drives two worlds through random sequences of the edits the game makes:
+// hooked placements (push_back + AddBlockToCache), swap-and-pop removals,
+// erase-style removals, remove_if sweeps that call RemoveBlockFromCache from
+// the predicate, unhooked pushes and removals of non-block instances,
+// unhooked block pushes, buffer reallocations and in-place moves followed by
+// InvalidateWorldCache. After every step FindBlockInstance and HasBlockAt are
+// compared with a scan of the instance list for the touched cells and a few
+// random ones, and the damping brickmap with the first world holding each
+// cell; every so often every cell in the arena is compared. Ends with the time
+// to place 10k blocks one at a time, each behind a HasBlockAt check, through
+// the index and through a linear scan. Exits nonzero if any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/DampingBrickmap.h"
+#include "BaseSystem/Vst3Host.h"
+
+namespace {
+    glm::ivec3 g_lastPropagationCell{0};
+    int g_propagationCellCalls = 0;
+}
+
+uint32_t VoxelWorldContext::getBlockWorld(const glm::ivec3&) const { return 0; }
+
+namespace CollisionSystemLogic {
+    void InvalidateColliders(int) {}
+    void NotifyBlockAdded(BaseSystem&, const std::vector<Entity>&, int, const glm::vec3&, int) {}
+    void NotifyBlockRemoved(BaseSystem&, int, const glm::vec3&) {}
+}
+namespace RayTracedAudioSystemLogic {
+    void InvalidatePropagation(BaseSystem&) {}
+    void InvalidatePropagationCell(BaseSystem&, const glm::ivec3& cell) {
+        g_lastPropagationCell = cell;
+        g_propagationCellCalls += 1;
+    }
+}
+
+#include "BaseSystem/BlockSelectionSystem.cpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kWorlds = 2;
+    constexpr int kArena = 7;  // cells span [-kArena, kArena] on each axis
+    constexpr int kSteps = 40000;
+    constexpr int kFullCheckEvery = 2000;
+
+    enum Proto { WorldProto = 0, Stone = 1, Wood = 2, Label = 3, ProtoCount };
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    std::string cellText(const glm::ivec3& cell) {
+        return "(" + std::to_string(cell.x) + "," + std::to_string(cell.y) + "," + std::to_string(cell.z) + ")";
+    }
+
+    std::vector<Entity> makePrototypes() {
+        std::vector<Entity> prototypes(ProtoCount);
+        for (int i = 0; i < ProtoCount; ++i) prototypes[i].prototypeID = i;
+        prototypes[WorldProto].name = "World";
+        prototypes[WorldProto].isWorld = true;
+        prototypes[Stone].name = "Stone";
+        prototypes[Stone].isBlock = true;
+        prototypes[Stone].dampingFactor = 0.6f;
+        prototypes[Wood].name = "Wood";
+        prototypes[Wood].isBlock = true;
+        prototypes[Wood].dampingFactor = 0.25f;
+        prototypes[Label].name = "Label";
+        prototypes[Label].isUI = true;
+        return prototypes;
+    }
+
+    void resetCaches() {
+        BlockSelectionSystemLogic::g_worldCaches.clear();
+        BlockSelectionSystemLogic::g_cachePrototypes = nullptr;
+        BlockSelectionSystemLogic::g_dampingBrickmap.clear();
+        BlockSelectionSystemLogic::g_dampingBrickmapDirty = true;
+    }
+
+    void makeLevel(BaseSystem& baseSystem, const std::vector<Entity>& prototypes) {
+        baseSystem.level = std::make_unique<LevelContext>();
+        for (int w = 0; w < kWorlds; ++w) {
+            Entity world = prototypes[WorldProto];
+            world.name = "World" + std::to_string(w);
+            baseSystem.level->worlds.push_back(world);
+        }
+        resetCaches();
+    }
+
+    EntityInstance makeInstance(int prototypeID, const glm::vec3& position) {
+        EntityInstance inst{};
+        inst.prototypeID = prototypeID;
+        inst.position = position;
+        return inst;
+    }
+
+    bool isBlock(const std::vector<Entity>& prototypes, const EntityInstance& inst) {
+        return inst.prototypeID >= 0 && inst.prototypeID < static_cast<int>(prototypes.size())
+            && prototypes[inst.prototypeID].isBlock;
+    }
+
+    // Slot of the first block instance in `cell`, or -1.
+    int scanSlot(const std::vector<Entity>& prototypes, const Entity& world, const glm::ivec3& cell) {
+        for (size_t i = 0; i < world.instances.size(); ++i) {
+            const EntityInstance& inst = world.instances[i];
+            if (isBlock(prototypes, inst) && BlockCellIndex::cellOf(inst.position) == cell) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // What SampleBlockDamping must answer: the first world holding the cell.
+    bool scanDamping(const std::vector<Entity>& prototypes, const LevelContext& level, const glm::ivec3& cell, float& damping) {
+        for (const Entity& world : level.worlds) {
+            const int slot = scanSlot(prototypes, world, cell);
+            if (slot < 0) continue;
+            damping = prototypes[world.instances[static_cast<size_t>(slot)].prototypeID].dampingFactor;
+            return true;
+        }
+        return false;
+    }
+
+    struct Arena {
+        BaseSystem baseSystem;
+        std::vector<Entity> prototypes = makePrototypes();
+        std::mt19937 rng{0xb10c};
+
+        Arena() { makeLevel(baseSystem, prototypes); }
+
+        Entity& world(int w) { return baseSystem.level->worlds[static_cast<size_t>(w)]; }
+        int pick(int n) { return std::uniform_int_distribution<int>(0, n - 1)(rng); }
+        glm::ivec3 randomCell() {
+            std::uniform_int_distribution<int> axis(-kArena, kArena);
+            return glm::ivec3(axis(rng), axis(rng), axis(rng));
+        }
+        // Block positions wander off the cell centre the way dropped and
+        // nudged blocks do, so the rounding in cellOf is exercised.
+        glm::vec3 positionIn(const glm::ivec3& cell) {
+            std::uniform_real_distribution<float> jitter(-0.45f, 0.45f);
+            return glm::vec3(cell) + glm::vec3(jitter(rng), jitter(rng), jitter(rng));
+        }
+        int randomBlockSlot(int w) {
+            std::vector<int> slots;
+            for (size_t i = 0; i < world(w).instances.size(); ++i) {
+                if (isBlock(prototypes, world(w).instances[i])) slots.push_back(static_cast<int>(i));
+            }
+            return slots.empty() ? -1 : slots[static_cast<size_t>(pick(static_cast<int>(slots.size())))];
+        }
+        int randomLabelSlot(int w) {
+            std::vector<int> slots;
+            for (size_t i = 0; i < world(w).instances.size(); ++i) {
+                if (world(w).instances[i].prototypeID == Label) slots.push_back(static_cast<int>(i));
+            }
+            return slots.empty() ? -1 : slots[static_cast<size_t>(pick(static_cast<int>(slots.size())))];
+        }
+    };
+
+    void checkCell(Arena& arena, int w, const glm::ivec3& cell, const std::string& where) {
+        using namespace BlockSelectionSystemLogic;
+        const Entity& world = arena.world(w);
+        const int expected = scanSlot(arena.prototypes, world, cell);
+        const EntityInstance* found = FindBlockInstance(arena.baseSystem, arena.prototypes, w, glm::vec3(cell));
+        const EntityInstance* wanted = expected >= 0 ? &world.instances[static_cast<size_t>(expected)] : nullptr;
+        check(found == wanted, where + ": FindBlockInstance world " + std::to_string(w) + " cell " + cellText(cell)
+              + " gave slot " + std::to_string(found ? static_cast<int>(found - world.instances.data()) : -1)
+              + ", scan " + std::to_string(expected));
+        const bool has = HasBlockAt(arena.baseSystem, arena.prototypes, w, glm::vec3(cell) + glm::vec3(0.3f, -0.2f, 0.1f));
+        check(has == (expected >= 0), where + ": HasBlockAt world " + std::to_string(w) + " cell " + cellText(cell));
+    }
+
+    void checkDamping(Arena& arena, const DampingBrickmap* bricks, const glm::ivec3& cell, const std::string& where) {
+        float expected = 0.0f;
+        const bool occupied = scanDamping(arena.prototypes, *arena.baseSystem.level, cell, expected);
+        float sampled = 0.0f;
+        const bool sampledOccupied = BlockSelectionSystemLogic::SampleBlockDamping(arena.baseSystem, cell, sampled);
+        check(sampledOccupied == occupied && (!occupied || sampled == expected),
+              where + ": SampleBlockDamping cell " + cellText(cell));
+        const uint8_t wanted = occupied ? DampingBrickmap::encodeDamping(expected) : uint8_t(0);
+        check(bricks && bricks->cellValue(cell) == wanted, where + ": brickmap cell " + cellText(cell)
+              + " holds " + std::to_string(bricks ? bricks->cellValue(cell) : -1) + ", expected " + std::to_string(wanted));
+    }
+
+    void checkEverything(Arena& arena, const std::string& where) {
+        using namespace BlockSelectionSystemLogic;
+        const DampingBrickmap* bricks = GetDampingBrickmap(arena.baseSystem);
+        for (int w = 0; w < kWorlds; ++w) {
+            const Entity& world = arena.world(w);
+            size_t blocks = 0;
+            for (size_t i = 0; i < world.instances.size(); ++i) {
+                if (!isBlock(arena.prototypes, world.instances[i])) continue;
+                blocks += 1;
+                const EntityInstance* found = FindBlockInstance(arena.baseSystem, arena.prototypes, w, world.instances[i].position);
+                check(found == &world.instances[i], where + ": block in slot " + std::to_string(i) + " of world "
+                      + std::to_string(w) + " not found at its own position");
+            }
+            // A lookup may have rebuilt the cache, so read it afterwards.
+            const WorldBlockCache& cache = g_worldCaches[static_cast<size_t>(w)];
+            check(!cache.initialized || cache.cells.slots.size() <= blocks,
+                  where + ": world " + std::to_string(w) + " index names more cells than there are blocks");
+        }
+        for (int x = -kArena; x <= kArena; ++x) {
+            for (int y = -kArena; y <= kArena; ++y) {
+                for (int z = -kArena; z <= kArena; ++z) {
+                    const glm::ivec3 cell(x, y, z);
+                    for (int w = 0; w < kWorlds; ++w) {
+                        const int expected = scanSlot(arena.prototypes, arena.world(w), cell);
+                        const EntityInstance* found = FindBlockInstance(arena.baseSystem, arena.prototypes, w, glm::vec3(cell));
+                        if (!check((found != nullptr) == (expected >= 0),
+                                   where + ": world " + std::to_string(w) + " cell " + cellText(cell) + " occupancy")) return;
+                    }
+                    checkDamping(arena, bricks, cell, where);
+                    if (g_failures > 20) return;
+                }
+            }
+        }
+    }
+
+    // One random edit; the cells it touched are returned for checking.
+    std::vector<glm::ivec3> randomEdit(Arena& arena, int& w, std::string& what) {
+        using namespace BlockSelectionSystemLogic;
+        std::vector<glm::ivec3> touched;
+        w = arena.pick(kWorlds);
+        Entity& world = arena.world(w);
+        auto& instances = world.instances;
+        const int roll = arena.pick(100);
+        const int callsBefore = g_propagationCellCalls;
+
+        if (roll < 45) {
+            what = "hooked placement";
+            const glm::ivec3 cell = arena.randomCell();
+            touched.push_back(cell);
+            if (HasBlockAt(arena.baseSystem, arena.prototypes, w, glm::vec3(cell))) return touched;
+            const glm::vec3 position = arena.positionIn(cell);
+            const int proto = arena.pick(2) == 0 ? Stone : Wood;
+            instances.push_back(makeInstance(proto, position));
+            world.instanceEdits += 1;
+            AddBlockToCache(arena.baseSystem, arena.prototypes, w, position, proto);
+            check(g_propagationCellCalls == callsBefore + 1 && g_lastPropagationCell == cell,
+                  "placement did not invalidate propagation for " + cellText(cell));
+        } else if (roll < 60) {
+            what = "swap-and-pop removal";
+            const int slot = arena.randomBlockSlot(w);
+            if (slot < 0) return touched;
+            const glm::vec3 position = instances[static_cast<size_t>(slot)].position;
+            touched.push_back(BlockCellIndex::cellOf(position));
+            touched.push_back(BlockCellIndex::cellOf(instances.back().position));
+            instances[static_cast<size_t>(slot)] = instances.back();
+            instances.pop_back();
+            world.instanceEdits += 1;
+            RemoveBlockFromCache(arena.baseSystem, arena.prototypes, w, position);
+            check(g_propagationCellCalls == callsBefore + 1 && g_lastPropagationCell == touched.front(),
+                  "removal did not invalidate propagation for " + cellText(touched.front()));
+        } else if (roll < 65) {
+            what = "erase removal";
+            const int slot = arena.randomBlockSlot(w);
+            if (slot < 0) return touched;
+            const glm::vec3 position = instances[static_cast<size_t>(slot)].position;
+            touched.push_back(BlockCellIndex::cellOf(position));
+            instances.erase(instances.begin() + slot);
+            world.instanceEdits += 1;
+            RemoveBlockFromCache(arena.baseSystem, arena.prototypes, w, position);
+        } else if (roll < 66) {
+            // StructurePlacementSystem clears a bench this way: the cache is
+            // told from inside the predicate, before the list shrinks.
+            what = "remove_if sweep";
+            const glm::ivec3 corner = arena.randomCell();
+            auto inBox = [&](const glm::ivec3& cell) {
+                return cell.x >= corner.x && cell.x < corner.x + 4
+                    && cell.y >= corner.y && cell.y < corner.y + 4
+                    && cell.z >= corner.z && cell.z < corner.z + 4;
+            };
+            const size_t before = instances.size();
+            instances.erase(std::remove_if(instances.begin(), instances.end(),
+                [&](const EntityInstance& inst) {
+                    if (!isBlock(arena.prototypes, inst)) return false;
+                    const glm::ivec3 cell = BlockCellIndex::cellOf(inst.position);
+                    if (!inBox(cell)) return false;
+                    touched.push_back(cell);
+                    RemoveBlockFromCache(arena.baseSystem, arena.prototypes, w, inst.position);
+                    return true;
+                }), instances.end());
+            if (instances.size() != before) world.instanceEdits += 1;
+        } else if (roll < 80) {
+            what = "unhooked label push";
+            instances.push_back(makeInstance(Label, glm::vec3(arena.randomCell())));
+            world.instanceEdits += 1;
+            touched.push_back(BlockCellIndex::cellOf(instances.back().position));
+        } else if (roll < 86) {
+            what = "unhooked label erase";
+            const int slot = arena.randomLabelSlot(w);
+            if (slot < 0) return touched;
+            instances.erase(instances.begin() + slot);
+            world.instanceEdits += 1;
+        } else if (roll < 92) {
+            // Level loads and structure stamps append blocks without telling
+            // the cache; only the count gives them away.
+            what = "unhooked block push";
+            const glm::ivec3 cell = arena.randomCell();
+            touched.push_back(cell);
+            if (scanSlot(arena.prototypes, world, cell) >= 0) return touched;
+            instances.push_back(makeInstance(Stone, arena.positionIn(cell)));
+            world.instanceEdits += 1;
+        } else if (roll < 96) {
+            what = "reallocation";
+            std::vector<EntityInstance> moved(instances.begin(), instances.end());
+            instances.swap(moved);
+        } else {
+            what = "in-place move";
+            const int slot = arena.randomBlockSlot(w);
+            const glm::ivec3 cell = arena.randomCell();
+            if (slot < 0 || scanSlot(arena.prototypes, world, cell) >= 0) return touched;
+            touched.push_back(BlockCellIndex::cellOf(instances[static_cast<size_t>(slot)].position));
+            touched.push_back(cell);
+            instances[static_cast<size_t>(slot)].position = arena.positionIn(cell);
+            world.instanceEdits += 1;
+            InvalidateWorldCache(w);
+        }
+        return touched;
+    }
+
+    void runConsistency() {
+        using namespace BlockSelectionSystemLogic;
+        Arena arena;
+        EnsureAllCaches(arena.baseSystem, arena.prototypes);
+        checkEverything(arena, "empty level");
+        std::map<std::string, int> counts;
+        for (int step = 0; step < kSteps && g_failures <= 20; ++step) {
+            int w = 0;
+            std::string what;
+            const std::vector<glm::ivec3> touched = randomEdit(arena, w, what);
+            counts[what] += 1;
+            const std::string where = "step " + std::to_string(step) + " (" + what + ")";
+            // The audio workers read the brickmap only after the main thread
+            // has settled it for the frame, so do the same here.
+            const DampingBrickmap* bricks = GetDampingBrickmap(arena.baseSystem);
+            for (const glm::ivec3& cell : touched) {
+                for (int other = 0; other < kWorlds; ++other) checkCell(arena, other, cell, where);
+                checkDamping(arena, bricks, cell, where);
+            }
+            for (int probe = 0; probe < 4; ++probe) {
+                int slot = arena.randomBlockSlot(w);
+                const glm::ivec3 cell = (slot >= 0 && probe % 2 == 0)
+                    ? BlockCellIndex::cellOf(arena.world(w).instances[static_cast<size_t>(slot)].position)
+                    : arena.randomCell();
+                checkCell(arena, w, cell, where);
+            }
+            if ((step + 1) % kFullCheckEvery == 0) checkEverything(arena, where);
+        }
+        size_t blocks = 0;
+        size_t total = 0;
+        for (int w = 0; w < kWorlds; ++w) {
+            total += arena.world(w).instances.size();
+            for (const EntityInstance& inst : arena.world(w).instances) blocks += isBlock(arena.prototypes, inst) ? 1 : 0;
+        }
+        std::printf("consistency: %d steps, %zu blocks among %zu instances at the end\n", kSteps, blocks, total);
+        for (const auto& [what, count] : counts) std::printf("  %-22s %6d\n", what.c_str(), count);
+        check(blocks > 500, "the random walk never built up a populated arena");
+    }
+
+    // The lookup HasBlockAt made before the index: walk the instance list.
+    bool linearHasBlockAt(const std::vector<Entity>& prototypes, const Entity& world, const glm::vec3& position) {
+        return scanSlot(prototypes, world, BlockCellIndex::cellOf(position)) >= 0;
+    }
+
+    struct PlacementTiming {
+        double indexMs = 0.0;
+        double linearMs = 0.0;
+    };
+
+    // Places `count` blocks in a shuffled grid, one at a time, each behind an
+    // existence check, into a world already holding `existing` blocks.
+    PlacementTiming timePlacements(int count, int existing) {
+        using namespace BlockSelectionSystemLogic;
+        PlacementTiming timing;
+        std::vector<glm::ivec3> cells;
+        const int side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(count + existing))));
+        for (int x = 0; x < side; ++x) {
+            for (int y = 0; y < side; ++y) {
+                for (int z = 0; z < side; ++z) cells.push_back(glm::ivec3(x, y, z));
+            }
+        }
+        std::shuffle(cells.begin(), cells.end(), std::mt19937(7));
+        cells.resize(static_cast<size_t>(count + existing));
+
+        for (int pass = 0; pass < 2; ++pass) {
+            const bool indexed = pass == 0;
+            Arena arena;
+            Entity& world = arena.world(0);
+            for (int i = 0; i < existing; ++i) world.instances.push_back(makeInstance(Stone, glm::vec3(cells[static_cast<size_t>(i)])));
+            EnsureAllCaches(arena.baseSystem, arena.prototypes);
+            GetDampingBrickmap(arena.baseSystem);
+            int placed = 0;
+            const auto start = Clock::now();
+            for (int i = existing; i < existing + count; ++i) {
+                const glm::vec3 position(cells[static_cast<size_t>(i)]);
+                const bool occupied = indexed
+                    ? HasBlockAt(arena.baseSystem, arena.prototypes, 0, position)
+                    : linearHasBlockAt(arena.prototypes, world, position);
+                if (occupied) continue;
+                world.instances.push_back(makeInstance(Stone, position));
+                world.instanceEdits += 1;
+                if (indexed) AddBlockToCache(arena.baseSystem, arena.prototypes, 0, position, Stone);
+                placed += 1;
+            }
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            check(placed == count, "placement benchmark refused a free cell");
+            (indexed ? timing.indexMs : timing.linearMs) = ms;
+        }
+        return timing;
+    }
+
+    void runBenchmark() {
+        std::printf("\n10k placements, each behind a HasBlockAt check:\n");
+        std::printf("  %-22s %12s %12s %9s\n", "world before", "index ms", "linear ms", "speedup");
+        for (int existing : {0, 10000, 50000}) {
+            const PlacementTiming timing = timePlacements(10000, existing);
+            std::printf("  %-22s %12.2f %12.2f %8.1fx\n", (std::to_string(existing) + " blocks").c_str(),
+                        timing.indexMs, timing.linearMs, timing.linearMs / std::max(timing.indexMs, 1e-6));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    if (!benchOnly) runConsistency();
+    runBenchmark();
+    if (g_failures > 0) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,396 @@
+// Standalone checks and time-to-first-section report for the tiled cave
+// field. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack and VST3 SDK include dirs> Tools/CaveFieldTilesCheck.cpp -o cave_field_tiles_check
+//   ./cave_field_tiles_check [--bench-only]
+//
+// Run from the repo root so Entities/ loads. Fills the monolithic lattice the
+// way the terrain generator did before tiling, then configures the game's
+// tiled field (ensureCaveField) with several tile sizes, resident budgets and
+// disk cache states (cold, warm, truncated and corrupted files) and requires
+// sampleCaveField to return exactly the monolithic value at every lattice
+// point, swept section by section with a trim between sections, and at random
+// off-lattice and out-of-range points. Ends with the time the first LOD0
+// section below the island takes through GenerateExpanseSectionVoxel: with
+// the old up-front fill, with cold tiles, with tiles from the disk cache and
+// with tiles prefetched ahead. The terrain sampler is a stand-in; the cave
+// field, section generator and voxel world are the game's. Exits nonzero if
+// any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/DampingBrickmap.h"
+#include "BaseSystem/Vst3Host.h"
+#include "Structures/VoxelWorld.cpp"
+
+namespace ExpanseBiomeSystemLogic {
+    bool SampleTerrain(const WorldContext&, float x, float z, float& outHeight) {
+        outHeight = 40.0f + 6.0f * std::sin(x * 0.07f) + 5.0f * std::cos(z * 0.05f) + 2.0f * std::sin((x + z) * 0.13f);
+        return true;
+    }
+}
+namespace HostLogic {
+    const Entity* findPrototype(const std::string& name, const std::vector<Entity>& prototypes) {
+        for (const Entity& proto : prototypes) {
+            if (proto.name == name) return &proto;
+        }
+        return nullptr;
+    }
+    EntityInstance CreateInstance(BaseSystem&, int prototypeID, glm::vec3 position, glm::vec3 color) {
+        EntityInstance inst{};
+        inst.prototypeID = prototypeID;
+        inst.position = position;
+        inst.color = color;
+        return inst;
+    }
+}
+
+#include "BaseSystem/TerrainGenerationSystem.cpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    namespace fs = std::filesystem;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // The lattice ensureCaveField lays out; kept in step with it by hand.
+    constexpr int kStep = 4;
+    constexpr int kSizeXZ = 2304;
+    constexpr int kMinY = -96;
+    constexpr int kHeightY = 256;
+    constexpr int kDimXZ = kSizeXZ / kStep + 1;
+    constexpr int kDimY = kHeightY / kStep + 1;
+    const glm::vec3 kOrigin(-kSizeXZ / 2, kMinY, -kSizeXZ / 2);
+
+    // The whole field filled up front, as the generator did before tiling.
+    struct MonolithicField {
+        std::vector<uint8_t> a;
+        std::vector<uint8_t> b;
+
+        static size_t index(int x, int y, int z) {
+            return (static_cast<size_t>(x) * kDimY + static_cast<size_t>(y)) * kDimXZ + static_cast<size_t>(z);
+        }
+
+        void fill(const ExpanseConfig& cfg) {
+            const size_t count = static_cast<size_t>(kDimXZ) * kDimY * kDimXZ;
+            a.assign(count, 0);
+            b.assign(count, 0);
+            TerrainSystemLogic::PerlinNoise3D caveNoiseA(cfg.elevationSeed + 1337);
+            TerrainSystemLogic::PerlinNoise3D caveNoiseB(cfg.ridgeSeed + 7331);
+            for (int x = 0; x < kDimXZ; ++x) {
+                float wx = kOrigin.x + static_cast<float>(x * kStep);
+                for (int z = 0; z < kDimXZ; ++z) {
+                    float wz = kOrigin.z + static_cast<float>(z * kStep);
+                    for (int y = 0; y < kDimY; ++y) {
+                        float wy = kOrigin.y + static_cast<float>(y * kStep);
+                        float v1 = (caveNoiseA.noise(wx / 64.0f, wy / 48.0f, wz / 64.0f) + 1.0f) * 0.5f;
+                        float v2 = (caveNoiseB.noise(wx / 128.0f, wy / 128.0f, wz / 128.0f) + 1.0f) * 0.5f;
+                        a[index(x, y, z)] = static_cast<uint8_t>(std::clamp(v1, 0.0f, 1.0f) * 255.0f);
+                        b[index(x, y, z)] = static_cast<uint8_t>(std::clamp(v2, 0.0f, 1.0f) * 255.0f);
+                    }
+                }
+            }
+        }
+
+        bool sample(float worldX, float worldY, float worldZ, float& outA, float& outB) const {
+            int ix = static_cast<int>(std::round((worldX - kOrigin.x) / static_cast<float>(kStep)));
+            int iy = static_cast<int>(std::round((worldY - kOrigin.y) / static_cast<float>(kStep)));
+            int iz = static_cast<int>(std::round((worldZ - kOrigin.z) / static_cast<float>(kStep)));
+            if (ix < 0 || iy < 0 || iz < 0 || ix >= kDimXZ || iy >= kDimY || iz >= kDimXZ) return false;
+            outA = static_cast<float>(a[index(ix, iy, iz)]) / 255.0f;
+            outB = static_cast<float>(b[index(ix, iy, iz)]) / 255.0f;
+            return true;
+        }
+    };
+
+    std::vector<Entity> loadPrototypes() {
+        std::vector<fs::path> files;
+        if (!fs::exists("Entities")) return {};
+        for (const auto& entry : fs::recursive_directory_iterator("Entities")) {
+            if (entry.path().extension() == ".json") files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+        std::vector<Entity> prototypes;
+        auto add = [&](const json& item) {
+            if (!item.is_object() || !item.contains("name")) return;
+            try {
+                Entity entity = item.get<Entity>();
+                entity.prototypeID = static_cast<int>(prototypes.size());
+                prototypes.push_back(entity);
+            } catch (...) {}
+        };
+        for (const auto& path : files) {
+            std::ifstream in(path);
+            json data;
+            try {
+                data = json::parse(in);
+            } catch (...) {
+                continue;
+            }
+            if (data.is_array()) {
+                for (const auto& item : data) add(item);
+            } else {
+                add(data);
+            }
+        }
+        return prototypes;
+    }
+
+    struct FieldSetup {
+        int tileSize = 32;
+        int capacity = 64;
+        std::string cacheDir;
+    };
+
+    // Drops whatever field the previous setup left and configures a new one.
+    void configureField(BaseSystem& baseSystem, const ExpanseConfig& cfg, const FieldSetup& setup) {
+        using namespace TerrainSystemLogic;
+        g_caveField.ready = false;
+        g_caveField.tiles.reset();
+        (*baseSystem.registry)["CaveFieldTileSize"] = std::to_string(setup.tileSize);
+        (*baseSystem.registry)["CaveFieldTileCacheTiles"] = std::to_string(setup.capacity);
+        (*baseSystem.registry)["CaveFieldCacheDir"] = setup.cacheDir;
+        ensureCaveField(baseSystem, cfg);
+    }
+
+    // Every lattice point, in the 64-block section footprints the streamer
+    // walks, with the per-frame trim between sections.
+    void compareLattice(const MonolithicField& reference, const FieldSetup& setup, const std::string& label) {
+        using namespace TerrainSystemLogic;
+        constexpr int kSectionColumns = 64 / kStep;
+        size_t mismatches = 0;
+        for (int sz = 0; sz < kDimXZ; sz += kSectionColumns) {
+            for (int sx = 0; sx < kDimXZ; sx += kSectionColumns) {
+                for (int x = sx; x < std::min(sx + kSectionColumns, kDimXZ); ++x) {
+                    const float wx = kOrigin.x + static_cast<float>(x * kStep);
+                    for (int z = sz; z < std::min(sz + kSectionColumns, kDimXZ); ++z) {
+                        const float wz = kOrigin.z + static_cast<float>(z * kStep);
+                        for (int y = 0; y < kDimY; ++y) {
+                            const float wy = kOrigin.y + static_cast<float>(y * kStep);
+                            float a = -1.0f;
+                            float b = -1.0f;
+                            const bool ok = sampleCaveField(wx, wy, wz, a, b);
+                            const size_t i = MonolithicField::index(x, y, z);
+                            if (ok && a == static_cast<float>(reference.a[i]) / 255.0f
+                                && b == static_cast<float>(reference.b[i]) / 255.0f) {
+                                continue;
+                            }
+                            if (mismatches++ < 5) {
+                                check(false, label + ": lattice point (" + std::to_string(x) + "," + std::to_string(y)
+                                      + "," + std::to_string(z) + ") differs from the monolithic field");
+                            }
+                        }
+                    }
+                }
+                g_caveField.tiles.trim();
+            }
+        }
+        check(mismatches == 0, label + ": " + std::to_string(mismatches) + " lattice points differ");
+        check(g_caveField.tiles.residentCount() <= static_cast<size_t>(setup.capacity), label + ": trim left "
+              + std::to_string(g_caveField.tiles.residentCount()) + " tiles resident");
+    }
+
+    // Off-lattice points round like the old sampler, and points outside the
+    // box report no field. Scattered probes touch every tile, so they run as
+    // one frame and trim once at the end rather than thrash the budget.
+    void compareRandomPoints(const MonolithicField& reference, const std::string& label) {
+        using namespace TerrainSystemLogic;
+        std::mt19937 rng(0xca7e);
+        std::uniform_real_distribution<float> xz(kOrigin.x - 12.0f, kOrigin.x + kSizeXZ + 12.0f);
+        std::uniform_real_distribution<float> y(kOrigin.y - 12.0f, kOrigin.y + kHeightY + 12.0f);
+        size_t mismatches = 0;
+        for (int i = 0; i < 200000; ++i) {
+            const float wx = xz(rng);
+            const float wy = y(rng);
+            const float wz = xz(rng);
+            float expectedA = 0.0f, expectedB = 0.0f, a = 0.0f, b = 0.0f;
+            const bool expected = reference.sample(wx, wy, wz, expectedA, expectedB);
+            const bool got = sampleCaveField(wx, wy, wz, a, b);
+            if (got == expected && (!got || (a == expectedA && b == expectedB))) continue;
+            if (mismatches++ < 5) {
+                check(false, label + ": random point (" + std::to_string(wx) + "," + std::to_string(wy) + ","
+                      + std::to_string(wz) + ") differs from the monolithic sampler");
+            }
+        }
+        g_caveField.tiles.trim();
+        check(mismatches == 0, label + ": " + std::to_string(mismatches) + " random points differ");
+    }
+
+    // Cuts every other cached tile short and flips a header byte in the rest
+    // of every third, so the loader must refill them rather than trust them.
+    size_t damageCache(const fs::path& dir) {
+        std::vector<fs::path> files;
+        for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+            if (entry.path().extension() == ".cave") files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+        size_t damaged = 0;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (i % 2 == 0) {
+                fs::resize_file(files[i], fs::file_size(files[i]) / 2);
+                damaged += 1;
+            } else if (i % 3 == 0) {
+                std::fstream file(files[i], std::ios::in | std::ios::out | std::ios::binary);
+                file.seekp(20);
+                const char flipped = 0x5a;
+                file.write(&flipped, 1);
+                damaged += 1;
+            }
+        }
+        return damaged;
+    }
+
+    ExpanseConfig islandConfig() {
+        ExpanseConfig cfg;
+        cfg.loaded = true;
+        cfg.islandRadius = 400.0f;
+        cfg.elevationSeed = 17;
+        cfg.ridgeSeed = 29;
+        return cfg;
+    }
+
+    struct SectionWorld {
+        std::map<std::string, std::variant<bool, std::string>> registry;
+        BaseSystem baseSystem;
+        WorldContext worldCtx;
+
+        SectionWorld() {
+            registry["ExpanseAbsoluteMaxY"] = std::string("160");
+            baseSystem.registry = &registry;
+            baseSystem.voxelWorld = std::make_unique<VoxelWorldContext>();
+            baseSystem.voxelWorld->enabled = true;
+            baseSystem.voxelWorld->sectionSize = 64;
+        }
+    };
+
+    // The first LOD0 section the streamer hands out under the island: every
+    // column is land and every block below the surface samples the field.
+    const glm::ivec3 kFirstSection(0, -1, 0);
+
+    double generateFirstSection(SectionWorld& world, std::vector<Entity>& prototypes, const ExpanseConfig& cfg) {
+        world.baseSystem.voxelWorld->reset();
+        const auto start = Clock::now();
+        const bool ok = TerrainSystemLogic::GenerateExpanseSectionVoxel(world.baseSystem, prototypes, world.worldCtx, cfg,
+                                                                        0, kFirstSection);
+        const double ms = msSince(start);
+        check(ok, "first section failed to generate");
+        return ms;
+    }
+
+    void runEquivalence(const MonolithicField& reference, const ExpanseConfig& cfg, const fs::path& cacheDir) {
+        std::map<std::string, std::variant<bool, std::string>> registry;
+        BaseSystem baseSystem;
+        baseSystem.registry = &registry;
+
+        struct Case {
+            std::string label;
+            FieldSetup setup;
+            bool damage = false;
+        };
+        const std::vector<Case> cases = {
+            {"32-point tiles, 64 resident", {32, 64, ""}, false},
+            {"24-point tiles, 4 resident", {24, 4, ""}, false},
+            {"32-point tiles, cold disk cache", {32, 64, cacheDir.string()}, false},
+            {"32-point tiles, warm disk cache", {32, 64, cacheDir.string()}, false},
+            {"32-point tiles, damaged disk cache", {32, 16, cacheDir.string()}, true},
+            {"32-point tiles, repaired disk cache", {32, 64, cacheDir.string()}, false},
+        };
+        for (const Case& c : cases) {
+            if (c.damage) check(damageCache(cacheDir) > 0, "no cache files to damage");
+            const auto start = Clock::now();
+            configureField(baseSystem, cfg, c.setup);
+            compareLattice(reference, c.setup, c.label);
+            compareRandomPoints(reference, c.label);
+            std::printf("  %-38s matches (%.0f ms)\n", c.label.c_str(), msSince(start));
+        }
+        TerrainSystemLogic::g_caveField.ready = false;
+        TerrainSystemLogic::g_caveField.tiles.reset();
+    }
+
+    void runFirstSection(const ExpanseConfig& cfg, const fs::path& cacheDir) {
+        std::vector<Entity> prototypes = loadPrototypes();
+        if (!check(!prototypes.empty(), "no prototypes under Entities/ (run from the repo root)")) return;
+        SectionWorld world;
+        using namespace TerrainSystemLogic;
+
+        // Old path: the whole lattice before the first block.
+        MonolithicField monolithic;
+        auto start = Clock::now();
+        monolithic.fill(cfg);
+        const double monolithicFillMs = msSince(start);
+        configureField(world.baseSystem, cfg, {32, 64, ""});
+        generateFirstSection(world, prototypes, cfg);
+        const double warmMs = generateFirstSection(world, prototypes, cfg);
+
+        configureField(world.baseSystem, cfg, {32, 64, ""});
+        const double coldMs = generateFirstSection(world, prototypes, cfg);
+
+        fs::remove_all(cacheDir);
+        configureField(world.baseSystem, cfg, {32, 64, cacheDir.string()});
+        generateFirstSection(world, prototypes, cfg);
+        configureField(world.baseSystem, cfg, {32, 64, cacheDir.string()});
+        const double diskMs = generateFirstSection(world, prototypes, cfg);
+
+        // The streamer queues the next sections' tiles a frame or more ahead;
+        // give the workers that long before the section asks.
+        configureField(world.baseSystem, cfg, {32, 64, ""});
+        const int size = world.baseSystem.voxelWorld->sectionSize;
+        prefetchCaveTiles(kFirstSection.x * size, kFirstSection.z * size,
+                          kFirstSection.x * size + size - 1, kFirstSection.z * size + size - 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        g_caveField.tiles.trim();
+        const double prefetchedMs = generateFirstSection(world, prototypes, cfg);
+
+        std::printf("\ntime to first LOD0 section (%d^3 at section (%d,%d,%d)):\n", size,
+                    kFirstSection.x, kFirstSection.y, kFirstSection.z);
+        std::printf("  %-38s %10.1f ms  (field %.1f + section %.1f)\n", "monolithic field, filled up front",
+                    monolithicFillMs + warmMs, monolithicFillMs, warmMs);
+        std::printf("  %-38s %10.1f ms\n", "tiles filled on demand", coldMs);
+        std::printf("  %-38s %10.1f ms\n", "tiles from the disk cache", diskMs);
+        std::printf("  %-38s %10.1f ms\n", "tiles prefetched a frame ahead", prefetchedMs);
+        std::printf("  %-38s %10.1f ms\n", "all tiles resident", warmMs);
+        g_caveField.ready = false;
+        g_caveField.tiles.reset();
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    const ExpanseConfig cfg = islandConfig();
+    const fs::path cacheDir = fs::temp_directory_path() / ("cave_field_tiles_check_" + std::to_string(Clock::now().time_since_epoch().count()));
+    fs::remove_all(cacheDir);
+    if (!benchOnly) {
+        MonolithicField reference;
+        reference.fill(cfg);
+        std::printf("tiled field vs monolithic %dx%dx%d lattice:\n", kDimXZ, kDimY, kDimXZ);
+        runEquivalence(reference, cfg, cacheDir);
+    }
+    runFirstSection(cfg, cacheDir);
+    fs::remove_all(cacheDir);
+    if (g_failures > 0) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("ok\n");
+    return 0;
+}
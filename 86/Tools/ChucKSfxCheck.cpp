@@ -0,0 +1,245 @@
+// Standalone checks and trigger-latency benchmark for the ChucK SFX hosts.
+// Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack, ChucK and VST3 SDK include dirs> Tools/ChucKSfxCheck.cpp <jack and ChucK libs> -o chuck_sfx_check
+//   ./chuck_sfx_check [--bench-only]
+//
+// Run from the repo root. Every script under the SFX folders must define
+// play() and compile into a host shred in a real ChucK VM, and a script
+// without play() must be refused. A test sound with a one-second voice then
+// checks the pool: several triggers inside one block start several voices,
+// more triggers than voices keep the pool at its size, and the voices that
+// survive are the newest ones. Ends with the trigger latency, in blocks and
+// microseconds, from TriggerSfx to the voice sounding. Exits nonzero if any
+// check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <sys/stat.h>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/Vst3Host.h"
+
+extern "C" double glfwGetTime(void) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem&, const std::string&, int fallback) { return fallback; }
+}
+
+#include "BaseSystem/ChucKSystem.cpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kSampleRate = 48000;
+    constexpr int kBlock = 256;
+    constexpr int kChannels = 2;
+    constexpr int kVoices = 4;
+    const char* kTestScript = "/tmp/chuck_sfx_check_voice.ck";
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    struct Vm {
+        BaseSystem base;
+        std::vector<float> output = std::vector<float>(kBlock * kChannels, 0.0f);
+
+        Vm() {
+            base.audio = std::make_unique<AudioContext>();
+            AudioContext& audio = *base.audio;
+            audio.chuck = new ChucK();
+            audio.chuck->setParam(CHUCK_PARAM_SAMPLE_RATE, kSampleRate);
+            audio.chuck->setParam(CHUCK_PARAM_INPUT_CHANNELS, 0);
+            audio.chuck->setParam(CHUCK_PARAM_OUTPUT_CHANNELS, kChannels);
+            audio.chuck->setParam(CHUCK_PARAM_VM_HALT, FALSE);
+            audio.chuck->setParam(CHUCK_PARAM_IS_REALTIME_AUDIO_HINT, FALSE);
+            audio.chuck->init();
+            audio.chuck->start();
+            audio.chuckRunning = true;
+            audio.chuckSfxTriggerRing = jack_ringbuffer_create(sizeof(ChuckSfxTrigger) * 256);
+            audio.chuckSfxVoicesPerSound = kVoices;
+        }
+        ~Vm() {
+            AudioContext& audio = *base.audio;
+            jack_ringbuffer_free(audio.chuckSfxTriggerRing);
+            delete audio.chuck;
+        }
+
+        // One audio callback: dispatch, then let the VM run the block.
+        // Returns the block's peak level.
+        float runBlock() {
+            AudioContext& audio = *base.audio;
+            ChucKSystemLogic::DispatchSfxTriggers(audio);
+            audio.chuck->run(nullptr, output.data(), kBlock);
+            float peak = 0.0f;
+            for (float s : output) peak = std::max(peak, std::abs(s));
+            return peak;
+        }
+
+        // Ids of the live play() voices sporked by the sound's host.
+        std::vector<t_CKUINT> voices(int soundIndex) {
+            AudioContext& audio = *base.audio;
+            const t_CKUINT host = audio.chuckSfxSounds[static_cast<size_t>(soundIndex)].hostShredId;
+            std::vector<Chuck_VM_Shred*> shreds;
+            audio.chuck->vm()->shreduler()->get_all_shreds(shreds);
+            std::vector<t_CKUINT> ids;
+            for (auto* shred : shreds) {
+                if (shred && shred->parent && shred->parent->get_id() == host) ids.push_back(shred->get_id());
+            }
+            std::sort(ids.begin(), ids.end());
+            return ids;
+        }
+    };
+
+    void writeTestScript() {
+        std::ofstream out(kTestScript);
+        out << "fun void play()\n{\n"
+               "    SinOsc s => dac;\n"
+               "    0.2 => s.gain;\n"
+               "    1::second => now;\n"
+               "}\n";
+    }
+
+    void scriptsLoad() {
+        ChuckSfxSound sound;
+        sound.triggerEvent = "sfx_trigger_0";
+        sound.triggerCount = "sfx_trigger_count_0";
+        std::string code;
+        check(!ChucKSystemLogic::build_sfx_host("SinOsc s => dac;\n1::second => now;\n", sound, kVoices, code),
+              "a script without play() is refused");
+
+        size_t scripts = 0;
+        for (const char* folder : ChucKSystemLogic::kSfxFolders) {
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator(folder, ec)) {
+                if (entry.path().extension() != ".ck") continue;
+                std::ifstream in(entry.path());
+                std::stringstream source;
+                source << in.rdbuf();
+                check(ChucKSystemLogic::build_sfx_host(source.str(), sound, kVoices, code),
+                      entry.path().generic_string() + " defines play()");
+                scripts += 1;
+            }
+        }
+        check(scripts > 0, "SFX scripts are found; run from the repo root");
+
+        // Every host must compile in a real VM.
+        Vm vm;
+        AudioContext& audio = *vm.base.audio;
+        ChucKSystemLogic::preload_sfx(vm.base, audio);
+        const int count = audio.chuckSfxSoundCount.load();
+        check(static_cast<size_t>(count) == scripts, "every SFX script is registered");
+        for (int i = 0; i < count; ++i) {
+            const ChuckSfxSound& loaded = audio.chuckSfxSounds[static_cast<size_t>(i)];
+            check(loaded.ready && loaded.hostShredId != 0, loaded.scriptPath + " compiles into a host shred");
+        }
+    }
+
+    void voicePool() {
+        writeTestScript();
+        Vm vm;
+        AudioContext& audio = *vm.base.audio;
+        const int index = ChucKSystemLogic::register_sfx(audio, kTestScript);
+        if (!check(index >= 0 && audio.chuckSfxSounds[static_cast<size_t>(index)].ready, "pool: test sound compiles")) return;
+        vm.runBlock();
+
+        // Three triggers in one block start three voices.
+        for (int i = 0; i < 3; ++i) check(ChucKSystemLogic::TriggerSfx(vm.base, kTestScript), "pool: trigger is queued");
+        vm.runBlock();
+        std::vector<t_CKUINT> first = vm.voices(index);
+        check(first.size() == 3, "pool: three triggers in one block start " + std::to_string(first.size()) + " voices");
+
+        // Three more with one slot free: two of the first voices are stolen,
+        // oldest first, and the pool stays at its size.
+        for (int i = 0; i < 3; ++i) ChucKSystemLogic::TriggerSfx(vm.base, kTestScript);
+        vm.runBlock();
+        std::vector<t_CKUINT> second = vm.voices(index);
+        check(second.size() == kVoices, "pool: six triggers keep " + std::to_string(second.size())
+                                            + " voices, the pool holds " + std::to_string(kVoices));
+        check(second.size() == kVoices && first.size() == 3 && second.front() == first.back(),
+              "pool: the oldest voices are the ones stolen");
+
+        // A burst larger than the pool starts at most one pool's worth.
+        std::set<t_CKUINT> before(second.begin(), second.end());
+        for (int i = 0; i < 3 * kVoices; ++i) ChucKSystemLogic::TriggerSfx(vm.base, kTestScript);
+        vm.runBlock();
+        std::vector<t_CKUINT> third = vm.voices(index);
+        size_t survivors = 0;
+        for (t_CKUINT id : third) survivors += before.count(id);
+        check(third.size() == kVoices && survivors == 0, "pool: a burst replaces the whole pool and no more");
+
+        // Voices end on their own and free their slots.
+        for (int i = 0; i < kSampleRate / kBlock + 2; ++i) vm.runBlock();
+        check(vm.voices(index).empty(), "pool: finished voices leave the pool");
+    }
+
+    void latency() {
+        writeTestScript();
+        Vm vm;
+        AudioContext& audio = *vm.base.audio;
+        const int index = ChucKSystemLogic::register_sfx(audio, kTestScript);
+        if (!check(index >= 0, "latency: test sound compiles")) return;
+        vm.runBlock();
+
+        constexpr int kTrials = 200;
+        int worstBlocks = 0;
+        int totalBlocks = 0;
+        double totalUs = 0.0;
+        double dispatchUs = 0.0;
+        for (int trial = 0; trial < kTrials; ++trial) {
+            // Let the previous voice finish so each trial starts from silence.
+            while (!vm.voices(index).empty()) vm.runBlock();
+            vm.runBlock();
+            const auto start = Clock::now();
+            ChucKSystemLogic::TriggerSfx(vm.base, kTestScript);
+            int blocks = 0;
+            float peak = 0.0f;
+            while (peak == 0.0f && blocks < 64) {
+                const auto dispatchStart = Clock::now();
+                ChucKSystemLogic::DispatchSfxTriggers(audio);
+                dispatchUs += std::chrono::duration<double, std::micro>(Clock::now() - dispatchStart).count();
+                audio.chuck->run(nullptr, vm.output.data(), kBlock);
+                for (float s : vm.output) peak = std::max(peak, std::abs(s));
+                blocks += 1;
+            }
+            totalUs += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            totalBlocks += blocks;
+            worstBlocks = std::max(worstBlocks, blocks);
+        }
+        check(worstBlocks == 1, "latency: a trigger sounds in the next block, worst was " + std::to_string(worstBlocks));
+        std::printf("trigger latency over %d triggers: %.2f blocks average, %d worst (%d-frame blocks), "
+                    "%.1f us to first sound, dispatch %.2f us per block\n",
+                    kTrials, static_cast<double>(totalBlocks) / kTrials, worstBlocks, kBlock,
+                    totalUs / kTrials, dispatchUs / totalBlocks);
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    if (!benchOnly) {
+        scriptsLoad();
+        voicePool();
+    }
+    latency();
+    std::remove(kTestScript);
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
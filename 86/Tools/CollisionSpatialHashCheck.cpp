@@ -0,0 +1,197 @@
+// Standalone checks for CollisionSpatialHash. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. -I<glm> Tools/CollisionSpatialHashCheck.cpp -o collision_spatial_hash_check
+//   ./collision_spatial_hash_check
+//
+// Drives random inserts, moves and removes and compares query, querySwept and
+// queryBatch against a linear scan over the live boxes after every step. Boxes
+// straddle negative cells and sometimes cover more cells than are occupied so
+// both query paths run. Exits nonzero if any check fails.
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "BaseSystem/CollisionSpatialHash.h"
+
+namespace {
+    int g_failures = 0;
+
+    bool check(bool condition, const char* what, int step) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << " (step " << step << ")\n";
+        g_failures += 1;
+        return false;
+    }
+
+    struct Box {
+        glm::vec3 min{0.0f};
+        glm::vec3 max{0.0f};
+        int32_t handle = -1;
+    };
+
+    bool overlaps(const Box& box, const glm::vec3& min, const glm::vec3& max) {
+        if (box.min.x > max.x || box.max.x < min.x) return false;
+        if (box.min.y > max.y || box.max.y < min.y) return false;
+        if (box.min.z > max.z || box.max.z < min.z) return false;
+        return true;
+    }
+
+    std::vector<int32_t> linearScan(const std::vector<Box>& boxes, const glm::vec3& min, const glm::vec3& max) {
+        std::vector<int32_t> out;
+        for (const Box& box : boxes) {
+            if (overlaps(box, min, max)) out.push_back(box.handle);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    bool sameHandles(std::vector<int32_t> got, const std::vector<int32_t>& expected) {
+        std::sort(got.begin(), got.end());
+        return got == expected;
+    }
+
+    struct BoxSource {
+        std::mt19937 rng{0xc011};
+
+        float uniform(float lo, float hi) {
+            return std::uniform_real_distribution<float>(lo, hi)(rng);
+        }
+
+        // Mostly block-sized bodies, some spanning several cells and the odd
+        // one covering a large part of the field.
+        Box next() {
+            const glm::vec3 center(uniform(-40.0f, 40.0f), uniform(-12.0f, 12.0f), uniform(-40.0f, 40.0f));
+            const int kind = static_cast<int>(rng() % 20);
+            const float extent = kind == 0 ? uniform(10.0f, 30.0f)
+                : (kind < 5 ? uniform(1.0f, 6.0f) : uniform(0.05f, 0.6f));
+            const glm::vec3 half(extent, extent * uniform(0.3f, 1.0f), extent * uniform(0.3f, 1.0f));
+            Box box;
+            box.min = center - half;
+            box.max = center + half;
+            return box;
+        }
+
+        // Exactly block-aligned sometimes, to hit the inclusive edges.
+        Box nextQuery() {
+            Box box = next();
+            if (rng() % 4 == 0) {
+                box.min = glm::floor(box.min);
+                box.max = glm::floor(box.max);
+            }
+            return box;
+        }
+    };
+
+    void randomEdits() {
+        constexpr int kSteps = 20000;
+        CollisionSpatialHash hash;
+        hash.clear(4.0f);
+        std::vector<Box> live;
+        std::vector<int32_t> removed;
+        BoxSource source;
+        std::vector<int32_t> got;
+
+        for (int step = 0; step < kSteps && g_failures == 0; ++step) {
+            const int op = static_cast<int>(source.rng() % 10);
+            if (op < 4 || live.empty()) {
+                Box box = source.next();
+                box.handle = hash.insert(box.min, box.max, step);
+                check(hash.valid(box.handle), "inserted handle is valid", step);
+                removed.erase(std::remove(removed.begin(), removed.end(), box.handle), removed.end());
+                live.push_back(box);
+            } else if (op < 8) {
+                Box& box = live[source.rng() % live.size()];
+                glm::vec3 delta(source.uniform(-0.5f, 0.5f), source.uniform(-0.5f, 0.5f), source.uniform(-0.5f, 0.5f));
+                if (op == 7) delta = delta * 40.0f;
+                box.min = box.min + delta;
+                box.max = box.max + delta;
+                hash.move(box.handle, box.min, box.max);
+            } else {
+                const size_t index = source.rng() % live.size();
+                hash.remove(live[index].handle);
+                check(!hash.valid(live[index].handle), "removed handle is invalid", step);
+                removed.push_back(live[index].handle);
+                live[index] = live.back();
+                live.pop_back();
+            }
+            check(hash.liveCount == live.size(), "live count matches", step);
+
+            const Box probe = source.nextQuery();
+            got.clear();
+            hash.query(probe.min, probe.max, got);
+            check(sameHandles(got, linearScan(live, probe.min, probe.max)), "query matches linear scan", step);
+            for (int32_t handle : got) {
+                check(std::find(removed.begin(), removed.end(), handle) == removed.end(),
+                      "query never returns removed handles", step);
+            }
+
+            glm::vec3 delta(source.uniform(-8.0f, 8.0f), source.uniform(-2.0f, 2.0f), source.uniform(-8.0f, 8.0f));
+            got.clear();
+            hash.querySwept(probe.min, probe.max, delta, got);
+            const glm::vec3 sweptMin = glm::min(probe.min, probe.min + delta);
+            const glm::vec3 sweptMax = glm::max(probe.max, probe.max + delta);
+            check(sameHandles(got, linearScan(live, sweptMin, sweptMax)), "querySwept matches linear scan", step);
+        }
+        std::cout << "edits: " << kSteps << " steps, " << live.size() << " live boxes in "
+                  << hash.cells.size() << " cells\n";
+    }
+
+    void batchMatchesSingleQueries() {
+        CollisionSpatialHash hash;
+        hash.clear(2.0f);
+        std::vector<Box> live;
+        BoxSource source;
+        for (int i = 0; i < 3000; ++i) {
+            Box box = source.next();
+            box.handle = hash.insert(box.min, box.max, i);
+            live.push_back(box);
+        }
+        std::vector<glm::vec3> mins;
+        std::vector<glm::vec3> maxs;
+        for (int i = 0; i < 500; ++i) {
+            const Box probe = source.nextQuery();
+            mins.push_back(probe.min);
+            maxs.push_back(probe.max);
+        }
+        std::vector<int32_t> offsets;
+        std::vector<int32_t> handles;
+        hash.queryBatch(mins, maxs, offsets, handles);
+        if (!check(offsets.size() == mins.size() + 1, "batch has one range per body", 0)) return;
+        for (size_t i = 0; i < mins.size(); ++i) {
+            std::vector<int32_t> slice(handles.begin() + offsets[i], handles.begin() + offsets[i + 1]);
+            check(sameHandles(slice, linearScan(live, mins[i], maxs[i])), "queryBatch range matches linear scan",
+                  static_cast<int>(i));
+        }
+        std::cout << "batch: " << mins.size() << " bodies, " << handles.size() << " candidates\n";
+    }
+
+    void removeAllEmptiesCells() {
+        CollisionSpatialHash hash;
+        hash.clear(4.0f);
+        BoxSource source;
+        std::vector<int32_t> handles;
+        for (int i = 0; i < 1000; ++i) {
+            const Box box = source.next();
+            handles.push_back(hash.insert(box.min, box.max, i));
+        }
+        for (int32_t handle : handles) hash.remove(handle);
+        check(hash.liveCount == 0, "no live entries after removing all", 0);
+        check(hash.cells.empty(), "no occupied cells after removing all", 0);
+        const int32_t reused = hash.insert(glm::vec3(0.0f), glm::vec3(1.0f), 0);
+        check(std::find(handles.begin(), handles.end(), reused) != handles.end(), "freed handles are recycled", 0);
+    }
+}
+
+int main() {
+    randomEdits();
+    batchMatchesSingleQueries();
+    removeAllEmptiesCells();
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
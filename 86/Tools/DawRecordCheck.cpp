@@ -0,0 +1,255 @@
+// Standalone checks for the disk recorder. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack include dir> Tools/DawRecordCheck.cpp -o daw_record_check
+//   ./daw_record_check
+//
+// Drives two armed stereo tracks the way the audio callback does
+// (WriteRecordInputRT per 256-frame block, about 5x realtime) while one take's
+// file sits on a simulated slow disk that outpaces its 16k-frame rings.
+// Every frame that reaches the file must keep its left and right samples
+// together, the frames missing from the file must equal recordDroppedFrames,
+// and aborting the other track's take must not wait on the slow disk. A
+// second pass feeds the right ring later than the left and checks the late
+// frames are paired up rather than zero-filled, and a ring with no room on
+// the right side must drop the frame on both sides and count it. Exits nonzero
+// if any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <streambuf>
+#include <thread>
+
+#include "BaseSystem/DawRecordSystem.cpp"
+
+namespace DawWaveformSystemLogic {
+    void UpdateWaveformRange(DawContext&, DawTrack&, size_t, size_t) {}
+    void TrimRecordPreview(DawTrack& track) {
+        track.pendingRecord.clear();
+        track.pendingRecordRight.clear();
+    }
+}
+namespace DawStreamSystemLogic {
+    void ReleaseStream(DawContext&, DawClipAudio&) {}
+    std::string StreamSourcePath(const DawContext&, const DawClipAudio&) { return std::string(); }
+}
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t kBlock = 256;
+    constexpr size_t kRingBytes = 16384 * sizeof(float);
+    constexpr int kBlocks = 2000;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    // Passes writes through to the take's file, sleeping on every sample
+    // chunk as a stalled disk would.
+    struct SlowDiskBuf : std::streambuf {
+        std::streambuf* inner = nullptr;
+        std::chrono::milliseconds delay{40};
+
+    protected:
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            if (n > 64) std::this_thread::sleep_for(delay);
+            return inner->sputn(s, n);
+        }
+        int_type overflow(int_type c) override {
+            return traits_type::eq_int_type(c, traits_type::eof()) ? traits_type::not_eof(c) : inner->sputc(traits_type::to_char_type(c));
+        }
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+            return inner->pubseekoff(off, dir, which);
+        }
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override { return inner->pubseekpos(pos, which); }
+        int sync() override { return inner->pubsync(); }
+    };
+
+    DawTrack& armTrack(DawContext& daw) {
+        DawTrack& track = daw.tracks.emplace_back();
+        track.recordRing = jack_ringbuffer_create(kRingBytes);
+        track.recordRingRight = jack_ringbuffer_create(kRingBytes);
+        track.stereoInputPair12 = true;
+        track.recordingActive = true;
+        return track;
+    }
+
+    void freeRings(DawContext& daw) {
+        for (auto& track : daw.tracks) {
+            jack_ringbuffer_free(track.recordRing);
+            jack_ringbuffer_free(track.recordRingRight);
+            track.recordRing = nullptr;
+            track.recordRingRight = nullptr;
+        }
+    }
+
+    // Interleaved stereo samples of a float WAV, RIFF or RF64 layout.
+    std::vector<float> readTake(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        size_t pos = 12;
+        while (pos + 8 <= bytes.size()) {
+            uint32_t size = 0;
+            std::memcpy(&size, bytes.data() + pos + 4, 4);
+            if (std::memcmp(bytes.data() + pos, "data", 4) == 0) {
+                const size_t count = (bytes.size() - pos - 8) / sizeof(float);
+                std::vector<float> samples(count);
+                std::memcpy(samples.data(), bytes.data() + pos + 8, count * sizeof(float));
+                return samples;
+            }
+            pos += 8 + size;
+        }
+        return {};
+    }
+
+    float leftOf(uint64_t frame) { return static_cast<float>(frame); }
+    float rightOf(uint64_t frame) { return -static_cast<float>(frame) - 0.25f; }
+
+    void slowDiskTake() {
+        DawContext daw;
+        daw.sampleRate = 48000.0f;
+        armTrack(daw);
+        armTrack(daw);
+        if (!check(DawRecordSystemLogic::BeginTakes(daw), "slow: takes open")) return;
+
+        SlowDiskBuf slow;
+        {
+            // The recorder thread snapshots the list between passes; the
+            // file is swapped before any frame is produced.
+            DawRecordTake& take = *daw.diskRecorder->takes[0];
+            std::lock_guard<std::mutex> takeLock(take.mutex);
+            slow.inner = take.writer.file.rdbuf();
+            take.writer.file.std::ostream::rdbuf(&slow);
+        }
+
+        std::vector<float> left(kBlock);
+        std::vector<float> right(kBlock);
+        double abortMs = 0.0;
+        const auto start = Clock::now();
+        for (int block = 0; block < kBlocks; ++block) {
+            for (size_t i = 0; i < kBlock; ++i) {
+                const uint64_t frame = static_cast<uint64_t>(block) * kBlock + i;
+                left[i] = leftOf(frame);
+                right[i] = rightOf(frame);
+            }
+            for (auto& track : daw.tracks) {
+                if (!track.recordingActive) continue;
+                DawRecordSystemLogic::WriteRecordInputRT(track, left.data(), right.data(), kBlock);
+            }
+            if (block % 16 == 0) DawRecordSystemLogic::DrainRecordPreview(daw);
+            if (block == kBlocks / 2) {
+                const auto abortStart = Clock::now();
+                DawRecordSystemLogic::AbortTrackTake(daw, daw.tracks[1]);
+                abortMs = std::chrono::duration<double, std::milli>(Clock::now() - abortStart).count();
+                daw.tracks[1].recordingActive = false;
+            }
+            std::this_thread::sleep_until(start + std::chrono::milliseconds(block + 1));
+        }
+        DawRecordSystemLogic::FinishTakes(daw);
+
+        const DawTrack& track = daw.tracks[0];
+        const uint64_t produced = static_cast<uint64_t>(kBlocks) * kBlock;
+        const uint64_t dropped = track.recordDroppedFrames.load();
+        const std::vector<float> samples = readTake(track.recordTakePath);
+        const uint64_t frames = samples.size() / 2;
+        check(!track.recordTakePath.empty() && frames == track.recordTakeFrames, "slow: take is kept with its frame count");
+        check(dropped > 0, "slow: the slow disk overflows the rings");
+        check(frames + dropped == produced, "slow: written + dropped frames (" + std::to_string(frames) + " + "
+                                                + std::to_string(dropped) + ") equal produced frames "
+                                                + std::to_string(produced));
+
+        size_t unpaired = 0;
+        size_t outOfOrder = 0;
+        uint64_t gaps = 0;
+        int64_t previous = -1;
+        for (uint64_t i = 0; i < frames; ++i) {
+            const float l = samples[i * 2];
+            const float r = samples[i * 2 + 1];
+            const int64_t frame = static_cast<int64_t>(l);
+            if (r != rightOf(static_cast<uint64_t>(frame)) || static_cast<float>(frame) != l) unpaired += 1;
+            if (frame <= previous) outOfOrder += 1;
+            else gaps += static_cast<uint64_t>(frame - previous - 1);
+            previous = frame;
+        }
+        gaps += produced - 1 - static_cast<uint64_t>(std::max<int64_t>(previous, 0));
+        check(unpaired == 0, "slow: left and right stay paired, " + std::to_string(unpaired) + " frames apart");
+        check(outOfOrder == 0, "slow: frames stay in order");
+        check(gaps == dropped, "slow: frames missing from the file (" + std::to_string(gaps)
+                                   + ") are the ones counted as dropped");
+        check(abortMs < 15.0, "slow: aborting another take waits " + std::to_string(abortMs) + " ms on the slow disk");
+        std::printf("slow disk: %llu of %llu frames written, %llu dropped, abort took %.2f ms\n",
+                    static_cast<unsigned long long>(frames), static_cast<unsigned long long>(produced),
+                    static_cast<unsigned long long>(dropped), abortMs);
+
+        DawRecordSystemLogic::SweepTakeFiles(daw, false);
+        DawRecordSystemLogic::ShutdownRecorder(daw);
+        freeRings(daw);
+    }
+
+    void lateRightChannel() {
+        DawContext daw;
+        daw.sampleRate = 48000.0f;
+        DawTrack& track = armTrack(daw);
+        if (!check(DawRecordSystemLogic::BeginTakes(daw), "late: take opens")) return;
+
+        std::vector<float> left(1000);
+        std::vector<float> right(1000);
+        for (size_t i = 0; i < left.size(); ++i) {
+            left[i] = leftOf(i);
+            right[i] = rightOf(i);
+        }
+        jack_ringbuffer_write(track.recordRing, reinterpret_cast<const char*>(left.data()), 1000 * sizeof(float));
+        jack_ringbuffer_write(track.recordRingRight, reinterpret_cast<const char*>(right.data()), 600 * sizeof(float));
+        // Long enough for the recorder thread to drain what is there.
+        std::this_thread::sleep_for(std::chrono::milliseconds(40));
+        jack_ringbuffer_write(track.recordRingRight, reinterpret_cast<const char*>(right.data() + 600), 400 * sizeof(float));
+        DawRecordSystemLogic::FinishTakes(daw);
+
+        const std::vector<float> samples = readTake(track.recordTakePath);
+        bool paired = samples.size() == 2000;
+        for (size_t i = 0; paired && i < 1000; ++i) {
+            paired = samples[i * 2] == leftOf(i) && samples[i * 2 + 1] == rightOf(i);
+        }
+        check(paired, "late: right frames that arrive after their left frames are written beside them");
+        DawRecordSystemLogic::SweepTakeFiles(daw, false);
+        DawRecordSystemLogic::ShutdownRecorder(daw);
+        freeRings(daw);
+    }
+
+    void oneSidedOverflow() {
+        DawContext daw;
+        DawTrack& track = armTrack(daw);
+        // The right ring is backed up with all but 100 frames of room.
+        const size_t capacity = jack_ringbuffer_write_space(track.recordRingRight) / sizeof(float);
+        std::vector<float> fill(capacity - 100, 0.0f);
+        jack_ringbuffer_write(track.recordRingRight, reinterpret_cast<const char*>(fill.data()), fill.size() * sizeof(float));
+        std::vector<float> block(kBlock, 1.0f);
+        DawRecordSystemLogic::WriteRecordInputRT(track, block.data(), block.data(), kBlock);
+        check(jack_ringbuffer_read_space(track.recordRing) == 100 * sizeof(float),
+              "overflow: the left ring takes only what the right ring has room for");
+        check(track.recordDroppedFrames.load() == kBlock - 100, "overflow: right-ring overflow is counted as dropped");
+        freeRings(daw);
+    }
+}
+
+int main() {
+    slowDiskTake();
+    lateRightChannel();
+    oneSidedOverflow();
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
@@ -0,0 +1,315 @@
+// Standalone checks for the streamed clip cache. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack and VST3 SDK include dirs> Tools/DawStreamCheck.cpp -o daw_stream_check
+//   ./daw_stream_check
+//
+// Maps float WAVs through OpenStreamedClipAudio with the smallest page cache
+// (4 pages of 8192 frames) and plays them the way the audio callback does:
+// ReadStreamFramesRT per 256-frame block, with UpdateDawStreaming publishing
+// the playhead between blocks, at about 2.5x realtime. Sequential playback of
+// a stereo clip and of a mono clip written with an RF64 reservation must come
+// out sample-identical with no underruns once the first page is in. Seek-heavy
+// playback must serve every frame it returns identically, zero-fill the rest,
+// count exactly the zero-filled frames as underruns and recover from each
+// seek within a few blocks. Also checks that stream ids are recycled past
+// kMaxStreams, that a recycled id never serves the released file's pages,
+// that running out of ids fails instead of handing out a bad id and that
+// ReleaseStreams cuts off readers. Exits nonzero if any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <thread>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/Vst3Host.h"
+#include "BaseSystem/WavStreamWriter.h"
+
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem&, const std::string&, int fallback) { return fallback; }
+}
+double glfwGetTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#include "BaseSystem/DawStreamSystem.cpp"
+
+namespace {
+    namespace fs = std::filesystem;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr float kSampleRate = 48000.0f;
+    constexpr size_t kBlock = 256;
+    constexpr uint64_t kClipFrames = 240000;
+    // Each block stands for 5.3 ms of audio.
+    constexpr auto kBlockPace = std::chrono::microseconds(2000);
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    // Every frame is distinct, so a frame served from the wrong offset or
+    // the wrong file cannot match by accident.
+    float sampleAt(uint32_t seed, uint64_t frame, int channel) {
+        return static_cast<float>(seed) + static_cast<float>(frame) * 1.0e-6f + (channel ? 0.5f : 0.0f);
+    }
+
+    std::string writeSource(const fs::path& dir, const char* name, uint32_t seed, uint16_t channels, bool rf64) {
+        const fs::path path = dir / name;
+        WavStreamWriter writer;
+        writer.open(path.string(), channels, static_cast<uint32_t>(kSampleRate), rf64);
+        std::vector<float> chunk;
+        for (uint64_t start = 0; start < kClipFrames; start += 4096) {
+            const uint64_t end = std::min<uint64_t>(kClipFrames, start + 4096);
+            chunk.clear();
+            for (uint64_t frame = start; frame < end; ++frame) {
+                for (int c = 0; c < channels; ++c) chunk.push_back(sampleAt(seed, frame, c));
+            }
+            writer.writeInterleaved(chunk.data(), static_cast<size_t>(end - start));
+        }
+        writer.close();
+        return path.string();
+    }
+
+    struct Stream {
+        BaseSystem base;
+        std::vector<Entity> prototypes;
+        std::vector<float> left = std::vector<float>(kBlock);
+        std::vector<float> right = std::vector<float>(kBlock);
+
+        Stream() {
+            base.daw = std::make_unique<DawContext>();
+            DawContext& daw = *base.daw;
+            daw.sampleRate = kSampleRate;
+            daw.streamConfigLoaded = true;
+            daw.streamCachePages = 4;
+            daw.streamReadAheadSeconds = 0.25;
+        }
+
+        ~Stream() { DawStreamSystemLogic::CleanupDawStreaming(base, prototypes, 0.0f, nullptr); }
+
+        DawContext& daw() { return *base.daw; }
+
+        int open(const std::string& path) {
+            DawClipAudio clip;
+            uint32_t rate = 0;
+            if (!DawStreamSystemLogic::OpenStreamedClipAudio(daw(), path, clip, rate)) return -1;
+            daw().clipAudio.push_back(std::move(clip));
+            return static_cast<int>(daw().clipAudio.size()) - 1;
+        }
+
+        void place(int audioId) {
+            DawTrack& track = daw().tracks.emplace_back();
+            DawClip clip;
+            clip.audioId = audioId;
+            clip.length = daw().clipAudio[static_cast<size_t>(audioId)].frameCount();
+            track.clips.push_back(clip);
+        }
+
+        void publish(uint64_t playhead) {
+            daw().playheadSample.store(playhead);
+            DawStreamSystemLogic::UpdateDawStreaming(base, prototypes, 0.0f, nullptr);
+        }
+
+        size_t read(int audioId, uint64_t offset) {
+            return DawStreamSystemLogic::ReadStreamFramesRT(daw(), daw().clipAudio[static_cast<size_t>(audioId)],
+                                                            offset, kBlock, left.data(), right.data());
+        }
+
+        // Keeps publishing until the block at `offset` is served in full.
+        bool waitServed(int audioId, uint64_t offset) {
+            const auto deadline = Clock::now() + std::chrono::seconds(2);
+            while (Clock::now() < deadline) {
+                publish(offset);
+                if (read(audioId, offset) == kBlock) return true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return false;
+        }
+
+        uint64_t underrunFrames() const { return base.daw->sampleCache->underrunFrames.load(); }
+    };
+
+    // Frames of one block that differ from the source; `zeroOk` accepts
+    // zero-filled frames.
+    size_t wrongFrames(const Stream& stream, uint32_t seed, uint16_t channels, uint64_t offset, bool zeroOk) {
+        size_t wrong = 0;
+        for (size_t i = 0; i < kBlock; ++i) {
+            const uint64_t frame = offset + i;
+            const float l = frame < kClipFrames ? sampleAt(seed, frame, 0) : 0.0f;
+            const float r = frame < kClipFrames ? sampleAt(seed, frame, channels > 1 ? 1 : 0) : 0.0f;
+            const bool exact = stream.left[i] == l && stream.right[i] == r;
+            const bool zero = stream.left[i] == 0.0f && stream.right[i] == 0.0f;
+            if (!exact && !(zeroOk && zero)) wrong += 1;
+        }
+        return wrong;
+    }
+
+    void sequentialPlayback(const std::string& path, uint32_t seed, uint16_t channels, const char* label) {
+        Stream stream;
+        const int id = stream.open(path);
+        if (!check(id >= 0, std::string(label) + ": opens as a stream")) return;
+        stream.place(id);
+        check(stream.daw().clipAudio[static_cast<size_t>(id)].channels == channels, std::string(label) + ": channel count");
+        if (!check(stream.waitServed(id, 0), std::string(label) + ": first page arrives")) return;
+
+        const uint64_t underrunsBefore = stream.underrunFrames();
+        size_t wrong = 0;
+        size_t blocks = 0;
+        for (uint64_t offset = 0; offset < kClipFrames; offset += kBlock, ++blocks) {
+            stream.publish(offset);
+            stream.read(id, offset);
+            wrong += wrongFrames(stream, seed, channels, offset, false);
+            std::this_thread::sleep_for(kBlockPace);
+        }
+        const uint64_t underruns = stream.underrunFrames() - underrunsBefore;
+        check(wrong == 0, std::string(label) + ": sequential output is sample-identical, "
+                              + std::to_string(wrong) + " frames differ");
+        check(underruns == 0, std::string(label) + ": no underruns, " + std::to_string(underruns) + " frames");
+        std::printf("%s: %zu blocks sequential, %llu underrun frames\n", label, blocks,
+                    static_cast<unsigned long long>(underruns));
+    }
+
+    void seekHeavyPlayback(const std::string& path, uint32_t seed) {
+        Stream stream;
+        const int id = stream.open(path);
+        if (!check(id >= 0, "seek: opens as a stream")) return;
+        stream.place(id);
+
+        std::mt19937_64 rng(0x5eec);
+        constexpr int kSeeks = 150;
+        size_t wrong = 0;
+        size_t accountingErrors = 0;
+        size_t blocks = 0;
+        size_t missedBlocks = 0;
+        size_t worstRecovery = 0;
+        for (int seek = 0; seek < kSeeks; ++seek) {
+            // The renderer never reads past a clip's end, so neither do seeks.
+            uint64_t offset = rng() % (kClipFrames - 8 * kBlock);
+            if (seek % 5 == 0) offset = (offset / DawSampleCache::kPageFrames) * DawSampleCache::kPageFrames;
+            if (seek % 7 == 0) offset = kClipFrames - 8 * kBlock;
+            size_t recovery = 0;
+            bool recovered = false;
+            for (int b = 0; b < 8; ++b, offset += kBlock, ++blocks) {
+                stream.publish(offset);
+                const uint64_t before = stream.underrunFrames();
+                const size_t served = stream.read(id, offset);
+                if (stream.underrunFrames() - before != kBlock - served) accountingErrors += 1;
+                wrong += wrongFrames(stream, seed, 2, offset, true);
+                if (served < kBlock) missedBlocks += 1;
+                if (!recovered && served == kBlock) recovered = true;
+                if (!recovered) recovery += 1;
+                std::this_thread::sleep_for(kBlockPace);
+            }
+            if (!recovered) recovery = 8;
+            worstRecovery = std::max(worstRecovery, recovery);
+        }
+        check(wrong == 0, "seek: every served frame is sample-identical, " + std::to_string(wrong) + " frames differ");
+        check(accountingErrors == 0, "seek: underrun frames equal zero-filled frames in every block");
+        check(worstRecovery <= 4, "seek: playback recovers within 4 blocks of a seek, took "
+                                      + std::to_string(worstRecovery));
+        std::printf("seek: %d seeks, %zu blocks, %zu with misses, worst recovery %zu blocks\n", kSeeks, blocks,
+                    missedBlocks, worstRecovery);
+    }
+
+    void idsAreRecycled(const std::string& first, const std::string& second) {
+        Stream stream;
+        DawContext& daw = stream.daw();
+        int maxId = -1;
+        bool allOpened = true;
+        for (int i = 0; i < DawSampleCache::kMaxStreams * 3; ++i) {
+            DawClipAudio clip;
+            uint32_t rate = 0;
+            if (!DawStreamSystemLogic::OpenStreamedClipAudio(daw, i % 2 ? second : first, clip, rate)) {
+                allOpened = false;
+                break;
+            }
+            maxId = std::max(maxId, clip.streamId);
+            DawStreamSystemLogic::ReleaseStream(daw, clip);
+            if (clip.isStreamed()) allOpened = false;
+        }
+        check(allOpened, "open/release cycles past kMaxStreams keep succeeding");
+        check(maxId == 0, "a released id is the next one handed out");
+
+        // Pull a page of the first file in, release it and reuse its id for
+        // the second file: the resident page must not be served for it.
+        const int a = stream.open(first);
+        stream.place(a);
+        if (!check(stream.waitServed(a, 0), "recycle: first file's page arrives")) return;
+        const int oldStreamId = daw.clipAudio[static_cast<size_t>(a)].streamId;
+        DawStreamSystemLogic::ReleaseStream(daw, daw.clipAudio[static_cast<size_t>(a)]);
+        check(stream.read(a, 0) == 0, "a released clip serves nothing");
+        daw.tracks.clear();
+        const int b = stream.open(second);
+        stream.place(b);
+        check(daw.clipAudio[static_cast<size_t>(b)].streamId == oldStreamId, "recycle: the id is reused");
+        stream.read(b, 0);
+        check(wrongFrames(stream, 2, 1, 0, true) == 0, "recycle: a reused id never serves the old file's page");
+        check(stream.waitServed(b, 0) && wrongFrames(stream, 2, 1, 0, false) == 0, "recycle: the new file's page arrives");
+    }
+
+    void exhaustionFailsLoudly(const std::string& path) {
+        Stream stream;
+        DawContext& daw = stream.daw();
+        std::vector<DawClipAudio> clips(DawSampleCache::kMaxStreams);
+        uint32_t rate = 0;
+        bool allOpened = true;
+        for (auto& clip : clips) allOpened = DawStreamSystemLogic::OpenStreamedClipAudio(daw, path, clip, rate) && allOpened;
+        check(allOpened, "kMaxStreams streams open");
+        DawClipAudio extra;
+        check(!DawStreamSystemLogic::OpenStreamedClipAudio(daw, path, extra, rate) && !extra.isStreamed(),
+              "one more stream is refused");
+        const int freed = clips[77].streamId;
+        DawStreamSystemLogic::ReleaseStream(daw, clips[77]);
+        check(DawStreamSystemLogic::OpenStreamedClipAudio(daw, path, extra, rate) && extra.streamId == freed,
+              "a released slot can be opened again");
+
+        // ReleaseStreams while the prefetch thread runs: readers are cut off
+        // at once and the cache keeps working afterwards.
+        daw.clipAudio.push_back(extra);
+        stream.place(0);
+        stream.waitServed(0, 0);
+        const auto start = Clock::now();
+        DawStreamSystemLogic::ReleaseStreams(daw);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        check(stream.read(0, 0) == 0, "ReleaseStreams cuts off readers");
+        check(daw.sampleCache->liveStreams.load() == 0, "ReleaseStreams leaves no live streams");
+        daw.clipAudio.clear();
+        daw.tracks.clear();
+        const int reopened = stream.open(path);
+        stream.place(reopened);
+        check(reopened >= 0 && stream.waitServed(reopened, 0), "streams open and play after ReleaseStreams");
+        std::printf("release: %d streams released in %.3f ms\n", DawSampleCache::kMaxStreams, ms);
+    }
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "daw_stream_check";
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+    const std::string stereo = writeSource(dir, "stereo.wav", 1, 2, false);
+    const std::string mono = writeSource(dir, "mono_rf64.wav", 2, 1, true);
+
+    sequentialPlayback(stereo, 1, 2, "stereo");
+    sequentialPlayback(mono, 2, 1, "mono rf64");
+    seekHeavyPlayback(stereo, 1);
+    idsAreRecycled(stereo, mono);
+    exhaustionFailsLoudly(mono);
+    fs::remove_all(dir, ec);
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
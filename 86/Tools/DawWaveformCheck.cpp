@@ -0,0 +1,259 @@
+// Standalone checks and benchmark for the clip waveform pyramid. Not part of
+// the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack and VST3 SDK include dirs> Tools/DawWaveformCheck.cpp -o daw_waveform_check
+//   ./daw_waveform_check [--bench-only]
+//
+// Builds the pyramids of stereo, mono and short clips of odd length through
+// UpdateDawWaveforms, a tick budget at a time, and compares every entry of
+// every level with the min/max and RMS of the source frames it covers.
+// QueryClipWaveform over random spans must report exactly the brute-force
+// min/max of the blocks it reads. Then times building and querying a 10-minute 48 kHz stereo clip.
+// Exits nonzero if any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/Vst3Host.h"
+
+namespace DawClipSystemLogic {
+    uint64_t TrackEndSample(const DawTrack&) { return 0; }
+    void RenderTrackRange(DawContext&, const DawTrack&, uint64_t, size_t count, float* outLeft, float* outRight) {
+        std::fill(outLeft, outLeft + count, 0.0f);
+        std::fill(outRight, outRight + count, 0.0f);
+    }
+}
+namespace DawStreamSystemLogic {
+    bool ReadStreamFrames(DawContext&, const DawClipAudio&, uint64_t, size_t, float*, float*) { return false; }
+}
+
+#include "BaseSystem/DawWaveformSystem.cpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint64_t kBlockFrames = DawWaveformPyramid::kBaseBlockFrames;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    // Tones, noise bursts and silent stretches, so blocks differ in level,
+    // sign and colour.
+    DawClipAudio makeClip(uint64_t frames, bool stereo, uint32_t seed) {
+        DawClipAudio clip;
+        clip.channels = stereo ? 2 : 1;
+        clip.left.resize(static_cast<size_t>(frames));
+        if (stereo) clip.right.resize(static_cast<size_t>(frames));
+        uint32_t state = seed;
+        for (uint64_t i = 0; i < frames; ++i) {
+            state = state * 1664525u + 1013904223u;
+            const float noise = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+            const uint64_t section = (i / 9973) % 4;
+            float sample = 0.0f;
+            if (section == 0) sample = 0.8f * std::sin(static_cast<float>(i) * 0.031f);
+            else if (section == 1) sample = 0.3f * noise;
+            else if (section == 3) sample = 0.5f * std::sin(static_cast<float>(i) * 0.0071f) + 0.05f * noise;
+            clip.left[static_cast<size_t>(i)] = sample;
+            if (stereo) clip.right[static_cast<size_t>(i)] = -0.7f * sample + 0.01f * noise;
+        }
+        return clip;
+    }
+
+    float sourceRight(const DawClipAudio& clip, size_t i) {
+        return clip.channels > 1 ? clip.right[i] : clip.left[i];
+    }
+
+    // Builds the pool's pyramids the way the main loop does; returns ticks.
+    int buildAll(BaseSystem& base, std::vector<Entity>& prototypes) {
+        int ticks = 0;
+        while (true) {
+            bool done = true;
+            for (const auto& clip : base.daw->clipAudio) {
+                done = done && clip.waveform.builtFrames >= clip.frameCount();
+            }
+            if (done) return ticks;
+            DawWaveformSystemLogic::UpdateDawWaveforms(base, prototypes, 0.0f, nullptr);
+            ticks += 1;
+        }
+    }
+
+    void checkLevels(const DawClipAudio& clip, const char* label) {
+        const DawWaveformPyramid& pyramid = clip.waveform;
+        const uint64_t total = clip.frameCount();
+        size_t wrongMinMax = 0;
+        size_t wrongRms = 0;
+        for (size_t level = 0; level < pyramid.levels.size(); ++level) {
+            const DawWaveformLevel& data = pyramid.levels[level];
+            const uint64_t span = kBlockFrames << level;
+            check(data.minL.size() == static_cast<size_t>((total + span - 1) / span),
+                  std::string(label) + ": level " + std::to_string(level) + " entry count");
+            for (size_t i = 0; i < data.minL.size(); ++i) {
+                const size_t start = static_cast<size_t>(i * span);
+                const size_t end = static_cast<size_t>(std::min<uint64_t>(total, (i + 1) * span));
+                float minL = clip.left[start];
+                float maxL = minL;
+                float minR = sourceRight(clip, start);
+                float maxR = minR;
+                double sumL = 0.0;
+                double sumR = 0.0;
+                for (size_t f = start; f < end; ++f) {
+                    const float l = clip.left[f];
+                    const float r = sourceRight(clip, f);
+                    minL = std::min(minL, l);
+                    maxL = std::max(maxL, l);
+                    minR = std::min(minR, r);
+                    maxR = std::max(maxR, r);
+                    sumL += static_cast<double>(l) * l;
+                    sumR += static_cast<double>(r) * r;
+                }
+                if (data.minL[i] != minL || data.maxL[i] != maxL || data.minR[i] != minR || data.maxR[i] != maxR) {
+                    wrongMinMax += 1;
+                }
+                const double n = static_cast<double>(end - start);
+                const double rmsL = std::sqrt(sumL / n);
+                const double rmsR = std::sqrt(sumR / n);
+                if (std::abs(data.rmsL[i] - rmsL) > 1.0e-4 * (1.0 + rmsL)
+                    || std::abs(data.rmsR[i] - rmsR) > 1.0e-4 * (1.0 + rmsR)) {
+                    wrongRms += 1;
+                }
+            }
+        }
+        check(wrongMinMax == 0, std::string(label) + ": pyramid min/max equal brute force, "
+                                    + std::to_string(wrongMinMax) + " entries differ");
+        check(wrongRms == 0, std::string(label) + ": pyramid RMS equals brute force, "
+                                 + std::to_string(wrongRms) + " entries differ");
+    }
+
+    void checkQueries(const DawClipAudio& clip, const char* label) {
+        const uint64_t total = clip.frameCount();
+        std::mt19937_64 rng(0x3a7e);
+        size_t wrong = 0;
+        size_t rejected = 0;
+        for (int q = 0; q < 3000; ++q) {
+            // Spans from a few frames (zoomed in) to the whole clip.
+            const uint64_t span = 1 + (rng() % (q % 3 == 0 ? total : (q % 3 == 1 ? 65536 : 512)));
+            const uint64_t start = rng() % total;
+            const uint64_t end = std::min(total, start + span);
+            DawWaveformSpan out;
+            if (!DawWaveformSystemLogic::QueryClipWaveform(clip, start, end, out)) {
+                rejected += 1;
+                continue;
+            }
+            // The query reads whole blocks of the level it picks; it must
+            // report exactly the frames those blocks cover.
+            size_t level = 0;
+            while (level + 1 < clip.waveform.levels.size() && (kBlockFrames << (level + 1)) <= end - start) ++level;
+            const uint64_t blockSpan = kBlockFrames << level;
+            const size_t from = static_cast<size_t>(start / blockSpan * blockSpan);
+            const size_t to = static_cast<size_t>(std::min<uint64_t>(total, ((end - 1) / blockSpan + 1) * blockSpan));
+            float minL = clip.left[from];
+            float maxL = minL;
+            float minR = sourceRight(clip, from);
+            float maxR = minR;
+            for (size_t f = from; f < to; ++f) {
+                minL = std::min(minL, clip.left[f]);
+                maxL = std::max(maxL, clip.left[f]);
+                minR = std::min(minR, sourceRight(clip, f));
+                maxR = std::max(maxR, sourceRight(clip, f));
+            }
+            if (out.minL != minL || out.maxL != maxL || out.minR != minR || out.maxR != maxR) wrong += 1;
+        }
+        check(rejected == 0, std::string(label) + ": every in-range query is answered");
+        check(wrong == 0, std::string(label) + ": queries match brute force, " + std::to_string(wrong) + " differ");
+    }
+
+    void correctness() {
+        BaseSystem base;
+        std::vector<Entity> prototypes;
+        base.daw = std::make_unique<DawContext>();
+        DawContext& daw = *base.daw;
+        daw.sampleRate = 48000.0f;
+        // Odd lengths leave a partial block and odd counts at every level.
+        daw.clipAudio.push_back(makeClip(3 * 1048576 + 12345, true, 7));
+        daw.clipAudio.push_back(makeClip(700001, false, 11));
+        daw.clipAudio.push_back(makeClip(100, true, 13));
+        const int ticks = buildAll(base, prototypes);
+        check(ticks > 1, "the pool is built over several ticks");
+        checkLevels(daw.clipAudio[0], "stereo");
+        checkLevels(daw.clipAudio[1], "mono");
+        checkLevels(daw.clipAudio[2], "short");
+        checkQueries(daw.clipAudio[0], "stereo");
+        checkQueries(daw.clipAudio[1], "mono");
+
+        // Rebuilding a range in place leaves the pyramid unchanged.
+        const DawWaveformPyramid before = daw.clipAudio[0].waveform;
+        DawWaveformSystemLogic::UpdateClipWaveformRange(daw, daw.clipAudio[0], 500000, 1500001);
+        bool same = before.levels.size() == daw.clipAudio[0].waveform.levels.size();
+        for (size_t l = 0; same && l < before.levels.size(); ++l) {
+            const DawWaveformLevel& a = before.levels[l];
+            const DawWaveformLevel& b = daw.clipAudio[0].waveform.levels[l];
+            same = a.minL == b.minL && a.maxL == b.maxL && a.minR == b.minR && a.maxR == b.maxR
+                && a.rmsL == b.rmsL && a.rmsR == b.rmsR;
+        }
+        check(same, "rebuilding a range reproduces the same pyramid");
+    }
+
+    void benchmark() {
+        BaseSystem base;
+        std::vector<Entity> prototypes;
+        base.daw = std::make_unique<DawContext>();
+        DawContext& daw = *base.daw;
+        daw.sampleRate = 48000.0f;
+        const uint64_t frames = 10ull * 60ull * 48000ull;
+        daw.clipAudio.push_back(makeClip(frames, true, 3));
+
+        const auto buildStart = Clock::now();
+        double worstTickMs = 0.0;
+        int ticks = 0;
+        while (daw.clipAudio[0].waveform.builtFrames < frames) {
+            const auto tickStart = Clock::now();
+            DawWaveformSystemLogic::UpdateDawWaveforms(base, prototypes, 0.0f, nullptr);
+            worstTickMs = std::max(worstTickMs, std::chrono::duration<double, std::milli>(Clock::now() - tickStart).count());
+            ticks += 1;
+        }
+        const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+
+        // One lane redraw: a pixel column per query, at three zoom levels.
+        std::mt19937_64 rng(1);
+        DawWaveformSpan out;
+        float sink = 0.0f;
+        const auto queryStart = Clock::now();
+        int queries = 0;
+        for (uint64_t columnFrames : {uint64_t(64), uint64_t(4096), frames / 2000}) {
+            const uint64_t start = rng() % (frames - 2000 * columnFrames + 1);
+            for (int column = 0; column < 2000; ++column, ++queries) {
+                const uint64_t s = start + static_cast<uint64_t>(column) * columnFrames;
+                DawWaveformSystemLogic::QueryClipWaveform(daw.clipAudio[0], s, s + columnFrames, out);
+                sink += out.maxL - out.minL;
+            }
+        }
+        const double queryUs = std::chrono::duration<double, std::micro>(Clock::now() - queryStart).count();
+        std::printf("10-minute clip: built in %.1f ms over %d ticks (worst tick %.1f ms), "
+                    "%d column queries in %.1f us (%.3f us each)%s\n",
+                    buildMs, ticks, worstTickMs, queries, queryUs, queryUs / queries, sink < 0.0f ? " " : "");
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    if (!benchOnly) correctness();
+    benchmark();
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
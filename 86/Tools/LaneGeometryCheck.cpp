@@ -0,0 +1,1959 @@
+// Standalone checks and benchmark for the retained timeline lanes. Not part
+// of the game build:
+//
+//   g++ -std=c++17 -O2 -I. -I<glm include dir> Tools/LaneGeometryCheck.cpp -o lane_geometry_check
+//   ./lane_geometry_check [--bench-only]
+//
+// DawLaneResource and MidiLane keep their lanes in a LaneGeometry::Store
+// placed by UILane.vert.glsl. Its tick x, NDC and stereo waveform y are first
+// compared with the old double formulas over millions of random inputs; they
+// may differ only where the exact value sits on a rounding tie. The previous
+// immediate pass, which rebuilt every lane in NDC, is kept here verbatim for
+// audio and MIDI lanes (the ruler, grid and drag overlay are the same code on
+// both paths and left out). Random scenes -- screen sizes, lane rows with drag gaps and hidden lanes,
+// offsets past 2^24 samples, zoom from a few milliseconds to minutes,
+// selections, stereo clips, record previews, notes outside their clip,
+// rendered MIDI audio -- are drawn both ways through UIBatch::Builder and
+// rasterized with GL's fill rules: the old NDC vertices as written, the lane
+// layers from a buffer updated only with the store's dirty ranges and placed
+// as the shader places them. Each scene is then edited, scrolled and zoomed
+// for a few frames against the same retained state. Every frame must give
+// the same pixels and the same labels. Ends with a 64-track session (audio
+// and MIDI, ten clips a track) timed idle, scrolling, zooming and editing on
+// both paths, with the lane bytes each frame uploads. Exits nonzero if any
+// check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BaseSystem/LaneGeometry.h"
+#include "BaseSystem/UIBatch.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    constexpr size_t kWaveformBlockSize = 256;
+    constexpr double kSampleRate = 48000.0;
+    constexpr float kLaneAlpha = 0.85f;
+    constexpr float kTrackHandleSize = 60.0f;
+    constexpr float kTrackHandleInset = 12.0f;
+
+    // The parts of DawContext/MidiContext the lanes read.
+    struct Note {
+        int pitch = 60;
+        uint64_t startSample = 0;
+        uint64_t length = 0;
+    };
+
+    struct Clip {
+        uint64_t startSample = 0;
+        uint64_t length = 0;
+        uint64_t sourceOffset = 0;
+        int audioId = -1;
+        std::vector<Note> notes;
+    };
+
+    struct ClipAudio {
+        bool stereo = false;
+        uint64_t length = 0;
+        uint32_t seed = 0;
+        glm::vec3 color{0.3f};
+    };
+
+    struct WaveSpan {
+        float minL = 0.0f;
+        float maxL = 0.0f;
+        float minR = 0.0f;
+        float maxR = 0.0f;
+        glm::vec3 color{0.0f};
+    };
+
+    // Record preview blocks for audio tracks, rendered audio for MIDI tracks.
+    struct Track {
+        std::vector<Clip> clips;
+        uint64_t recordStartSample = 0;
+        uint64_t previewLength = 0;
+        std::vector<float> waveformMin;
+        std::vector<float> waveformMax;
+        std::vector<float> waveformMinRight;
+        std::vector<float> waveformMaxRight;
+        std::vector<glm::vec3> waveformColor;
+        uint64_t waveformVersion = 0;
+    };
+
+    struct Scene {
+        bool midi = false;
+        std::vector<Track> tracks;
+        std::vector<int> laneIndex;
+        std::vector<ClipAudio> clipAudio;
+        uint64_t clipWaveformVersion = 1;
+        int selectedClipTrack = -1;
+        int selectedClipIndex = -1;
+        double screenWidth = 1280.0;
+        double screenHeight = 800.0;
+        float laneLeft = 120.0f;
+        float laneRight = 1100.0f;
+        float laneHeight = 60.0f;
+        float laneHalfH = 30.0f;
+        float rowSpan = 72.0f;
+        float startY = 100.0f;
+        uint64_t offsetSamples = 0;
+        double secondsPerScreen = 10.0;
+        double bpm = 120.0;
+        int previewSlot = -1;
+        bool dragActive = false;
+        int dragLaneIndex = -1;
+        uint64_t themeRevision = 0;
+    };
+
+    uint64_t mix(uint64_t a, uint64_t b) {
+        uint64_t h = a * 0x9e3779b97f4a7c15ull ^ (b + 0x632be59bd9b4e019ull + (a << 6) + (a >> 2));
+        h ^= h >> 29;
+        h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 32;
+        return h;
+    }
+
+    float unit(uint64_t h) { return static_cast<float>(h & 0xffffu) / 65535.0f; }
+
+    // Stands in for DawWaveformSystemLogic::QueryClipWaveform: peaks that
+    // change with the source range and sometimes overshoot the lane.
+    bool queryClipWaveform(const ClipAudio& audio, uint64_t src0, uint64_t src1, WaveSpan& span) {
+        if (src0 >= audio.length) return false;
+        const uint64_t h = mix(mix(audio.seed, src0 / 61), src1 / 67);
+        span.minL = -1.3f * unit(h);
+        span.maxL = 1.3f * unit(h >> 16);
+        span.minR = -1.3f * unit(h >> 32);
+        span.maxR = 1.3f * unit(h >> 48);
+        span.color = audio.color;
+        return true;
+    }
+
+    // PianoRollResourceSystemLogic::NoteColor.
+    void noteColor(int noteIndex, float& r, float& g, float& b) {
+        switch (noteIndex) {
+            case 0:  r = 0.467f; g = 0.667f; b = 0.855f; break;
+            case 1:  r = 0.129f; g = 0.596f; b = 0.647f; break;
+            case 2:  r = 0.463f; g = 0.667f; b = 0.298f; break;
+            case 3:  r = 0.518f; g = 0.620f; b = 0.020f; break;
+            case 4:  r = 0.992f; g = 0.922f; b = 0.008f; break;
+            case 5:  r = 0.992f; g = 0.596f; b = 0.016f; break;
+            case 6:  r = 0.992f; g = 0.565f; b = 0.153f; break;
+            case 7:  r = 0.988f; g = 0.467f; b = 0.067f; break;
+            case 8:  r = 0.988f; g = 0.416f; b = 0.400f; break;
+            case 9:  r = 0.933f; g = 0.502f; b = 0.643f; break;
+            case 10: r = 0.510f; g = 0.282f; b = 0.694f; break;
+            case 11: r = 0.376f; g = 0.384f; b = 0.702f; break;
+            default: r = 0.75f; g = 0.85f; b = 0.9f; break;
+        }
+    }
+
+    // Where FontSystemLogic::AppendUiLabel was asked to put text. The glyph
+    // quads are fixed-size boxes; both paths lay them out with this.
+    struct LabelSpot {
+        float x = 0.0f;
+        float y = 0.0f;
+        std::string text;
+
+        bool operator==(const LabelSpot& other) const {
+            return x == other.x && y == other.y && text == other.text;
+        }
+    };
+
+    void appendLabel(UIBatch::TextOverlay& labels, std::vector<LabelSpot>& spots, size_t at, float x, float y,
+                     const char* text, double screenWidth, double screenHeight) {
+        // Labels of lanes wholly off screen are not compared.
+        if (y >= 0.0f && y - 8.0f <= static_cast<float>(screenHeight)) spots.push_back({x, y, text});
+        const size_t first = labels.vertices.size();
+        const uint32_t color = UIBatch::packColor(0.04f, 0.04f, 0.04f, 1.0f);
+        for (size_t i = 0; text[i] != '\0'; ++i) {
+            const double x0 = x + 6.0 * static_cast<double>(i);
+            const double corners[4][2] = {{x0, y - 8.0}, {x0 + 5.0, y - 8.0}, {x0 + 5.0, y}, {x0, y}};
+            const int order[6] = {0, 1, 2, 0, 2, 3};
+            for (int k : order) {
+                UIBatch::Vertex v;
+                v.x = static_cast<float>((corners[k][0] / screenWidth) * 2.0 - 1.0);
+                v.y = static_cast<float>(1.0 - (corners[k][1] / screenHeight) * 2.0);
+                v.color = color;
+                labels.vertices.push_back(v);
+            }
+        }
+        labels.mark(at, 1, first);
+    }
+
+    struct Palette {
+        glm::vec3 lane{0.14f, 0.14f, 0.14f};
+        glm::vec3 highlight{0.2f, 0.2f, 0.2f};
+        glm::vec3 shadow{0.08f, 0.08f, 0.08f};
+        glm::vec3 waveform{0.05f, 0.05f, 0.05f};
+        glm::vec3 clip{0.0f};
+        glm::vec3 clipLip{0.0f};
+        glm::vec3 selectedClip{0.0f};
+        glm::vec3 selectedClipLip{0.0f};
+    };
+
+    Palette palette(uint64_t themeRevision) {
+        Palette p;
+        if (themeRevision % 2 == 1) {
+            const glm::vec3 darkGray(0.25f, 0.22f, 0.27f);
+            p.lane = glm::clamp(darkGray + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
+            p.highlight = glm::clamp(darkGray + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+            p.shadow = glm::clamp(darkGray - glm::vec3(0.06f), glm::vec3(0.0f), glm::vec3(1.0f));
+            p.waveform = glm::clamp(darkGray - glm::vec3(0.2f), glm::vec3(0.0f), glm::vec3(1.0f));
+        }
+        p.clip = glm::clamp(p.highlight + glm::vec3(0.12f), glm::vec3(0.0f), glm::vec3(1.0f));
+        p.clipLip = glm::clamp(p.clip - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
+        p.selectedClip = glm::clamp(p.clip + glm::vec3(0.08f), glm::vec3(0.0f), glm::vec3(1.0f));
+        p.selectedClipLip = glm::clamp(p.selectedClip - glm::vec3(0.09f), glm::vec3(0.0f), glm::vec3(1.0f));
+        return p;
+    }
+
+    uint64_t beatStep(const Scene& scene) {
+        double bpmNow = scene.bpm;
+        if (bpmNow <= 0.0) bpmNow = 120.0;
+        return std::max<uint64_t>(1, static_cast<uint64_t>(std::llround((60.0 / bpmNow) * kSampleRate)));
+    }
+
+    LaneGeometry::Rows rowsOf(const Scene& scene) {
+        LaneGeometry::Rows rows;
+        rows.startY = scene.startY;
+        rows.rowSpan = scene.rowSpan;
+        rows.previewSlot = scene.previewSlot;
+        rows.previewingDrag = scene.previewSlot >= 0 && scene.dragActive && scene.dragLaneIndex >= 0;
+        rows.draggedLaneIndex = scene.dragLaneIndex;
+        return rows;
+    }
+
+    LaneGeometry::View viewOf(const Scene& scene) {
+        LaneGeometry::View view;
+        view.offsetSamples = static_cast<double>(scene.offsetSamples);
+        view.windowSamples = std::max(0.0, scene.secondsPerScreen * kSampleRate);
+        view.laneLeft = scene.laneLeft;
+        view.laneRight = scene.laneRight;
+        view.screenWidth = scene.screenWidth;
+        view.screenHeight = scene.screenHeight;
+        return view;
+    }
+
+    bool previewOf(const Track& track, uint64_t& previewStart, uint64_t& previewEnd) {
+        previewStart = track.recordStartSample;
+        previewEnd = track.recordStartSample + track.previewLength;
+        return previewEnd > previewStart && !track.waveformMin.empty()
+            && track.waveformMax.size() == track.waveformMin.size();
+    }
+
+    bool trackHasStereoClip(const Scene& scene, const Track& track) {
+        for (const auto& clip : track.clips) {
+            if (clip.audioId < 0 || clip.audioId >= static_cast<int>(scene.clipAudio.size())) continue;
+            if (scene.clipAudio[static_cast<size_t>(clip.audioId)].stereo) return true;
+        }
+        return false;
+    }
+
+    // DawLaneResource's and MidiLane's buildLanes before the lanes were
+    // retained, with the ruler and grid left out.
+    namespace Legacy {
+        struct UiVertex { glm::vec2 pos; glm::vec3 color; };
+
+        constexpr float kClipHorizontalPad = 2.0f;
+        constexpr float kClipVerticalInset = 0.0f;
+        constexpr float kClipMinHeight = 2.0f;
+        constexpr float kClipLipMinHeight = 6.0f;
+        constexpr float kClipLipMaxHeight = 12.0f;
+        constexpr int kPreviewBasePitch = 24;
+        constexpr int kPreviewRows = 84;
+
+        glm::vec2 pixelToNDC(const glm::vec2& pixel, double width, double height) {
+            float ndcX = static_cast<float>((pixel.x / width) * 2.0 - 1.0);
+            float ndcY = static_cast<float>(1.0 - (pixel.y / height) * 2.0);
+            return {ndcX, ndcY};
+        }
+
+        void pushQuad(std::vector<UiVertex>& verts,
+                      const glm::vec2& a,
+                      const glm::vec2& b,
+                      const glm::vec2& c,
+                      const glm::vec2& d,
+                      const glm::vec3& color) {
+            verts.push_back({a, color});
+            verts.push_back({b, color});
+            verts.push_back({c, color});
+            verts.push_back({a, color});
+            verts.push_back({c, color});
+            verts.push_back({d, color});
+        }
+
+        void computeClipRect(float centerY,
+                             float laneHalfH,
+                             float& top,
+                             float& bottom,
+                             float& lipBottom) {
+            top = centerY - laneHalfH + kClipVerticalInset;
+            bottom = centerY + laneHalfH - kClipVerticalInset;
+            if (bottom < top + kClipMinHeight) {
+                float mid = (top + bottom) * 0.5f;
+                top = mid - (kClipMinHeight * 0.5f);
+                bottom = mid + (kClipMinHeight * 0.5f);
+            }
+            float lipHeight = std::clamp((bottom - top) * 0.18f, kClipLipMinHeight, kClipLipMaxHeight);
+            lipBottom = std::min(bottom, top + lipHeight);
+        }
+
+        struct Output {
+            std::vector<UiVertex> vertices;
+            UIBatch::TextOverlay labels;
+            std::vector<LabelSpot> spots;
+        };
+
+        void buildLanes(const Scene& scene, Output& out) {
+            out.vertices.clear();
+            out.labels.clear();
+            out.spots.clear();
+            auto& vertices = out.vertices;
+            const int trackCount = static_cast<int>(scene.tracks.size());
+            const float laneLeft = scene.laneLeft;
+            const float laneRight = scene.laneRight;
+            const float laneHalfH = scene.laneHalfH;
+            const float rowSpan = scene.rowSpan;
+            const float startY = scene.startY;
+            const double screenWidth = scene.screenWidth;
+            const double screenHeight = scene.screenHeight;
+            const double secondsPerScreen = scene.secondsPerScreen;
+            const int previewSlot = scene.previewSlot;
+            const bool previewingLaneDrag = (previewSlot >= 0
+                && scene.dragActive
+                && scene.dragLaneIndex >= 0);
+            const int draggedLaneIndex = scene.dragLaneIndex;
+            auto computeDisplayIndex = [&](int laneIndex) -> int {
+                int displayIndex = laneIndex;
+                if (previewSlot < 0) return displayIndex;
+                if (previewingLaneDrag) {
+                    if (laneIndex == draggedLaneIndex) return -1;
+                    if (laneIndex > draggedLaneIndex) {
+                        displayIndex -= 1;
+                    }
+                }
+                if (displayIndex >= previewSlot) {
+                    displayIndex += 1;
+                }
+                return displayIndex;
+            };
+            const Palette p = palette(scene.themeRevision);
+            const glm::vec3 laneColor = p.lane;
+            const glm::vec3 laneHighlight = p.highlight;
+            const glm::vec3 laneShadow = p.shadow;
+            const glm::vec3 waveformBaseColor = p.waveform;
+
+            for (int t = 0; t < trackCount; ++t) {
+                int laneIndex = scene.laneIndex[static_cast<size_t>(t)];
+                if (laneIndex < 0) continue;
+                int displayIndex = computeDisplayIndex(laneIndex);
+                if (displayIndex < 0) continue;
+                float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
+                float top = centerY - laneHalfH;
+                float bottom = centerY + laneHalfH;
+
+                float bevelDepth = 6.0f;
+                glm::vec2 frontA(laneLeft, top);
+                glm::vec2 frontB(laneRight, top);
+                glm::vec2 frontC(laneRight, bottom);
+                glm::vec2 frontD(laneLeft, bottom);
+
+                glm::vec2 topA = frontA;
+                glm::vec2 topB = frontB;
+                glm::vec2 topC(frontB.x - bevelDepth, frontB.y - bevelDepth);
+                glm::vec2 topD(frontA.x - bevelDepth, frontA.y - bevelDepth);
+
+                glm::vec2 leftA = frontA;
+                glm::vec2 leftB = frontD;
+                glm::vec2 leftC(frontD.x - bevelDepth, frontD.y - bevelDepth);
+                glm::vec2 leftD(frontA.x - bevelDepth, frontA.y - bevelDepth);
+
+                pushQuad(vertices,
+                         pixelToNDC(frontA, screenWidth, screenHeight),
+                         pixelToNDC(frontB, screenWidth, screenHeight),
+                         pixelToNDC(frontC, screenWidth, screenHeight),
+                         pixelToNDC(frontD, screenWidth, screenHeight),
+                         laneColor);
+                pushQuad(vertices,
+                         pixelToNDC(topA, screenWidth, screenHeight),
+                         pixelToNDC(topB, screenWidth, screenHeight),
+                         pixelToNDC(topC, screenWidth, screenHeight),
+                         pixelToNDC(topD, screenWidth, screenHeight),
+                         laneHighlight);
+                pushQuad(vertices,
+                         pixelToNDC(leftA, screenWidth, screenHeight),
+                         pixelToNDC(leftB, screenWidth, screenHeight),
+                         pixelToNDC(leftC, screenWidth, screenHeight),
+                         pixelToNDC(leftD, screenWidth, screenHeight),
+                         laneShadow);
+            }
+
+            double offsetSamples = static_cast<double>(scene.offsetSamples);
+            double windowSamples = secondsPerScreen * kSampleRate;
+            if (windowSamples < 0.0) windowSamples = 0.0;
+            glm::vec3 clipColor = p.clip;
+            glm::vec3 clipLipColor = p.clipLip;
+            glm::vec3 selectedClipColor = p.selectedClip;
+            glm::vec3 selectedClipLipColor = p.selectedClipLip;
+            uint64_t beatStepSamples = beatStep(scene);
+            for (int t = 0; t < trackCount; ++t) {
+                const auto& clips = scene.tracks[static_cast<size_t>(t)].clips;
+                if (clips.empty()) continue;
+                int laneIndex = scene.laneIndex[static_cast<size_t>(t)];
+                if (laneIndex < 0) continue;
+                int displayIndex = computeDisplayIndex(laneIndex);
+                if (displayIndex < 0) continue;
+                float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
+                float top = 0.0f;
+                float bottom = 0.0f;
+                float lipBottom = 0.0f;
+                computeClipRect(centerY, laneHalfH, top, bottom, lipBottom);
+                for (size_t ci = 0; ci < clips.size(); ++ci) {
+                    const auto& clip = clips[ci];
+                    if (clip.length == 0) continue;
+                    bool selectedClip = (t == scene.selectedClipTrack) && (static_cast<int>(ci) == scene.selectedClipIndex);
+                    const glm::vec3& bodyColor = selectedClip ? selectedClipColor : clipColor;
+                    const glm::vec3& lipColor = selectedClip ? selectedClipLipColor : clipLipColor;
+                    double clipStart = static_cast<double>(clip.startSample);
+                    double clipEnd = static_cast<double>(clip.startSample + clip.length);
+                    if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) continue;
+                    double visibleStart = std::max(clipStart, offsetSamples);
+                    double visibleEnd = std::min(clipEnd, offsetSamples + windowSamples);
+                    float t0 = (windowSamples > 0.0)
+                        ? static_cast<float>((visibleStart - offsetSamples) / windowSamples)
+                        : 0.0f;
+                    float t1 = (windowSamples > 0.0)
+                        ? static_cast<float>((visibleEnd - offsetSamples) / windowSamples)
+                        : 0.0f;
+                    float x0 = laneLeft + (laneRight - laneLeft) * t0 - kClipHorizontalPad;
+                    float x1 = laneLeft + (laneRight - laneLeft) * t1 + kClipHorizontalPad;
+                    x0 = std::max(x0, laneLeft);
+                    x1 = std::min(x1, laneRight);
+                    if (x1 < laneLeft || x0 > laneRight) continue;
+                    glm::vec2 a(x0, top);
+                    glm::vec2 b(x1, top);
+                    glm::vec2 c(x1, bottom);
+                    glm::vec2 d(x0, bottom);
+                    pushQuad(vertices,
+                             pixelToNDC(a, screenWidth, screenHeight),
+                             pixelToNDC(b, screenWidth, screenHeight),
+                             pixelToNDC(c, screenWidth, screenHeight),
+                             pixelToNDC(d, screenWidth, screenHeight),
+                             bodyColor);
+                    if (lipBottom > top + 0.5f) {
+                        glm::vec2 la(x0, top);
+                        glm::vec2 lb(x1, top);
+                        glm::vec2 lc(x1, lipBottom);
+                        glm::vec2 ld(x0, lipBottom);
+                        pushQuad(vertices,
+                                 pixelToNDC(la, screenWidth, screenHeight),
+                                 pixelToNDC(lb, screenWidth, screenHeight),
+                                 pixelToNDC(lc, screenWidth, screenHeight),
+                                 pixelToNDC(ld, screenWidth, screenHeight),
+                                 lipColor);
+                    }
+                    if (beatStepSamples > 0 && x1 > x0 + 2.0f) {
+                        uint64_t visibleStartSample = static_cast<uint64_t>(std::max(visibleStart, 0.0));
+                        uint64_t visibleEndSample = static_cast<uint64_t>(std::max(visibleEnd, 0.0));
+                        if (visibleEndSample > visibleStartSample) {
+                            const uint64_t clipStartSample = clip.startSample;
+                            uint64_t tick = clipStartSample;
+                            if (visibleStartSample > clipStartSample) {
+                                uint64_t delta = visibleStartSample - clipStartSample;
+                                uint64_t steps = (delta + beatStepSamples - 1) / beatStepSamples;
+                                tick = clipStartSample + steps * beatStepSamples;
+                            }
+                            int guard = 0;
+                            float markerTop = lipBottom + 1.0f;
+                            float maxTickHeight = std::max(3.0f, bottom - markerTop - 2.0f);
+                            float beatTickHeight = std::clamp(maxTickHeight * 0.30f, 3.0f, 8.0f);
+                            float barTickHeight = std::clamp(maxTickHeight * 0.52f, 5.0f, 13.0f);
+                            float phraseTickHeight = std::clamp(maxTickHeight * 0.68f, 7.0f, 16.0f);
+                            float lastLabelX = -10000.0f;
+                            while (tick < visibleEndSample && guard < 512) {
+                                float tt = static_cast<float>((static_cast<double>(tick) - offsetSamples) / windowSamples);
+                                float x = laneLeft + (laneRight - laneLeft) * tt;
+                                x = std::clamp(x, x0 + 1.0f, x1 - 1.0f);
+                                uint64_t localBeat = (tick >= clipStartSample)
+                                    ? ((tick - clipStartSample) / beatStepSamples)
+                                    : 0;
+                                bool isBar = ((localBeat % 4ull) == 0ull);
+                                bool isPhrase = ((localBeat % 16ull) == 0ull);
+                                float lineHalf = isBar ? 0.9f : 0.45f;
+                                glm::vec3 lineColor = isBar ? glm::vec3(0.02f, 0.02f, 0.02f)
+                                                            : glm::vec3(0.06f, 0.06f, 0.06f);
+                                float markerBottom = markerTop + (isPhrase ? phraseTickHeight : (isBar ? barTickHeight : beatTickHeight));
+                                markerBottom = std::min(markerBottom, bottom - 1.0f);
+                                pushQuad(vertices,
+                                         pixelToNDC({x - lineHalf, markerTop}, screenWidth, screenHeight),
+                                         pixelToNDC({x + lineHalf, markerTop}, screenWidth, screenHeight),
+                                         pixelToNDC({x + lineHalf, markerBottom}, screenWidth, screenHeight),
+                                         pixelToNDC({x - lineHalf, markerBottom}, screenWidth, screenHeight),
+                                         lineColor);
+                                if ((x - lastLabelX) >= 46.0f
+                                    && (x + 30.0f) <= (x1 - 2.0f)
+                                    && (markerBottom + 10.0f) <= (bottom - 2.0f)) {
+                                    uint64_t barIndex = (localBeat / 4ull) + 1ull;
+                                    uint64_t beatInBar = (localBeat % 4ull) + 1ull;
+                                    char label[24];
+                                    std::snprintf(label, sizeof(label), "%llu.%llu.1",
+                                                  static_cast<unsigned long long>(barIndex),
+                                                  static_cast<unsigned long long>(beatInBar));
+                                    appendLabel(out.labels, out.spots, vertices.size(), x + 2.0f, markerBottom + 2.0f,
+                                                label, screenWidth, screenHeight);
+                                    lastLabelX = x;
+                                }
+                                tick += beatStepSamples;
+                                ++guard;
+                            }
+                        }
+                    }
+                }
+            }
+
+            float waveHeight = scene.laneHeight * 0.8f;
+            float ampScale = waveHeight * 0.5f;
+            int pixelWidth = static_cast<int>(laneRight - laneLeft);
+            if (!scene.midi && pixelWidth > 0 && windowSamples > 0.0) {
+                const double samplesPerPixel = windowSamples / static_cast<double>(pixelWidth);
+                for (int t = 0; t < trackCount; ++t) {
+                    const Track& track = scene.tracks[static_cast<size_t>(t)];
+                    uint64_t previewStart = 0;
+                    uint64_t previewEnd = 0;
+                    const bool hasPreview = previewOf(track, previewStart, previewEnd);
+                    if (track.clips.empty() && !hasPreview) continue;
+                    const bool hasRightWave = trackHasStereoClip(scene, track);
+                    int laneIndex = scene.laneIndex[static_cast<size_t>(t)];
+                    if (laneIndex < 0) continue;
+                    int displayIndex = computeDisplayIndex(laneIndex);
+                    if (displayIndex < 0) continue;
+                    float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
+                    float top = centerY - laneHalfH;
+                    float bottom = centerY + laneHalfH;
+                    if (hasRightWave) {
+                        const float splitY = 0.5f * (top + bottom);
+                        const float splitHalf = 0.5f;
+                        pushQuad(vertices,
+                                 pixelToNDC({laneLeft, splitY - splitHalf}, screenWidth, screenHeight),
+                                 pixelToNDC({laneRight, splitY - splitHalf}, screenWidth, screenHeight),
+                                 pixelToNDC({laneRight, splitY + splitHalf}, screenWidth, screenHeight),
+                                 pixelToNDC({laneLeft, splitY + splitHalf}, screenWidth, screenHeight),
+                                 glm::vec3(0.03f, 0.03f, 0.03f));
+                    }
+                    auto pushWaveColumn = [&](int x, float minVal, float maxVal, float minValR, float maxValR,
+                                              const glm::vec3& blockColor) {
+                        float yTop = centerY - maxVal * ampScale;
+                        float yBottom = centerY - minVal * ampScale;
+                        yTop = std::max(yTop, top);
+                        yBottom = std::min(yBottom, bottom);
+                        float xPos = laneLeft + static_cast<float>(x);
+                        float lineWidth = 1.0f;
+                        if (hasRightWave) {
+                            const float splitY = 0.5f * (top + bottom);
+                            const float regionGap = 1.0f;
+                            const float topRegionTop = top;
+                            const float topRegionBottom = splitY - regionGap;
+                            const float bottomRegionTop = splitY + regionGap;
+                            const float bottomRegionBottom = bottom;
+                            const float topCenter = 0.5f * (topRegionTop + topRegionBottom);
+                            const float bottomCenter = 0.5f * (bottomRegionTop + bottomRegionBottom);
+                            const float topAmp = std::max(1.0f, (topRegionBottom - topRegionTop) * 0.45f);
+                            const float bottomAmp = std::max(1.0f, (bottomRegionBottom - bottomRegionTop) * 0.45f);
+
+                            float yTopL = topCenter - maxVal * topAmp;
+                            float yBottomL = topCenter - minVal * topAmp;
+                            yTopL = std::clamp(yTopL, topRegionTop, topRegionBottom);
+                            yBottomL = std::clamp(yBottomL, topRegionTop, topRegionBottom);
+                            pushQuad(vertices,
+                                     pixelToNDC({xPos - lineWidth, yTopL}, screenWidth, screenHeight),
+                                     pixelToNDC({xPos + lineWidth, yTopL}, screenWidth, screenHeight),
+                                     pixelToNDC({xPos + lineWidth, yBottomL}, screenWidth, screenHeight),
+                                     pixelToNDC({xPos - lineWidth, yBottomL}, screenWidth, screenHeight),
+                                     blockColor);
+
+                            float yTopR = bottomCenter - maxValR * bottomAmp;
+                            float yBottomR = bottomCenter - minValR * bottomAmp;
+                            yTopR = std::clamp(yTopR, bottomRegionTop, bottomRegionBottom);
+                            yBottomR = std::clamp(yBottomR, bottomRegionTop, bottomRegionBottom);
+                            glm::vec3 rightColor = glm::clamp(blockColor + glm::vec3(0.16f, 0.04f, 0.08f),
+                                                              glm::vec3(0.0f), glm::vec3(1.0f));
+                            pushQuad(vertices,
+                                     pixelToNDC({xPos - lineWidth, yTopR}, screenWidth, screenHeight),
+                                     pixelToNDC({xPos + lineWidth, yTopR}, screenWidth, screenHeight),
+                                     pixelToNDC({xPos + lineWidth, yBottomR}, screenWidth, screenHeight),
+                                     pixelToNDC({xPos - lineWidth, yBottomR}, screenWidth, screenHeight),
+                                     rightColor);
+                        } else {
+                            glm::vec2 a(xPos - lineWidth, yTop);
+                            glm::vec2 b(xPos + lineWidth, yTop);
+                            glm::vec2 c(xPos + lineWidth, yBottom);
+                            glm::vec2 d(xPos - lineWidth, yBottom);
+                            pushQuad(vertices,
+                                     pixelToNDC(a, screenWidth, screenHeight),
+                                     pixelToNDC(b, screenWidth, screenHeight),
+                                     pixelToNDC(c, screenWidth, screenHeight),
+                                     pixelToNDC(d, screenWidth, screenHeight),
+                                     blockColor);
+                        }
+                    };
+
+                    for (const auto& clip : track.clips) {
+                        if (clip.length == 0) continue;
+                        if (clip.audioId < 0 || clip.audioId >= static_cast<int>(scene.clipAudio.size())) continue;
+                        const ClipAudio& clipAudio = scene.clipAudio[static_cast<size_t>(clip.audioId)];
+                        const double clipStart = static_cast<double>(clip.startSample);
+                        const double clipEnd = static_cast<double>(clip.startSample + clip.length);
+                        if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) continue;
+                        const int xBegin = std::max(0, static_cast<int>(std::floor((clipStart - offsetSamples) / samplesPerPixel)));
+                        const int xEnd = std::min(pixelWidth, static_cast<int>(std::ceil((clipEnd - offsetSamples) / samplesPerPixel)));
+                        for (int x = xBegin; x < xEnd; ++x) {
+                            const double s0 = std::max(clipStart, offsetSamples + static_cast<double>(x) * samplesPerPixel);
+                            const double s1 = std::min(clipEnd, offsetSamples + static_cast<double>(x + 1) * samplesPerPixel);
+                            if (s1 <= s0) continue;
+                            const uint64_t src0 = clip.sourceOffset + static_cast<uint64_t>(s0 - clipStart);
+                            const uint64_t src1 = std::max(src0 + 1, clip.sourceOffset + static_cast<uint64_t>(std::ceil(s1 - clipStart)));
+                            WaveSpan span;
+                            if (!queryClipWaveform(clipAudio, src0, src1, span)) continue;
+                            pushWaveColumn(x, span.minL, span.maxL, span.minR, span.maxR, span.color);
+                        }
+                    }
+
+                    if (hasPreview) {
+                        const size_t blockCount = track.waveformMin.size();
+                        const bool previewRight = (track.waveformMinRight.size() == blockCount)
+                            && (track.waveformMaxRight.size() == blockCount);
+                        for (int x = 0; x < pixelWidth; ++x) {
+                            double samplePos = offsetSamples + static_cast<double>(x) * samplesPerPixel;
+                            if (samplePos < static_cast<double>(previewStart) || samplePos >= static_cast<double>(previewEnd)) continue;
+                            size_t idx = static_cast<size_t>(samplePos) / kWaveformBlockSize;
+                            if (idx >= blockCount) continue;
+                            const float minVal = track.waveformMin[idx];
+                            const float maxVal = track.waveformMax[idx];
+                            pushWaveColumn(x,
+                                           minVal,
+                                           maxVal,
+                                           previewRight ? track.waveformMinRight[idx] : minVal,
+                                           previewRight ? track.waveformMaxRight[idx] : maxVal,
+                                           waveformBaseColor);
+                        }
+                    }
+                }
+            }
+
+            if (scene.midi && pixelWidth > 0) {
+                for (int t = 0; t < trackCount; ++t) {
+                    const Track& track = scene.tracks[static_cast<size_t>(t)];
+                    if (track.waveformMin.empty()) continue;
+                    size_t blockCount = track.waveformMin.size();
+                    if (blockCount == 0) continue;
+                    int laneIndex = scene.laneIndex[static_cast<size_t>(t)];
+                    if (laneIndex < 0) continue;
+                    int displayIndex = computeDisplayIndex(laneIndex);
+                    if (displayIndex < 0) continue;
+                    float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
+                    float top = centerY - laneHalfH;
+                    float bottom = centerY + laneHalfH;
+                    for (int px = 0; px < pixelWidth; ++px) {
+                        double t0 = static_cast<double>(px) / static_cast<double>(pixelWidth);
+                        double t1 = static_cast<double>(px + 1) / static_cast<double>(pixelWidth);
+                        double s0 = offsetSamples + t0 * windowSamples;
+                        double s1 = offsetSamples + t1 * windowSamples;
+                        size_t block0 = static_cast<size_t>(s0 / static_cast<double>(kWaveformBlockSize));
+                        size_t block1 = static_cast<size_t>(s1 / static_cast<double>(kWaveformBlockSize));
+                        if (block0 >= blockCount) continue;
+                        block1 = std::min(block1, blockCount - 1);
+
+                        float minVal = 0.0f;
+                        float maxVal = 0.0f;
+                        glm::vec3 color = waveformBaseColor;
+                        bool init = false;
+                        for (size_t b = block0; b <= block1; ++b) {
+                            float minB = track.waveformMin[b];
+                            float maxB = track.waveformMax[b];
+                            if (!init) {
+                                minVal = minB;
+                                maxVal = maxB;
+                                color = track.waveformColor[b];
+                                init = true;
+                            } else {
+                                minVal = std::min(minVal, minB);
+                                maxVal = std::max(maxVal, maxB);
+                                color = (color + track.waveformColor[b]) * 0.5f;
+                            }
+                        }
+                        if (!init) continue;
+                        float x = laneLeft + static_cast<float>(px);
+                        float yCenter = centerY;
+                        float yMin = yCenter + minVal * ampScale;
+                        float yMax = yCenter + maxVal * ampScale;
+                        if (yMax < yMin) std::swap(yMax, yMin);
+                        yMin = std::clamp(yMin, top, bottom);
+                        yMax = std::clamp(yMax, top, bottom);
+                        glm::vec2 a(x, yMin);
+                        glm::vec2 b(x + 1.0f, yMin);
+                        glm::vec2 c(x + 1.0f, yMax);
+                        glm::vec2 d(x, yMax);
+                        pushQuad(vertices,
+                                 pixelToNDC(a, screenWidth, screenHeight),
+                                 pixelToNDC(b, screenWidth, screenHeight),
+                                 pixelToNDC(c, screenWidth, screenHeight),
+                                 pixelToNDC(d, screenWidth, screenHeight),
+                                 color);
+                    }
+                }
+
+                for (int t = 0; t < trackCount; ++t) {
+                    const auto& clips = scene.tracks[static_cast<size_t>(t)].clips;
+                    if (clips.empty()) continue;
+                    int laneIndex = scene.laneIndex[static_cast<size_t>(t)];
+                    if (laneIndex < 0) continue;
+                    int displayIndex = computeDisplayIndex(laneIndex);
+                    if (displayIndex < 0) continue;
+                    float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
+                    float top = 0.0f;
+                    float bottom = 0.0f;
+                    float lipBottom = 0.0f;
+                    computeClipRect(centerY, laneHalfH, top, bottom, lipBottom);
+                    float noteTop = std::min(bottom, lipBottom + 1.0f);
+                    float noteBottom = std::max(noteTop + 1.0f, bottom - 1.0f);
+                    float noteHeight = noteBottom - noteTop;
+                    if (noteHeight <= 0.5f) continue;
+
+                    for (const auto& clip : clips) {
+                        if (clip.length == 0 || clip.notes.empty()) continue;
+                        double clipStart = static_cast<double>(clip.startSample);
+                        double clipEnd = static_cast<double>(clip.startSample + clip.length);
+                        if (clipEnd <= offsetSamples || clipStart >= offsetSamples + windowSamples) continue;
+                        double clipVisibleStart = std::max(clipStart, offsetSamples);
+                        double clipVisibleEnd = std::min(clipEnd, offsetSamples + windowSamples);
+                        float clipT0 = static_cast<float>((clipVisibleStart - offsetSamples) / windowSamples);
+                        float clipT1 = static_cast<float>((clipVisibleEnd - offsetSamples) / windowSamples);
+                        float clipX0 = laneLeft + (laneRight - laneLeft) * clipT0;
+                        float clipX1 = laneLeft + (laneRight - laneLeft) * clipT1;
+                        clipX0 = std::max(clipX0, laneLeft);
+                        clipX1 = std::min(clipX1, laneRight);
+                        if (clipX1 <= clipX0) continue;
+
+                        for (const auto& note : clip.notes) {
+                            if (note.length == 0) continue;
+                            double noteStart = static_cast<double>(clip.startSample + note.startSample);
+                            double noteEnd = noteStart + static_cast<double>(note.length);
+                            if (noteEnd <= offsetSamples || noteStart >= offsetSamples + windowSamples) continue;
+                            double noteVisibleStart = std::max(noteStart, offsetSamples);
+                            double noteVisibleEnd = std::min(noteEnd, offsetSamples + windowSamples);
+                            float noteT0 = static_cast<float>((noteVisibleStart - offsetSamples) / windowSamples);
+                            float noteT1 = static_cast<float>((noteVisibleEnd - offsetSamples) / windowSamples);
+                            float x0 = laneLeft + (laneRight - laneLeft) * noteT0;
+                            float x1 = laneLeft + (laneRight - laneLeft) * noteT1;
+                            x0 = std::clamp(x0, clipX0 + 1.0f, clipX1 - 1.0f);
+                            x1 = std::clamp(x1, clipX0 + 1.0f, clipX1 - 1.0f);
+                            if (x1 <= x0 + 0.5f) continue;
+
+                            int row = std::clamp(note.pitch - kPreviewBasePitch, 0, kPreviewRows - 1);
+                            float rowT0 = static_cast<float>(row) / static_cast<float>(kPreviewRows);
+                            float rowT1 = static_cast<float>(row + 1) / static_cast<float>(kPreviewRows);
+                            float y0 = noteBottom - rowT1 * noteHeight;
+                            float y1 = noteBottom - rowT0 * noteHeight;
+                            if (y1 < y0 + 1.0f) y1 = y0 + 1.0f;
+                            if (y0 < noteTop) y0 = noteTop;
+                            if (y1 > noteBottom) y1 = noteBottom;
+                            if (y1 <= y0) continue;
+
+                            int noteIndex = note.pitch % 12;
+                            if (noteIndex < 0) noteIndex += 12;
+                            float nr = 0.75f, ng = 0.85f, nb = 0.9f;
+                            noteColor(noteIndex, nr, ng, nb);
+                            glm::vec3 noteColor(nr, ng, nb);
+                            pushQuad(vertices,
+                                     pixelToNDC({x0, y0}, screenWidth, screenHeight),
+                                     pixelToNDC({x1, y0}, screenWidth, screenHeight),
+                                     pixelToNDC({x1, y1}, screenWidth, screenHeight),
+                                     pixelToNDC({x0, y1}, screenWidth, screenHeight),
+                                     noteColor);
+                        }
+                    }
+                }
+            }
+
+            {
+                float handleSize = std::min(kTrackHandleSize, std::max(14.0f, scene.laneHeight));
+                float handleHalf = handleSize * 0.5f;
+                float handleCenterX = laneRight + kTrackHandleInset + handleHalf;
+                float minCenterX = laneLeft + 4.0f + handleHalf;
+                if (handleCenterX < minCenterX) handleCenterX = minCenterX;
+                glm::vec3 handleFront = glm::clamp(laneColor + glm::vec3(0.03f), glm::vec3(0.0f), glm::vec3(1.0f));
+                glm::vec3 handleTop = glm::clamp(laneHighlight + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
+                glm::vec3 handleSide = laneShadow;
+                float handleDepth = std::min(6.0f, handleHalf * 0.5f);
+                for (int t = 0; t < trackCount; ++t) {
+                    int laneIndex = scene.laneIndex[static_cast<size_t>(t)];
+                    if (laneIndex < 0) continue;
+                    int displayIndex = computeDisplayIndex(laneIndex);
+                    if (displayIndex < 0) continue;
+                    float centerY = startY + static_cast<float>(displayIndex) * rowSpan;
+                    float top = centerY - handleHalf;
+                    float bottom = centerY + handleHalf;
+                    glm::vec2 frontA(handleCenterX - handleHalf, top);
+                    glm::vec2 frontB(handleCenterX + handleHalf, top);
+                    glm::vec2 frontC(handleCenterX + handleHalf, bottom);
+                    glm::vec2 frontD(handleCenterX - handleHalf, bottom);
+                    glm::vec2 topA = frontA;
+                    glm::vec2 topB = frontB;
+                    glm::vec2 topC(frontB.x - handleDepth, frontB.y - handleDepth);
+                    glm::vec2 topD(frontA.x - handleDepth, frontA.y - handleDepth);
+                    glm::vec2 leftA = frontA;
+                    glm::vec2 leftB = frontD;
+                    glm::vec2 leftC(frontD.x - handleDepth, frontD.y - handleDepth);
+                    glm::vec2 leftD(frontA.x - handleDepth, frontA.y - handleDepth);
+                    pushQuad(vertices,
+                             pixelToNDC(frontA, screenWidth, screenHeight),
+                             pixelToNDC(frontB, screenWidth, screenHeight),
+                             pixelToNDC(frontC, screenWidth, screenHeight),
+                             pixelToNDC(frontD, screenWidth, screenHeight),
+                             handleFront);
+                    pushQuad(vertices,
+                             pixelToNDC(topA, screenWidth, screenHeight),
+                             pixelToNDC(topB, screenWidth, screenHeight),
+                             pixelToNDC(topC, screenWidth, screenHeight),
+                             pixelToNDC(topD, screenWidth, screenHeight),
+                             handleTop);
+                    pushQuad(vertices,
+                             pixelToNDC(leftA, screenWidth, screenHeight),
+                             pixelToNDC(leftB, screenWidth, screenHeight),
+                             pixelToNDC(leftC, screenWidth, screenHeight),
+                             pixelToNDC(leftD, screenWidth, screenHeight),
+                             handleSide);
+                }
+            }
+        }
+    }
+
+    // DawLaneResource's and MidiLane's retained lanes: the same segments,
+    // keys, plan order and transform, over the scene model above.
+    class Retained {
+    public:
+        struct Writes {
+            uint64_t backgrounds = 0;
+            uint64_t handles = 0;
+            uint64_t bodies = 0;
+            uint64_t notes = 0;
+            uint64_t waves = 0;
+
+            uint64_t total() const { return backgrounds + handles + bodies + notes + waves; }
+        };
+
+        LaneGeometry::Store store;
+        Writes writes;
+        std::vector<LabelSpot> spots;
+
+        void update(const Scene& scene) {
+            const LaneGeometry::Rows rows = rowsOf(scene);
+            const LaneGeometry::View view = viewOf(scene);
+            const Palette p = palette(scene.themeRevision);
+            refreshGeometry(scene, rows, view, p);
+            store.transform.setView(view);
+            placeLanes(scene, rows);
+
+            LaneGeometry::Key composeKey;
+            composeKey.addReal(scene.screenWidth).addReal(scene.screenHeight)
+                .addReal(view.offsetSamples).addReal(view.windowSamples)
+                .addReal(scene.laneLeft).addReal(scene.laneRight).addReal(scene.laneHalfH)
+                .addReal(scene.startY).addReal(scene.rowSpan)
+                .add(static_cast<uint64_t>(scene.tracks.size()))
+                .add(static_cast<uint64_t>(rows.previewSlot + 1)).add(rows.previewingDrag ? 1u : 0u)
+                .add(static_cast<uint64_t>(rows.draggedLaneIndex + 1)).addReal(scene.bpm).add(scene.themeRevision);
+            for (int laneIndex : scene.laneIndex) composeKey.add(static_cast<uint64_t>(laneIndex + 1));
+            if (!composed || composeKey.value() != composedKey || store.revision() != composedRevision) {
+                composeLanes(scene, rows, view);
+                composedKey = composeKey.value();
+                composedRevision = store.revision();
+                composed = true;
+            }
+        }
+
+        void submit(UIBatch::Builder& batch, float alpha) {
+            store.transform.setAlpha(alpha);
+            plan.submit(batch, store);
+        }
+
+    private:
+        struct ClipGeometry {
+            LaneGeometry::Segment body;
+            LaneGeometry::ClipLayout layout;
+            LaneGeometry::Segment notes;
+        };
+
+        struct TrackGeometry {
+            std::vector<ClipGeometry> clips;
+            LaneGeometry::Segment background;
+            LaneGeometry::Segment handle;
+            LaneGeometry::Segment wave;
+            bool hasRightWave = false;
+        };
+
+        LaneGeometry::Plan plan;
+        std::vector<LaneGeometry::Vertex> scratch;
+        std::vector<TrackGeometry> tracks;
+        uint64_t composedKey = 0;
+        uint64_t composedRevision = 0;
+        bool composed = false;
+
+        static uint32_t packRgb(const glm::vec3& color) {
+            return UIBatch::packColor(color.r, color.g, color.b, 0.0f);
+        }
+
+        void releaseTrack(TrackGeometry& geometry) {
+            for (ClipGeometry& clip : geometry.clips) {
+                store.release(clip.body.id);
+                store.release(clip.notes.id);
+            }
+            store.release(geometry.background.id);
+            store.release(geometry.handle.id);
+            store.release(geometry.wave.id);
+        }
+
+        void buildBackground(TrackGeometry& geometry, uint32_t lane, const Scene& scene, const Palette& p) {
+            const uint64_t key = LaneGeometry::Key()
+                .addReal(scene.laneLeft).addReal(scene.laneRight).addReal(scene.laneHalfH)
+                .add(scene.themeRevision).value();
+            if (!geometry.background.rebuild(key)) return;
+            scratch.clear();
+            LaneGeometry::pushBevelBox(scratch, lane, scene.laneLeft, scene.laneHalfH, scene.laneRight, 6.0f,
+                                       packRgb(p.lane), packRgb(p.highlight), packRgb(p.shadow));
+            store.write(geometry.background.id, scratch);
+            writes.backgrounds += 1;
+        }
+
+        void buildHandle(TrackGeometry& geometry, uint32_t lane, const Scene& scene, const Palette& p) {
+            const uint64_t key = LaneGeometry::Key()
+                .addReal(scene.laneLeft).addReal(scene.laneRight).addReal(scene.laneHeight)
+                .add(scene.themeRevision).value();
+            if (!geometry.handle.rebuild(key)) return;
+            float handleSize = std::min(kTrackHandleSize, std::max(14.0f, scene.laneHeight));
+            float handleHalf = handleSize * 0.5f;
+            float handleCenterX = scene.laneRight + kTrackHandleInset + handleHalf;
+            float minCenterX = scene.laneLeft + 4.0f + handleHalf;
+            if (handleCenterX < minCenterX) handleCenterX = minCenterX;
+            glm::vec3 handleFront = glm::clamp(p.lane + glm::vec3(0.03f), glm::vec3(0.0f), glm::vec3(1.0f));
+            glm::vec3 handleTop = glm::clamp(p.highlight + glm::vec3(0.02f), glm::vec3(0.0f), glm::vec3(1.0f));
+            float handleDepth = std::min(6.0f, handleHalf * 0.5f);
+            scratch.clear();
+            LaneGeometry::pushBevelBox(scratch, lane, handleCenterX - handleHalf, handleHalf,
+                                       handleCenterX + handleHalf, handleDepth,
+                                       packRgb(handleFront), packRgb(handleTop), packRgb(p.shadow));
+            store.write(geometry.handle.id, scratch);
+            writes.handles += 1;
+        }
+
+        void buildClipBody(ClipGeometry& geometry, uint32_t lane, const Clip& clip, bool selected, const Palette& p,
+                           float laneHalfH, uint64_t beatStepSamples, uint64_t themeRevision) {
+            const uint64_t key = LaneGeometry::Key()
+                .add(clip.startSample).add(clip.length).add(selected ? 1u : 0u)
+                .add(beatStepSamples).addReal(laneHalfH).add(themeRevision).value();
+            if (!geometry.body.rebuild(key)) return;
+            const glm::vec3& bodyColor = selected ? p.selectedClip : p.clip;
+            const glm::vec3& lipColor = selected ? p.selectedClipLip : p.clipLip;
+            scratch.clear();
+            geometry.layout = LaneGeometry::pushClip(scratch, lane, laneHalfH, clip.startSample, clip.length,
+                                                     beatStepSamples, packRgb(bodyColor), packRgb(lipColor));
+            store.write(geometry.body.id, scratch);
+            writes.bodies += 1;
+        }
+
+        void buildClipNotes(ClipGeometry& geometry, uint32_t lane, const Clip& clip, float laneHalfH) {
+            LaneGeometry::Key key;
+            key.add(clip.startSample).add(clip.length).addReal(laneHalfH)
+                .add(static_cast<uint64_t>(clip.notes.size()));
+            for (const auto& note : clip.notes) {
+                key.add(static_cast<uint64_t>(note.pitch + 256)).add(note.startSample).add(note.length);
+            }
+            if (!geometry.notes.rebuild(key.value())) return;
+            scratch.clear();
+            LaneGeometry::pushNotes(scratch, lane, laneHalfH, clip.startSample, clip.length, clip.notes,
+                                    [](int pitch) {
+                                        int noteIndex = pitch % 12;
+                                        if (noteIndex < 0) noteIndex += 12;
+                                        float nr = 0.75f, ng = 0.85f, nb = 0.9f;
+                                        noteColor(noteIndex, nr, ng, nb);
+                                        return UIBatch::packColor(nr, ng, nb, 0.0f);
+                                    });
+            store.write(geometry.notes.id, scratch);
+            writes.notes += 1;
+        }
+
+        void buildAudioWave(TrackGeometry& geometry, uint32_t lane, const Scene& scene, const Track& track,
+                            const LaneGeometry::View& view, const Palette& p, float laneHalfH, float ampScale) {
+            uint64_t previewStart = 0;
+            uint64_t previewEnd = 0;
+            const bool hasPreview = previewOf(track, previewStart, previewEnd);
+            const bool hasRightWave = geometry.hasRightWave;
+            LaneGeometry::Key key;
+            key.addReal(view.offsetSamples).addReal(view.windowSamples).addReal(view.laneLeft).addReal(view.laneRight)
+                .addReal(laneHalfH).addReal(ampScale).add(hasRightWave ? 1u : 0u).add(scene.clipWaveformVersion)
+                .add(static_cast<uint64_t>(track.clips.size()));
+            for (const auto& clip : track.clips) {
+                key.add(static_cast<uint64_t>(clip.audioId + 1)).add(clip.startSample).add(clip.length).add(clip.sourceOffset);
+            }
+            key.add(hasPreview ? 1u : 0u);
+            if (hasPreview) {
+                key.add(track.waveformVersion).add(previewStart).add(previewEnd)
+                    .add(static_cast<uint64_t>(track.waveformMin.size())).add(scene.themeRevision);
+            }
+            if (!geometry.wave.rebuild(key.value())) return;
+            writes.waves += 1;
+            scratch.clear();
+            auto& out = scratch;
+            if ((track.clips.empty() && !hasPreview) || static_cast<int>(view.laneRight - view.laneLeft) <= 0
+                || view.windowSamples <= 0.0) {
+                store.write(geometry.wave.id, scratch);
+                return;
+            }
+            if (hasRightWave) {
+                LaneGeometry::pushSplit(out, lane, view.laneLeft, view.laneRight, packRgb(glm::vec3(0.03f, 0.03f, 0.03f)));
+            }
+            auto pushColumn = [&](int x, float minVal, float maxVal, float minValR, float maxValR,
+                                  const glm::vec3& blockColor) {
+                glm::vec3 rightColor = glm::clamp(blockColor + glm::vec3(0.16f, 0.04f, 0.08f),
+                                                  glm::vec3(0.0f), glm::vec3(1.0f));
+                LaneGeometry::pushWaveColumn(out, lane, view.laneLeft + static_cast<float>(x), laneHalfH, ampScale,
+                                             hasRightWave, minVal, maxVal, minValR, maxValR,
+                                             packRgb(blockColor), packRgb(rightColor));
+            };
+            for (const auto& clip : track.clips) {
+                if (clip.audioId < 0 || clip.audioId >= static_cast<int>(scene.clipAudio.size())) continue;
+                const ClipAudio& clipAudio = scene.clipAudio[static_cast<size_t>(clip.audioId)];
+                const double clipStart = static_cast<double>(clip.startSample);
+                LaneGeometry::clipColumns(view, clip.startSample, clip.length, [&](int x, double s0, double s1) {
+                    const uint64_t src0 = clip.sourceOffset + static_cast<uint64_t>(s0 - clipStart);
+                    const uint64_t src1 = std::max(src0 + 1, clip.sourceOffset + static_cast<uint64_t>(std::ceil(s1 - clipStart)));
+                    WaveSpan span;
+                    if (!queryClipWaveform(clipAudio, src0, src1, span)) return;
+                    pushColumn(x, span.minL, span.maxL, span.minR, span.maxR, span.color);
+                });
+            }
+            if (hasPreview) {
+                const size_t blockCount = track.waveformMin.size();
+                const bool previewRight = (track.waveformMinRight.size() == blockCount)
+                    && (track.waveformMaxRight.size() == blockCount);
+                LaneGeometry::previewColumns(view, previewStart, previewEnd, [&](int x, double samplePos) {
+                    size_t idx = static_cast<size_t>(samplePos) / kWaveformBlockSize;
+                    if (idx >= blockCount) return;
+                    const float minVal = track.waveformMin[idx];
+                    const float maxVal = track.waveformMax[idx];
+                    pushColumn(x,
+                               minVal,
+                               maxVal,
+                               previewRight ? track.waveformMinRight[idx] : minVal,
+                               previewRight ? track.waveformMaxRight[idx] : maxVal,
+                               p.waveform);
+                });
+            }
+            store.write(geometry.wave.id, scratch);
+        }
+
+        void buildMidiWave(TrackGeometry& geometry, uint32_t lane, const Track& track, const LaneGeometry::View& view,
+                           float laneHalfH, float ampScale) {
+            const size_t blockCount = track.waveformMin.size();
+            const uint64_t key = LaneGeometry::Key()
+                .addReal(view.offsetSamples).addReal(view.windowSamples).addReal(view.laneLeft).addReal(view.laneRight)
+                .add(track.waveformVersion).add(static_cast<uint64_t>(blockCount))
+                .addReal(laneHalfH).addReal(ampScale).value();
+            if (!geometry.wave.rebuild(key)) return;
+            writes.waves += 1;
+            scratch.clear();
+            if (blockCount > 0 && track.waveformMax.size() >= blockCount && track.waveformColor.size() >= blockCount) {
+                LaneGeometry::trackColumns(view, [&](int px, double s0, double s1) {
+                    size_t block0 = static_cast<size_t>(s0 / static_cast<double>(kWaveformBlockSize));
+                    size_t block1 = static_cast<size_t>(s1 / static_cast<double>(kWaveformBlockSize));
+                    if (block0 >= blockCount) return;
+                    block1 = std::min(block1, blockCount - 1);
+                    float minVal = track.waveformMin[block0];
+                    float maxVal = track.waveformMax[block0];
+                    glm::vec3 color = track.waveformColor[block0];
+                    for (size_t b = block0 + 1; b <= block1; ++b) {
+                        minVal = std::min(minVal, track.waveformMin[b]);
+                        maxVal = std::max(maxVal, track.waveformMax[b]);
+                        color = (color + track.waveformColor[b]) * 0.5f;
+                    }
+                    LaneGeometry::pushTrackWaveColumn(scratch, lane, view.laneLeft + static_cast<float>(px),
+                                                      laneHalfH, ampScale, minVal, maxVal, packRgb(color));
+                });
+            }
+            store.write(geometry.wave.id, scratch);
+        }
+
+        void refreshGeometry(const Scene& scene, const LaneGeometry::Rows& rows, const LaneGeometry::View& view,
+                             const Palette& p) {
+            const size_t trackCount = scene.tracks.size();
+            if (tracks.size() != trackCount) {
+                for (size_t t = trackCount; t < tracks.size(); ++t) releaseTrack(tracks[t]);
+                tracks.resize(trackCount);
+            }
+            const uint64_t beatStepSamples = beatStep(scene);
+            const float ampScale = scene.laneHeight * 0.8f * 0.5f;
+            for (size_t t = 0; t < trackCount; ++t) {
+                int laneIndex = scene.laneIndex[t];
+                if (laneIndex < 0) continue;
+                int displayIndex = rows.displayIndex(laneIndex);
+                if (displayIndex < 0) continue;
+                if (!rows.onScreen(rows.centerY(displayIndex), scene.screenHeight)) continue;
+                const Track& track = scene.tracks[t];
+                TrackGeometry& geometry = tracks[t];
+                const uint32_t lane = static_cast<uint32_t>(t);
+                geometry.hasRightWave = !scene.midi && trackHasStereoClip(scene, track);
+                buildBackground(geometry, lane, scene, p);
+                buildHandle(geometry, lane, scene, p);
+                if (geometry.clips.size() != track.clips.size()) {
+                    for (size_t ci = track.clips.size(); ci < geometry.clips.size(); ++ci) {
+                        store.release(geometry.clips[ci].body.id);
+                        store.release(geometry.clips[ci].notes.id);
+                    }
+                    geometry.clips.resize(track.clips.size());
+                }
+                for (size_t ci = 0; ci < track.clips.size(); ++ci) {
+                    const bool selected = static_cast<int>(t) == scene.selectedClipTrack
+                        && static_cast<int>(ci) == scene.selectedClipIndex;
+                    buildClipBody(geometry.clips[ci], lane, track.clips[ci], selected, p, scene.laneHalfH,
+                                  beatStepSamples, scene.themeRevision);
+                    if (scene.midi) buildClipNotes(geometry.clips[ci], lane, track.clips[ci], scene.laneHalfH);
+                }
+                if (scene.midi) {
+                    buildMidiWave(geometry, lane, track, view, scene.laneHalfH, ampScale);
+                } else {
+                    buildAudioWave(geometry, lane, scene, track, view, p, scene.laneHalfH, ampScale);
+                }
+            }
+        }
+
+        void composeLanes(const Scene& scene, const LaneGeometry::Rows& rows, const LaneGeometry::View& view) {
+            plan.clear();
+            spots.clear();
+            const int trackCount = static_cast<int>(scene.tracks.size());
+            const uint64_t beatStepSamples = beatStep(scene);
+            auto laneCenter = [&](int t, float& centerY) -> bool {
+                int laneIndex = scene.laneIndex[static_cast<size_t>(t)];
+                if (laneIndex < 0) return false;
+                int displayIndex = rows.displayIndex(laneIndex);
+                if (displayIndex < 0) return false;
+                centerY = rows.centerY(displayIndex);
+                return rows.onScreen(centerY, scene.screenHeight);
+            };
+            auto label = [&](size_t at, float x, float y, const char* text) {
+                appendLabel(plan.labels(), spots, at, x, y, text, scene.screenWidth, scene.screenHeight);
+            };
+            float centerY = 0.0f;
+            for (int t = 0; t < trackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                plan.add(store, tracks[static_cast<size_t>(t)].background.id, static_cast<uint32_t>(t), centerY, view);
+            }
+            for (int t = 0; t < trackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                const auto& clips = scene.tracks[static_cast<size_t>(t)].clips;
+                const TrackGeometry& geometry = tracks[static_cast<size_t>(t)];
+                for (size_t ci = 0; ci < clips.size() && ci < geometry.clips.size(); ++ci) {
+                    LaneGeometry::planClip(plan, store, geometry.clips[ci].body.id, geometry.clips[ci].layout,
+                                           static_cast<uint32_t>(t), centerY, scene.laneHalfH, view,
+                                           clips[ci].startSample, clips[ci].length, beatStepSamples, label);
+                }
+            }
+            for (int t = 0; t < trackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                plan.add(store, tracks[static_cast<size_t>(t)].wave.id, static_cast<uint32_t>(t), centerY, view);
+            }
+            if (scene.midi) {
+                for (int t = 0; t < trackCount; ++t) {
+                    if (!laneCenter(t, centerY)) continue;
+                    const auto& clips = scene.tracks[static_cast<size_t>(t)].clips;
+                    const TrackGeometry& geometry = tracks[static_cast<size_t>(t)];
+                    for (size_t ci = 0; ci < clips.size() && ci < geometry.clips.size(); ++ci) {
+                        if (!LaneGeometry::notesVisible(view, clips[ci].startSample, clips[ci].length)) continue;
+                        plan.add(store, geometry.clips[ci].notes.id, static_cast<uint32_t>(t), centerY, view);
+                    }
+                }
+            }
+            for (int t = 0; t < trackCount; ++t) {
+                if (!laneCenter(t, centerY)) continue;
+                plan.add(store, tracks[static_cast<size_t>(t)].handle.id, static_cast<uint32_t>(t), centerY, view);
+            }
+            plan.mark();
+        }
+
+        void placeLanes(const Scene& scene, const LaneGeometry::Rows& rows) {
+            std::vector<float>& centers = store.transform.centerY;
+            centers.assign(scene.laneIndex.size(), 0.0f);
+            for (size_t t = 0; t < scene.laneIndex.size(); ++t) {
+                if (scene.laneIndex[t] < 0) continue;
+                int displayIndex = rows.displayIndex(scene.laneIndex[t]);
+                if (displayIndex >= 0) centers[t] = rows.centerY(displayIndex);
+            }
+        }
+    };
+
+    // UIBatchSystem's copy of a store: replaced whole on first use, growth or
+    // compaction, otherwise patched with the dirty ranges.
+    struct LaneBuffer {
+        std::vector<LaneGeometry::Vertex> data;
+        size_t capacity = 0;
+        uint64_t generation = 0;
+        bool uploaded = false;
+        size_t bytes = 0;  // uploaded by the last sync
+
+        void sync(LaneGeometry::Store& store) {
+            const std::vector<LaneGeometry::Vertex>& vertices = store.vertices();
+            const size_t stride = sizeof(LaneGeometry::Vertex);
+            bytes = 0;
+            if (!uploaded || generation != store.generation() || capacity < vertices.size()) {
+                size_t grown = std::max<size_t>(capacity, 4096);
+                while (grown < vertices.size()) grown *= 2;
+                data.assign(grown, LaneGeometry::Vertex{});
+                std::copy(vertices.begin(), vertices.end(), data.begin());
+                bytes = vertices.size() * stride;
+                store.takeDirty();
+                capacity = grown;
+                generation = store.generation();
+                uploaded = true;
+                return;
+            }
+            for (const UIBatch::Range& range : store.takeDirty()) {
+                std::copy(vertices.begin() + range.first, vertices.begin() + range.first + range.count,
+                          data.begin() + range.first);
+                bytes += range.count * stride;
+            }
+        }
+
+        bool matches(const LaneGeometry::Store& store) const {
+            const std::vector<LaneGeometry::Vertex>& vertices = store.vertices();
+            return data.size() >= vertices.size()
+                && std::memcmp(data.data(), vertices.data(), vertices.size() * sizeof(LaneGeometry::Vertex)) == 0;
+        }
+    };
+
+    // A framebuffer filled with GL's rules: vertices snapped to 1/256 pixel
+    // after the viewport transform, samples at pixel centers, top-left edges
+    // owned, and blended SRC_ALPHA/ONE_MINUS_SRC_ALPHA in painter's order.
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::vector<float> rgb;
+
+        void reset(int w, int h) {
+            width = w;
+            height = h;
+            rgb.assign(static_cast<size_t>(w) * static_cast<size_t>(h) * 3, 0.0f);
+        }
+
+        void triangle(const float* ndcX, const float* ndcY, uint32_t color, float alpha) {
+            int64_t x[3];
+            int64_t y[3];
+            for (int i = 0; i < 3; ++i) {
+                const float wx = (ndcX[i] * 0.5f + 0.5f) * static_cast<float>(width);
+                const float wy = (ndcY[i] * 0.5f + 0.5f) * static_cast<float>(height);
+                x[i] = std::llround(static_cast<double>(wx) * 256.0);
+                y[i] = std::llround(static_cast<double>(wy) * 256.0);
+            }
+            int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+            if (area == 0) return;
+            if (area < 0) {
+                std::swap(x[1], x[2]);
+                std::swap(y[1], y[2]);
+            }
+            const int64_t minX = std::max<int64_t>(0, (std::min({x[0], x[1], x[2]}) - 128) / 256 - 1);
+            const int64_t maxX = std::min<int64_t>(width - 1, (std::max({x[0], x[1], x[2]}) + 128) / 256 + 1);
+            const int64_t minY = std::max<int64_t>(0, (std::min({y[0], y[1], y[2]}) - 128) / 256 - 1);
+            const int64_t maxY = std::min<int64_t>(height - 1, (std::max({y[0], y[1], y[2]}) + 128) / 256 + 1);
+            const float src[3] = {static_cast<float>(color & 0xffu) / 255.0f,
+                                  static_cast<float>((color >> 8u) & 0xffu) / 255.0f,
+                                  static_cast<float>((color >> 16u) & 0xffu) / 255.0f};
+            for (int64_t py = minY; py <= maxY; ++py) {
+                const int64_t sy = py * 256 + 128;
+                for (int64_t px = minX; px <= maxX; ++px) {
+                    const int64_t sx = px * 256 + 128;
+                    bool inside = true;
+                    for (int e = 0; e < 3 && inside; ++e) {
+                        const int64_t ax = x[e];
+                        const int64_t ay = y[e];
+                        const int64_t bx = x[(e + 1) % 3];
+                        const int64_t by = y[(e + 1) % 3];
+                        const int64_t w = (bx - ax) * (sy - ay) - (by - ay) * (sx - ax);
+                        // Counter-clockwise in y-up: left edges run down, top edges run left.
+                        const bool topLeft = (by < ay) || (by == ay && bx < ax);
+                        inside = w > 0 || (w == 0 && topLeft);
+                    }
+                    if (!inside) continue;
+                    float* dst = &rgb[(static_cast<size_t>(py) * static_cast<size_t>(width) + static_cast<size_t>(px)) * 3];
+                    for (int c = 0; c < 3; ++c) dst[c] = src[c] * alpha + dst[c] * (1.0f - alpha);
+                }
+            }
+        }
+    };
+
+    // Draws a finished batch: Color and Text runs from write(), Lane runs from
+    // the stores' buffers through the shader's placement.
+    void rasterize(UIBatch::Builder& batch, const std::vector<std::pair<LaneGeometry::Store*, LaneBuffer*>>& layers,
+                   Image& image) {
+        std::vector<UIBatch::Vertex> written(batch.vertexCount());
+        batch.write(written.data());
+        const std::vector<UIBatch::Range>& ranges = batch.ranges();
+        for (const UIBatch::Draw& draw : batch.draws()) {
+            if (draw.state.program != UIBatch::Program::Lane) {
+                for (uint32_t i = draw.first; i + 2 < draw.first + draw.count; i += 3) {
+                    const float xs[3] = {written[i].x, written[i + 1].x, written[i + 2].x};
+                    const float ys[3] = {written[i].y, written[i + 1].y, written[i + 2].y};
+                    const uint32_t color = written[i].color;
+                    image.triangle(xs, ys, color, static_cast<float>(color >> 24u) / 255.0f);
+                }
+                continue;
+            }
+            const uint32_t storeId = draw.state.texture & 0xffffu;
+            const uint32_t page = draw.state.texture >> 16u;
+            const LaneGeometry::Store* store = nullptr;
+            const LaneBuffer* buffer = nullptr;
+            for (const auto& layer : layers) {
+                if (layer.first->id() == storeId) {
+                    store = layer.first;
+                    buffer = layer.second;
+                }
+            }
+            if (!check(store != nullptr, "lane draw names a registered store")) continue;
+            const LaneGeometry::Transform& transform = store->transform;
+            // UILane.vert.glsl: x from place(), y from this page's uCenterY.
+            auto shade = [&](const LaneGeometry::Vertex& v, float& ndcX, float& ndcY) {
+                float x = 0.0f;
+                float y = 0.0f;
+                LaneGeometry::place(transform, v, x, y);
+                const size_t slot = static_cast<size_t>(page) * LaneGeometry::kLanesPerPage + ((v.meta >> 8u) & 255u);
+                const float center = slot < transform.centerY.size() ? transform.centerY[slot] : 0.0f;
+                y = (center + v.dy[0]) + v.dy[1];
+                LaneGeometry::toNdc(transform, x, y, ndcX, ndcY);
+            };
+            for (uint32_t r = draw.first; r < draw.first + draw.count; ++r) {
+                const UIBatch::Range& range = ranges[r];
+                for (uint32_t i = range.first; i + 2 < range.first + range.count; i += 3) {
+                    float xs[3];
+                    float ys[3];
+                    for (int k = 0; k < 3; ++k) shade(buffer->data[i + static_cast<uint32_t>(k)], xs[k], ys[k]);
+                    image.triangle(xs, ys, buffer->data[i].color, transform.alpha);
+                }
+            }
+        }
+    }
+
+    size_t countMismatches(const Image& a, const Image& b) {
+        size_t mismatches = 0;
+        for (size_t i = 0; i + 2 < a.rgb.size(); i += 3) {
+            if (a.rgb[i] != b.rgb[i] || a.rgb[i + 1] != b.rgb[i + 1] || a.rgb[i + 2] != b.rgb[i + 2]) ++mismatches;
+        }
+        return mismatches;
+    }
+
+    double logUniform(std::mt19937& rng, double lo, double hi) {
+        std::uniform_real_distribution<double> d(std::log(lo), std::log(hi));
+        return std::exp(d(rng));
+    }
+
+    float quarters(std::mt19937& rng, int lo, int hi) {
+        return static_cast<float>(std::uniform_int_distribution<int>(lo * 4, hi * 4)(rng)) * 0.25f;
+    }
+
+    void fillBlocks(Track& track, std::mt19937& rng, size_t blockCount, bool right, bool colors) {
+        std::uniform_real_distribution<float> amp(-1.2f, 1.2f);
+        track.waveformMin.resize(blockCount);
+        track.waveformMax.resize(blockCount);
+        for (size_t b = 0; b < blockCount; ++b) {
+            const float a = amp(rng);
+            const float c = amp(rng);
+            track.waveformMin[b] = std::min(a, c);
+            track.waveformMax[b] = std::max(a, c);
+        }
+        if (right) {
+            track.waveformMinRight = track.waveformMin;
+            track.waveformMaxRight = track.waveformMax;
+            for (float& v : track.waveformMaxRight) v *= 0.7f;
+        } else {
+            track.waveformMinRight.clear();
+            track.waveformMaxRight.clear();
+        }
+        if (colors) {
+            std::uniform_real_distribution<float> channel(0.0f, 1.0f);
+            track.waveformColor.resize(blockCount);
+            for (glm::vec3& c : track.waveformColor) c = glm::vec3(channel(rng), channel(rng), channel(rng));
+        }
+        track.waveformVersion += 1;
+    }
+
+    Scene randomScene(std::mt19937& rng, bool midi) {
+        auto chance = [&](double p) { return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < p; };
+        auto pick = [&](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+        Scene scene;
+        scene.midi = midi;
+        scene.screenWidth = pick(480, 1920);
+        scene.screenHeight = pick(320, 1200);
+        scene.laneLeft = quarters(rng, 20, 240);
+        scene.laneRight = static_cast<float>(scene.screenWidth) - quarters(rng, 80, 260);
+        if (chance(0.05)) scene.laneRight = scene.laneLeft + quarters(rng, 0, 3);
+        scene.laneHeight = std::clamp(quarters(rng, 20, 180), 24.0f, 180.0f);
+        scene.laneHalfH = scene.laneHeight * 0.5f;
+        scene.rowSpan = scene.laneHeight + 12.0f;
+        scene.startY = quarters(rng, -900, 300);
+        const int choice = pick(0, 3);
+        scene.offsetSamples = choice == 0 ? 0
+            : static_cast<uint64_t>(logUniform(rng, 10.0, choice == 3 ? 6.0e8 : 2.0e7));
+        scene.secondsPerScreen = chance(0.03) ? 0.0 : logUniform(rng, 0.01, 900.0);
+        scene.bpm = chance(0.05) ? 0.0 : logUniform(rng, 30.0, 300.0);
+        scene.themeRevision = static_cast<uint64_t>(pick(0, 1));
+
+        const int trackCount = pick(1, 36);
+        std::vector<int> order(static_cast<size_t>(trackCount));
+        for (int i = 0; i < trackCount; ++i) order[static_cast<size_t>(i)] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        scene.laneIndex = order;
+        for (int& laneIndex : scene.laneIndex) {
+            if (chance(0.08)) laneIndex = -1;
+        }
+        if (chance(0.3)) {
+            scene.previewSlot = pick(0, trackCount);
+            scene.dragActive = chance(0.5);
+            scene.dragLaneIndex = scene.dragActive ? pick(0, trackCount - 1) : -1;
+        }
+
+        const int audioCount = pick(1, 5);
+        for (int a = 0; a < audioCount; ++a) {
+            ClipAudio audio;
+            audio.stereo = chance(0.4);
+            audio.length = static_cast<uint64_t>(logUniform(rng, 100.0, 5.0e7));
+            audio.seed = static_cast<uint32_t>(rng());
+            audio.color = glm::vec3(0.2f + 0.1f * static_cast<float>(a), 0.3f, 0.5f - 0.05f * static_cast<float>(a));
+            scene.clipAudio.push_back(audio);
+        }
+
+        const double window = std::max(1.0, scene.secondsPerScreen * kSampleRate);
+        scene.tracks.resize(static_cast<size_t>(trackCount));
+        for (Track& track : scene.tracks) {
+            const int clipCount = pick(0, 8);
+            for (int c = 0; c < clipCount; ++c) {
+                Clip clip;
+                const double start = static_cast<double>(scene.offsetSamples)
+                    + std::uniform_real_distribution<double>(-window, 2.0 * window)(rng);
+                clip.startSample = static_cast<uint64_t>(std::max(0.0, start));
+                clip.length = chance(0.04) ? 0 : static_cast<uint64_t>(std::max(1.0, window * logUniform(rng, 1e-4, 2.0)));
+                clip.sourceOffset = static_cast<uint64_t>(pick(0, 100000));
+                clip.audioId = pick(-1, audioCount - 1);
+                if (midi) {
+                    const int noteCount = pick(0, 40);
+                    for (int n = 0; n < noteCount; ++n) {
+                        Note note;
+                        note.pitch = pick(0, 127);
+                        const double len = static_cast<double>(std::max<uint64_t>(1, clip.length));
+                        note.startSample = static_cast<uint64_t>(len * std::uniform_real_distribution<double>(0.0, 1.2)(rng));
+                        note.length = chance(0.05) ? 0 : static_cast<uint64_t>(1.0 + len * logUniform(rng, 1e-4, 0.6));
+                        clip.notes.push_back(note);
+                    }
+                }
+                track.clips.push_back(clip);
+            }
+            const uint64_t viewEnd = scene.offsetSamples + static_cast<uint64_t>(window);
+            if (midi) {
+                if (chance(0.6) && viewEnd / kWaveformBlockSize < 3000000) {
+                    const size_t blocks = static_cast<size_t>(
+                        static_cast<double>(viewEnd / kWaveformBlockSize + 1) * std::uniform_real_distribution<double>(0.2, 1.3)(rng));
+                    fillBlocks(track, rng, blocks, false, true);
+                }
+            } else if (chance(0.3) && viewEnd / kWaveformBlockSize < 3000000) {
+                const double start = static_cast<double>(scene.offsetSamples)
+                    + std::uniform_real_distribution<double>(-window, window)(rng);
+                track.recordStartSample = static_cast<uint64_t>(std::max(0.0, start));
+                track.previewLength = static_cast<uint64_t>(window * logUniform(rng, 1e-3, 1.5));
+                const size_t blocks = static_cast<size_t>(
+                    static_cast<double>((track.recordStartSample + track.previewLength) / kWaveformBlockSize + 1)
+                    * std::uniform_real_distribution<double>(0.5, 1.1)(rng));
+                fillBlocks(track, rng, blocks, chance(0.5), false);
+            }
+        }
+        if (chance(0.7)) {
+            scene.selectedClipTrack = pick(0, trackCount - 1);
+            scene.selectedClipIndex = pick(0, 8);
+        }
+        return scene;
+    }
+
+    // One step of editing, scrolling or zooming between frames.
+    void perturb(Scene& scene, std::mt19937& rng) {
+        auto pick = [&](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+        const double window = std::max(1.0, scene.secondsPerScreen * kSampleRate);
+        switch (pick(0, 10)) {
+            case 0:
+                scene.startY += quarters(rng, -200, 200);
+                break;
+            case 1:
+                scene.offsetSamples = static_cast<uint64_t>(std::max(0.0, static_cast<double>(scene.offsetSamples)
+                    + std::uniform_real_distribution<double>(-0.3, 0.3)(rng) * window));
+                break;
+            case 2:
+                scene.secondsPerScreen *= logUniform(rng, 0.5, 2.0);
+                break;
+            case 3:
+                for (Track& track : scene.tracks) {
+                    if (track.clips.empty()) continue;
+                    Clip& clip = track.clips[static_cast<size_t>(pick(0, static_cast<int>(track.clips.size()) - 1))];
+                    clip.startSample += static_cast<uint64_t>(pick(1, 48000));
+                    break;
+                }
+                break;
+            case 4:
+                scene.selectedClipTrack = pick(-1, static_cast<int>(scene.tracks.size()) - 1);
+                scene.selectedClipIndex = pick(0, 4);
+                break;
+            case 5:
+                for (Track& track : scene.tracks) {
+                    if (track.clips.empty()) continue;
+                    Clip& clip = track.clips.back();
+                    if (!clip.notes.empty()) {
+                        clip.notes[static_cast<size_t>(pick(0, static_cast<int>(clip.notes.size()) - 1))].pitch = pick(0, 127);
+                    }
+                    clip.length += static_cast<uint64_t>(pick(1, 20000));
+                    break;
+                }
+                break;
+            case 6:
+                scene.laneHeight = std::clamp(scene.laneHeight + quarters(rng, -20, 20), 24.0f, 180.0f);
+                scene.laneHalfH = scene.laneHeight * 0.5f;
+                scene.rowSpan = scene.laneHeight + 12.0f;
+                break;
+            case 7:
+                scene.previewSlot = pick(-1, static_cast<int>(scene.tracks.size()));
+                scene.dragActive = pick(0, 1) == 1;
+                scene.dragLaneIndex = scene.dragActive ? pick(0, static_cast<int>(scene.tracks.size()) - 1) : -1;
+                break;
+            case 8:
+                if (!scene.tracks.empty() && pick(0, 1) == 0) {
+                    scene.tracks.pop_back();
+                    scene.laneIndex.pop_back();
+                } else {
+                    scene.tracks.push_back(scene.tracks.front());
+                    scene.laneIndex.push_back(static_cast<int>(scene.laneIndex.size()));
+                }
+                break;
+            case 9:
+                for (Track& track : scene.tracks) {
+                    if (track.waveformMin.empty()) continue;
+                    track.previewLength += static_cast<uint64_t>(pick(256, 48000));
+                    fillBlocks(track, rng, track.waveformMin.size() + static_cast<size_t>(pick(1, 200)),
+                               !track.waveformMinRight.empty(), scene.midi);
+                    break;
+                }
+                break;
+            default:
+                scene.themeRevision += 1;
+                scene.clipWaveformVersion += 1;
+                break;
+        }
+    }
+
+    struct FrameResult {
+        size_t mismatches = 0;
+        bool labelsMatch = true;
+    };
+
+    // Draws `scene` both ways and compares them.
+    FrameResult compareFrame(const Scene& scene, Retained& retained, LaneBuffer& buffer, Legacy::Output& legacy,
+                             Image& before, Image& after) {
+        FrameResult result;
+        UIBatch::Builder batch;
+        Legacy::buildLanes(scene, legacy);
+        batch.addColored(legacy.vertices, kLaneAlpha, legacy.labels);
+        before.reset(static_cast<int>(scene.screenWidth), static_cast<int>(scene.screenHeight));
+        rasterize(batch, {}, before);
+
+        batch.clear();
+        retained.update(scene);
+        retained.submit(batch, kLaneAlpha);
+        buffer.sync(retained.store);
+        check(buffer.matches(retained.store), "the lane buffer holds the store after its dirty ranges");
+        after.reset(static_cast<int>(scene.screenWidth), static_cast<int>(scene.screenHeight));
+        rasterize(batch, {{&retained.store, &buffer}}, after);
+
+        result.mismatches = countMismatches(before, after);
+        result.labelsMatch = legacy.spots == retained.spots;
+        return result;
+    }
+
+    // True when v lies within 2^-20 ulp of a midpoint between floats, where
+    // LaneGeometry's float pairs may round the other way from a double.
+    bool nearFloatTie(long double v) {
+        const float f = static_cast<float>(v);
+        const float other = std::nextafter(f, static_cast<long double>(f) < v ? HUGE_VALF : -HUGE_VALF);
+        const long double mid = (static_cast<long double>(f) + static_cast<long double>(other)) / 2.0L;
+        const long double ulp = std::fabs(static_cast<long double>(other) - static_cast<long double>(f));
+        return std::fabs(v - mid) <= std::ldexp(ulp, -20);
+    }
+
+    // The roundings the shader has to reproduce, one formula at a time and
+    // far more often than whole scenes reach them: beat tick x, NDC, and
+    // clamped stereo waveform y.
+    void checkRounding(int count) {
+        std::mt19937 rng(2024u);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        size_t tickTies = 0;
+        size_t tickMisses = 0;
+        size_t ndcMisses = 0;
+        size_t waveMisses = 0;
+        for (int i = 0; i < count; ++i) {
+            LaneGeometry::View view;
+            view.offsetSamples = static_cast<double>(static_cast<uint64_t>(logUniform(rng, 1.0, 4.0e10)));
+            view.windowSamples = logUniform(rng, 0.003, 900.0) * kSampleRate;
+            view.screenWidth = static_cast<double>(std::uniform_int_distribution<int>(320, 3840)(rng));
+            view.screenHeight = static_cast<double>(std::uniform_int_distribution<int>(240, 2160)(rng));
+            view.laneLeft = quarters(rng, 0, 400);
+            view.laneRight = std::max(view.laneLeft + 1.0f, quarters(rng, 0, static_cast<int>(view.screenWidth)));
+            LaneGeometry::Transform transform;
+            transform.setView(view);
+            const float centerY = quarters(rng, -40, static_cast<int>(view.screenHeight) + 40);
+            transform.centerY.assign(1, centerY);
+
+            const double tick = std::floor(view.offsetSamples + (unit(rng) * 1.2 - 0.1) * view.windowSamples);
+            if (tick >= 0.0) {
+                const float tt = static_cast<float>((tick - view.offsetSamples) / view.windowSamples);
+                const float oldX = view.laneLeft + (view.laneRight - view.laneLeft) * tt;
+                float split[2];
+                LaneGeometry::splitSample(static_cast<uint64_t>(tick), split);
+                if (LaneGeometry::detail::timelineX(transform, split) != oldX) {
+                    const long double exact = (static_cast<long double>(tick) - view.offsetSamples) / view.windowSamples;
+                    if (nearFloatTie(exact)) {
+                        tickTies += 1;
+                    } else {
+                        tickMisses += 1;
+                    }
+                }
+            }
+
+            const float x = static_cast<float>((unit(rng) * 1.1 - 0.05) * view.screenWidth);
+            const float y = static_cast<float>((unit(rng) * 1.1 - 0.05) * view.screenHeight);
+            const glm::vec2 oldNdc = Legacy::pixelToNDC({x, y}, view.screenWidth, view.screenHeight);
+            float ndcX = 0.0f;
+            float ndcY = 0.0f;
+            LaneGeometry::toNdc(transform, x, y, ndcX, ndcY);
+            if (ndcX != oldNdc.x || ndcY != oldNdc.y) ndcMisses += 1;
+
+            // Legacy::buildLanes' stereo column, with the lane's edges on the
+            // screen as the old pass had them.
+            const float laneHalfH = quarters(rng, 4, 80);
+            const float top = centerY - laneHalfH;
+            const float bottom = centerY + laneHalfH;
+            const float splitY = 0.5f * (top + bottom);
+            const float topRegionBottom = splitY - 1.0f;
+            const float bottomRegionTop = splitY + 1.0f;
+            const float topCenter = 0.5f * (top + topRegionBottom);
+            const float bottomCenter = 0.5f * (bottomRegionTop + bottom);
+            const float topAmp = std::max(1.0f, (topRegionBottom - top) * 0.45f);
+            const float bottomAmp = std::max(1.0f, (bottom - bottomRegionTop) * 0.45f);
+            float values[4];
+            for (float& value : values) value = static_cast<float>(unit(rng) * 2.4 - 1.2);
+            const float oldY[4] = {
+                std::clamp(topCenter - values[1] * topAmp, top, topRegionBottom),
+                std::clamp(topCenter - values[0] * topAmp, top, topRegionBottom),
+                std::clamp(bottomCenter - values[3] * bottomAmp, bottomRegionTop, bottom),
+                std::clamp(bottomCenter - values[2] * bottomAmp, bottomRegionTop, bottom),
+            };
+            std::vector<LaneGeometry::Vertex> column;
+            LaneGeometry::pushWaveColumn(column, 0, x, laneHalfH, 1.0f, true, values[0], values[1], values[2],
+                                         values[3], 0u, 0u);
+            const size_t corners[4] = {0, 2, 6, 8};
+            for (int c = 0; c < 4; ++c) {
+                float placedX = 0.0f;
+                float placedY = 0.0f;
+                LaneGeometry::place(transform, column[corners[c]], placedX, placedY);
+                if (placedY != oldY[c]) {
+                    waveMisses += 1;
+                    break;
+                }
+            }
+        }
+        std::printf("rounding: %d draws, %zu tick x (and %zu at a tie), %zu NDC and %zu stereo y differ\n", count,
+                    tickMisses, tickTies, ndcMisses, waveMisses);
+        check(tickMisses == 0 && ndcMisses == 0 && waveMisses == 0,
+              "the shader's placement rounds as the immediate pass did");
+    }
+
+    void checkRandomScenes(bool midi, int sceneCount, int framesPerScene) {
+        std::mt19937 rng(midi ? 4711u : 1147u);
+        Retained retained;
+        LaneBuffer buffer;
+        Legacy::Output legacy;
+        Image before;
+        Image after;
+        size_t frames = 0;
+        size_t failedFrames = 0;
+        size_t worst = 0;
+        for (int s = 0; s < sceneCount; ++s) {
+            Scene scene = randomScene(rng, midi);
+            for (int f = 0; f < framesPerScene; ++f) {
+                if (f > 0) perturb(scene, rng);
+                const FrameResult result = compareFrame(scene, retained, buffer, legacy, before, after);
+                frames += 1;
+                worst = std::max(worst, result.mismatches);
+                if (result.mismatches != 0 || !result.labelsMatch) {
+                    failedFrames += 1;
+                    if (failedFrames <= 5) {
+                        std::cerr << (midi ? "midi" : "audio") << " scene " << s << " frame " << f << ": "
+                                  << result.mismatches << " pixel(s) differ"
+                                  << (result.labelsMatch ? "" : ", labels differ") << "\n";
+                    }
+                }
+            }
+        }
+        std::printf("%s lanes: %zu frames of %d random scenes, %zu differ (worst %zu pixels)\n",
+                    midi ? "midi" : "audio", frames, sceneCount, failedFrames, worst);
+        check(failedFrames == 0, std::string(midi ? "midi" : "audio") + " lanes draw the same pixels and labels as the immediate pass");
+    }
+
+    // 64 tracks of ten clips, four seconds each with a second between.
+    Scene sessionScene(bool midi) {
+        std::mt19937 rng(midi ? 64u : 46u);
+        Scene scene;
+        scene.midi = midi;
+        scene.screenWidth = 1600.0;
+        scene.screenHeight = 900.0;
+        scene.laneLeft = 140.0f;
+        scene.laneRight = 1480.0f;
+        scene.laneHeight = 60.0f;
+        scene.laneHalfH = 30.0f;
+        scene.rowSpan = 72.0f;
+        scene.startY = 120.0f;
+        scene.offsetSamples = 48000;
+        scene.secondsPerScreen = 20.0;
+        scene.bpm = 124.0;
+        for (int a = 0; a < 8; ++a) {
+            ClipAudio audio;
+            audio.stereo = a % 2 == 0;
+            audio.length = 48000 * 8;
+            audio.seed = static_cast<uint32_t>(a * 977);
+            audio.color = glm::vec3(0.3f, 0.25f + 0.05f * static_cast<float>(a), 0.4f);
+            scene.clipAudio.push_back(audio);
+        }
+        scene.tracks.resize(64);
+        for (int t = 0; t < 64; ++t) {
+            Track& track = scene.tracks[static_cast<size_t>(t)];
+            scene.laneIndex.push_back(t);
+            for (int c = 0; c < 10; ++c) {
+                Clip clip;
+                clip.startSample = static_cast<uint64_t>(c) * 5 * 48000 + static_cast<uint64_t>(t) * 1200;
+                clip.length = 4 * 48000;
+                clip.audioId = (t + c) % 8;
+                if (midi) {
+                    for (int n = 0; n < 32; ++n) {
+                        clip.notes.push_back({36 + (n * 7 + t) % 48, static_cast<uint64_t>(n) * 6000, 5000});
+                    }
+                }
+                track.clips.push_back(clip);
+            }
+            if (midi) fillBlocks(track, rng, 52 * 48000 / kWaveformBlockSize, false, true);
+        }
+        return scene;
+    }
+
+    struct BenchResult {
+        double oldMs = 0.0;
+        double newMs = 0.0;
+        double oldBytes = 0.0;
+        double newBytes = 0.0;
+        double oldDraws = 0.0;
+        double newDraws = 0.0;
+        uint64_t laneBytesLate = 0;  // lane uploads in the second half
+        Retained::Writes writes;     // after the first frame
+        size_t worstMismatch = 0;
+    };
+
+    template <class StepFn>
+    BenchResult runScenario(bool midi, int frames, StepFn&& step) {
+        Scene scene = sessionScene(midi);
+        Retained retained;
+        LaneBuffer buffer;
+        Legacy::Output legacy;
+        UIBatch::Builder batch;
+        std::vector<UIBatch::Vertex> written;
+        Image before;
+        Image after;
+        BenchResult result;
+        Retained::Writes firstWrites;
+        bool legacyStale = true;
+        for (int f = 0; f < frames; ++f) {
+            if (f > 0) legacyStale = step(scene, f) || legacyStale;
+
+            // The old pass rebuilt its vertices when anything changed and
+            // wrote them all into the ring every frame.
+            auto t0 = Clock::now();
+            if (legacyStale) Legacy::buildLanes(scene, legacy);
+            legacyStale = false;
+            batch.clear();
+            batch.addColored(legacy.vertices, kLaneAlpha, legacy.labels);
+            written.resize(batch.vertexCount());
+            batch.write(written.data());
+            auto t1 = Clock::now();
+            const UIBatch::Stats oldStats = batch.stats();
+            result.oldMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            result.oldBytes += static_cast<double>(oldStats.bytes);
+            result.oldDraws += static_cast<double>(oldStats.draws);
+            if (f % 100 == 50) {
+                before.reset(static_cast<int>(scene.screenWidth), static_cast<int>(scene.screenHeight));
+                rasterize(batch, {}, before);
+            }
+
+            t0 = Clock::now();
+            retained.update(scene);
+            batch.clear();
+            retained.submit(batch, kLaneAlpha);
+            written.resize(batch.vertexCount());
+            batch.write(written.data());
+            buffer.sync(retained.store);
+            t1 = Clock::now();
+            const UIBatch::Stats newStats = batch.stats();
+            result.newMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            result.newBytes += static_cast<double>(newStats.bytes + buffer.bytes);
+            result.newDraws += static_cast<double>(newStats.draws);
+            if (f >= frames / 2) result.laneBytesLate += buffer.bytes;
+            if (f == 0) firstWrites = retained.writes;
+            if (f % 100 == 50) {
+                after.reset(static_cast<int>(scene.screenWidth), static_cast<int>(scene.screenHeight));
+                rasterize(batch, {{&retained.store, &buffer}}, after);
+                result.worstMismatch = std::max(result.worstMismatch, countMismatches(before, after));
+            }
+        }
+        check(buffer.matches(retained.store), "the benchmark's lane buffer holds the store");
+        result.writes.backgrounds = retained.writes.backgrounds - firstWrites.backgrounds;
+        result.writes.handles = retained.writes.handles - firstWrites.handles;
+        result.writes.bodies = retained.writes.bodies - firstWrites.bodies;
+        result.writes.notes = retained.writes.notes - firstWrites.notes;
+        result.writes.waves = retained.writes.waves - firstWrites.waves;
+        const double n = static_cast<double>(frames);
+        result.oldMs /= n;
+        result.newMs /= n;
+        result.oldBytes /= n;
+        result.newBytes /= n;
+        result.oldDraws /= n;
+        result.newDraws /= n;
+        return result;
+    }
+
+    void report(const char* name, bool midi, const BenchResult& r) {
+        std::printf("  %-5s %-16s old %7.3f ms %8.0f KB %5.1f draws | new %7.3f ms %8.1f KB %5.1f draws\n",
+                    midi ? "midi" : "audio", name, r.oldMs, r.oldBytes / 1024.0, r.oldDraws,
+                    r.newMs, r.newBytes / 1024.0, r.newDraws);
+        check(r.worstMismatch == 0, std::string(name) + ": sampled frames draw the same pixels on both paths");
+    }
+
+    void runBenchmark(bool checks) {
+        const int frames = 240;
+        std::printf("64-track session, %d frames per scenario, per frame (KB = vertex bytes uploaded):\n", frames);
+        for (int m = 0; m < 2; ++m) {
+            const bool midi = m == 1;
+            const BenchResult idle = runScenario(midi, frames, [](Scene&, int) { return false; });
+            report("idle", midi, idle);
+
+            const BenchResult vertical = runScenario(midi, frames, [](Scene& scene, int f) {
+                const int phase = f % 120;
+                scene.startY = 120.0f - 12.0f * static_cast<float>(phase < 60 ? phase : 120 - phase);
+                return true;
+            });
+            report("vertical scroll", midi, vertical);
+
+            const BenchResult horizontal = runScenario(midi, frames, [](Scene& scene, int) {
+                scene.offsetSamples += 1600;
+                return true;
+            });
+            report("horizontal scrol", midi, horizontal);
+
+            const BenchResult zoom = runScenario(midi, frames, [](Scene& scene, int f) {
+                scene.secondsPerScreen = 20.0 * std::pow(1.004, static_cast<double>(f % 200 < 100 ? f % 200 : 200 - f % 200));
+                return true;
+            });
+            report("zoom", midi, zoom);
+
+            const BenchResult drag = runScenario(midi, frames, [](Scene& scene, int) {
+                scene.tracks[3].clips[2].startSample += 480;
+                return true;
+            });
+            report("clip drag", midi, drag);
+
+            const BenchResult select = runScenario(midi, frames, [](Scene& scene, int f) {
+                if (f % 10 != 0) return false;
+                scene.selectedClipTrack = (f / 10) % 8;
+                scene.selectedClipIndex = (f / 10) % 10;
+                return true;
+            });
+            report("select", midi, select);
+
+            const BenchResult edit = runScenario(midi, frames, [midi](Scene& scene, int f) {
+                Track& track = scene.tracks[5];
+                if (midi) {
+                    track.clips[1].notes[static_cast<size_t>(f % 32)].pitch = 36 + (f * 5) % 48;
+                } else {
+                    // A take being recorded: the preview grows by a block a frame.
+                    if (track.waveformMin.empty()) track.recordStartSample = 48000;
+                    track.previewLength += kWaveformBlockSize;
+                    const size_t blocks = (track.recordStartSample + track.previewLength) / kWaveformBlockSize;
+                    track.waveformMin.resize(blocks, -0.4f);
+                    track.waveformMax.resize(blocks, 0.5f);
+                    track.waveformVersion += 1;
+                }
+                return true;
+            });
+            report(midi ? "note edit" : "recording", midi, edit);
+
+            if (!checks) continue;
+            check(idle.laneBytesLate == 0 && idle.writes.total() == 0,
+                  "an idle session uploads no lane vertices after the first frame");
+            check(vertical.laneBytesLate == 0,
+                  "scrolling back over lanes already built uploads nothing");
+            check(horizontal.writes.bodies == 0 && horizontal.writes.backgrounds == 0 && horizontal.writes.handles == 0
+                      && horizontal.writes.notes == 0,
+                  "horizontal scrolling rewrites only waveform columns");
+            check(zoom.writes.bodies == 0 && zoom.writes.backgrounds == 0 && zoom.writes.handles == 0
+                      && zoom.writes.notes == 0,
+                  "zooming rewrites only waveform columns");
+            check(drag.writes.bodies == static_cast<uint64_t>(frames - 1) && drag.writes.backgrounds == 0
+                      && drag.writes.handles == 0 && drag.writes.waves <= static_cast<uint64_t>(frames - 1),
+                  "dragging a clip rewrites that clip and at most its track's waveform");
+            check(select.writes.backgrounds == 0 && select.writes.handles == 0 && select.writes.waves == 0
+                      && select.writes.bodies <= 2 * static_cast<uint64_t>(frames / 10),
+                  "changing the selection rewrites only the two clips involved");
+            check(edit.writes.bodies == 0 && edit.writes.backgrounds == 0 && edit.writes.handles == 0,
+                  "editing notes or recording leaves clip bodies and lanes alone");
+            check(idle.newBytes < idle.oldBytes / 4.0, "an idle frame uploads far less than the immediate pass");
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    if (!benchOnly) {
+        checkRounding(2000000);
+        checkRandomScenes(false, 200, 4);
+        checkRandomScenes(true, 200, 4);
+    }
+    runBenchmark(!benchOnly);
+    if (g_failures > 0) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("ok\n");
+    return 0;
+}
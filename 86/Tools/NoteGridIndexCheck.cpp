@@ -0,0 +1,202 @@
+// Standalone checks for NoteGridIndex. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. Tools/NoteGridIndexCheck.cpp -o note_grid_index_check
+//   ./note_grid_index_check
+//
+// Edits a clip's notes at random the way the piano roll, lane trims and
+// recording do (moves, resizes, appends, erases, out-of-range pitches,
+// zero lengths, notes past the built extent), syncs after each edit and
+// compares query() and pixelWindow() against a linear scan. Ends with a
+// timing of visible-window queries against the scan the renderer used to do.
+// Exits nonzero if any check fails.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+#include "BaseSystem/NoteGridIndex.h"
+
+namespace {
+    // Same fields NoteGridIndex reads from Host.h's MidiNote.
+    struct MidiNote {
+        int pitch = 0;
+        uint64_t startSample = 0;
+        uint64_t length = 0;
+        float velocity = 1.0f;
+    };
+
+    int g_failures = 0;
+
+    bool check(bool condition, const char* what, int step) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << " (step " << step << ")\n";
+        g_failures += 1;
+        return false;
+    }
+
+    std::vector<uint32_t> linearScan(const std::vector<MidiNote>& notes, int rowMin, int rowMax,
+                                     uint64_t t0, uint64_t t1) {
+        std::vector<uint32_t> out;
+        if (t1 < t0 || rowMax < rowMin) return out;
+        rowMin = std::clamp(rowMin, 0, NoteGridIndex::kPitchCount - 1);
+        rowMax = std::clamp(rowMax, 0, NoteGridIndex::kPitchCount - 1);
+        for (uint32_t id = 0; id < notes.size(); ++id) {
+            const int row = std::clamp(notes[id].pitch, 0, NoteGridIndex::kPitchCount - 1);
+            const uint64_t start = notes[id].startSample;
+            const uint64_t end = start + std::max<uint64_t>(notes[id].length, 1);
+            if (row < rowMin || row > rowMax) continue;
+            if (start > t1 || end <= t0) continue;
+            out.push_back(id);
+        }
+        return out;
+    }
+
+    struct NoteSource {
+        std::mt19937_64 rng{0x9071};
+        uint64_t extent = 48000 * 16;
+
+        uint64_t below(uint64_t n) { return n ? rng() % n : 0; }
+
+        MidiNote next() {
+            MidiNote note;
+            note.pitch = 36 + static_cast<int>(below(48));
+            if (below(50) == 0) note.pitch = below(2) ? -5 : 140;
+            note.startSample = below(extent);
+            note.length = below(20) == 0 ? 0 : 100 + below(48000);
+            if (below(30) == 0) note.length = extent / 2;
+            return note;
+        }
+    };
+
+    void randomEdits() {
+        constexpr int kSteps = 4000;
+        NoteSource source;
+        std::vector<MidiNote> notes;
+        NoteGridIndex index;
+        std::vector<uint32_t> got;
+        for (int i = 0; i < 200; ++i) notes.push_back(source.next());
+
+        for (int step = 0; step < kSteps && g_failures == 0; ++step) {
+            const int op = static_cast<int>(source.below(12));
+            if (op < 4 && !notes.empty()) {
+                MidiNote& note = notes[source.below(notes.size())];
+                note.startSample = source.below(source.extent);
+                if (source.below(2)) note.pitch = 36 + static_cast<int>(source.below(48));
+            } else if (op < 6 && !notes.empty()) {
+                notes[source.below(notes.size())].length = source.below(96000);
+            } else if (op < 9) {
+                const int count = 1 + static_cast<int>(source.below(op == 8 ? 40 : 3));
+                for (int i = 0; i < count; ++i) notes.push_back(source.next());
+            } else if (op < 10 && !notes.empty()) {
+                notes.erase(notes.begin() + static_cast<std::ptrdiff_t>(source.below(notes.size())));
+            } else if (op < 11) {
+                // Recording or a lane trim pushing notes past the built extent.
+                MidiNote note = source.next();
+                note.startSample = source.extent + source.below(source.extent * 4);
+                notes.push_back(note);
+            }
+
+            const bool changed = index.sync(notes);
+            if (op == 11) check(!changed, "sync without edits reports no change", step);
+            check(!index.sync(notes), "a second sync reports no change", step);
+
+            for (int q = 0; q < 4; ++q) {
+                int rowMin = static_cast<int>(source.below(140)) - 6;
+                int rowMax = rowMin + static_cast<int>(source.below(40));
+                uint64_t t0 = source.below(source.extent * 5);
+                uint64_t t1 = t0 + source.below(source.extent / 4);
+                if (q == 3) {
+                    rowMin = -10;
+                    rowMax = 200;
+                    t0 = 0;
+                    t1 = std::numeric_limits<uint64_t>::max();
+                }
+                got.clear();
+                index.query(rowMin, rowMax, t0, t1, got);
+                if (!check(got == linearScan(notes, rowMin, rowMax, t0, t1), "query matches linear scan", step)) break;
+            }
+        }
+        std::cout << "edits: " << kSteps << " steps, " << notes.size() << " notes, "
+                  << index.bucketCount << " buckets of " << index.bucketSamples << " samples\n";
+    }
+
+    // Every note drawn inside [left, right] pixels must come back from the
+    // window pixelWindow() picks, at any zoom.
+    void pixelWindowCoversDrawnNotes() {
+        NoteSource source;
+        std::vector<MidiNote> notes;
+        for (int i = 0; i < 3000; ++i) notes.push_back(source.next());
+        NoteGridIndex index;
+        index.sync(notes);
+        std::vector<uint32_t> got;
+        for (int step = 0; step < 2000 && g_failures == 0; ++step) {
+            const double pxPerSample = step % 50 == 0 ? 0.0 : std::pow(10.0, -5.0 + 4.0 * (source.below(1000) / 1000.0));
+            const double clipX = -2000.0 + static_cast<double>(source.below(4000));
+            const double left = static_cast<double>(source.below(1920));
+            const double right = left + static_cast<double>(source.below(400));
+            uint64_t t0 = 0;
+            uint64_t t1 = 0;
+            got.clear();
+            if (NoteGridIndex::pixelWindow(clipX, pxPerSample, left, right, t0, t1)) {
+                index.query(0, NoteGridIndex::kPitchCount - 1, t0, t1, got);
+            }
+            for (uint32_t id = 0; id < notes.size(); ++id) {
+                const double x0 = clipX + static_cast<double>(notes[id].startSample) * pxPerSample;
+                const double x1 = x0 + static_cast<double>(std::max<uint64_t>(notes[id].length, 1)) * pxPerSample;
+                if (pxPerSample > 0.0 && (x1 < left || x0 > right)) continue;
+                if (!check(std::binary_search(got.begin(), got.end(), id), "pixelWindow keeps drawn notes", step)) break;
+            }
+        }
+    }
+
+    void visibleWindowBenchmark() {
+        using Clock = std::chrono::steady_clock;
+        NoteSource source;
+        source.extent = 48000ull * 600;
+        std::vector<MidiNote> notes;
+        for (int i = 0; i < 20000; ++i) {
+            // A long arrangement: no held notes spanning minutes.
+            MidiNote note = source.next();
+            note.length = std::min<uint64_t>(note.length, 48000 * 4);
+            notes.push_back(note);
+        }
+        NoteGridIndex index;
+        index.sync(notes);
+
+        constexpr int kQueries = 2000;
+        std::vector<uint32_t> got;
+        size_t indexed = 0;
+        size_t scanned = 0;
+        auto start = Clock::now();
+        for (int q = 0; q < kQueries; ++q) {
+            const uint64_t t0 = (source.extent / kQueries) * static_cast<uint64_t>(q);
+            got.clear();
+            index.query(36, 84, t0, t0 + 48000 * 8, got);
+            indexed += got.size();
+        }
+        const double indexUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        start = Clock::now();
+        for (int q = 0; q < kQueries; ++q) {
+            const uint64_t t0 = (source.extent / kQueries) * static_cast<uint64_t>(q);
+            scanned += linearScan(notes, 36, 84, t0, t0 + 48000 * 8).size();
+        }
+        const double scanUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        check(indexed == scanned, "benchmark windows agree", 0);
+        std::printf("window: %zu notes, %.2f us per query (linear scan %.2f us)\n",
+                    notes.size(), indexUs / kQueries, scanUs / kQueries);
+    }
+}
+
+int main() {
+    randomEdits();
+    pixelWindowCoversDrawnNotes();
+    visibleWindowBenchmark();
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
@@ -0,0 +1,228 @@
+// Standalone checks and microbenchmark for the per-section ore vein plan. Not
+// part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. Tools/OreVeinPlanCheck.cpp -o ore_vein_plan_check
+//   ./ore_vein_plan_check [--bench-only]
+//
+// Compares OreVeinPlan::planColumns and OreVeinPlan::variantForColumn with a
+// verbatim copy of the per-column search GenerateExpanseSectionVoxel ran
+// before the plan, over many random seeds and vein parameters (including
+// negative seeds, chance 0 and 1 and radii wider than a cell), section
+// footprints of 16 to 128 columns, LOD 0 to 3 column spacing and origins on
+// both sides of zero. Every column must get the same variant. Ends with the
+// time to resolve one section's columns both ways. Exits nonzero if any check
+// fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BaseSystem/OreVeinPlan.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    // TerrainGenerationSystem's helpers and oreVariantForColumn lambda as they
+    // were before the plan, with the captured settings passed in.
+    namespace Legacy {
+        uint32_t hash2DInt(int x, int z) {
+            uint32_t ux = static_cast<uint32_t>(x) * 73856093u;
+            uint32_t uz = static_cast<uint32_t>(z) * 19349663u;
+            uint32_t h = ux ^ uz;
+            h ^= (h >> 13);
+            h *= 1274126177u;
+            h ^= (h >> 16);
+            return h;
+        }
+
+        int floorDivInt(int value, int divisor) {
+            if (divisor <= 0) return 0;
+            if (value >= 0) return value / divisor;
+            return -(((-value) + divisor - 1) / divisor);
+        }
+
+        int oreVariantForColumn(const OreVeinPlan::Params& params, int worldXi, int worldZi) {
+            const bool oreEnabled = params.enabled;
+            const int oreSeed = params.seed;
+            const int oreVeinCellSize = params.cellSize;
+            const float oreVeinRadiusMin = params.radiusMin;
+            const float oreVeinRadiusMax = params.radiusMax;
+            const float oreVeinChance = params.chance;
+            if (!oreEnabled) return -1;
+            const int cellX = floorDivInt(worldXi, oreVeinCellSize);
+            const int cellZ = floorDivInt(worldZi, oreVeinCellSize);
+            int bestVariant = -1;
+            float bestDist2 = std::numeric_limits<float>::max();
+            for (int oz = -1; oz <= 1; ++oz) {
+                for (int ox = -1; ox <= 1; ++ox) {
+                    const int vx = cellX + ox;
+                    const int vz = cellZ + oz;
+                    const uint32_t seed = hash2DInt(vx + oreSeed * 17, vz - oreSeed * 23);
+                    const float chanceRoll = static_cast<float>((seed >> 24u) & 0xffu) / 255.0f;
+                    if (chanceRoll > oreVeinChance) continue;
+                    const float offsetX = static_cast<float>(seed & 0xffu) / 255.0f;
+                    const float offsetZ = static_cast<float>((seed >> 8u) & 0xffu) / 255.0f;
+                    const float centerX = (static_cast<float>(vx) + offsetX) * static_cast<float>(oreVeinCellSize);
+                    const float centerZ = (static_cast<float>(vz) + offsetZ) * static_cast<float>(oreVeinCellSize);
+                    const uint32_t radiusSeed = hash2DInt(vx * 131 + oreSeed, vz * 197 - oreSeed);
+                    const float radiusT = static_cast<float>(radiusSeed & 0xffu) / 255.0f;
+                    const float radius = oreVeinRadiusMin + (oreVeinRadiusMax - oreVeinRadiusMin) * radiusT;
+                    const float dx = static_cast<float>(worldXi) - centerX;
+                    const float dz = static_cast<float>(worldZi) - centerZ;
+                    const float dist2 = dx * dx + dz * dz;
+                    if (dist2 > radius * radius) continue;
+                    if (dist2 < bestDist2) {
+                        bestDist2 = dist2;
+                        const uint32_t oreSeedValue = hash2DInt(vx * 313 + oreSeed * 7, vz * 571 - oreSeed * 11);
+                        bestVariant = static_cast<int>((oreSeedValue >> 5u) & 0x3u);
+                    }
+                }
+            }
+            return bestVariant;
+        }
+    }
+
+    // Within the clamps the section generator applies to the registry values
+    // (cell size at least 6, radiusMin at least 0.5, radiusMax at least
+    // radiusMin, chance in [0, 1]), with a share of edge shapes.
+    OreVeinPlan::Params randomParams(std::mt19937& rng) {
+        OreVeinPlan::Params params;
+        params.enabled = true;
+        params.seed = std::uniform_int_distribution<int>(-100000, 100000)(rng);
+        params.cellSize = std::uniform_int_distribution<int>(6, 40)(rng);
+        const int shape = std::uniform_int_distribution<int>(0, 9)(rng);
+        params.radiusMin = std::max(0.5f, std::uniform_real_distribution<float>(0.5f, 6.0f)(rng));
+        params.radiusMax = std::max(params.radiusMin, params.radiusMin + std::uniform_real_distribution<float>(0.0f, 6.0f)(rng));
+        if (shape == 0) params.radiusMax = params.radiusMin;
+        if (shape == 1) params.radiusMax = static_cast<float>(params.cellSize) * 1.6f;  // discs spill past the 3x3
+        params.chance = std::uniform_real_distribution<float>(0.0f, 1.0f)(rng);
+        if (shape == 2) params.chance = 0.0f;
+        if (shape == 3) params.chance = 1.0f;
+        return params;
+    }
+
+    std::string describe(const OreVeinPlan::Params& params, int originX, int originZ, int count, int step) {
+        return "seed " + std::to_string(params.seed) + " cell " + std::to_string(params.cellSize)
+            + " radius " + std::to_string(params.radiusMin) + ".." + std::to_string(params.radiusMax)
+            + " chance " + std::to_string(params.chance) + " footprint " + std::to_string(count)
+            + " step " + std::to_string(step) + " at (" + std::to_string(originX) + "," + std::to_string(originZ) + ")";
+    }
+
+    void runEquivalence() {
+        constexpr int kParamSets = 600;
+        const int counts[] = {16, 32, 64, 128};
+        std::mt19937 rng(0x0e5e);
+        OreVeinPlan::Grid grid;  // reused across plans like a worker would
+        std::vector<int8_t> planned;
+        size_t columns = 0;
+        size_t withOre = 0;
+        size_t mismatches = 0;
+        for (int set = 0; set < kParamSets && mismatches < 10; ++set) {
+            const OreVeinPlan::Params params = randomParams(rng);
+            for (int count : counts) {
+                for (int lod = 0; lod <= 3; ++lod) {
+                    const int step = 1 << lod;
+                    // Section origins sit on multiples of the section span.
+                    const int span = count * step;
+                    const int originX = std::uniform_int_distribution<int>(-40, 40)(rng) * span;
+                    const int originZ = std::uniform_int_distribution<int>(-40, 40)(rng) * span;
+                    OreVeinPlan::planColumns(params, originX, originZ, count, step, grid, planned);
+                    check(planned.size() == static_cast<size_t>(count) * static_cast<size_t>(count),
+                          "plan size for " + describe(params, originX, originZ, count, step));
+                    for (int z = 0; z < count && mismatches < 10; ++z) {
+                        for (int x = 0; x < count; ++x) {
+                            const int worldX = originX + x * step;
+                            const int worldZ = originZ + z * step;
+                            const int expected = Legacy::oreVariantForColumn(params, worldX, worldZ);
+                            const int fromPlan = planned[static_cast<size_t>(z) * static_cast<size_t>(count) + static_cast<size_t>(x)];
+                            const int fromColumn = OreVeinPlan::variantForColumn(params, worldX, worldZ);
+                            columns += 1;
+                            withOre += expected >= 0 ? 1 : 0;
+                            if (fromPlan == expected && fromColumn == expected) continue;
+                            mismatches += 1;
+                            check(false, "column (" + std::to_string(worldX) + "," + std::to_string(worldZ) + "): old "
+                                  + std::to_string(expected) + ", plan " + std::to_string(fromPlan) + ", variantForColumn "
+                                  + std::to_string(fromColumn) + " for " + describe(params, originX, originZ, count, step));
+                            if (mismatches >= 10) break;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Disabled veins plan nothing, whatever the other settings.
+        OreVeinPlan::Params disabled = randomParams(rng);
+        disabled.enabled = false;
+        disabled.chance = 1.0f;
+        OreVeinPlan::planColumns(disabled, 0, 0, 64, 1, grid, planned);
+        check(std::all_of(planned.begin(), planned.end(), [](int8_t v) { return v == -1; }), "disabled plan placed ore");
+        check(OreVeinPlan::variantForColumn(disabled, 3, 5) == -1, "disabled variantForColumn placed ore");
+
+        std::printf("equivalence: %d parameter sets, %zu columns, %zu with ore, %zu mismatches\n",
+                    kParamSets, columns, withOre, mismatches);
+        check(withOre > columns / 20, "too few ore columns for the comparison to mean much");
+    }
+
+    void runBenchmark() {
+        std::printf("\nore variants for one section footprint (game defaults):\n");
+        std::printf("  %-18s %14s %14s %9s\n", "footprint", "per-column us", "plan us", "speedup");
+        const OreVeinPlan::Params params;
+        OreVeinPlan::Grid grid;
+        std::vector<int8_t> planned;
+        long long sink = 0;
+        struct Shape { int count; int step; };
+        for (const Shape shape : {Shape{32, 1}, Shape{64, 1}, Shape{128, 1}, Shape{64, 2}, Shape{64, 4}}) {
+            const int sections = std::max(16, (1 << 20) / (shape.count * shape.count));
+            const int span = shape.count * shape.step;
+            auto start = Clock::now();
+            for (int s = 0; s < sections; ++s) {
+                const int originX = (s % 32 - 16) * span;
+                const int originZ = (s / 32 - 16) * span;
+                for (int z = 0; z < shape.count; ++z) {
+                    for (int x = 0; x < shape.count; ++x) {
+                        sink += Legacy::oreVariantForColumn(params, originX + x * shape.step, originZ + z * shape.step);
+                    }
+                }
+            }
+            const double perColumnUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / sections;
+            start = Clock::now();
+            for (int s = 0; s < sections; ++s) {
+                const int originX = (s % 32 - 16) * span;
+                const int originZ = (s / 32 - 16) * span;
+                OreVeinPlan::planColumns(params, originX, originZ, shape.count, shape.step, grid, planned);
+                sink += planned[static_cast<size_t>(s) % planned.size()];
+            }
+            const double planUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / sections;
+            const std::string label = std::to_string(shape.count) + "^2 step " + std::to_string(shape.step);
+            std::printf("  %-18s %14.1f %14.1f %8.1fx\n", label.c_str(), perColumnUs, planUs, perColumnUs / planUs);
+        }
+        if (sink == 42) std::printf(" \n");
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    if (!benchOnly) runEquivalence();
+    runBenchmark();
+    if (g_failures > 0) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,305 @@
+// Standalone checks and benchmark for the ray-traced audio propagation
+// cache. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack and VST3 SDK include dirs> Tools/PropagationCacheCheck.cpp -o propagation_cache_check
+//   ./propagation_cache_check [--bench-only]
+//
+// Runs the same sequence of updates twice, once through the listener's
+// propagation cache and once with no cache, while blocks are placed and
+// removed near and far from the listener (each edit invalidated the way
+// BlockSelectionSystem does), sources move between cells, the listener moves
+// between cells and the ear frame turns by more than the probe tolerance.
+// Every update's rays, per-source sums and emitted states must be bitwise
+// identical, and the cache must actually have answered a good share of them.
+// Ends with the time per update with and without the cache for a still scene,
+// for edits outside the traced volume and for edits inside it. Exits nonzero
+// if any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/DampingBrickmap.h"
+#include "BaseSystem/Vst3Host.h"
+
+extern "C" double glfwGetTime(void) { return 0.0; }
+
+namespace {
+    DampingBrickmap g_bricks;
+}
+
+namespace BlockSelectionSystemLogic {
+    bool EnsureLocalCaches(BaseSystem&, const std::vector<Entity>&, const glm::vec3&, int) { return true; }
+    void EnsureAllCaches(BaseSystem&, const std::vector<Entity>&) {}
+    bool SampleBlockDamping(BaseSystem&, const glm::ivec3& cell, float& dampingOut) { return g_bricks.sample(cell, dampingOut); }
+    const DampingBrickmap* GetDampingBrickmap(BaseSystem&) { return &g_bricks; }
+}
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem&, const std::string&, int fallback) { return fallback; }
+}
+
+#include "BaseSystem/RayTracedAudioSystem.cpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kSources = 24;
+    constexpr int kRays = 256;
+    constexpr int kBounces = 6;
+    constexpr float kMaxDistance = 48.0f;
+    constexpr int kRoom = 30;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    const uint8_t kStone = DampingBrickmap::encodeDamping(0.6f);
+
+    // A closed room with two partitions and some pillars.
+    void buildWorld() {
+        g_bricks.clear();
+        std::mt19937 rng(11);
+        for (int a = -kRoom; a <= kRoom; ++a) {
+            for (int b = -kRoom; b <= kRoom; ++b) {
+                for (int side : {-kRoom, kRoom}) {
+                    g_bricks.setCell(glm::ivec3(side, a, b), kStone);
+                    g_bricks.setCell(glm::ivec3(a, side, b), kStone);
+                    g_bricks.setCell(glm::ivec3(a, b, side), kStone);
+                }
+            }
+        }
+        for (int wall = 0; wall < 2; ++wall) {
+            const int x = -10 + 20 * wall;
+            for (int y = -kRoom; y < 8; ++y)
+                for (int z = -kRoom; z < kRoom; ++z)
+                    if (std::abs(z - 12 * wall + 6) > 3) g_bricks.setCell(glm::ivec3(x, y, z), kStone);
+        }
+        for (int pillar = 0; pillar < 16; ++pillar) {
+            const glm::ivec3 base(static_cast<int>(rng() % 50) - 25, -kRoom + 1, static_cast<int>(rng() % 50) - 25);
+            for (int y = 0; y < 14; ++y) g_bricks.setCell(base + glm::ivec3(0, y, 0), kStone);
+        }
+    }
+
+    BaseSystem g_base;
+
+    // Places or clears `cell` and tells the tracer, as BlockSelectionSystem's
+    // add and remove paths do.
+    void edit(const glm::ivec3& cell, bool solid) {
+        g_bricks.setCell(cell, solid ? kStone : 0);
+        RayTracedAudioSystemLogic::InvalidatePropagationCell(g_base, cell);
+    }
+
+    glm::vec3 airPoint(std::mt19937& rng) {
+        while (true) {
+            const glm::vec3 p(static_cast<float>(rng() % (2 * kRoom - 4)) - kRoom + 2.37f,
+                              static_cast<float>(rng() % 20) - kRoom + 1.61f,
+                              static_cast<float>(rng() % (2 * kRoom - 4)) - kRoom + 2.53f);
+            if (g_bricks.cellValue(glm::ivec3(glm::floor(p))) == 0) return p;
+        }
+    }
+
+    struct Ears {
+        glm::vec3 forward, right, up;
+        explicit Ears(float yawDegrees) {
+            const float yaw = glm::radians(yawDegrees);
+            forward = glm::normalize(glm::vec3(std::cos(yaw), -0.1f, std::sin(yaw)));
+            right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+            up = glm::normalize(glm::cross(right, forward));
+        }
+    };
+
+    // One update as ProcessRayTracedAudio runs it.
+    void update(RayTraceBatch& batch, RayTracePropagationCache* propagation, AudioSourceStateBuffer& states,
+                const glm::vec3& listener, const std::vector<EntityInstance*>& sources, const Ears& ears) {
+        int version = 0;
+        RayTracedAudioSystemLogic::InitializeRayBatch(batch, listener, ears.right, sources, kRays, false, 0);
+        RayTracedAudioSystemLogic::TraceRayBatch(g_base, batch, propagation, kMaxDistance, kBounces, nullptr,
+                                                 glm::vec3(1.0f), glm::vec3(1.0f), glm::vec3(1.0f), glm::vec3(1.0f));
+        RayTracedAudioSystemLogic::EmitRayStates(g_base, batch, propagation, kMaxDistance, ears.forward, ears.right,
+                                                 ears.up, states, version, batch.finishedRays, true);
+    }
+
+    bool sameAccum(const RayTraceSourceAccum& a, const RayTraceSourceAccum& b) {
+        return a.greenHits == b.greenHits && a.greenChecks == b.greenChecks
+            && a.orangeVisibleWallSum == b.orangeVisibleWallSum && a.orangeVisibleChecks == b.orangeVisibleChecks
+            && a.orangeOccludedWallSum == b.orangeOccludedWallSum && a.orangeOccludedChecks == b.orangeOccludedChecks
+            && a.dirSum == b.dirSum && a.dirCount == b.dirCount;
+    }
+
+    bool sameState(const AudioSourceState& a, const AudioSourceState& b) {
+        return a.isOccluded == b.isOccluded && a.distanceGain == b.distanceGain && a.preFalloffGain == b.preFalloffGain
+            && a.echoDelaySeconds == b.echoDelaySeconds && a.echoGain == b.echoGain && a.escapeRatio == b.escapeRatio
+            && a.pan == b.pan && a.hfAlpha == b.hfAlpha && a.sourcePos == b.sourcePos && a.direction == b.direction;
+    }
+
+    bool sameBatch(const RayTraceBatch& a, const RayTraceBatch& b) {
+        if (a.rays.size() != b.rays.size() || a.accum.size() != b.accum.size()) return false;
+        for (size_t r = 0; r < a.rays.size(); ++r) {
+            const RayTraceRayState& x = a.rays[r];
+            const RayTraceRayState& y = b.rays[r];
+            if (x.pos != y.pos || x.dir != y.dir || x.escaped != y.escaped || x.blueLenSum != y.blueLenSum
+                || x.blueLenCount != y.blueLenCount || x.hits.size() != y.hits.size()) {
+                return false;
+            }
+            for (size_t h = 0; h < x.hits.size(); ++h) {
+                if (x.hits[h].pos != y.hits[h].pos || x.hits[h].hasBlue != y.hits[h].hasBlue) return false;
+            }
+        }
+        for (size_t s = 0; s < a.accum.size(); ++s) if (!sameAccum(a.accum[s], b.accum[s])) return false;
+        return a.escapeCount == b.escapeCount && a.blueLenSum == b.blueLenSum && a.blueLenMax == b.blueLenMax;
+    }
+
+    bool sameStates(const AudioSourceStateTable& a, const AudioSourceStateTable& b) {
+        if (a.ids != b.ids) return false;
+        for (int id : a.ids) if (!sameState(*a.find(id), *b.find(id))) return false;
+        return true;
+    }
+
+    void equivalence() {
+        buildWorld();
+        RayTracedAudioContext& rtAudio = *g_base.rayTracedAudio;
+        rtAudio.propagation = RayTracePropagationCache{};
+        AudioSourceStateBuffer cachedStates;
+        AudioSourceStateBuffer plainStates;
+        RayTraceBatch cachedBatch;
+        RayTraceBatch plainBatch;
+
+        std::mt19937 rng(3);
+        std::vector<EntityInstance> instances(kSources);
+        std::vector<EntityInstance*> sources;
+        for (int s = 0; s < kSources; ++s) {
+            instances[s].instanceID = 5 + 2 * s;
+            instances[s].position = airPoint(rng);
+            sources.push_back(&instances[s]);
+        }
+        // Distinct cells: within one cell the listener's rays are reused by
+        // design, so only a move to another cell has an exact uncached twin.
+        const glm::vec3 listeners[] = {glm::vec3(-3.4f, -20.3f, 2.2f), glm::vec3(4.6f, -22.7f, -5.1f), glm::vec3(-6.1f, -20.3f, 7.8f)};
+        int listenerIndex = 0;
+        const Ears earFrames[] = {Ears(20.0f), Ears(65.0f)};
+        int earIndex = 0;
+
+        constexpr int kUpdates = 240;
+        int fieldReused = 0;
+        int sourcesReused = 0;
+        int probesReused = 0;
+        int wrongBatches = 0;
+        int wrongStates = 0;
+        int nearEdits = 0;
+        int farEdits = 0;
+        for (int u = 0; u < kUpdates; ++u) {
+            const int event = static_cast<int>(rng() % 12);
+            const glm::ivec3 listenerCell(glm::floor(listeners[listenerIndex]));
+            if (event < 3) {
+                // Near the listener: inside the traced volume.
+                const glm::ivec3 cell = listenerCell + glm::ivec3(static_cast<int>(rng() % 9) - 4, static_cast<int>(rng() % 5) - 2,
+                                                                  static_cast<int>(rng() % 9) - 4);
+                if (cell != listenerCell) edit(cell, rng() % 2 == 0);
+                nearEdits += 1;
+            } else if (event < 6) {
+                // Outside the room, where no path reaches.
+                edit(glm::ivec3(kRoom + 3 + static_cast<int>(rng() % 20), static_cast<int>(rng() % 20),
+                                static_cast<int>(rng() % 20)), rng() % 2 == 0);
+                farEdits += 1;
+            } else if (event == 6) {
+                instances[rng() % kSources].position = airPoint(rng);
+            } else if (event == 7) {
+                listenerIndex = (listenerIndex + 1) % 3;
+            } else if (event == 8) {
+                earIndex ^= 1;
+            }
+
+            const glm::vec3 listener = listeners[listenerIndex];
+            RayTracePropagationCache& cache = rtAudio.propagation;
+            if (cache.fieldValid && cache.listenerCell == glm::ivec3(glm::floor(listener))) fieldReused += 1;
+            for (const EntityInstance* source : sources) {
+                const RayTracePropagationEntry* entry = RayTracedAudioSystemLogic::findPropagationEntry(cache, source->position);
+                if (!entry) continue;
+                sourcesReused += 1;
+                if (entry->probesValid && glm::dot(entry->probeForward, earFrames[earIndex].forward) >= 0.97f) probesReused += 1;
+            }
+
+            update(cachedBatch, &cache, cachedStates, listener, sources, earFrames[earIndex]);
+            update(plainBatch, nullptr, plainStates, listener, sources, earFrames[earIndex]);
+            if (!sameBatch(cachedBatch, plainBatch)) wrongBatches += 1;
+            if (!sameStates(cachedStates.front(), plainStates.front())) wrongStates += 1;
+        }
+        check(wrongBatches == 0, "cached rays and per-source sums equal uncached ones, "
+                                     + std::to_string(wrongBatches) + " of " + std::to_string(kUpdates) + " updates differ");
+        check(wrongStates == 0, "cached source states equal uncached ones, "
+                                    + std::to_string(wrongStates) + " of " + std::to_string(kUpdates) + " updates differ");
+        check(fieldReused > kUpdates / 4, "the listener's rays are reused in " + std::to_string(fieldReused) + " updates");
+        check(sourcesReused > kUpdates * kSources / 8, "source entries are reused " + std::to_string(sourcesReused) + " times");
+        check(probesReused > 0 && probesReused < sourcesReused, "probe ratios are reused only while the ears hold still");
+        check(nearEdits > 0 && farEdits > 0, "edits land both near and far");
+        std::printf("%d updates, %d near and %d far edits: listener rays reused %d times, "
+                    "source entries %d of %d, probes %d\n",
+                    kUpdates, nearEdits, farEdits, fieldReused, sourcesReused, kUpdates * kSources, probesReused);
+    }
+
+    void benchmark() {
+        buildWorld();
+        RayTracedAudioContext& rtAudio = *g_base.rayTracedAudio;
+        std::mt19937 rng(8);
+        std::vector<EntityInstance> instances(kSources);
+        std::vector<EntityInstance*> sources;
+        for (int s = 0; s < kSources; ++s) {
+            instances[s].instanceID = s;
+            instances[s].position = airPoint(rng);
+            sources.push_back(&instances[s]);
+        }
+        const glm::vec3 listener(-3.4f, -20.3f, 2.2f);
+        const Ears ears(20.0f);
+        constexpr int kFrames = 40;
+        RayTraceBatch batch;
+        AudioSourceStateBuffer states;
+
+        auto run = [&](bool cached, int editEvery, bool near) {
+            rtAudio.propagation = RayTracePropagationCache{};
+            update(batch, cached ? &rtAudio.propagation : nullptr, states, listener, sources, ears);
+            const auto start = Clock::now();
+            for (int f = 0; f < kFrames; ++f) {
+                if (editEvery > 0 && f % editEvery == 0) {
+                    const glm::ivec3 cell = near ? glm::ivec3(0, -kRoom + 1, 14) : glm::ivec3(kRoom + 5, 0, 0);
+                    edit(cell, g_bricks.cellValue(cell) == 0);
+                }
+                update(batch, cached ? &rtAudio.propagation : nullptr, states, listener, sources, ears);
+            }
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+        };
+        const double plain = run(false, 0, false);
+        const double still = run(true, 0, false);
+        const double far = run(true, 1, false);
+        const double near = run(true, 10, true);
+        std::printf("ms per update, %d sources, %d rays x %d bounces:\n"
+                    "  no cache                       %8.3f\n"
+                    "  cache, still scene             %8.3f  (%.0fx)\n"
+                    "  cache, edit outside each frame %8.3f  (%.0fx)\n"
+                    "  cache, edit inside every 10th  %8.3f  (%.1fx)\n",
+                    kSources, kRays, kBounces, plain, still, plain / still, far, plain / far, near, plain / near);
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    g_base.rayTracedAudio = std::make_unique<RayTracedAudioContext>();
+    if (!benchOnly) equivalence();
+    benchmark();
+    g_base.rayTracedAudio.reset();
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
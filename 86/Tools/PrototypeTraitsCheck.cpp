@@ -0,0 +1,361 @@
+// Standalone equivalence check for the prototype trait table. Not part of the
+// game build:
+//
+//   g++ -std=c++17 -O2 -I. -I<glm> -I<dir holding json.hpp> Tools/PrototypeTraitsCheck.cpp -o prototype_traits_check
+//   ./prototype_traits_check
+//
+// Run from the repo root so Entities/ loads. Loads the prototypes in Host's
+// order and, separately, every prototype file under Entities/, adds synthetic
+// entries for the cases the files do not cover (affixed pebbles, animated
+// wireframe leaves, a duplicate name, a non-block named like a block, a solid
+// block in slot 0), and requires every trait test the voxel passes make to
+// agree with the name and flag predicates they used before the table, for
+// every id: tree and foliage placement, the meshing block classes, slope
+// directions and the first-match name lookup. Also checks the table follows a
+// reloaded or grown prototype list. Exits nonzero if any check fails.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include "json.hpp"
+using json = nlohmann::json;
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/PrototypeTraits.h"
+
+namespace {
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    // The predicates the tree, foliage and meshing passes used before the
+    // trait table, as they were written there.
+    namespace Legacy {
+        bool startsWith(const std::string& value, const char* prefix) {
+            const size_t prefixLen = std::strlen(prefix);
+            return value.size() >= prefixLen && value.compare(0, prefixLen, prefix) == 0;
+        }
+        bool endsWith(const std::string& value, const char* suffix) {
+            const size_t suffixLen = std::strlen(suffix);
+            return value.size() >= suffixLen && value.compare(value.size() - suffixLen, suffixLen, suffix) == 0;
+        }
+
+        bool isPineVerticalLogName(const std::string& name) {
+            return name == "FirLog1Tex" || name == "FirLog2Tex"
+                || name == "FirLog1TopTex" || name == "FirLog2TopTex";
+        }
+        bool isPineAnyLogName(const std::string& name) {
+            return isPineVerticalLogName(name)
+                || name == "FirLog1TexX" || name == "FirLog2TexX"
+                || name == "FirLog1TexZ" || name == "FirLog2TexZ"
+                || name == "FirLog1NubTexX" || name == "FirLog2NubTexX"
+                || name == "FirLog1NubTexZ" || name == "FirLog2NubTexZ";
+        }
+        bool isFoliageGround(const std::vector<Entity>& prototypes, int id, int waterPrototypeID) {
+            if (id <= 0 || id >= static_cast<int>(prototypes.size())) return false;
+            if (id == waterPrototypeID) return false;
+            const Entity& proto = prototypes[static_cast<size_t>(id)];
+            if (!proto.isBlock || !proto.isSolid) return false;
+            if (proto.name == "Leaf"
+                || proto.name == "GrassTuft"
+                || proto.name == "GrassTuftShort"
+                || proto.name == "Flower"
+                || proto.name == "StickTexX"
+                || proto.name == "StickTexZ"
+                || proto.name == "StonePebbleTexX"
+                || proto.name == "StonePebbleTexZ"
+                || proto.name == "WallStoneTexPosX"
+                || proto.name == "WallStoneTexNegX"
+                || proto.name == "WallStoneTexPosZ"
+                || proto.name == "WallStoneTexNegZ"
+                || proto.name == "CeilingStoneTexX"
+                || proto.name == "CeilingStoneTexZ") return false;
+            return true;
+        }
+        bool isGrassSurfacePrototypeName(const std::string& name) {
+            return name == "GrassBlockTex" || name == "ScaffoldBlock";
+        }
+        bool isStoneSurfacePrototypeName(const std::string& name) {
+            return name == "StoneBlockTex" || name == "ScaffoldBlock";
+        }
+        bool isWallStonePrototypeName(const std::string& name) {
+            return name == "WallStoneTexPosX" || name == "WallStoneTexNegX"
+                || name == "WallStoneTexPosZ" || name == "WallStoneTexNegZ";
+        }
+
+        PrototypeTraits::SlopeDir slopeDirForPrototype(const Entity& proto) {
+            if (proto.name == "DebugSlopeTexPosX") return PrototypeTraits::SlopeDir::PosX;
+            if (proto.name == "DebugSlopeTexNegX") return PrototypeTraits::SlopeDir::NegX;
+            if (proto.name == "DebugSlopeTexPosZ") return PrototypeTraits::SlopeDir::PosZ;
+            if (proto.name == "DebugSlopeTexNegZ") return PrototypeTraits::SlopeDir::NegZ;
+            return PrototypeTraits::SlopeDir::None;
+        }
+        bool isLeafPrototype(const Entity& proto) {
+            return proto.name == "Leaf" || (proto.isAnimated && proto.hasWireframe && !proto.isSolid);
+        }
+        bool isPlantPrototype(const Entity& proto) {
+            return proto.name == "GrassTuft" || proto.name == "GrassTuftShort" || proto.name == "Flower";
+        }
+        bool isStonePebbleXName(const std::string& name) {
+            return name == "StonePebbleTexX" || (startsWith(name, "StonePebble") && endsWith(name, "TexX"));
+        }
+        bool isStonePebbleZName(const std::string& name) {
+            return name == "StonePebbleTexZ" || (startsWith(name, "StonePebble") && endsWith(name, "TexZ"));
+        }
+        bool isNarrowLogPrototype(const Entity& proto) {
+            const std::string& name = proto.name;
+            return isPineAnyLogName(name)
+                || name == "StickTexX" || name == "StickTexZ"
+                || isStonePebbleXName(name) || isStonePebbleZName(name)
+                || name == "CeilingStoneTexX" || name == "CeilingStoneTexZ"
+                || isWallStonePrototypeName(name);
+        }
+
+        const Entity* findPrototype(const std::string& name, const std::vector<Entity>& prototypes) {
+            for (const Entity& proto : prototypes) {
+                if (proto.name == name) return &proto;
+            }
+            return nullptr;
+        }
+    }
+
+    // The block class the greedy mesher sorts each voxel into.
+    enum class MeshClass { Empty, Water, Slope, Leaf, Plant, Narrow, Cube };
+
+    MeshClass legacyMeshClass(const std::vector<Entity>& prototypes, uint32_t id) {
+        if (id == 0 || id >= prototypes.size()) return MeshClass::Empty;
+        const Entity& proto = prototypes[id];
+        if (!proto.isBlock) return MeshClass::Empty;
+        if (proto.name == "Water") return MeshClass::Water;
+        if (Legacy::slopeDirForPrototype(proto) != PrototypeTraits::SlopeDir::None) return MeshClass::Slope;
+        if (Legacy::isLeafPrototype(proto)) return MeshClass::Leaf;
+        if (Legacy::isPlantPrototype(proto)) return MeshClass::Plant;
+        if (Legacy::isNarrowLogPrototype(proto)) return MeshClass::Narrow;
+        return MeshClass::Cube;
+    }
+
+    MeshClass tableMeshClass(const PrototypeTraits::Table& traits, uint32_t id) {
+        using namespace PrototypeTraits;
+        if (id == 0 || !traits.has(id, Block)) return MeshClass::Empty;
+        if (traits.has(id, Water)) return MeshClass::Water;
+        if (traits.has(id, CaveSlope)) return MeshClass::Slope;
+        if (traits.has(id, MeshLeaf)) return MeshClass::Leaf;
+        if (traits.has(id, Plant)) return MeshClass::Plant;
+        if (traits.has(id, NarrowLog)) return MeshClass::Narrow;
+        return MeshClass::Cube;
+    }
+
+    void loadEntityFile(const std::filesystem::path& path, std::vector<Entity>& prototypes) {
+        std::ifstream in(path);
+        if (!in.is_open()) return;
+        auto add = [&](const json& item) {
+            Entity entity = item.get<Entity>();
+            entity.prototypeID = static_cast<int>(prototypes.size());
+            prototypes.push_back(entity);
+        };
+        try {
+            json data = json::parse(in);
+            if (data.is_array()) {
+                for (const auto& item : data) add(item);
+            } else {
+                add(data);
+            }
+        } catch (const std::exception& e) {
+            check(false, path.string() + " does not load as prototypes: " + e.what());
+        }
+    }
+
+    std::vector<std::filesystem::path> jsonFilesUnder(const std::string& dir) {
+        std::vector<std::filesystem::path> files;
+        std::error_code ec;
+        if (!std::filesystem::exists(dir, ec)) return files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(dir, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".json") files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    // Same files in the same order as Host::PopulateWorldsFromLevel, so ids
+    // and first-match lookups are the game's.
+    std::vector<Entity> loadHostPrototypes() {
+        const std::vector<std::string> entityFiles = {
+            "Entities/Block.json", "Entities/Leaf.json", "Entities/Branch.json", "Entities/TexturedBlock.json", "Entities/Star.json", "Entities/Water.json",
+            "Entities/World.json", "Entities/DebugWorldGenerator.json",
+            "Entities/Audicles/UAV.json", "Entities/AudioVisualizer.json", "Entities/Microphone.json", "Entities/Computer.json",
+            "Entities/ScaffoldBlock.json",
+            "Entities/Faces.json",
+            "Entities/Foliage.json"
+        };
+        std::vector<Entity> prototypes;
+        for (const std::string& file : entityFiles) loadEntityFile(file, prototypes);
+        for (const auto& path : jsonFilesUnder("Entities/UI")) loadEntityFile(path, prototypes);
+        return prototypes;
+    }
+
+    // Every prototype file under Entities/, including ones Host does not
+    // load at startup, in path order.
+    std::vector<Entity> loadAllPrototypes(size_t& fileCount) {
+        const std::vector<std::filesystem::path> files = jsonFilesUnder("Entities");
+        fileCount = files.size();
+        std::vector<Entity> prototypes;
+        for (const auto& path : files) loadEntityFile(path, prototypes);
+        return prototypes;
+    }
+
+    void addSynthetic(std::vector<Entity>& prototypes) {
+        auto add = [&](const std::string& name, bool block, bool solid) -> Entity& {
+            Entity entity;
+            entity.name = name;
+            entity.isBlock = block;
+            entity.isSolid = solid;
+            entity.isRenderable = block;
+            entity.prototypeID = static_cast<int>(prototypes.size());
+            prototypes.push_back(entity);
+            return prototypes.back();
+        };
+        add("StonePebbleMossyTexX", true, true);
+        add("StonePebbleMossyTexZ", true, true);
+        add("StonePebbleTex", true, true);
+        Entity& vine = add("HangingVine", true, false);
+        vine.isAnimated = true;
+        vine.hasWireframe = true;
+        Entity& solidVine = add("SolidVine", true, true);
+        solidVine.isAnimated = true;
+        solidVine.hasWireframe = true;
+        add("StoneBlockTex", true, false);  // a second, non-solid stone: lookups take the first
+        add("Water", false, false);          // a non-block water; the first Water still wins
+        add("FirLog1Tex", false, false);
+        add("", true, true);
+    }
+
+    const char* meshClassName(MeshClass c) {
+        switch (c) {
+            case MeshClass::Empty: return "empty";
+            case MeshClass::Water: return "water";
+            case MeshClass::Slope: return "slope";
+            case MeshClass::Leaf: return "leaf";
+            case MeshClass::Plant: return "plant";
+            case MeshClass::Narrow: return "narrow";
+            case MeshClass::Cube: return "cube";
+        }
+        return "?";
+    }
+
+    void compareAll(const std::vector<Entity>& prototypes, const std::string& label) {
+        using namespace PrototypeTraits;
+        const Table& traits = For(prototypes);
+        check(traits.bits.size() == prototypes.size(), label + ": table size differs from the prototype list");
+        const Entity* water = Legacy::findPrototype("Water", prototypes);
+        const int waterID = water ? water->prototypeID : -1;
+
+        for (size_t i = 0; i < prototypes.size(); ++i) {
+            const uint32_t id = static_cast<uint32_t>(i);
+            const Entity& proto = prototypes[i];
+            const std::string what = label + ": id " + std::to_string(i) + " \"" + proto.name + "\" ";
+
+            // TreeGenerationSystem.
+            check(traits.has(id, PineVerticalLog) == Legacy::isPineVerticalLogName(proto.name), what + "vertical pine log");
+            check(traits.has(id, PineLog) == Legacy::isPineAnyLogName(proto.name), what + "pine log");
+            check(traits.has(id, Leaf) == (proto.name == "Leaf"), what + "leaf");
+            check((static_cast<int>(id) != waterID && traits.has(id, FoliageGround))
+                      == Legacy::isFoliageGround(prototypes, static_cast<int>(id), waterID),
+                  what + "foliage ground");
+            check(traits.has(id, GrassSurface) == Legacy::isGrassSurfacePrototypeName(proto.name), what + "grass surface");
+            const bool legacyStoneSupport = id != 0u && proto.isBlock && proto.isSolid
+                && Legacy::isStoneSurfacePrototypeName(proto.name);
+            check((id != 0u && traits.has(id, Block | Solid | StoneSurface)) == legacyStoneSupport, what + "stone support");
+            check((id != 0u && traits.has(id, WallStone)) == (id != 0u && Legacy::isWallStonePrototypeName(proto.name)),
+                  what + "wall stone");
+            const bool legacySolidGround = id != 0u && proto.isBlock && proto.isSolid && proto.name != "Water";
+            check((id != 0u && traits.has(id, Block | Solid) && !traits.has(id, Water)) == legacySolidGround,
+                  what + "solid non-water ground");
+            const bool legacyBlockNotWater = proto.isBlock && proto.name != "Water";
+            check((traits.has(id, Block) && !traits.has(id, Water)) == legacyBlockNotWater, what + "block other than water");
+            check(traits.has(id, Water) == (proto.name == "Water"), what + "water");
+
+            // VoxelMeshingSystem.
+            const MeshClass expected = legacyMeshClass(prototypes, id);
+            const MeshClass got = tableMeshClass(traits, id);
+            check(got == expected, what + "meshes as " + meshClassName(got) + ", was " + meshClassName(expected));
+            check(traits.slope(id) == Legacy::slopeDirForPrototype(proto), what + "slope direction");
+            check(traits.has(id, NarrowLog) == Legacy::isNarrowLogPrototype(proto), what + "narrow log");
+
+            // Name lookups (TerrainGenerationSystem and the tree pass).
+            check(findPrototype(proto.name, prototypes) == Legacy::findPrototype(proto.name, prototypes),
+                  what + "name lookup");
+        }
+        check(findPrototype("NoSuchPrototype", prototypes) == nullptr, label + ": lookup of a missing name");
+        check(!traits.has(static_cast<uint32_t>(prototypes.size()), Block), label + ": id past the end has traits");
+    }
+
+    // The same prototypes reloaded into a new vector, then grown, must not be
+    // answered from the table built for the old one.
+    void checkRefresh(const std::vector<Entity>& prototypes) {
+        using namespace PrototypeTraits;
+        std::vector<Entity> reloaded = prototypes;
+        for (Entity& proto : reloaded) {
+            if (proto.name == "Leaf") proto.name = "LeafRenamed";
+        }
+        const Table& traits = For(reloaded);
+        check(traits.source == reloaded.data(), "table not rebuilt for a reloaded prototype list");
+        check(findPrototype("Leaf", reloaded) == Legacy::findPrototype("Leaf", reloaded),
+              "renamed prototype still found under its old name");
+        compareAll(reloaded, "reloaded");
+
+        reloaded.reserve(reloaded.size() + 1);
+        For(reloaded);
+        Entity extra;
+        extra.name = "LateBlock";
+        extra.isBlock = true;
+        extra.isSolid = true;
+        extra.prototypeID = static_cast<int>(reloaded.size());
+        reloaded.push_back(extra);
+        check(findPrototype("LateBlock", reloaded) == &reloaded.back(), "prototype appended in place not found");
+        compareAll(reloaded, "grown");
+    }
+}
+
+int main() {
+    std::vector<Entity> prototypes = loadHostPrototypes();
+    if (!check(!prototypes.empty(), "no prototypes under Entities/ (run from the repo root)")) return 1;
+    const size_t hostCount = prototypes.size();
+    compareAll(prototypes, "Host load order");
+
+    size_t fileCount = 0;
+    const std::vector<Entity> everything = loadAllPrototypes(fileCount);
+    compareAll(everything, "all of Entities/");
+
+    addSynthetic(prototypes);
+    compareAll(prototypes, "with synthetic");
+
+    // Slot 0 is air to the voxel passes whatever prototype sits there.
+    std::vector<Entity> solidFirst = prototypes;
+    solidFirst[0].isBlock = true;
+    solidFirst[0].isSolid = true;
+    check(!PrototypeTraits::For(solidFirst).has(0u, PrototypeTraits::FoliageGround), "id 0 counts as foliage ground");
+    compareAll(solidFirst, "solid slot 0");
+
+    checkRefresh(prototypes);
+
+    std::printf("%zu prototypes as Host loads them, %zu from all %zu files under Entities/, %zu synthetic\n",
+                hostCount, everything.size(), fileCount, prototypes.size() - hostCount);
+    if (g_failures > 0) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("ok\n");
+    return 0;
+}
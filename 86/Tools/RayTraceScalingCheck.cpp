@@ -0,0 +1,287 @@
+// Standalone determinism checks and thread-scaling benchmark for the audio
+// ray tracer's worker pool. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack and VST3 SDK include dirs> Tools/RayTraceScalingCheck.cpp -o ray_trace_scaling_check
+//   ./ray_trace_scaling_check [--bench-only]
+//
+// First drives RayTraceWorkerPool directly: every run() must call each task
+// index exactly once, for counts from 0 up and over many back-to-back runs,
+// and AudioSourceStateTable must keep ids, lookups and clears consistent.
+// Then traces the same batches (rays, bounces, per-source sums and the
+// emitted AudioSourceStateTable, over two updates so the previous table is
+// blended in) with 0, 1, 2, 3, 4, 7 and 15 helper threads; every result must
+// be bitwise identical to the single-threaded one, and repeated runs at the
+// highest count too. Ends with the batch time per thread count. Exits nonzero
+// if any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/DampingBrickmap.h"
+#include "BaseSystem/Vst3Host.h"
+
+extern "C" double glfwGetTime(void) { return 0.0; }
+
+namespace {
+    DampingBrickmap g_bricks;
+    int g_workerThreads = 0;
+}
+
+namespace BlockSelectionSystemLogic {
+    bool EnsureLocalCaches(BaseSystem&, const std::vector<Entity>&, const glm::vec3&, int) { return true; }
+    void EnsureAllCaches(BaseSystem&, const std::vector<Entity>&) {}
+    bool SampleBlockDamping(BaseSystem&, const glm::ivec3& cell, float& dampingOut) { return g_bricks.sample(cell, dampingOut); }
+    const DampingBrickmap* GetDampingBrickmap(BaseSystem&) { return &g_bricks; }
+}
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem&, const std::string& key, int fallback) {
+        return key == "RayTracedAudioWorkerThreads" ? g_workerThreads : fallback;
+    }
+}
+
+#include "BaseSystem/RayTracedAudioSystem.cpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kSources = 48;
+    constexpr int kRays = 512;
+    constexpr int kBounces = 6;
+    constexpr float kMaxDistance = 64.0f;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    void poolRuns() {
+        for (int workers : {0, 1, 3, 8}) {
+            RayTraceWorkerPool pool(workers);
+            std::mt19937 rng(static_cast<uint32_t>(workers));
+            size_t wrong = 0;
+            for (int run = 0; run < 2000; ++run) {
+                const size_t count = run < 20 ? static_cast<size_t>(run) : rng() % 300;
+                std::vector<std::atomic<int>> calls(count);
+                for (auto& c : calls) c.store(0);
+                pool.run(count, [&](size_t i) { calls[i].fetch_add(1, std::memory_order_relaxed); });
+                for (auto& c : calls) wrong += c.load() != 1 ? 1 : 0;
+            }
+            check(wrong == 0, "pool with " + std::to_string(workers) + " workers runs every task once, "
+                                  + std::to_string(wrong) + " misses or repeats");
+        }
+    }
+
+    void stateTable() {
+        AudioSourceStateTable table;
+        std::mt19937 rng(5);
+        std::vector<int> expected;
+        for (int round = 0; round < 50; ++round) {
+            table.clear();
+            expected.clear();
+            std::vector<uint8_t> seen(600, 0);
+            const int n = static_cast<int>(rng() % 120);
+            for (int i = 0; i < n; ++i) {
+                const int id = static_cast<int>(rng() % 600);
+                table.insert(id).pan = static_cast<float>(id);
+                if (!seen[static_cast<size_t>(id)]) expected.push_back(id);
+                seen[static_cast<size_t>(id)] = 1;
+            }
+            bool ok = table.ids == expected && table.size() == expected.size();
+            for (int id = -1; id < 700; ++id) {
+                const bool in = id >= 0 && id < 600 && seen[static_cast<size_t>(id)];
+                const AudioSourceState* state = table.find(id);
+                ok = ok && table.contains(id) == in && (state != nullptr) == in && (!state || state->pan == id);
+            }
+            if (!check(ok, "state table round " + std::to_string(round) + " keeps ids and lookups consistent")) return;
+        }
+        AudioSourceStateBuffer buffer;
+        buffer.back().insert(3);
+        buffer.publish();
+        check(buffer.front().contains(3) && !buffer.back().contains(3), "state buffer publishes back to front");
+    }
+
+    BaseSystem g_base;
+
+    void buildWorld() {
+        g_bricks.clear();
+        std::mt19937 rng(11);
+        const uint8_t stone = DampingBrickmap::encodeDamping(0.6f);
+        // A closed room with a few interior walls and pillars, so rays
+        // bounce several times and sight lines are sometimes blocked.
+        for (int a = -40; a <= 40; ++a) {
+            for (int b = -40; b <= 40; ++b) {
+                for (int side : {-40, 40}) {
+                    g_bricks.setCell(glm::ivec3(side, a, b), stone);
+                    g_bricks.setCell(glm::ivec3(a, side, b), stone);
+                    g_bricks.setCell(glm::ivec3(a, b, side), stone);
+                }
+            }
+        }
+        for (int wall = 0; wall < 4; ++wall) {
+            const int x = -25 + 15 * wall;
+            for (int y = -40; y < 10; ++y)
+                for (int z = -40; z < 40; ++z)
+                    if (std::abs(z - 10 * wall + 15) > 3) g_bricks.setCell(glm::ivec3(x, y, z), stone);
+        }
+        for (int pillar = 0; pillar < 30; ++pillar) {
+            const glm::ivec3 base(static_cast<int>(rng() % 70) - 35, -39, static_cast<int>(rng() % 70) - 35);
+            for (int y = 0; y < 20; ++y) g_bricks.setCell(base + glm::ivec3(0, y, 0), stone);
+        }
+    }
+
+    struct Result {
+        std::vector<RayTraceRayState> rays;
+        std::vector<RayTraceSourceAccum> accum;
+        std::vector<AudioSourceState> states;
+        int escapes = 0;
+        float blueLenSum = 0.0f;
+        float blueLenMax = 0.0f;
+    };
+
+    bool sameAccum(const RayTraceSourceAccum& a, const RayTraceSourceAccum& b) {
+        return a.greenHits == b.greenHits && a.greenChecks == b.greenChecks
+            && a.orangeVisibleWallSum == b.orangeVisibleWallSum && a.orangeVisibleChecks == b.orangeVisibleChecks
+            && a.orangeOccludedWallSum == b.orangeOccludedWallSum && a.orangeOccludedChecks == b.orangeOccludedChecks
+            && a.dirSum == b.dirSum && a.dirCount == b.dirCount;
+    }
+
+    bool sameState(const AudioSourceState& a, const AudioSourceState& b) {
+        return a.isOccluded == b.isOccluded && a.distanceGain == b.distanceGain && a.preFalloffGain == b.preFalloffGain
+            && a.echoDelaySeconds == b.echoDelaySeconds && a.echoGain == b.echoGain && a.escapeRatio == b.escapeRatio
+            && a.pan == b.pan && a.hfAlpha == b.hfAlpha && a.sourcePos == b.sourcePos && a.direction == b.direction;
+    }
+
+    bool sameRays(const std::vector<RayTraceRayState>& a, const std::vector<RayTraceRayState>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t r = 0; r < a.size(); ++r) {
+            const RayTraceRayState& x = a[r];
+            const RayTraceRayState& y = b[r];
+            if (x.pos != y.pos || x.dir != y.dir || x.escaped != y.escaped || x.blueLenSum != y.blueLenSum
+                || x.blueLenCount != y.blueLenCount || x.blueLenMax != y.blueLenMax || x.hits.size() != y.hits.size()) {
+                return false;
+            }
+            for (size_t h = 0; h < x.hits.size(); ++h) {
+                if (x.hits[h].pos != y.hits[h].pos || x.hits[h].from != y.hits[h].from
+                    || x.hits[h].hasBlue != y.hits[h].hasBlue || x.hits[h].blueDir != y.hits[h].blueDir) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Two updates from nearby listener positions with the same sources and
+    // no propagation cache, as ProcessRayTracedAudio runs them.
+    Result traceScene(int threads, int rays, double* seconds = nullptr) {
+        g_workerThreads = threads;
+        RayTracedAudioContext& rtAudio = *g_base.rayTracedAudio;
+        rtAudio.sourceStates.clear();
+        std::mt19937 rng(21);
+        std::vector<EntityInstance> instances(kSources);
+        std::vector<EntityInstance*> sources;
+        for (int s = 0; s < kSources; ++s) {
+            instances[s].instanceID = 7 + 3 * s;
+            instances[s].position = glm::vec3(static_cast<float>(rng() % 70) - 34.5f, static_cast<float>(rng() % 30) - 30.5f,
+                                              static_cast<float>(rng() % 70) - 34.5f);
+            sources.push_back(&instances[s]);
+        }
+        Result result;
+        const glm::vec3 earForward = glm::normalize(glm::vec3(0.3f, 0.0f, -1.0f));
+        const glm::vec3 earRight = glm::normalize(glm::cross(earForward, glm::vec3(0.0f, 1.0f, 0.0f)));
+        const glm::vec3 earUp = glm::normalize(glm::cross(earRight, earForward));
+        const auto start = Clock::now();
+        for (const glm::vec3 listener : {glm::vec3(-3.3f, -20.2f, 4.1f), glm::vec3(-2.6f, -20.2f, 4.9f)}) {
+            RayTraceBatch& batch = rtAudio.batch;
+            RayTracedAudioSystemLogic::InitializeRayBatch(batch, listener, earRight, sources, rays, false, 0);
+            RayTracedAudioSystemLogic::TraceRayBatch(g_base, batch, nullptr, kMaxDistance, kBounces, nullptr,
+                                                     glm::vec3(1.0f), glm::vec3(1.0f), glm::vec3(1.0f), glm::vec3(1.0f));
+            RayTracedAudioSystemLogic::EmitRayStates(g_base, batch, nullptr, kMaxDistance, earForward, earRight, earUp,
+                                                     rtAudio.sourceStates, rtAudio.sourceStatesVersion,
+                                                     batch.finishedRays, true);
+        }
+        if (seconds) *seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const RayTraceBatch& batch = rtAudio.batch;
+        result.rays = batch.rays;
+        result.accum = batch.accum;
+        result.escapes = batch.escapeCount;
+        result.blueLenSum = batch.blueLenSum;
+        result.blueLenMax = batch.blueLenMax;
+        const AudioSourceStateTable& table = rtAudio.sourceStates.front();
+        for (int id : table.ids) result.states.push_back(table.slots[static_cast<size_t>(id)]);
+        return result;
+    }
+
+    bool sameResult(const Result& a, const Result& b) {
+        if (!sameRays(a.rays, b.rays) || a.accum.size() != b.accum.size() || a.states.size() != b.states.size()) return false;
+        for (size_t i = 0; i < a.accum.size(); ++i) if (!sameAccum(a.accum[i], b.accum[i])) return false;
+        for (size_t i = 0; i < a.states.size(); ++i) if (!sameState(a.states[i], b.states[i])) return false;
+        return a.escapes == b.escapes && a.blueLenSum == b.blueLenSum && a.blueLenMax == b.blueLenMax;
+    }
+
+    const int kThreadCounts[] = {0, 1, 2, 3, 4, 7, 15};
+
+    void determinism() {
+        const Result reference = traceScene(0, kRays);
+        size_t hits = 0;
+        for (const auto& ray : reference.rays) hits += ray.hits.size();
+        int clear = 0;
+        for (const auto& state : reference.states) clear += state.distanceGain == 1.0f ? 1 : 0;
+        check(reference.states.size() == kSources, "every source gets a state");
+        check(hits > kRays && reference.escapes < kRays, "rays bounce inside the room");
+        check(clear > 0 && clear < kSources, "some sources are in clear sight and some are muffled");
+        for (int threads : kThreadCounts) {
+            check(sameResult(traceScene(threads, kRays), reference),
+                  std::to_string(threads) + " helper threads give the single-threaded result");
+        }
+        for (int repeat = 0; repeat < 5; ++repeat) {
+            check(sameResult(traceScene(15, kRays), reference), "repeat " + std::to_string(repeat) + " with 15 helpers is unchanged");
+        }
+    }
+
+    void scaling() {
+        const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        double baseline = 0.0;
+        std::printf("%d sources, %d rays x %d bounces, two updates (%u hardware threads):\n",
+                    kSources, 2 * kRays, kBounces, hardware);
+        for (int threads : kThreadCounts) {
+            traceScene(threads, 2 * kRays);  // warm the pool and caches
+            double best = 1.0e30;
+            for (int run = 0; run < 2; ++run) {
+                double seconds = 0.0;
+                traceScene(threads, 2 * kRays, &seconds);
+                best = std::min(best, seconds);
+            }
+            if (threads == 0) baseline = best;
+            std::printf("  %2d helpers: %8.2f ms  %.2fx\n", threads, best * 1000.0, baseline / best);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    g_base.rayTracedAudio = std::make_unique<RayTracedAudioContext>();
+    buildWorld();
+    if (!benchOnly) {
+        poolRuns();
+        stateTable();
+        determinism();
+    }
+    scaling();
+    g_base.rayTracedAudio.reset();
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
@@ -0,0 +1,275 @@
+// Standalone fixed-scene check of the render systems against the recording
+// render device. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. -I<glm> -I<dir holding json.hpp> -I<glad, GLFW, jack, ChucK and VST3 SDK include dirs> Tools/RenderDeviceScene.cpp -o render_device_scene
+//   ./render_device_scene
+//
+// Drives the real sky/godray pass, greedy voxel upload, UI batch flush and
+// Shader through the recording backend, no GPU involved. The scene is fixed:
+// four greedy sections of 1200 faces (every tenth translucent), 500 stars, three
+// scissor-clipped UI panels and glyph runs on two atlases. The first frame
+// must make exactly 13 draws and upload exactly the face, star and UI bytes,
+// with every instance buffer sized to its instance count. A steady frame
+// must stay inside a 13-draw, stars-plus-UI upload budget that the first
+// frame exceeds, reuse the UI ring and restore the viewport after the godray
+// pass. The per-flush mapping fallback must count the same UI bytes. Exits
+// nonzero if any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <cstdio>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/RenderDeviceRecording.h"
+#include "BaseSystem/Vst3Host.h"
+
+namespace RenderInitSystemLogic {
+    RenderBehavior BehaviorForPrototype(const Entity&) { return RenderBehavior::STATIC_DEFAULT; }
+    void DestroyVoxelGreedyRenderBuffers(VoxelGreedyRenderBuffers&) {}
+    void DestroyChunkRenderBuffers(ChunkRenderBuffers&) {}
+    int getRegistryInt(const BaseSystem&, const std::string&, int fallback) { return fallback; }
+    bool getRegistryBool(const BaseSystem&, const std::string&, bool fallback) { return fallback; }
+    bool shouldRenderVoxelSection(const BaseSystem&, const VoxelSection&, const glm::vec3&) { return true; }
+}
+namespace VoxelMeshInitSystemLogic {
+    glm::vec3 UnpackColor(uint32_t) { return glm::vec3(1.0f); }
+}
+
+#include "Host/HostShader.cpp"
+#include "BaseSystem/SkyboxSystem.cpp"
+#include "BaseSystem/VoxelMeshUploadSystem.cpp"
+#include "BaseSystem/UIBatchSystem.cpp"
+
+namespace {
+    using Op = RenderDevice::Op;
+
+    constexpr int kSections = 4;
+    constexpr int kFacesPerSection = 1200;
+    constexpr int kStars = 500;
+    constexpr int kPanels = 3;
+    constexpr int kPanelVertices = 6 * 40;
+    constexpr int kGlyphVertices = 6 * 20;
+    constexpr uint32_t kAtlases[2] = {7, 8};
+    // Sky: sun and moon occlusion, radial blur, skybox, stars, sun and moon,
+    // composite. UI: one draw per clipped panel and per atlas.
+    constexpr uint32_t kSceneDraws = 8 + kPanels + 2;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    struct ColorVertex {
+        glm::vec2 pos;
+        glm::vec3 color;
+    };
+
+    struct Scene {
+        RenderDevice::Device device;
+        BaseSystem base;
+        std::vector<Entity> prototypes;
+        std::vector<GreedyChunkData> chunks;
+        std::vector<glm::vec3> stars;
+        std::vector<ColorVertex> panel;
+        std::vector<UIBatch::Vertex> glyphs;
+        glm::mat4 view{1.0f};
+        glm::mat4 projection{1.0f};
+
+        Scene() {
+            RenderDevice::setCurrent(&device);
+            device.viewport(0, 0, 1920, 1080);
+            base.renderer = std::make_unique<RendererContext>();
+            base.world = std::make_unique<WorldContext>();
+            RendererContext& renderer = *base.renderer;
+            for (auto* shader : {&renderer.sunMoonShader, &renderer.godrayRadialShader, &renderer.godrayCompositeShader,
+                                 &renderer.skyboxShader, &renderer.starShader}) {
+                *shader = std::make_unique<Shader>("", "");
+            }
+            renderer.faceVBO = device.createBuffer();
+            renderer.starVAO = device.createVertexArray();
+            renderer.starVBO = device.createBuffer();
+            base.world->skyKeys = {{0.0f, glm::vec3(0.1f), glm::vec3(0.0f)}, {1.0f, glm::vec3(0.2f), glm::vec3(0.1f)}};
+
+            chunks.resize(kSections);
+            for (GreedyChunkData& chunk : chunks) {
+                for (int i = 0; i < kFacesPerSection; ++i) {
+                    chunk.positions.push_back(glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+                    chunk.faceTypes.push_back(i % 6);
+                    chunk.alphas.push_back(i % 10 == 0 ? 0.5f : 1.0f);
+                }
+            }
+            stars.assign(kStars, glm::vec3(0.0f, 1.0f, 0.0f));
+            panel.resize(kPanelVertices);
+            glyphs.resize(kGlyphVertices);
+        }
+
+        ~Scene() { RenderDevice::setCurrent(nullptr); }
+
+        UIBatch::Clip panelClip(int index) const {
+            UIBatch::Clip clip;
+            clip.enabled = true;
+            clip.x = index * 100;
+            clip.w = 100;
+            clip.h = 100;
+            return clip;
+        }
+
+        void submitUI() {
+            UIBatch::Builder& ui = UIBatchSystemLogic::Frame(base);
+            for (int i = 0; i < kPanels; ++i) ui.addColored(panel, 1.0f, panelClip(i));
+            for (uint32_t atlas : kAtlases) {
+                ui.addPacked(UIBatch::Program::Text, atlas, glyphs.data(), glyphs.size(), 1.0f);
+            }
+        }
+
+        // One frame in the order WorldRenderSystem draws it. The voxel
+        // sections are only rebuilt when asked, as after an edit.
+        std::vector<VoxelGreedyRenderBuffers> frame(bool rebuild) {
+            std::vector<VoxelGreedyRenderBuffers> buffers(chunks.size());
+            if (rebuild) {
+                for (size_t i = 0; i < chunks.size(); ++i) {
+                    VoxelMeshUploadSystemLogic::BuildVoxelGreedyRenderBuffers(*base.renderer, chunks[i], buffers[i]);
+                }
+            }
+            glm::vec3 lightDir(0.0f);
+            SkyboxSystemLogic::RenderSkyAndCelestials(base, prototypes, stars, 1.0f, 0.5f, view, projection,
+                                                      glm::vec3(0.0f), lightDir);
+            submitUI();
+            UIBatchSystemLogic::Flush(base);
+            device.endFrame();
+            base.frameIndex += 1;
+            return buffers;
+        }
+    };
+
+    const size_t kFaceBytes = kSections * kFacesPerSection * sizeof(FaceInstanceRenderData);
+    const size_t kStarBytes = kStars * sizeof(glm::vec3);
+    const size_t kUIBytes = (kPanels * kPanelVertices + 2 * kGlyphVertices) * sizeof(UIBatch::Vertex);
+
+    size_t countSince(const RenderDevice::Device& device, size_t begin, Op op) {
+        size_t count = 0;
+        for (size_t i = begin; i < device.backend().commands.size(); ++i) {
+            if (device.backend().commands[i].op == op) count += 1;
+        }
+        return count;
+    }
+
+    void printStats(const char* label, const RenderDevice::FrameStats& stats) {
+        std::printf("%s: %u draws, %llu vertices, %u uploads, %zu bytes, %u program binds, %u uniforms\n", label,
+                    stats.drawCalls, static_cast<unsigned long long>(stats.vertices), stats.uploads,
+                    stats.uploadBytes, stats.programBinds, stats.uniformSets);
+    }
+
+    void firstFrame(Scene& scene) {
+        RenderDevice::Device& device = scene.device;
+        const size_t begin = device.backend().commands.size();
+        const std::vector<VoxelGreedyRenderBuffers> built = scene.frame(true);
+        const RenderDevice::FrameStats& stats = device.lastFrameStats();
+        printStats("frame 1", stats);
+
+        check(stats.drawCalls == kSceneDraws, "first frame makes " + std::to_string(kSceneDraws) + " draws, made "
+              + std::to_string(stats.drawCalls));
+        check(countSince(device, begin, Op::DrawArrays) + countSince(device, begin, Op::DrawArraysInstanced)
+              == stats.drawCalls, "recorded draws match the counted draws");
+        check(stats.uploadBytes == kFaceBytes + kStarBytes + kUIBytes,
+              "first frame uploads faces, stars and UI, uploaded " + std::to_string(stats.uploadBytes));
+        check(device.backend().bufferBytes(scene.base.renderer->starVBO) == kStarBytes, "star buffer holds every star");
+
+        int faces = 0;
+        for (const VoxelGreedyRenderBuffers& buffers : built) {
+            for (int face = 0; face < 6; ++face) {
+                faces += buffers.opaqueCounts[face] + buffers.alphaCounts[face];
+                check(device.backend().bufferBytes(buffers.opaqueVBOs[face])
+                      == static_cast<size_t>(buffers.opaqueCounts[face]) * sizeof(FaceInstanceRenderData),
+                      "opaque instance buffer matches its count");
+                check(device.backend().bufferBytes(buffers.alphaVBOs[face])
+                      == static_cast<size_t>(buffers.alphaCounts[face]) * sizeof(FaceInstanceRenderData),
+                      "translucent instance buffer matches its count");
+            }
+            check(buffers.alphaCounts[0] + buffers.alphaCounts[1] + buffers.alphaCounts[2] + buffers.alphaCounts[3]
+                  + buffers.alphaCounts[4] + buffers.alphaCounts[5] == kFacesPerSection / 10,
+                  "every tenth face goes to the translucent pass");
+        }
+        check(faces == kSections * kFacesPerSection, "every face lands in an instance buffer");
+
+        // Each panel's scissor rect and each atlas is set once, in order.
+        std::vector<UIBatch::Clip> scissors;
+        std::vector<uint32_t> textures;
+        for (size_t i = begin; i < device.backend().commands.size(); ++i) {
+            const auto& command = device.backend().commands[i];
+            if (command.op == Op::Scissor) {
+                UIBatch::Clip clip;
+                clip.enabled = true;
+                clip.x = static_cast<int>(command.a);
+                clip.y = static_cast<int>(command.b);
+                clip.w = static_cast<int>(command.c);
+                clip.h = static_cast<int>(command.d);
+                scissors.push_back(clip);
+            } else if (command.op == Op::BindTexture && command.b == GL_TEXTURE_2D
+                       && (command.a == kAtlases[0] || command.a == kAtlases[1])) {
+                textures.push_back(command.a);
+            }
+        }
+        bool panelsClipped = scissors.size() == kPanels;
+        for (int i = 0; panelsClipped && i < kPanels; ++i) panelsClipped = scissors[i] == scene.panelClip(i);
+        check(panelsClipped, "each panel is drawn under its own scissor rect");
+        check(textures == std::vector<uint32_t>(std::begin(kAtlases), std::end(kAtlases)), "each atlas is bound once");
+        check(device.backend().count(Op::BufferStorage) == 1, "the UI ring gets its storage once");
+    }
+
+    void steadyFrame(Scene& scene) {
+        RenderDevice::Device& device = scene.device;
+        const RenderDevice::FrameStats first = device.lastFrameStats();
+        scene.frame(false);
+        const RenderDevice::FrameStats& steady = device.lastFrameStats();
+        printStats("frame 2", steady);
+
+        RenderDevice::Budget budget;
+        budget.maxDrawCalls = kSceneDraws;
+        budget.maxUploadBytes = kStarBytes + kUIBytes;
+        check(!RenderDevice::overDrawBudget(steady, budget), "steady frame stays inside the draw budget");
+        check(!RenderDevice::overUploadBudget(steady, budget), "steady frame stays inside the upload budget");
+        check(RenderDevice::overUploadBudget(first, budget), "the rebuild frame exceeds the upload budget");
+        check(device.backend().count(Op::BufferStorage) == 1, "the UI ring is reused, not respecified");
+
+        int32_t viewport[4] = {};
+        device.getViewport(viewport);
+        check(viewport[0] == 0 && viewport[1] == 0 && viewport[2] == 1920 && viewport[3] == 1080,
+              "the viewport is restored after the godray pass");
+    }
+
+    void mappingFallback(Scene& scene) {
+        RenderDevice::Device& device = scene.device;
+        UIBatchSystemLogic::CleanupUIBatch(scene.base, scene.prototypes, 0.0f, nullptr);
+        device.backend().bufferStorageAvailable = false;
+        const size_t storageBefore = device.backend().count(Op::BufferStorage);
+        scene.submitUI();
+        UIBatchSystemLogic::Flush(scene.base);
+        device.endFrame();
+        const RenderDevice::FrameStats& stats = device.lastFrameStats();
+        printStats("fallback", stats);
+        check(stats.uploadBytes == kUIBytes, "per-flush mapping counts the UI bytes");
+        check(stats.drawCalls == kPanels + 2, "per-flush mapping draws the same UI");
+        check(device.backend().count(Op::BufferStorage) == storageBefore, "no immutable storage without buffer storage");
+        UIBatchSystemLogic::CleanupUIBatch(scene.base, scene.prototypes, 0.0f, nullptr);
+    }
+}
+
+int main() {
+    Scene scene;
+    firstFrame(scene);
+    steadyFrame(scene);
+    mappingFallback(scene);
+    std::cout << scene.device.backend().commands.size() << " commands recorded\n";
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
@@ -0,0 +1,216 @@
+// Standalone checks for SessionBinary. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. -I<dir holding json.hpp> Tools/SessionBinaryCheck.cpp -o session_binary_check
+//   ./session_binary_check
+//
+// Builds session roots shaped like the ones DawIO writes and checks that
+// split/encode/decode/join gives them back unchanged, that an edit to one
+// track changes only that track's chunk, that every truncation and every
+// single flipped byte is rejected, and that saveFileAtomic, the .bak
+// recovery and loadFile behave on disk. Exits nonzero if any check fails.
+
+#include <iostream>
+#include <random>
+
+#include "BaseSystem/SessionBinary.h"
+
+namespace {
+    using nlohmann::json;
+    namespace fs = std::filesystem;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    json makeSession(std::mt19937& rng, int audioTracks, int midiTracks, int notesPerClip) {
+        json root;
+        root["format"] = "salamander_session";
+        root["version"] = 3;
+        root["asset_dir"] = "check_assets";
+        root["sample_rate"] = 48000.0;
+        root["timeline"] = {{"seconds_per_screen", 10.0}, {"offset_samples", 0}};
+        root["transport"] = {{"bpm", 120.0}, {"loop_enabled", true}, {"loop_start", 0}, {"loop_end", 192000}};
+        root["lane_order"] = json::array({{{"type", "audio"}, {"index", 0}}});
+
+        json pool = json::array();
+        for (int i = 0; i < audioTracks * 2; ++i) {
+            pool.push_back({{"id", i}, {"file", "take_" + std::to_string(i) + ".wav"}, {"valid", true},
+                            {"content_hash", std::to_string(rng())}, {"channels", 1 + i % 2},
+                            {"frames", static_cast<uint64_t>(rng() % 5000000)}});
+        }
+        root["audio_pool"] = pool;
+
+        json audio = json::array();
+        for (int t = 0; t < audioTracks; ++t) {
+            json clips = json::array();
+            for (int c = 0; c < 6; ++c) {
+                clips.push_back({{"audio_id", (t * 2 + c) % (audioTracks * 2)},
+                                 {"start_sample", static_cast<uint64_t>(c) * 96000},
+                                 {"length", 48000 + static_cast<int>(rng() % 48000)},
+                                 {"source_offset", 0}, {"take_id", c}});
+            }
+            audio.push_back({{"arm_mode", 0}, {"mute", t == 1}, {"solo", false}, {"output_bus", 0},
+                             {"gain", 0.5 + 0.125 * t}, {"clips", clips}});
+        }
+        root["audio_tracks"] = audio;
+
+        json midi = json::array();
+        for (int t = 0; t < midiTracks; ++t) {
+            json notes = json::array();
+            for (int n = 0; n < notesPerClip; ++n) {
+                notes.push_back({{"pitch", 36 + static_cast<int>(rng() % 48)},
+                                 {"start_sample", static_cast<uint64_t>(n) * 6000},
+                                 {"length", 3000}, {"velocity", 0.25 + (rng() % 64) / 128.0}});
+            }
+            midi.push_back({{"clips", json::array({{{"start_sample", 0}, {"length", 192000},
+                                                     {"take_id", 0}, {"notes", notes}}})},
+                            {"plugin", {{"name", "Synth"}, {"class_id", "0123456789ABCDEF"},
+                                        {"is_instrument", true}, {"parameters", json::array()}}}});
+        }
+        root["midi_tracks"] = midi;
+
+        json automation = json::array();
+        automation.push_back({{"clips", json::array({{{"start_sample", 0}, {"length", 96000}, {"take_id", 0},
+                                                      {"points", json::array({{{"offset_sample", 0}, {"value", 0.0}},
+                                                                              {{"offset_sample", 48000}, {"value", 1.0}}})}}})}});
+        root["automation_tracks"] = automation;
+        return root;
+    }
+
+    // Truncation and corruption decode the whole file once per byte, so they
+    // only run on the small sessions.
+    void roundTrip(const json& root, const std::string& label, bool corrupt) {
+        const std::vector<SessionBinary::Chunk> chunks = SessionBinary::split(root);
+        const std::vector<uint8_t> bytes = SessionBinary::encode(chunks);
+        std::vector<SessionBinary::Chunk> decoded;
+        std::string error;
+        if (!check(SessionBinary::decode(bytes.data(), bytes.size(), decoded, error), label + ": decode " + error)) return;
+        json joined;
+        if (!check(SessionBinary::join(decoded, joined, error), label + ": join " + error)) return;
+        check(joined == root, label + ": join(decode(encode(split))) gives the root back");
+        check(SessionBinary::encode(SessionBinary::split(joined)) == bytes, label + ": re-encoding is byte-identical");
+        if (!corrupt) return;
+
+        for (size_t cut = 0; cut < bytes.size(); ++cut) {
+            std::vector<SessionBinary::Chunk> partial;
+            if (!check(!SessionBinary::decode(bytes.data(), cut, partial, error),
+                       label + ": truncation at " + std::to_string(cut) + " is rejected")) {
+                break;
+            }
+        }
+        std::vector<uint8_t> flipped = bytes;
+        for (size_t i = 0; i < flipped.size(); ++i) {
+            flipped[i] ^= 0x5a;
+            std::vector<SessionBinary::Chunk> damaged;
+            const bool accepted = SessionBinary::decode(flipped.data(), flipped.size(), damaged, error);
+            flipped[i] ^= 0x5a;
+            if (!check(!accepted, label + ": flipped byte " + std::to_string(i) + " is rejected")) break;
+        }
+    }
+
+    void editTouchesOneChunk(std::mt19937& rng) {
+        const json before = makeSession(rng, 4, 3, 64);
+        json after = before;
+        after["midi_tracks"][1]["clips"][0]["notes"][5]["velocity"] = 1.0;
+        const std::vector<SessionBinary::Chunk> a = SessionBinary::split(before);
+        const std::vector<SessionBinary::Chunk> b = SessionBinary::split(after);
+        if (!check(a.size() == b.size(), "edit keeps the chunk count")) return;
+        size_t changed = 0;
+        size_t changedIndex = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            check(a[i].id == b[i].id, "edit keeps the chunk order");
+            if (a[i].hash != b[i].hash) {
+                changed += 1;
+                changedIndex = i;
+            }
+        }
+        check(changed == 1, "a note edit changes exactly one chunk hash");
+        check(b[changedIndex].id == SessionBinary::kMidiTrack, "the changed chunk is a MIDI track");
+        check(SessionBinary::combinedHash(a) != SessionBinary::combinedHash(b), "the combined hash changes");
+        check(SessionBinary::combinedHash(a) == SessionBinary::combinedHash(SessionBinary::split(before)),
+              "the combined hash is stable for an unchanged root");
+    }
+
+    void unknownChunksAreSkipped(std::mt19937& rng) {
+        const json root = makeSession(rng, 2, 1, 8);
+        std::vector<SessionBinary::Chunk> chunks = SessionBinary::split(root);
+        chunks.insert(chunks.begin() + 1, SessionBinary::makeChunk(SessionBinary::chunkId("XTRA"), json{{"later", 1}}));
+        const std::vector<uint8_t> bytes = SessionBinary::encode(chunks);
+        std::vector<SessionBinary::Chunk> decoded;
+        json joined;
+        std::string error;
+        check(SessionBinary::decode(bytes.data(), bytes.size(), decoded, error)
+              && SessionBinary::join(decoded, joined, error) && joined == root,
+              "an unknown chunk is skipped on join");
+
+        std::vector<SessionBinary::Chunk> headless(chunks.begin() + 1, chunks.end());
+        check(!SessionBinary::join(headless, joined, error), "join without HEAD fails");
+    }
+
+    void fileChecks(std::mt19937& rng) {
+        const fs::path dir = fs::temp_directory_path() / "session_binary_check";
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+        fs::create_directories(dir);
+        const fs::path path = dir / "session.slms";
+        std::string error;
+
+        const json first = makeSession(rng, 3, 2, 16);
+        const json second = makeSession(rng, 5, 4, 32);
+        check(SessionBinary::saveFileAtomic(path, SessionBinary::encode(SessionBinary::split(first)), error),
+              "first atomic save " + error);
+        check(SessionBinary::saveFileAtomic(path, SessionBinary::encode(SessionBinary::split(second)), error),
+              "atomic save over an existing file " + error);
+        check(!fs::exists(dir / "session.slms.tmp") && !fs::exists(SessionBinary::backupPathFor(path)),
+              "atomic save leaves no temp or backup file");
+        check(SessionBinary::isBinaryFile(path), "saved file is recognised as binary");
+
+        json loaded;
+        check(SessionBinary::loadFile(path, loaded, error) && loaded == second, "loadFile returns the last save");
+
+        // A save that died after moving the old file aside.
+        fs::rename(path, SessionBinary::backupPathFor(path));
+        check(SessionBinary::recoverInterruptedSave(path), "recovery restores the backup");
+        check(SessionBinary::loadFile(path, loaded, error) && loaded == second, "recovered file loads");
+        check(SessionBinary::recoverInterruptedSave(path), "recovery is a no-op when the file exists");
+
+        const fs::path missing = dir / "missing.slms";
+        check(!SessionBinary::recoverInterruptedSave(missing), "recovery of a missing file without backup fails");
+        check(!SessionBinary::loadFile(missing, loaded, error), "loadFile of a missing file fails");
+        check(!SessionBinary::isBinaryFile(missing), "a missing file is not binary");
+
+        const fs::path jsonPath = dir / "session.json";
+        std::ofstream(jsonPath) << first.dump();
+        check(!SessionBinary::isBinaryFile(jsonPath), "a JSON session is not binary");
+
+        const fs::path blocked = dir / "no_such_dir" / "session.slms";
+        check(!SessionBinary::saveFileAtomic(blocked, {1, 2, 3}, error), "saving into a missing directory fails");
+        fs::remove_all(dir, ec);
+    }
+}
+
+int main() {
+    std::mt19937 rng(0x51a5);
+    roundTrip(makeSession(rng, 0, 0, 0), "empty tracks", true);
+    roundTrip(makeSession(rng, 2, 2, 16), "small session", true);
+    const json large = makeSession(rng, 16, 16, 512);
+    roundTrip(large, "large session", false);
+    editTouchesOneChunk(rng);
+    unknownChunksAreSkipped(rng);
+    fileChecks(rng);
+
+    const size_t jsonBytes = large.dump().size();
+    const size_t binaryBytes = SessionBinary::encode(SessionBinary::split(large)).size();
+    std::cout << "large session: " << binaryBytes << " bytes binary vs " << jsonBytes << " bytes JSON\n";
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
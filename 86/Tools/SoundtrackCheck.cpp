@@ -0,0 +1,333 @@
+// Standalone checks for the soundtrack loader and its hand-off to the audio
+// callback. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack, ChucK and VST3 SDK include dirs> Tools/SoundtrackCheck.cpp <jack and ChucK libs> -o soundtrack_check
+//   ./soundtrack_check
+//
+// Measures the resampler's frequency response on pure tones for 44.1 to 48,
+// 48 to 44.1 and 96 to 48 kHz: tones below 80% of the output Nyquist must
+// come through within 0.05 dB, tones that would alias must be at least 90 dB
+// down. Then cancels loads through a real loader thread: a load cancelled
+// mid-resample finishes promptly without a result or a cache file, a queued
+// load cancelled before it starts never runs, the next load of the same
+// file still succeeds, a second load is served from the cache with the same
+// samples, and destroying the loader mid-load joins promptly. Last, the
+// offline driver renders on its own thread as the callback would while the
+// main thread publishes and replaces head tracks; every block must play one
+// whole published track. Exits nonzero if any check fails.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <thread>
+
+namespace PinkNoiseSystemLogic {
+    float generate_filtered_pink_noise(AudioContext*) { return 0.0f; }
+}
+namespace RenderInitSystemLogic {
+    int getRegistryInt(const BaseSystem&, const std::string&, int fallback) { return fallback; }
+}
+namespace ChucKSystemLogic {
+    void DispatchSfxTriggers(AudioContext&) {}
+}
+namespace DawRecordSystemLogic {
+    void WriteRecordInputRT(DawTrack&, const float*, const float*, size_t) {}
+}
+namespace DawStreamSystemLogic {
+    size_t ReadStreamFramesRT(DawContext&, const DawClipAudio&, uint64_t, size_t, float*, float*) { return 0; }
+}
+
+#include "BaseSystem/AudioSystem.cpp"
+#include "BaseSystem/SoundtrackSystem.cpp"
+
+namespace Vst3SystemLogic {
+    void EnsureMidiTrackCount(Vst3Context&, int) {}
+    bool ProcessEffectChainStereo(Vst3Context&, Vst3TrackChain&, const float*, const float*, float*, float*,
+                                  int, int64_t, bool) { return false; }
+    bool ProcessEffectChain(Vst3Context&, Vst3TrackChain&, const float*, float*, int, int64_t, bool) { return false; }
+    bool ProcessInstrument(Vst3Context&, Vst3TrackChain&, Vst3Plugin&, float*, int, int64_t, bool,
+                           const std::array<float, 128>&, std::array<float, 128>&) { return false; }
+}
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    namespace fs = std::filesystem;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    std::vector<float> tone(uint32_t rate, double hz, size_t frames) {
+        std::vector<float> out(frames);
+        for (size_t i = 0; i < frames; ++i) {
+            out[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * hz * static_cast<double>(i) / rate));
+        }
+        return out;
+    }
+
+    // Gain of the tone at `hz` in `signal`, from a least-squares fit of a
+    // sine and cosine over the middle half (clear of the edge transients),
+    // and the RMS of everything else, both relative to amplitude 0.5.
+    void measure(const std::vector<float>& signal, uint32_t rate, double hz, double& gain, double& residual) {
+        const size_t begin = signal.size() / 4;
+        const size_t end = signal.size() * 3 / 4;
+        double ss = 0.0, cc = 0.0, sc = 0.0, ys = 0.0, yc = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            const double phase = 2.0 * M_PI * hz * static_cast<double>(i) / rate;
+            const double s = std::sin(phase);
+            const double c = std::cos(phase);
+            ss += s * s;
+            cc += c * c;
+            sc += s * c;
+            ys += signal[i] * s;
+            yc += signal[i] * c;
+        }
+        const double det = ss * cc - sc * sc;
+        const double a = (ys * cc - yc * sc) / det;
+        const double b = (yc * ss - ys * sc) / det;
+        gain = std::sqrt(a * a + b * b) / 0.5;
+        double rest = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            const double phase = 2.0 * M_PI * hz * static_cast<double>(i) / rate;
+            const double e = signal[i] - (a * std::sin(phase) + b * std::cos(phase));
+            rest += e * e;
+        }
+        residual = std::sqrt(rest / static_cast<double>(end - begin)) / (0.5 / std::sqrt(2.0));
+    }
+
+    double dB(double ratio) { return 20.0 * std::log10(std::max(ratio, 1.0e-12)); }
+
+    void frequencyResponse() {
+        const std::atomic<bool> never{false};
+        struct Pair { uint32_t from; uint32_t to; };
+        for (const Pair pair : {Pair{44100, 48000}, Pair{48000, 44100}, Pair{96000, 48000}}) {
+            const double outNyquist = 0.5 * std::min(pair.from, pair.to);
+            double worstPass = 0.0;
+            double worstStop = -300.0;
+            for (double fraction : {0.01, 0.1, 0.3, 0.5, 0.7, 0.8}) {
+                const double hz = fraction * outNyquist;
+                SoundtrackAudio in;
+                in.sampleRate = pair.from;
+                in.left = tone(pair.from, hz, pair.from / 2);
+                SoundtrackAudio out;
+                SoundtrackSystemLogic::resampleSinc(in, pair.to, never, out);
+                double gain = 0.0, residual = 0.0;
+                measure(out.left, pair.to, hz, gain, residual);
+                worstPass = std::max(worstPass, std::abs(dB(gain)));
+                check(std::abs(dB(gain)) < 0.05, std::to_string(pair.from) + "->" + std::to_string(pair.to) + ": "
+                                                     + std::to_string(hz) + " Hz passes at " + std::to_string(dB(gain)) + " dB");
+                check(dB(residual) < -90.0, std::to_string(pair.from) + "->" + std::to_string(pair.to) + ": "
+                                                + std::to_string(hz) + " Hz adds " + std::to_string(dB(residual)) + " dB of other content");
+            }
+            // Only a conversion down has input content above the output Nyquist.
+            if (pair.to < pair.from) {
+                for (double fraction : {1.07, 1.2, 1.5, 1.9}) {
+                    const double hz = fraction * outNyquist;
+                    if (hz >= 0.5 * pair.from) continue;
+                    SoundtrackAudio in;
+                    in.sampleRate = pair.from;
+                    in.left = tone(pair.from, hz, pair.from / 2);
+                    SoundtrackAudio out;
+                    SoundtrackSystemLogic::resampleSinc(in, pair.to, never, out);
+                    double gain = 0.0, residual = 0.0;
+                    // Any tone left over lands at its alias; the RMS covers it.
+                    measure(out.left, pair.to, std::abs(pair.to - hz), gain, residual);
+                    const double level = dB(std::sqrt(gain * gain + residual * residual));
+                    worstStop = std::max(worstStop, level);
+                    check(level < -90.0, std::to_string(pair.from) + "->" + std::to_string(pair.to) + ": "
+                                             + std::to_string(hz) + " Hz aliases at " + std::to_string(level) + " dB");
+                }
+            }
+            std::printf("%u -> %u: passband within %.4f dB", pair.from, pair.to, worstPass);
+            if (worstStop > -300.0) std::printf(", worst alias %.1f dB", worstStop);
+            std::printf("\n");
+        }
+    }
+
+    std::unique_ptr<SoundtrackLoader> startLoader(const std::string& cacheDir) {
+        auto loader = std::make_unique<SoundtrackLoader>();
+        loader->cacheDir = cacheDir;
+        SoundtrackLoader* raw = loader.get();
+        loader->worker = std::thread([raw]() { SoundtrackSystemLogic::runWorker(*raw); });
+        return loader;
+    }
+
+    bool waitDone(const std::shared_ptr<SoundtrackLoadJob>& job, double timeoutMs, double& tookMs) {
+        const auto start = Clock::now();
+        while (!job->done.load(std::memory_order_acquire)) {
+            tookMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (tookMs > timeoutMs) return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        tookMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return true;
+    }
+
+    size_t cacheFiles(const std::string& dir, bool partial) {
+        size_t count = 0;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            const bool isPart = entry.path().extension() == ".part";
+            if (isPart == partial) count += 1;
+        }
+        return count;
+    }
+
+    void loadCancellation() {
+        const fs::path root = fs::temp_directory_path() / "soundtrack_check";
+        std::error_code ec;
+        fs::remove_all(root, ec);
+        fs::create_directories(root / "cache", ec);
+        const std::string cacheDir = (root / "cache").string();
+        const std::string path = (root / "long.wav").string();
+
+        // Two minutes of stereo at 44.1 kHz: long enough that converting it
+        // to 48 kHz takes a while.
+        {
+            const size_t frames = 44100 * 120;
+            std::vector<float> left = tone(44100, 440.0, frames);
+            std::vector<float> right = tone(44100, 660.0, frames);
+            WavStreamWriter writer;
+            check(writer.open(path, 2, 44100, false) && writer.writePlanar(left.data(), right.data(), frames)
+                      && writer.close(), "cancel: source WAV written");
+        }
+
+        {
+            std::unique_ptr<SoundtrackLoader> loader = startLoader(cacheDir);
+            auto running = SoundtrackSystemLogic::submitLoad(*loader, path, true, 48000);
+            auto queued = SoundtrackSystemLogic::submitLoad(*loader, path, true, 48000);
+            // Let the first job get into its decode or resample.
+            while (true) {
+                std::lock_guard<std::mutex> lock(loader->mutex);
+                if (loader->current == running) break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            auto cancelledRunning = running;
+            auto cancelledQueued = queued;
+            SoundtrackSystemLogic::cancelLoad(running);
+            SoundtrackSystemLogic::cancelLoad(queued);
+            double tookMs = 0.0;
+            const bool stopped = waitDone(cancelledRunning, 1000.0, tookMs);
+            check(stopped && tookMs < 50.0,
+                  "cancel: a running load stops within 50 ms, took " + std::to_string(tookMs) + " ms");
+            check(!cancelledRunning->ok && cancelledRunning->audio.left.empty(), "cancel: a cancelled load has no result");
+            double queuedMs = 0.0;
+            check(waitDone(cancelledQueued, 1000.0, queuedMs), "cancel: a queued load cancelled early still finishes");
+            check(!cancelledQueued->ok, "cancel: a load cancelled before it starts never runs");
+            check(cacheFiles(cacheDir, false) == 0 && cacheFiles(cacheDir, true) == 0,
+                  "cancel: no cache file is left by a cancelled conversion");
+            std::printf("cancelling a running load took %.2f ms\n", tookMs);
+
+            // The same file loads normally afterwards.
+            auto fresh = SoundtrackSystemLogic::submitLoad(*loader, path, true, 48000);
+            double freshMs = 0.0;
+            check(waitDone(fresh, 60000.0, freshMs) && fresh->ok, "cancel: the next load of the file succeeds");
+            check(fresh->audio.sampleRate == 48000 && fresh->audio.left.size() == 48000 * 120
+                      && fresh->audio.right.size() == fresh->audio.left.size(),
+                  "cancel: the converted track has the expected length");
+            check(cacheFiles(cacheDir, false) == 1, "cancel: a finished conversion is cached");
+
+            auto cached = SoundtrackSystemLogic::submitLoad(*loader, path, true, 48000);
+            double cachedMs = 0.0;
+            check(waitDone(cached, 60000.0, cachedMs) && cached->ok, "cancel: the cached load succeeds");
+            check(cached->audio.left == fresh->audio.left && cached->audio.right == fresh->audio.right,
+                  "cancel: the cached track matches the converted one");
+            std::printf("converting took %.0f ms, loading from the cache %.0f ms\n", freshMs, cachedMs);
+
+            // Tearing the loader down cancels a load in flight and joins. A
+            // rate with nothing cached forces a fresh conversion.
+            auto abandoned = SoundtrackSystemLogic::submitLoad(*loader, path, true, 44100 + 1);
+            while (true) {
+                std::lock_guard<std::mutex> lock(loader->mutex);
+                if (loader->current == abandoned) break;
+            }
+            const auto teardown = Clock::now();
+            loader.reset();
+            const double teardownMs = std::chrono::duration<double, std::milli>(Clock::now() - teardown).count();
+            check(teardownMs < 50.0, "cancel: destroying the loader mid-load joins within 50 ms, took "
+                                         + std::to_string(teardownMs) + " ms");
+        }
+        fs::remove_all(root, ec);
+    }
+
+    void handoff() {
+        constexpr uint32_t kRate = 48000;
+        constexpr uint32_t kBlock = 256;
+        constexpr int kTracks = 2000;
+        AudioContext audio;
+        audio.sampleRate = static_cast<float>(kRate);
+        audio.jackOutputChannels = 2;
+        audio.jackInputChannels = 0;
+        audio.soundtrackLevelGain.store(1.0f);
+        AudioSystemLogic::OpenOfflineAudio(audio, kRate, kBlock);
+        AudioSystemLogic::StartOfflineCapture(audio, "", true);
+
+        // Track k is a constant k, so a block built from a freed or
+        // half-replaced track shows up as a value nobody published.
+        std::atomic<bool> stop{false};
+        std::thread callback([&]() {
+            while (!stop.load()) AudioSystemLogic::RenderOfflineBlocks(audio, 1);
+        });
+        for (int k = 1; k <= kTracks; ++k) {
+            auto* track = new SoundtrackSlot::Track();
+            track->audio.sampleRate = kRate;
+            track->audio.left.assign(kBlock * (1 + k % 7), static_cast<float>(k));
+            track->audio.right.assign(track->audio.left.size(), static_cast<float>(k));
+            track->start = true;
+            track->gain = 1.0f;
+            track->loop = true;
+            SoundtrackSystemLogic::publishTrack(audio.headTrack, track);
+            std::this_thread::sleep_for(std::chrono::microseconds(k % 3 == 0 ? 0 : 50));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        stop.store(true);
+        callback.join();
+        AudioSystemLogic::StopOfflineCapture(audio);
+        SoundtrackSystemLogic::publishTrack(audio.headTrack, nullptr);
+
+        const std::vector<float>& left = audio.offlineDriver->captured[0];
+        const std::vector<float>& right = audio.offlineDriver->captured[1];
+        size_t mixedBlocks = 0;
+        size_t strangeBlocks = 0;
+        std::set<int> heard;
+        float lastValue = 0.0f;
+        size_t backwards = 0;
+        for (size_t block = 0; block + kBlock <= left.size(); block += kBlock) {
+            const float value = left[block];
+            bool whole = true;
+            for (size_t i = block; i < block + kBlock; ++i) whole = whole && left[i] == value && right[i] == value;
+            if (!whole) mixedBlocks += 1;
+            const float track = value * 2.0f;  // the callback mixes at half level
+            if (track != std::floor(track) || track < 0.0f || track > kTracks) strangeBlocks += 1;
+            else if (track > 0.0f) heard.insert(static_cast<int>(track));
+            if (track < lastValue) backwards += 1;
+            lastValue = std::max(lastValue, track);
+        }
+        check(mixedBlocks == 0, "handoff: every block plays one track, " + std::to_string(mixedBlocks) + " mixed");
+        check(strangeBlocks == 0, "handoff: every block plays a published track, " + std::to_string(strangeBlocks) + " did not");
+        check(backwards == 0, "handoff: tracks are adopted in publishing order");
+        check(!heard.empty() && *heard.rbegin() == kTracks, "handoff: the last published track is the one playing");
+        std::printf("handoff: %zu of %d tracks heard over %zu blocks\n", heard.size(), kTracks, left.size() / kBlock);
+    }
+}
+
+int main() {
+    frequencyResponse();
+    loadCancellation();
+    handoff();
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
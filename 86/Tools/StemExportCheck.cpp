@@ -0,0 +1,292 @@
+// Standalone checks for the background stem export. Not part of the game
+// build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> -I<jack, ChucK and VST3 SDK include dirs> Tools/StemExportCheck.cpp -o stem_export_check
+//   ./stem_export_check [--update]
+//
+// Run from the repo root. Exports a fixed session through StartStemExport and
+// TickStemExport, the way the export dialog does, and requires the four stem
+// files to be byte-identical to Tools/golden/stem_export/, which were written
+// by the synchronous exporter this worker replaced (8 blocks per frame tick,
+// whole stems held in memory, written at the end). The session covers a
+// stereo clip split across two buses, a mono clip summed onto one bus with a
+// source offset, a muted track, a rendered MIDI track, clips that start
+// before the export range and a range that does not end on a block edge.
+// Also checks that a cancelled export leaves no files behind, that the main
+// thread can take the track lock while an export runs, and reports how much
+// faster than realtime a long export renders. --update rewrites the
+// references after an intended change to the mix. Exits nonzero if any check
+// fails. VST3, streamed clips and the track/plugin edit paths are stand-ins
+// the session does not use.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "BaseEntity.cpp"
+#include "BaseSystem/Vst3Host.h"
+
+namespace DawClipSystemLogic {
+    void RefreshTrackFromClips(DawContext&, DawTrack&) {}
+    void RenderTrackRange(DawContext&, const DawTrack&, uint64_t, size_t, float*, float*) {}
+    uint64_t TrackEndSample(const DawTrack&) { return 0; }
+}
+namespace DawRecordSystemLogic {
+    void AbortTakes(DawContext&) {}
+    void SweepTakeFiles(DawContext&, bool) {}
+}
+namespace DawStreamSystemLogic {
+    bool OpenStreamedClipAudio(DawContext&, const std::string&, DawClipAudio&, uint32_t&) { return false; }
+    bool ReadStreamFrames(DawContext&, const DawClipAudio&, uint64_t, size_t, float*, float*) { return false; }
+    void ReleaseStreams(DawContext&) {}
+    std::string StreamSourcePath(const DawContext&, const DawClipAudio&) { return {}; }
+}
+namespace DawTrackSystemLogic {
+    bool InsertTrackAt(BaseSystem&, int) { return false; }
+    bool RemoveTrackAt(BaseSystem&, int) { return false; }
+}
+namespace MidiTrackSystemLogic {
+    bool InsertTrackAt(BaseSystem&, int) { return false; }
+    bool RemoveTrackAt(BaseSystem&, int) { return false; }
+}
+namespace AutomationTrackSystemLogic {
+    bool InsertTrackAt(BaseSystem&, int) { return false; }
+    bool RemoveTrackAt(BaseSystem&, int) { return false; }
+}
+namespace MidiWaveformSystemLogic {
+    void RebuildWaveform(MidiTrack&, float) {}
+}
+namespace Vst3SystemLogic {
+    void EnsureAudioTrackCount(Vst3Context&, int) {}
+    void EnsureMidiTrackCount(Vst3Context&, int) {}
+    bool AddPluginToTrack(Vst3Context&, const Vst3AvailablePlugin&, int, int) { return false; }
+    bool RemovePluginFromTrack(Vst3Context&, Vst3Plugin*, int, int) { return false; }
+    bool ProcessEffectChainStereo(Vst3Context&, Vst3TrackChain&, const float*, const float*, float*, float*,
+                                  int, int64_t, bool) { return false; }
+    bool ProcessEffectChain(Vst3Context&, Vst3TrackChain&, const float*, float*, int, int64_t, bool) { return false; }
+    bool ProcessInstrument(Vst3Context&, Vst3TrackChain&, Vst3Plugin&, float*, int, int64_t, bool,
+                           const std::array<float, 128>&, std::array<float, 128>&) { return false; }
+}
+
+#include "BaseSystem/DawIOSystem.cpp"
+
+namespace {
+    namespace fs = std::filesystem;
+
+    // 240 bpm at 6 kHz makes a bar 6000 frames; bars 2..3 export 6000
+    // frames, 11 blocks of 512 and a 368-frame tail.
+    constexpr float kSampleRate = 6000.0f;
+    constexpr double kBpm = 240.0;
+    const char* kReferenceDir = "Tools/golden/stem_export";
+    const std::array<std::string, DawContext::kBusCount> kStemNames{"stem_a", "stem_b", "stem_c", "stem_d"};
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    // Deterministic source material from an integer LCG, so the references
+    // do not depend on the C library's sin/exp.
+    std::vector<float> lcgSignal(size_t frames, uint32_t seed, int smoothing) {
+        std::vector<float> out(frames);
+        uint32_t state = seed;
+        float smoothed = 0.0f;
+        for (size_t i = 0; i < frames; ++i) {
+            state = state * 1664525u + 1013904223u;
+            const float white = static_cast<float>(static_cast<int32_t>(state >> 8) - (1 << 23)) / static_cast<float>(1 << 23);
+            smoothed += (white - smoothed) / static_cast<float>(smoothing);
+            out[i] = smoothed;
+        }
+        return out;
+    }
+
+    DawClip makeClip(int audioId, uint64_t start, uint64_t length, uint64_t sourceOffset) {
+        DawClip clip;
+        clip.audioId = audioId;
+        clip.startSample = start;
+        clip.length = length;
+        clip.sourceOffset = sourceOffset;
+        return clip;
+    }
+
+    struct Session {
+        BaseSystem base;
+
+        explicit Session(const fs::path& folder) {
+            base.audio = std::make_unique<AudioContext>();
+            base.daw = std::make_unique<DawContext>();
+            base.midi = std::make_unique<MidiContext>();
+            DawContext& daw = *base.daw;
+            daw.sampleRate = kSampleRate;
+            daw.bpm.store(kBpm);
+            daw.playheadSample.store(1234);
+            daw.exportStartBar = 2;
+            daw.exportEndBar = 3;
+            daw.exportFolderPath = folder.string();
+            daw.exportStemNames = kStemNames;
+
+            DawClipAudio stereo;
+            stereo.channels = 2;
+            stereo.left = lcgSignal(9000, 0x51e7, 3);
+            stereo.right = lcgSignal(9000, 0x7a11, 9);
+            daw.clipAudio.push_back(std::move(stereo));
+            DawClipAudio mono;
+            mono.left = lcgSignal(7000, 0x0d0e, 5);
+            daw.clipAudio.push_back(std::move(mono));
+
+            // Track 0: stereo clip on buses 0/1, starting before the range.
+            // Track 1: mono clip summed onto bus 2, one clip with an offset.
+            // Track 2: muted, on bus 3.
+            daw.tracks.resize(3);
+            daw.tracks[0].clips.push_back(makeClip(0, 4000, 9000, 0));
+            daw.tracks[0].gain.store(0.8f);
+            daw.tracks[0].outputBusL.store(0);
+            daw.tracks[0].outputBusR.store(1);
+            daw.tracks[1].clips.push_back(makeClip(1, 5500, 2000, 1500));
+            daw.tracks[1].clips.push_back(makeClip(1, 9000, 5000, 0));
+            daw.tracks[1].gain.store(0.5f);
+            daw.tracks[1].outputBusL.store(2);
+            daw.tracks[1].outputBusR.store(2);
+            daw.tracks[2].clips.push_back(makeClip(0, 6000, 6000, 100));
+            daw.tracks[2].mute.store(true);
+            daw.tracks[2].outputBusL.store(3);
+            daw.tracks[2].outputBusR.store(3);
+            daw.trackCount = 3;
+
+            // A rendered MIDI track on bus 3 that ends inside the range.
+            MidiContext& midi = *base.midi;
+            midi.sampleRate = kSampleRate;
+            midi.tracks.resize(1);
+            midi.tracks[0].audio = lcgSignal(10500, 0x3141, 2);
+            midi.tracks[0].gain.store(0.7f);
+            midi.tracks[0].outputBusL.store(3);
+            midi.tracks[0].outputBusR.store(3);
+            midi.trackCount = 1;
+        }
+
+        // Drives the export the way the main loop does: one tick per frame
+        // until the job reports done.
+        bool runExport() {
+            if (!DawIOSystemLogic::StartStemExport(base)) return false;
+            while (base.daw->exportJobActive) {
+                DawIOSystemLogic::TickStemExport(base, 0.016f);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return true;
+        }
+    };
+
+    std::vector<char> readFile(const fs::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void exportMatchesReference(const fs::path& folder, bool update) {
+        Session session(folder);
+        const DawContext& daw = *session.base.daw;
+        if (!check(session.runExport(), "export starts")) return;
+        check(daw.exportSucceeded, "export succeeds: " + daw.exportStatusMessage);
+        check(daw.exportProgress.load() == 1.0f, "progress ends at 1");
+        check(daw.playheadSample.load() == 1234, "playhead is restored");
+        check(!session.base.audio->offlineRenderMute.load(), "live output is unmuted");
+
+        for (const std::string& name : kStemNames) {
+            const fs::path produced = folder / (name + ".wav");
+            const fs::path reference = fs::path(kReferenceDir) / (name + ".wav");
+            const std::vector<char> bytes = readFile(produced);
+            check(bytes.size() == 44 + 6000 * sizeof(float), name + " has 6000 frames");
+            if (update) {
+                fs::create_directories(kReferenceDir);
+                fs::copy_file(produced, reference, fs::copy_options::overwrite_existing);
+                continue;
+            }
+            const std::vector<char> expected = readFile(reference);
+            if (!check(!expected.empty(), reference.string() + " exists")) continue;
+            if (bytes == expected) continue;
+            size_t first = 0;
+            while (first < bytes.size() && first < expected.size() && bytes[first] == expected[first]) ++first;
+            check(false, name + ".wav differs from the reference at byte " + std::to_string(first));
+        }
+    }
+
+    void cancelRemovesStems(const fs::path& folder) {
+        Session session(folder);
+        DawContext& daw = *session.base.daw;
+        daw.exportEndBar = 4000;
+        if (!check(DawIOSystemLogic::StartStemExport(session.base), "long export starts")) return;
+        check(!DawIOSystemLogic::StartStemExport(session.base), "a second export is refused while one runs");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        DawIOSystemLogic::CancelStemExport(session.base, false);
+        while (daw.exportJobActive) {
+            DawIOSystemLogic::TickStemExport(session.base, 0.016f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        check(!daw.exportSucceeded && daw.exportStatusMessage == "Export cancelled.", "cancel reports cancelled");
+        check(daw.exportProgress.load() == 0.0f, "cancel resets progress");
+        for (const std::string& name : kStemNames) {
+            check(!fs::exists(folder / (name + ".wav")), "cancel removes " + name + ".wav");
+        }
+    }
+
+    // Autosave and the lane UI take the track lock every frame while the
+    // worker runs; the worker must let them in between blocks. Also times
+    // the render against realtime.
+    void mainThreadKeepsTrackLock(const fs::path& folder) {
+        using Clock = std::chrono::steady_clock;
+        Session session(folder);
+        DawContext& daw = *session.base.daw;
+        daw.exportEndBar = 302;
+        const double exportSeconds = 300.0 * 4.0 * 60.0 / kBpm;
+        const auto start = Clock::now();
+        if (!check(DawIOSystemLogic::StartStemExport(session.base), "timed export starts")) return;
+        double worstWaitMs = 0.0;
+        int locks = 0;
+        while (daw.exportJobActive) {
+            const auto before = Clock::now();
+            {
+                std::lock_guard<std::mutex> lock(daw.trackMutex);
+                locks += 1;
+            }
+            worstWaitMs = std::max(worstWaitMs, std::chrono::duration<double, std::milli>(Clock::now() - before).count());
+            DawIOSystemLogic::TickStemExport(session.base, 0.016f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        check(daw.exportSucceeded, "timed export succeeds");
+        check(worstWaitMs < 20.0, "main thread waits at most 20 ms for the track lock, waited "
+                                      + std::to_string(worstWaitMs) + " ms");
+        std::printf("export: %.0f s of audio in %.2f s (%.0fx realtime), %d main-thread locks, worst wait %.3f ms\n",
+                    exportSeconds, seconds, exportSeconds / seconds, locks, worstWaitMs);
+        for (const std::string& name : kStemNames) fs::remove(folder / (name + ".wav"));
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool update = argc > 1 && std::string(argv[1]) == "--update";
+    if (argc > 1 && !update) {
+        std::cerr << "usage: " << argv[0] << " [--update]\n";
+        return 2;
+    }
+    const fs::path folder = fs::temp_directory_path() / "stem_export_check";
+    std::error_code ec;
+    fs::remove_all(folder, ec);
+    fs::create_directories(folder);
+
+    exportMatchesReference(folder, update);
+    cancelRemovesStems(folder);
+    mainThreadKeepsTrackLock(folder);
+    fs::remove_all(folder, ec);
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << (update ? "updated\n" : "ok\n");
+    return 0;
+}
@@ -0,0 +1,200 @@
+// Standalone round-trip checks for StructureBinary. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. -I<glm> -I<dir holding json.hpp> Tools/StructureBinaryCheck.cpp -o structure_binary_check
+//   ./structure_binary_check [Structures/starter_build.json]
+//
+// Random structures go through buildMips, encode/decode, saveFile/loadFile
+// and toJson/fromJson and must come back cell for cell; every truncation of
+// an encoded file must be rejected. The given JSON structure (starter_build
+// by default) is converted both ways as well. Exits nonzero if any check
+// fails.
+
+#include <iostream>
+#include <random>
+
+#include "BaseSystem/StructureBinary.h"
+
+namespace {
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    std::vector<int32_t> levelCells(const StructureBinary::Structure& s, size_t level) {
+        std::vector<int32_t> cells;
+        StructureBinary::decodeRuns(s.levels[level].runs, StructureBinary::cellCount(s.levels[level].size), cells);
+        return cells;
+    }
+
+    bool samePalette(const StructureBinary::Structure& a, const StructureBinary::Structure& b) {
+        if (a.palette.size() != b.palette.size()) return false;
+        for (size_t i = 0; i < a.palette.size(); ++i) {
+            if (a.palette[i].prototype != b.palette[i].prototype) return false;
+            for (int c = 0; c < 3; ++c) {
+                if (a.palette[i].color[c] != b.palette[i].color[c]) return false;
+            }
+        }
+        return true;
+    }
+
+    bool sameStructure(const StructureBinary::Structure& a, const StructureBinary::Structure& b) {
+        if (a.id != b.id || a.world != b.world || a.minCorner != b.minCorner) return false;
+        if (!samePalette(a, b) || a.levels.size() != b.levels.size()) return false;
+        for (size_t level = 0; level < a.levels.size(); ++level) {
+            if (a.levels[level].size != b.levels[level].size) return false;
+            if (levelCells(a, level) != levelCells(b, level)) return false;
+        }
+        return true;
+    }
+
+    StructureBinary::Structure randomStructure(std::mt19937& rng, int index) {
+        StructureBinary::Structure s;
+        s.id = "check_" + std::to_string(index);
+        s.world = index % 2 ? "DAWWorld" : "";
+        s.minCorner = glm::ivec3(static_cast<int>(rng() % 200) - 100, static_cast<int>(rng() % 40) - 20,
+                                 static_cast<int>(rng() % 200) - 100);
+        const int paletteSize = 1 + static_cast<int>(rng() % 6);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int i = 0; i < paletteSize; ++i) {
+            // An empty prototype name is a palette entry buildMips must treat as air.
+            std::string name = (i == 0 && rng() % 3 == 0) ? "" : "Block" + std::to_string(rng() % 4);
+            s.palette.push_back({name, glm::vec3(unit(rng), unit(rng), unit(rng))});
+        }
+        const glm::ivec3 dims(1 + static_cast<int>(rng() % 23), 1 + static_cast<int>(rng() % 17),
+                              1 + static_cast<int>(rng() % 23));
+        std::vector<int32_t> cells(StructureBinary::cellCount(dims), StructureBinary::kEmpty);
+        const uint32_t fill = rng() % 100;
+        int32_t current = StructureBinary::kEmpty;
+        for (int32_t& cell : cells) {
+            // Long runs with occasional changes, like captured builds.
+            if (rng() % 8 == 0) {
+                current = (rng() % 100 < fill) ? static_cast<int32_t>(rng() % static_cast<uint32_t>(paletteSize))
+                                               : StructureBinary::kEmpty;
+            }
+            cell = current;
+        }
+        s.levels.push_back({dims, StructureBinary::encodeRuns(cells)});
+        StructureBinary::buildMips(s);
+        return s;
+    }
+
+    // Every mip cell is empty or carries a palette entry one of its eight
+    // children carries.
+    void checkMips(const StructureBinary::Structure& s, const std::string& label) {
+        for (size_t level = 1; level < s.levels.size(); ++level) {
+            const glm::ivec3 childDims = s.levels[level - 1].size;
+            const glm::ivec3 dims = s.levels[level].size;
+            check(dims == (childDims + glm::ivec3(1)) / 2, label + ": mip " + std::to_string(level) + " halves its parent");
+            const std::vector<int32_t> child = levelCells(s, level - 1);
+            const std::vector<int32_t> parent = levelCells(s, level);
+            for (int z = 0; z < dims.z; ++z) {
+                for (int y = 0; y < dims.y; ++y) {
+                    for (int x = 0; x < dims.x; ++x) {
+                        const int32_t p = parent[StructureBinary::cellIndex(glm::ivec3(x, y, z), dims)];
+                        if (p == StructureBinary::kEmpty) continue;
+                        bool found = false;
+                        for (int d = 0; d < 8 && !found; ++d) {
+                            const glm::ivec3 c(x * 2 + (d & 1), y * 2 + ((d >> 1) & 1), z * 2 + (d >> 2));
+                            if (c.x >= childDims.x || c.y >= childDims.y || c.z >= childDims.z) continue;
+                            found = child[StructureBinary::cellIndex(c, childDims)] == p;
+                        }
+                        if (!check(found, label + ": mip cell comes from a child")) return;
+                    }
+                }
+            }
+        }
+    }
+
+    void roundTrip(const StructureBinary::Structure& s, const std::string& label) {
+        const std::vector<uint8_t> bytes = StructureBinary::encode(s);
+        StructureBinary::Structure decoded;
+        std::string error;
+        if (!check(StructureBinary::decode(bytes.data(), bytes.size(), decoded, error), label + ": decode " + error)) return;
+        check(sameStructure(s, decoded), label + ": decode matches the encoded structure");
+        check(StructureBinary::encode(decoded) == bytes, label + ": re-encoding is byte-identical");
+
+        for (size_t cut = 0; cut < bytes.size(); ++cut) {
+            StructureBinary::Structure partial;
+            std::string ignored;
+            if (!check(!StructureBinary::decode(bytes.data(), cut, partial, ignored),
+                       label + ": truncation at " + std::to_string(cut) + " is rejected")) {
+                break;
+            }
+        }
+
+        StructureBinary::Structure fromJson;
+        error.clear();
+        if (check(StructureBinary::fromJson(StructureBinary::toJson(s), fromJson, error) && error.empty(),
+                  label + ": fromJson(toJson) " + error)) {
+            check(fromJson.id == s.id && fromJson.world == s.world && fromJson.minCorner == s.minCorner,
+                  label + ": JSON keeps the header");
+            check(samePalette(fromJson, s), label + ": JSON keeps the palette");
+            check(levelCells(fromJson, 0) == levelCells(s, 0), label + ": JSON keeps level 0 cells");
+        }
+    }
+
+    void fileRoundTrip(const StructureBinary::Structure& s) {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "structure_binary_check.vstb";
+        std::string error;
+        if (check(StructureBinary::saveFile(path, s, error), "saveFile " + error)) {
+            StructureBinary::Structure loaded;
+            check(StructureBinary::loadFile(path, loaded, error), "loadFile " + error);
+            check(sameStructure(s, loaded), "loadFile matches saveFile");
+        }
+        std::filesystem::remove(path);
+        StructureBinary::Structure missing;
+        check(!StructureBinary::loadFile(path, missing, error), "loadFile of a missing file fails");
+    }
+
+    void checkJsonFile(const std::filesystem::path& path) {
+        std::ifstream in(path);
+        if (!check(in.is_open(), "cannot read " + path.string())) return;
+        nlohmann::json data;
+        try {
+            data = nlohmann::json::parse(in);
+        } catch (const std::exception& e) {
+            check(false, path.string() + ": " + e.what());
+            return;
+        }
+        StructureBinary::Structure s;
+        std::string error;
+        if (!check(StructureBinary::fromJson(data, s, error), path.string() + ": " + error)) return;
+        StructureBinary::buildMips(s);
+        checkMips(s, path.string());
+        roundTrip(s, path.string());
+        const glm::ivec3 dims = s.size();
+        std::cout << path.string() << ": " << dims.x << "x" << dims.y << "x" << dims.z << ", "
+                  << s.levels.size() << " levels, " << StructureBinary::encode(s).size() << " bytes binary vs "
+                  << data.dump().size() << " bytes JSON\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2) {
+        std::cerr << "usage: " << argv[0] << " [structure.json]\n";
+        return 2;
+    }
+    std::mt19937 rng(0x57b);
+    for (int i = 0; i < 200 && g_failures == 0; ++i) {
+        const StructureBinary::Structure s = randomStructure(rng, i);
+        const std::string label = "random " + std::to_string(i);
+        checkMips(s, label);
+        roundTrip(s, label);
+        if (i == 0) fileRoundTrip(s);
+    }
+    std::cout << "random: 200 structures round-tripped\n";
+
+    const std::filesystem::path jsonPath = argc == 2 ? argv[1] : "Structures/starter_build.json";
+    if (std::filesystem::exists(jsonPath) || argc == 2) checkJsonFile(jsonPath);
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
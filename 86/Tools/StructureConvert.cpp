@@ -0,0 +1,65 @@
+// Standalone JSON <-> binary structure converter. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. -I<glm> -I<dir holding json.hpp> Tools/StructureConvert.cpp -o structure_convert
+//   ./structure_convert Structures/starter_build.json [Structures/starter_build.vstb]
+//   ./structure_convert Structures/starter_build.vstb Structures/starter_build.json
+//
+// The direction follows the input extension. JSON input gets mips rebuilt
+// before it is written; the output path defaults to the input with the other
+// extension.
+
+#include <iostream>
+
+#include "BaseSystem/StructureBinary.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " <in.json|in.vstb> [out]\n";
+        return 2;
+    }
+    namespace fs = std::filesystem;
+    fs::path inPath(argv[1]);
+    const bool fromBinary = inPath.extension() == ".vstb";
+    fs::path outPath = (argc == 3) ? fs::path(argv[2])
+        : (fromBinary ? fs::path(inPath).replace_extension(".json") : StructureBinary::binaryPathFor(inPath));
+
+    StructureBinary::Structure structure;
+    std::string error;
+    if (fromBinary) {
+        if (!StructureBinary::loadFile(inPath, structure, error)) {
+            std::cerr << inPath.string() << ": " << error << "\n";
+            return 1;
+        }
+        std::ofstream out(outPath);
+        if (!out.is_open()) {
+            std::cerr << "cannot write " << outPath.string() << "\n";
+            return 1;
+        }
+        out << StructureBinary::toJson(structure).dump(2);
+    } else {
+        std::ifstream in(inPath);
+        if (!in.is_open()) {
+            std::cerr << "cannot read " << inPath.string() << "\n";
+            return 1;
+        }
+        nlohmann::json data;
+        try {
+            data = nlohmann::json::parse(in);
+        } catch (const std::exception& e) {
+            std::cerr << inPath.string() << ": " << e.what() << "\n";
+            return 1;
+        }
+        if (!StructureBinary::fromJson(data, structure, error)) {
+            std::cerr << inPath.string() << ": " << error << "\n";
+            return 1;
+        }
+        if (!error.empty()) std::cerr << inPath.string() << ": " << error << "\n";
+        StructureBinary::buildMips(structure);
+        if (!StructureBinary::saveFile(outPath, structure, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+    std::cout << inPath.string() << " -> " << outPath.string() << "\n";
+    return 0;
+}
@@ -0,0 +1,593 @@
+// Standalone checks and benchmark for TextLayout. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. Tools/TextLayoutCheck.cpp -o text_layout_check
+//   ./text_layout_check [--bench-only]
+//
+// stb_truetype is not needed: faces are synthetic packed-char tables with
+// fractional offsets and advances, blank glyphs and characters outside the
+// atlas, converted to TextLayout::Face the way FontSystem's loadAtlas does.
+// Checks that cached layouts emitted at random positions and screen sizes
+// give bit-identical quads, UVs, widths and heights to FontSystem's previous
+// measureText/stbtt_GetPackedQuad path (kept here verbatim), that wrapped
+// lines break where documented and report their metrics, and that the cache
+// hits, misses and evicts when the text, atlas id, size or wrap width change.
+// Ends with a 2000-label frame drawn three ways: shaped in place, through the
+// layout cache, and with FontSystem's per-instance run reuse. Exits nonzero
+// if any check fails.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BaseSystem/TextLayout.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    constexpr int kFirstChar = 32;
+    constexpr int kCharCount = 96;
+
+    // stb_truetype's stbtt_packedchar and stbtt_aligned_quad.
+    struct PackedChar {
+        unsigned short x0, y0, x1, y1;
+        float xoff, yoff, xadvance;
+        float xoff2, yoff2;
+    };
+
+    struct AlignedQuad {
+        float x0, y0, s0, t0;
+        float x1, y1, s1, t1;
+    };
+
+    struct Atlas {
+        PackedChar cdata[kCharCount]{};
+        int width = 512;
+        int height = 512;
+        float size = 24.0f;
+        float ascent = 0.0f;
+        float lineHeight = 24.0f;
+        TextLayout::Face face;
+    };
+
+    // A packed font at `size`: glyph boxes, offsets and advances with the
+    // fractions oversampled packing produces; space and DEL are blank.
+    Atlas makeAtlas(std::mt19937& rng, float size, uint32_t faceId) {
+        Atlas atlas;
+        atlas.size = size;
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        atlas.ascent = size * (0.72f + 0.1f * unit(rng));
+        atlas.lineHeight = size * (1.15f + 0.1f * unit(rng));
+        int packX = 1;
+        int packY = 1;
+        for (int i = 0; i < kCharCount; ++i) {
+            PackedChar& c = atlas.cdata[i];
+            c.xadvance = size * (0.25f + 0.45f * unit(rng));
+            const bool blank = (i == 0 || i == kCharCount - 1);
+            const int w = blank ? 0 : 1 + static_cast<int>(size * (0.2f + 0.5f * unit(rng)));
+            const int h = blank ? 0 : 1 + static_cast<int>(size * (0.2f + 0.8f * unit(rng)));
+            if (packX + w + 1 > atlas.width) {
+                packX = 1;
+                packY += static_cast<int>(size * 1.2f) + 2;
+            }
+            c.x0 = static_cast<unsigned short>(packX);
+            c.y0 = static_cast<unsigned short>(packY);
+            c.x1 = static_cast<unsigned short>(packX + w);
+            c.y1 = static_cast<unsigned short>(packY + h);
+            packX += w + 1;
+            c.xoff = -1.0f + 3.0f * unit(rng);
+            c.yoff = -atlas.ascent * unit(rng) + 0.5f * unit(rng);
+            const float oversample = size <= 18.0f ? 2.0f : 1.0f;
+            c.xoff2 = c.xoff + static_cast<float>(w) / oversample;
+            c.yoff2 = c.yoff + static_cast<float>(h) / oversample;
+        }
+
+        // FontSystem's loadAtlas conversion.
+        atlas.face.id = faceId;
+        atlas.face.pixelSize = static_cast<int>(std::round(size));
+        atlas.face.firstChar = kFirstChar;
+        atlas.face.ascent = atlas.ascent;
+        atlas.face.lineHeight = (atlas.lineHeight > 0.0f) ? atlas.lineHeight : atlas.size;
+        atlas.face.glyphs.resize(kCharCount);
+        const float invWidth = 1.0f / static_cast<float>(atlas.width);
+        const float invHeight = 1.0f / static_cast<float>(atlas.height);
+        for (int i = 0; i < kCharCount; ++i) {
+            const PackedChar& bc = atlas.cdata[i];
+            TextLayout::GlyphMetrics& g = atlas.face.glyphs[static_cast<size_t>(i)];
+            g.xoff = bc.xoff;
+            g.yoff = bc.yoff;
+            g.xoff2 = bc.xoff2;
+            g.yoff2 = bc.yoff2;
+            g.s0 = bc.x0 * invWidth;
+            g.t0 = bc.y0 * invHeight;
+            g.s1 = bc.x1 * invWidth;
+            g.t1 = bc.y1 * invHeight;
+            g.xadvance = bc.xadvance;
+        }
+        return atlas;
+    }
+
+    // FontSystem's text path before the layout cache.
+    namespace Legacy {
+        void GetPackedQuad(const PackedChar* chardata, int pw, int ph, int char_index, float* xpos, float* ypos,
+                           AlignedQuad* q, int align_to_integer) {
+            float ipw = 1.0f / pw, iph = 1.0f / ph;
+            const PackedChar* b = chardata + char_index;
+            if (align_to_integer) {
+                float x = (float)((int)std::floor((*xpos + b->xoff) + 0.5f));
+                float y = (float)((int)std::floor((*ypos + b->yoff) + 0.5f));
+                q->x0 = x;
+                q->y0 = y;
+                q->x1 = x + b->xoff2 - b->xoff;
+                q->y1 = y + b->yoff2 - b->yoff;
+            } else {
+                q->x0 = *xpos + b->xoff;
+                q->y0 = *ypos + b->yoff;
+                q->x1 = *xpos + b->xoff2;
+                q->y1 = *ypos + b->yoff2;
+            }
+            q->s0 = b->x0 * ipw;
+            q->t0 = b->y0 * iph;
+            q->s1 = b->x1 * ipw;
+            q->t1 = b->y1 * iph;
+            *xpos += b->xadvance;
+        }
+
+        struct Vec2 { float x; float y; };
+
+        Vec2 pixelToNDC(const Vec2& pixel, double width, double height) {
+            float ndcX = static_cast<float>((pixel.x / width) * 2.0 - 1.0);
+            float ndcY = static_cast<float>(1.0 - (pixel.y / height) * 2.0);
+            return {ndcX, ndcY};
+        }
+
+        void measureText(const std::string& text, const Atlas& atlas, float& outWidth, float& outHeight) {
+            float lineHeight = (atlas.lineHeight > 0.0f) ? atlas.lineHeight : atlas.size;
+            float lineWidth = 0.0f;
+            float maxWidth = 0.0f;
+            int lineCount = 1;
+
+            for (char c : text) {
+                if (c == '\n') {
+                    maxWidth = std::max(maxWidth, lineWidth);
+                    lineWidth = 0.0f;
+                    ++lineCount;
+                    continue;
+                }
+                unsigned char uc = static_cast<unsigned char>(c);
+                if (uc < kFirstChar || uc >= kFirstChar + kCharCount) continue;
+                const PackedChar& bc = atlas.cdata[uc - kFirstChar];
+                lineWidth += bc.xadvance;
+            }
+
+            maxWidth = std::max(maxWidth, lineWidth);
+            outWidth = maxWidth;
+            outHeight = lineHeight * lineCount;
+        }
+
+        // Writes UIBatch::Vertex where it wrote FontVertex; otherwise as it was.
+        void appendTextVertices(std::vector<UIBatch::Vertex>& verts, const Atlas& atlas, const std::string& text,
+                                uint32_t color, const Vec2& position, double screenWidth, double screenHeight) {
+            if (text.empty()) return;
+
+            float textWidth = 0.0f;
+            float textHeight = 0.0f;
+            measureText(text, atlas, textWidth, textHeight);
+            float lineHeight = (atlas.lineHeight > 0.0f) ? atlas.lineHeight : atlas.size;
+
+            float startX = position.x - textWidth * 0.5f;
+            float startY = position.y - textHeight * 0.5f;
+            float x = startX;
+            float y = startY + atlas.ascent;
+
+            int lineIndex = 0;
+            for (char c : text) {
+                if (c == '\n') {
+                    ++lineIndex;
+                    x = startX;
+                    y = startY + atlas.ascent + lineIndex * lineHeight;
+                    continue;
+                }
+                unsigned char uc = static_cast<unsigned char>(c);
+                if (uc < kFirstChar || uc >= kFirstChar + kCharCount) continue;
+
+                AlignedQuad q;
+                float xCursor = x;
+                float yCursor = y;
+                GetPackedQuad(atlas.cdata, atlas.width, atlas.height, uc - kFirstChar, &xCursor, &yCursor, &q, 1);
+                x = xCursor;
+
+                Vec2 p0 = pixelToNDC({q.x0, q.y0}, screenWidth, screenHeight);
+                Vec2 p1 = pixelToNDC({q.x1, q.y0}, screenWidth, screenHeight);
+                Vec2 p2 = pixelToNDC({q.x1, q.y1}, screenWidth, screenHeight);
+                Vec2 p3 = pixelToNDC({q.x0, q.y1}, screenWidth, screenHeight);
+
+                verts.push_back({p0.x, p0.y, q.s0, q.t0, color});
+                verts.push_back({p1.x, p1.y, q.s1, q.t0, color});
+                verts.push_back({p2.x, p2.y, q.s1, q.t1, color});
+                verts.push_back({p0.x, p0.y, q.s0, q.t0, color});
+                verts.push_back({p2.x, p2.y, q.s1, q.t1, color});
+                verts.push_back({p3.x, p3.y, q.s0, q.t1, color});
+            }
+        }
+    }
+
+    // The old path also emitted zero-area quads for blank glyphs; they
+    // cover no pixels, so they are left out of the comparison.
+    std::vector<UIBatch::Vertex> withoutBlankQuads(const std::vector<UIBatch::Vertex>& verts) {
+        std::vector<UIBatch::Vertex> out;
+        for (size_t q = 0; q + 6 <= verts.size(); q += 6) {
+            if (verts[q].x == verts[q + 1].x || verts[q].y == verts[q + 2].y) continue;
+            out.insert(out.end(), verts.begin() + static_cast<long>(q), verts.begin() + static_cast<long>(q) + 6);
+        }
+        return out;
+    }
+
+    bool sameVertices(const std::vector<UIBatch::Vertex>& a, const std::vector<UIBatch::Vertex>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].x != b[i].x || a[i].y != b[i].y || a[i].u != b[i].u || a[i].v != b[i].v
+                || a[i].color != b[i].color) return false;
+        }
+        return true;
+    }
+
+    std::string randomText(std::mt19937& rng, int maxLength) {
+        const int length = std::uniform_int_distribution<int>(0, maxLength)(rng);
+        std::string text;
+        for (int i = 0; i < length; ++i) {
+            const int roll = std::uniform_int_distribution<int>(0, 99)(rng);
+            if (roll < 14) text += ' ';
+            else if (roll < 17) text += '\n';
+            else if (roll < 18) text += static_cast<char>(std::uniform_int_distribution<int>(0, 1)(rng) ? '\t' : 200);
+            else text += static_cast<char>(std::uniform_int_distribution<int>(33, 127)(rng));
+        }
+        return text;
+    }
+
+    void legacyEquivalence() {
+        std::mt19937 rng(0x7e47);
+        const float sizes[] = {11.0f, 14.0f, 24.0f, 48.0f};
+        std::vector<Atlas> atlases;
+        uint32_t faceId = 1;
+        for (float size : sizes) atlases.push_back(makeAtlas(rng, size, faceId++));
+
+        TextLayout::Cache cache;
+        std::vector<UIBatch::Vertex> expected;
+        std::vector<UIBatch::Vertex> actual;
+        constexpr int kStrings = 20000;
+        size_t quads = 0;
+        int mismatches = 0;
+        for (int i = 0; i < kStrings && mismatches < 10; ++i) {
+            const Atlas& atlas = atlases[static_cast<size_t>(i) % atlases.size()];
+            const std::string text = randomText(rng, 40);
+            const Legacy::Vec2 position{std::uniform_real_distribution<float>(-50.0f, 2600.0f)(rng),
+                                        std::uniform_real_distribution<float>(-50.0f, 1500.0f)(rng)};
+            const double screenWidth = std::uniform_int_distribution<int>(0, 1)(rng) ? 1920.0 : 1280.0 + 7.0 * (i % 13);
+            const double screenHeight = std::uniform_int_distribution<int>(0, 1)(rng) ? 1080.0 : 720.0 + 3.0 * (i % 11);
+            const uint32_t color = UIBatch::packColor(0.9f, 0.8f, 0.7f, 1.0f);
+
+            expected.clear();
+            Legacy::appendTextVertices(expected, atlas, text, color, position, screenWidth, screenHeight);
+            expected = withoutBlankQuads(expected);
+
+            // FontSystem's layoutRun.
+            const TextLayout::Layout& layout = cache.get(atlas.face, text, 0.0f);
+            actual.clear();
+            if (!text.empty()) {
+                TextLayout::emit(layout, position.x - layout.width * 0.5f, position.y - layout.height * 0.5f,
+                                 color, screenWidth, screenHeight, actual);
+            }
+
+            float legacyWidth = 0.0f;
+            float legacyHeight = 0.0f;
+            Legacy::measureText(text, atlas, legacyWidth, legacyHeight);
+            const std::string at = " for string " + std::to_string(i) + " at size " + std::to_string(atlas.size);
+            bool ok = check(layout.width == legacyWidth && layout.height == legacyHeight, "width/height" + at);
+            ok = check(sameVertices(actual, expected), "quads differ from the stbtt_GetPackedQuad path" + at) && ok;
+            if (!ok) mismatches += 1;
+            quads += expected.size() / 6;
+        }
+        std::printf("legacy equivalence: %d strings, %zu glyph quads, %d mismatching\n", kStrings, quads, mismatches);
+    }
+
+    // Independent line widths: advances summed from each line's start, a
+    // wrapped line measured up to the space it broke after.
+    void wrapMetrics() {
+        std::mt19937 rng(0x3a9);
+        const Atlas atlas = makeAtlas(rng, 16.0f, 1);
+        constexpr int kStrings = 20000;
+        int wrapped = 0;
+        int failures = 0;
+        for (int i = 0; i < kStrings && failures < 10; ++i) {
+            std::string text = randomText(rng, 80);
+            const float wrapWidth = std::uniform_real_distribution<float>(20.0f, 300.0f)(rng);
+            TextLayout::Layout layout;
+            TextLayout::shape(atlas.face, text, wrapWidth, layout);
+            const std::string at = " for string " + std::to_string(i) + " wrapped at " + std::to_string(wrapWidth);
+
+            // Characters in the atlas, in order, each with its own advance.
+            std::vector<unsigned char> placed;
+            int hardBreaks = 0;
+            for (char ch : text) {
+                if (ch == '\n') { hardBreaks += 1; continue; }
+                if (atlas.face.glyph(static_cast<unsigned char>(ch))) placed.push_back(static_cast<unsigned char>(ch));
+            }
+            bool ok = check(layout.advances.size() == placed.size() && layout.quadIndex.size() == placed.size(),
+                            "every placed character keeps an advance" + at);
+            if (!ok) { failures += 1; continue; }
+            size_t blank = 0;
+            for (size_t k = 0; k < placed.size(); ++k) {
+                const TextLayout::GlyphMetrics* g = atlas.face.glyph(placed[k]);
+                ok = ok && layout.advances[k] == g->xadvance;
+                const bool isBlank = !(g->xoff2 > g->xoff && g->yoff2 > g->yoff);
+                blank += isBlank ? 1 : 0;
+                ok = ok && (layout.quadIndex[k] < 0) == isBlank;
+            }
+            ok = check(ok && layout.quads.size() + blank == placed.size(), "advances and quads follow the text" + at) && ok;
+            ok = check(layout.lines == static_cast<int>(layout.lineStarts.size()) && layout.lines >= hardBreaks + 1
+                       && layout.height == layout.lineHeight * static_cast<float>(layout.lines), "line count and height" + at) && ok;
+
+            // Walk the lines, telling hard breaks from wrap breaks by the text.
+            float widest = 0.0f;
+            size_t cursor = 0;  // into `text`
+            for (int line = 0; line < layout.lines; ++line) {
+                const size_t begin = layout.lineStarts[static_cast<size_t>(line)];
+                const size_t end = line + 1 < layout.lines ? layout.lineStarts[static_cast<size_t>(line) + 1] : placed.size();
+                ok = ok && begin <= end;
+                // Find where this line ends in the text.
+                size_t seen = begin;
+                while (cursor < text.size() && seen < end) {
+                    if (text[cursor] != '\n' && atlas.face.glyph(static_cast<unsigned char>(text[cursor]))) seen += 1;
+                    cursor += 1;
+                }
+                while (cursor < text.size() && text[cursor] != '\n' && !atlas.face.glyph(static_cast<unsigned char>(text[cursor]))) cursor += 1;
+                const bool hardEnd = line + 1 == layout.lines || (cursor < text.size() && text[cursor] == '\n');
+                if (cursor < text.size() && text[cursor] == '\n') cursor += 1;
+
+                float width = 0.0f;
+                const size_t measured = (!hardEnd && end > begin) ? end - 1 : end;
+                for (size_t k = begin; k < measured; ++k) width += layout.advances[k];
+                widest = std::max(widest, width);
+                if (!hardEnd) {
+                    wrapped += 1;
+                    ok = check(end > begin && placed[end - 1] == ' ', "wrap break after a space" + at) && ok;
+                }
+                // Spaces never break a line, so trailing ones may hang past the
+                // width; otherwise a line only runs past it when it is one word.
+                size_t trimmed = measured;
+                while (trimmed > begin && placed[trimmed - 1] == ' ') trimmed -= 1;
+                float inked = 0.0f;
+                for (size_t k = begin; k < trimmed; ++k) inked += layout.advances[k];
+                if (inked > wrapWidth) {
+                    bool oneWord = true;
+                    for (size_t k = begin; k < trimmed; ++k) {
+                        oneWord = oneWord && (placed[k] != ' ' || k == begin || placed[k - 1] == ' ');
+                    }
+                    // Leading spaces are allowed only up to the word.
+                    size_t word = begin;
+                    while (word < trimmed && placed[word] == ' ') word += 1;
+                    for (size_t k = word; k < trimmed; ++k) oneWord = oneWord && placed[k] != ' ';
+                    ok = check(oneWord, "line of several words wider than the wrap width" + at) && ok;
+                }
+                // The break was needed: the word it moved down did not fit.
+                if (!hardEnd && end < placed.size()) {
+                    size_t wordEnd = end;
+                    while (wordEnd < placed.size() && placed[wordEnd] != ' ') wordEnd += 1;
+                    float withWord = 0.0f;
+                    for (size_t k = begin; k < wordEnd; ++k) withWord += layout.advances[k];
+                    ok = check(withWord > wrapWidth, "unneeded wrap break" + at) && ok;
+                }
+            }
+            ok = check(layout.width == widest, "layout width is the widest line" + at) && ok;
+            if (!ok) failures += 1;
+        }
+
+        // A word longer than the width stays whole; spaces break.
+        TextLayout::Layout layout;
+        std::string longWord(40, 'W');
+        TextLayout::shape(atlas.face, longWord, 30.0f, layout);
+        check(layout.lines == 1 && layout.width > 30.0f, "long word split");
+        TextLayout::shape(atlas.face, "ab cd ef", 1.0f, layout);
+        check(layout.lines == 3, "each word on its own line at a tiny width");
+        TextLayout::shape(atlas.face, "ab cd ef", 0.0f, layout);
+        check(layout.lines == 1, "wrap width 0 does not wrap");
+        TextLayout::shape(atlas.face, "", 0.0f, layout);
+        check(layout.lines == 1 && layout.width == 0.0f && layout.quads.empty(), "empty text");
+        std::printf("wrap metrics: %d strings, %d wrap breaks\n", kStrings, wrapped);
+    }
+
+    void cacheInvalidation() {
+        std::mt19937 rng(0xcace);
+        const Atlas atlas = makeAtlas(rng, 24.0f, 10);
+        TextLayout::Cache cache(8);
+        auto sameLayout = [](const TextLayout::Layout& a, const TextLayout::Layout& b) {
+            if (a.advances != b.advances || a.quadIndex != b.quadIndex || a.lineStarts != b.lineStarts
+                || a.quads.size() != b.quads.size() || a.width != b.width || a.height != b.height) return false;
+            for (size_t i = 0; i < a.quads.size(); ++i) {
+                if (std::memcmp(&a.quads[i], &b.quads[i], sizeof(TextLayout::Quad)) != 0) return false;
+            }
+            return true;
+        };
+        auto fresh = [](const TextLayout::Face& face, const std::string& text, float wrap) {
+            TextLayout::Layout layout;
+            TextLayout::shape(face, text, wrap, layout);
+            return layout;
+        };
+
+        const TextLayout::Layout* first = &cache.get(atlas.face, "Track 1", 0.0f);
+        check(cache.misses() == 1 && cache.hits() == 0, "first lookup misses");
+        const TextLayout::Layout* again = &cache.get(atlas.face, "Track 1", 0.0f);
+        check(cache.hits() == 1 && cache.misses() == 1 && again == first, "same key hits the same entry");
+        check(sameLayout(*again, fresh(atlas.face, "Track 1", 0.0f)), "cached layout matches a fresh shape");
+
+        cache.get(atlas.face, "Track 2", 0.0f);
+        check(cache.misses() == 2, "changed text misses");
+        check(sameLayout(cache.get(atlas.face, "Track 2", 0.0f), fresh(atlas.face, "Track 2", 0.0f)), "changed text reshaped");
+
+        // Non-positive wrap widths all mean no wrapping and share an entry.
+        cache.get(atlas.face, "Track 1", -4.0f);
+        check(cache.misses() == 2, "negative wrap width treated as none");
+        cache.get(atlas.face, "Track 1", 50.0f);
+        check(cache.misses() == 3, "wrap width change misses");
+        check(sameLayout(cache.get(atlas.face, "Track 1", 50.0f), fresh(atlas.face, "Track 1", 50.0f)), "wrapped entry");
+
+        // A rebuilt atlas has new metrics and a new id; its layouts must not
+        // come from the old atlas's entries.
+        std::mt19937 rebuildRng(0xbeef);
+        const Atlas rebuilt = makeAtlas(rebuildRng, 24.0f, 11);
+        const uint64_t missesBefore = cache.misses();
+        const TextLayout::Layout& afterRebuild = cache.get(rebuilt.face, "Track 1", 0.0f);
+        check(cache.misses() == missesBefore + 1, "atlas rebuild misses");
+        check(sameLayout(afterRebuild, fresh(rebuilt.face, "Track 1", 0.0f)), "layout uses the rebuilt atlas");
+        check(!sameLayout(afterRebuild, fresh(atlas.face, "Track 1", 0.0f)), "rebuilt atlas metrics did not differ");
+
+        // Same font at another size.
+        Atlas resized = makeAtlas(rebuildRng, 11.0f, 10);
+        resized.face.id = atlas.face.id;
+        const uint64_t missesBeforeSize = cache.misses();
+        cache.get(resized.face, "Track 1", 0.0f);
+        check(cache.misses() == missesBeforeSize + 1, "pixel size change misses");
+
+        // Filling past capacity drops the least recently used half.
+        TextLayout::Cache small(8);
+        for (int i = 0; i < 8; ++i) small.get(atlas.face, "label " + std::to_string(i), 0.0f);
+        for (int i = 4; i < 8; ++i) small.get(atlas.face, "label " + std::to_string(i), 0.0f);
+        small.get(atlas.face, "label 8", 0.0f);
+        check(small.size() <= 8, "cache grew past capacity");
+        const uint64_t hits = small.hits();
+        for (int i = 4; i < 9; ++i) small.get(atlas.face, "label " + std::to_string(i), 0.0f);
+        check(small.hits() == hits + 5, "recently used entries evicted");
+        const uint64_t misses = small.misses();
+        small.get(atlas.face, "label 0", 0.0f);
+        check(small.misses() == misses + 1, "least recently used entry kept");
+        check(sameLayout(small.get(atlas.face, "label 0", 0.0f), fresh(atlas.face, "label 0", 0.0f)),
+              "re-shaped entry after eviction");
+
+        small.clear();
+        check(small.size() == 0, "clear");
+        const uint64_t missesAfterClear = small.misses();
+        small.get(atlas.face, "label 5", 0.0f);
+        check(small.misses() == missesAfterClear + 1, "lookups after clear miss");
+    }
+
+    // FontSystem's TextRun: last vertices of one text instance.
+    struct Run {
+        std::string text;
+        uint32_t faceId = 0;
+        float x = 0.0f;
+        float y = 0.0f;
+        std::vector<UIBatch::Vertex> vertices;
+    };
+
+    void labelFrameBenchmark() {
+        std::mt19937 rng(0x2000);
+        const Atlas atlas = makeAtlas(rng, 24.0f, 1);
+        constexpr int kLabels = 2000;
+        constexpr int kFrames = 120;
+        std::vector<std::string> texts(kLabels);
+        std::vector<Legacy::Vec2> positions(kLabels);
+        for (int i = 0; i < kLabels; ++i) {
+            texts[static_cast<size_t>(i)] = (i % 3 == 0 ? "Track " : (i % 3 == 1 ? "Clip " : "Bus send ")) + std::to_string(i);
+            positions[static_cast<size_t>(i)] = {40.0f + 90.0f * static_cast<float>(i % 20), 12.0f + 10.0f * static_cast<float>(i / 20)};
+        }
+        const uint32_t color = UIBatch::packColor(1.0f, 1.0f, 1.0f, 1.0f);
+        // A few labels change every frame, like the transport clock and meters.
+        auto frameText = [&](int label, int frame) -> const std::string& {
+            static std::string changing;
+            if (label % 100 != 0) return texts[static_cast<size_t>(label)];
+            changing = std::to_string(frame * 17 + label) + " ms";
+            return changing;
+        };
+
+        std::vector<UIBatch::Vertex> frameVertices;
+        frameVertices.reserve(kLabels * 10 * 6);
+        double inPlaceMs = 0.0;
+        double cachedMs = 0.0;
+        double runsMs = 0.0;
+        size_t vertexCount[3] = {0, 0, 0};
+
+        for (int frame = 0; frame < kFrames; ++frame) {
+            frameVertices.clear();
+            auto start = Clock::now();
+            for (int i = 0; i < kLabels; ++i) {
+                Legacy::appendTextVertices(frameVertices, atlas, frameText(i, frame), color, positions[static_cast<size_t>(i)], 1920.0, 1080.0);
+            }
+            inPlaceMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            vertexCount[0] = frameVertices.size();
+        }
+
+        TextLayout::Cache cache;
+        for (int frame = 0; frame < kFrames; ++frame) {
+            frameVertices.clear();
+            auto start = Clock::now();
+            for (int i = 0; i < kLabels; ++i) {
+                const TextLayout::Layout& layout = cache.get(atlas.face, frameText(i, frame), 0.0f);
+                const Legacy::Vec2& p = positions[static_cast<size_t>(i)];
+                TextLayout::emit(layout, p.x - layout.width * 0.5f, p.y - layout.height * 0.5f, color, 1920.0, 1080.0, frameVertices);
+            }
+            cachedMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            vertexCount[1] = frameVertices.size();
+        }
+
+        TextLayout::Cache runCache;
+        std::vector<Run> runs(kLabels);
+        for (int frame = 0; frame < kFrames; ++frame) {
+            frameVertices.clear();
+            auto start = Clock::now();
+            for (int i = 0; i < kLabels; ++i) {
+                Run& run = runs[static_cast<size_t>(i)];
+                const std::string& text = frameText(i, frame);
+                const Legacy::Vec2& p = positions[static_cast<size_t>(i)];
+                if (run.faceId != atlas.face.id || run.x != p.x || run.y != p.y || run.text != text) {
+                    const TextLayout::Layout& layout = runCache.get(atlas.face, text, 0.0f);
+                    run.vertices.clear();
+                    TextLayout::emit(layout, p.x - layout.width * 0.5f, p.y - layout.height * 0.5f, color, 1920.0, 1080.0, run.vertices);
+                    run.text = text;
+                    run.faceId = atlas.face.id;
+                    run.x = p.x;
+                    run.y = p.y;
+                }
+                frameVertices.insert(frameVertices.end(), run.vertices.begin(), run.vertices.end());
+            }
+            runsMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            vertexCount[2] = frameVertices.size();
+        }
+
+        std::printf("\n%d-label frame (%d labels change per frame):\n", kLabels, kLabels / 100);
+        std::printf("  shaped in place   %7.3f ms  %zu vertices\n", inPlaceMs / kFrames, vertexCount[0]);
+        std::printf("  layout cache      %7.3f ms  %zu vertices\n", cachedMs / kFrames, vertexCount[1]);
+        std::printf("  run reuse         %7.3f ms  %zu vertices\n", runsMs / kFrames, vertexCount[2]);
+        std::printf("  cache: %zu entries, %llu hits, %llu misses\n", cache.size(),
+                    static_cast<unsigned long long>(cache.hits()), static_cast<unsigned long long>(cache.misses()));
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    if (!benchOnly) {
+        legacyEquivalence();
+        wrapMetrics();
+        cacheInvalidation();
+    }
+    labelFrameBenchmark();
+    if (g_failures > 0) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,246 @@
+// Standalone determinism check for parallel tree/foliage decoration. Not part
+// of the game build:
+//
+//   g++ -std=c++17 -O2 -pthread -I. -I<glm> -I<dir holding json.hpp> Tools/TreeDecorationDeterminism.cpp -o tree_decoration_determinism
+//   ./tree_decoration_determinism [threads...]
+//
+// Run from the repo root so Entities/ loads. Builds the same hilly 256x256
+// voxel terrain with tunnels (so the cave passes run) once per thread count,
+// runs UpdateExpanseTrees for 60 frames with "TreeDecorationThreads" set to
+// that count and requires every section's ids, colors and editVersion to be
+// byte-identical to the 1-thread world. Thread counts default to 1 3 8; 1 is
+// always the reference. Exits nonzero on any difference. The host contexts
+// and the terrain sampler are stand-ins; the decoration code, voxel world,
+// prototypes and worker pool are the game's.
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <variant>
+
+#include <glm/glm.hpp>
+#include "json.hpp"
+using json = nlohmann::json;
+
+#include "BaseEntity.cpp"
+#include "Structures/VoxelWorld.h"
+#include "Structures/VoxelWorld.cpp"
+
+struct GLFWwindow;
+struct ExpanseConfig {
+    bool loaded = true;
+    float desertStartX = 160.0f;
+    float snowStartZ = -160.0f;
+};
+struct WorldContext { ExpanseConfig expanse; };
+struct PlayerContext { glm::vec3 cameraPosition = glm::vec3(128.0f, 0.0f, 128.0f); };
+struct BaseSystem {
+    std::unique_ptr<WorldContext> world;
+    std::unique_ptr<VoxelWorldContext> voxelWorld;
+    std::unique_ptr<PlayerContext> player;
+    uint64_t frameIndex = 0;
+    std::map<std::string, std::variant<bool, std::string>>* registry = nullptr;
+};
+
+namespace ExpanseBiomeSystemLogic {
+    float TerrainHeight(float x, float z) {
+        return 40.0f + 6.0f * std::sin(x * 0.07f) + 5.0f * std::cos(z * 0.05f) + 2.0f * std::sin((x + z) * 0.13f);
+    }
+    bool SampleTerrain(const WorldContext&, float x, float z, float& outHeight) {
+        outHeight = TerrainHeight(x, z);
+        return true;
+    }
+    void PrepareTerrainSampling(const WorldContext&) {}
+}
+namespace ChucKSystemLogic {
+    bool TriggerSfx(BaseSystem&, const std::string&, float = 0.0f) { return false; }
+}
+namespace VoxelMeshingSystemLogic {
+    void RequestPriorityVoxelRemesh(BaseSystem&, std::vector<Entity>&, const glm::ivec3&) {}
+}
+
+#include "BaseSystem/TreeGenerationSystem.cpp"
+
+namespace {
+    constexpr int kSectionsPerSide = 8;
+    constexpr int kSectionSize = 32;
+    constexpr int kFrames = 60;
+
+    std::vector<Entity> loadPrototypes() {
+        namespace fs = std::filesystem;
+        std::vector<fs::path> files;
+        if (!fs::exists("Entities")) return {};
+        for (const auto& entry : fs::recursive_directory_iterator("Entities")) {
+            if (entry.path().extension() == ".json") files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+        std::vector<Entity> prototypes;
+        auto add = [&](const json& item) {
+            if (!item.is_object() || !item.contains("name")) return;
+            try {
+                Entity entity = item.get<Entity>();
+                entity.prototypeID = static_cast<int>(prototypes.size());
+                prototypes.push_back(entity);
+            } catch (...) {}
+        };
+        for (const auto& path : files) {
+            std::ifstream in(path);
+            json data;
+            try {
+                data = json::parse(in);
+            } catch (...) {
+                continue;
+            }
+            if (data.is_array()) {
+                for (const auto& item : data) add(item);
+            } else {
+                add(data);
+            }
+        }
+        return prototypes;
+    }
+
+    uint32_t prototypeId(const std::vector<Entity>& prototypes, const char* name) {
+        const Entity* proto = PrototypeTraits::findPrototype(name, prototypes);
+        return proto ? static_cast<uint32_t>(proto->prototypeID) : 0u;
+    }
+
+    struct Run {
+        std::unique_ptr<VoxelWorldContext> world;
+        double ms = 0.0;
+    };
+
+    Run decorate(std::vector<Entity>& prototypes, int threads) {
+        std::map<std::string, std::variant<bool, std::string>> registry;
+        // A new level key per run drops the decoration caches the previous
+        // run left in TreeGenerationSystem's statics.
+        registry["level"] = std::string("determinism_") + std::to_string(threads);
+        registry["TreeDecorationThreads"] = std::to_string(threads);
+        registry["TreeFoliageBackfillSectionsPerFrame"] = std::string("12");
+        registry["CaveStoneMinDepthFromSurface"] = std::string("2");
+        registry["CaveSlopeMinDepthFromSurface"] = std::string("2");
+        registry["CaveWallStoneMinDepthFromSurface"] = std::string("2");
+        registry["CaveCeilingStoneMinDepthFromSurface"] = std::string("2");
+
+        BaseSystem baseSystem;
+        baseSystem.registry = &registry;
+        baseSystem.world = std::make_unique<WorldContext>();
+        baseSystem.voxelWorld = std::make_unique<VoxelWorldContext>();
+        baseSystem.player = std::make_unique<PlayerContext>();
+        VoxelWorldContext& voxelWorld = *baseSystem.voxelWorld;
+        voxelWorld.enabled = true;
+        voxelWorld.sectionSize = kSectionSize;
+
+        const uint32_t grass = prototypeId(prototypes, "GrassBlockTex");
+        const uint32_t stone = prototypeId(prototypes, "StoneBlockTex");
+        const int extent = kSectionsPerSide * kSectionSize;
+        for (int z = 0; z < extent; ++z) {
+            for (int x = 0; x < extent; ++x) {
+                const int height = static_cast<int>(std::floor(ExpanseBiomeSystemLogic::TerrainHeight(
+                    static_cast<float>(x), static_cast<float>(z))));
+                for (int y = 0; y <= height; ++y) {
+                    const float tunnelY = 18.0f + 4.0f * std::sin(x * 0.09f);
+                    const float tunnel = std::abs(y - tunnelY) + std::abs(std::sin(z * 0.11f) * 6.0f) - 3.0f;
+                    if (y > 4 && y < height - 3 && tunnel < 2.5f) continue;
+                    voxelWorld.setBlockLod(0, glm::ivec3(x, y, z), y == height ? grass : stone, 0xff808080u, false);
+                }
+            }
+        }
+        for (const auto& [key, section] : voxelWorld.sections) voxelWorld.dirtySections.insert(key);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < kFrames; ++frame) {
+            baseSystem.frameIndex = static_cast<uint64_t>(frame);
+            TreeGenerationSystemLogic::UpdateExpanseTrees(baseSystem, prototypes, 0.016f, nullptr);
+            voxelWorld.dirtySections.clear();
+        }
+        Run run;
+        run.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        run.world = std::move(baseSystem.voxelWorld);
+        return run;
+    }
+
+    size_t decoratedCells(const VoxelWorldContext& world, uint32_t grass, uint32_t stone) {
+        size_t count = 0;
+        for (const auto& [key, section] : world.sections) {
+            for (uint32_t id : section.ids) {
+                if (id != 0 && id != grass && id != stone) count += 1;
+            }
+        }
+        return count;
+    }
+
+    // Returns the number of differing sections, printing the first few.
+    int compareWorlds(const VoxelWorldContext& reference, const VoxelWorldContext& other, int threads) {
+        int differences = 0;
+        auto report = [&](const VoxelSectionKey& key, const char* what) {
+            if (differences++ < 5) {
+                std::cerr << "FAIL: " << threads << " threads: section lod " << key.lod << " ("
+                          << key.coord.x << ", " << key.coord.y << ", " << key.coord.z << ") " << what << "\n";
+            }
+        };
+        for (const auto& [key, section] : reference.sections) {
+            auto it = other.sections.find(key);
+            if (it == other.sections.end()) {
+                report(key, "missing");
+                continue;
+            }
+            if (section.editVersion != it->second.editVersion) report(key, "editVersion differs");
+            else if (section.ids != it->second.ids) report(key, "ids differ");
+            else if (section.colors != it->second.colors) report(key, "colors differ");
+        }
+        for (const auto& [key, section] : other.sections) {
+            if (reference.sections.find(key) == reference.sections.end()) report(key, "extra");
+        }
+        return differences;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> threadCounts;
+    for (int i = 1; i < argc; ++i) {
+        const int threads = std::atoi(argv[i]);
+        if (threads < 1) {
+            std::cerr << "usage: " << argv[0] << " [threads...]\n";
+            return 2;
+        }
+        if (threads != 1) threadCounts.push_back(threads);
+    }
+    if (argc == 1) threadCounts = {3, 8};
+
+    std::vector<Entity> prototypes = loadPrototypes();
+    const uint32_t grass = prototypeId(prototypes, "GrassBlockTex");
+    const uint32_t stone = prototypeId(prototypes, "StoneBlockTex");
+    if (!grass || !stone || !PrototypeTraits::findPrototype("Leaf", prototypes)) {
+        std::cerr << "prototypes missing; run from the repo root\n";
+        return 2;
+    }
+
+    const Run reference = decorate(prototypes, 1);
+    const size_t decorated = decoratedCells(*reference.world, grass, stone);
+    std::printf("1 thread: %zu sections, %zu decorated cells, %.0f ms\n",
+                reference.world->sections.size(), decorated, reference.ms);
+    int failures = 0;
+    if (decorated == 0) {
+        std::cerr << "FAIL: the reference run placed nothing\n";
+        failures += 1;
+    }
+    for (int threads : threadCounts) {
+        const Run run = decorate(prototypes, threads);
+        const int differences = compareWorlds(*reference.world, *run.world, threads);
+        std::printf("%d threads: %s, %.0f ms\n", threads,
+                    differences == 0 ? "identical" : "DIFFERENT", run.ms);
+        failures += differences;
+    }
+    if (failures > 0) {
+        std::cerr << failures << " difference(s)\n";
+        return 1;
+    }
+    std::cout << "ok\n";
+    return 0;
+}
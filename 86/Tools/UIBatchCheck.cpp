@@ -0,0 +1,525 @@
+// Standalone checks for the UI batch builder. Not part of the game build:
+//
+//   g++ -std=c++17 -O2 -I. Tools/UIBatchCheck.cpp -o ui_batch_check
+//   ./ui_batch_check [--bench-only]
+//
+// UIBatch::Builder is the GL-free half of UIBatchSystem, so everything it
+// decides can be checked on the CPU. Random frames of colored quads, packed
+// glyph quads and colored streams with text overlays, under a handful of
+// programs, atlas textures and scissor rects, are rasterized onto a small
+// grid twice: once in submission order with each submission's own state, the
+// way the systems drew before the batch, and once from draws() and write() the
+// way Flush issues them. Every cell must end up showing the same submission.
+// Also checks that draws() partitions the written vertices, that every vertex
+// lands in a draw with its own state, the merge rules (overlap, lookback,
+// disabled clips), color packing, alpha replacement, text overlay marks and
+// prefixes, and the stats Flush reports. Ends with the time to build and write
+// a busy DAW frame. Exits nonzero if any check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BaseSystem/UIBatch.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    int g_failures = 0;
+
+    bool check(bool condition, const std::string& what) {
+        if (condition) return true;
+        std::cerr << "FAIL: " << what << "\n";
+        g_failures += 1;
+        return false;
+    }
+
+    // Same shape addColored reads from the systems' glm-based UiVertex.
+    struct ColorVertex {
+        struct { float x; float y; } pos;
+        struct { float r; float g; float b; } color;
+    };
+
+    constexpr int kGrid = 64;  // framebuffer pixels per side
+
+    // Submission ids ride in the vertex rgb so both raster passes can tell
+    // which submission painted a cell; alpha is what the builder rewrites.
+    uint32_t idColor(uint32_t id) {
+        return UIBatch::packColor(static_cast<float>(id & 0xffu) / 255.0f,
+                                  static_cast<float>((id >> 8u) & 0xffu) / 255.0f,
+                                  static_cast<float>((id >> 16u) & 0xffu) / 255.0f, 1.0f);
+    }
+
+    uint32_t idOf(const UIBatch::Vertex& vertex) { return vertex.color & 0x00ffffffu; }
+
+    struct Rect { float x0, y0, x1, y1; };  // NDC
+
+    // Two triangles covering `rect`, in the winding the systems' pushQuad uses.
+    template <class Out, class Make>
+    void quadVertices(const Rect& rect, Out& out, Make make) {
+        out.push_back(make(rect.x0, rect.y0));
+        out.push_back(make(rect.x1, rect.y0));
+        out.push_back(make(rect.x1, rect.y1));
+        out.push_back(make(rect.x0, rect.y0));
+        out.push_back(make(rect.x1, rect.y1));
+        out.push_back(make(rect.x0, rect.y1));
+    }
+
+    std::vector<ColorVertex> colorQuads(const std::vector<Rect>& rects, uint32_t id) {
+        std::vector<ColorVertex> out;
+        const float r = static_cast<float>(id & 0xffu) / 255.0f;
+        const float g = static_cast<float>((id >> 8u) & 0xffu) / 255.0f;
+        const float b = static_cast<float>((id >> 16u) & 0xffu) / 255.0f;
+        for (const Rect& rect : rects) {
+            quadVertices(rect, out, [&](float x, float y) { return ColorVertex{{x, y}, {r, g, b}}; });
+        }
+        return out;
+    }
+
+    void packedQuads(const std::vector<Rect>& rects, uint32_t id, std::vector<UIBatch::Vertex>& out) {
+        for (const Rect& rect : rects) {
+            quadVertices(rect, out, [&](float x, float y) {
+                UIBatch::Vertex v;
+                v.x = x;
+                v.y = y;
+                v.u = 0.25f;
+                v.v = 0.75f;
+                v.color = idColor(id);
+                return v;
+            });
+        }
+    }
+
+    using Grid = std::vector<uint32_t>;  // submission id + 1 per cell, 0 = untouched
+
+    // Paints one quad (6 vertices) the way a rasterizer samples pixel centers.
+    void paintQuad(Grid& grid, const UIBatch::Vertex* quad, const UIBatch::Clip& clip, uint32_t id) {
+        float minX = quad[0].x, maxX = quad[0].x, minY = quad[0].y, maxY = quad[0].y;
+        for (int i = 1; i < 6; ++i) {
+            minX = std::min(minX, quad[i].x);
+            maxX = std::max(maxX, quad[i].x);
+            minY = std::min(minY, quad[i].y);
+            maxY = std::max(maxY, quad[i].y);
+        }
+        for (int py = 0; py < kGrid; ++py) {
+            const float cy = (static_cast<float>(py) + 0.5f) / kGrid * 2.0f - 1.0f;
+            if (cy < minY || cy >= maxY) continue;
+            if (clip.enabled && (py < clip.y || py >= clip.y + clip.h)) continue;
+            for (int px = 0; px < kGrid; ++px) {
+                const float cx = (static_cast<float>(px) + 0.5f) / kGrid * 2.0f - 1.0f;
+                if (cx < minX || cx >= maxX) continue;
+                if (clip.enabled && (px < clip.x || px >= clip.x + clip.w)) continue;
+                grid[static_cast<size_t>(py) * kGrid + static_cast<size_t>(px)] = id + 1;
+            }
+        }
+    }
+
+    // One submission as the unbatched systems would have drawn it.
+    struct Reference {
+        uint32_t id = 0;
+        UIBatch::State state;
+        std::vector<UIBatch::Vertex> vertices;
+    };
+
+    struct Frame {
+        std::vector<Reference> order;
+        std::vector<UIBatch::State> stateOfId;
+    };
+
+    const UIBatch::Clip kClips[] = {
+        UIBatch::Clip{},
+        UIBatch::Clip{true, 8, 8, 40, 30},
+        UIBatch::Clip{true, 24, 0, 40, 64},
+        UIBatch::Clip{false, 3, 4, 5, 6},  // disabled: same as no clip
+    };
+
+    UIBatch::State randomState(std::mt19937& rng) {
+        UIBatch::State state;
+        state.clip = kClips[std::uniform_int_distribution<int>(0, 3)(rng)];
+        if (std::uniform_int_distribution<int>(0, 2)(rng) == 0) {
+            state.program = UIBatch::Program::Text;
+            state.texture = static_cast<uint32_t>(std::uniform_int_distribution<int>(1, 2)(rng));
+        }
+        return state;
+    }
+
+    // Rects on a 1/16 NDC lattice, from glyph-sized to panel-sized.
+    Rect randomRect(std::mt19937& rng) {
+        std::uniform_int_distribution<int> corner(-16, 15);
+        const int x0 = corner(rng);
+        const int y0 = corner(rng);
+        const int maxSize = std::uniform_int_distribution<int>(0, 3)(rng) == 0 ? 16 : 4;
+        const int w = std::uniform_int_distribution<int>(1, maxSize)(rng);
+        const int h = std::uniform_int_distribution<int>(1, maxSize)(rng);
+        return {x0 / 16.0f, y0 / 16.0f, std::min(16, x0 + w) / 16.0f, std::min(16, y0 + h) / 16.0f};
+    }
+
+    std::vector<Rect> randomRects(std::mt19937& rng) {
+        std::vector<Rect> rects(static_cast<size_t>(std::uniform_int_distribution<int>(1, 3)(rng)));
+        for (Rect& rect : rects) rect = randomRect(rng);
+        return rects;
+    }
+
+    Reference makeReference(uint32_t id, const UIBatch::State& state, const std::vector<Rect>& rects) {
+        Reference ref;
+        ref.id = id;
+        ref.state = state;
+        packedQuads(rects, id, ref.vertices);
+        return ref;
+    }
+
+    // Submits a random frame to `builder` and returns the unbatched order.
+    Frame buildRandomFrame(std::mt19937& rng, UIBatch::Builder& builder) {
+        Frame frame;
+        uint32_t nextId = 0;
+        auto newId = [&](const UIBatch::State& state) {
+            frame.stateOfId.push_back(state);
+            return nextId++;
+        };
+        const int submissions = std::uniform_int_distribution<int>(1, 60)(rng);
+        for (int s = 0; s < submissions; ++s) {
+            const int kind = std::uniform_int_distribution<int>(0, 5)(rng);
+            UIBatch::State state = randomState(rng);
+            if (kind <= 2) {
+                // A system's colored vertex stream.
+                state.program = UIBatch::Program::Color;
+                state.texture = 0;
+                const std::vector<Rect> rects = randomRects(rng);
+                const uint32_t id = newId(state);
+                builder.addColored(colorQuads(rects, id), 0.5f, state.clip);
+                frame.order.push_back(makeReference(id, state, rects));
+            } else if (kind <= 4) {
+                // Laid-out glyph quads or another packed stream.
+                const std::vector<Rect> rects = randomRects(rng);
+                const uint32_t id = newId(state);
+                std::vector<UIBatch::Vertex> packed;
+                packedQuads(rects, id, packed);
+                builder.addPacked(state.program, state.texture, packed.data(), packed.size(), 0.8f, state.clip);
+                frame.order.push_back(makeReference(id, state, rects));
+            } else {
+                // Colored stream with labels laid over it, as the lanes and piano roll submit.
+                UIBatch::State colorState;
+                colorState.clip = state.clip;
+                const int pieces = std::uniform_int_distribution<int>(1, 4)(rng);
+                std::vector<ColorVertex> stream;
+                UIBatch::TextOverlay labels;
+                std::vector<Reference> expected;
+                for (int p = 0; p < pieces; ++p) {
+                    const std::vector<Rect> rects = randomRects(rng);
+                    const uint32_t id = newId(colorState);
+                    const std::vector<ColorVertex> quads = colorQuads(rects, id);
+                    stream.insert(stream.end(), quads.begin(), quads.end());
+                    expected.push_back(makeReference(id, colorState, rects));
+                    const int texts = std::uniform_int_distribution<int>(0, 2)(rng);
+                    for (int t = 0; t < texts; ++t) {
+                        UIBatch::State textState;
+                        textState.program = UIBatch::Program::Text;
+                        textState.texture = static_cast<uint32_t>(std::uniform_int_distribution<int>(1, 2)(rng));
+                        textState.clip = state.clip;
+                        const std::vector<Rect> glyphs = randomRects(rng);
+                        const uint32_t textId = newId(textState);
+                        const size_t first = labels.vertices.size();
+                        packedQuads(glyphs, textId, labels.vertices);
+                        labels.mark(stream.size(), textState.texture, first);
+                        expected.push_back(makeReference(textId, textState, glyphs));
+                    }
+                }
+                builder.addColored(stream, 0.6f, labels, state.clip);
+                frame.order.insert(frame.order.end(), expected.begin(), expected.end());
+            }
+        }
+        return frame;
+    }
+
+    void randomFrames() {
+        constexpr int kFrames = 3000;
+        std::mt19937 rng(0xba7c4);
+        UIBatch::Builder builder;
+        std::vector<UIBatch::Vertex> written;
+        size_t submits = 0;
+        size_t draws = 0;
+        int mismatchedFrames = 0;
+        for (int f = 0; f < kFrames && mismatchedFrames < 5; ++f) {
+            builder.clear();
+            const Frame frame = buildRandomFrame(rng, builder);
+            const std::string at = " (frame " + std::to_string(f) + ")";
+
+            Grid expected(kGrid * kGrid, 0);
+            size_t referenceVertices = 0;
+            for (const Reference& ref : frame.order) {
+                for (size_t q = 0; q + 6 <= ref.vertices.size(); q += 6) {
+                    paintQuad(expected, ref.vertices.data() + q, ref.state.clip, ref.id);
+                }
+                referenceVertices += ref.vertices.size();
+            }
+
+            const std::vector<UIBatch::Draw>& drawList = builder.draws();
+            written.assign(builder.vertexCount(), UIBatch::Vertex{});
+            builder.write(written.data());
+            check(builder.vertexCount() == referenceVertices, "vertex count" + at);
+
+            Grid batched(kGrid * kGrid, 0);
+            uint32_t next = 0;
+            bool statesMatch = true;
+            for (const UIBatch::Draw& draw : drawList) {
+                check(draw.first == next && draw.count > 0 && draw.count % 6 == 0, "draws do not tile the buffer" + at);
+                next = draw.first + draw.count;
+                if (next > written.size()) break;
+                for (uint32_t q = draw.first; q + 6 <= draw.first + draw.count; q += 6) {
+                    const uint32_t id = idOf(written[q]);
+                    statesMatch = statesMatch && id < frame.stateOfId.size() && frame.stateOfId[id] == draw.state;
+                    paintQuad(batched, written.data() + q, draw.state.clip, id);
+                }
+            }
+            check(next == written.size(), "draws do not cover every vertex" + at);
+            check(statesMatch, "vertex drawn with another submission's state" + at);
+            if (!check(batched == expected, "painter's order differs from unbatched drawing" + at)) mismatchedFrames += 1;
+
+            const UIBatch::Stats stats = builder.stats();
+            check(stats.draws == drawList.size() && stats.vertices == written.size()
+                  && stats.bytes == written.size() * sizeof(UIBatch::Vertex)
+                  && stats.submits == builder.submitCount(), "stats" + at);
+            submits += stats.submits;
+            draws += stats.draws;
+        }
+        std::printf("random frames: %d frames, %zu submissions drawn in %zu draws\n", kFrames, submits, draws);
+        check(draws < submits, "batching merged nothing");
+    }
+
+    // Builds a frame from (state index, rect) pairs and returns its draw count.
+    size_t drawsFor(const std::vector<std::pair<UIBatch::State, Rect>>& items) {
+        UIBatch::Builder builder;
+        uint32_t id = 0;
+        for (const auto& item : items) {
+            std::vector<UIBatch::Vertex> packed;
+            packedQuads({item.second}, id++, packed);
+            builder.addPacked(item.first.program, item.first.texture, packed.data(), packed.size(), 1.0f, item.first.clip);
+        }
+        return builder.draws().size();
+    }
+
+    void mergeRules() {
+        UIBatch::State panel;
+        UIBatch::State text;
+        text.program = UIBatch::Program::Text;
+        text.texture = 7;
+        const Rect left{-1.0f, -1.0f, -0.5f, -0.5f};
+        const Rect leftBelow{-1.0f, 0.5f, -0.5f, 1.0f};
+        const Rect right{0.5f, -1.0f, 1.0f, -0.5f};
+        const Rect overRight{0.75f, -0.75f, 1.0f, 0.0f};
+
+        check(drawsFor({{panel, left}, {text, right}, {panel, leftBelow}}) == 2,
+              "same-state submission not merged past a disjoint run");
+        check(drawsFor({{panel, left}, {text, right}, {panel, overRight}}) == 3,
+              "submission merged across a run it overlaps");
+        // Touching edges do not overlap.
+        check(drawsFor({{panel, left}, {text, Rect{-0.5f, -1.0f, 0.0f, -0.5f}}, {panel, Rect{-0.5f, -1.0f, 0.0f, -0.5f}}}) == 3,
+              "identical rects treated as disjoint");
+        check(drawsFor({{panel, left}, {text, Rect{-0.5f, -1.0f, 0.0f, -0.5f}}, {panel, leftBelow}}) == 2,
+              "edge-touching run blocked a merge");
+
+        // Only the last kMergeLookback runs are searched.
+        std::vector<std::pair<UIBatch::State, Rect>> items{{panel, left}};
+        for (size_t i = 1; i < UIBatch::Builder::kMergeLookback; ++i) {
+            UIBatch::State other;
+            other.program = UIBatch::Program::Text;
+            other.texture = static_cast<uint32_t>(100 + i);
+            items.push_back({other, right});
+        }
+        items.push_back({panel, leftBelow});
+        check(drawsFor(items) == UIBatch::Builder::kMergeLookback, "merge within the lookback");
+        items.pop_back();
+        UIBatch::State extra;
+        extra.program = UIBatch::Program::Text;
+        extra.texture = 99;
+        items.push_back({extra, right});
+        items.push_back({panel, leftBelow});
+        check(drawsFor(items) == UIBatch::Builder::kMergeLookback + 2, "merge past the lookback");
+
+        // Disabled clips compare equal whatever their rect; enabled ones by rect.
+        UIBatch::State clippedA = panel;
+        clippedA.clip = UIBatch::Clip{false, 1, 2, 3, 4};
+        check(drawsFor({{panel, left}, {clippedA, leftBelow}}) == 1, "disabled clip split a run");
+        UIBatch::State clippedB = panel;
+        clippedB.clip = UIBatch::Clip{true, 0, 0, 32, 32};
+        UIBatch::State clippedC = clippedB;
+        clippedC.clip.w = 31;
+        check(drawsFor({{clippedB, left}, {clippedC, leftBelow}}) == 2, "different scissors merged");
+        check(drawsFor({{clippedB, left}, {clippedB, leftBelow}}) == 1, "same scissor not merged");
+        UIBatch::State otherAtlas = text;
+        otherAtlas.texture = 8;
+        check(drawsFor({{text, left}, {otherAtlas, leftBelow}}) == 2, "different atlases merged");
+    }
+
+    void colorsAndAlpha() {
+        check(UIBatch::packColor(1.0f, 0.5f, 0.0f, 1.0f) == (255u | (128u << 8u) | (0u << 16u) | (255u << 24u)), "packColor channels");
+        check(UIBatch::packColor(-1.0f, 2.0f, 0.2f, 0.0f) == (0u | (255u << 8u) | (51u << 16u)), "packColor clamps");
+        for (uint32_t v = 0; v < 256; ++v) {
+            const float f = static_cast<float>(v) / 255.0f;
+            if (!check(UIBatch::packColor(f, f, f, f) == v * 0x01010101u, "packColor round trip " + std::to_string(v))) break;
+        }
+
+        UIBatch::Builder builder;
+        builder.addColored(colorQuads({Rect{-1.0f, -1.0f, 0.0f, 0.0f}}, 0x123456u), 0.25f);
+        std::vector<UIBatch::Vertex> packed;
+        packedQuads({Rect{0.0f, 0.0f, 1.0f, 1.0f}}, 0x654321u, packed);
+        builder.addPacked(UIBatch::Program::Text, 3, packed.data(), packed.size(), 0.5f);
+        std::vector<UIBatch::Vertex> written(builder.vertexCount());
+        builder.write(written.data());
+        check(written.size() == 12, "written size");
+        const uint32_t quarter = UIBatch::packColor(0.0f, 0.0f, 0.0f, 0.25f) & 0xff000000u;
+        const uint32_t half = UIBatch::packColor(0.0f, 0.0f, 0.0f, 0.5f) & 0xff000000u;
+        check(written[0].color == (0x123456u | quarter), "addColored color and alpha");
+        check(written[6].color == (0x654321u | half), "addPacked keeps rgb and replaces alpha");
+        check(written[6].u == 0.25f && written[6].v == 0.75f, "addPacked keeps texture coordinates");
+        check(written[0].x == -1.0f && written[2].y == 0.0f, "addColored positions");
+
+        // Empty submissions are ignored.
+        UIBatch::Builder empty;
+        empty.addColored(std::vector<ColorVertex>{}, 1.0f);
+        empty.addPacked(UIBatch::Program::Text, 1, nullptr, 0, 1.0f);
+        check(empty.empty() && empty.submitCount() == 0 && empty.draws().empty(), "empty submissions");
+
+        builder.clear();
+        check(builder.empty() && builder.draws().empty() && builder.stats().bytes == 0, "clear");
+    }
+
+    void textOverlay() {
+        UIBatch::TextOverlay labels;
+        packedQuads({Rect{0, 0, 0.1f, 0.1f}}, 1, labels.vertices);
+        labels.mark(6, 2, 0);
+        packedQuads({Rect{0.1f, 0, 0.2f, 0.1f}}, 2, labels.vertices);
+        labels.mark(6, 2, 6);
+        check(labels.marks.size() == 1 && labels.marks[0].count == 12, "adjacent labels at one point joined");
+        const UIBatch::TextOverlay::Prefix prefix = labels.prefix();
+        packedQuads({Rect{0.2f, 0, 0.3f, 0.1f}}, 3, labels.vertices);
+        labels.mark(6, 2, 12);
+        packedQuads({Rect{0.3f, 0, 0.4f, 0.1f}}, 4, labels.vertices);
+        labels.mark(12, 2, 18);
+        packedQuads({Rect{0.4f, 0, 0.5f, 0.1f}}, 5, labels.vertices);
+        labels.mark(12, 1, 24);
+        labels.mark(12, 1, 30);  // nothing new: no mark
+        check(labels.marks.size() == 3 && labels.marks[0].count == 18, "labels split by position and atlas");
+        labels.truncate(prefix);
+        check(labels.marks.size() == 1 && labels.marks[0].count == 12 && labels.vertices.size() == 12,
+              "truncate restores the joined mark");
+
+        // Marks past the end of the stream draw after all of it.
+        UIBatch::TextOverlay late;
+        packedQuads({Rect{0, 0, 0.1f, 0.1f}}, 9, late.vertices);
+        late.mark(1000, 4, 0);
+        UIBatch::Builder builder;
+        builder.addColored(colorQuads({Rect{-1, -1, 1, 1}}, 8), 1.0f, late);
+        std::vector<UIBatch::Vertex> written(builder.vertexCount());
+        builder.write(written.data());
+        check(builder.submitCount() == 2 && idOf(written[0]) == 8 && idOf(written[6]) == 9, "label past the stream");
+    }
+
+    // A 64-track arrangement: per lane a colored stream of clip bodies with
+    // their names laid over them, then a clipped meter column and a few
+    // hundred free labels, like the DAW screen submits each frame.
+    struct BusyFrame {
+        std::vector<std::vector<ColorVertex>> lanes;
+        std::vector<UIBatch::TextOverlay> laneLabels;
+        std::vector<ColorVertex> meters;
+        std::vector<std::vector<UIBatch::Vertex>> labels;
+    };
+
+    BusyFrame makeBusyFrame() {
+        constexpr int kTracks = 64;
+        constexpr int kClipsPerLane = 24;
+        BusyFrame frame;
+        const float laneHeight = 1.8f / kTracks;
+        for (int track = 0; track < kTracks; ++track) {
+            const float y0 = -0.9f + laneHeight * track;
+            std::vector<ColorVertex> lane = colorQuads({Rect{-0.8f, y0, 0.9f, y0 + laneHeight}}, 1);
+            UIBatch::TextOverlay names;
+            for (int clip = 0; clip < kClipsPerLane; ++clip) {
+                const float x0 = -0.8f + 1.7f * clip / kClipsPerLane;
+                const float x1 = x0 + 1.6f / kClipsPerLane;
+                const std::vector<ColorVertex> body = colorQuads({Rect{x0, y0 + 0.002f, x1, y0 + laneHeight - 0.002f}}, 2);
+                lane.insert(lane.end(), body.begin(), body.end());
+                std::vector<Rect> glyphs(6);
+                for (int g = 0; g < 6; ++g) {
+                    glyphs[static_cast<size_t>(g)] = Rect{x0 + 0.004f * g, y0 + 0.004f, x0 + 0.004f * (g + 1), y0 + 0.02f};
+                }
+                const size_t first = names.vertices.size();
+                packedQuads(glyphs, 3, names.vertices);
+                names.mark(lane.size(), 1, first);
+            }
+            frame.lanes.push_back(std::move(lane));
+            frame.laneLabels.push_back(std::move(names));
+            const std::vector<ColorVertex> meter = colorQuads({Rect{-0.95f, y0, -0.9f, y0 + laneHeight * 0.8f}}, 4);
+            frame.meters.insert(frame.meters.end(), meter.begin(), meter.end());
+        }
+        for (int label = 0; label < 300; ++label) {
+            const float x0 = -1.0f + 0.05f * static_cast<float>(label % 40);
+            const float y0 = 0.9f + 0.0125f * static_cast<float>(label / 40);
+            std::vector<Rect> glyphs(8);
+            for (int g = 0; g < 8; ++g) glyphs[static_cast<size_t>(g)] = Rect{x0 + 0.005f * g, y0, x0 + 0.005f * (g + 1), y0 + 0.01f};
+            frame.labels.emplace_back();
+            packedQuads(glyphs, 5, frame.labels.back());
+        }
+        return frame;
+    }
+
+    void submitBusyFrame(UIBatch::Builder& builder, const BusyFrame& frame) {
+        for (size_t track = 0; track < frame.lanes.size(); ++track) {
+            builder.addColored(frame.lanes[track], 0.85f, frame.laneLabels[track]);
+        }
+        builder.addColored(frame.meters, 1.0f, UIBatch::Clip{true, 0, 0, 64, 1080});
+        for (const std::vector<UIBatch::Vertex>& label : frame.labels) {
+            builder.addPacked(UIBatch::Program::Text, 1, label.data(), label.size(), 1.0f);
+        }
+    }
+
+    void busyFrameBenchmark() {
+        const BusyFrame frame = makeBusyFrame();
+        UIBatch::Builder builder;
+        std::vector<UIBatch::Vertex> written;
+        constexpr int kFrames = 200;
+        UIBatch::Stats stats;
+        double buildUs = 0.0;
+        double writeUs = 0.0;
+        for (int f = 0; f < kFrames; ++f) {
+            builder.clear();
+            auto start = Clock::now();
+            submitBusyFrame(builder, frame);
+            stats = builder.stats();
+            auto mid = Clock::now();
+            written.resize(builder.vertexCount());
+            builder.write(written.data());
+            auto end = Clock::now();
+            buildUs += std::chrono::duration<double, std::micro>(mid - start).count();
+            writeUs += std::chrono::duration<double, std::micro>(end - mid).count();
+        }
+        std::printf("\n64-track DAW frame: %u submissions, %u draws, %u vertices, %zu KB\n",
+                    stats.submits, stats.draws, stats.vertices, stats.bytes / 1024);
+        std::printf("  build %.1f us, write %.1f us per frame\n", buildUs / kFrames, writeUs / kFrames);
+        // Run bounds are unions, so a lane's labels end up covering the
+        // next lane's first clip: expect about a color and a text draw per lane.
+        check(stats.draws <= 2 * frame.lanes.size() + 4, "64-track frame batched worse than two draws per lane");
+    }
+}
+
+int main(int argc, char** argv) {
+    const bool benchOnly = argc > 1 && std::strcmp(argv[1], "--bench-only") == 0;
+    if (!benchOnly) {
+        randomFrames();
+        mergeRules();
+        colorsAndAlpha();
+        textOverlay();
+    }
+    busyFrameBenchmark();
+    if (g_failures > 0) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("ok\n");
+    return 0;
+}
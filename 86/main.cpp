@@ -25,6 +25,8 @@
 #include "BaseSystem/DawWaveformSystem.cpp"
 #include "BaseSystem/DawUiSystem.cpp"
 #include "BaseSystem/DawIOSystem.cpp"
+#include "BaseSystem/DawStreamSystem.cpp"
+#include "BaseSystem/DawRecordSystem.cpp"
 #include "BaseSystem/MidiTrackSystem.cpp"
 #include "BaseSystem/AutomationTrackSystem.cpp"
 #include "BaseSystem/MidiTransportSystem.cpp"
@@ -81,6 +83,7 @@
 #include "BaseSystem/PianoRollLayoutSystem.cpp"
 #include "BaseSystem/PianoRollInputSystem.cpp"
 #include "BaseSystem/PianoRollRenderSystem.cpp"
+#include "BaseSystem/UIBatchSystem.cpp"
 #include "BaseSystem/ComputerCursorSystem.cpp"
 #include "BaseSystem/ButtonSystem.cpp"
 #include "BaseSystem/RegistryEditorSystem.cpp"
@@ -90,6 +93,7 @@
 #include "BaseSystem/Vst3BrowserSystem.cpp"
 #include "BaseSystem/BlockTextureSystem.cpp"
 #include "Structures/VoxelWorld.cpp"
+#include "Host/HostRenderDevice.cpp"
 #include "Host/HostShader.cpp"
 #include "Host/HostUtilities.cpp"
 #include "Host/Startup.cpp"